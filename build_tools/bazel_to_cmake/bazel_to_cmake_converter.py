@@ -45,6 +45,7 @@ class BuildFileFunctions(object):
     self.IREE_DRIVER_MODULES = [
         # TODO(b/142004903): enable when Dawn HAL implementation is functional
         # "//iree/hal/dawn:dawn_driver_module",
+        "//iree/hal/dylib:dylib_driver_module",
         "//iree/hal/vmla:vmla_driver_module",
         "//iree/hal/vulkan:vulkan_driver_module",
         "//iree/hal/llvmjit:llvmjit_driver_module",
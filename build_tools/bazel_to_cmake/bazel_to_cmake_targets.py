@@ -31,6 +31,7 @@ EXPLICIT_TARGET_MAPPING = {
     "@llvm-project//llvm:support": ["LLVMSupport"],
     "@llvm-project//llvm:orc_jit": ["LLVMOrcJIT"],
     "@llvm-project//llvm:tablegen": ["LLVMTableGen"],
+    "@llvm-project//llvm:target": ["LLVMTarget"],
     "@llvm-project//llvm:x86_code_gen": ["LLVMX86CodeGen"],
     # MLIR
     "@llvm-project//mlir:AllPassesAndDialects": ["MLIRAllDialects"],
@@ -57,6 +57,12 @@ if(${IREE_ENABLE_TRACING})
   )
 endif()
 
+if(${IREE_ENABLE_VM_PROFILING})
+  list(APPEND IREE_DEFAULT_COPTS
+    "-DIREE_VM_PROFILING_ENABLE=1"
+  )
+endif()
+
 #-------------------------------------------------------------------------------
 # Compiler: Clang/LLVM
 #-------------------------------------------------------------------------------
@@ -34,6 +34,11 @@ StatusOr<std::string> GetFileContents(const std::string& path);
 // Synchronously writes a string into a file, overwriting its contents.
 Status SetFileContents(const std::string& path, const std::string& content);
 
+// Creates a new empty file with a unique name in the system temporary
+// directory and returns its path. The file name starts with |base_name|.
+// Callers are responsible for deleting the file when no longer needed.
+StatusOr<std::string> GetTempFile(const std::string& base_name);
+
 // Deletes the file at the provided path.
 Status DeleteFile(const std::string& path);
 
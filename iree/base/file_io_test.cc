@@ -62,6 +62,20 @@ TEST(FileIo, SetDeleteExists) {
   EXPECT_THAT(FileExists(path), StatusIs(StatusCode::kNotFound));
 }
 
+TEST(FileIo, GetTempFile) {
+  ASSERT_OK_AND_ASSIGN(auto path_a, GetTempFile("iree_file_io_test"));
+  ASSERT_OK_AND_ASSIGN(auto path_b, GetTempFile("iree_file_io_test"));
+  EXPECT_NE(path_a, path_b);
+  ASSERT_OK(FileExists(path_a));
+  ASSERT_OK(FileExists(path_b));
+  auto to_write = GetUniqueContents("GetTempFile");
+  ASSERT_OK(SetFileContents(path_a, to_write));
+  ASSERT_OK_AND_ASSIGN(std::string read, GetFileContents(path_a));
+  EXPECT_EQ(to_write, read);
+  ASSERT_OK(DeleteFile(path_a));
+  ASSERT_OK(DeleteFile(path_b));
+}
+
 TEST(FileIo, MoveFile) {
   auto from_path = GetUniquePath("MoveFileFrom");
   auto to_path = GetUniquePath("MoveFileTo");
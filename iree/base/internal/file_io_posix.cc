@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <cstdio>
+#include <cstdlib>
 
 #include "absl/strings/str_cat.h"
 #include "iree/base/file_io.h"
@@ -86,6 +87,20 @@ Status SetFileContents(const std::string& path, const std::string& content) {
   return OkStatus();
 }
 
+StatusOr<std::string> GetTempFile(const std::string& base_name) {
+  const char* tmpdir = std::getenv("TMPDIR");
+  std::string path = absl::StrCat(tmpdir ? tmpdir : "/tmp", "/", base_name,
+                                  "XXXXXX");
+  int fd = ::mkstemp(const_cast<char*>(path.data()));
+  if (fd == -1) {
+    return ErrnoToCanonicalStatusBuilder(
+        errno, absl::StrCat("Failed to create temp file '", path, "'"),
+        IREE_LOC);
+  }
+  ::close(fd);
+  return path;
+}
+
 Status DeleteFile(const std::string& path) {
   if (::remove(path.c_str()) == -1) {
     return ErrnoToCanonicalStatusBuilder(
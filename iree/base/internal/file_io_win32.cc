@@ -63,6 +63,20 @@ Status SetFileContents(const std::string& path, const std::string& content) {
   return OkStatus();
 }
 
+StatusOr<std::string> GetTempFile(const std::string& base_name) {
+  char temp_path[MAX_PATH];
+  if (::GetTempPathA(MAX_PATH, temp_path) == 0) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to query temp path";
+  }
+  char temp_file[MAX_PATH];
+  if (::GetTempFileNameA(temp_path, base_name.c_str(), 0, temp_file) == 0) {
+    return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
+           << "Unable to create temp file in " << temp_path;
+  }
+  return std::string(temp_file);
+}
+
 Status DeleteFile(const std::string& path) {
   if (::DeleteFileA(path.c_str()) == FALSE) {
     return Win32ErrorToCanonicalStatusBuilder(GetLastError(), IREE_LOC)
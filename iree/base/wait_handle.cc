@@ -15,10 +15,7 @@
 #include "iree/base/wait_handle.h"
 
 #include <errno.h>
-#include <fcntl.h>
-#include <poll.h>
 #include <time.h>
-#include <unistd.h>
 
 #include <type_traits>
 #include <utility>
@@ -29,9 +26,14 @@
 #include "absl/time/time.h"
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
+#include "iree/base/target_platform.h"
 
 // TODO(benvanik): organize these macros - they are terrible.
 
+// TODO(GH-65): port to win32 (WaitForMultipleObjects/events). Until then
+// waits are unimplemented and ManualResetEvents have no handle.
+#if !defined(IREE_PLATFORM_WINDOWS)
+
 #if !defined(__ANDROID__) && !defined(OS_IOS) && !defined(__EMSCRIPTEN__)
 #define IREE_HAS_PPOLL 1
 #endif  // !__ANDROID__  && !__EMSCRIPTEN__
@@ -43,6 +45,14 @@
 #define IREE_HAS_PIPE 1
 // #define IREE_HAS_SYNC_FILE 1
 
+#endif  // !IREE_PLATFORM_WINDOWS
+
+#if defined(IREE_HAS_POLL)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif  // IREE_HAS_POLL
+
 #if defined(IREE_HAS_EVENTFD)
 #include <sys/eventfd.h>
 #endif  // IREE_HAS_EVENTFD
@@ -70,6 +80,8 @@ StatusOr<typename std::result_of<SyscallT(ParamsT...)>::type> Syscall(
   }
 }
 
+#if defined(IREE_HAS_POLL)
+
 #if defined(IREE_HAS_PPOLL)
 
 // ppoll(), present on Linux.
@@ -129,8 +141,6 @@ StatusOr<int> SystemPoll(absl::Span<pollfd> poll_fds, absl::Time deadline) {
   return Syscall(::poll, poll_fds.data(), poll_fds.size(), timeout);
 }
 
-#else
-#error "No SystemPoll implementation"
 #endif  // IREE_HAS_PPOLL / IREE_HAS_POLL / etc
 
 // Builds the list of pollfds to for ppoll wait on and will perform any
@@ -282,6 +292,8 @@ Status MultiPoll(WaitHandle::WaitHandleSpan wait_handles,
   return OkStatus();
 }
 
+#endif  // IREE_HAS_POLL
+
 }  // namespace
 
 // static
@@ -323,6 +335,11 @@ WaitHandle WaitHandle::AlwaysFailing() {
 Status WaitHandle::WaitAll(WaitHandleSpan wait_handles, absl::Time deadline) {
   if (wait_handles.empty()) return OkStatus();
 
+#if !defined(IREE_HAS_POLL)
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "Wait handles are not supported on this platform";
+#else
+
   // Build the list of pollfds to wait on.
   ASSIGN_OR_RETURN(auto poll_fds, AcquireWaitHandles(wait_handles, deadline));
 
@@ -341,6 +358,7 @@ Status WaitHandle::WaitAll(WaitHandleSpan wait_handles, absl::Time deadline) {
     // One or more were unsignaled.
     return DeadlineExceededErrorBuilder(IREE_LOC);
   }
+#endif  // !IREE_HAS_POLL
 }
 
 // static
@@ -362,6 +380,10 @@ StatusOr<int> WaitHandle::WaitAny(WaitHandleSpan wait_handles,
            << "At least one wait handle is required for WaitAny";
   }
 
+#if !defined(IREE_HAS_POLL)
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "Wait handles are not supported on this platform";
+#else
   // Build the list of pollfds to wait on.
   ASSIGN_OR_RETURN(auto poll_fds, AcquireWaitHandles(wait_handles, deadline));
 
@@ -375,6 +397,7 @@ StatusOr<int> WaitHandle::WaitAny(WaitHandleSpan wait_handles,
     return 0;
   }
   return any_signaled_index;
+#endif  // !IREE_HAS_POLL
 }
 
 // static
@@ -455,12 +478,14 @@ void ManualResetEvent::Initialize() {
   fd_ = pipefd[0];
   write_fd_ = pipefd[1];
 #else
-// NOTE: sync_file does not use Notifier as they come from the kernel.
-#error "No fd-based sync primitive on this platform"
+  // NOTE: sync_file does not use Notifier as they come from the kernel.
+  // No fd-based sync primitive on this platform; the event has no handle.
+  fd_type_ = FdType::kPermanent;
 #endif  // IREE_HAS_EVENTFD / IREE_HAS_PIPE / etc
 }
 
 void ManualResetEvent::Dispose() {
+#if defined(IREE_HAS_POLL)
   if (fd_ != kInvalidFd) {
     // Always signal, as we need to ensure waiters are woken.
     CHECK_OK(Set());
@@ -471,6 +496,7 @@ void ManualResetEvent::Dispose() {
     Syscall(::close, write_fd_).value();
     write_fd_ = kInvalidFd;
   }
+#endif  // IREE_HAS_POLL
 }
 
 ManualResetEvent::ManualResetEvent(ManualResetEvent&& other)
@@ -525,7 +551,14 @@ Status ManualResetEvent::Set() {
 #endif  // IREE_HAS_EVENTFD / IREE_HAS_PIPE
 }
 
-Status ManualResetEvent::Reset() { return ClearFd(fd_type_, fd_); }
+Status ManualResetEvent::Reset() {
+#if defined(IREE_HAS_POLL)
+  return ClearFd(fd_type_, fd_);
+#else
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "No fd-based sync primitive on this platform";
+#endif  // IREE_HAS_POLL
+}
 
 WaitHandle ManualResetEvent::OnSet() { return WaitHandle(add_ref(this)); }
 
@@ -184,6 +184,10 @@ class WaitHandle {
   //
   // Returns DEADLINE_EXCEEDED if the |deadline| elapses without any handles
   // having been signaled.
+  //
+  // Callers repeatedly waiting on the same large set of handles (such as an
+  // event loop) should instead register the fds from
+  // WaitableObject::AcquireFdForWait with their own poller (such as epoll).
   static StatusOr<int> WaitAny(WaitHandleSpan wait_handles,
                                absl::Time deadline);
   static StatusOr<int> WaitAny(WaitHandleSpan wait_handles,
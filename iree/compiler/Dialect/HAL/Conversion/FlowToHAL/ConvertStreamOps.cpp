@@ -38,11 +38,22 @@ namespace mlir {
 namespace iree_compiler {
 namespace {
 
+// Alignment of transient values within the transient slab of a stream.
+// Matches the largest minStorageBufferOffsetAlignment of Vulkan devices so that
+// any range may be bound directly.
+static constexpr int64_t kTransientAlignment = 256;
+
 struct BufferRange {
   BufferRange() = default;
   explicit BufferRange(Value buffer) : buffer(buffer) {}
+  BufferRange(Value buffer, Value offset, Value length)
+      : buffer(buffer), offset(offset), length(length) {}
 
   Value buffer = nullptr;
+  // Byte offset and length of the range within |buffer| or null if the range
+  // covers the whole buffer.
+  Value offset = nullptr;
+  Value length = nullptr;
 };
 
 // Allocated buffers used within the stream.
@@ -128,18 +139,35 @@ static void allocateOutputBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   }
 }
 
-// Allocates a transient buffer for use entirely within the command buffer.
-static Value allocateTransientBuffer(Value streamValue, Value allocator,
-                                     ConversionPatternRewriter &rewriter) {
-  Location loc = streamValue.getLoc();
-  // TODO(benvanik): compute from SSA use-def chain uses.
-  IREE::HAL::MemoryTypeBitfield memoryTypes =
-      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
-  IREE::HAL::BufferUsageBitfield bufferUsage =
-      IREE::HAL::BufferUsageBitfield::Dispatch |
-      IREE::HAL::BufferUsageBitfield::Transfer;
+// Returns the byte offset of |range| within its buffer.
+static Value getRangeOffset(const BufferRange &range, Location loc,
+                            ConversionPatternRewriter &rewriter) {
+  if (range.offset) return range.offset;
+  return rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0);
+}
 
-  // Compute the allocation size for the value.
+// Returns a buffer referencing only the bytes of |range|.
+static Value getRangeBuffer(const BufferRange &range, Location loc,
+                            ConversionPatternRewriter &rewriter) {
+  if (!range.offset) return range.buffer;
+  return rewriter.createOrFold<IREE::HAL::BufferSubspanOp>(
+      loc, IREE::HAL::BufferType::get(rewriter.getContext()), range.buffer,
+      range.offset, range.length);
+}
+
+// Returns the unsigned maximum of |lhs| and |rhs|.
+static Value createMax(Location loc, Value lhs, Value rhs,
+                       ConversionPatternRewriter &rewriter) {
+  auto isGreater =
+      rewriter.createOrFold<CmpIOp>(loc, CmpIPredicate::ugt, lhs, rhs);
+  return rewriter.createOrFold<SelectOp>(loc, isGreater, lhs, rhs);
+}
+
+// Computes the size of the storage required for a transient value, rounded up
+// to kTransientAlignment.
+static Value computeTransientSize(Value streamValue, Value allocator,
+                                  ConversionPatternRewriter &rewriter) {
+  Location loc = streamValue.getLoc();
   auto elementType = IREE::HAL::getElementTypeValue(
       streamValue.getType().cast<ShapedType>().getElementType());
   if (!elementType) {
@@ -153,60 +181,202 @@ static Value allocateTransientBuffer(Value streamValue, Value allocator,
                             .create<IREE::HAL::AllocatorComputeSizeOp>(
                                 loc, allocator, *shape, elementType.getValue())
                             .getResult();
+  auto alignmentMask = rewriter.createOrFold<mlir::ConstantIndexOp>(
+      loc, kTransientAlignment - 1);
+  auto alignmentBits = rewriter.createOrFold<mlir::ConstantIndexOp>(
+      loc, ~(kTransientAlignment - 1));
+  return rewriter.createOrFold<AndOp>(
+      loc, rewriter.createOrFold<AddIOp>(loc, allocationSize, alignmentMask),
+      alignmentBits);
+}
 
-  auto buffer =
-      rewriter
-          .create<IREE::HAL::AllocatorAllocateOp>(loc, allocator, memoryTypes,
-                                                  bufferUsage, allocationSize)
-          .getResult();
+// Returns the size of |value| in bytes if it can be determined statically.
+// This is only used as a heuristic as the actual size is computed by the
+// allocator at runtime.
+static Optional<int64_t> estimateStaticSize(Value value) {
+  auto shapedType = value.getType().cast<ShapedType>();
+  if (!shapedType.hasStaticShape() ||
+      !shapedType.getElementType().isIntOrFloat()) {
+    return llvm::None;
+  }
+  int64_t elementByteWidth = (shapedType.getElementTypeBitWidth() + 7) / 8;
+  return shapedType.getNumElements() * elementByteWidth;
+}
 
-  // TODO(benvanik): implement resource sets.
-  rewriter.create<IREE::HAL::ExDeferReleaseOp>(loc, buffer);
+// A region of the transient slab shared by transient values with disjoint
+// lifetimes. The region is as large as the largest value assigned to it.
+struct TransientSlot {
+  // Values assigned to the slot in the order they are defined.
+  SmallVector<Value, 4> values;
+  // Index of the last stream op using the most recently assigned value.
+  int lastUse = -1;
+  // Largest static size estimate of the values in the slot, if all are known.
+  Optional<int64_t> staticSize;
+};
 
-  return buffer;
+// Assigns |value|, live across stream ops [|firstUse|, |lastUse|], to a slot
+// whose previous values are all dead by |firstUse|. Among the free slots the
+// one that needs to grow the least is preferred.
+static void assignTransientSlot(Value value, int firstUse, int lastUse,
+                                SmallVectorImpl<TransientSlot> &slots) {
+  auto staticSize = estimateStaticSize(value);
+  TransientSlot *bestSlot = nullptr;
+  int64_t bestGrowth = 0;
+  for (auto &slot : slots) {
+    if (slot.lastUse >= firstUse) continue;
+    if (!staticSize || !slot.staticSize) {
+      // Without sizes any free slot is as good as any other.
+      if (!bestSlot) bestSlot = &slot;
+      continue;
+    }
+    int64_t growth = std::max<int64_t>(0, *staticSize - *slot.staticSize);
+    if (!bestSlot || !bestSlot->staticSize || growth < bestGrowth ||
+        (growth == bestGrowth && *slot.staticSize < *bestSlot->staticSize)) {
+      bestSlot = &slot;
+      bestGrowth = growth;
+    }
+  }
+  if (!bestSlot) {
+    slots.emplace_back();
+    bestSlot = &slots.back();
+    bestSlot->staticSize = staticSize;
+  } else if (staticSize && bestSlot->staticSize) {
+    bestSlot->staticSize = std::max(*staticSize, *bestSlot->staticSize);
+  } else {
+    bestSlot->staticSize = llvm::None;
+  }
+  bestSlot->values.push_back(value);
+  bestSlot->lastUse = lastUse;
 }
 
-// Allocates transient buffers to store the intra-stream results and populates
-// the |bufferSet| with the new mappings.
-static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
-                                     BufferSet &bufferSet,
-                                     ConversionPatternRewriter &rewriter) {
+// Allocates storage for the intra-stream results and populates the |bufferSet|
+// with the new mappings.
+//
+// All transient values are packed into a single slab allocated once per
+// stream. The lifetime of each value is the range of stream ops from its
+// definition to its last use (including uses through identity ops). Values
+// with disjoint lifetimes are assigned to the same slot of the slab such that
+// the slab is only as large as the values that are live at the same time
+// require. Sizes are only known at runtime so the slot offsets and the slab
+// size are computed in the IR.
+static LogicalResult allocateTransientBuffers(
+    IREE::Flow::ExStreamFragmentOp streamOp, BufferSet &bufferSet,
+    ConversionPatternRewriter &rewriter) {
+  auto &streamBlock = streamOp.body().front();
+
   // Pull outputs that terminate on identities to operands.
-  for (auto &op : llvm::reverse(streamOp.body().front())) {
+  for (auto &op : llvm::reverse(streamBlock)) {
     if (isIdentityOp(&op)) {
       auto result = op.getResult(0);
       auto operand = op.getOperand(0);
       if (bufferSet.rangeMap[result].buffer &&
           !bufferSet.rangeMap[operand].buffer) {
-        bufferSet.rangeMap[operand].buffer = bufferSet.rangeMap[result].buffer;
+        bufferSet.rangeMap[operand] = bufferSet.rangeMap[result];
       }
     }
   }
 
   // Push inputs that originate on identities to results.
-  for (auto &op : streamOp.body().front()) {
+  for (auto &op : streamBlock) {
     if (isIdentityOp(&op)) {
       auto operand = op.getOperand(0);
       auto result = op.getResult(0);
       if (bufferSet.rangeMap[operand].buffer &&
           !bufferSet.rangeMap[result].buffer) {
-        bufferSet.rangeMap[result].buffer = bufferSet.rangeMap[operand].buffer;
+        bufferSet.rangeMap[result] = bufferSet.rangeMap[operand];
       }
     }
   }
 
-  // Allocate any remaining transients on "active" ops.
-  for (auto &op : streamOp.body().front()) {
+  // Compute the lifetime of each value in terms of stream op indices. Identity
+  // results are aliases of their operands and extend their lifetime.
+  DenseMap<Value, Value> aliasRoots;
+  auto getAliasRoot = [&](Value value) {
+    auto it = aliasRoots.find(value);
+    return it == aliasRoots.end() ? value : it->second;
+  };
+  DenseMap<Value, int> lastUses;
+  int opIndex = 0;
+  for (auto &op : streamBlock) {
+    for (auto operand : op.getOperands()) {
+      lastUses[getAliasRoot(operand)] = opIndex;
+    }
+    if (isIdentityOp(&op)) {
+      aliasRoots[op.getResult(0)] = getAliasRoot(op.getOperand(0));
+    }
+    ++opIndex;
+  }
+
+  // Assign any remaining transients on "active" ops to slots.
+  SmallVector<TransientSlot, 8> slots;
+  opIndex = 0;
+  for (auto &op : streamBlock) {
+    int firstUse = opIndex++;
     if (isNoOp(&op) || isIdentityOp(&op)) continue;
     for (auto result : op.getResults()) {
       // If the result is an output buffer we can just use that directly.
       if (bufferSet.rangeMap[result].buffer) continue;
+      auto lastUse = lastUses.lookup(result);
+      assignTransientSlot(result, firstUse, std::max(firstUse, lastUse),
+                          slots);
+    }
+  }
+  if (slots.empty()) return success();
+
+  // Lay out the slots back to back within the slab.
+  auto loc = streamOp.getLoc();
+  DenseMap<Value, Value> transientSizes;
+  SmallVector<Value, 8> slotOffsets;
+  Value slabSize = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0);
+  for (auto &slot : slots) {
+    Value slotSize = nullptr;
+    for (auto value : slot.values) {
+      auto size = computeTransientSize(value, bufferSet.allocator, rewriter);
+      if (!size) {
+        return value.getDefiningOp()->emitOpError()
+               << "unable to compute transient storage size";
+      }
+      transientSizes[value] = size;
+      slotSize = slotSize ? createMax(loc, slotSize, size, rewriter) : size;
+    }
+    slotOffsets.push_back(slabSize);
+    slabSize = rewriter.createOrFold<AddIOp>(loc, slabSize, slotSize);
+  }
 
-      auto buffer =
-          allocateTransientBuffer(result, bufferSet.allocator, rewriter);
-      bufferSet.rangeMap[result] = BufferRange{buffer};
+  // TODO(benvanik): compute from SSA use-def chain uses.
+  IREE::HAL::MemoryTypeBitfield memoryTypes =
+      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
+  IREE::HAL::BufferUsageBitfield bufferUsage =
+      IREE::HAL::BufferUsageBitfield::Dispatch |
+      IREE::HAL::BufferUsageBitfield::Transfer;
+  auto slab = rewriter
+                  .create<IREE::HAL::AllocatorAllocateOp>(
+                      loc, bufferSet.allocator, memoryTypes, bufferUsage,
+                      slabSize)
+                  .getResult();
+
+  // TODO(benvanik): implement resource sets.
+  rewriter.create<IREE::HAL::ExDeferReleaseOp>(loc, slab);
+
+  for (auto slot : llvm::enumerate(slots)) {
+    for (auto value : slot.value().values) {
+      bufferSet.rangeMap[value] = BufferRange{
+          slab, slotOffsets[slot.index()], transientSizes[value]};
     }
   }
+
+  // Push transients through identities to their results.
+  for (auto &op : streamBlock) {
+    if (isIdentityOp(&op)) {
+      auto operand = op.getOperand(0);
+      auto result = op.getResult(0);
+      if (bufferSet.rangeMap[operand].buffer &&
+          !bufferSet.rangeMap[result].buffer) {
+        bufferSet.rangeMap[result] = bufferSet.rangeMap[operand];
+      }
+    }
+  }
+  return success();
 }
 
 // Records a full execution barrier that forces visibility of all buffers.
@@ -272,8 +442,6 @@ static LogicalResult recordPushBindings(
   uint32_t setOrdinal = 0;
   uint32_t bindingOrdinal = 0;
   SmallVector<IREE::HAL::DescriptorSetBindingValue, 4> bindings;
-  auto zeroOffset =
-      rewriter.createOrFold<mlir::ConstantIndexOp>(dispatchOp.getLoc(), 0);
   auto pushBinding = [&](Value tensorValue) -> LogicalResult {
     auto &bufferRange = bufferSet.rangeMap[tensorValue];
     assert(bufferRange.buffer && "buffer not preallocated");
@@ -282,8 +450,10 @@ static LogicalResult recordPushBindings(
     auto byteLength = value.getByteLength();
     if (!byteLength) return failure();
 
-    bindings.push_back(std::make_tuple(bindingOrdinal++, value.getBuffer(),
-                                       zeroOffset, byteLength));
+    bindings.push_back(std::make_tuple(
+        bindingOrdinal++, value.getBuffer(),
+        getRangeOffset(bufferRange, dispatchOp.getLoc(), rewriter),
+        byteLength));
     return success();
   };
   for (auto inputValue : dispatchOp.operands()) {
@@ -370,7 +540,8 @@ static LogicalResult recordDispatch(Value device, Value commandBuffer,
     auto &bufferRange = bufferSet.rangeMap[value];
     assert(bufferRange.buffer && "operand buffer not allocated");
     operandAdaptors.emplace_back(IREE::HAL::TensorRewriteAdaptor{
-        dispatchOp.getLoc(), value, bufferRange.buffer, rewriter});
+        dispatchOp.getLoc(), value,
+        getRangeBuffer(bufferRange, dispatchOp.getLoc(), rewriter), rewriter});
   }
   dispatchState.operands = operandAdaptors;
   SmallVector<Optional<IREE::HAL::TensorRewriteAdaptor>, 4> resultAdaptors;
@@ -380,7 +551,8 @@ static LogicalResult recordDispatch(Value device, Value commandBuffer,
     auto &bufferRange = bufferSet.rangeMap[value];
     assert(bufferRange.buffer && "result buffer not preallocated");
     resultAdaptors.emplace_back(IREE::HAL::TensorRewriteAdaptor{
-        dispatchOp.getLoc(), value, bufferRange.buffer, rewriter});
+        dispatchOp.getLoc(), value,
+        getRangeBuffer(bufferRange, dispatchOp.getLoc(), rewriter), rewriter});
   }
   dispatchState.results = resultAdaptors;
 
@@ -427,8 +599,9 @@ static LogicalResult recordTensorUpdate(Value device, Value commandBuffer,
   IREE::HAL::TensorRewriteAdaptor result(updateOp.getLoc(), updateOp.result(),
                                          resultBuffer.buffer, rewriter);
 
-  auto zeroOffset =
-      rewriter.createOrFold<mlir::ConstantIndexOp>(updateOp.getLoc(), 0);
+  auto updateOffset = getRangeOffset(updateBuffer, updateOp.getLoc(), rewriter);
+  auto targetOffset = getRangeOffset(targetBuffer, updateOp.getLoc(), rewriter);
+  auto resultOffset = getRangeOffset(resultBuffer, updateOp.getLoc(), rewriter);
 
   // Compute the size of the update range.
   auto startIndices = llvm::to_vector<4>(llvm::map_range(
@@ -444,13 +617,16 @@ static LogicalResult recordTensorUpdate(Value device, Value commandBuffer,
   if (!targetByteLength) return failure();
 
   rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
-      updateOp.getLoc(), commandBuffer, target.getBuffer(), zeroOffset,
-      result.getBuffer(), zeroOffset, targetByteLength);
+      updateOp.getLoc(), commandBuffer, target.getBuffer(), targetOffset,
+      result.getBuffer(), resultOffset, targetByteLength);
   // TODO(benvanik): slice left/mid/right, but really just don't do this.
   recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
   rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
-      updateOp.getLoc(), commandBuffer, update.getBuffer(), zeroOffset,
-      result.getBuffer(), targetRange->offset, targetRange->length);
+      updateOp.getLoc(), commandBuffer, update.getBuffer(), updateOffset,
+      result.getBuffer(),
+      rewriter.createOrFold<AddIOp>(updateOp.getLoc(), resultOffset,
+                                    targetRange->offset),
+      targetRange->length);
 
   // TODO(benvanik): implement resource sets.
   rewriter.create<IREE::HAL::ExDeferReleaseOp>(updateOp.getLoc(),
@@ -531,7 +707,9 @@ class ExStreamFragmentOpConversion
 
     // Allocate buffers for outputs and transient buffers.
     allocateOutputBuffers(streamOp, bufferSet, rewriter);
-    allocateTransientBuffers(streamOp, bufferSet, rewriter);
+    if (failed(allocateTransientBuffers(streamOp, bufferSet, rewriter))) {
+      return failure();
+    }
 
     // Allocate and begin the command buffer.
     // In a real version we would want to pick the device based on the placement
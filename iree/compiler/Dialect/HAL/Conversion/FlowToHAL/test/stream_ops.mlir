@@ -47,6 +47,49 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
 
 // -----
 
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.entry_point @entry0 attributes {
+    interface = @interface,
+    ordinal = 0 : i32,
+    signature = (tensor<128xf32>) -> tensor<128xf32>
+  }
+  hal.executable.target "vmla" {
+    module {}
+  }
+}
+
+// CHECK-LABEL: func @transientSlab
+func @transientSlab(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  // CHECK: [[RET_BUF:%.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal"
+  // CHECK: [[SLAB:%.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch"
+  // CHECK-NEXT: hal.ex.defer_release [[SLAB]]
+  // CHECK-NOT: hal.allocator.allocate
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    // Transients alternate between two slots as each dies once it has been
+    // consumed by the next dispatch.
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%arg0, %c0, {{.+}}), 1 = ([[SLAB]], %c0, {{.+}})]
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = ([[SLAB]], %c0, {{.+}}), 1 = ([[SLAB]], [[SLOT1:%.+]], {{.+}})]
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = ([[SLAB]], [[SLOT1]], {{.+}}), 1 = ([[SLAB]], %c0, {{.+}})]
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = ([[SLAB]], %c0, {{.+}}), 1 = ([[SLAB]], [[SLOT1]], {{.+}})]
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : index](%3) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = ([[SLAB]], [[SLOT1]], {{.+}}), 1 = ([[RET_BUF]], %c0, {{.+}})]
+    %5 = flow.dispatch @ex0::@entry0[%arg1 : index](%4) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %5 : tensor<128xf32>
+  }
+  // CHECK: return [[RET_BUF]]
+  return %0 : tensor<128xf32>
+}
+
+// -----
+
 // CHECK-LABEL: @tensorUpdate
 // CHECK-SAME: ([[UBUF:%.+]]:{{.+}}, [[TBUF:%.+]]:{{.+}})
 func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> tensor<5x1x10xf32> {
@@ -163,6 +163,62 @@ class CommandBufferPushDescriptorSetOpConversion
   mutable IREE::VM::ImportOp importOp;
 };
 
+class CommandBufferPushDescriptorSetSlotsOpConversion
+    : public OpConversionPattern<
+          IREE::HAL::CommandBufferPushDescriptorSetSlotsOp> {
+ public:
+  CommandBufferPushDescriptorSetSlotsOpConversion(MLIRContext *context,
+                                                  SymbolTable &importSymbols,
+                                                  TypeConverter &typeConverter,
+                                                  StringRef importName)
+      : OpConversionPattern(context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+  }
+
+  LogicalResult matchAndRewrite(
+      IREE::HAL::CommandBufferPushDescriptorSetSlotsOp op,
+      llvm::ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto importType = importOp.getType();
+    IREE::HAL::CommandBufferPushDescriptorSetSlotsOpOperandAdaptor newOperands(
+        operands);
+
+    SmallVector<Value, 8> callOperands = {
+        newOperands.command_buffer(),
+        newOperands.executable_layout(),
+        rewriter.create<mlir::ConstantOp>(
+            op.getLoc(), rewriter.getI32IntegerAttr(
+                             static_cast<int32_t>(op.setAttr().getInt()))),
+    };
+    SmallVector<int16_t, 5> segmentSizes = {
+        /*command_buffer=*/-1,
+        /*executable_layout=*/-1,
+        /*set=*/-1,
+        /*bindings_ordinals=*/
+        static_cast<int16_t>(op.bindings().size()),
+        /*bindings_slots=*/
+        static_cast<int16_t>(op.bindings().size()),
+    };
+    for (auto bindingAttr : op.bindings()) {
+      callOperands.push_back(
+          rewriter.create<mlir::ConstantOp>(op.getLoc(), bindingAttr));
+    }
+    for (auto slotAttr : op.binding_slots()) {
+      callOperands.push_back(
+          rewriter.create<mlir::ConstantOp>(op.getLoc(), slotAttr));
+    }
+
+    rewriter.replaceOpWithNewOp<IREE::VM::CallVariadicOp>(
+        op, rewriter.getSymbolRefAttr(importOp), importType.getResults(),
+        segmentSizes, importType.getInputs(), callOperands);
+    return success();
+  }
+
+ private:
+  mutable IREE::VM::ImportOp importOp;
+};
+
 }  // namespace
 
 void populateHALCommandBufferToVMPatterns(MLIRContext *context,
@@ -191,6 +247,9 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
   patterns.insert<CommandBufferPushDescriptorSetOpConversion>(
       context, importSymbols, typeConverter,
       "hal.command_buffer.push_descriptor_set");
+  patterns.insert<CommandBufferPushDescriptorSetSlotsOpConversion>(
+      context, importSymbols, typeConverter,
+      "hal.command_buffer.push_descriptor_set.slots");
   patterns.insert<
       VMImportOpConversion<IREE::HAL::CommandBufferBindDescriptorSetOp>>(
       context, importSymbols, typeConverter,
@@ -201,6 +260,8 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
       .insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchIndirectOp>>(
           context, importSymbols, typeConverter,
           "hal.command_buffer.dispatch.indirect");
+  patterns.insert<VMImportOpConversion<IREE::HAL::CommandBufferBindOp>>(
+      context, importSymbols, typeConverter, "hal.command_buffer.bind");
 }
 
 }  // namespace iree_compiler
@@ -59,6 +59,17 @@ func @command_buffer_copy_buffer(%arg0 : !hal.command_buffer, %arg1 : !hal.buffe
 
 // -----
 
+// CHECK-LABEL: @command_buffer_push_descriptor_set_slots
+func @command_buffer_push_descriptor_set_slots(
+    %arg0 : !hal.command_buffer,
+    %arg1 : !hal.executable_layout) {
+  // CHECK: vm.call.variadic @hal.command_buffer.push_descriptor_set.slots(%arg0, %arg1, %zero, [{{.+}}], [{{.+}}]) : (!vm.ref<!hal.command_buffer>, !vm.ref<!hal.executable_layout>, i32, i32..., i32...)
+  hal.command_buffer.push_descriptor_set.slots %arg0, %arg1, set = 0, bindings = [0 : i32, 1 : i32], slots = [1 : i32, 0 : i32]
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_bind_descriptor_set
 func @command_buffer_bind_descriptor_set(
     %arg0 : !hal.command_buffer,
@@ -96,3 +107,17 @@ func @command_buffer_dispatch_indirect(
   hal.command_buffer.dispatch.indirect %arg0, %arg1, entry_point=0, workgroups=%arg2[%c100]
   return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_bind
+func @command_buffer_bind(
+    %arg0 : !hal.command_buffer,
+    %arg1 : !hal.buffer,
+    %arg2 : !hal.buffer) -> !hal.command_buffer {
+  %c100 = constant 100 : index
+  %c200 = constant 200 : index
+  // CHECK: %ref = vm.call.variadic @hal.command_buffer.bind(%arg0, [%arg1, %arg2], [%c100, %c100], [%c200, %c200]) : (!vm.ref<!hal.command_buffer>, !vm.ref<!hal.buffer>..., i32..., i32...) -> !vm.ref<!hal.command_buffer>
+  %0 = hal.command_buffer.bind %arg0, buffers = [%arg1, %arg2], offsets = [%c100, %c100], lengths = [%c200, %c200] : !hal.command_buffer
+  return %0 : !hal.command_buffer
+}
@@ -831,6 +831,23 @@ static void printCommandBufferPushDescriptorSetOp(
                           });
 }
 
+//===----------------------------------------------------------------------===//
+// hal.command_buffer.push_descriptor_set.slots
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verifyCommandBufferPushDescriptorSetSlotsOp(
+    CommandBufferPushDescriptorSetSlotsOp op) {
+  if (op.binding_slots().size() != op.bindings().size()) {
+    return op.emitOpError() << "requires one slot per binding";
+  }
+  for (auto slotAttr : op.binding_slots()) {
+    if (slotAttr.cast<IntegerAttr>().getInt() < 0) {
+      return op.emitOpError() << "binding table slots must be non-negative";
+    }
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // hal.command_buffer.bind_descriptor_set
 //===----------------------------------------------------------------------===//
@@ -862,6 +879,19 @@ void CommandBufferDispatchOp::build(
                                              entryPoint.ordinal()));
 }
 
+//===----------------------------------------------------------------------===//
+// hal.command_buffer.bind
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verifyCommandBufferBindOp(CommandBufferBindOp op) {
+  // Buffers, offsets, and lengths share the variadic operands evenly.
+  if ((op.getNumOperands() - 1) % 3 != 0) {
+    return op.emitOpError()
+           << "requires one offset and length per binding table buffer";
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // hal.descriptor_set.create
 //===----------------------------------------------------------------------===//
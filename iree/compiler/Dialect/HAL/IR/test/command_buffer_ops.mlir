@@ -92,6 +92,16 @@ func @command_buffer_copy_buffer(%arg0 : !hal.command_buffer) {
 
 // -----
 
+// CHECK-LABEL: @command_buffer_push_descriptor_set_slots
+func @command_buffer_push_descriptor_set_slots(%arg0 : !hal.command_buffer) {
+  %0 = "test_hal.executable_layout"() : () -> !hal.executable_layout
+  // CHECK: hal.command_buffer.push_descriptor_set.slots %arg0, %0, set = 0, bindings = [0 : i32, 1 : i32], slots = [1 : i32, 0 : i32]
+  hal.command_buffer.push_descriptor_set.slots %arg0, %0, set = 0, bindings = [0 : i32, 1 : i32], slots = [1 : i32, 0 : i32]
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_bind_descriptor_set
 func @command_buffer_bind_descriptor_set(%arg0 : !hal.command_buffer) {
   %0 = "test_hal.executable_layout"() : () -> !hal.executable_layout
@@ -128,3 +138,16 @@ func @command_buffer_dispatch_indirect(%arg0 : !hal.command_buffer) {
   hal.command_buffer.dispatch.indirect %arg0, %0, entry_point = 0, workgroups = %1[%2]
   return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_bind
+func @command_buffer_bind(%arg0 : !hal.command_buffer) -> !hal.command_buffer {
+  %0 = "test_hal.buffer"() : () -> !hal.buffer
+  %1 = "test_hal.buffer"() : () -> !hal.buffer
+  %2 = "test_hal.offset"() : () -> index
+  %3 = "test_hal.length"() : () -> index
+  // CHECK: %4 = hal.command_buffer.bind %arg0, buffers = [%0, %1], offsets = [%2, %2], lengths = [%3, %3] : !hal.command_buffer
+  %4 = hal.command_buffer.bind %arg0, buffers = [%0, %1], offsets = [%2, %2], lengths = [%3, %3] : !hal.command_buffer
+  return %4 : !hal.command_buffer
+}
@@ -19,11 +19,25 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Translation/CodegenPasses/Passes.h"
 #include "iree/compiler/Translation/CodegenUtils/CodegenUtils.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
 #include "mlir/Conversion/LinalgToLLVM/LinalgToLLVM.h"
 #include "mlir/Conversion/LoopToStandard/ConvertLoopToStandard.h"
 #include "mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h"
@@ -35,6 +49,7 @@
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Target/LLVMIR.h"
 #include "mlir/Transforms/Passes.h"
+#include "tensorflow/compiler/mlir/xla/ir/hlo_ops.h"
 
 namespace mlir {
 namespace iree_compiler {
@@ -42,14 +57,33 @@ namespace IREE {
 namespace HAL {
 
 LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
+  static llvm::cl::opt<std::string> clTargetTriple(
+      "iree-llvm-target-triple",
+      llvm::cl::desc("LLVM target triple used for ahead-of-time compilation; "
+                     "defaults to the host"),
+      llvm::cl::init(""));
+  static llvm::cl::opt<std::string> clLinkerPath(
+      "iree-llvm-linker-path",
+      llvm::cl::desc("Linker used to produce ahead-of-time compiled shared "
+                     "libraries; defaults to ld.lld or ld on the PATH"),
+      llvm::cl::init(""));
+
   LLVMTargetOptions targetOptions;
+  targetOptions.targetTriple = clTargetTriple;
+  targetOptions.linkerPath = clLinkerPath;
   return targetOptions;
 }
 
 // TODO(ataei): This is written as a stub in LLVM IR. It would be easier to have
 // this using MLIR and lower it to LLVM like the dispatch function
 // implementation is.
+//
+// The runtime passes the workgroup ID and count as two trailing uint32_t[3]
+// pointers after the function arguments. When |sliceElementCount| is non-zero
+// the dispatch function was partitioned by PartitionWorkgroupsPass and each
+// argument is offset to the slice selected by workgroup ID x.
 static void createInvocationFunc(const std::string& name,
+                                 int64_t sliceElementCount,
                                  llvm::Module* module) {
   auto& ctx = module->getContext();
   llvm::IRBuilder<> builder(ctx);
@@ -68,6 +102,19 @@ static void createInvocationFunc(const std::string& name,
   bb->insertInto(interface_func);
   builder.SetInsertPoint(bb);
   llvm::Value* argList = interface_func->arg_begin();
+
+  llvm::Value* slice_offset = nullptr;
+  if (sliceElementCount) {
+    llvm::Value* workgroup_id_ptr = builder.CreateLoad(
+        builder.CreateGEP(argList, builder.getInt64(var_func->arg_size())));
+    workgroup_id_ptr = builder.CreateBitCast(
+        workgroup_id_ptr, builder.getInt32Ty()->getPointerTo());
+    llvm::Value* workgroup_id_x = builder.CreateZExt(
+        builder.CreateLoad(workgroup_id_ptr), builder.getInt64Ty());
+    slice_offset =
+        builder.CreateMul(workgroup_id_x, builder.getInt64(sliceElementCount));
+  }
+
   llvm::SmallVector<llvm::Value*, 8> args;
   args.reserve(llvm::size(var_func->args()));
   for (auto& indexedArg : llvm::enumerate(var_func->args())) {
@@ -78,12 +125,111 @@ static void createInvocationFunc(const std::string& name,
     arg_ptr = builder.CreateBitCast(
         arg_ptr, indexedArg.value().getType()->getPointerTo());
     llvm::Value* arg = builder.CreateLoad(arg_ptr);
+    if (slice_offset) {
+      // Arguments are pointers to memref descriptors; pass a copy of the
+      // descriptor with its aligned data pointer advanced to the slice.
+      llvm::Value* descriptor = builder.CreateLoad(arg);
+      llvm::Value* aligned_ptr = builder.CreateExtractValue(descriptor, 1);
+      descriptor = builder.CreateInsertValue(
+          descriptor, builder.CreateGEP(aligned_ptr, slice_offset), 1);
+      arg = builder.CreateAlloca(descriptor->getType());
+      builder.CreateStore(descriptor, arg);
+    }
     args.push_back(arg);
   }
   builder.CreateCall(var_func, args);
   builder.CreateRetVoid();
 }
 
+// Creates a target machine producing position-independent code for the target
+// triple in |options| (or the host when unspecified).
+static std::unique_ptr<llvm::TargetMachine> createTargetMachine(
+    const LLVMTargetOptions& options, std::string& errorMessage) {
+  static bool nativeTargetInitialized = []() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    return true;
+  }();
+  (void)nativeTargetInitialized;
+
+  bool isHost = options.targetTriple.empty();
+  std::string triple =
+      isHost ? llvm::sys::getProcessTriple() : options.targetTriple;
+  auto* target = llvm::TargetRegistry::lookupTarget(triple, errorMessage);
+  if (!target) return nullptr;
+  std::string cpu = isHost ? llvm::sys::getHostCPUName().str() : "generic";
+  return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+      triple, cpu, /*Features=*/"", llvm::TargetOptions(), llvm::Reloc::PIC_));
+}
+
+// Compiles |module| with |targetMachine| into an object file.
+static LogicalResult emitObjectFile(llvm::Module& module,
+                                    llvm::TargetMachine& targetMachine,
+                                    std::string& objectData) {
+  llvm::SmallVector<char, 0> buffer;
+  llvm::raw_svector_ostream ostream(buffer);
+  llvm::legacy::PassManager passManager;
+  if (targetMachine.addPassesToEmitFile(passManager, ostream,
+                                        /*DwoOut=*/nullptr,
+                                        llvm::CGFT_ObjectFile)) {
+    return failure();
+  }
+  passManager.run(module);
+  objectData.assign(buffer.begin(), buffer.end());
+  return success();
+}
+
+// Links |objectData| into a shared library with the linker at |linkerPath|
+// (or ld.lld/ld from the PATH) and returns the library contents.
+static LogicalResult linkSharedLibrary(StringRef objectData,
+                                       StringRef linkerPath,
+                                       std::string& libraryData,
+                                       std::string& errorMessage) {
+  auto linkerOr = linkerPath.empty() ? llvm::sys::findProgramByName("ld.lld")
+                                     : llvm::sys::findProgramByName(linkerPath);
+  if (!linkerOr && linkerPath.empty()) {
+    linkerOr = llvm::sys::findProgramByName("ld");
+  }
+  if (!linkerOr) {
+    errorMessage = "linker not found";
+    return failure();
+  }
+
+  llvm::SmallString<64> objectPath;
+  llvm::SmallString<64> libraryPath;
+  if (llvm::sys::fs::createTemporaryFile("iree-llvm-aot", "o", objectPath) ||
+      llvm::sys::fs::createTemporaryFile("iree-llvm-aot", "so", libraryPath)) {
+    errorMessage = "unable to create temporary files";
+    return failure();
+  }
+  llvm::FileRemover objectRemover(objectPath);
+  llvm::FileRemover libraryRemover(libraryPath);
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream objectFile(objectPath, ec);
+    if (ec) {
+      errorMessage = ec.message();
+      return failure();
+    }
+    objectFile << objectData;
+  }
+
+  StringRef args[] = {*linkerOr, "-shared", "-o", libraryPath, objectPath};
+  if (llvm::sys::ExecuteAndWait(*linkerOr, args, /*Env=*/llvm::None,
+                                /*Redirects=*/{}, /*SecondsToWait=*/0,
+                                /*MemoryLimit=*/0, &errorMessage) != 0) {
+    return failure();
+  }
+
+  auto libraryBuffer = llvm::MemoryBuffer::getFile(libraryPath);
+  if (!libraryBuffer) {
+    errorMessage = libraryBuffer.getError().message();
+    return failure();
+  }
+  libraryData = (*libraryBuffer)->getBuffer().str();
+  return success();
+}
+
 namespace {
 
 /// Clones the dispatch function implementation into a module to be later passed
@@ -128,20 +274,211 @@ struct PrepareForLLVMLoweringPass
   }
 };
 
+/// Module attribute mapping the name of each partitioned dispatch function to
+/// [workgroup count, number of elements per workgroup slice].
+static const char* kWorkgroupPartitionsAttr = "llvm.workgroup_partitions";
+
+/// Upper bound on the number of workgroups a dispatch is partitioned into.
+static const int64_t kMaxWorkgroupCount = 64;
+
+/// Minimum number of elements each workgroup processes. Below this the cost of
+/// invoking the dispatch function for each workgroup dominates.
+static const int64_t kMinWorkgroupElementCount = 16 * 1024;
+
+/// Returns true if each element of the results of |op| is computed only from
+/// the operand elements at the same index.
+static bool isElementwiseOp(Operation* op) {
+  return isa<xla_hlo::AddOp>(op) || isa<xla_hlo::SubOp>(op) ||
+         isa<xla_hlo::DivOp>(op) || isa<xla_hlo::MulOp>(op) ||
+         isa<xla_hlo::PowOp>(op) || isa<xla_hlo::RemOp>(op) ||
+         isa<xla_hlo::ShiftLeftOp>(op) ||
+         isa<xla_hlo::ShiftRightArithmeticOp>(op) ||
+         isa<xla_hlo::ShiftRightLogicalOp>(op) || isa<xla_hlo::AndOp>(op) ||
+         isa<xla_hlo::OrOp>(op) || isa<xla_hlo::XorOp>(op) ||
+         isa<xla_hlo::ExpOp>(op) || isa<xla_hlo::LogOp>(op) ||
+         isa<xla_hlo::FloorOp>(op) || isa<xla_hlo::RsqrtOp>(op) ||
+         isa<xla_hlo::SqrtOp>(op) || isa<xla_hlo::CosOp>(op) ||
+         isa<xla_hlo::SinOp>(op) || isa<xla_hlo::TanhOp>(op) ||
+         isa<xla_hlo::Atan2Op>(op) || isa<xla_hlo::SelectOp>(op) ||
+         isa<xla_hlo::ConvertOp>(op) || isa<xla_hlo::AbsOp>(op) ||
+         isa<xla_hlo::NegOp>(op) || isa<xla_hlo::MaxOp>(op) ||
+         isa<xla_hlo::MinOp>(op) || isa<xla_hlo::ClampOp>(op);
+}
+
+/// Returns true if |type| is a statically shaped non-scalar tensor of |shape|.
+/// |shape| is taken from |type| if it is empty.
+static bool matchShape(Type type, ArrayRef<int64_t>& shape) {
+  auto tensorType = type.dyn_cast<RankedTensorType>();
+  if (!tensorType || !tensorType.hasStaticShape() ||
+      tensorType.getRank() == 0) {
+    return false;
+  }
+  if (shape.empty()) shape = tensorType.getShape();
+  return tensorType.getShape() == shape;
+}
+
+/// Returns the implementation function called by the dispatch function
+/// |funcOp| if the dispatch can be partitioned along the outermost dimension
+/// of its tensors, storing their shared shape in |shape|. Only dispatches that
+/// load tensors, call an implementation computing on them elementwise, and
+/// store the results are partitioned as each workgroup can then process the
+/// same contiguous slice of every binding.
+static FuncOp matchPartitionableDispatch(FuncOp funcOp,
+                                         SymbolTable& symbolTable,
+                                         ArrayRef<int64_t>& shape) {
+  if (funcOp.getBlocks().size() != 1) return nullptr;
+  auto matchesShape = [&](Type type) { return matchShape(type, shape); };
+  FuncOp implFuncOp;
+  for (auto& op : funcOp.front()) {
+    if (auto callOp = dyn_cast<mlir::CallOp>(op)) {
+      if (implFuncOp) return nullptr;
+      implFuncOp = symbolTable.lookup<FuncOp>(callOp.callee());
+    } else if (auto loadOp = dyn_cast<IREE::HAL::InterfaceLoadTensorOp>(op)) {
+      if (!matchesShape(loadOp.result().getType())) return nullptr;
+    } else if (auto storeOp = dyn_cast<IREE::HAL::InterfaceStoreTensorOp>(op)) {
+      if (!matchesShape(storeOp.operand().getType())) return nullptr;
+    } else if (auto constantOp = dyn_cast<mlir::ConstantOp>(op)) {
+      if (!constantOp.getType().isIndex()) return nullptr;
+    } else if (!isa<mlir::ReturnOp>(op)) {
+      return nullptr;
+    }
+  }
+  if (!implFuncOp || implFuncOp.getBlocks().size() != 1) return nullptr;
+
+  auto implType = implFuncOp.getType();
+  if (!llvm::all_of(implType.getInputs(), matchesShape) ||
+      !llvm::all_of(implType.getResults(), matchesShape)) {
+    return nullptr;
+  }
+  for (auto& op : implFuncOp.front()) {
+    if (isa<mlir::ReturnOp>(op)) continue;
+    if (!isElementwiseOp(&op) ||
+        !llvm::all_of(op.getOperandTypes(), matchesShape) ||
+        !llvm::all_of(op.getResultTypes(), matchesShape)) {
+      return nullptr;
+    }
+  }
+  return implFuncOp;
+}
+
+/// Returns the number of workgroups a dispatch over tensors of |shape| is
+/// partitioned into along the outermost dimension.
+static int64_t calculateWorkgroupCount(ArrayRef<int64_t> shape) {
+  int64_t elementsPerRow = 1;
+  for (auto dim : shape.drop_front()) elementsPerRow *= dim;
+  for (int64_t workgroupCount = std::min(shape.front(), kMaxWorkgroupCount);
+       workgroupCount > 1; --workgroupCount) {
+    if (shape.front() % workgroupCount == 0 &&
+        (shape.front() / workgroupCount) * elementsPerRow >=
+            kMinWorkgroupElementCount) {
+      return workgroupCount;
+    }
+  }
+  return 1;
+}
+
+/// Retypes all tensor values defined in |block| to their slice along the
+/// outermost dimension when partitioned into |workgroupCount| workgroups.
+static void retypeToSlice(Block& block, int64_t workgroupCount) {
+  auto getSliceType = [&](Type type) -> Type {
+    auto tensorType = type.dyn_cast<RankedTensorType>();
+    if (!tensorType) return type;
+    SmallVector<int64_t, 4> sliceShape(tensorType.getShape().begin(),
+                                       tensorType.getShape().end());
+    sliceShape.front() /= workgroupCount;
+    return RankedTensorType::get(sliceShape, tensorType.getElementType());
+  };
+  for (auto arg : block.getArguments()) {
+    arg.setType(getSliceType(arg.getType()));
+  }
+  for (auto& op : block) {
+    for (auto result : op.getResults()) {
+      result.setType(getSliceType(result.getType()));
+    }
+  }
+}
+
+/// Partitions elementwise dispatches into multiple workgroups along the
+/// outermost dimension of their tensors. The dispatch is retyped to process a
+/// single slice and the invocation function created during serialization
+/// offsets the bindings to the slice selected by the workgroup ID.
+struct PartitionWorkgroupsPass
+    : PassWrapper<PartitionWorkgroupsPass, OperationPass<ModuleOp>> {
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SymbolTable symbolTable(moduleOp);
+    Builder builder(&getContext());
+    SmallVector<NamedAttribute, 4> partitions;
+    for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+      if (SymbolTable::getSymbolVisibility(funcOp) !=
+          SymbolTable::Visibility::Public) {
+        continue;
+      }
+      ArrayRef<int64_t> shape;
+      auto implFuncOp = matchPartitionableDispatch(funcOp, symbolTable, shape);
+      if (!implFuncOp) continue;
+      int64_t workgroupCount = calculateWorkgroupCount(shape);
+      if (workgroupCount <= 1) continue;
+
+      retypeToSlice(funcOp.front(), workgroupCount);
+      retypeToSlice(implFuncOp.front(), workgroupCount);
+      auto& implBlock = implFuncOp.front();
+      SmallVector<Type, 4> inputTypes;
+      for (auto arg : implBlock.getArguments()) {
+        inputTypes.push_back(arg.getType());
+      }
+      auto returnOp = cast<mlir::ReturnOp>(implBlock.getTerminator());
+      SmallVector<Type, 4> resultTypes(returnOp.getOperandTypes().begin(),
+                                       returnOp.getOperandTypes().end());
+      implFuncOp.setType(builder.getFunctionType(inputTypes, resultTypes));
+
+      int64_t sliceElementCount = 1;
+      for (auto dim : shape) sliceElementCount *= dim;
+      sliceElementCount /= workgroupCount;
+      partitions.push_back(builder.getNamedAttr(
+          funcOp.getName(),
+          builder.getI64ArrayAttr({workgroupCount, sliceElementCount})));
+    }
+    if (!partitions.empty()) {
+      moduleOp.setAttr(kWorkgroupPartitionsAttr,
+                       builder.getDictionaryAttr(partitions));
+    }
+  }
+};
+
+/// Returns the [workgroup count, slice element count] recorded by
+/// PartitionWorkgroupsPass for the dispatch function |name| or [1, 0] if the
+/// dispatch was not partitioned.
+static std::pair<int64_t, int64_t> getWorkgroupPartition(ModuleOp moduleOp,
+                                                         StringRef name) {
+  auto partitions =
+      moduleOp.getAttrOfType<DictionaryAttr>(kWorkgroupPartitionsAttr);
+  if (!partitions) return {1, 0};
+  auto partition = partitions.get(name).dyn_cast_or_null<ArrayAttr>();
+  if (!partition) return {1, 0};
+  return {partition.getValue()[0].cast<IntegerAttr>().getInt(),
+          partition.getValue()[1].cast<IntegerAttr>().getInt()};
+}
+
 }  // namespace
 
-class LLVMIRTargetBackend final : public TargetBackend {
+// Shared lowering from HLO to LLVM IR for the LLVM-based backends. Backends
+// differ only in how they serialize the resulting LLVM module.
+class LLVMBaseTargetBackend : public TargetBackend {
  public:
-  LLVMIRTargetBackend(LLVMTargetOptions options)
+  explicit LLVMBaseTargetBackend(LLVMTargetOptions options)
       : options_(std::move(options)) {}
 
-  // NOTE: we could vary this based on the options, such as by arch/etc.
-  std::string name() const override { return "llvm*"; }
+  // The LLVM drivers record into in-process command buffers.
+  bool supportsCommandBufferBindingTables() const override { return true; }
 
   // Adds a sequence of passess to a given pass manager that progressively lower
   // from HLO to LLVM throught linalg dialect.
   void buildTranslationPassPipeline(IREE::HAL::ExecutableTargetOp targetOp,
                                     OpPassManager& passManager) override {
+    // Split elementwise dispatches into workgroups executed in parallel.
+    passManager.addPass(std::make_unique<PartitionWorkgroupsPass>());
+
     // Convert IREE's hal.interface accesses to memrefs.
     passManager.addPass(createHALInterfaceToMemrefPass());
 
@@ -177,9 +514,12 @@ class LLVMIRTargetBackend final : public TargetBackend {
     // At this moment we are leaving MLIR LLVM dialect land translating module
     // into target independent LLVMIR.
     auto llvmModule = mlir::translateModuleToLLVMIR(targetOp.getInnerModule());
+    if (!llvmModule) {
+      return targetOp.emitError() << "failed to translate module to LLVM IR";
+    }
 
     // Create invocation function an populate entry_points.
-    iree::LLVMIRExecutableDefT llvmIrExecutableDef;
+    SmallVector<std::string, 4> entryPointNames;
     auto executableOp = cast<IREE::HAL::ExecutableOp>(targetOp.getParentOp());
     auto entryPointOps =
         executableOp.getBlock().getOps<IREE::HAL::ExecutableEntryPointOp>();
@@ -188,14 +528,74 @@ class LLVMIRTargetBackend final : public TargetBackend {
       std::string funcName =
           addCInterface ? "_mlir_ciface_" + std::string(entryPointOp.sym_name())
                         : std::string(entryPointOp.sym_name());
-      llvmIrExecutableDef.entry_points.push_back(funcName);
-      createInvocationFunc(funcName, llvmModule.get());
+      entryPointNames.push_back(funcName);
+      auto partition = getWorkgroupPartition(targetOp.getInnerModule(),
+                                             entryPointOp.sym_name());
+      createInvocationFunc(funcName, partition.second, llvmModule.get());
+    }
+
+    return serializeLLVMModule(targetOp, *llvmModule, entryPointNames,
+                               executableBuilder);
+  }
+
+  // Dispatches the number of workgroups PartitionWorkgroupsPass partitioned
+  // the entry point into. Each workgroup processes the slice of the workload
+  // selected by its workgroup ID and dispatches that were not partitioned
+  // process the entire workload in a single workgroup.
+  std::array<Value, 3> calculateDispatchWorkgroupCount(
+      Location loc, IREE::HAL::ExecutableOp executableOp,
+      IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
+      OpBuilder& builder) override {
+    int64_t workgroupCount = 1;
+    for (auto executableTargetOp :
+         executableOp.getBlock().getOps<IREE::HAL::ExecutableTargetOp>()) {
+      if (matchPattern(executableTargetOp.target_backend(), name())) {
+        workgroupCount =
+            getWorkgroupPartition(executableTargetOp.getInnerModule(),
+                                  entryPointOp.sym_name())
+                .first;
+        break;
+      }
     }
+    auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
+    return {
+        builder.createOrFold<mlir::ConstantIndexOp>(loc, workgroupCount),
+        constantOne,
+        constantOne,
+    };
+  }
+
+ protected:
+  // Serializes |llvmModule| into a hal.executable.binary. Each entry point in
+  // |entryPointNames| has an `invoke_` wrapper taking a packed argument list.
+  virtual LogicalResult serializeLLVMModule(
+      IREE::HAL::ExecutableTargetOp targetOp, llvm::Module& llvmModule,
+      ArrayRef<std::string> entryPointNames, OpBuilder& executableBuilder) = 0;
+
+  LLVMTargetOptions options_;
+};
+
+// Embeds textual LLVM IR that is JIT compiled by the runtime when loaded.
+class LLVMIRTargetBackend final : public LLVMBaseTargetBackend {
+ public:
+  using LLVMBaseTargetBackend::LLVMBaseTargetBackend;
+
+  // NOTE: we could vary this based on the options, such as by arch/etc.
+  std::string name() const override { return "llvm*"; }
+
+ protected:
+  LogicalResult serializeLLVMModule(IREE::HAL::ExecutableTargetOp targetOp,
+                                    llvm::Module& llvmModule,
+                                    ArrayRef<std::string> entryPointNames,
+                                    OpBuilder& executableBuilder) override {
+    iree::LLVMIRExecutableDefT llvmIrExecutableDef;
+    llvmIrExecutableDef.entry_points = {entryPointNames.begin(),
+                                        entryPointNames.end()};
 
     // Serialize LLVM module.
     std::string bufferString;
     llvm::raw_string_ostream ostream(bufferString);
-    llvmModule->print(ostream, nullptr);
+    llvmModule.print(ostream, nullptr);
     ostream.flush();
 
     // Creates executable bytes.
@@ -218,9 +618,63 @@ class LLVMIRTargetBackend final : public TargetBackend {
 
     return success();
   }
+};
 
- private:
-  LLVMTargetOptions options_;
+// Compiles ahead-of-time to a native shared library that the runtime loads
+// with the platform dynamic loader. No LLVM is required at runtime.
+class LLVMAOTTargetBackend final : public LLVMBaseTargetBackend {
+ public:
+  using LLVMBaseTargetBackend::LLVMBaseTargetBackend;
+
+  std::string name() const override { return "dylib*"; }
+
+ protected:
+  LogicalResult serializeLLVMModule(IREE::HAL::ExecutableTargetOp targetOp,
+                                    llvm::Module& llvmModule,
+                                    ArrayRef<std::string> entryPointNames,
+                                    OpBuilder& executableBuilder) override {
+    std::string errorMessage;
+    auto targetMachine = createTargetMachine(options_, errorMessage);
+    if (!targetMachine) {
+      return targetOp.emitError()
+             << "failed to create target machine: " << errorMessage;
+    }
+    llvmModule.setDataLayout(targetMachine->createDataLayout());
+    llvmModule.setTargetTriple(targetMachine->getTargetTriple().str());
+
+    std::string objectData;
+    if (failed(emitObjectFile(llvmModule, *targetMachine, objectData))) {
+      return targetOp.emitError() << "failed to emit object file";
+    }
+    std::string libraryData;
+    if (failed(linkSharedLibrary(objectData, options_.linkerPath, libraryData,
+                                 errorMessage))) {
+      return targetOp.emitError()
+             << "failed to link shared library: " << errorMessage;
+    }
+
+    iree::DyLibExecutableDefT dyLibExecutableDef;
+    dyLibExecutableDef.entry_points = {entryPointNames.begin(),
+                                       entryPointNames.end()};
+    dyLibExecutableDef.library_embedded = {libraryData.begin(),
+                                           libraryData.end()};
+
+    ::flatbuffers::FlatBufferBuilder fbb;
+    auto executableOffset =
+        iree::DyLibExecutableDef::Pack(fbb, &dyLibExecutableDef);
+    iree::FinishDyLibExecutableDefBuffer(fbb, executableOffset);
+    std::vector<uint8_t> bytes;
+    bytes.resize(fbb.GetSize());
+    std::memcpy(bytes.data(), fbb.GetBufferPointer(), bytes.size());
+
+    // Add the binary data to the target executable.
+    executableBuilder.create<IREE::HAL::ExecutableBinaryOp>(
+        targetOp.getLoc(),
+        static_cast<uint32_t>(IREE::HAL::ExecutableFormat::DyLib),
+        std::move(bytes));
+
+    return success();
+  }
 };
 
 void registerLLVMTargetBackends(
@@ -229,6 +683,9 @@ void registerLLVMTargetBackends(
   static TargetBackendRegistration registration("llvm-ir", [=]() {
     return std::make_unique<LLVMIRTargetBackend>(queryOptions());
   });
+  static TargetBackendRegistration aotRegistration("dylib-llvm-aot", [=]() {
+    return std::make_unique<LLVMAOTTargetBackend>(queryOptions());
+  });
 }
 
 }  // namespace HAL
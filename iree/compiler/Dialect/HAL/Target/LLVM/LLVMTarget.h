@@ -16,6 +16,8 @@
 #ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_TARGET_H_
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_TARGET_H_
 
+#include <string>
+
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 
 namespace mlir {
@@ -24,11 +26,15 @@ namespace IREE {
 namespace HAL {
 
 struct LLVMTargetOptions {
-  // TODO(ataei): Add LLVM compilation options.
+  // Target triple used for ahead-of-time compilation. Defaults to the host.
+  std::string targetTriple;
+  // Linker used to produce shared libraries for ahead-of-time compilation.
+  // When empty the first of ld.lld and ld found on the PATH is used.
+  std::string linkerPath;
 };
 
 // Returns LLVMTargetOptions struct intialized with the
-// iree-hal-llvm-ir-* flags.
+// iree-llvm-* flags.
 LLVMTargetOptions getLLVMTargetOptionsFromFlags();
 
 // Registers the LLVM backends.
@@ -0,0 +1,36 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='iree-hal-transformation-pipeline{serialize-executables=false}' -iree-hal-target-backends=llvm-ir %s | IreeFileCheck %s
+
+flow.executable @large_ex_dispatch_0 {
+  flow.dispatch.entry @large_rgn_dispatch_0 attributes {
+    workload = 65536 : index
+  }
+  module {
+    func @large_rgn_dispatch_0(%arg0: tensor<64x1024xf32>) -> tensor<64x1024xf32> {
+      %0 = xla_hlo.add %arg0, %arg0 : tensor<64x1024xf32>
+      return %0 : tensor<64x1024xf32>
+    }
+  }
+}
+
+// CHECK-LABEL: hal.executable @large_ex_dispatch_0
+//       CHECK:   hal.executable.target "{{.+}}" {
+//  CHECK-NEXT:     module attributes {llvm.workgroup_partitions = {large_rgn_dispatch_0 = [4, 16384]}} {
+//       CHECK:       llvm.func @large_rgn_dispatch_0
+
+// -----
+
+flow.executable @small_ex_dispatch_0 {
+  flow.dispatch.entry @small_rgn_dispatch_0 attributes {
+    workload = 4 : index
+  }
+  module {
+    func @small_rgn_dispatch_0(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %0 = xla_hlo.add %arg0, %arg0 : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+
+// CHECK-LABEL: hal.executable @small_ex_dispatch_0
+//       CHECK:   hal.executable.target "{{.+}}" {
+//  CHECK-NEXT:     module {
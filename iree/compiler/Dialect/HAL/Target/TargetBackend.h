@@ -200,6 +200,13 @@ class TargetBackend {
     ArrayRef<Optional<TensorRewriteAdaptor>> results;
   };
 
+  // Returns true if the runtime driver for this backend supports binding
+  // buffer ranges to prerecorded command buffers with
+  // `hal.command_buffer.push_descriptor_set_slots` and
+  // `hal.command_buffer.bind`. Command buffers are only hoisted into
+  // initializers when all target backends support this.
+  virtual bool supportsCommandBufferBindingTables() const { return false; }
+
   // Records a dispatch to a command buffer given the dispatch state.
   // Push constants and bindings are already set and at minimum only a
   // `hal.command_buffer.dispatch` is required.
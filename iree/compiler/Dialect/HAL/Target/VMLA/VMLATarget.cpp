@@ -47,6 +47,9 @@ class VMLATargetBackend final : public TargetBackend {
 
   std::string name() const override { return "vmla"; }
 
+  // The VMLA driver records into in-process command buffers.
+  bool supportsCommandBufferBindingTables() const override { return true; }
+
   void buildTranslationPassPipeline(IREE::HAL::ExecutableTargetOp targetOp,
                                     OpPassManager &passManager) override {
     IREE::VMLA::buildVMLATransformPassPipeline(passManager);
@@ -92,6 +95,31 @@ class VMLATargetBackend final : public TargetBackend {
     return success();
   }
 
+  // Dispatches the number of workgroups the VMLA conversion partitioned the
+  // entry point into. Each workgroup processes the slice of the workload
+  // selected by its interface.workgroup_id and entry points that were not
+  // partitioned process the entire workload in a single workgroup.
+  std::array<Value, 3> calculateDispatchWorkgroupCount(
+      Location loc, IREE::HAL::ExecutableOp executableOp,
+      IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
+      OpBuilder &builder) override {
+    int64_t workgroupCount = 1;
+    for (auto executableTargetOp :
+         executableOp.getBlock().getOps<IREE::HAL::ExecutableTargetOp>()) {
+      if (matchPattern(executableTargetOp.target_backend(), name())) {
+        workgroupCount = IREE::VMLA::getEntryPointWorkgroupCount(
+            executableTargetOp.getInnerModule(), entryPointOp.sym_name());
+        break;
+      }
+    }
+    auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
+    return {
+        builder.createOrFold<mlir::ConstantIndexOp>(loc, workgroupCount),
+        constantOne,
+        constantOne,
+    };
+  }
+
  private:
   VMLATargetOptions options_;
 };
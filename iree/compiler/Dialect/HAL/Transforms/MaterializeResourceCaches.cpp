@@ -16,9 +16,12 @@
 
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
+#include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "llvm/ADT/StringSet.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/Attributes.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/StandardTypes.h"
@@ -63,7 +66,8 @@ class MaterializeResourceCachesPass
 
     // Generate cached resource singletons and replace lookup ops with direct
     // loads from variables.
-    for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+    auto funcOps = llvm::to_vector<8>(moduleOp.getOps<FuncOp>());
+    for (auto funcOp : funcOps) {
       for (auto &block : funcOp) {
         for (auto &op : llvm::make_early_inc_range(block)) {
           if (auto lookupOp = dyn_cast<DescriptorSetLayoutLookupOp>(op)) {
@@ -86,9 +90,36 @@ class MaterializeResourceCachesPass
     if (!executableOps.empty()) {
       defineExecutableCacheOp(executableOps);
     }
+
+    // Hoist the recording of command buffers that only vary in the buffer
+    // ranges they bind into initializers. Each call then just binds its
+    // buffer ranges to the prerecorded command buffer instead of recording it
+    // again. This must come after the executable cache so that the
+    // executables are prepared before the command buffers referencing them
+    // are recorded. Only drivers for some backends can bind buffer ranges to
+    // prerecorded command buffers so we leave recording in place unless all
+    // of the targets support it.
+    if (!allTargetsSupportBindingTables()) return;
+    for (auto funcOp : funcOps) {
+      for (auto &block : funcOp) {
+        for (auto createOp :
+             llvm::to_vector<4>(block.getOps<CommandBufferCreateOp>())) {
+          hoistCommandBufferOp(createOp);
+        }
+      }
+    }
   }
 
  private:
+  bool allTargetsSupportBindingTables() {
+    auto targetBackends = matchTargetBackends(targetOptions_.targets);
+    if (targetBackends.empty()) return false;
+    for (auto &targetBackend : targetBackends) {
+      if (!targetBackend->supportsCommandBufferBindingTables()) return false;
+    }
+    return true;
+  }
+
   VariableOp defineExecutableOp(ExecutableOp executableOp) {
     auto symbolName =
         (StringRef("_executable_") + executableOp.sym_name()).str();
@@ -99,6 +130,7 @@ class MaterializeResourceCachesPass
     SymbolTable::setSymbolVisibility(variableOp,
                                      SymbolTable::Visibility::Private);
     executableCache_.try_emplace(executableOp.sym_name(), variableOp);
+    executableVariableNames_.insert(variableOp.sym_name());
     return variableOp;
   }
 
@@ -257,6 +289,187 @@ class MaterializeResourceCachesPass
     return variableOp;
   }
 
+  // Returns true if |value| is loop-invariant across calls and can be
+  // rematerialized in an initializer by cloning its defining op.
+  bool isHoistableValue(Value value) {
+    auto *definingOp = value.getDefiningOp();
+    if (!definingOp) return false;
+    if (isa<mlir::ConstantOp>(definingOp) ||
+        isa<MakeMemoryBarrierOp>(definingOp) ||
+        isa<ExSharedDeviceOp>(definingOp)) {
+      return true;
+    }
+    if (auto loadOp = dyn_cast<VariableLoadOp>(definingOp)) {
+      // Executable variables are mutable only so that the cache initializer
+      // can store them; they never change afterward.
+      if (executableVariableNames_.count(loadOp.variable())) return true;
+      auto variableOp = dyn_cast_or_null<VariableOp>(
+          SymbolTable::lookupNearestSymbolFrom(loadOp, loadOp.variable()));
+      return variableOp && !variableOp.is_mutable();
+    }
+    return false;
+  }
+
+  // Hoists the command buffer recorded from |createOp| into an initializer
+  // when all commands use values that are invariant across calls with the
+  // exception of the descriptor set buffer ranges. Those become binding table
+  // slots that are bound prior to submission along with their offsets and
+  // lengths, which in lowered streams are computed per call from the buffers
+  // themselves. Command buffers with dynamic workgroup counts or push
+  // constants (such as those produced from dynamically-shaped streams) are
+  // left as-is.
+  void hoistCommandBufferOp(CommandBufferCreateOp createOp) {
+    auto *block = createOp.getOperation()->getBlock();
+    auto commandBuffer = createOp.result();
+    if (!isHoistableValue(createOp.device())) return;
+
+    CommandBufferBeginOp beginOp;
+    CommandBufferEndOp endOp;
+    ExSubmitAndWaitOp submitOp;
+    SmallVector<Operation *, 16> recordingOps;
+    for (auto *user : commandBuffer.getUsers()) {
+      if (user->getBlock() != block) return;
+      if (auto op = dyn_cast<CommandBufferBeginOp>(user)) {
+        if (beginOp) return;
+        beginOp = op;
+      } else if (auto op = dyn_cast<CommandBufferEndOp>(user)) {
+        if (endOp) return;
+        endOp = op;
+      } else if (auto op = dyn_cast<ExSubmitAndWaitOp>(user)) {
+        if (submitOp) return;
+        submitOp = op;
+      } else if (isa<CommandBufferExecutionBarrierOp>(user) ||
+                 isa<CommandBufferPushConstantsOp>(user) ||
+                 isa<CommandBufferPushDescriptorSetOp>(user) ||
+                 isa<CommandBufferDispatchOp>(user) ||
+                 (isa<DeviceSwitchOp>(user) && user->getNumResults() == 0)) {
+        recordingOps.push_back(user);
+      } else {
+        return;
+      }
+    }
+    if (!beginOp || !endOp || !submitOp ||
+        !endOp.getOperation()->isBeforeInBlock(submitOp)) {
+      return;
+    }
+    llvm::sort(recordingOps, [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+    if (!recordingOps.empty() &&
+        (!beginOp.getOperation()->isBeforeInBlock(recordingOps.front()) ||
+         !recordingOps.back()->isBeforeInBlock(endOp))) {
+      return;
+    }
+
+    // Ensure everything but the descriptor set buffer ranges can be recorded
+    // during initialization. The buffer ranges are bound at the call site
+    // where their values are already available.
+    for (auto *op : recordingOps) {
+      if (auto pushOp = dyn_cast<CommandBufferPushDescriptorSetOp>(op)) {
+        if (!isHoistableValue(pushOp.executable_layout())) return;
+        continue;
+      }
+      for (auto operand : op->getOperands()) {
+        if (operand != commandBuffer && !isHoistableValue(operand)) return;
+      }
+    }
+
+    auto loc = createOp.getLoc();
+    auto symbolName = (StringRef("_command_buffer_") +
+                       std::to_string(nextUniqueCommandBufferId++))
+                          .str();
+    auto initializerName = symbolName + "_initializer";
+
+    auto commandBufferType = CommandBufferType::get(loc.getContext());
+    auto variableOp = moduleBuilder.create<VariableOp>(
+        loc, symbolName, /*isMutable=*/false, commandBufferType,
+        StringRef(initializerName), llvm::None);
+    SymbolTable::setSymbolVisibility(variableOp,
+                                     SymbolTable::Visibility::Private);
+
+    auto initializerOp = moduleBuilder.create<FuncOp>(
+        loc, initializerName,
+        moduleBuilder.getFunctionType({}, {commandBufferType}),
+        ArrayRef<NamedAttribute>{});
+    SymbolTable::setSymbolVisibility(initializerOp,
+                                     SymbolTable::Visibility::Private);
+    auto *entryBlock = initializerOp.addEntryBlock();
+    OpBuilder blockBuilder = OpBuilder::atBlockEnd(entryBlock);
+
+    // Invariant values are rematerialized by cloning their defining ops.
+    BlockAndValueMapping mapping;
+    auto cloneValue = [&](Value value) {
+      if (auto mappedValue = mapping.lookupOrNull(value)) return mappedValue;
+      auto *clonedOp = blockBuilder.clone(*value.getDefiningOp());
+      mapping.map(value.getDefiningOp()->getResults(), clonedOp->getResults());
+      return mapping.lookup(value);
+    };
+
+    // Each unique descriptor set buffer range is assigned a binding table slot.
+    SmallVector<Value, 8> bindingBuffers;
+    SmallVector<Value, 8> bindingOffsets;
+    SmallVector<Value, 8> bindingLengths;
+    auto getBindingSlot = [&](Value buffer, Value offset, Value length) {
+      for (int32_t slot = 0; slot < bindingBuffers.size(); ++slot) {
+        if (bindingBuffers[slot] == buffer && bindingOffsets[slot] == offset &&
+            bindingLengths[slot] == length) {
+          return slot;
+        }
+      }
+      bindingBuffers.push_back(buffer);
+      bindingOffsets.push_back(offset);
+      bindingLengths.push_back(length);
+      return static_cast<int32_t>(bindingBuffers.size() - 1);
+    };
+
+    // The command buffer is submitted many times and must not be one-shot.
+    auto deviceValue = blockBuilder.createOrFold<ExSharedDeviceOp>(loc);
+    auto newCommandBuffer = blockBuilder.createOrFold<CommandBufferCreateOp>(
+        loc, deviceValue, CommandBufferModeBitfield::None,
+        createOp.command_categories());
+    mapping.map(commandBuffer, newCommandBuffer);
+    blockBuilder.create<CommandBufferBeginOp>(loc, newCommandBuffer);
+    for (auto *op : recordingOps) {
+      if (auto pushOp = dyn_cast<CommandBufferPushDescriptorSetOp>(op)) {
+        SmallVector<Attribute, 4> slotAttrs;
+        for (auto binding :
+             llvm::zip(pushOp.binding_buffers(), pushOp.binding_offsets(),
+                       pushOp.binding_lengths())) {
+          slotAttrs.push_back(blockBuilder.getI32IntegerAttr(
+              getBindingSlot(std::get<0>(binding), std::get<1>(binding),
+                             std::get<2>(binding))));
+        }
+        blockBuilder.create<CommandBufferPushDescriptorSetSlotsOp>(
+            pushOp.getLoc(), newCommandBuffer,
+            cloneValue(pushOp.executable_layout()), pushOp.setAttr(),
+            pushOp.bindings(), blockBuilder.getArrayAttr(slotAttrs));
+        continue;
+      }
+      for (auto operand : op->getOperands()) {
+        if (operand != commandBuffer) cloneValue(operand);
+      }
+      blockBuilder.clone(*op, mapping);
+    }
+    blockBuilder.create<CommandBufferEndOp>(loc, newCommandBuffer);
+    blockBuilder.create<mlir::ReturnOp>(loc, newCommandBuffer);
+
+    // Submit the prerecorded command buffer with this call's buffer ranges.
+    OpBuilder builder(submitOp);
+    auto loadedCommandBuffer = builder.create<VariableLoadOp>(
+        loc, commandBufferType, variableOp.sym_name());
+    auto boundCommandBuffer = builder.create<CommandBufferBindOp>(
+        loc, commandBufferType, loadedCommandBuffer, bindingBuffers,
+        bindingOffsets, bindingLengths);
+    submitOp.getOperation()->replaceUsesOfWith(commandBuffer,
+                                               boundCommandBuffer);
+    for (auto *op : llvm::reverse(recordingOps)) {
+      op->erase();
+    }
+    endOp.erase();
+    beginOp.erase();
+    createOp.erase();
+  }
+
   void replaceDescriptorSetLayoutLookupOp(
       DescriptorSetLayoutLookupOp &lookupOp) {
     OpBuilder builder(lookupOp);
@@ -300,9 +513,11 @@ class MaterializeResourceCachesPass
   DenseMap<Attribute, VariableOp> descriptorSetLayoutCache_;
   DenseMap<Attribute, VariableOp> executableLayoutCache_;
   DenseMap<StringRef, VariableOp> executableCache_;
+  llvm::StringSet<> executableVariableNames_;
 
   int nextUniqueExecutableLayoutId = 0;
   int nextUniqueDescriptorSetLayoutId = 0;
+  int nextUniqueCommandBufferId = 0;
 };
 
 std::unique_ptr<OperationPass<ModuleOp>> createMaterializeResourceCachesPass(
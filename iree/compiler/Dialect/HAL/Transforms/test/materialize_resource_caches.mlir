@@ -1,4 +1,5 @@
-// RUN: iree-opt -split-input-file -iree-hal-materialize-resource-caches %s | IreeFileCheck %s
+// RUN: iree-opt -split-input-file -iree-hal-materialize-resource-caches -iree-hal-target-backends=vmla %s | IreeFileCheck %s
+// RUN: iree-opt -split-input-file -iree-hal-materialize-resource-caches -iree-hal-target-backends=vulkan-spirv %s | IreeFileCheck %s --check-prefix=NOBIND
 
 //      CHECK: hal.variable @_descriptor_set_layout_0 init(@_descriptor_set_layout_0_initializer) : !hal.descriptor_set_layout
 // CHECK-NEXT: func @_descriptor_set_layout_0_initializer() -> !hal.descriptor_set_layout attributes {sym_visibility = "private"} {
@@ -127,3 +128,91 @@ func @exeLookup(%arg0 : !hal.device) -> !hal.executable {
   // CHECK-NEXT: return %[[EXE]]
   return %0 : !hal.executable
 }
+
+// -----
+
+hal.executable @exe {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.entry_point @entry attributes {
+    interface = @interface,
+    ordinal = 0 : i32,
+    signature = (tensor<4xf32>) -> tensor<4xf32>,
+    workgroup_size = [32 : index, 1 : index, 1 : index]
+  }
+  hal.executable.binary attributes {
+    data = dense<[0, 1, 2, 3]> : vector<4xi8>,
+    format = 1230128453 : i32
+  }
+}
+
+//      CHECK: hal.variable @_command_buffer_0 init(@_command_buffer_0_initializer) : !hal.command_buffer
+// CHECK-NEXT: func @_command_buffer_0_initializer() -> !hal.command_buffer
+//      CHECK: %[[CMD:.+]] = hal.command_buffer.create %{{.+}}, "None", "Transfer|Dispatch" : !hal.command_buffer
+// CHECK-NEXT: hal.command_buffer.begin %[[CMD]]
+//      CHECK: %[[LAYOUT:.+]] = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+//      CHECK: hal.command_buffer.push_descriptor_set.slots %[[CMD]], %[[LAYOUT]], set = 0, bindings = [0 : i32, 1 : i32], slots = [0 : i32, 1 : i32]
+//      CHECK: %[[EXE:.+]] = hal.variable.load @_executable_exe : !hal.executable
+//      CHECK: hal.command_buffer.dispatch %[[CMD]], %[[EXE]], entry_point = 0
+// CHECK-NEXT: hal.command_buffer.end %[[CMD]]
+// CHECK-NEXT: return %[[CMD]] : !hal.command_buffer
+
+// NOBIND-NOT: hal.variable @_command_buffer_0
+
+// CHECK-LABEL: @staticDispatch
+// CHECK-SAME: (%[[ARG0:.+]]: !hal.buffer, %[[ARG1:.+]]: !hal.buffer)
+// NOBIND-LABEL: @staticDispatch
+func @staticDispatch(%arg0 : !hal.buffer, %arg1 : !hal.buffer) {
+  %c0 = constant 0 : index
+  %c1 = constant 1 : index
+  %c16 = constant 16 : index
+  %dev = hal.ex.shared_device : !hal.device
+  // CHECK-NOT: hal.command_buffer.create
+  // NOBIND: hal.command_buffer.create %{{.+}}, "OneShot", "Transfer|Dispatch"
+  %cmd = hal.command_buffer.create %dev, "OneShot", "Transfer|Dispatch" : !hal.command_buffer
+  hal.command_buffer.begin %cmd
+  %layout = hal.executable_layout.lookup %dev, set_layouts = [
+    [
+      #hal.descriptor_set_layout_binding<0, "StorageBuffer", "Read">,
+      #hal.descriptor_set_layout_binding<1, "StorageBuffer", "Write|Discard">
+    ]
+  ] : !hal.executable_layout
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg0, %c0, %c16), 1 = (%arg1, %c0, %c16)]
+  %exe = hal.executable.lookup %dev, @exe : !hal.executable
+  hal.command_buffer.dispatch %cmd, %exe, entry_point = 0, workgroup_xyz = [%c1, %c1, %c1]
+  hal.command_buffer.end %cmd
+  // CHECK: %[[CMD:.+]] = hal.variable.load @_command_buffer_0 : !hal.command_buffer
+  // CHECK-NEXT: %[[BOUND:.+]] = hal.command_buffer.bind %[[CMD]], buffers = [%[[ARG0]], %[[ARG1]]], offsets = [%c0, %c0], lengths = [%c16, %c16] : !hal.command_buffer
+  // CHECK-NEXT: hal.ex.submit_and_wait %{{.+}}, %[[BOUND]]
+  // NOBIND-NOT: hal.command_buffer.bind
+  // NOBIND: hal.ex.submit_and_wait
+  hal.ex.submit_and_wait %dev, %cmd
+  return
+}
+
+// CHECK-LABEL: @dynamicDispatch
+func @dynamicDispatch(%arg0 : !hal.buffer, %arg1 : !hal.buffer, %arg2 : index) {
+  %c0 = constant 0 : index
+  %c1 = constant 1 : index
+  %c16 = constant 16 : index
+  %dev = hal.ex.shared_device : !hal.device
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create %dev, "OneShot", "Transfer|Dispatch" : !hal.command_buffer
+  hal.command_buffer.begin %cmd
+  %layout = hal.executable_layout.lookup %dev, set_layouts = [
+    [
+      #hal.descriptor_set_layout_binding<0, "StorageBuffer", "Read">,
+      #hal.descriptor_set_layout_binding<1, "StorageBuffer", "Write|Discard">
+    ]
+  ] : !hal.executable_layout
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg0, %c0, %c16), 1 = (%arg1, %c0, %c16)]
+  %exe = hal.executable.lookup %dev, @exe : !hal.executable
+  hal.command_buffer.dispatch %cmd, %exe, entry_point = 0, workgroup_xyz = [%arg2, %c1, %c1]
+  hal.command_buffer.end %cmd
+  // CHECK-NOT: hal.command_buffer.bind
+  // CHECK: hal.ex.submit_and_wait
+  hal.ex.submit_and_wait %dev, %cmd
+  return
+}
@@ -0,0 +1,69 @@
+// RUN: iree-opt -split-input-file -iree-convert-flow-to-hal -canonicalize -cse -iree-hal-materialize-resource-caches -iree-hal-target-backends=vmla %s | IreeFileCheck %s
+
+// Tests hoisting command buffers as recorded by ConvertFlowToHAL. Binding
+// lengths are computed from the buffer allocators and transient offsets from
+// the sizes of the values in the transient slab; both are bound per call.
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.entry_point @entry0 attributes {
+    interface = @interface,
+    ordinal = 0 : i32,
+    signature = (tensor<128xf32>) -> tensor<128xf32>
+  }
+  hal.executable.target "vmla" {
+    module {}
+  }
+}
+
+//      CHECK: hal.variable @_command_buffer_0 init(@_command_buffer_0_initializer) : !hal.command_buffer
+// CHECK-NEXT: func @_command_buffer_0_initializer() -> !hal.command_buffer
+//      CHECK: %[[CMD:.+]] = hal.command_buffer.create %{{.+}}, "None", "Transfer|Dispatch" : !hal.command_buffer
+// CHECK-NEXT: hal.command_buffer.begin %[[CMD]]
+// CHECK-NEXT: %[[LAYOUT:.+]] = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+// CHECK-NEXT: hal.command_buffer.push_descriptor_set.slots %[[CMD]], %[[LAYOUT]], set = 0, bindings = [0 : i32, 1 : i32], slots = [0 : i32, 1 : i32]
+//      CHECK: hal.device.switch
+// CHECK-NEXT: #hal.device.match.id<"vmla">({{.+}} = %[[CMD]] : !hal.command_buffer, {{.+}}) {
+//      CHECK: hal.command_buffer.dispatch
+//      CHECK: hal.command_buffer.execution_barrier %[[CMD]]
+// CHECK-NEXT: hal.command_buffer.push_descriptor_set.slots %[[CMD]], %[[LAYOUT]], set = 0, bindings = [0 : i32, 1 : i32], slots = [1 : i32, 2 : i32]
+//      CHECK: hal.command_buffer.dispatch
+//      CHECK: hal.command_buffer.execution_barrier %[[CMD]]
+// CHECK-NEXT: hal.command_buffer.push_descriptor_set.slots %[[CMD]], %[[LAYOUT]], set = 0, bindings = [0 : i32, 1 : i32], slots = [2 : i32, 3 : i32]
+//      CHECK: hal.command_buffer.dispatch
+//      CHECK: hal.command_buffer.execution_barrier %[[CMD]]
+// CHECK-NEXT: hal.command_buffer.end %[[CMD]]
+// CHECK-NEXT: return %[[CMD]] : !hal.command_buffer
+
+// CHECK-LABEL: func @transientSlab
+// CHECK-SAME: (%[[ARG0:.+]]: !hal.buffer) -> !hal.buffer
+func @transientSlab(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  // CHECK-DAG: %[[C0:.+]] = constant 0 : index
+  %cst = constant 128 : index
+  //      CHECK: %[[SIZE:.+]] = hal.allocator.compute_size
+  //      CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal"
+  //      CHECK: %[[SLAB:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch"
+  //  CHECK-NOT: hal.command_buffer.create
+  //      CHECK: %[[ARG_ALLOCATOR:.+]] = hal.buffer.allocator %[[ARG0]]
+  // CHECK-NEXT: %[[ARG_SIZE:.+]] = hal.allocator.compute_size %[[ARG_ALLOCATOR]]
+  //  CHECK-NOT: hal.command_buffer.push_descriptor_set
+  //      CHECK: %[[CMD:.+]] = hal.variable.load @_command_buffer_0 : !hal.command_buffer
+  // CHECK-NEXT: %[[BOUND:.+]] = hal.command_buffer.bind %[[CMD]],
+  // CHECK-SAME:     buffers = [%[[ARG0]], %[[SLAB]], %[[SLAB]], %[[RET_BUF]]],
+  // CHECK-SAME:     offsets = [%[[C0]], %[[C0]], %{{.+}}, %[[C0]]],
+  // CHECK-SAME:     lengths = [%[[ARG_SIZE]], %[[SIZE]], %[[SIZE]], %[[SIZE]]] : !hal.command_buffer
+  // CHECK-NEXT: hal.ex.submit_and_wait %{{.+}}, %[[BOUND]]
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    // The two transients are live at the same time and are assigned to
+    // different slots of the slab.
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%2) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %3 : tensor<128xf32>
+  }
+  // CHECK-NEXT: return %[[RET_BUF]]
+  return %0 : tensor<128xf32>
+}
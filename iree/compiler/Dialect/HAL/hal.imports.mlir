@@ -285,6 +285,16 @@ vm.import @command_buffer.push_descriptor_set(
   %binding_lengths : i32 ...
 )
 
+// Pushes a descriptor set to the given set number with buffer ranges taken from
+// the binding table the command buffer is submitted with.
+vm.import @command_buffer.push_descriptor_set.slots(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %executable_layout : !vm.ref<!hal.executable_layout>,
+  %set : i32,
+  %bindings : i32 ...,
+  %binding_slots : i32 ...
+)
+
 // Binds a descriptor set to the given set number.
 vm.import @command_buffer.bind_descriptor_set(
   %command_buffer : !vm.ref<!hal.command_buffer>,
@@ -314,6 +324,15 @@ vm.import @command_buffer.dispatch.indirect(
   %workgroups_offset : i32
 )
 
+// Returns a command buffer that submits the recorded |command_buffer| with the
+// given buffer ranges as its binding table.
+vm.import @command_buffer.bind(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %binding_buffers : !vm.ref<!hal.buffer>...,
+  %binding_offsets : i32 ...,
+  %binding_lengths : i32 ...
+) -> !vm.ref<!hal.command_buffer>
+
 //===----------------------------------------------------------------------===//
 // iree::hal::DescriptorSet
 //===----------------------------------------------------------------------===//
@@ -90,12 +90,15 @@ LogicalResult RegisterAllocation::annotateIR(IREE::VM::FuncOp funcOp) {
   return success();
 }
 
+// Returns true if values of |type| are stored in a pair of i32 registers.
+static bool isI64Type(Type type) { return type.isInteger(64); }
+
 // Forms a register reference byte as interpreted by the VM.
 // Assumes that the ordinal has been constructed in the valid range.
 static uint16_t makeRegisterByte(Type type, int ordinal, bool isMove) {
   if (type.isSignlessIntOrIndexOrFloat()) {
     assert(ordinal < kIntRegisterCount);
-    return ordinal;
+    return isI64Type(type) ? (ordinal | kI64RegisterBit) : ordinal;
   } else {
     assert(ordinal < kRefRegisterCount);
     return (ordinal | kRefRegisterTypeBit) | (isMove ? kRefRegisterMoveBit : 0);
@@ -108,16 +111,33 @@ struct RegisterUsage {
   llvm::BitVector refRegisters{kRefRegisterCount};
   int maxI32RegisterOrdinal = -1;
   int maxRefRegisterOrdinal = -1;
+  int nextIntArgumentOrdinal = 0;
+  int nextRefArgumentOrdinal = 0;
 
   void reset() {
     intRegisters.reset();
     refRegisters.reset();
     maxI32RegisterOrdinal = -1;
     maxRefRegisterOrdinal = -1;
+    nextIntArgumentOrdinal = 0;
+    nextRefArgumentOrdinal = 0;
   }
 
   Optional<uint16_t> allocateRegister(Type type) {
-    if (type.isSignlessIntOrIndexOrFloat()) {
+    if (isI64Type(type)) {
+      // Register pairs must start on an even ordinal.
+      int ordinal = intRegisters.find_first_unset();
+      while (ordinal != -1 && ordinal + 1 < kIntRegisterCount &&
+             (ordinal % 2 != 0 || intRegisters.test(ordinal + 1))) {
+        ordinal = intRegisters.find_next_unset(ordinal);
+      }
+      if (ordinal == -1 || ordinal + 1 >= kIntRegisterCount) {
+        return {};
+      }
+      auto reg = makeRegisterByte(type, ordinal, /*isMove=*/false);
+      markRegisterUsed(reg);
+      return reg;
+    } else if (type.isSignlessIntOrIndexOrFloat()) {
       int ordinal = intRegisters.find_first_unset();
       if (ordinal >= kIntRegisterCount) {
         return {};
@@ -136,11 +156,35 @@ struct RegisterUsage {
     }
   }
 
+  // Allocates the next register for a function argument of |type|.
+  // Arguments are assigned left-aligned in each bank in the order they are
+  // declared to match the calling convention used by the VM to populate them.
+  Optional<uint16_t> allocateArgumentRegister(Type type) {
+    int ordinal = 0;
+    if (isI64Type(type)) {
+      ordinal = (nextIntArgumentOrdinal + 1) & ~1;
+      nextIntArgumentOrdinal = ordinal + 2;
+      if (nextIntArgumentOrdinal > kIntRegisterCount) return {};
+    } else if (type.isSignlessIntOrIndexOrFloat()) {
+      ordinal = nextIntArgumentOrdinal++;
+      if (nextIntArgumentOrdinal > kIntRegisterCount) return {};
+    } else {
+      ordinal = nextRefArgumentOrdinal++;
+      if (nextRefArgumentOrdinal > kRefRegisterCount) return {};
+    }
+    auto reg = makeRegisterByte(type, ordinal, /*isMove=*/false);
+    markRegisterUsed(reg);
+    return reg;
+  }
+
   void markRegisterUsed(uint16_t reg) {
     int ordinal = getRegisterOrdinal(reg);
     if (isRefRegister(reg)) {
       refRegisters.set(ordinal);
       maxRefRegisterOrdinal = std::max(ordinal, maxRefRegisterOrdinal);
+    } else if (isI64Register(reg)) {
+      intRegisters.set(ordinal, ordinal + 2);
+      maxI32RegisterOrdinal = std::max(ordinal + 1, maxI32RegisterOrdinal);
     } else {
       intRegisters.set(ordinal);
       maxI32RegisterOrdinal = std::max(ordinal, maxI32RegisterOrdinal);
@@ -148,10 +192,13 @@ struct RegisterUsage {
   }
 
   void releaseRegister(uint16_t reg) {
+    int ordinal = getRegisterOrdinal(reg);
     if (isRefRegister(reg)) {
-      refRegisters.reset(reg & 0x3F);
+      refRegisters.reset(ordinal);
+    } else if (isI64Register(reg)) {
+      intRegisters.reset(ordinal, ordinal + 2);
     } else {
-      intRegisters.reset(reg & 0x7F);
+      intRegisters.reset(ordinal);
     }
   }
 };
@@ -215,9 +262,14 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
       registerUsage.markRegisterUsed(mapToRegister(liveInValue));
     }
 
-    // Allocate arguments first from left-to-right.
+    // Allocate arguments first from left-to-right. Entry block arguments are
+    // populated by the caller and must follow the calling convention.
+    bool isEntryBlock = block->isEntryBlock();
     for (auto blockArg : block->getArguments()) {
-      auto reg = registerUsage.allocateRegister(blockArg.getType());
+      auto reg =
+          isEntryBlock
+              ? registerUsage.allocateArgumentRegister(blockArg.getType())
+              : registerUsage.allocateRegister(blockArg.getType());
       if (!reg.hasValue()) {
         return funcOp.emitError() << "register allocation failed for block arg "
                                   << blockArg.getArgNumber();
@@ -499,7 +551,16 @@ RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
     uint16_t srcReg = mapToRegister(it.value());
     BlockArgument targetArg = targetBlock->getArgument(it.index());
     uint16_t dstReg = mapToRegister(targetArg);
-    if (!compareRegistersEqual(srcReg, dstReg)) {
+    if (isI64Register(srcReg)) {
+      // Register pairs are remapped as their two halves so that cycles and
+      // hazards with overlapping i32 registers are detected below.
+      uint16_t srcOrdinal = getRegisterOrdinal(srcReg);
+      uint16_t dstOrdinal = getRegisterOrdinal(dstReg);
+      if (srcOrdinal != dstOrdinal) {
+        srcDstRegs.push_back({srcOrdinal, dstOrdinal});
+        srcDstRegs.push_back({srcOrdinal + 1, dstOrdinal + 1});
+      }
+    } else if (!compareRegistersEqual(srcReg, dstReg)) {
       srcDstRegs.push_back({srcReg, dstReg});
     }
   }
@@ -24,12 +24,16 @@ namespace mlir {
 namespace iree_compiler {
 
 // The VM contains multiple register banks:
-// - 128 32-bit integer registers
-//   - may be aliased as 32 128-bit registers
-// - 64 ref_ptr registers
+// - 16383 32-bit primitive registers
+//   - i32 and f32 values use a single register
+//   - i64 values use an even-aligned pair of registers
+// - 16383 ref_ptr registers
 //
-// Registers are represented in bytecode as an 8-bit integer with the high bit
-// indicating whether it is from the integer (0b0) or ref_ptr bank (0b1).
+// Registers are represented in bytecode as a 16-bit integer with the high bit
+// indicating whether it is from the primitive (0b0) or ref_ptr bank (0b1).
+//
+// Primitive register words have the next bit set when they reference a 64-bit
+// register pair. The ordinal is that of the first (low) register in the pair.
 //
 // ref_ptr register bytes also include a bit denoting whether the register
 // reference has move semantics. When set the VM can assume that the value is
@@ -37,8 +41,9 @@ namespace iree_compiler {
 // the receiving op/call. This allows reference count increment elision, though
 // the VM is free to ignore this if it so chooses.
 
-constexpr int kIntRegisterCount = 0x7FFF;
+constexpr int kIntRegisterCount = 0x3FFF;
 constexpr int kRefRegisterCount = 0x3FFF;
+constexpr uint16_t kI64RegisterBit = 0x4000;
 constexpr uint16_t kRefRegisterTypeBit = 0x8000;
 constexpr uint16_t kRefRegisterMoveBit = 0x4000;
 
@@ -47,6 +52,11 @@ constexpr bool isRefRegister(uint16_t reg) {
   return (reg & kRefRegisterTypeBit) == kRefRegisterTypeBit;
 }
 
+// Returns true if |reg| is a 64-bit pair of registers in the primitive bank.
+constexpr bool isI64Register(uint16_t reg) {
+  return !isRefRegister(reg) && (reg & kI64RegisterBit) == kI64RegisterBit;
+}
+
 // Returns true if the ref_ptr |reg| denotes a move operation.
 constexpr bool isRefMove(uint16_t reg) {
   return (reg & kRefRegisterMoveBit) == kRefRegisterMoveBit;
@@ -56,7 +66,7 @@ constexpr bool isRefMove(uint16_t reg) {
 constexpr uint16_t getRegisterOrdinal(uint16_t reg) {
   return isRefRegister(reg)
              ? (reg & ~(kRefRegisterTypeBit | kRefRegisterMoveBit))
-             : reg;
+             : (reg & ~kI64RegisterBit);
 }
 
 // Returns the register ID without the move bit.
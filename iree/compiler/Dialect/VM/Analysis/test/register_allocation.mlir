@@ -185,4 +185,14 @@ vm.module @module {
     // CHECK-SAME: block_registers = ["0"]
     vm.return %ie : i32
   }
+
+  // i64 values occupy an even-aligned pair of primitive registers and are
+  // referenced with the 0x4000 bit set (16386 = 0x4000 | 2).
+  // CHECK-LABEL: @i64_args
+  vm.func @i64_args(%arg0 : i32, %arg1 : i64) -> (i32, i64) {
+    // CHECK: vm.add.i64
+    // CHECK-SAME: block_registers = ["0", "16386"]
+    %0 = vm.add.i64 %arg1, %arg1 : i64
+    vm.return %arg0, %0 : i32, i64
+  }
 }
@@ -163,22 +163,41 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   LogicalResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!floatAttr.getType().isF32()) {
+        srcOp.emitRemark() << "unsupported bit width for dialect constant";
+        return failure();
+      }
+      if (floatAttr.getValue().isPosZero()) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, floatAttr);
+      }
+      return success();
+    }
+
     auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
-    // Only 32bit integer supported for now.
     if (!integerAttr) {
       srcOp.emitRemark() << "unsupported const type for dialect";
       return failure();
     }
+    int numBits = 32;
     if (integerAttr.getType().isIntOrFloat()) {
-      int numBits = integerAttr.getType().getIntOrFloatBitWidth();
-      if (numBits != 1 && numBits != 32) {
+      numBits = integerAttr.getType().getIntOrFloatBitWidth();
+      if (numBits != 1 && numBits != 32 && numBits != 64) {
         srcOp.emitRemark() << "unsupported bit width for dialect constant";
         return failure();
       }
     }
 
     auto intValue = integerAttr.getInt();
-    if (intValue == 0) {
+    if (numBits == 64) {
+      if (intValue == 0) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI64ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI64Op>(srcOp, intValue);
+      }
+    } else if (intValue == 0) {
       rewriter.replaceOpWithNewOp<IREE::VM::ConstI32ZeroOp>(srcOp);
     } else {
       rewriter.replaceOpWithNewOp<IREE::VM::ConstI32Op>(srcOp, intValue);
@@ -195,6 +214,9 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
       ConversionPatternRewriter &rewriter) const override {
     CmpIOpOperandAdaptor srcAdapter(operands);
     auto returnType = rewriter.getIntegerType(32);
+    if (srcAdapter.lhs().getType().isInteger(64)) {
+      return matchAndRewriteI64(srcOp, srcAdapter, returnType, rewriter);
+    }
     switch (srcOp.getPredicate()) {
       case CmpIPredicate::eq:
         rewriter.replaceOpWithNewOp<IREE::VM::CmpEQI32Op>(
@@ -240,6 +262,98 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
         return failure();
     }
   }
+
+ private:
+  // The i64 comparisons only provide lt/lte so gt/gte swap their operands.
+  LogicalResult matchAndRewriteI64(
+      CmpIOp srcOp, CmpIOpOperandAdaptor srcAdapter, Type returnType,
+      ConversionPatternRewriter &rewriter) const {
+    switch (srcOp.getPredicate()) {
+      case CmpIPredicate::eq:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQI64Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::ne:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEI64Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::slt:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI64SOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::sle:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI64SOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::sgt:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI64SOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpIPredicate::sge:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI64SOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpIPredicate::ult:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI64UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::ule:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI64UOp>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpIPredicate::ugt:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTI64UOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpIPredicate::uge:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEI64UOp>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      default:
+        return failure();
+    }
+  }
+};
+
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOpOperandAdaptor srcAdapter(operands);
+    auto returnType = rewriter.getIntegerType(32);
+    // The VM comparisons are ordered with the exception of cmp.ne.f32 (which
+    // matches C !=) and gt/gte swap their operands.
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32Op>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32Op>(
+            srcOp, returnType, srcAdapter.rhs(), srcAdapter.lhs());
+        return success();
+      default:
+        return failure();
+    }
+  }
 };
 
 template <typename SrcOpTy, typename DstOpTy>
@@ -257,6 +371,80 @@ class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   }
 };
 
+// Selects between the i32 and i64 variants of an integer op based on the
+// converted operand type.
+template <typename SrcOpTy, typename DstI32OpTy, typename DstI64OpTy>
+class BinaryIntegerArithmeticOpConversion
+    : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    typename SrcOpTy::OperandAdaptor srcAdapter(operands);
+    auto type = srcAdapter.lhs().getType();
+    if (type.isInteger(64)) {
+      rewriter.replaceOpWithNewOp<DstI64OpTy>(srcOp, type, srcAdapter.lhs(),
+                                              srcAdapter.rhs());
+    } else {
+      rewriter.replaceOpWithNewOp<DstI32OpTy>(srcOp, type, srcAdapter.lhs(),
+                                              srcAdapter.rhs());
+    }
+    return success();
+  }
+};
+
+template <typename SrcOpTy, typename DstOpTy>
+class UnaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    typename SrcOpTy::OperandAdaptor srcAdapter(operands);
+
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, srcAdapter.operand().getType(),
+                                         srcAdapter.operand());
+    return success();
+  }
+};
+
+// Converts a cast op when its source and result types match those of |DstOpTy|.
+template <typename SrcOpTy, typename DstOpTy, unsigned kSrcBits,
+          unsigned kDstBits>
+class IntegerCastOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto srcType = srcOp.getOperand().getType();
+    auto dstType = srcOp.getType();
+    if (!srcType.isSignlessInteger(kSrcBits) ||
+        !dstType.isSignlessInteger(kDstBits)) {
+      return failure();
+    }
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, dstType, operands[0]);
+    return success();
+  }
+};
+
+class SIToFPOpConversion : public OpConversionPattern<SIToFPOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SIToFPOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto dstType = srcOp.getType();
+    if (!operands[0].getType().isSignlessInteger(32) || !dstType.isF32()) {
+      return failure();
+    }
+    rewriter.replaceOpWithNewOp<IREE::VM::CastSI32F32Op>(srcOp, dstType,
+                                                         operands[0]);
+    return success();
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy, unsigned kBits = 32>
 class ShiftArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -294,7 +482,7 @@ class IndexCastOpConversion : public OpConversionPattern<IndexCastOp> {
   }
 };
 
-class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
+class SelectOpConversion : public OpConversionPattern<SelectOp> {
   using OpConversionPattern::OpConversionPattern;
   LogicalResult matchAndRewrite(
       SelectOp srcOp, ArrayRef<Value> operands,
@@ -308,6 +496,17 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
     // (Otherwise, the dialect converter may report the error as a failure to
     // legalize the select op depending on order of resolution).
     auto actualType = srcAdaptor.true_value().getType();
+    if (actualType.isInteger(64)) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectI64Op>(
+          srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+      return success();
+    } else if (actualType.isF32()) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+          srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+      return success();
+    }
     if (actualType != requiredType && actualType.isa<IndexType>())
       return failure();
 
@@ -376,28 +575,57 @@ void populateStandardToVMPatterns(MLIRContext *context,
                                   OwningRewritePatternList &patterns) {
   patterns
       .insert<BranchOpConversion, CallOpConversion, CmpIOpConversion,
-              CondBranchOpConversion, ConstantOpConversion, ModuleOpConversion,
-              ModuleTerminatorOpConversion, FuncOpConversion,
-              ReturnOpConversion, IndexCastOpConversion, SelectI32OpConversion>(
-          context);
-
-  // Binary arithmetic ops
-  patterns
-      .insert<BinaryArithmeticOpConversion<AddIOp, IREE::VM::AddI32Op>,
-              BinaryArithmeticOpConversion<SignedDivIOp, IREE::VM::DivI32SOp>,
-              BinaryArithmeticOpConversion<UnsignedDivIOp, IREE::VM::DivI32UOp>,
-              BinaryArithmeticOpConversion<MulIOp, IREE::VM::MulI32Op>,
-              BinaryArithmeticOpConversion<SignedRemIOp, IREE::VM::RemI32SOp>,
-              BinaryArithmeticOpConversion<UnsignedRemIOp, IREE::VM::RemI32UOp>,
-              BinaryArithmeticOpConversion<SubIOp, IREE::VM::SubI32Op>,
-              BinaryArithmeticOpConversion<AndOp, IREE::VM::AndI32Op>,
-              BinaryArithmeticOpConversion<OrOp, IREE::VM::OrI32Op>,
-              BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(context);
+              CmpFOpConversion, CondBranchOpConversion, ConstantOpConversion,
+              ModuleOpConversion, ModuleTerminatorOpConversion,
+              FuncOpConversion, ReturnOpConversion, IndexCastOpConversion,
+              SelectOpConversion>(context);
+
+  // Binary integer arithmetic ops
+  patterns.insert<
+      BinaryIntegerArithmeticOpConversion<AddIOp, IREE::VM::AddI32Op,
+                                          IREE::VM::AddI64Op>,
+      BinaryIntegerArithmeticOpConversion<SignedDivIOp, IREE::VM::DivI32SOp,
+                                          IREE::VM::DivI64SOp>,
+      BinaryIntegerArithmeticOpConversion<UnsignedDivIOp, IREE::VM::DivI32UOp,
+                                          IREE::VM::DivI64UOp>,
+      BinaryIntegerArithmeticOpConversion<MulIOp, IREE::VM::MulI32Op,
+                                          IREE::VM::MulI64Op>,
+      BinaryIntegerArithmeticOpConversion<SignedRemIOp, IREE::VM::RemI32SOp,
+                                          IREE::VM::RemI64SOp>,
+      BinaryIntegerArithmeticOpConversion<UnsignedRemIOp, IREE::VM::RemI32UOp,
+                                          IREE::VM::RemI64UOp>,
+      BinaryIntegerArithmeticOpConversion<SubIOp, IREE::VM::SubI32Op,
+                                          IREE::VM::SubI64Op>,
+      BinaryIntegerArithmeticOpConversion<AndOp, IREE::VM::AndI32Op,
+                                          IREE::VM::AndI64Op>,
+      BinaryIntegerArithmeticOpConversion<OrOp, IREE::VM::OrI32Op,
+                                          IREE::VM::OrI64Op>,
+      BinaryIntegerArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op,
+                                          IREE::VM::XorI64Op>>(context);
+
+  // Floating-point arithmetic ops
+  patterns.insert<BinaryArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op>,
+                  BinaryArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op>,
+                  BinaryArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op>,
+                  BinaryArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op>,
+                  BinaryArithmeticOpConversion<RemFOp, IREE::VM::RemF32Op>,
+                  UnaryArithmeticOpConversion<AbsFOp, IREE::VM::AbsF32Op>,
+                  UnaryArithmeticOpConversion<NegFOp, IREE::VM::NegF32Op>>(
+      context);
 
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
-  patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
+  patterns.insert<
+      ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>,
+      ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI64Op, 64>>(
       context);
+
+  // Casting ops
+  patterns.insert<
+      IntegerCastOpConversion<TruncateIOp, IREE::VM::TruncI64I32Op, 64, 32>,
+      IntegerCastOpConversion<SignExtendIOp, IREE::VM::ExtI32I64SOp, 32, 64>,
+      IntegerCastOpConversion<ZeroExtendIOp, IREE::VM::ExtI32I64UOp, 32, 64>,
+      SIToFPOpConversion>(context);
 }
 
 }  // namespace iree_compiler
@@ -169,3 +169,37 @@ module {
 }
 
 }
+
+// -----
+// CHECK-LABEL: @t011_cmp_sgt_i64
+module @t011_cmp_sgt_i64 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  // CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0: i64, %arg1 : i64) -> (i1) {
+    // CHECK: vm.cmp.lt.i64.s [[ARG1]], [[ARG0]] : i64
+    %1 = cmpi "sgt", %arg0, %arg1 : i64
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t012_cmp_olt_f32
+module @t012_cmp_olt_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: [[ARG0:%[a-zA-Z0-9]+]]
+  // CHECK-SAME: [[ARG1:%[a-zA-Z0-9]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.lt.f32 [[ARG0]], [[ARG1]] : f32
+    %1 = cmpf "olt", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
@@ -27,3 +27,59 @@ module {
 }
 
 }
+
+// -----
+// CHECK-LABEL: @t002_const.i64.nonzero
+module @t002_const.i64.nonzero {
+
+module {
+  func @non_zero() -> (i64) {
+    // CHECK: vm.const.i64 1 : i64
+    %1 = constant 1 : i64
+    return %1 : i64
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t002_const.i64.zero
+module @t002_const.i64.zero {
+
+module {
+  func @zero() -> (i64) {
+    // CHECK: vm.const.i64.zero : i64
+    %1 = constant 0 : i64
+    return %1 : i64
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_const.f32.nonzero
+module @t003_const.f32.nonzero {
+
+module {
+  func @non_zero() -> (f32) {
+    // CHECK: vm.const.f32 1.500000e+00 : f32
+    %1 = constant 1.5 : f32
+    return %1 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_const.f32.zero
+module @t003_const.f32.zero {
+
+module {
+  func @zero() -> (f32) {
+    // CHECK: vm.const.f32.zero : f32
+    %1 = constant 0.0 : f32
+    return %1 : f32
+  }
+}
+
+}
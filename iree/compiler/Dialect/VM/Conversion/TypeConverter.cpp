@@ -38,7 +38,8 @@ VMTypeConverter::VMTypeConverter() {
   });
   // Convert integer types.
   addConversion([](IntegerType integerType) -> Optional<Type> {
-    if (integerType.isSignlessInteger(32)) {
+    if (integerType.isSignlessInteger(32) ||
+        integerType.isSignlessInteger(64)) {
       return integerType;
     } else if (integerType.isInteger(1)) {
       // Promote i1 -> i32.
@@ -51,6 +52,14 @@ VMTypeConverter::VMTypeConverter() {
     return llvm::None;
   });
 
+  // Convert floating-point types. Only f32 is natively supported.
+  addConversion([](FloatType floatType) -> Optional<Type> {
+    if (floatType.isF32()) {
+      return floatType;
+    }
+    return llvm::None;
+  });
+
   // Convert index types to i32.
   addConversion([](IndexType indexType) -> Optional<Type> {
     return IntegerType::get(32, indexType.getContext());
@@ -50,14 +50,20 @@ struct VMOpAsmInterface : public OpAsmDialectInterface {
     }
     if (auto globalLoadOp = dyn_cast<GlobalLoadI32Op>(op)) {
       os << globalLoadOp.global();
+    } else if (auto globalLoadOp = dyn_cast<GlobalLoadI64Op>(op)) {
+      os << globalLoadOp.global();
+    } else if (auto globalLoadOp = dyn_cast<GlobalLoadF32Op>(op)) {
+      os << globalLoadOp.global();
     } else if (auto globalLoadOp = dyn_cast<GlobalLoadRefOp>(op)) {
       os << globalLoadOp.global();
     } else if (isa<ConstRefZeroOp>(op)) {
       os << "null";
-    } else if (isa<ConstI32ZeroOp>(op)) {
+    } else if (isa<ConstI32ZeroOp>(op) || isa<ConstI64ZeroOp>(op) ||
+               isa<ConstF32ZeroOp>(op)) {
       os << "zero";
-    } else if (auto constOp = dyn_cast<ConstI32Op>(op)) {
-      if (auto intAttr = constOp.value().dyn_cast<IntegerAttr>()) {
+    } else if (isa<ConstI32Op>(op) || isa<ConstI64Op>(op)) {
+      auto intAttr = op->getAttrOfType<IntegerAttr>("value");
+      if (intAttr) {
         if (intAttr.getValue() == 0) {
           os << "zero";
         } else {
@@ -248,6 +254,18 @@ Operation *VMDialect::materializeConstant(OpBuilder &builder, Attribute value,
       return builder.create<VM::ConstI32ZeroOp>(loc);
     }
     return builder.create<VM::ConstI32Op>(loc, convertedValue);
+  } else if (ConstI64Op::isBuildableWith(value, type)) {
+    auto convertedValue = ConstI64Op::convertConstValue(value);
+    if (convertedValue.cast<IntegerAttr>().getValue() == 0) {
+      return builder.create<VM::ConstI64ZeroOp>(loc);
+    }
+    return builder.create<VM::ConstI64Op>(loc, convertedValue);
+  } else if (ConstF32Op::isBuildableWith(value, type)) {
+    auto convertedValue = ConstF32Op::convertConstValue(value);
+    if (convertedValue.cast<FloatAttr>().getValue().isPosZero()) {
+      return builder.create<VM::ConstF32ZeroOp>(loc);
+    }
+    return builder.create<VM::ConstF32Op>(loc, convertedValue);
   } else if (type.isa<IREE::VM::RefType>()) {
     // The only constant type we support for ref_ptrs is null so we can just
     // emit that here.
@@ -56,6 +56,10 @@ class VMFuncEncoder {
   // Encodes an integer attribute as a fixed byte length based on bitwidth.
   virtual LogicalResult encodeIntAttr(IntegerAttr value) = 0;
 
+  // Encodes a floating-point attribute as its IEEE bit pattern based on
+  // bitwidth.
+  virtual LogicalResult encodeFloatAttr(FloatAttr value) = 0;
+
   // Encodes a variable-length integer array attribute.
   virtual LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) = 0;
 
@@ -73,6 +77,10 @@ class VMFuncEncoder {
   // Encodes a variable list of operands (by reference), including a count.
   virtual LogicalResult encodeOperands(Operation::operand_range values) = 0;
 
+  // Encodes the operands of a call as they map to the callee argument registers
+  // defined by the VM ABI.
+  virtual LogicalResult encodeCallOperands(Operation::operand_range values) = 0;
+
   // Encodes a result value (by reference).
   virtual LogicalResult encodeResult(Value value) = 0;
 
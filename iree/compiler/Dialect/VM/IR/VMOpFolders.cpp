@@ -16,6 +16,7 @@
 
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -70,6 +71,14 @@ Attribute onesOfType(Type type) {
   return {};
 }
 
+/// Returns true if |value| is a constant floating-point 1.0.
+bool isConstFloatOne(Value value) {
+  Attribute attr;
+  if (!matchPattern(value, m_Constant(&attr))) return false;
+  auto floatAttr = attr.dyn_cast<FloatAttr>();
+  return floatAttr && floatAttr.getValue().isExactlyValue(1.0);
+}
+
 }  // namespace
 
 //===----------------------------------------------------------------------===//
@@ -111,17 +120,18 @@ struct InlineConstGlobalOpInitializer : public OpRewritePattern<T> {
 
 /// Drops initial_values from globals where the value is 0, as by default all
 /// globals are zero-initialized upon module load.
-struct DropDefaultConstGlobalOpInitializer
-    : public OpRewritePattern<GlobalI32Op> {
-  using OpRewritePattern<GlobalI32Op>::OpRewritePattern;
-  LogicalResult matchAndRewrite(GlobalI32Op op,
+template <typename T>
+struct DropDefaultConstGlobalOpInitializer : public OpRewritePattern<T> {
+  using OpRewritePattern<T>::OpRewritePattern;
+  LogicalResult matchAndRewrite(T op,
                                 PatternRewriter &rewriter) const override {
     if (!op.initial_value().hasValue()) return failure();
-    auto value = op.initial_valueAttr().cast<IntegerAttr>();
-    if (value.getValue() != 0) return failure();
-    rewriter.replaceOpWithNewOp<GlobalI32Op>(
-        op, op.sym_name(), op.is_mutable(), op.type(),
-        llvm::to_vector<4>(op.getDialectAttrs()));
+    // Note that this compares the bit pattern of floating-point values such
+    // that -0.0 is preserved.
+    if (op.initial_valueAttr() != zerosOfType(op.type())) return failure();
+    rewriter.replaceOpWithNewOp<T>(op, op.sym_name(), op.is_mutable(),
+                                   op.type(),
+                                   llvm::to_vector<4>(op.getDialectAttrs()));
     return success();
   }
 };
@@ -131,7 +141,19 @@ struct DropDefaultConstGlobalOpInitializer
 void GlobalI32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                               MLIRContext *context) {
   results.insert<InlineConstGlobalOpInitializer<GlobalI32Op>,
-                 DropDefaultConstGlobalOpInitializer>(context);
+                 DropDefaultConstGlobalOpInitializer<GlobalI32Op>>(context);
+}
+
+void GlobalI64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalI64Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalI64Op>>(context);
+}
+
+void GlobalF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF32Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF32Op>>(context);
 }
 
 void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
@@ -142,21 +164,21 @@ void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
 namespace {
 
 /// Inlines immutable global constants into their loads.
-struct InlineConstGlobalLoadI32Op : public OpRewritePattern<GlobalLoadI32Op> {
-  using OpRewritePattern<GlobalLoadI32Op>::OpRewritePattern;
-  LogicalResult matchAndRewrite(GlobalLoadI32Op op,
+template <typename LOAD, typename GLOBAL, typename CONST, typename CONST_ZERO>
+struct InlineConstGlobalLoadPrimitiveOp : public OpRewritePattern<LOAD> {
+  using OpRewritePattern<LOAD>::OpRewritePattern;
+  LogicalResult matchAndRewrite(LOAD op,
                                 PatternRewriter &rewriter) const override {
-    auto globalAttr = op.getAttrOfType<FlatSymbolRefAttr>("global");
-    auto globalOp =
-        op.getParentOfType<VM::ModuleOp>().lookupSymbol<GlobalI32Op>(
-            globalAttr.getValue());
+    auto globalAttr = op.template getAttrOfType<FlatSymbolRefAttr>("global");
+    auto globalOp = op.template getParentOfType<VM::ModuleOp>()
+                        .template lookupSymbol<GLOBAL>(globalAttr.getValue());
     if (!globalOp) return failure();
     if (globalOp.is_mutable()) return failure();
     if (globalOp.initial_value()) {
-      rewriter.replaceOpWithNewOp<ConstI32Op>(
-          op, globalOp.initial_value().getValue());
+      rewriter.replaceOpWithNewOp<CONST>(op,
+                                         globalOp.initial_value().getValue());
     } else {
-      rewriter.replaceOpWithNewOp<ConstI32ZeroOp>(op);
+      rewriter.replaceOpWithNewOp<CONST_ZERO>(op);
     }
     return success();
   }
@@ -166,7 +188,20 @@ struct InlineConstGlobalLoadI32Op : public OpRewritePattern<GlobalLoadI32Op> {
 
 void GlobalLoadI32Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadI32Op>(context);
+  results.insert<InlineConstGlobalLoadPrimitiveOp<
+      GlobalLoadI32Op, GlobalI32Op, ConstI32Op, ConstI32ZeroOp>>(context);
+}
+
+void GlobalLoadI64Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<
+      GlobalLoadI64Op, GlobalI64Op, ConstI64Op, ConstI64ZeroOp>>(context);
+}
+
+void GlobalLoadF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<
+      GlobalLoadF32Op, GlobalF32Op, ConstF32Op, ConstF32ZeroOp>>(context);
 }
 
 namespace {
@@ -269,10 +304,22 @@ void GlobalStoreIndirectRefOp::getCanonicalizationPatterns(
 
 OpFoldResult ConstI32Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
+OpFoldResult ConstI64Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
 OpFoldResult ConstI32ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return IntegerAttr::get(getResult().getType(), 0);
+}
+
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -305,6 +352,14 @@ OpFoldResult SelectI32Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -415,175 +470,391 @@ Attribute constFoldBinaryOp(ArrayRef<Attribute> operands,
   return {};
 }
 
+/// Performs const folding `calculate` on the scalar attribute in `operands`
+/// producing a value of `resultType`, which may differ from the operand type.
+template <class SrcAttrElementT, class DstAttrElementT,
+          class CalculationT = std::function<
+              typename DstAttrElementT::ValueType(
+                  typename SrcAttrElementT::ValueType)>>
+Attribute constFoldConversionOp(Type resultType, ArrayRef<Attribute> operands,
+                                const CalculationT &calculate) {
+  assert(operands.size() == 1 && "conversion op takes one operand");
+  if (auto operand = operands[0].dyn_cast_or_null<SrcAttrElementT>()) {
+    return DstAttrElementT::get(resultType, calculate(operand.getValue()));
+  }
+  return {};
+}
+
+/// Performs const folding of the comparison `calculate` on the two scalar
+/// attributes in `operands` and returns the boolean result as an integer of
+/// `resultType`.
+template <class AttrElementT,
+          class ElementValueT = typename AttrElementT::ValueType,
+          class CalculationT =
+              std::function<bool(ElementValueT, ElementValueT)>>
+Attribute constFoldCmpOp(Type resultType, ArrayRef<Attribute> operands,
+                         const CalculationT &calculate) {
+  assert(operands.size() == 2 && "comparison op takes two operands");
+  auto lhs = operands[0].dyn_cast_or_null<AttrElementT>();
+  auto rhs = operands[1].dyn_cast_or_null<AttrElementT>();
+  if (!lhs || !rhs || lhs.getType() != rhs.getType()) return {};
+  return IntegerAttr::get(resultType,
+                          calculate(lhs.getValue(), rhs.getValue()) ? 1 : 0);
+}
+
 }  // namespace
 
-OpFoldResult AddI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldAddOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x + 0 = x or 0 + y = y (commutative)
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a + b; });
 }
 
-OpFoldResult SubI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldSubOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x - 0 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a - b; });
 }
 
-OpFoldResult MulI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldMulOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x * 0 = 0 or 0 * y = 0 (commutative)
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x * 1 = x or 1 * y = y (commutative)
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a * b; });
 }
 
-OpFoldResult DivI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldDivSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x / 0 = death
-    emitOpError() << "is a divide by constant zero";
+    op.emitOpError() << "is a divide by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero())) {
+  } else if (matchPattern(op.lhs(), m_Zero())) {
     // 0 / y = 0
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x / 1 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.sdiv(b); });
 }
 
-OpFoldResult DivI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldDivUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x / 0 = death
-    emitOpError() << "is a divide by constant zero";
+    op.emitOpError() << "is a divide by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero())) {
+  } else if (matchPattern(op.lhs(), m_Zero())) {
     // 0 / y = 0
-    return zerosOfType(getType());
-  } else if (matchPattern(rhs(), m_One())) {
+    return zerosOfType(op.getType());
+  } else if (matchPattern(op.rhs(), m_One())) {
     // x / 1 = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.udiv(b); });
 }
 
-OpFoldResult RemI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldRemSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x % 0 = death
-    emitOpError() << "is a remainder by constant zero";
+    op.emitOpError() << "is a remainder by constant zero";
     return {};
-  } else if (matchPattern(lhs(), m_Zero()) || matchPattern(rhs(), m_One())) {
+  } else if (matchPattern(op.lhs(), m_Zero()) ||
+             matchPattern(op.rhs(), m_One())) {
     // x % 1 = 0
     // 0 % y = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.srem(b); });
 }
 
-OpFoldResult RemI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(lhs(), m_Zero()) || matchPattern(rhs(), m_One())) {
+template <typename T>
+static OpFoldResult foldRemUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.lhs(), m_Zero()) || matchPattern(op.rhs(), m_One())) {
     // x % 1 = 0
     // 0 % y = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(
       operands, [](APInt a, APInt b) { return a.urem(b); });
 }
 
-OpFoldResult NotI32Op::fold(ArrayRef<Attribute> operands) {
+template <typename T>
+static OpFoldResult foldNotOp(T op, ArrayRef<Attribute> operands) {
   return constFoldUnaryOp<IntegerAttr>(operands, [](APInt a) {
     a.flipAllBits();
     return a;
   });
 }
 
-OpFoldResult AndI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldAndOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x & 0 = 0 or 0 & y = 0 (commutative)
-    return zerosOfType(getType());
-  } else if (lhs() == rhs()) {
+    return zerosOfType(op.getType());
+  } else if (op.lhs() == op.rhs()) {
     // x & x = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a & b; });
 }
 
-OpFoldResult OrI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldOrOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x | 0 = x or 0 | y = y (commutative)
-    return lhs();
-  } else if (lhs() == rhs()) {
+    return op.lhs();
+  } else if (op.lhs() == op.rhs()) {
     // x | x = x
-    return lhs();
+    return op.lhs();
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a | b; });
 }
 
-OpFoldResult XorI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(rhs(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldXorOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_Zero())) {
     // x ^ 0 = x or 0 ^ y = y (commutative)
-    return lhs();
-  } else if (lhs() == rhs()) {
+    return op.lhs();
+  } else if (op.lhs() == op.rhs()) {
     // x ^ x = 0
-    return zerosOfType(getType());
+    return zerosOfType(op.getType());
   }
   return constFoldBinaryOp<IntegerAttr>(operands,
                                         [](APInt a, APInt b) { return a ^ b; });
 }
 
+OpFoldResult AddI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldAddOp(*this, operands);
+}
+
+OpFoldResult AddI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldAddOp(*this, operands);
+}
+
+OpFoldResult SubI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSubOp(*this, operands);
+}
+
+OpFoldResult SubI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldSubOp(*this, operands);
+}
+
+OpFoldResult MulI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulOp(*this, operands);
+}
+
+OpFoldResult MulI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulOp(*this, operands);
+}
+
+OpFoldResult DivI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivSOp(*this, operands);
+}
+
+OpFoldResult DivI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivSOp(*this, operands);
+}
+
+OpFoldResult DivI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivUOp(*this, operands);
+}
+
+OpFoldResult DivI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldDivUOp(*this, operands);
+}
+
+OpFoldResult RemI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemSOp(*this, operands);
+}
+
+OpFoldResult RemI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemSOp(*this, operands);
+}
+
+OpFoldResult RemI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemUOp(*this, operands);
+}
+
+OpFoldResult RemI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldRemUOp(*this, operands);
+}
+
+OpFoldResult NotI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldNotOp(*this, operands);
+}
+
+OpFoldResult NotI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldNotOp(*this, operands);
+}
+
+OpFoldResult AndI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldAndOp(*this, operands);
+}
+
+OpFoldResult AndI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldAndOp(*this, operands);
+}
+
+OpFoldResult OrI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldOrOp(*this, operands);
+}
+
+OpFoldResult OrI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldOrOp(*this, operands);
+}
+
+OpFoldResult XorI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldXorOp(*this, operands);
+}
+
+OpFoldResult XorI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldXorOp(*this, operands);
+}
+
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+// NOTE: identities such as x + 0 = x do not hold for IEEE floating-point values
+// (-0 + 0 = +0, NaN, etc) so only fully constant operations are folded.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a + b; });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a - b; });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  if (isConstFloatOne(rhs())) {
+    // x * 1 = x or 1 * y = y (commutative)
+    return lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a * b; });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  if (isConstFloatOne(rhs())) {
+    // x / 1 = x
+    return lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a / b; });
+}
+
+OpFoldResult RemF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    // Matches the C fmodf semantics used at runtime.
+    a.mod(b);
+    return a;
+  });
+}
+
+OpFoldResult AbsF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(operands, [](APFloat a) {
+    a.clearSign();
+    return a;
+  });
+}
+
+OpFoldResult NegF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(operands, [](APFloat a) {
+    a.changeSign();
+    return a;
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // Native bitwise shifts and rotates
 //===----------------------------------------------------------------------===//
 
-OpFoldResult ShlI32Op::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldShlOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 << y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x << 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.shl(amount()); });
+      operands, [&](APInt a) { return a.shl(op.amount()); });
 }
 
-OpFoldResult ShrI32SOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldShrSOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 >> y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x >> 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.ashr(amount()); });
+      operands, [&](APInt a) { return a.ashr(op.amount()); });
 }
 
-OpFoldResult ShrI32UOp::fold(ArrayRef<Attribute> operands) {
-  if (matchPattern(operand(), m_Zero())) {
+template <typename T>
+static OpFoldResult foldShrUOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.operand(), m_Zero())) {
     // 0 >> y = 0
-    return zerosOfType(getType());
-  } else if (amount() == 0) {
+    return zerosOfType(op.getType());
+  } else if (op.amount() == 0) {
     // x >> 0 = x
-    return operand();
+    return op.operand();
   }
   return constFoldUnaryOp<IntegerAttr>(
-      operands, [&](APInt a) { return a.lshr(amount()); });
+      operands, [&](APInt a) { return a.lshr(op.amount()); });
+}
+
+OpFoldResult ShlI32Op::fold(ArrayRef<Attribute> operands) {
+  return foldShlOp(*this, operands);
+}
+
+OpFoldResult ShlI64Op::fold(ArrayRef<Attribute> operands) {
+  return foldShlOp(*this, operands);
+}
+
+OpFoldResult ShrI32SOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrSOp(*this, operands);
+}
+
+OpFoldResult ShrI64SOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrSOp(*this, operands);
+}
+
+OpFoldResult ShrI32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrUOp(*this, operands);
+}
+
+OpFoldResult ShrI64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldShrUOp(*this, operands);
 }
 
 //===----------------------------------------------------------------------===//
@@ -610,6 +881,61 @@ OpFoldResult ExtI16I32SOp::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a) { return a.trunc(16).sext(32); });
 }
 
+OpFoldResult TruncI64I32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr, IntegerAttr>(
+      getType(), operands, [&](APInt a) { return a.trunc(32); });
+}
+
+OpFoldResult ExtI32I64SOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr, IntegerAttr>(
+      getType(), operands, [&](APInt a) { return a.sext(64); });
+}
+
+OpFoldResult ExtI32I64UOp::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr, IntegerAttr>(
+      getType(), operands, [&](APInt a) { return a.zext(64); });
+}
+
+/// Converts the integer |value| to an f32 value, treating it as |isSigned|.
+static APFloat convertIntegerToF32(const APInt &value, bool isSigned) {
+  APFloat result(APFloat::IEEEsingle());
+  result.convertFromAPInt(value, isSigned, APFloat::rmNearestTiesToEven);
+  return result;
+}
+
+/// Converts the floating-point |value| to a 32-bit integer rounding toward
+/// zero, treating the result as |isSigned|.
+static APInt convertF32ToInteger(const APFloat &value, bool isSigned) {
+  APSInt result(32, /*isUnsigned=*/!isSigned);
+  bool isExact = false;
+  value.convertToInteger(result, APFloat::rmTowardZero, &isExact);
+  return result;
+}
+
+OpFoldResult CastSI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr, FloatAttr>(
+      getType(), operands,
+      [&](APInt a) { return convertIntegerToF32(a, /*isSigned=*/true); });
+}
+
+OpFoldResult CastUI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<IntegerAttr, FloatAttr>(
+      getType(), operands,
+      [&](APInt a) { return convertIntegerToF32(a, /*isSigned=*/false); });
+}
+
+OpFoldResult CastF32SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<FloatAttr, IntegerAttr>(
+      getType(), operands,
+      [&](APFloat a) { return convertF32ToInteger(a, /*isSigned=*/true); });
+}
+
+OpFoldResult CastF32UI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<FloatAttr, IntegerAttr>(
+      getType(), operands,
+      [&](APFloat a) { return convertF32ToInteger(a, /*isSigned=*/false); });
+}
+
 //===----------------------------------------------------------------------===//
 // Native reduction (horizontal) arithmetic
 //===----------------------------------------------------------------------===//
@@ -708,6 +1034,93 @@ OpFoldResult CmpGTEI32UOp::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a, APInt b) { return a.uge(b); });
 }
 
+OpFoldResult CmpEQI64Op::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x == x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.eq(b); });
+}
+
+OpFoldResult CmpNEI64Op::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x != x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.ne(b); });
+}
+
+OpFoldResult CmpLTI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x < x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.slt(b); });
+}
+
+OpFoldResult CmpLTI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x < x = false
+    return zerosOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.ult(b); });
+}
+
+OpFoldResult CmpLTEI64SOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x <= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.sle(b); });
+}
+
+OpFoldResult CmpLTEI64UOp::fold(ArrayRef<Attribute> operands) {
+  if (lhs() == rhs()) {
+    // x <= x = true
+    return onesOfType(getType());
+  }
+  return constFoldCmpOp<IntegerAttr>(
+      getType(), operands, [&](APInt a, APInt b) { return a.ule(b); });
+}
+
+// NOTE: floating-point comparisons are ordered (false if either operand is NaN)
+// with the exception of cmp.ne which is unordered, matching the C operators.
+// This also means that x == x cannot be folded without knowing x is not NaN.
+
+OpFoldResult CmpEQF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      getType(), operands, [&](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpEqual;
+      });
+}
+
+OpFoldResult CmpNEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      getType(), operands, [&](APFloat a, APFloat b) {
+        return a.compare(b) != APFloat::cmpEqual;
+      });
+}
+
+OpFoldResult CmpLTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      getType(), operands, [&](APFloat a, APFloat b) {
+        return a.compare(b) == APFloat::cmpLessThan;
+      });
+}
+
+OpFoldResult CmpLTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpOp<FloatAttr>(
+      getType(), operands, [&](APFloat a, APFloat b) {
+        auto result = a.compare(b);
+        return result == APFloat::cmpLessThan || result == APFloat::cmpEqual;
+      });
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
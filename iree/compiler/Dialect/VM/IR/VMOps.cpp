@@ -366,7 +366,7 @@ static void printGlobalOp(OpAsmPrinter &p, Operation *op) {
     p.printSymbolName(initializer.getValue());
     p << ')';
   }
-  if (auto initialValue = op->getAttrOfType<IntegerAttr>("initial_value")) {
+  if (auto initialValue = op->getAttr("initial_value")) {
     p << ' ';
     p.printAttribute(initialValue);
   } else {
@@ -419,11 +419,13 @@ static LogicalResult verifyGlobalOp(Operation *op) {
   return success();
 }
 
-void GlobalI32Op::build(Builder *builder, OperationState &result,
-                        StringRef name, bool isMutable, Type type,
-                        Optional<StringRef> initializer,
-                        Optional<Attribute> initialValue,
-                        ArrayRef<NamedAttribute> attrs) {
+// Builds a primitive global op (such as GlobalI32Op) with either an
+// initializer function or an initial value.
+static void buildPrimitiveGlobalOp(Builder *builder, OperationState &result,
+                                   StringRef name, bool isMutable, Type type,
+                                   Optional<StringRef> initializer,
+                                   Optional<Attribute> initialValue,
+                                   ArrayRef<NamedAttribute> attrs) {
   result.addAttribute(SymbolTable::getSymbolAttrName(),
                       builder->getStringAttr(name));
   if (isMutable) {
@@ -440,24 +442,95 @@ void GlobalI32Op::build(Builder *builder, OperationState &result,
 }
 
 void GlobalI32Op::build(Builder *builder, OperationState &result,
-                        StringRef name, bool isMutable,
-                        IREE::VM::FuncOp initializer,
-                        ArrayRef<NamedAttribute> attrs) {
+                  StringRef name, bool isMutable, Type type,
+                  Optional<StringRef> initializer,
+                  Optional<Attribute> initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
+  buildPrimitiveGlobalOp(builder, result, name, isMutable, type, initializer,
+                         initialValue, attrs);
+}
+
+void GlobalI32Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable,
+                  IREE::VM::FuncOp initializer,
+                  ArrayRef<NamedAttribute> attrs) {
   build(builder, result, name, isMutable, initializer.getType().getResult(0),
         initializer.getName(), llvm::None, attrs);
 }
 
 void GlobalI32Op::build(Builder *builder, OperationState &result,
-                        StringRef name, bool isMutable, Type type,
-                        Attribute initialValue,
-                        ArrayRef<NamedAttribute> attrs) {
+                  StringRef name, bool isMutable, Type type,
+                  Attribute initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
   build(builder, result, name, isMutable, type, llvm::None, initialValue,
         attrs);
 }
 
 void GlobalI32Op::build(Builder *builder, OperationState &result,
-                        StringRef name, bool isMutable, Type type,
-                        ArrayRef<NamedAttribute> attrs) {
+                  StringRef name, bool isMutable, Type type,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, type, llvm::None, llvm::None, attrs);
+}
+
+void GlobalI64Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  Optional<StringRef> initializer,
+                  Optional<Attribute> initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
+  buildPrimitiveGlobalOp(builder, result, name, isMutable, type, initializer,
+                         initialValue, attrs);
+}
+
+void GlobalI64Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable,
+                  IREE::VM::FuncOp initializer,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, initializer.getType().getResult(0),
+        initializer.getName(), llvm::None, attrs);
+}
+
+void GlobalI64Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  Attribute initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, type, llvm::None, initialValue,
+        attrs);
+}
+
+void GlobalI64Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, type, llvm::None, llvm::None, attrs);
+}
+
+void GlobalF32Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  Optional<StringRef> initializer,
+                  Optional<Attribute> initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
+  buildPrimitiveGlobalOp(builder, result, name, isMutable, type, initializer,
+                         initialValue, attrs);
+}
+
+void GlobalF32Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable,
+                  IREE::VM::FuncOp initializer,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, initializer.getType().getResult(0),
+        initializer.getName(), llvm::None, attrs);
+}
+
+void GlobalF32Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  Attribute initialValue,
+                  ArrayRef<NamedAttribute> attrs) {
+  build(builder, result, name, isMutable, type, llvm::None, initialValue,
+        attrs);
+}
+
+void GlobalF32Op::build(Builder *builder, OperationState &result,
+                  StringRef name, bool isMutable, Type type,
+                  ArrayRef<NamedAttribute> attrs) {
   build(builder, result, name, isMutable, type, llvm::None, llvm::None, attrs);
 }
 
@@ -551,19 +624,19 @@ static LogicalResult verifyGlobalStoreOp(Operation *op) {
 // Constants
 //===----------------------------------------------------------------------===//
 
-static ParseResult parseConstI32Op(OpAsmParser &parser,
-                                   OperationState *result) {
+template <typename T>
+static ParseResult parseConstOp(OpAsmParser &parser, OperationState *result) {
   Attribute valueAttr;
   SmallVector<NamedAttribute, 1> dummyAttrs;
   if (failed(parser.parseAttribute(valueAttr, "value", dummyAttrs))) {
     return parser.emitError(parser.getCurrentLocation())
            << "Invalid attribute encoding";
   }
-  if (!ConstI32Op::isBuildableWith(valueAttr, valueAttr.getType())) {
+  if (!T::isBuildableWith(valueAttr, valueAttr.getType())) {
     return parser.emitError(parser.getCurrentLocation())
            << "Incompatible type or invalid type value formatting";
   }
-  valueAttr = ConstI32Op::convertConstValue(valueAttr);
+  valueAttr = T::convertConstValue(valueAttr);
   result->addAttribute("value", valueAttr);
   if (failed(parser.parseOptionalAttrDict(result->attributes))) {
     return parser.emitError(parser.getCurrentLocation())
@@ -572,14 +645,43 @@ static ParseResult parseConstI32Op(OpAsmParser &parser,
   return parser.addTypeToList(valueAttr.getType(), result->types);
 }
 
-static void printConstI32Op(OpAsmPrinter &p, ConstI32Op &op) {
+template <typename T>
+static void printConstOp(OpAsmPrinter &p, T &op) {
   p << op.getOperationName() << ' ';
   p.printAttribute(op.value());
   p.printOptionalAttrDict(op.getAttrs(), /*elidedAttrs=*/{"value"});
 }
 
-// static
-bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
+static ParseResult parseConstI32Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstI32Op>(parser, result);
+}
+
+static void printConstI32Op(OpAsmPrinter &p, ConstI32Op &op) {
+  printConstOp(p, op);
+}
+
+static ParseResult parseConstI64Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstI64Op>(parser, result);
+}
+
+static void printConstI64Op(OpAsmPrinter &p, ConstI64Op &op) {
+  printConstOp(p, op);
+}
+
+static ParseResult parseConstF32Op(OpAsmParser &parser,
+                                   OperationState *result) {
+  return parseConstOp<ConstF32Op>(parser, result);
+}
+
+static void printConstF32Op(OpAsmPrinter &p, ConstF32Op &op) {
+  printConstOp(p, op);
+}
+
+// Returns true if |value| is an integer-like attribute that can be converted
+// to a constant of |type|.
+static bool isConstIntegerBuildableWith(Attribute value, Type type) {
   // FlatSymbolRefAttr can only be used with a function type.
   if (value.isa<FlatSymbolRefAttr>()) {
     return false;
@@ -597,22 +699,22 @@ bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
                                            .isSignlessInteger());
 }
 
-// static
-Attribute ConstI32Op::convertConstValue(Attribute value) {
-  assert(isBuildableWith(value, value.getType()));
+// Converts an integer-like |value| to an attribute of |bitWidth|.
+static Attribute convertConstIntegerValue(Attribute value, int bitWidth) {
   Builder builder(value.getContext());
+  auto integerType = builder.getIntegerType(bitWidth);
   int32_t dims = 1;
   if (value.isa<UnitAttr>()) {
-    return builder.getI32IntegerAttr(1);
+    return builder.getIntegerAttr(integerType, APInt(bitWidth, 1));
   } else if (auto v = value.dyn_cast<BoolAttr>()) {
-    return builder.getI32IntegerAttr(v.getValue() ? 1 : 0);
+    return builder.getIntegerAttr(integerType,
+                                  APInt(bitWidth, v.getValue() ? 1 : 0));
   } else if (auto v = value.dyn_cast<IntegerAttr>()) {
-    return builder.getI32IntegerAttr(
-        static_cast<int32_t>(v.getValue().getLimitedValue()));
+    return builder.getIntegerAttr(integerType,
+                                  v.getValue().sextOrTrunc(bitWidth));
   } else if (auto v = value.dyn_cast<ElementsAttr>()) {
     dims = v.getNumElements();
-    ShapedType adjustedType =
-        VectorType::get({dims}, builder.getIntegerType(32));
+    ShapedType adjustedType = VectorType::get({dims}, integerType);
     if (auto elements = v.dyn_cast<SplatElementsAttr>()) {
       return SplatElementsAttr::get(adjustedType, elements.getSplatValue());
     } else {
@@ -624,6 +726,17 @@ Attribute ConstI32Op::convertConstValue(Attribute value) {
   return Attribute();
 }
 
+// static
+bool ConstI32Op::isBuildableWith(Attribute value, Type type) {
+  return isConstIntegerBuildableWith(value, type);
+}
+
+// static
+Attribute ConstI32Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  return convertConstIntegerValue(value, 32);
+}
+
 void ConstI32Op::build(Builder *builder, OperationState &result,
                        Attribute value) {
   Attribute newValue = convertConstValue(value);
@@ -636,10 +749,84 @@ void ConstI32Op::build(Builder *builder, OperationState &result,
   return build(builder, result, builder->getI32IntegerAttr(value));
 }
 
+// static
+bool ConstI64Op::isBuildableWith(Attribute value, Type type) {
+  return isConstIntegerBuildableWith(value, type);
+}
+
+// static
+Attribute ConstI64Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  return convertConstIntegerValue(value, 64);
+}
+
+void ConstI64Op::build(Builder *builder, OperationState &result,
+                       Attribute value) {
+  Attribute newValue = convertConstValue(value);
+  result.addAttribute("value", newValue);
+  result.addTypes(newValue.getType());
+}
+
+void ConstI64Op::build(Builder *builder, OperationState &result,
+                       int64_t value) {
+  return build(builder, result, builder->getI64IntegerAttr(value));
+}
+
+// static
+bool ConstF32Op::isBuildableWith(Attribute value, Type type) {
+  // The attribute must have the same type as 'type'.
+  if (value.getType() != type) {
+    return false;
+  }
+  return value.isa<FloatAttr>() ||
+         (value.isa<ElementsAttr>() &&
+          value.cast<ElementsAttr>().getType().getElementType().isF32());
+}
+
+// static
+Attribute ConstF32Op::convertConstValue(Attribute value) {
+  assert(isBuildableWith(value, value.getType()));
+  Builder builder(value.getContext());
+  if (auto v = value.dyn_cast<FloatAttr>()) {
+    return builder.getF32FloatAttr(
+        static_cast<float>(v.getValueAsDouble()));
+  } else if (auto v = value.dyn_cast<ElementsAttr>()) {
+    int32_t dims = v.getNumElements();
+    ShapedType adjustedType = VectorType::get({dims}, builder.getF32Type());
+    if (auto elements = v.dyn_cast<SplatElementsAttr>()) {
+      return SplatElementsAttr::get(adjustedType, elements.getSplatValue());
+    } else {
+      return DenseElementsAttr::get(
+          adjustedType, llvm::to_vector<4>(v.getValues<Attribute>()));
+    }
+  }
+  llvm_unreachable("unexpected attribute type");
+  return Attribute();
+}
+
+void ConstF32Op::build(Builder *builder, OperationState &result,
+                       Attribute value) {
+  Attribute newValue = convertConstValue(value);
+  result.addAttribute("value", newValue);
+  result.addTypes(newValue.getType());
+}
+
+void ConstF32Op::build(Builder *builder, OperationState &result, float value) {
+  return build(builder, result, builder->getF32FloatAttr(value));
+}
+
 void ConstI32ZeroOp::build(Builder *builder, OperationState &result) {
   result.addTypes(builder->getIntegerType(32));
 }
 
+void ConstI64ZeroOp::build(Builder *builder, OperationState &result) {
+  result.addTypes(builder->getIntegerType(64));
+}
+
+void ConstF32ZeroOp::build(Builder *builder, OperationState &result) {
+  result.addTypes(builder->getF32Type());
+}
+
 void ConstRefZeroOp::build(Builder *builder, OperationState &result,
                            Type objectType) {
   result.addTypes(objectType);
@@ -370,3 +370,49 @@ vm.module @shr_i32_u_folds {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @i64_folds
+vm.module @i64_folds {
+  // CHECK-LABEL: @add_i64_const
+  vm.func @add_i64_const() -> i64 {
+    // CHECK: %c8589934592 = vm.const.i64 8589934592 : i64
+    // CHECK-NEXT: vm.return %c8589934592 : i64
+    %c1 = vm.const.i64 4294967296 : i64
+    %0 = vm.add.i64 %c1, %c1 : i64
+    vm.return %0 : i64
+  }
+
+  // CHECK-LABEL: @mul_i64_by_1
+  vm.func @mul_i64_by_1(%arg0 : i64) -> i64 {
+    // CHECK: vm.return %arg0 : i64
+    %c1 = vm.const.i64 1 : i64
+    %0 = vm.mul.i64 %arg0, %c1 : i64
+    vm.return %0 : i64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @f32_folds
+vm.module @f32_folds {
+  // CHECK-LABEL: @mul_f32_const
+  vm.func @mul_f32_const() -> f32 {
+    // CHECK: [[C:%.+]] = vm.const.f32 3.000000e+00 : f32
+    // CHECK-NEXT: vm.return [[C]] : f32
+    %c0 = vm.const.f32 1.5 : f32
+    %c1 = vm.const.f32 2.0 : f32
+    %0 = vm.mul.f32 %c0, %c1 : f32
+    vm.return %0 : f32
+  }
+
+  // CHECK-LABEL: @add_f32_zero
+  vm.func @add_f32_zero(%arg0 : f32) -> f32 {
+    // x + 0 is not an identity for floating-point values.
+    // CHECK: vm.add.f32
+    %zero = vm.const.f32.zero : f32
+    %0 = vm.add.f32 %arg0, %zero : f32
+    vm.return %0 : f32
+  }
+}
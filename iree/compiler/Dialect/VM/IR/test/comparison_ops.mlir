@@ -144,3 +144,17 @@ vm.module @my_module {
     vm.return %rnz : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_i64_f32
+vm.module @my_module {
+  vm.func @cmp_i64_f32(%arg0 : i64, %arg1 : i64,
+                       %arg2 : f32, %arg3 : f32) -> (i32, i32) {
+    // CHECK: %0 = vm.cmp.lte.i64.s %arg0, %arg1 : i64
+    %0 = vm.cmp.lte.i64.s %arg0, %arg1 : i64
+    // CHECK-NEXT: %1 = vm.cmp.lt.f32 %arg2, %arg3 : f32
+    %1 = vm.cmp.lt.f32 %arg2, %arg3 : f32
+    vm.return %0, %1 : i32, i32
+  }
+}
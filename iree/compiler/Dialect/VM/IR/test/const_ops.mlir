@@ -44,3 +44,29 @@ vm.module @my_module {
     vm.return %buf0 : !vm.ref<!iree.byte_buffer>
   }
 }
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_i64
+  vm.func @const_i64() -> (i64, i64) {
+    // CHECK: %zero = vm.const.i64.zero : i64
+    %zero = vm.const.i64.zero : i64
+    // CHECK: %c4294967296 = vm.const.i64 4294967296 : i64
+    %c4294967296 = vm.const.i64 4294967296 : i64
+    vm.return %zero, %c4294967296 : i64, i64
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32
+  vm.func @const_f32() -> (f32, f32) {
+    // CHECK: %zero = vm.const.f32.zero : f32
+    %zero = vm.const.f32.zero : f32
+    // CHECK: = vm.const.f32 1.500000e+00 : f32
+    %0 = vm.const.f32 1.5 : f32
+    vm.return %zero, %0 : f32, f32
+  }
+}
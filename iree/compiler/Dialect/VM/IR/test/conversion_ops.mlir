@@ -25,3 +25,18 @@ vm.module @my_module {
     vm.return %1 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @conversion_i64_f32
+vm.module @my_module {
+  vm.func @conversion_i64_f32(%arg0 : i32) -> f32 {
+    // CHECK: %0 = vm.ext.i32.i64.u %arg0 : i32 -> i64
+    %0 = vm.ext.i32.i64.u %arg0 : i32 -> i64
+    // CHECK-NEXT: %1 = vm.trunc.i64.i32 %0 : i64 -> i32
+    %1 = vm.trunc.i64.i32 %0 : i64 -> i32
+    // CHECK-NEXT: %2 = vm.cast.ui32.f32 %1 : i32 -> f32
+    %2 = vm.cast.ui32.f32 %1 : i32 -> f32
+    vm.return %2 : f32
+  }
+}
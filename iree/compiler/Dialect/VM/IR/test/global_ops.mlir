@@ -103,3 +103,24 @@ vm.module @my_module {
     vm.return
   }
 }
+
+// -----
+
+// CHECK-LABEL: @global_i64_f32
+vm.module @my_module {
+  // CHECK: vm.global.i64 @g0 mutable 4294967296 : i64
+  vm.global.i64 @g0 mutable 4294967296 : i64
+  // CHECK: vm.global.f32 @g1 mutable 1.500000e+00 : f32
+  vm.global.f32 @g1 mutable 1.5 : f32
+  vm.func @global_i64_f32(%arg0 : i64, %arg1 : f32) -> (i64, f32) {
+    // CHECK: vm.global.store.i64 %arg0, @g0 : i64
+    vm.global.store.i64 %arg0, @g0 : i64
+    // CHECK: vm.global.store.f32 %arg1, @g1 : f32
+    vm.global.store.f32 %arg1, @g1 : f32
+    // CHECK: %g0 = vm.global.load.i64 @g0 : i64
+    %g0 = vm.global.load.i64 @g0 : i64
+    // CHECK: %g1 = vm.global.load.f32 @g1 : f32
+    %g1 = vm.global.load.f32 @g1 : f32
+    vm.return %g0, %g1 : i64, f32
+  }
+}
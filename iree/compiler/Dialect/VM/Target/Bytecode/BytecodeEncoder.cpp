@@ -18,6 +18,7 @@
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 
@@ -28,15 +29,93 @@ namespace VM {
 
 namespace {
 
-// v0 bytecode spec. This is in extreme flux and not guaranteed to be a stable
+// Returns the opcode of the const+op superinstruction for |op|, if any.
+static Optional<Opcode> getImmediateOpcode(Operation *op) {
+  if (isa<AddI32Op>(op)) return Opcode::AddI32Imm;
+  if (isa<SubI32Op>(op)) return Opcode::SubI32Imm;
+  if (isa<MulI32Op>(op)) return Opcode::MulI32Imm;
+  if (isa<AndI32Op>(op)) return Opcode::AndI32Imm;
+  if (isa<OrI32Op>(op)) return Opcode::OrI32Imm;
+  if (isa<XorI32Op>(op)) return Opcode::XorI32Imm;
+  return llvm::None;
+}
+
+// Returns the ordinal of the operand of |op| that is defined by a vm.const.i32
+// and can be encoded as the immediate of a const+op superinstruction, if any.
+static Optional<unsigned> getImmediateOperandOrdinal(Operation *op) {
+  if (!getImmediateOpcode(op).hasValue()) return llvm::None;
+  if (isa_and_nonnull<ConstI32Op>(op->getOperand(1).getDefiningOp())) {
+    return 1u;
+  }
+  // All but sub are commutative and can take the immediate from either side.
+  if (!isa<SubI32Op>(op) &&
+      isa_and_nonnull<ConstI32Op>(op->getOperand(0).getDefiningOp())) {
+    return 0u;
+  }
+  return llvm::None;
+}
+
+// Returns true if all uses of |constOp| are encoded as immediates such that the
+// constant itself does not need to be materialized in a register.
+static bool isFoldedIntoUsers(ConstI32Op constOp) {
+  for (auto &use : constOp.getResult().getUses()) {
+    auto immOrdinal = getImmediateOperandOrdinal(use.getOwner());
+    if (!immOrdinal.hasValue() ||
+        immOrdinal.getValue() != use.getOperandNumber()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the opcode of the compare-and-branch superinstruction for |op|, if
+// any.
+static Optional<Opcode> getCompareAndBranchOpcode(Operation *op) {
+  if (isa<CmpEQI32Op>(op)) return Opcode::CondBranchEQI32;
+  if (isa<CmpNEI32Op>(op)) return Opcode::CondBranchNEI32;
+  if (isa<CmpLTI32SOp>(op)) return Opcode::CondBranchLTI32S;
+  if (isa<CmpLTI32UOp>(op)) return Opcode::CondBranchLTI32U;
+  if (isa<CmpLTEI32SOp>(op)) return Opcode::CondBranchLTEI32S;
+  if (isa<CmpLTEI32UOp>(op)) return Opcode::CondBranchLTEI32U;
+  if (isa<CmpGTI32SOp>(op)) return Opcode::CondBranchGTI32S;
+  if (isa<CmpGTI32UOp>(op)) return Opcode::CondBranchGTI32U;
+  if (isa<CmpGTEI32SOp>(op)) return Opcode::CondBranchGTEI32S;
+  if (isa<CmpGTEI32UOp>(op)) return Opcode::CondBranchGTEI32U;
+  return llvm::None;
+}
+
+// Returns the vm.cond_br that |op| can be fused with into a compare-and-branch
+// superinstruction, if any. The comparison result must only be used as the
+// condition of the branch immediately following it.
+static CondBranchOp getFusableCondBranch(Operation *op) {
+  if (!getCompareAndBranchOpcode(op).hasValue()) return {};
+  auto condBranchOp = dyn_cast_or_null<CondBranchOp>(op->getNextNode());
+  if (!condBranchOp || condBranchOp.getCondition() != op->getResult(0) ||
+      !op->getResult(0).hasOneUse()) {
+    return {};
+  }
+  return condBranchOp;
+}
+
+// v1 bytecode spec. This is in extreme flux and not guaranteed to be a stable
 // representation. Always generate this from source in tooling and never check
 // in any emitted files!
-class V0BytecodeEncoder : public BytecodeEncoder {
+//
+// Changes from v0:
+// - Branch register remappings and call operands are split into one list for
+//   the primitive bank followed by one for the ref bank so that the runtime
+//   can remap each without checking register types. i64 register pairs are
+//   remapped as two i32 registers.
+// - Call operands are mapped to the callee argument registers as defined by
+//   the VM ABI at compile time.
+// - Constants and comparisons are fused with their users into
+//   superinstructions where possible (see VM_FusedOPC).
+class V1BytecodeEncoder : public BytecodeEncoder {
  public:
-  V0BytecodeEncoder(llvm::DenseMap<Type, int> *typeTable,
+  V1BytecodeEncoder(llvm::DenseMap<Type, int> *typeTable,
                     RegisterAllocation *registerAllocation)
       : typeTable_(typeTable), registerAllocation_(registerAllocation) {}
-  ~V0BytecodeEncoder() = default;
+  ~V1BytecodeEncoder() = default;
 
   LogicalResult beginBlock(Block *block) override {
     blockOffsets_[block] = bytecode_.size();
@@ -103,6 +182,20 @@ class V0BytecodeEncoder : public BytecodeEncoder {
         return writeUint16(static_cast<uint16_t>(limitedValue));
       case 32:
         return writeUint32(static_cast<uint32_t>(limitedValue));
+      case 64:
+        return writeUint64(limitedValue);
+      default:
+        return currentOp_->emitOpError()
+               << "attribute of bitwidth " << bitWidth << " not supported";
+    }
+  }
+
+  LogicalResult encodeFloatAttr(FloatAttr value) override {
+    int bitWidth = value.getType().getIntOrFloatBitWidth();
+    APInt bits = value.getValue().bitcastToAPInt();
+    switch (bitWidth) {
+      case 32:
+        return writeUint32(static_cast<uint32_t>(bits.getZExtValue()));
       default:
         return currentOp_->emitOpError()
                << "attribute of bitwidth " << bitWidth << " not supported";
@@ -143,18 +236,22 @@ class V0BytecodeEncoder : public BytecodeEncoder {
 
     // Compute required remappings - we only need to emit them when the source
     // and dest registers differ. Hopefully the allocator did a good job and
-    // this list is small :)
+    // these lists are small :)
     auto srcDstRegs = registerAllocation_->remapSuccessorRegisters(
         currentOp_, successorIndex);
-    writeUint16(srcDstRegs.size());
+    SmallVector<std::pair<uint16_t, uint16_t>, 8> i32SrcDstRegs;
+    SmallVector<std::pair<uint16_t, uint16_t>, 8> refSrcDstRegs;
     for (auto srcDstReg : srcDstRegs) {
-      if (failed(writeUint16(srcDstReg.first)) ||
-          failed(writeUint16(srcDstReg.second))) {
-        return failure();
+      // The relative order of the remappings within each bank is preserved as
+      // required to resolve hazards; the banks themselves never overlap.
+      if (isRefRegister(srcDstReg.first)) {
+        refSrcDstRegs.push_back(srcDstReg);
+      } else {
+        i32SrcDstRegs.push_back(srcDstReg);
       }
     }
-
-    return success();
+    return failure(failed(writeRemapList(i32SrcDstRegs)) ||
+                   failed(writeRemapList(refSrcDstRegs)));
   }
 
   LogicalResult encodeOperand(Value value, int ordinal) override {
@@ -175,6 +272,41 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  LogicalResult encodeCallOperands(Operation::operand_range values) override {
+    // Each bank begins left-aligned at 0 and increments per arg of its type.
+    // i64 args occupy the next even-aligned register pair in the i32 bank and
+    // are remapped as their two halves.
+    SmallVector<std::pair<uint16_t, uint16_t>, 8> i32SrcDstRegs;
+    SmallVector<uint16_t, 8> refSrcRegs;
+    uint16_t i32Ordinal = 0;
+    for (auto it : llvm::enumerate(values)) {
+      uint16_t reg = registerAllocation_->mapUseToRegister(
+          it.value(), currentOp_, it.index());
+      if (isRefRegister(reg)) {
+        refSrcRegs.push_back(reg);
+      } else if (isI64Register(reg)) {
+        i32Ordinal = (i32Ordinal + 1) & ~1;
+        uint16_t srcOrdinal = getRegisterOrdinal(reg);
+        i32SrcDstRegs.push_back({srcOrdinal, i32Ordinal++});
+        i32SrcDstRegs.push_back({srcOrdinal + 1, i32Ordinal++});
+      } else {
+        i32SrcDstRegs.push_back({reg, i32Ordinal++});
+      }
+    }
+
+    // Primitive remappings followed by the ref registers in argument order.
+    if (failed(writeRemapList(i32SrcDstRegs)) ||
+        failed(writeUint16(refSrcRegs.size()))) {
+      return failure();
+    }
+    for (auto reg : refSrcRegs) {
+      if (failed(writeUint16(reg))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
   LogicalResult encodeResult(Value value) override {
     uint16_t reg = registerAllocation_->mapUseToRegister(value, currentOp_, 0);
     return writeUint16(reg);
@@ -191,6 +323,42 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  // Encodes a binary arithmetic |op| with its vm.const.i32 operand
+  // |immOrdinal| inlined as an immediate:
+  //   [opcode][operand reg][i32 immediate][result reg]
+  LogicalResult encodeImmediateOp(Operation *op, unsigned immOrdinal) {
+    auto opcode = getImmediateOpcode(op).getValue();
+    unsigned regOrdinal = immOrdinal == 0 ? 1 : 0;
+    auto constOp = cast<ConstI32Op>(op->getOperand(immOrdinal).getDefiningOp());
+    return failure(
+        failed(encodeOpcode(stringifyOpcode(opcode),
+                            static_cast<int>(opcode))) ||
+        failed(encodeOperand(op->getOperand(regOrdinal), regOrdinal)) ||
+        failed(encodeIntAttr(constOp.getAttrOfType<IntegerAttr>("value"))) ||
+        failed(encodeResult(op->getResult(0))));
+  }
+
+  // Encodes the comparison |op| and the |condBranchOp| consuming its result
+  // as a single compare-and-branch:
+  //   [opcode][lhs reg][rhs reg][true branch][false branch]
+  LogicalResult encodeCompareAndBranch(Operation *op,
+                                       CondBranchOp condBranchOp) {
+    auto opcode = getCompareAndBranchOpcode(op).getValue();
+    if (failed(encodeOpcode(stringifyOpcode(opcode),
+                            static_cast<int>(opcode))) ||
+        failed(encodeOperand(op->getOperand(0), 0)) ||
+        failed(encodeOperand(op->getOperand(1), 1))) {
+      return failure();
+    }
+    // Branch remappings are computed relative to the branch op.
+    currentOp_ = condBranchOp.getOperation();
+    return failure(
+        failed(encodeBranch(condBranchOp.getTrueDest(),
+                            condBranchOp.getTrueOperands(), 0)) ||
+        failed(encodeBranch(condBranchOp.getFalseDest(),
+                            condBranchOp.getFalseOperands(), 1)));
+  }
+
   Optional<std::vector<uint8_t>> finish() {
     if (failed(fixupOffsets())) {
       return llvm::None;
@@ -234,6 +402,26 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return writeBytes(&value, sizeof(value));
   }
 
+  LogicalResult writeUint64(uint64_t value) {
+    return writeBytes(&value, sizeof(value));
+  }
+
+  // Writes a list of (src, dst) register pairs prefixed by its size.
+  LogicalResult writeRemapList(
+      ArrayRef<std::pair<uint16_t, uint16_t>> srcDstRegs) {
+    if (srcDstRegs.size() > UINT16_MAX ||
+        failed(writeUint16(srcDstRegs.size()))) {
+      return failure();
+    }
+    for (auto srcDstReg : srcDstRegs) {
+      if (failed(writeUint16(srcDstReg.first)) ||
+          failed(writeUint16(srcDstReg.second))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
   LogicalResult fixupOffsets() {
     for (const auto &fixup : blockOffsetFixups_) {
       auto blockOffset = blockOffsets_.find(fixup.first);
@@ -276,7 +464,10 @@ Optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
   result.i32RegisterCount = registerAllocation.getMaxI32RegisterOrdinal() + 1;
   result.refRegisterCount = registerAllocation.getMaxRefRegisterOrdinal() + 1;
 
-  V0BytecodeEncoder encoder(&typeTable, &registerAllocation);
+  V1BytecodeEncoder encoder(&typeTable, &registerAllocation);
+  // Ops that were encoded as part of a superinstruction started by a preceding
+  // op in the same block.
+  llvm::SmallPtrSet<Operation *, 8> fusedOps;
   for (auto &block : funcOp.getBlocks()) {
     if (failed(encoder.beginBlock(&block))) {
       funcOp.emitError() << "failed to begin block";
@@ -284,15 +475,32 @@ Optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     }
 
     for (auto &op : block.getOperations()) {
+      if (fusedOps.count(&op)) continue;
+      if (auto constOp = dyn_cast<ConstI32Op>(&op)) {
+        // Constants only used as immediates are never read from registers.
+        if (isFoldedIntoUsers(constOp)) continue;
+      }
+
       auto *serializableOp =
           op.getAbstractOperation()->getInterface<IREE::VM::VMSerializableOp>();
       if (!serializableOp) {
         op.emitOpError() << "is not serializable";
         return llvm::None;
       }
-      if (failed(encoder.beginOp(&op)) ||
-          failed(serializableOp->encode(&op, symbolTable, encoder)) ||
-          failed(encoder.endOp(&op))) {
+      if (failed(encoder.beginOp(&op))) {
+        op.emitOpError() << "failed to encode";
+        return llvm::None;
+      }
+      LogicalResult encodeResult = success();
+      if (auto condBranchOp = getFusableCondBranch(&op)) {
+        fusedOps.insert(condBranchOp.getOperation());
+        encodeResult = encoder.encodeCompareAndBranch(&op, condBranchOp);
+      } else if (auto immOrdinal = getImmediateOperandOrdinal(&op)) {
+        encodeResult = encoder.encodeImmediateOp(&op, immOrdinal.getValue());
+      } else {
+        encodeResult = serializableOp->encode(&op, symbolTable, encoder);
+      }
+      if (failed(encodeResult) || failed(encoder.endOp(&op))) {
         op.emitOpError() << "failed to encode";
         return llvm::None;
       }
@@ -28,6 +28,7 @@
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "iree/schemas/bytecode_module_def_generated.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Module.h"
@@ -83,8 +84,12 @@ static ModuleCounts computeModuleSymbolCounts(IREE::VM::ModuleOp moduleOp) {
       ++counts.exportFuncs;
     } else if (isa<IREE::VM::ImportOp>(op)) {
       ++counts.importFuncs;
-    } else if (isa<IREE::VM::GlobalI32Op>(op)) {
+    } else if (isa<IREE::VM::GlobalI32Op>(op) ||
+               isa<IREE::VM::GlobalF32Op>(op)) {
       counts.globalBytes += 4;
+    } else if (isa<IREE::VM::GlobalI64Op>(op)) {
+      // Matches the alignment applied by OrdinalAllocationPass.
+      counts.globalBytes = llvm::alignTo(counts.globalBytes, 8) + 8;
     } else if (isa<IREE::VM::GlobalRefOp>(op)) {
       ++counts.globalRefs;
     } else if (isa<IREE::VM::RodataOp>(op)) {
@@ -81,6 +81,20 @@ static Offset<Vector<uint8_t>> serializeConstantI64Array(
   return byteVector;
 }
 
+// Serializes f16 and bf16 values, which share a 16-bit storage size.
+static Offset<Vector<uint8_t>> serializeConstantF16Array(
+    DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
+  uint8_t *bytePtr = nullptr;
+  auto byteVector =
+      fbb.CreateUninitializedVector(attr.getNumElements() * 2, &bytePtr);
+  uint16_t *nativePtr = reinterpret_cast<uint16_t *>(bytePtr);
+  for (const APFloat &value : attr.getFloatValues()) {
+    *(nativePtr++) =
+        value.bitcastToAPInt().extractBitsAsZExtValue(16, 0) & UINT16_MAX;
+  }
+  return byteVector;
+}
+
 static Offset<Vector<uint8_t>> serializeConstantF32Array(
     DenseFPElementsAttr attr, FlatBufferBuilder &fbb) {
   uint8_t *bytePtr = nullptr;
@@ -125,6 +139,8 @@ Offset<Vector<uint8_t>> serializeConstant(Location loc,
     }
   } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
+      case 16:
+        return serializeConstantF16Array(attr, fbb);
       case 32:
         return serializeConstantF32Array(attr, fbb);
       case 64:
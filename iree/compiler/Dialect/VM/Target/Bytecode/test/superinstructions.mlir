@@ -0,0 +1,39 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text %s | IreeFileCheck %s
+
+// CHECK-LABEL: name: "compare_and_branch"
+vm.module @compare_and_branch {
+  vm.export @cmp_br
+  vm.func @cmp_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    %cmp = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %cmp, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+
+  // The comparison and branch are encoded as a single CondBranchLTI32S (0x57)
+  // with empty i32 and ref remapping lists for each successor.
+  // CHECK: bytecode_data: [ 87, 0, 0, 1, 0,
+  // CHECK-SAME: 21, 0, 0, 0, 0, 0, 0, 0,
+  // CHECK-SAME: 26, 0, 0, 0, 0, 0, 0, 0,
+  // CHECK-SAME: 84, 1, 0, 0, 0,
+  // CHECK-SAME: 84, 1, 0, 1, 0 ]
+}
+
+// -----
+
+// CHECK-LABEL: name: "const_and_op"
+vm.module @const_and_op {
+  vm.export @add_imm
+  vm.func @add_imm(%arg0 : i32) -> i32 {
+    %c5 = vm.const.i32 5 : i32
+    %0 = vm.add.i32 %arg0, %c5 : i32
+    vm.return %0 : i32
+  }
+
+  // The constant is not materialized and is instead encoded as the immediate
+  // of an AddI32Imm (0x14).
+  // CHECK: bytecode_data: [ 20, 0, 0, 5, 0, 0, 0, {{[0-9]+}}, 0,
+  // CHECK-SAME: 84, 1, 0, {{[0-9]+}}, 0 ]
+}
@@ -0,0 +1,1192 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
+
+#include <string>
+#include <vector>
+
+#include "iree/compiler/Dialect/VM/IR/VMDialect.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/IR/VMTypes.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Format.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/Module.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/ControlFlowInterfaces.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/Passes.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+namespace {
+
+// Kinds of values that can be held in C locals.
+enum class ValueKind {
+  kI32,
+  kI64,
+  kF32,
+  kRef,
+};
+
+// Returns the kind of values of |type| or None if the type is not supported.
+Optional<ValueKind> getValueKind(Type type) {
+  if (type.isa<IREE::VM::RefType>()) return ValueKind::kRef;
+  if (type.isInteger(32)) return ValueKind::kI32;
+  if (type.isInteger(64)) return ValueKind::kI64;
+  if (type.isF32()) return ValueKind::kF32;
+  return llvm::None;
+}
+
+// Returns the C type used to hold values of |kind|.
+StringRef getCType(ValueKind kind) {
+  switch (kind) {
+    case ValueKind::kI32:
+      return "int32_t";
+    case ValueKind::kI64:
+      return "int64_t";
+    case ValueKind::kF32:
+      return "float";
+    case ValueKind::kRef:
+      return "iree_vm_ref_t";
+  }
+  llvm_unreachable("unhandled value kind");
+}
+
+// Returns the name of the IREE_VM_C_REG_* accessor for |kind|.
+StringRef getRegisterAccessor(ValueKind kind) {
+  switch (kind) {
+    case ValueKind::kI32:
+      return "IREE_VM_C_REG_I32";
+    case ValueKind::kI64:
+      return "IREE_VM_C_REG_I64";
+    case ValueKind::kF32:
+      return "IREE_VM_C_REG_F32";
+    case ValueKind::kRef:
+      return "IREE_VM_C_REG_REF";
+  }
+  llvm_unreachable("unhandled value kind");
+}
+
+// Assigns ABI registers to a list of values as done by the VM calling
+// convention: each bank begins left-aligned at 0 and i64 values occupy the next
+// even-aligned pair of registers in the i32 bank.
+std::vector<uint16_t> assignABIRegisters(ArrayRef<ValueKind> kinds) {
+  std::vector<uint16_t> registers;
+  registers.reserve(kinds.size());
+  int i32RegisterOffset = 0;
+  int refRegisterOffset = 0;
+  for (auto kind : kinds) {
+    switch (kind) {
+      case ValueKind::kI32:
+      case ValueKind::kF32:
+        registers.push_back(i32RegisterOffset++);
+        break;
+      case ValueKind::kI64:
+        i32RegisterOffset = (i32RegisterOffset + 1) & ~1;
+        registers.push_back(0x4000 | i32RegisterOffset);
+        i32RegisterOffset += 2;
+        break;
+      case ValueKind::kRef:
+        registers.push_back(0x8000 | refRegisterOffset++);
+        break;
+    }
+  }
+  return registers;
+}
+
+// Returns the number of i32 registers used by |kinds| when assigned with
+// assignABIRegisters.
+int countI32Registers(ArrayRef<ValueKind> kinds) {
+  int i32RegisterCount = 0;
+  for (auto kind : kinds) {
+    switch (kind) {
+      case ValueKind::kI32:
+      case ValueKind::kF32:
+        ++i32RegisterCount;
+        break;
+      case ValueKind::kI64:
+        i32RegisterCount = ((i32RegisterCount + 1) & ~1) + 2;
+        break;
+      case ValueKind::kRef:
+        break;
+    }
+  }
+  return i32RegisterCount;
+}
+
+// Returns the number of ref registers used in |kinds|.
+int countRefs(ArrayRef<ValueKind> kinds) {
+  return llvm::count(kinds, ValueKind::kRef);
+}
+
+// Returns |name| with all characters that are not valid in C identifiers
+// replaced with underscores.
+std::string sanitizeIdentifier(StringRef name) {
+  std::string result = name.str();
+  for (auto &c : result) {
+    if (!llvm::isAlnum(c) && c != '_') c = '_';
+  }
+  if (!result.empty() && llvm::isDigit(result[0])) result.insert(0, "_");
+  return result;
+}
+
+// Returns |value| as an escaped C string literal.
+std::string quoteString(StringRef value) {
+  std::string result = "\"";
+  for (unsigned char c : value) {
+    if (c == '\\' || c == '"') {
+      result += '\\';
+      result += c;
+    } else if (llvm::isPrint(c)) {
+      result += c;
+    } else {
+      // Octal escapes always take 3 digits so they cannot merge with any
+      // following digits.
+      result += '\\';
+      result += '0' + ((c >> 6) & 7);
+      result += '0' + ((c >> 3) & 7);
+      result += '0' + (c & 7);
+    }
+  }
+  result += "\"";
+  return result;
+}
+
+// Returns an iree_string_view_t initializer for |value|.
+std::string makeStringView(StringRef value) {
+  return "{" + quoteString(value) + ", " + std::to_string(value.size()) + "}";
+}
+
+// Returns a C literal for the given 32-bit integer.
+std::string makeI32Literal(int32_t value) {
+  if (value == INT32_MIN) return "INT32_MIN";
+  return std::to_string(value);
+}
+
+// Returns a C literal for the given 64-bit integer.
+std::string makeI64Literal(int64_t value) {
+  if (value == INT64_MIN) return "INT64_MIN";
+  return "INT64_C(" + std::to_string(value) + ")";
+}
+
+// Returns a C literal that exactly represents the given 32-bit float.
+std::string makeF32Literal(APFloat value) {
+  if (value.isNaN()) return "NAN";
+  if (value.isInfinity()) return value.isNegative() ? "-INFINITY" : "INFINITY";
+  // Hexadecimal float literals are exact and do not depend on the host
+  // rounding behavior when parsed.
+  llvm::SmallString<32> buffer;
+  buffer.resize(32);
+  unsigned length = value.convertToHexString(
+      buffer.data(), /*hexDigits=*/0, /*upperCase=*/false,
+      APFloat::rmNearestTiesToEven);
+  buffer.resize(length);
+  return std::string(buffer.str()) + "f";
+}
+
+// Returns a C expression template for ops whose result is a pure function of
+// their operands. $0..$N are replaced with the operand locals.
+Optional<StringRef> getExpressionTemplate(Operation *op) {
+  static const llvm::StringMap<StringRef> *templates = []() {
+    auto *map = new llvm::StringMap<StringRef>();
+    auto &m = *map;
+    m[ConstI32ZeroOp::getOperationName()] = "0";
+    m[ConstI64ZeroOp::getOperationName()] = "0";
+    m[ConstF32ZeroOp::getOperationName()] = "0.0f";
+    m[SelectI32Op::getOperationName()] = "$0 ? $1 : $2";
+    m[SelectI64Op::getOperationName()] = "$0 ? $1 : $2";
+    m[SelectF32Op::getOperationName()] = "$0 ? $1 : $2";
+
+    // Signed overflow is undefined in C so wrapping ops go through unsigned.
+    m[AddI32Op::getOperationName()] = "(int32_t)((uint32_t)$0 + (uint32_t)$1)";
+    m[SubI32Op::getOperationName()] = "(int32_t)((uint32_t)$0 - (uint32_t)$1)";
+    m[MulI32Op::getOperationName()] = "(int32_t)((uint32_t)$0 * (uint32_t)$1)";
+    m[DivI32SOp::getOperationName()] = "$0 / $1";
+    m[DivI32UOp::getOperationName()] = "(int32_t)((uint32_t)$0 / (uint32_t)$1)";
+    m[RemI32SOp::getOperationName()] = "$0 % $1";
+    m[RemI32UOp::getOperationName()] = "(int32_t)((uint32_t)$0 % (uint32_t)$1)";
+    m[NotI32Op::getOperationName()] = "~$0";
+    m[AndI32Op::getOperationName()] = "$0 & $1";
+    m[OrI32Op::getOperationName()] = "$0 | $1";
+    m[XorI32Op::getOperationName()] = "$0 ^ $1";
+
+    m[AddI64Op::getOperationName()] = "(int64_t)((uint64_t)$0 + (uint64_t)$1)";
+    m[SubI64Op::getOperationName()] = "(int64_t)((uint64_t)$0 - (uint64_t)$1)";
+    m[MulI64Op::getOperationName()] = "(int64_t)((uint64_t)$0 * (uint64_t)$1)";
+    m[DivI64SOp::getOperationName()] = "$0 / $1";
+    m[DivI64UOp::getOperationName()] = "(int64_t)((uint64_t)$0 / (uint64_t)$1)";
+    m[RemI64SOp::getOperationName()] = "$0 % $1";
+    m[RemI64UOp::getOperationName()] = "(int64_t)((uint64_t)$0 % (uint64_t)$1)";
+    m[NotI64Op::getOperationName()] = "~$0";
+    m[AndI64Op::getOperationName()] = "$0 & $1";
+    m[OrI64Op::getOperationName()] = "$0 | $1";
+    m[XorI64Op::getOperationName()] = "$0 ^ $1";
+
+    m[AddF32Op::getOperationName()] = "$0 + $1";
+    m[SubF32Op::getOperationName()] = "$0 - $1";
+    m[MulF32Op::getOperationName()] = "$0 * $1";
+    m[DivF32Op::getOperationName()] = "$0 / $1";
+    m[RemF32Op::getOperationName()] = "fmodf($0, $1)";
+    m[AbsF32Op::getOperationName()] = "fabsf($0)";
+    m[NegF32Op::getOperationName()] = "-$0";
+
+    m[TruncI8Op::getOperationName()] = "(int32_t)(uint8_t)$0";
+    m[TruncI16Op::getOperationName()] = "(int32_t)(uint16_t)$0";
+    m[ExtI8I32SOp::getOperationName()] = "(int32_t)(int8_t)$0";
+    m[ExtI16I32SOp::getOperationName()] = "(int32_t)(int16_t)$0";
+    m[TruncI64I32Op::getOperationName()] = "(int32_t)$0";
+    m[ExtI32I64SOp::getOperationName()] = "(int64_t)$0";
+    m[ExtI32I64UOp::getOperationName()] = "(int64_t)(uint32_t)$0";
+    m[CastSI32F32Op::getOperationName()] = "(float)$0";
+    m[CastUI32F32Op::getOperationName()] = "(float)(uint32_t)$0";
+    m[CastF32SI32Op::getOperationName()] = "(int32_t)$0";
+    m[CastF32UI32Op::getOperationName()] = "(int32_t)(uint32_t)$0";
+
+    m[CmpEQI32Op::getOperationName()] = "$0 == $1";
+    m[CmpNEI32Op::getOperationName()] = "$0 != $1";
+    m[CmpLTI32SOp::getOperationName()] = "$0 < $1";
+    m[CmpLTI32UOp::getOperationName()] = "(uint32_t)$0 < (uint32_t)$1";
+    m[CmpLTEI32SOp::getOperationName()] = "$0 <= $1";
+    m[CmpLTEI32UOp::getOperationName()] = "(uint32_t)$0 <= (uint32_t)$1";
+    m[CmpGTI32SOp::getOperationName()] = "$0 > $1";
+    m[CmpGTI32UOp::getOperationName()] = "(uint32_t)$0 > (uint32_t)$1";
+    m[CmpGTEI32SOp::getOperationName()] = "$0 >= $1";
+    m[CmpGTEI32UOp::getOperationName()] = "(uint32_t)$0 >= (uint32_t)$1";
+    m[CmpEQI64Op::getOperationName()] = "$0 == $1";
+    m[CmpNEI64Op::getOperationName()] = "$0 != $1";
+    m[CmpLTI64SOp::getOperationName()] = "$0 < $1";
+    m[CmpLTI64UOp::getOperationName()] = "(uint64_t)$0 < (uint64_t)$1";
+    m[CmpLTEI64SOp::getOperationName()] = "$0 <= $1";
+    m[CmpLTEI64UOp::getOperationName()] = "(uint64_t)$0 <= (uint64_t)$1";
+    m[CmpEQF32Op::getOperationName()] = "$0 == $1";
+    m[CmpNEF32Op::getOperationName()] = "$0 != $1";
+    m[CmpLTF32Op::getOperationName()] = "$0 < $1";
+    m[CmpLTEF32Op::getOperationName()] = "$0 <= $1";
+    m[CmpEQRefOp::getOperationName()] = "iree_vm_ref_equal(&$0, &$1)";
+    m[CmpNERefOp::getOperationName()] = "!iree_vm_ref_equal(&$0, &$1)";
+    m[CmpNZRefOp::getOperationName()] = "$0.ptr != NULL";
+    return map;
+  }();
+  auto it = templates->find(op->getName().getStringRef());
+  if (it == templates->end()) return llvm::None;
+  return it->second;
+}
+
+// Returns a C expression template for shift ops. $0 is replaced with the
+// operand local and $a with the shift amount.
+Optional<StringRef> getShiftTemplate(Operation *op) {
+  if (isa<ShlI32Op>(op)) return StringRef("(int32_t)((uint32_t)$0 << $a)");
+  if (isa<ShrI32SOp>(op)) return StringRef("$0 >> $a");
+  if (isa<ShrI32UOp>(op)) return StringRef("(int32_t)((uint32_t)$0 >> $a)");
+  if (isa<ShlI64Op>(op)) return StringRef("(int64_t)((uint64_t)$0 << $a)");
+  if (isa<ShrI64SOp>(op)) return StringRef("$0 >> $a");
+  if (isa<ShrI64UOp>(op)) return StringRef("(int64_t)((uint64_t)$0 >> $a)");
+  return llvm::None;
+}
+
+// Emits the C source or header for a vm.module.
+class CModuleEmitter {
+ public:
+  CModuleEmitter(IREE::VM::ModuleOp moduleOp, CTargetOptions targetOptions,
+                 llvm::raw_ostream &output)
+      : moduleOp_(moduleOp),
+        symbolTable_(moduleOp),
+        output_(output),
+        prefix_(sanitizeIdentifier(targetOptions.symbolPrefix.empty()
+                                       ? moduleOp.sym_name()
+                                       : targetOptions.symbolPrefix)) {}
+
+  LogicalResult emitHeader();
+  LogicalResult emitSource();
+
+ private:
+  // Returns the ordinal assigned by OrdinalAllocationPass to |symbolOp|.
+  int32_t getOrdinal(Operation *symbolOp) {
+    return symbolOp->getAttrOfType<IntegerAttr>("ordinal").getInt();
+  }
+  int32_t getSymbolOrdinal(StringRef symbolName) {
+    return getOrdinal(symbolTable_.lookup(symbolName));
+  }
+
+  std::string getFunctionName(IREE::VM::FuncOp funcOp) {
+    return prefix_ + "_" + sanitizeIdentifier(funcOp.getName());
+  }
+
+  LogicalResult emitRodata(IREE::VM::RodataOp rodataOp);
+  LogicalResult emitFunctionSignature(IREE::VM::FuncOp funcOp);
+  LogicalResult emitFunction(IREE::VM::FuncOp funcOp);
+  LogicalResult emitShim(IREE::VM::FuncOp funcOp);
+  LogicalResult emitDescriptor();
+
+  LogicalResult emitOp(Operation *op);
+  LogicalResult emitCall(Operation *op, StringRef callee,
+                         Optional<DenseIntElementsAttr> segmentSizes);
+  LogicalResult emitImportCall(Operation *op, IREE::VM::ImportOp importOp,
+                               Optional<DenseIntElementsAttr> segmentSizes);
+  void emitBranch(Block *dest, OperandRange operands, StringRef indent);
+  void emitAssign(Value dst, StringRef src, StringRef indent);
+
+  // Returns the name of the local holding |value|.
+  StringRef getLocal(Value value) { return valueNames_[value]; }
+
+  IREE::VM::ModuleOp moduleOp_;
+  SymbolTable symbolTable_;
+  llvm::raw_ostream &output_;
+  std::string prefix_;
+
+  // Per-function state.
+  llvm::DenseMap<Value, std::string> valueNames_;
+  llvm::DenseMap<Block *, int> blockIds_;
+  int nextTempId_ = 0;
+};
+
+LogicalResult CModuleEmitter::emitHeader() {
+  std::string guard = StringRef(prefix_).upper() + "_H_";
+  output_ << "// Generated from vm.module @" << moduleOp_.sym_name()
+          << " by the IREE VM C target. Do not edit.\n\n";
+  output_ << "#ifndef " << guard << "\n";
+  output_ << "#define " << guard << "\n\n";
+  output_ << "#include \"iree/base/api.h\"\n";
+  output_ << "#include \"iree/vm/module.h\"\n\n";
+  output_ << "#ifdef __cplusplus\n";
+  output_ << "extern \"C\" {\n";
+  output_ << "#endif  // __cplusplus\n\n";
+  output_ << "// Creates an instance of the " << moduleOp_.sym_name()
+          << " module.\n";
+  output_ << "iree_status_t " << prefix_
+          << "_create(iree_allocator_t allocator, "
+             "iree_vm_module_t** out_module);\n\n";
+  output_ << "#ifdef __cplusplus\n";
+  output_ << "}  // extern \"C\"\n";
+  output_ << "#endif  // __cplusplus\n\n";
+  output_ << "#endif  // " << guard << "\n";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitSource() {
+  output_ << "// Generated from vm.module @" << moduleOp_.sym_name()
+          << " by the IREE VM C target. Do not edit.\n\n";
+  output_ << "#include <math.h>\n";
+  output_ << "#include <string.h>\n\n";
+  output_ << "#include \"iree/vm/c_module.h\"\n\n";
+
+  for (auto rodataOp : moduleOp_.getBlock().getOps<IREE::VM::RodataOp>()) {
+    if (failed(emitRodata(rodataOp))) return failure();
+  }
+  for (auto funcOp : moduleOp_.getBlock().getOps<IREE::VM::FuncOp>()) {
+    if (failed(emitFunctionSignature(funcOp))) return failure();
+    output_ << ";\n";
+  }
+  output_ << "\n";
+  for (auto funcOp : moduleOp_.getBlock().getOps<IREE::VM::FuncOp>()) {
+    if (failed(emitFunction(funcOp))) return failure();
+  }
+  for (auto funcOp : moduleOp_.getBlock().getOps<IREE::VM::FuncOp>()) {
+    if (failed(emitShim(funcOp))) return failure();
+  }
+  return emitDescriptor();
+}
+
+// Serializes the contents of |elementsAttr| in the same format as the bytecode
+// target: densely packed little-endian elements.
+static LogicalResult serializeConstant(Location loc, ElementsAttr elementsAttr,
+                                       std::vector<uint8_t> &bytes) {
+  auto appendBits = [&](const APInt &value) {
+    for (unsigned i = 0; i < value.getBitWidth(); i += 8) {
+      bytes.push_back(value.extractBitsAsZExtValue(8, i) & UINT8_MAX);
+    }
+  };
+  if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
+    unsigned bitWidth = attr.getType().getElementTypeBitWidth();
+    if (bitWidth != 8 && bitWidth != 16 && bitWidth != 32 && bitWidth != 64) {
+      return emitError(loc) << "unhandled element bitwidth " << bitWidth;
+    }
+    for (const APInt &value : attr.getIntValues()) appendBits(value);
+    return success();
+  } else if (auto attr = elementsAttr.dyn_cast<DenseFPElementsAttr>()) {
+    unsigned bitWidth = attr.getType().getElementTypeBitWidth();
+    if (bitWidth != 32 && bitWidth != 64) {
+      return emitError(loc) << "unhandled element bitwidth " << bitWidth;
+    }
+    for (const APFloat &value : attr.getFloatValues()) {
+      appendBits(value.bitcastToAPInt());
+    }
+    return success();
+  }
+  return emitError(loc) << "unimplemented attribute encoding: "
+                        << elementsAttr.getType();
+}
+
+LogicalResult CModuleEmitter::emitRodata(IREE::VM::RodataOp rodataOp) {
+  std::vector<uint8_t> bytes;
+  if (failed(serializeConstant(rodataOp.getLoc(), rodataOp.value(), bytes))) {
+    return rodataOp.emitOpError() << "failed to encode";
+  }
+  output_ << "static iree_alignas(16) const uint8_t " << prefix_ << "_rodata_"
+          << getOrdinal(rodataOp) << "[" << std::max<size_t>(bytes.size(), 1)
+          << "] = {";
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    output_ << (i % 16 == 0 ? "\n    " : " ") << static_cast<int>(bytes[i])
+            << ",";
+  }
+  output_ << "\n};\n\n";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitFunctionSignature(IREE::VM::FuncOp funcOp) {
+  auto functionType = funcOp.getType();
+  output_ << "static iree_status_t " << getFunctionName(funcOp)
+          << "(iree_vm_stack_t* stack, iree_vm_c_module_state_t* state";
+  for (auto type : llvm::enumerate(functionType.getInputs())) {
+    auto kind = getValueKind(type.value());
+    if (!kind) {
+      return funcOp.emitError()
+             << "argument type " << type.value()
+             << " is not supported by the C target";
+    }
+    output_ << ", " << getCType(*kind)
+            << (*kind == ValueKind::kRef ? "* arg" : " arg") << type.index();
+  }
+  for (auto type : llvm::enumerate(functionType.getResults())) {
+    auto kind = getValueKind(type.value());
+    if (!kind) {
+      return funcOp.emitError() << "result type " << type.value()
+                                << " is not supported by the C target";
+    }
+    output_ << ", " << getCType(*kind) << "* out_result" << type.index();
+  }
+  output_ << ")";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitFunction(IREE::VM::FuncOp funcOp) {
+  if (funcOp.empty()) {
+    return funcOp.emitError() << "functions must have bodies";
+  }
+
+  // Assign names to all values and blocks. Every value gets its own local;
+  // the C compiler is much better at register allocation than we are.
+  valueNames_.clear();
+  blockIds_.clear();
+  nextTempId_ = 0;
+  SmallVector<std::pair<std::string, ValueKind>, 32> locals;
+  auto declareValue = [&](Value value) -> LogicalResult {
+    auto kind = getValueKind(value.getType());
+    if (!kind) {
+      return emitError(value.getLoc())
+             << "type " << value.getType()
+             << " is not supported by the C target";
+    }
+    std::string name = "v" + std::to_string(valueNames_.size());
+    valueNames_[value] = name;
+    locals.push_back({name, *kind});
+    return success();
+  };
+  for (auto &block : funcOp.getBlocks()) {
+    blockIds_[&block] = blockIds_.size();
+    for (auto arg : block.getArguments()) {
+      if (failed(declareValue(arg))) return failure();
+    }
+    for (auto &op : block) {
+      for (auto result : op.getResults()) {
+        if (failed(declareValue(result))) return failure();
+      }
+    }
+  }
+
+  if (failed(emitFunctionSignature(funcOp))) return failure();
+  output_ << " {\n";
+  output_ << "  iree_status_t status = IREE_STATUS_OK;\n";
+  for (auto &local : locals) {
+    output_ << "  " << getCType(local.second) << " " << local.first
+            << (local.second == ValueKind::kRef ? " = {0};\n" : " = 0;\n");
+  }
+
+  // Bind the entry block arguments to the function arguments. Refs are retained
+  // so that they are released along with all other locals on exit.
+  for (auto arg : llvm::enumerate(funcOp.getArguments())) {
+    if (getValueKind(arg.value().getType()) == ValueKind::kRef) {
+      output_ << "  iree_vm_ref_retain(arg" << arg.index() << ", &"
+              << getLocal(arg.value()) << ");\n";
+    } else {
+      output_ << "  " << getLocal(arg.value()) << " = arg" << arg.index()
+              << ";\n";
+    }
+  }
+
+  for (auto &block : funcOp.getBlocks()) {
+    if (!block.isEntryBlock()) {
+      output_ << "bb" << blockIds_[&block] << ":\n";
+    }
+    for (auto &op : block) {
+      if (failed(emitOp(&op))) return failure();
+    }
+  }
+
+  output_ << "exit:\n";
+  for (auto &local : locals) {
+    if (local.second == ValueKind::kRef) {
+      output_ << "  iree_vm_ref_release(&" << local.first << ");\n";
+    }
+  }
+  output_ << "  return status;\n";
+  output_ << "}\n\n";
+  return success();
+}
+
+void CModuleEmitter::emitAssign(Value dst, StringRef src, StringRef indent) {
+  if (getValueKind(dst.getType()) == ValueKind::kRef) {
+    output_ << indent << "iree_vm_ref_retain(&" << src << ", &" << getLocal(dst)
+            << ");\n";
+  } else {
+    output_ << indent << getLocal(dst) << " = " << src << ";\n";
+  }
+}
+
+void CModuleEmitter::emitBranch(Block *dest, OperandRange operands,
+                                StringRef indent) {
+  if (operands.size() == 1) {
+    emitAssign(dest->getArgument(0), getLocal(*operands.begin()), indent);
+  } else if (operands.size() > 1) {
+    // Block arguments are assigned in parallel so copy all operands to
+    // temporaries before assigning any of the arguments.
+    output_ << indent << "{\n";
+    std::string innerIndent = (indent + "  ").str();
+    SmallVector<std::string, 4> temps;
+    for (auto operand : operands) {
+      auto kind = *getValueKind(operand.getType());
+      std::string temp = "t" + std::to_string(nextTempId_++);
+      temps.push_back(temp);
+      if (kind == ValueKind::kRef) {
+        output_ << innerIndent << "iree_vm_ref_t " << temp << " = {0};\n";
+        output_ << innerIndent << "iree_vm_ref_retain(&" << getLocal(operand)
+                << ", &" << temp << ");\n";
+      } else {
+        output_ << innerIndent << getCType(kind) << " " << temp << " = "
+                << getLocal(operand) << ";\n";
+      }
+    }
+    for (auto arg : llvm::enumerate(dest->getArguments())) {
+      if (getValueKind(arg.value().getType()) == ValueKind::kRef) {
+        output_ << innerIndent << "iree_vm_ref_move(&" << temps[arg.index()]
+                << ", &" << getLocal(arg.value()) << ");\n";
+      } else {
+        output_ << innerIndent << getLocal(arg.value()) << " = "
+                << temps[arg.index()] << ";\n";
+      }
+    }
+    output_ << indent << "}\n";
+  }
+  output_ << indent << "goto bb" << blockIds_[dest] << ";\n";
+}
+
+LogicalResult CModuleEmitter::emitOp(Operation *op) {
+  // Ops that are pure functions of their operands.
+  if (auto exprTemplate = getExpressionTemplate(op)) {
+    std::string expr = exprTemplate->str();
+    for (int i = op->getNumOperands() - 1; i >= 0; --i) {
+      std::string placeholder = "$" + std::to_string(i);
+      size_t pos = 0;
+      while ((pos = expr.find(placeholder, pos)) != std::string::npos) {
+        expr.replace(pos, placeholder.size(), getLocal(op->getOperand(i)));
+      }
+    }
+    output_ << "  " << getLocal(op->getResult(0)) << " = " << expr << ";\n";
+    return success();
+  } else if (auto shiftTemplate = getShiftTemplate(op)) {
+    std::string expr = shiftTemplate->str();
+    int64_t amount = op->getAttrOfType<IntegerAttr>("amount").getInt();
+    expr.replace(expr.find("$0"), 2, getLocal(op->getOperand(0)));
+    expr.replace(expr.find("$a"), 2, std::to_string(amount));
+    output_ << "  " << getLocal(op->getResult(0)) << " = " << expr << ";\n";
+    return success();
+  }
+
+  // Constants.
+  if (auto constOp = dyn_cast<ConstI32Op>(op)) {
+    auto value = constOp.getAttrOfType<IntegerAttr>("value").getInt();
+    output_ << "  " << getLocal(constOp.getResult()) << " = "
+            << makeI32Literal(static_cast<int32_t>(value)) << ";\n";
+    return success();
+  } else if (auto constOp = dyn_cast<ConstI64Op>(op)) {
+    auto value = constOp.getAttrOfType<IntegerAttr>("value").getInt();
+    output_ << "  " << getLocal(constOp.getResult()) << " = "
+            << makeI64Literal(value) << ";\n";
+    return success();
+  } else if (auto constOp = dyn_cast<ConstF32Op>(op)) {
+    auto value = constOp.getAttrOfType<FloatAttr>("value").getValue();
+    output_ << "  " << getLocal(constOp.getResult()) << " = "
+            << makeF32Literal(value) << ";\n";
+    return success();
+  } else if (auto constOp = dyn_cast<ConstRefZeroOp>(op)) {
+    output_ << "  iree_vm_ref_release(&" << getLocal(constOp.getResult())
+            << ");\n";
+    return success();
+  } else if (auto constOp = dyn_cast<ConstRefRodataOp>(op)) {
+    output_ << "  IREE_VM_C_CHECK_OK(iree_vm_ref_wrap_retain(\n"
+            << "      &state->rodata_ref_table["
+            << getSymbolOrdinal(constOp.rodata())
+            << "], iree_vm_ro_byte_buffer_type_id(), &"
+            << getLocal(constOp.getResult()) << "));\n";
+    return success();
+  }
+
+  // Globals.
+  auto emitGlobalLoad = [&](StringRef type, StringRef global, Value result) {
+    output_ << "  " << getLocal(result) << " = IREE_VM_C_GLOBAL(state, "
+            << type << ", " << getSymbolOrdinal(global) << ");\n";
+    return success();
+  };
+  auto emitGlobalStore = [&](StringRef type, StringRef global, Value value) {
+    output_ << "  IREE_VM_C_GLOBAL(state, " << type << ", "
+            << getSymbolOrdinal(global) << ") = " << getLocal(value) << ";\n";
+    return success();
+  };
+  if (auto loadOp = dyn_cast<GlobalLoadI32Op>(op)) {
+    return emitGlobalLoad("int32_t", loadOp.global(), loadOp.value());
+  } else if (auto loadOp = dyn_cast<GlobalLoadI64Op>(op)) {
+    return emitGlobalLoad("int64_t", loadOp.global(), loadOp.value());
+  } else if (auto loadOp = dyn_cast<GlobalLoadF32Op>(op)) {
+    return emitGlobalLoad("float", loadOp.global(), loadOp.value());
+  } else if (auto storeOp = dyn_cast<GlobalStoreI32Op>(op)) {
+    return emitGlobalStore("int32_t", storeOp.global(), storeOp.value());
+  } else if (auto storeOp = dyn_cast<GlobalStoreI64Op>(op)) {
+    return emitGlobalStore("int64_t", storeOp.global(), storeOp.value());
+  } else if (auto storeOp = dyn_cast<GlobalStoreF32Op>(op)) {
+    return emitGlobalStore("float", storeOp.global(), storeOp.value());
+  } else if (auto loadOp = dyn_cast<GlobalLoadRefOp>(op)) {
+    output_ << "  iree_vm_ref_retain(&state->global_ref_table["
+            << getSymbolOrdinal(loadOp.global()) << "], &"
+            << getLocal(loadOp.value()) << ");\n";
+    return success();
+  } else if (auto storeOp = dyn_cast<GlobalStoreRefOp>(op)) {
+    output_ << "  iree_vm_ref_retain(&" << getLocal(storeOp.value())
+            << ", &state->global_ref_table["
+            << getSymbolOrdinal(storeOp.global()) << "]);\n";
+    return success();
+  } else if (isa<GlobalLoadIndirectI32Op>(op) ||
+             isa<GlobalStoreIndirectI32Op>(op)) {
+    bool isLoad = isa<GlobalLoadIndirectI32Op>(op);
+    auto offset = getLocal(op->getOperand(isLoad ? 0 : 1));
+    // Compare against the last valid offset so that large offsets cannot
+    // overflow the check.
+    output_ << "  if (" << offset << " < 0 || " << offset
+            << " > (int64_t)state->rwdata_storage.data_length - 4) {\n"
+            << "    status = IREE_STATUS_OUT_OF_RANGE;\n"
+            << "    goto exit;\n"
+            << "  }\n";
+    if (isLoad) {
+      output_ << "  " << getLocal(op->getResult(0))
+              << " = IREE_VM_C_GLOBAL(state, int32_t, " << offset << ");\n";
+    } else {
+      output_ << "  IREE_VM_C_GLOBAL(state, int32_t, " << offset
+              << ") = " << getLocal(op->getOperand(0)) << ";\n";
+    }
+    return success();
+  } else if (isa<GlobalLoadIndirectRefOp>(op) ||
+             isa<GlobalStoreIndirectRefOp>(op)) {
+    bool isLoad = isa<GlobalLoadIndirectRefOp>(op);
+    auto ordinal = getLocal(op->getOperand(isLoad ? 0 : 1));
+    output_ << "  if (" << ordinal << " < 0 || " << ordinal
+            << " >= state->global_ref_count) {\n"
+            << "    status = IREE_STATUS_OUT_OF_RANGE;\n"
+            << "    goto exit;\n"
+            << "  }\n";
+    if (isLoad) {
+      output_ << "  iree_vm_ref_retain(&state->global_ref_table[" << ordinal
+              << "], &" << getLocal(op->getResult(0)) << ");\n";
+    } else {
+      output_ << "  iree_vm_ref_retain(&" << getLocal(op->getOperand(0))
+              << ", &state->global_ref_table[" << ordinal << "]);\n";
+    }
+    return success();
+  }
+
+  // Conditional assignment.
+  if (auto selectOp = dyn_cast<SelectRefOp>(op)) {
+    output_ << "  iree_vm_ref_retain(" << getLocal(selectOp.condition())
+            << " ? &" << getLocal(selectOp.true_value()) << " : &"
+            << getLocal(selectOp.false_value()) << ", &"
+            << getLocal(selectOp.result()) << ");\n";
+    return success();
+  } else if (isa<SwitchI32Op>(op) || isa<SwitchRefOp>(op)) {
+    // Operands are (index, default_value, values...).
+    Value result = op->getResult(0);
+    output_ << "  switch (" << getLocal(op->getOperand(0)) << ") {\n";
+    for (unsigned i = 2; i < op->getNumOperands(); ++i) {
+      output_ << "    case " << (i - 2) << ":\n";
+      emitAssign(result, getLocal(op->getOperand(i)), "      ");
+      output_ << "      break;\n";
+    }
+    output_ << "    default:\n";
+    emitAssign(result, getLocal(op->getOperand(1)), "      ");
+    output_ << "      break;\n";
+    output_ << "  }\n";
+    return success();
+  }
+
+  // Control flow.
+  if (auto branchOp = dyn_cast<BranchOp>(op)) {
+    emitBranch(branchOp.getDest(), branchOp.getOperands(), "  ");
+    return success();
+  } else if (auto condBranchOp = dyn_cast<CondBranchOp>(op)) {
+    output_ << "  if (" << getLocal(condBranchOp.condition()) << ") {\n";
+    emitBranch(condBranchOp.getTrueDest(), condBranchOp.getTrueOperands(),
+               "    ");
+    output_ << "  } else {\n";
+    emitBranch(condBranchOp.getFalseDest(), condBranchOp.getFalseOperands(),
+               "    ");
+    output_ << "  }\n";
+    return success();
+  } else if (isa<BreakOp>(op) || isa<CondBreakOp>(op)) {
+    // Debug breaks are not yet implemented and continue at the target block
+    // just as in the bytecode interpreter.
+    auto operands = cast<BranchOpInterface>(op).getSuccessorOperands(0);
+    emitBranch(op->getSuccessor(0), *operands, "  ");
+    return success();
+  } else if (auto callOp = dyn_cast<CallOp>(op)) {
+    return emitCall(op, callOp.callee(), llvm::None);
+  } else if (auto callOp = dyn_cast<CallVariadicOp>(op)) {
+    return emitCall(op, callOp.callee(), callOp.segment_sizes());
+  } else if (auto returnOp = dyn_cast<ReturnOp>(op)) {
+    for (auto operand : llvm::enumerate(returnOp.getOperands())) {
+      if (getValueKind(operand.value().getType()) == ValueKind::kRef) {
+        output_ << "  iree_vm_ref_retain(&" << getLocal(operand.value())
+                << ", out_result" << operand.index() << ");\n";
+      } else {
+        output_ << "  *out_result" << operand.index() << " = "
+                << getLocal(operand.value()) << ";\n";
+      }
+    }
+    output_ << "  goto exit;\n";
+    return success();
+  } else if (isa<YieldOp>(op)) {
+    // Generated functions cannot suspend mid-function so yields continue
+    // immediately, just as synchronous invocations resume them.
+    return success();
+  }
+
+  // Debugging ops are no-ops, matching the bytecode interpreter.
+  if (isa<TraceOp>(op) || isa<PrintOp>(op)) {
+    return success();
+  }
+
+  return op->emitOpError() << "is not supported by the C target";
+}
+
+LogicalResult CModuleEmitter::emitCall(
+    Operation *op, StringRef callee,
+    Optional<DenseIntElementsAttr> segmentSizes) {
+  auto *calleeOp = symbolTable_.lookup(callee);
+  if (auto importOp = dyn_cast_or_null<IREE::VM::ImportOp>(calleeOp)) {
+    return emitImportCall(op, importOp, segmentSizes);
+  }
+  auto funcOp = dyn_cast_or_null<IREE::VM::FuncOp>(calleeOp);
+  if (!funcOp) {
+    return op->emitOpError() << "callee " << callee << " not found";
+  } else if (segmentSizes) {
+    return op->emitOpError()
+           << "variadic calls are only supported for imported functions";
+  }
+
+  // Internal calls are direct C calls with results written to the locals.
+  output_ << "  IREE_VM_C_CHECK_OK(" << getFunctionName(funcOp)
+          << "(stack, state";
+  for (auto operand : op->getOperands()) {
+    output_ << ", "
+            << (getValueKind(operand.getType()) == ValueKind::kRef ? "&" : "")
+            << getLocal(operand);
+  }
+  for (auto result : op->getResults()) {
+    output_ << ", &" << getLocal(result);
+  }
+  output_ << "));\n";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitImportCall(
+    Operation *op, IREE::VM::ImportOp importOp,
+    Optional<DenseIntElementsAttr> segmentSizes) {
+  SmallVector<ValueKind, 8> argumentKinds;
+  for (auto type : op->getOperandTypes()) {
+    argumentKinds.push_back(*getValueKind(type));
+  }
+  SmallVector<ValueKind, 8> resultKinds;
+  for (auto type : op->getResultTypes()) {
+    resultKinds.push_back(*getValueKind(type));
+  }
+  auto argumentRegisters = assignABIRegisters(argumentKinds);
+  auto resultRegisters = assignABIRegisters(resultKinds);
+
+  output_ << "  {\n";
+  if (segmentSizes) {
+    // Variadic imports receive the segment sizes in place of the return
+    // registers, matching the bytecode interpreter.
+    auto sizes = llvm::to_vector<8>(segmentSizes->getValues<int16_t>());
+    output_ << "    static const union {\n"
+            << "      uint16_t reserved[" << (sizes.size() + 1) << "];\n"
+            << "      iree_vm_register_list_t list;\n"
+            << "    } segment_sizes = {{" << sizes.size();
+    for (auto size : sizes) output_ << ", " << size;
+    output_ << "}};\n";
+  }
+  output_ << "    iree_vm_stack_frame_t* callee_frame = NULL;\n";
+  output_ << "    IREE_VM_C_CHECK_OK("
+          << "iree_vm_c_module_enter_import("
+          << "stack, state, " << getOrdinal(importOp) << ", "
+          << countI32Registers(argumentKinds) << ", "
+          << countRefs(argumentKinds) << ", &callee_frame));\n";
+  output_ << "    iree_vm_registers_t* callee_regs = "
+          << "&callee_frame->registers;\n";
+  for (auto operand : llvm::enumerate(op->getOperands())) {
+    auto kind = argumentKinds[operand.index()];
+    auto reg = argumentRegisters[operand.index()];
+    auto accessor = getRegisterAccessor(kind);
+    if (kind == ValueKind::kRef) {
+      output_ << "    memset(&" << accessor << "(callee_regs, " << reg
+              << "), 0, sizeof(iree_vm_ref_t));\n";
+      output_ << "    iree_vm_ref_retain(&" << getLocal(operand.value())
+              << ", &" << accessor << "(callee_regs, " << reg << "));\n";
+    } else {
+      output_ << "    " << accessor << "(callee_regs, " << reg
+              << ") = " << getLocal(operand.value()) << ";\n";
+    }
+  }
+  int refArgumentCount = countRefs(argumentKinds);
+  if (refArgumentCount) {
+    output_ << "    callee_regs->ref_register_count = " << refArgumentCount
+            << ";\n";
+  }
+  if (segmentSizes) {
+    output_ << "    callee_frame->return_registers = &segment_sizes.list;\n";
+  }
+  output_ << "    status = "
+          << "iree_vm_c_module_call_import(stack, callee_frame);\n";
+  if (op->getNumResults()) {
+    output_ << "    if (iree_status_is_ok(status)) {\n";
+    for (auto result : llvm::enumerate(op->getResults())) {
+      auto kind = resultKinds[result.index()];
+      auto reg = resultRegisters[result.index()];
+      std::string source =
+          (getRegisterAccessor(kind) +
+           "(callee_regs, iree_vm_c_result_register(callee_frame, " +
+           std::to_string(result.index()) + ", " + std::to_string(reg) + "))")
+              .str();
+      if (kind == ValueKind::kRef) {
+        output_ << "      iree_vm_ref_move(&" << source << ", &"
+                << getLocal(result.value()) << ");\n";
+      } else {
+        output_ << "      " << getLocal(result.value()) << " = " << source
+                << ";\n";
+      }
+    }
+    output_ << "    }\n";
+  }
+  output_ << "    iree_vm_stack_function_leave(stack);\n";
+  output_ << "    if (!iree_status_is_ok(status)) goto exit;\n";
+  output_ << "  }\n";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitShim(IREE::VM::FuncOp funcOp) {
+  auto functionType = funcOp.getType();
+  SmallVector<ValueKind, 8> argumentKinds;
+  for (auto type : functionType.getInputs()) {
+    argumentKinds.push_back(*getValueKind(type));
+  }
+  SmallVector<ValueKind, 8> resultKinds;
+  for (auto type : functionType.getResults()) {
+    resultKinds.push_back(*getValueKind(type));
+  }
+  auto argumentRegisters = assignABIRegisters(argumentKinds);
+  auto resultRegisters = assignABIRegisters(resultKinds);
+
+  output_ << "static iree_status_t " << getFunctionName(funcOp)
+          << "_shim(iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,\n"
+          << "    iree_vm_c_module_state_t* state) {\n";
+
+  // Results are returned left-aligned and refs are moved out by the caller.
+  output_ << "  static const union {\n"
+          << "    uint16_t reserved[" << (resultRegisters.size() + 1) << "];\n"
+          << "    iree_vm_register_list_t list;\n"
+          << "  } return_registers = {{" << resultRegisters.size();
+  for (auto reg : llvm::enumerate(resultRegisters)) {
+    // Ref results are marked as moves so the caller takes ownership.
+    uint16_t moveBit =
+        resultKinds[reg.index()] == ValueKind::kRef ? 0x4000 : 0;
+    output_ << ", " << llvm::format_hex(reg.value() | moveBit, 6);
+  }
+  output_ << "}};\n";
+  output_ << "  iree_vm_registers_t* regs = &frame->registers;\n";
+  for (auto kind : llvm::enumerate(resultKinds)) {
+    output_ << "  " << getCType(kind.value()) << " result" << kind.index()
+            << (kind.value() == ValueKind::kRef ? " = {0};\n" : " = 0;\n");
+  }
+  output_ << "  iree_status_t status = " << getFunctionName(funcOp)
+          << "(stack, state";
+  for (auto kind : llvm::enumerate(argumentKinds)) {
+    output_ << ", " << (kind.value() == ValueKind::kRef ? "&" : "")
+            << getRegisterAccessor(kind.value()) << "(regs, "
+            << argumentRegisters[kind.index()] << ")";
+  }
+  for (unsigned i = 0; i < resultKinds.size(); ++i) {
+    output_ << ", &result" << i;
+  }
+  output_ << ");\n";
+  output_ << "  if (!iree_status_is_ok(status)) return status;\n";
+
+  int refResultCount = countRefs(resultKinds);
+  if (!resultKinds.empty()) {
+    // Callers only reserve the registers used by the arguments.
+    output_ << "  IREE_RETURN_IF_ERROR(iree_vm_stack_frame_reserve_registers("
+            << "stack, frame, " << countI32Registers(resultKinds) << ", "
+            << refResultCount << "));\n";
+  }
+  if (refResultCount) {
+    // Registers beyond those used by the arguments are uninitialized.
+    output_ << "  for (int i = regs->ref_register_count; i < "
+            << refResultCount << "; ++i) {\n"
+            << "    memset(&regs->ref[i], 0, sizeof(iree_vm_ref_t));\n"
+            << "  }\n"
+            << "  if (regs->ref_register_count < " << refResultCount << ") {\n"
+            << "    regs->ref_register_count = " << refResultCount << ";\n"
+            << "  }\n";
+  }
+  for (auto kind : llvm::enumerate(resultKinds)) {
+    auto reg = resultRegisters[kind.index()];
+    if (kind.value() == ValueKind::kRef) {
+      output_ << "  iree_vm_ref_move(&result" << kind.index()
+              << ", &IREE_VM_C_REG_REF(regs, " << reg << "));\n";
+    } else {
+      output_ << "  " << getRegisterAccessor(kind.value()) << "(regs, " << reg
+              << ") = result" << kind.index() << ";\n";
+    }
+  }
+  output_ << "  frame->return_registers = &return_registers.list;\n";
+  output_ << "  return IREE_STATUS_OK;\n";
+  output_ << "}\n\n";
+  return success();
+}
+
+LogicalResult CModuleEmitter::emitDescriptor() {
+  SmallVector<IREE::VM::ImportOp, 8> importOps;
+  SmallVector<IREE::VM::ExportOp, 8> exportOps;
+  SmallVector<IREE::VM::FuncOp, 8> funcOps;
+  SmallVector<IREE::VM::RodataOp, 8> rodataOps;
+  int globalBytes = 0;
+  int globalRefs = 0;
+  for (auto &op : moduleOp_.getBlock().getOperations()) {
+    if (auto importOp = dyn_cast<IREE::VM::ImportOp>(op)) {
+      importOps.push_back(importOp);
+    } else if (auto exportOp = dyn_cast<IREE::VM::ExportOp>(op)) {
+      exportOps.push_back(exportOp);
+    } else if (auto funcOp = dyn_cast<IREE::VM::FuncOp>(op)) {
+      funcOps.push_back(funcOp);
+    } else if (auto rodataOp = dyn_cast<IREE::VM::RodataOp>(op)) {
+      rodataOps.push_back(rodataOp);
+    } else if (isa<IREE::VM::GlobalI32Op>(op) ||
+               isa<IREE::VM::GlobalF32Op>(op)) {
+      globalBytes = getOrdinal(&op) + 4;
+    } else if (isa<IREE::VM::GlobalI64Op>(op)) {
+      globalBytes = getOrdinal(&op) + 8;
+    } else if (isa<IREE::VM::GlobalRefOp>(op)) {
+      ++globalRefs;
+    }
+  }
+
+  // Functions are emitted in IR order which matches the ordinal order.
+  for (auto funcOp : funcOps) {
+    auto reflectionAttrs =
+        funcOp.getAttrOfType<DictionaryAttr>("iree.reflection");
+    if (!reflectionAttrs) continue;
+    output_ << "static const iree_vm_c_reflection_attr_t "
+            << getFunctionName(funcOp) << "_reflection_attrs[] = {\n";
+    for (auto reflectionAttr : reflectionAttrs) {
+      auto key = reflectionAttr.first.strref();
+      auto value = reflectionAttr.second.dyn_cast<StringAttr>();
+      if (!value || key.empty()) continue;
+      output_ << "    {" << makeStringView(key) << ", "
+              << makeStringView(value.getValue()) << "},\n";
+    }
+    output_ << "};\n\n";
+  }
+
+  if (!importOps.empty()) {
+    output_ << "static const iree_vm_c_import_descriptor_t " << prefix_
+            << "_imports[] = {\n";
+    for (auto importOp : importOps) {
+      output_ << "    {" << makeStringView(importOp.getName()) << ", {"
+              << importOp.getType().getNumInputs() << ", "
+              << importOp.getType().getNumResults() << "}},\n";
+    }
+    output_ << "};\n\n";
+  }
+  if (!exportOps.empty()) {
+    output_ << "static const iree_vm_c_export_descriptor_t " << prefix_
+            << "_exports[] = {\n";
+    for (auto exportOp : exportOps) {
+      auto funcOp =
+          symbolTable_.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
+      output_ << "    {" << makeStringView(exportOp.export_name()) << ", "
+              << getOrdinal(funcOp) << "},\n";
+    }
+    output_ << "};\n\n";
+  }
+  if (!funcOps.empty()) {
+    output_ << "static const iree_vm_c_function_descriptor_t " << prefix_
+            << "_functions[] = {\n";
+    for (auto funcOp : funcOps) {
+      auto functionName = getFunctionName(funcOp);
+      auto reflectionAttrs =
+          funcOp.getAttrOfType<DictionaryAttr>("iree.reflection");
+      output_ << "    {" << makeStringView(funcOp.getName()) << ", {"
+              << funcOp.getType().getNumInputs() << ", "
+              << funcOp.getType().getNumResults() << "}, " << functionName
+              << "_shim, ";
+      if (reflectionAttrs) {
+        output_ << "sizeof(" << functionName << "_reflection_attrs) / sizeof("
+                << functionName << "_reflection_attrs[0]), " << functionName
+                << "_reflection_attrs},\n";
+      } else {
+        output_ << "0, NULL},\n";
+      }
+    }
+    output_ << "};\n\n";
+  }
+  if (!rodataOps.empty()) {
+    output_ << "static const iree_const_byte_span_t " << prefix_
+            << "_rodata_segments[] = {\n";
+    for (auto rodataOp : rodataOps) {
+      auto name = prefix_ + "_rodata_" + std::to_string(getOrdinal(rodataOp));
+      output_ << "    {" << name << ", sizeof(" << name << ")},\n";
+    }
+    output_ << "};\n\n";
+  }
+
+  auto table = [&](bool present, StringRef suffix) {
+    return present ? prefix_ + suffix.str() : std::string("NULL");
+  };
+  output_ << "static const iree_vm_c_module_descriptor_t " << prefix_
+          << "_descriptor = {\n";
+  output_ << "    " << makeStringView(moduleOp_.sym_name()) << ",\n";
+  output_ << "    " << importOps.size() << ",\n";
+  output_ << "    " << table(!importOps.empty(), "_imports") << ",\n";
+  output_ << "    " << exportOps.size() << ",\n";
+  output_ << "    " << table(!exportOps.empty(), "_exports") << ",\n";
+  output_ << "    " << funcOps.size() << ",\n";
+  output_ << "    " << table(!funcOps.empty(), "_functions") << ",\n";
+  output_ << "    " << rodataOps.size() << ",\n";
+  output_ << "    " << table(!rodataOps.empty(), "_rodata_segments") << ",\n";
+  output_ << "    " << globalBytes << ",\n";
+  output_ << "    " << globalRefs << ",\n";
+  output_ << "};\n\n";
+
+  output_ << "iree_status_t " << prefix_
+          << "_create(iree_allocator_t allocator, "
+             "iree_vm_module_t** out_module) {\n";
+  output_ << "  return iree_vm_c_module_create(&" << prefix_
+          << "_descriptor, allocator, out_module);\n";
+  output_ << "}\n";
+  return success();
+}
+
+}  // namespace
+
+// Canonicalizes the module to its final form prior to emission.
+// This mirrors the bytecode target so that both produce modules with the same
+// ordinals and globals layout.
+static LogicalResult canonicalizeModule(CTargetOptions targetOptions,
+                                        IREE::VM::ModuleOp moduleOp) {
+  OwningRewritePatternList patterns;
+  ConversionTarget target(*moduleOp.getContext());
+  target.addLegalDialect<IREE::VM::VMDialect>();
+
+  if (targetOptions.stripDebugOps) {
+    // TODO(benvanik): add RemoveDisabledDebugOp pattern.
+    target.addIllegalOp<IREE::VM::TraceOp, IREE::VM::PrintOp, IREE::VM::BreakOp,
+                        IREE::VM::CondBreakOp>();
+  }
+
+  if (failed(applyFullConversion(moduleOp, target, patterns))) {
+    return moduleOp.emitError() << "unable to fully apply conversion to module";
+  }
+
+  PassManager passManager(moduleOp.getContext());
+  auto &modulePasses = passManager.nest<IREE::VM::ModuleOp>();
+  if (targetOptions.optimize) {
+    modulePasses.addPass(mlir::createInlinerPass());
+    modulePasses.addPass(mlir::createCSEPass());
+    modulePasses.addPass(mlir::createCanonicalizerPass());
+  }
+  modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
+
+  if (failed(passManager.run(moduleOp.getParentOfType<mlir::ModuleOp>()))) {
+    return moduleOp.emitError() << "failed during transform passes";
+  }
+
+  return success();
+}
+
+LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output) {
+  if (targetOptions.outputFormat == COutputFormat::kHeader) {
+    // The header only depends on the module name.
+    return CModuleEmitter(moduleOp, targetOptions, output).emitHeader();
+  }
+
+  if (failed(canonicalizeModule(targetOptions, moduleOp))) {
+    return moduleOp.emitError()
+           << "failed to canonicalize vm.module to a serializable form";
+  }
+
+  // Emit to a temporary buffer so that partial output is not written on
+  // failure.
+  std::string source;
+  llvm::raw_string_ostream sourceStream(source);
+  if (failed(CModuleEmitter(moduleOp, targetOptions, sourceStream)
+                 .emitSource())) {
+    return moduleOp.emitError() << "failed to emit C source";
+  }
+  output << sourceStream.str();
+  output.flush();
+  return success();
+}
+
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output) {
+  auto moduleOps = outerModuleOp.getOps<IREE::VM::ModuleOp>();
+  if (moduleOps.empty()) {
+    return outerModuleOp.emitError()
+           << "outer module does not contain a vm.module op";
+  }
+  return translateModuleToC(*moduleOps.begin(), targetOptions, output);
+}
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,74 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
+#define IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
+
+#include <string>
+
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/Module.h"
+#include "mlir/Support/LogicalResult.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+// Defines the output format of the C module.
+enum class COutputFormat {
+  // C source implementing the module functions and descriptor.
+  kSource,
+  // C header declaring the module create function.
+  kHeader,
+};
+
+// Options that can be provided to C translation.
+struct CTargetOptions {
+  // Which file of the C module is written to the output stream.
+  COutputFormat outputFormat = COutputFormat::kSource;
+
+  // Prefix used for all symbols in the generated source. Defaults to the
+  // vm.module name.
+  std::string symbolPrefix;
+
+  // Run basic CSE/inlining/etc passes prior to emission.
+  bool optimize = true;
+
+  // Strips vm ops with the VM_DebugOnly trait.
+  bool stripDebugOps = false;
+};
+
+// Translates a vm.module to C source that implements the same module using the
+// iree/vm/c_module.h runtime support. The generated source defines a
+//   iree_status_t <prefix>_create(iree_allocator_t allocator,
+//                                 iree_vm_module_t** out_module);
+// function that is declared in the header produced with
+// COutputFormat::kHeader.
+//
+// Exposed via the --iree-vm-ir-to-c-module translation.
+LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output);
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 CTargetOptions targetOptions,
+                                 llvm::raw_ostream &output);
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_VM_TARGET_C_CMODULETARGET_H_
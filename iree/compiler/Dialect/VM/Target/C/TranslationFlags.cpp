@@ -0,0 +1,67 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/VM/Target/C/TranslationFlags.h"
+
+#include "llvm/Support/CommandLine.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+static llvm::cl::opt<COutputFormat> outputFormatFlag{
+    "iree-vm-c-module-output-format",
+    llvm::cl::desc("Output format the C module is written in"),
+    llvm::cl::init(COutputFormat::kSource),
+    llvm::cl::values(
+        clEnumValN(COutputFormat::kSource, "source",
+                   "C source implementing the module"),
+        clEnumValN(COutputFormat::kHeader, "header",
+                   "C header declaring the module create function")),
+};
+
+static llvm::cl::opt<std::string> symbolPrefixFlag{
+    "iree-vm-c-module-prefix",
+    llvm::cl::desc("Prefix used for all emitted C symbols; defaults to the "
+                   "vm.module name"),
+    llvm::cl::init(""),
+};
+
+static llvm::cl::opt<bool> optimizeFlag{
+    "iree-vm-c-module-optimize",
+    llvm::cl::desc(
+        "Optimizes the VM module with CSE/inlining/etc prior to emission"),
+    llvm::cl::init(true),
+};
+
+static llvm::cl::opt<bool> stripDebugOpsFlag{
+    "iree-vm-c-module-strip-debug-ops",
+    llvm::cl::desc("Strips debug-only ops from the module"),
+    llvm::cl::init(false),
+};
+
+CTargetOptions getCTargetOptionsFromFlags() {
+  CTargetOptions targetOptions;
+  targetOptions.outputFormat = outputFormatFlag;
+  targetOptions.symbolPrefix = symbolPrefixFlag;
+  targetOptions.optimize = optimizeFlag;
+  targetOptions.stripDebugOps = stripDebugOpsFlag;
+  return targetOptions;
+}
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -0,0 +1,13 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module -iree-vm-c-module-output-format=header -iree-vm-c-module-prefix=my_module %s | IreeFileCheck %s
+
+// CHECK: #ifndef MY_MODULE_H_
+// CHECK: #include "iree/vm/module.h"
+// CHECK: extern "C" {
+// CHECK: iree_status_t my_module_create(iree_allocator_t allocator, iree_vm_module_t** out_module);
+// CHECK: #endif  // MY_MODULE_H_
+vm.module @simple_module {
+  vm.export @func
+  vm.func @func() {
+    vm.return
+  }
+}
@@ -0,0 +1,107 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+// CHECK: #include "iree/vm/c_module.h"
+vm.module @simple_module {
+  vm.export @func
+
+  // CHECK: static iree_status_t simple_module_func(iree_vm_stack_t* stack, iree_vm_c_module_state_t* state, int32_t arg0, int32_t* out_result0);
+  // CHECK: static iree_status_t simple_module_func(iree_vm_stack_t* stack, iree_vm_c_module_state_t* state, int32_t arg0, int32_t* out_result0) {
+  // CHECK-NEXT: iree_status_t status = IREE_STATUS_OK;
+  // CHECK-NEXT: int32_t v0 = 0;
+  // CHECK-NEXT: v0 = arg0;
+  // CHECK-NEXT: *out_result0 = v0;
+  // CHECK-NEXT: goto exit;
+  // CHECK-NEXT: exit:
+  // CHECK-NEXT: return status;
+  vm.func @func(%arg0 : i32) -> i32 {
+    vm.return %arg0 : i32
+  }
+
+  // CHECK: static iree_status_t simple_module_func_shim(
+  // CHECK: } return_registers = {{[{][{]}}1, 0x0000{{[}][}]}};
+  // CHECK: iree_status_t status = simple_module_func(stack, state, IREE_VM_C_REG_I32(regs, 0), &result0);
+  // CHECK: IREE_RETURN_IF_ERROR(iree_vm_stack_frame_reserve_registers(stack, frame, 1, 0));
+  // CHECK: IREE_VM_C_REG_I32(regs, 0) = result0;
+
+  // CHECK: static const iree_vm_c_export_descriptor_t simple_module_exports[] = {
+  // CHECK-NEXT: {{[{][{]}}"func", 4}, 0},
+  // CHECK: static const iree_vm_c_function_descriptor_t simple_module_functions[] = {
+  // CHECK-NEXT: {{[{][{]}}"func", 4}, {1, 1}, simple_module_func_shim, 0, NULL},
+  // CHECK: iree_status_t simple_module_create(iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  // CHECK-NEXT: return iree_vm_c_module_create(&simple_module_descriptor, allocator, out_module);
+}
+
+// -----
+
+vm.module @control_flow {
+  vm.export @loop
+  // CHECK: static iree_status_t control_flow_loop(
+  // CHECK: bb1:
+  // CHECK: if (v{{[0-9]+}}) {
+  // CHECK: goto bb1;
+  // CHECK: } else {
+  // CHECK: goto bb2;
+  vm.func @loop(%count : i32) -> i32 {
+    %c0 = vm.const.i32.zero : i32
+    %c1 = vm.const.i32 1 : i32
+    vm.br ^loop(%c0 : i32)
+  ^loop(%i : i32):
+    %next = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %next, %count : i32
+    vm.cond_br %cmp, ^loop(%next : i32), ^exit(%next : i32)
+  ^exit(%result : i32):
+    vm.return %result : i32
+  }
+}
+
+// -----
+
+vm.module @imports {
+  // CHECK: static const iree_vm_c_import_descriptor_t imports_imports[] = {
+  // CHECK-NEXT: {{[{][{]}}"native.add", 10}, {2, 1}},
+  vm.import @native.add(%a : i32, %b : i32) -> i32
+
+  vm.export @call_import
+  // CHECK: IREE_VM_C_CHECK_OK(iree_vm_c_module_enter_import(stack, state, 0, 2, 0, &callee_frame));
+  // CHECK: IREE_VM_C_REG_I32(callee_regs, 0) = v0;
+  // CHECK: IREE_VM_C_REG_I32(callee_regs, 1) = v0;
+  // CHECK: status = iree_vm_c_module_call_import(stack, callee_frame);
+  // CHECK: iree_vm_stack_function_leave(stack);
+  vm.func @call_import(%arg0 : i32) -> i32 {
+    %0 = vm.call @native.add(%arg0, %arg0) : (i32, i32) -> i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+vm.module @globals {
+  vm.global.i32 @g0 mutable : i32
+
+  vm.export @load_indirect
+  // CHECK: static iree_status_t globals_load_indirect(
+  // CHECK: if ([[OFFSET:v[0-9]+]] < 0 || [[OFFSET]] > (int64_t)state->rwdata_storage.data_length - 4) {
+  // CHECK-NEXT: status = IREE_STATUS_OUT_OF_RANGE;
+  // CHECK: = IREE_VM_C_GLOBAL(state, int32_t, [[OFFSET]]);
+  vm.func @load_indirect() -> i32 {
+    %0 = vm.global.address @g0 : !iree.ptr<i32>
+    %1 = vm.global.load.indirect.i32 %0 : !iree.ptr<i32> -> i32
+    vm.return %1 : i32
+  }
+}
+
+// -----
+
+vm.module @yields {
+  vm.export @yield
+  // Generated functions continue past yields immediately.
+  // CHECK: static iree_status_t yields_yield({{.+}}) {
+  // CHECK-NEXT: iree_status_t status = IREE_STATUS_OK;
+  // CHECK-NEXT: int32_t v0 = 0;
+  // CHECK-NEXT: v0 = arg0;
+  // CHECK-NEXT: *out_result0 = v0;
+  vm.func @yield(%arg0 : i32) -> i32 {
+    vm.yield
+    vm.return %arg0 : i32
+  }
+}
@@ -29,8 +29,8 @@ using ::llvm::format_hex;
 using ::llvm::formatv;
 using ::llvm::Record;
 
-// Finds all serializable ops and emits a enum and template table for their
-// opcode and name.
+// Finds all serializable ops and fused superinstructions and emits a enum and
+// template table for their opcode and name.
 bool emitOpTableDefs(const llvm::RecordKeeper &recordKeeper, raw_ostream &os) {
   llvm::emitSourceFileHeader("IREE VM Operation Tables", os);
 
@@ -50,6 +50,14 @@ bool emitOpTableDefs(const llvm::RecordKeeper &recordKeeper, raw_ostream &os) {
     }
   }
 
+  // Fused superinstructions have no op of their own but are emitted by the
+  // bytecode encoder and must be dispatched by the runtime.
+  for (const auto *opcode :
+       recordKeeper.getAllDerivedDefinitions("VM_FusedOPC")) {
+    opRecords[opcode->getValueAsInt("value")] = opcode;
+    opEncodings[opcode->getValueAsInt("value")] = opcode;
+  }
+
   os << "typedef enum {\n";
   for (int i = 0; i < 256; ++i) {
     auto *def = opRecords[i];
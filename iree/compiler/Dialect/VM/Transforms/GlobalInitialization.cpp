@@ -40,7 +40,7 @@ namespace VM {
 // providing their own initialization functions for those cases.
 //
 // TODO(benvanik): add initializer functions to make dialect init possible.
-// TODO(benvanik): combine i32 initializers to store more efficiently.
+// TODO(benvanik): combine primitive initializers to store more efficiently.
 class GlobalInitializationPass
     : public PassWrapper<GlobalInitializationPass, OperationPass<ModuleOp>> {
  public:
@@ -66,7 +66,20 @@ class GlobalInitializationPass
     // initialization function.
     for (auto &op : getOperation().getBlock().getOperations()) {
       if (auto globalOp = dyn_cast<GlobalI32Op>(op)) {
-        if (failed(appendInitialization(globalOp, initBuilder))) {
+        if (failed(appendPrimitiveInitialization<ConstI32Op, GlobalStoreI32Op>(
+                globalOp, initBuilder))) {
+          globalOp.emitOpError() << "unable to be initialized";
+          return signalPassFailure();
+        }
+      } else if (auto globalOp = dyn_cast<GlobalI64Op>(op)) {
+        if (failed(appendPrimitiveInitialization<ConstI64Op, GlobalStoreI64Op>(
+                globalOp, initBuilder))) {
+          globalOp.emitOpError() << "unable to be initialized";
+          return signalPassFailure();
+        }
+      } else if (auto globalOp = dyn_cast<GlobalF32Op>(op)) {
+        if (failed(appendPrimitiveInitialization<ConstF32Op, GlobalStoreF32Op>(
+                globalOp, initBuilder))) {
           globalOp.emitOpError() << "unable to be initialized";
           return signalPassFailure();
         }
@@ -96,20 +109,24 @@ class GlobalInitializationPass
   }
 
  private:
-  LogicalResult appendInitialization(GlobalI32Op globalOp, OpBuilder &builder) {
+  // Initializes primitive (i32/i64/f32) globals from either their constant
+  // initial value or their initializer function.
+  template <typename ConstOp, typename GlobalStoreOp, typename GlobalOp>
+  LogicalResult appendPrimitiveInitialization(GlobalOp globalOp,
+                                              OpBuilder &builder) {
     if (globalOp.initial_value().hasValue()) {
-      auto constOp = builder.create<ConstI32Op>(globalOp.getLoc(),
-                                                globalOp.initial_valueAttr());
-      builder.create<GlobalStoreI32Op>(globalOp.getLoc(), constOp.getResult(),
-                                       globalOp.sym_name());
+      auto constOp = builder.create<ConstOp>(globalOp.getLoc(),
+                                             globalOp.initial_valueAttr());
+      builder.create<GlobalStoreOp>(globalOp.getLoc(), constOp.getResult(),
+                                    globalOp.sym_name());
       globalOp.clearInitialValue();
       globalOp.makeMutable();
     } else if (globalOp.initializer().hasValue()) {
       auto callOp = builder.create<CallOp>(
           globalOp.getLoc(), globalOp.initializerAttr(),
           ArrayRef<Type>{globalOp.type()}, ArrayRef<Value>{});
-      builder.create<GlobalStoreI32Op>(globalOp.getLoc(), callOp.getResult(0),
-                                       globalOp.sym_name());
+      builder.create<GlobalStoreOp>(globalOp.getLoc(), callOp.getResult(0),
+                                    globalOp.sym_name());
       globalOp.clearInitializer();
       globalOp.makeMutable();
     }
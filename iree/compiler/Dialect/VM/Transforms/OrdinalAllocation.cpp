@@ -15,6 +15,7 @@
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/SymbolTable.h"
@@ -60,9 +61,14 @@ class OrdinalAllocationPass
         ordinal = nextExportOrdinal++;
       } else if (isa<ImportOp>(op)) {
         ordinal = nextImportOrdinal++;
-      } else if (isa<GlobalI32Op>(op)) {
+      } else if (isa<GlobalI32Op>(op) || isa<GlobalF32Op>(op)) {
         ordinal = nextGlobalBytesOrdinal;
         nextGlobalBytesOrdinal += 4;
+      } else if (isa<GlobalI64Op>(op)) {
+        // 64-bit globals are naturally aligned in the global byte storage.
+        nextGlobalBytesOrdinal = llvm::alignTo(nextGlobalBytesOrdinal, 8);
+        ordinal = nextGlobalBytesOrdinal;
+        nextGlobalBytesOrdinal += 8;
       } else if (isa<GlobalRefOp>(op)) {
         ordinal = nextGlobalRefOrdinal++;
       } else if (isa<RodataOp>(op)) {
@@ -104,20 +104,37 @@ struct VMLAConvOpConverter : public OpConversionPattern<xla_hlo::ConvOp> {
       }
     }
 
+    // Quantized operands widened to i32 are instead convolved as i8 with
+    // their zero points and accumulated into the i32 result.
+    Value input = op.lhs();
+    Value filter = op.rhs();
+    IntegerAttr inputZeroPoint;
+    IntegerAttr filterZeroPoint;
+    auto inputQuantized = matchQuantizedOperand(input);
+    auto filterQuantized = matchQuantizedOperand(filter);
+    if (inputQuantized && filterQuantized) {
+      input = inputQuantized->value;
+      filter = filterQuantized->value;
+      inputZeroPoint = rewriter.getI32IntegerAttr(inputQuantized->zeroPoint);
+      filterZeroPoint = rewriter.getI32IntegerAttr(filterQuantized->zeroPoint);
+    }
+
     auto inputShape = VMLAConversionTarget::getTensorShape(
-        op.getLoc(), op.lhs(), typeConverter, rewriter);
+        op.getLoc(), input, typeConverter, rewriter);
     auto filterShape = VMLAConversionTarget::getTensorShape(
-        op.getLoc(), op.rhs(), typeConverter, rewriter);
+        op.getLoc(), filter, typeConverter, rewriter);
     auto dstShape = VMLAConversionTarget::getTensorShape(
         op.getLoc(), op.getResult(), typeConverter, rewriter);
 
     auto dst = VMLAConversionTarget::allocateOutputBuffer(
         op.getLoc(), op.getResult(), typeConverter, rewriter);
 
-    auto lhsType =
-        TypeAttr::get(op.lhs().getType().cast<ShapedType>().getElementType());
-    auto rhsType =
-        TypeAttr::get(op.lhs().getType().cast<ShapedType>().getElementType());
+    auto inputType =
+        TypeAttr::get(input.getType().cast<ShapedType>().getElementType());
+    auto filterType =
+        TypeAttr::get(filter.getType().cast<ShapedType>().getElementType());
+    auto dstType =
+        TypeAttr::get(op.getType().cast<ShapedType>().getElementType());
 
     SmallVector<int32_t, 4> windowStrides{1, 1};
     SmallVector<int32_t, 4> padding{0, 0, 0, 0};
@@ -141,7 +158,7 @@ struct VMLAConvOpConverter : public OpConversionPattern<xla_hlo::ConvOp> {
     fill_optional(op.rhs_dilation(), &rhsDilation);
 
     // Lower only what VMLA runtime supports.
-    if (rhsDilation[0] != 1 || rhsDilation[1] != 1) {
+    if (lhsDilation[0] != 1 || lhsDilation[1] != 1) {
       op.emitWarning() << "De-convoution isn't supported";
       return failure();
     }
@@ -152,13 +169,14 @@ struct VMLAConvOpConverter : public OpConversionPattern<xla_hlo::ConvOp> {
     }
 
     rewriter.create<IREE::VMLA::ConvOp>(
-        op.getLoc(), op.lhs(), inputShape, op.rhs(), filterShape, dst, dstShape,
+        op.getLoc(), input, inputShape, filter, filterShape, dst, dstShape,
         rewriter.getI32VectorAttr(windowStrides),
         rewriter.getI32VectorAttr(padding),
         rewriter.getI32VectorAttr(lhsDilation),
         rewriter.getI32VectorAttr(rhsDilation),
         rewriter.getI32IntegerAttr(featureGroupCount),
-        rewriter.getI32IntegerAttr(batchGroupCount), lhsType, rhsType, rhsType);
+        rewriter.getI32IntegerAttr(batchGroupCount), inputZeroPoint,
+        filterZeroPoint, inputType, filterType, dstType);
 
     rewriter.replaceOp(op, dst);
 
@@ -98,12 +98,25 @@ struct CanonicalizeDotGeneralOp
                                 PatternRewriter &rewriter) const override {
     Value lhs = op.lhs();
     Value rhs = op.rhs();
+    // Quantized operands widened to i32 are instead multiplied as i8 with
+    // their zero points and accumulated into the i32 result.
+    IntegerAttr lhsZeroPoint;
+    IntegerAttr rhsZeroPoint;
+    auto lhsQuantized = matchQuantizedOperand(lhs);
+    auto rhsQuantized = matchQuantizedOperand(rhs);
+    if (lhsQuantized && rhsQuantized) {
+      lhs = lhsQuantized->value;
+      rhs = rhsQuantized->value;
+      lhsZeroPoint = rewriter.getI32IntegerAttr(lhsQuantized->zeroPoint);
+      rhsZeroPoint = rewriter.getI32IntegerAttr(rhsQuantized->zeroPoint);
+    }
     RankedTensorType lhsType = lhs.getType().dyn_cast<RankedTensorType>();
     RankedTensorType rhsType = rhs.getType().dyn_cast<RankedTensorType>();
-    Type elementType = lhsType.getElementType();
     if (!lhsType || !rhsType) {
       return failure();
     }
+    Type elementType = lhsType.getElementType();
+    Type dstElementType = op.getType().cast<ShapedType>().getElementType();
     // TODO(silvasean): Extend to support dynamic shapes.
     // This op is a really good case for testing our e2e dynamic shape support.
     // There's interesting questions at the TF2XLA level too.
@@ -200,17 +213,17 @@ struct CanonicalizeDotGeneralOp
     auto dstShape = llvm::to_vector<6>(llvm::makeArrayRef(
         {totalElements(batchingDimExtents), totalElements(rhsFreeDimExtents),
          totalElements(lhsFreeDimExtents)}));
-    auto dstType = RankedTensorType::get(dstShape, elementType);
+    auto dstType = RankedTensorType::get(dstShape, dstElementType);
     Value dst = rewriter.create<IREE::VMLA::BatchMatMulPseudoOp>(
-        op.getLoc(), dstType, lhs, rhs);
+        op.getLoc(), dstType, lhs, rhs, lhsZeroPoint, rhsZeroPoint);
     RankedTensorType transposeType = RankedTensorType::get(
-        {dstShape[0], dstShape[2], dstShape[1]}, elementType);
+        {dstShape[0], dstShape[2], dstShape[1]}, dstElementType);
     auto transpose = rewriter.create<xla_hlo::TransposeOp>(
         op.getLoc(), transposeType, dst, make1DElementsAttr({0, 2, 1}));
     auto reshapeShape = batchingDimExtents;
     reshapeShape.append(lhsFreeDimExtents.begin(), lhsFreeDimExtents.end());
     reshapeShape.append(rhsFreeDimExtents.begin(), rhsFreeDimExtents.end());
-    auto reshapeType = RankedTensorType::get(reshapeShape, elementType);
+    auto reshapeType = RankedTensorType::get(reshapeShape, dstElementType);
     rewriter.replaceOpWithNewOp<xla_hlo::ReshapeOp>(op, reshapeType, transpose);
     return success();
   }
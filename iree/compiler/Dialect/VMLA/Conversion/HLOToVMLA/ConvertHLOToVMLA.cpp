@@ -14,6 +14,8 @@
 
 #include "iree/compiler/Dialect/VMLA/Conversion/HLOToVMLA/ConvertHLOToVMLA.h"
 
+#include <limits>
+
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/Shape/IR/Builders.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
@@ -48,6 +50,31 @@ void populateHLOReductionToVMLAPatterns(MLIRContext *context,
                                         OwningRewritePatternList &patterns,
                                         TypeConverter &typeConverter);
 
+Optional<QuantizedOperand> matchQuantizedOperand(Value value) {
+  int64_t zeroPoint = 0;
+  if (auto subOp = dyn_cast_or_null<xla_hlo::SubOp>(value.getDefiningOp())) {
+    SplatElementsAttr zeroPointAttr;
+    if (!matchPattern(subOp.rhs(), m_Constant(&zeroPointAttr))) {
+      return llvm::None;
+    }
+    auto zeroPointValue = zeroPointAttr.getSplatValue().dyn_cast<IntegerAttr>();
+    if (!zeroPointValue) return llvm::None;
+    zeroPoint = zeroPointValue.getInt();
+    value = subOp.lhs();
+  }
+  auto convertOp = dyn_cast_or_null<xla_hlo::ConvertOp>(value.getDefiningOp());
+  if (!convertOp) return llvm::None;
+  auto srcType = convertOp.operand().getType().cast<ShapedType>();
+  auto dstType = convertOp.getType().cast<ShapedType>();
+  if (!srcType.getElementType().isSignlessInteger(8) ||
+      !dstType.getElementType().isSignlessInteger(32) ||
+      zeroPoint < std::numeric_limits<int8_t>::min() ||
+      zeroPoint > std::numeric_limits<int8_t>::max()) {
+    return llvm::None;
+  }
+  return QuantizedOperand{convertOp.operand(), static_cast<int32_t>(zeroPoint)};
+}
+
 namespace {
 
 // Clones operand[0] and returns the result.
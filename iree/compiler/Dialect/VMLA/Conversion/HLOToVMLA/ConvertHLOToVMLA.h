@@ -15,12 +15,26 @@
 #ifndef IREE_COMPILER_DIALECT_VMLA_CONVERSION_HLOTOVMLA_CONVERTHLOTOVMLA_H_
 #define IREE_COMPILER_DIALECT_VMLA_CONVERSION_HLOTOVMLA_CONVERTHLOTOVMLA_H_
 
+#include "llvm/ADT/Optional.h"
+#include "mlir/IR/Value.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 
 namespace mlir {
 namespace iree_compiler {
 
+// An i8 value that has been widened to i32 for accumulation along with the
+// zero point that was subtracted from it.
+struct QuantizedOperand {
+  Value value;
+  int32_t zeroPoint;
+};
+
+// Matches `xla_hlo.convert` of an i8 |value| to i32, optionally followed by an
+// `xla_hlo.subtract` of a splat constant zero point. Quantized matmuls and
+// convolutions use this to multiply the i8 values directly.
+Optional<QuantizedOperand> matchQuantizedOperand(Value value);
+
 // Populates conversion patterns from the XLA HLO dialect to the VMLA dialect.
 void populateHLOToVMLAPatterns(MLIRContext *context,
                                OwningRewritePatternList &patterns,
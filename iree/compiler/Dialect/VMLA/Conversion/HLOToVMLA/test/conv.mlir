@@ -23,3 +23,61 @@ func @conv(%arg0: tensor<1x4x5x2xf32>, %arg1: tensor<3x2x2x1xf32>) -> tensor<1x2
         window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xf32>, tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32>
  return %2: tensor<1x2x3x1xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @dilated_conv
+func @dilated_conv(%arg0: tensor<1x4x5x2xf32>, %arg1: tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.conv
+  // CHECK-SAME: rhs_dilation = dense<2> : vector<2xi32>
+  %2 = "xla_hlo.convolution"(%arg0, %arg1) {
+        batch_group_count = 1 : i64,
+        dimension_numbers = {
+          input_batch_dimension = 0 : i64,
+          input_feature_dimension = 3 : i64,
+          input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+          kernel_input_feature_dimension = 2 : i64,
+          kernel_output_feature_dimension = 3 : i64,
+          kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+          output_batch_dimension = 0 : i64,
+          output_feature_dimension = 3 : i64,
+          output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>},
+        feature_group_count = 1 : i64,
+        rhs_dilation = dense<2> : tensor<2xi64>,
+        lhs_dilation = dense<1> : tensor<2xi64>,
+        padding = dense<[[1, 1],[0, 0]]> : tensor<2x2xi64>,
+        window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xf32>, tensor<3x2x2x1xf32>) -> tensor<1x2x3x1xf32>
+ return %2: tensor<1x2x3x1xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @quantized_conv
+func @quantized_conv(%arg0: tensor<1x4x5x2xi8>, %arg1: tensor<3x2x2x1xi8>) -> tensor<1x2x3x1xi32> attributes { sym_visibility = "private" } {
+  // CHECK: vmla.conv
+  // CHECK-SAME: dst_type = i32
+  // CHECK-SAME: filter_type = i8, filter_zero_point = 0 : i32
+  // CHECK-SAME: input_type = i8, input_zero_point = -5 : i32
+  %input = "xla_hlo.convert"(%arg0) : (tensor<1x4x5x2xi8>) -> tensor<1x4x5x2xi32>
+  %input_zero_point = xla_hlo.constant dense<-5> : tensor<1x4x5x2xi32>
+  %input_offset = "xla_hlo.subtract"(%input, %input_zero_point) : (tensor<1x4x5x2xi32>, tensor<1x4x5x2xi32>) -> tensor<1x4x5x2xi32>
+  %filter = "xla_hlo.convert"(%arg1) : (tensor<3x2x2x1xi8>) -> tensor<3x2x2x1xi32>
+  %2 = "xla_hlo.convolution"(%input_offset, %filter) {
+        batch_group_count = 1 : i64,
+        dimension_numbers = {
+          input_batch_dimension = 0 : i64,
+          input_feature_dimension = 3 : i64,
+          input_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>,
+          kernel_input_feature_dimension = 2 : i64,
+          kernel_output_feature_dimension = 3 : i64,
+          kernel_spatial_dimensions = dense<[0, 1]> : tensor<2xi64>,
+          output_batch_dimension = 0 : i64,
+          output_feature_dimension = 3 : i64,
+          output_spatial_dimensions = dense<[1, 2]> : tensor<2xi64>},
+        feature_group_count = 1 : i64,
+        rhs_dilation = dense<1> : tensor<2xi64>,
+        lhs_dilation = dense<1> : tensor<2xi64>,
+        padding = dense<[[1, 2],[2, 2]]> : tensor<2x2xi64>,
+        window_strides = dense<1> : tensor<2xi64>} : (tensor<1x4x5x2xi32>, tensor<3x2x2x1xi32>) -> tensor<1x2x3x1xi32>
+ return %2: tensor<1x2x3x1xi32>
+}
@@ -12,3 +12,27 @@ func @f(%arg0: tensor<3x4xf32>, %arg1: tensor<4x5xf32>) -> tensor<3x5xf32> attri
   }} : (tensor<3x4xf32>, tensor<4x5xf32>) -> tensor<3x5xf32>
   return %0 : tensor<3x5xf32>
 }
+
+// -----
+
+// CHECK-LABEL: @quantized
+func @quantized(%arg0: tensor<3x4xi8>, %arg1: tensor<4x5xi8>) -> tensor<3x5xi32> attributes {sym_visibility = "private"} {
+  // CHECK: vmla.batch.matmul
+  // CHECK-SAME: lhs_type = tensor<1x3x4xi8>
+  // CHECK-SAME: lhs_zero_point = 3 : i32
+  // CHECK-SAME: rhs_type = tensor<1x5x4xi8>
+  // CHECK-SAME: rhs_zero_point = -2 : i32
+  %lhs = "xla_hlo.convert"(%arg0) : (tensor<3x4xi8>) -> tensor<3x4xi32>
+  %lhs_zero_point = xla_hlo.constant dense<3> : tensor<3x4xi32>
+  %lhs_offset = "xla_hlo.subtract"(%lhs, %lhs_zero_point) : (tensor<3x4xi32>, tensor<3x4xi32>) -> tensor<3x4xi32>
+  %rhs = "xla_hlo.convert"(%arg1) : (tensor<4x5xi8>) -> tensor<4x5xi32>
+  %rhs_zero_point = xla_hlo.constant dense<-2> : tensor<4x5xi32>
+  %rhs_offset = "xla_hlo.subtract"(%rhs, %rhs_zero_point) : (tensor<4x5xi32>, tensor<4x5xi32>) -> tensor<4x5xi32>
+  %0 = "xla_hlo.dot_general"(%lhs_offset, %rhs_offset) {dot_dimension_numbers = {
+    lhs_batching_dimensions = dense<[]> : tensor<0xi64>,
+    lhs_contracting_dimensions = dense<[1]> : tensor<1xi64>,
+    rhs_batching_dimensions = dense<[]> : tensor<0xi64>,
+    rhs_contracting_dimensions = dense<[0]> : tensor<1xi64>
+  }} : (tensor<3x4xi32>, tensor<4x5xi32>) -> tensor<3x5xi32>
+  return %0 : tensor<3x5xi32>
+}
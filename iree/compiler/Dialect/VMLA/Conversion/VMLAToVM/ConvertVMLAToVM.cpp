@@ -115,7 +115,10 @@ class VMLAImportOpConversion : public OpConversionPattern<T> {
     }
 
     std::string typePrefix = "x";
-    if (elementType.isa<FloatType>()) {
+    if (elementType.isBF16()) {
+      // bf16 shares its bit width with f16 and needs its own imports.
+      return "bf16";
+    } else if (elementType.isa<FloatType>()) {
       typePrefix = "f";
     } else if (elementType.isSignlessInteger()) {
       typePrefix = forceUnsigned ? "u" : "i";
@@ -229,28 +232,29 @@ class VMLAConvertImportOpConversion
   }
 };
 
-class VMLABatchMatMulImportOpConversion
-    : public VMLAImportOpConversion<IREE::VMLA::BatchMatMulOp> {
+// Batch matmuls (including requantizing ones) suffixed by their operand and
+// result types, such as '.i8i8.i32'.
+template <typename T>
+class VMLABatchMatMulImportOpConversion : public VMLAImportOpConversion<T> {
  public:
-  using VMLAImportOpConversion<
-      IREE::VMLA::BatchMatMulOp>::VMLAImportOpConversion;
+  using VMLAImportOpConversion<T>::VMLAImportOpConversion;
 
-  std::string getImportSuffix(IREE::VMLA::BatchMatMulOp op) const override {
-    return std::string(".") + getTypedTypeStr(op.lhs_type()) +
-           getTypedTypeStr(op.rhs_type()) + std::string(".") +
-           getTypedTypeStr(op.dst_type());
+  std::string getImportSuffix(T op) const override {
+    return std::string(".") + this->getTypedTypeStr(op.lhs_type()) +
+           this->getTypedTypeStr(op.rhs_type()) + std::string(".") +
+           this->getTypedTypeStr(op.dst_type());
   }
 };
 
-class VMLAConvImportOpConversion
-    : public VMLAImportOpConversion<IREE::VMLA::ConvOp> {
+template <typename T>
+class VMLAConvImportOpConversion : public VMLAImportOpConversion<T> {
  public:
-  using VMLAImportOpConversion<IREE::VMLA::ConvOp>::VMLAImportOpConversion;
+  using VMLAImportOpConversion<T>::VMLAImportOpConversion;
 
-  std::string getImportSuffix(IREE::VMLA::ConvOp op) const override {
-    return std::string(".") + getTypedTypeStr(op.input_type()) +
-           getTypedTypeStr(op.filter_type()) + std::string(".") +
-           getTypedTypeStr(op.dst_type());
+  std::string getImportSuffix(T op) const override {
+    return std::string(".") + this->getTypedTypeStr(op.input_type()) +
+           this->getTypedTypeStr(op.filter_type()) + std::string(".") +
+           this->getTypedTypeStr(op.dst_type());
   }
 };
 }  // namespace
@@ -315,10 +319,15 @@ void populateVMLAToVMPatterns(MLIRContext *context, SymbolTable &importSymbols,
 
   patterns.insert<VMLAConvertImportOpConversion>(context, importSymbols,
                                                  typeConverter, "vmla.convert");
-  patterns.insert<VMLABatchMatMulImportOpConversion>(
+  patterns.insert<VMLABatchMatMulImportOpConversion<IREE::VMLA::BatchMatMulOp>>(
       context, importSymbols, typeConverter, "vmla.batch.matmul");
-  patterns.insert<VMLAConvImportOpConversion>(context, importSymbols,
-                                              typeConverter, "vmla.conv");
+  patterns.insert<
+      VMLABatchMatMulImportOpConversion<IREE::VMLA::BatchMatMulRequantOp>>(
+      context, importSymbols, typeConverter, "vmla.batch.matmul.requant");
+  patterns.insert<VMLAConvImportOpConversion<IREE::VMLA::ConvOp>>(
+      context, importSymbols, typeConverter, "vmla.conv");
+  patterns.insert<VMLAConvImportOpConversion<IREE::VMLA::ConvRequantOp>>(
+      context, importSymbols, typeConverter, "vmla.conv.requant");
 
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceSumOp, "vmla.reduce.sum");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceMinOp, "vmla.reduce.min");
@@ -330,6 +339,10 @@ void populateVMLAToVMPatterns(MLIRContext *context, SymbolTable &importSymbols,
 
   VMLA_IMPORT_OP(IREE::VMLA::InterfaceConstOp, "vmla.interface.const");
   VMLA_IMPORT_OP(IREE::VMLA::InterfaceBindingOp, "vmla.interface.binding");
+  VMLA_IMPORT_OP(IREE::VMLA::InterfaceWorkgroupIDOp,
+                 "vmla.interface.workgroup_id");
+  VMLA_IMPORT_OP(IREE::VMLA::InterfaceWorkgroupCountOp,
+                 "vmla.interface.workgroup_count");
 }
 
 namespace {
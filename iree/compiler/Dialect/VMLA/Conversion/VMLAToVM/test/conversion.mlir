@@ -65,6 +65,28 @@ func @convert(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
 
 // -----
 
+// CHECK-LABEL: vm.func @convertHalf
+func @convertHalf(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: vm.call @vmla.convert.f16.f32(%arg0, %arg1)
+  "vmla.convert"(%arg0, %arg1) { src_type = f16, dst_type = f32 } : (!vmla.buffer, !vmla.buffer) -> ()
+  // CHECK-NEXT: vm.call @vmla.convert.f32.bf16(%arg1, %arg0)
+  "vmla.convert"(%arg1, %arg0) { src_type = f32, dst_type = bf16 } : (!vmla.buffer, !vmla.buffer) -> ()
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @typedImportHalf
+func @typedImportHalf(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  // CHECK-NEXT: vm.call @vmla.add.f16(%arg0, %arg0, %arg1)
+  vmla.add(%arg0, %arg0, %arg1) : f16
+  // CHECK-NEXT: vm.call @vmla.tanh.bf16(%arg0, %arg1)
+  vmla.tanh(%arg0, %arg1) : bf16
+  return
+}
+
+// -----
+
 // CHECK-LABEL: vm.func @batch_matmul
 func @batch_matmul(
     %lhs : !vmla.buffer,
@@ -86,3 +108,88 @@ func @batch_matmul(
        !shapex.ranked_shape<[3,4,4]>) -> ()
   return
 }
+
+// -----
+
+// CHECK-LABEL: vm.func @batch_matmul_bf16
+func @batch_matmul_bf16(
+    %lhs : !vmla.buffer,
+    %rhs : !vmla.buffer,
+    %dst : !vmla.buffer) {
+  %lhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[3,4,8]>
+  %rhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[3,2,8]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[3,2,4]>
+  // CHECK: vm.call.variadic @vmla.batch.matmul.bf16bf16.bf16(%arg0, [%c3, %c4, %c8], %arg1, [%c3, %c2, %c8], %arg2, [%c3, %c2, %c4])
+  "vmla.batch.matmul"(%lhs, %lhs_shape, %rhs, %rhs_shape, %dst, %dst_shape)
+      { lhs_type = bf16, rhs_type = bf16, dst_type = bf16 } :
+      (!vmla.buffer,
+       !shapex.ranked_shape<[3,4,8]>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[3,2,8]>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[3,2,4]>) -> ()
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @batch_matmul_i8
+func @batch_matmul_i8(
+    %lhs : !vmla.buffer,
+    %rhs : !vmla.buffer,
+    %dst : !vmla.buffer) {
+  %lhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,2]>
+  %rhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,2]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,4]>
+  // CHECK: vm.call.variadic @vmla.batch.matmul.i8i8.i32(%arg0, [%c1, %c4, %c2], %c5, %arg1, [%c1, %c4, %c2], %c6, %arg2, [%c1, %c4, %c4])
+  "vmla.batch.matmul"(%lhs, %lhs_shape, %rhs, %rhs_shape, %dst, %dst_shape)
+      { lhs_type = i8, rhs_type = i8, dst_type = i32,
+        lhs_zero_point = 5 : i32, rhs_zero_point = 6 : i32 } :
+      (!vmla.buffer,
+       !shapex.ranked_shape<[1,4,2]>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[1,4,2]>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[1,4,4]>) -> ()
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @batch_matmul_requant
+func @batch_matmul_requant(
+    %lhs : !vmla.buffer,
+    %rhs : !vmla.buffer,
+    %mantissa : !vmla.buffer,
+    %exponent : !vmla.buffer,
+    %dst : !vmla.buffer) {
+  %lhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,2]>
+  %rhs_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,2]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[1,4,4]>
+  // CHECK: vm.call.variadic @vmla.batch.matmul.requant.i8i8.i8(%arg0, [%c1, %c4, %c2], %c5, %arg1, [%c1, %c4, %c2], %c6, %arg2, %arg3, %arg4, [%c1, %c4, %c4], %c7)
+  "vmla.batch.matmul.requant"(%lhs, %lhs_shape, %rhs, %rhs_shape, %mantissa,
+                              %exponent, %dst, %dst_shape)
+      { lhs_type = i8, rhs_type = i8, dst_type = i8, lhs_zero_point = 5 : i32,
+        rhs_zero_point = 6 : i32, dst_zero_point = 7 : i32 } :
+      (!vmla.buffer,
+       !shapex.ranked_shape<[1,4,2]>,
+       !vmla.buffer,
+       !shapex.ranked_shape<[1,4,2]>,
+       !vmla.buffer,
+       !vmla.buffer,
+       !vmla.buffer,
+       !shapex.ranked_shape<[1,4,4]>) -> ()
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @workgroupQuery
+func @workgroupQuery(%interface : !vmla.interface) -> (index, index) {
+  // CHECK-DAG: %c1 = vm.const.i32 1 : i32
+  // CHECK-DAG: = vm.call @vmla.interface.workgroup_id(%arg0, %c1) : (!vm.ref<!vmla.interface>, i32) -> i32
+  %0 = "vmla.interface.workgroup_id"(%interface) { dimension = 1 : i32 } : (!vmla.interface) -> index
+  // CHECK-DAG: = vm.call @vmla.interface.workgroup_count(%arg0, %c1) : (!vm.ref<!vmla.interface>, i32) -> i32
+  %1 = "vmla.interface.workgroup_count"(%interface) { dimension = 1 : i32 } : (!vmla.interface) -> index
+  return %0, %1 : index, index
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeDialect.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
 #include "iree/compiler/Dialect/Shape/Transforms/Patterns.h"
@@ -21,12 +22,15 @@
 #include "iree/compiler/Dialect/VMLA/Conversion/HLOToVMLA/ConvertHLOToVMLA.h"
 #include "iree/compiler/Dialect/VMLA/Conversion/StandardToVMLA/ConvertStandardToVMLA.h"
 #include "iree/compiler/Dialect/VMLA/Conversion/TypeConverter.h"
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
 #include "iree/compiler/Dialect/VMLA/IR/VMLATypes.h"
 #include "iree/compiler/Dialect/VMLA/Transforms/Passes.h"
 #include "llvm/ADT/STLExtras.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Builders.h"
 #include "mlir/IR/Module.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/StandardTypes.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassRegistry.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -56,6 +60,170 @@ static LogicalResult insertInterfacesToEntryPoints(mlir::ModuleOp moduleOp) {
   return success();
 }
 
+// Module attribute mapping the name of each partitioned entry point to the
+// number of workgroups it was partitioned into.
+static const char *kWorkgroupCountsAttr = "vmla.workgroup_counts";
+
+// Upper bound on the number of workgroups a dispatch is partitioned into.
+// Workgroups are spread across the worker threads of the device and there is
+// little to gain from producing many more workgroups than workers.
+static const int64_t kMaxWorkgroupCount = 64;
+
+// Minimum number of elements each workgroup processes. Below this the cost of
+// invoking the entry point for each workgroup dominates.
+static const int64_t kMinWorkgroupElementCount = 16 * 1024;
+
+// Returns true if each element of the results of |op| is computed only from
+// the operand elements at the same index.
+static bool isElementwiseOp(Operation *op) {
+  return isa<xla_hlo::AddOp>(op) || isa<xla_hlo::SubOp>(op) ||
+         isa<xla_hlo::DivOp>(op) || isa<xla_hlo::MulOp>(op) ||
+         isa<xla_hlo::PowOp>(op) || isa<xla_hlo::RemOp>(op) ||
+         isa<xla_hlo::ShiftLeftOp>(op) ||
+         isa<xla_hlo::ShiftRightArithmeticOp>(op) ||
+         isa<xla_hlo::ShiftRightLogicalOp>(op) || isa<xla_hlo::AndOp>(op) ||
+         isa<xla_hlo::OrOp>(op) || isa<xla_hlo::XorOp>(op) ||
+         isa<xla_hlo::ExpOp>(op) || isa<xla_hlo::LogOp>(op) ||
+         isa<xla_hlo::FloorOp>(op) || isa<xla_hlo::RsqrtOp>(op) ||
+         isa<xla_hlo::SqrtOp>(op) || isa<xla_hlo::CosOp>(op) ||
+         isa<xla_hlo::SinOp>(op) || isa<xla_hlo::TanhOp>(op) ||
+         isa<xla_hlo::Atan2Op>(op) || isa<xla_hlo::SelectOp>(op) ||
+         isa<xla_hlo::ConvertOp>(op) || isa<xla_hlo::AbsOp>(op) ||
+         isa<xla_hlo::NegOp>(op) || isa<xla_hlo::MaxOp>(op) ||
+         isa<xla_hlo::MinOp>(op) || isa<xla_hlo::ClampOp>(op);
+}
+
+// Returns the number of workgroups |funcOp| can be partitioned into along the
+// outermost dimension of its tensors or 1 if it must run as a single
+// workgroup. Only entry points that load tensors, compute on them elementwise,
+// and store the results with all tensors sharing one static shape are
+// partitioned; each workgroup can then process the same contiguous slice of
+// every binding independently of the others.
+static int64_t calculateWorkgroupCount(FuncOp funcOp) {
+  if (funcOp.getBlocks().size() != 1) return 1;
+
+  ArrayRef<int64_t> shape;
+  auto isPartitionableType = [&](Type type) {
+    auto tensorType = type.dyn_cast<RankedTensorType>();
+    if (!tensorType || !tensorType.hasStaticShape() ||
+        tensorType.getRank() == 0) {
+      return false;
+    }
+    if (shape.empty()) shape = tensorType.getShape();
+    return tensorType.getShape() == shape;
+  };
+
+  bool hasStore = false;
+  for (auto &op : funcOp.front()) {
+    if (auto loadOp = dyn_cast<IREE::HAL::InterfaceLoadTensorOp>(op)) {
+      if (!isPartitionableType(loadOp.result().getType())) return 1;
+    } else if (auto storeOp = dyn_cast<IREE::HAL::InterfaceStoreTensorOp>(op)) {
+      if (!isPartitionableType(storeOp.operand().getType())) return 1;
+      hasStore = true;
+    } else if (isElementwiseOp(&op)) {
+      for (auto type : op.getOperandTypes()) {
+        if (!isPartitionableType(type)) return 1;
+      }
+      for (auto type : op.getResultTypes()) {
+        if (!isPartitionableType(type)) return 1;
+      }
+    } else if (auto constantOp = dyn_cast<mlir::ConstantOp>(op)) {
+      // Only offsets may be constant; constant tensors are not sliced.
+      if (!constantOp.getType().isIndex()) return 1;
+    } else if (!isa<mlir::ReturnOp>(op)) {
+      return 1;
+    }
+  }
+  if (!hasStore) return 1;
+
+  int64_t elementsPerRow = 1;
+  for (auto dim : shape.drop_front()) elementsPerRow *= dim;
+  for (int64_t workgroupCount = std::min(shape.front(), kMaxWorkgroupCount);
+       workgroupCount > 1; --workgroupCount) {
+    if (shape.front() % workgroupCount == 0 &&
+        (shape.front() / workgroupCount) * elementsPerRow >=
+            kMinWorkgroupElementCount) {
+      return workgroupCount;
+    }
+  }
+  return 1;
+}
+
+// Rewrites |funcOp| such that each workgroup loads, computes, and stores only
+// the slice of its tensors selected by the workgroup ID along x.
+static void partitionEntryPoint(FuncOp funcOp, int64_t workgroupCount) {
+  auto &block = funcOp.front();
+  auto builder = OpBuilder::atBlockBegin(&block);
+  auto workgroupIdValue = builder.create<IREE::VMLA::InterfaceWorkgroupIDOp>(
+      funcOp.getLoc(), builder.getIndexType(), funcOp.getArgument(0),
+      builder.getI32IntegerAttr(0));
+
+  // Offsets the slice selected by the workgroup from the binding offset.
+  auto getSliceOffset = [&](Operation *op, Value offset,
+                            RankedTensorType sliceType) {
+    builder.setInsertionPoint(op);
+    auto sliceByteLength = builder.createOrFold<mlir::ConstantIndexOp>(
+        op->getLoc(), sliceType.getNumElements() *
+                          VMLATypeConverter::getRoundedElementByteWidth(
+                              sliceType.getElementType()));
+    return builder.createOrFold<mlir::AddIOp>(
+        op->getLoc(), offset,
+        builder.createOrFold<mlir::MulIOp>(op->getLoc(), workgroupIdValue,
+                                           sliceByteLength));
+  };
+
+  for (auto &op : llvm::make_early_inc_range(block)) {
+    for (auto result : op.getResults()) {
+      auto tensorType = result.getType().dyn_cast<RankedTensorType>();
+      if (!tensorType) continue;
+      SmallVector<int64_t, 4> sliceShape(tensorType.getShape().begin(),
+                                         tensorType.getShape().end());
+      sliceShape.front() /= workgroupCount;
+      result.setType(
+          RankedTensorType::get(sliceShape, tensorType.getElementType()));
+    }
+    if (auto loadOp = dyn_cast<IREE::HAL::InterfaceLoadTensorOp>(op)) {
+      auto sliceType = loadOp.result().getType().cast<RankedTensorType>();
+      op.setOperand(0, getSliceOffset(&op, loadOp.offset(), sliceType));
+    } else if (auto storeOp = dyn_cast<IREE::HAL::InterfaceStoreTensorOp>(op)) {
+      auto sliceType = storeOp.operand().getType().cast<RankedTensorType>();
+      op.setOperand(1, getSliceOffset(&op, storeOp.offset(), sliceType));
+    }
+  }
+}
+
+// Partitions all exported functions that can run as multiple workgroups and
+// records their workgroup counts on |moduleOp|.
+static void partitionEntryPoints(mlir::ModuleOp moduleOp) {
+  Builder builder(moduleOp.getContext());
+  SmallVector<NamedAttribute, 4> workgroupCounts;
+  for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+    if (SymbolTable::getSymbolVisibility(funcOp) !=
+        SymbolTable::Visibility::Public) {
+      continue;
+    }
+    int64_t workgroupCount = calculateWorkgroupCount(funcOp);
+    if (workgroupCount <= 1) continue;
+    partitionEntryPoint(funcOp, workgroupCount);
+    workgroupCounts.push_back(builder.getNamedAttr(
+        funcOp.getName(), builder.getI64IntegerAttr(workgroupCount)));
+  }
+  if (!workgroupCounts.empty()) {
+    moduleOp.setAttr(kWorkgroupCountsAttr,
+                     builder.getDictionaryAttr(workgroupCounts));
+  }
+}
+
+int64_t getEntryPointWorkgroupCount(mlir::ModuleOp moduleOp,
+                                    StringRef entryPointName) {
+  auto workgroupCounts =
+      moduleOp.getAttrOfType<DictionaryAttr>(kWorkgroupCountsAttr);
+  if (!workgroupCounts) return 1;
+  auto workgroupCount =
+      workgroupCounts.get(entryPointName).dyn_cast_or_null<IntegerAttr>();
+  return workgroupCount ? workgroupCount.getInt() : 1;
+}
+
 // Runs conversion with registered input dialects.
 class ConversionPass
     : public PassWrapper<ConversionPass, OperationPass<mlir::ModuleOp>> {
@@ -68,6 +236,10 @@ class ConversionPass
       return signalPassFailure();
     }
 
+    // Split elementwise entry points into multiple workgroups so that the
+    // runtime can execute them in parallel.
+    partitionEntryPoints(getOperation());
+
     auto *context = &getContext();
     VMLATypeConverter typeConverter;
     VMLAConversionTarget conversionTarget(context, typeConverter);
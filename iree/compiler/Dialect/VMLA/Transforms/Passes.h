@@ -44,6 +44,13 @@ namespace VMLA {
 //   <serialize VM module>
 void buildVMLATransformPassPipeline(OpPassManager &passManager);
 
+// Returns the number of workgroups the entry point |entryPointName| must be
+// dispatched with after |moduleOp| has been converted to the VMLA dialect.
+// Entry points that were not partitioned process their entire workload in a
+// single workgroup.
+int64_t getEntryPointWorkgroupCount(mlir::ModuleOp moduleOp,
+                                    StringRef entryPointName);
+
 //===----------------------------------------------------------------------===//
 // Input canonicalization and legalization
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,64 @@
+// RUN: iree-opt -split-input-file -iree-vmla-conversion -canonicalize %s | IreeFileCheck %s
+
+// CHECK-LABEL: module attributes {vmla.workgroup_counts = {elementwise = 4 : i64}}
+// CHECK-LABEL: func @elementwise
+// CHECK-SAME: ([[INTERFACE:%.+]]: !vmla.interface)
+func @elementwise() {
+  // CHECK-DAG: [[C0:%.+]] = constant 0 : index
+  // CHECK-DAG: [[SLICE_LENGTH:%.+]] = constant 65536 : index
+  // CHECK-DAG: [[WORKGROUP_ID:%.+]] = "vmla.interface.workgroup_id"([[INTERFACE]]) {dimension = 0 : i32} : (!vmla.interface) -> index
+  // CHECK-DAG: [[SLICE_OFFSET:%.+]] = muli [[WORKGROUP_ID]], [[SLICE_LENGTH]]
+  %c0 = constant 0 : index
+  // CHECK: [[ARG0_BINDING:%.+]] = "vmla.interface.binding"([[INTERFACE]]) {binding = 0 : i32, set = 0 : i32}
+  // CHECK-NEXT: [[ARG0:%.+]] = "vmla.buffer.view"([[ARG0_BINDING]], [[SLICE_OFFSET]], [[SLICE_LENGTH]])
+  %0 = hal.interface.load.tensor @legacy_io::@arg0, offset = %c0 : tensor<64x1024xf32>
+  // CHECK-NEXT: [[TEMP:%.+]] = "vmla.buffer.alloc"([[SLICE_LENGTH]])
+  // CHECK-NEXT: vmla.add([[ARG0]], [[ARG0]], [[TEMP]]) : f32
+  %1 = xla_hlo.add %0, %0 : tensor<64x1024xf32>
+  // CHECK-NEXT: [[RET0_BINDING:%.+]] = "vmla.interface.binding"([[INTERFACE]]) {binding = 1 : i32, set = 0 : i32}
+  // CHECK-NEXT: "vmla.buffer.copy"([[TEMP]], [[C0]], [[RET0_BINDING]], [[SLICE_OFFSET]], [[SLICE_LENGTH]])
+  hal.interface.store.tensor %1, @legacy_io::@ret0, offset = %c0 : tensor<64x1024xf32>
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
+
+// -----
+
+// Small workloads run as a single workgroup.
+
+// CHECK-LABEL: module {
+// CHECK-LABEL: func @small_elementwise
+// CHECK-NOT: vmla.interface.workgroup_id
+func @small_elementwise() {
+  %c0 = constant 0 : index
+  %0 = hal.interface.load.tensor @legacy_io::@arg0, offset = %c0 : tensor<4xf32>
+  %1 = xla_hlo.add %0, %0 : tensor<4xf32>
+  hal.interface.store.tensor %1, @legacy_io::@ret0, offset = %c0 : tensor<4xf32>
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
+
+// -----
+
+// Workloads that read across rows run as a single workgroup.
+
+// CHECK-LABEL: module {
+// CHECK-LABEL: func @dot
+// CHECK-NOT: vmla.interface.workgroup_id
+func @dot() {
+  %c0 = constant 0 : index
+  %0 = hal.interface.load.tensor @legacy_io::@arg0, offset = %c0 : tensor<512x512xf32>
+  %1 = "xla_hlo.dot"(%0, %0) : (tensor<512x512xf32>, tensor<512x512xf32>) -> tensor<512x512xf32>
+  hal.interface.store.tensor %1, @legacy_io::@ret0, offset = %c0 : tensor<512x512xf32>
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
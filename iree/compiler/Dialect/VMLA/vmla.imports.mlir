@@ -37,6 +37,18 @@ vm.import @interface.binding(
 ) -> !vm.ref<!vmla.buffer>
 attributes {nosideeffects}
 
+vm.import @interface.workgroup_id(
+  %interface : !vm.ref<!vmla.interface>,
+  %dimension : i32
+) -> i32
+attributes {nosideeffects}
+
+vm.import @interface.workgroup_count(
+  %interface : !vm.ref<!vmla.interface>,
+  %dimension : i32
+) -> i32
+attributes {nosideeffects}
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: buffer manipulation
 //===----------------------------------------------------------------------===//
@@ -235,22 +247,32 @@ vm.import @add.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %d
 vm.import @add.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @add.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @add.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @add.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @add.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sub.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sub.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sub.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @abs.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @abs.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @abs.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @neg.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @neg.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @neg.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @mul.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @mul.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @mul.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
@@ -258,6 +280,8 @@ vm.import @div.u8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %d
 vm.import @div.u16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.u32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @div.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @div.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @div.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rem.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
@@ -267,28 +291,46 @@ vm.import @rem.u32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %
 vm.import @rem.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @pow.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @exp.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @exp.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @exp.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @log.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @log.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @log.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @rsqrt.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rsqrt.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @rsqrt.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sqrt.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sqrt.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @sqrt.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @cos.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @sin.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @tanh.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @tanh.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @tanh.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @atan2.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 vm.import @min.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @min.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @min.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @min.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i8(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.i32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @max.f32(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @max.f16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @max.bf16(%lhs : !vm.ref<!vmla.buffer>, %rhs : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i8(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i16(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.i32(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @clamp.f32(%min : !vm.ref<!vmla.buffer>, %value : !vm.ref<!vmla.buffer>, %max : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @floor.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @floor.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @floor.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @ceil.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @ceil.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @ceil.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: conversion
@@ -306,6 +348,10 @@ vm.import @convert.i32.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.bu
 vm.import @convert.f32.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @convert.f32.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @convert.f32.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f16.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f32.f16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.bf16.f32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
+vm.import @convert.f32.bf16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
 //===----------------------------------------------------------------------===//
 // VMLA Ops: Convolution
@@ -323,6 +369,61 @@ vm.import @conv.f32f32.f32(
   %batch_group_count: i32
 )
 
+vm.import @conv.f16f16.f16(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+
+vm.import @conv.bf16bf16.bf16(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+
+vm.import @conv.i8i8.i32(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %input_zero_point: i32,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %filter_zero_point: i32,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+
+vm.import @conv.requant.i8i8.i8(
+  %input: !vm.ref<!vmla.buffer>, %input_shape: i32 ...,
+  %input_zero_point: i32,
+  %filter: !vm.ref<!vmla.buffer>, %filter_shape: i32 ...,
+  %filter_zero_point: i32,
+  %multiplier_mantissa: !vm.ref<!vmla.buffer>,
+  %multiplier_exponent: !vm.ref<!vmla.buffer>,
+  %dst: !vm.ref<!vmla.buffer>, %dst_shape: i32 ...,
+  %dst_zero_point: i32,
+  %window_strides: i32 ...,
+  %padding: i32 ...,
+  %lhs_dilation: i32 ...,
+  %rhs_dilation: i32 ...,
+  %feature_group_count: i32,
+  %batch_group_count: i32
+)
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: GEMM/GEMV
 //===----------------------------------------------------------------------===//
@@ -333,6 +434,37 @@ vm.import @batch.matmul.f32f32.f32(
   %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
 )
 
+vm.import @batch.matmul.f16f16.f16(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+
+vm.import @batch.matmul.bf16bf16.bf16(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+
+vm.import @batch.matmul.i8i8.i32(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %lhs_zero_point : i32,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %rhs_zero_point : i32,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...
+)
+
+vm.import @batch.matmul.requant.i8i8.i8(
+  %lhs : !vm.ref<!vmla.buffer>, %lhs_shape : i32 ...,
+  %lhs_zero_point : i32,
+  %rhs : !vm.ref<!vmla.buffer>, %rhs_shape : i32 ...,
+  %rhs_zero_point : i32,
+  %multiplier_mantissa : !vm.ref<!vmla.buffer>,
+  %multiplier_exponent : !vm.ref<!vmla.buffer>,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %dst_zero_point : i32
+)
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: reduction
 //===----------------------------------------------------------------------===//
@@ -18,6 +18,7 @@
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
 #include "iree/compiler/Dialect/IREE/Transforms/Passes.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/TranslationFlags.h"
+#include "iree/compiler/Dialect/VM/Target/C/TranslationFlags.h"
 #include "iree/compiler/Dialect/VM/Transforms/Passes.h"
 #include "mlir/IR/Module.h"
 #include "mlir/Pass/PassManager.h"
@@ -71,13 +72,11 @@ static PassPipelineRegistration<> transformPassPipeline(
       passManager.addPass(IREE::createDropCompilerHintsPass());
     });
 
-LogicalResult translateFromMLIRToVMBytecodeModule(
-    ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions,
-    IREE::VM::BytecodeTargetOptions bytecodeOptions,
-    llvm::raw_ostream &output) {
-  // Convert from our source to a vm.module in canonical form.
-  // After this completes we have a non-bytecode-specific vm.module that we
-  // could lower to other forms (LLVM IR, C, etc).
+// Converts from our source to a vm.module in canonical form.
+// After this completes we have a non-bytecode-specific vm.module that we can
+// lower to other forms (bytecode, C, etc).
+static LogicalResult convertFromMLIRToVMModule(
+    ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions) {
   PassManager passManager(moduleOp.getContext());
   mlir::applyPassManagerCLOptions(passManager);
   IREE::Flow::buildFlowTransformPassPipeline(passManager);
@@ -87,11 +86,35 @@ LogicalResult translateFromMLIRToVMBytecodeModule(
   if (failed(passManager.run(moduleOp))) {
     return moduleOp.emitError() << "conversion from source -> vm failed";
   }
+  return success();
+}
+
+LogicalResult translateFromMLIRToVMBytecodeModule(
+    ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions,
+    IREE::VM::BytecodeTargetOptions bytecodeOptions,
+    llvm::raw_ostream &output) {
+  if (failed(convertFromMLIRToVMModule(moduleOp, executableOptions))) {
+    return failure();
+  }
 
   // Serialize to bytecode.
   return translateModuleToBytecode(moduleOp, bytecodeOptions, output);
 }
 
+LogicalResult translateFromMLIRToVMCModule(
+    ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions,
+    IREE::VM::CTargetOptions cOptions, llvm::raw_ostream &output) {
+  // The header only declares the module create function and does not need the
+  // full compilation pipeline to run.
+  if (cOptions.outputFormat != IREE::VM::COutputFormat::kHeader &&
+      failed(convertFromMLIRToVMModule(moduleOp, executableOptions))) {
+    return failure();
+  }
+
+  // Emit C source.
+  return translateModuleToC(moduleOp, cOptions, output);
+}
+
 static LogicalResult translateFromMLIRToVMBytecodeModuleWithFlags(
     ModuleOp moduleOp, llvm::raw_ostream &output) {
   mlir::registerPassManagerCLOptions();
@@ -105,5 +128,17 @@ static TranslateFromMLIRRegistration toVMBytecodeModuleWithFlags(
     "iree-mlir-to-vm-bytecode-module",
     translateFromMLIRToVMBytecodeModuleWithFlags);
 
+static LogicalResult translateFromMLIRToVMCModuleWithFlags(
+    ModuleOp moduleOp, llvm::raw_ostream &output) {
+  mlir::registerPassManagerCLOptions();
+  auto TargetOptions = IREE::HAL::getTargetOptionsFromFlags();
+  auto cTargetOptions = IREE::VM::getCTargetOptionsFromFlags();
+  return translateFromMLIRToVMCModule(moduleOp, TargetOptions, cTargetOptions,
+                                      output);
+}
+
+static TranslateFromMLIRRegistration toVMCModuleWithFlags(
+    "iree-mlir-to-vm-c-module", translateFromMLIRToVMCModuleWithFlags);
+
 }  // namespace iree_compiler
 }  // namespace mlir
@@ -17,6 +17,7 @@
 
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
+#include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/Module.h"
 #include "mlir/Support/LogicalResult.h"
@@ -53,6 +54,16 @@ LogicalResult translateFromMLIRToVMBytecodeModule(
     ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions,
     IREE::VM::BytecodeTargetOptions bytecodeOptions, llvm::raw_ostream &output);
 
+// Translates an MLIR module containing a set of supported IREE input dialects
+// to C source implementing the IREE VM module ahead-of-time.
+//
+// See iree/vm/c_module.h for the runtime support used by the generated source.
+//
+// Exposed via the --iree-mlir-to-vm-c-module translation.
+LogicalResult translateFromMLIRToVMCModule(
+    ModuleOp moduleOp, IREE::HAL::TargetOptions executableOptions,
+    IREE::VM::CTargetOptions cOptions, llvm::raw_ostream &output);
+
 // TODO(benvanik): versions with multiple targets, etc.
 
 }  // namespace iree_compiler
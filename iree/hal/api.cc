@@ -25,6 +25,7 @@
 #include "iree/base/shape.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api_detail.h"
+#include "iree/hal/bound_command_buffer.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/command_buffer.h"
 #include "iree/hal/device.h"
@@ -854,6 +855,34 @@ iree_hal_command_buffer_push_descriptor_set(
           binding_count)));
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_command_buffer_push_descriptor_set_slots(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_executable_layout_t* executable_layout, int32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_slot_binding_t* bindings) {
+  IREE_TRACE_SCOPE0("iree_hal_command_buffer_push_descriptor_set_slots");
+  auto* handle = reinterpret_cast<CommandBuffer*>(command_buffer);
+  if (!handle) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  if (!executable_layout) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  if (binding_count && !bindings) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  static_assert(sizeof(DescriptorSet::SlotBinding) ==
+                    sizeof(iree_hal_descriptor_set_slot_binding_t),
+                "Expecting identical layout");
+  return ToApiStatus(handle->PushDescriptorSetSlots(
+      reinterpret_cast<ExecutableLayout*>(executable_layout), set,
+      absl::MakeConstSpan(
+          reinterpret_cast<const DescriptorSet::SlotBinding*>(bindings),
+          binding_count)));
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_command_buffer_bind_descriptor_set(
     iree_hal_command_buffer_t* command_buffer,
@@ -916,6 +945,41 @@ iree_hal_command_buffer_dispatch_indirect(
       reinterpret_cast<Buffer*>(workgroups_buffer), workgroups_offset));
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_command_buffer_bind(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_host_size_t binding_table_count,
+    const iree_hal_binding_table_entry_t* binding_table,
+    iree_allocator_t allocator,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  IREE_TRACE_SCOPE0("iree_hal_command_buffer_bind");
+  if (!out_command_buffer) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  *out_command_buffer = nullptr;
+  auto* handle = reinterpret_cast<CommandBuffer*>(command_buffer);
+  if (!handle) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  if (binding_table_count && !binding_table) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  static_assert(sizeof(BindingTableEntry) ==
+                    sizeof(iree_hal_binding_table_entry_t),
+                "Expecting identical layout");
+  IREE_API_ASSIGN_OR_RETURN(
+      auto bound_command_buffer,
+      BindCommandBuffer(
+          add_ref(handle),
+          absl::MakeConstSpan(
+              reinterpret_cast<const BindingTableEntry*>(binding_table),
+              binding_table_count)));
+
+  *out_command_buffer = reinterpret_cast<iree_hal_command_buffer_t*>(
+      bound_command_buffer.release());
+  return IREE_STATUS_OK;
+}
+
 //===----------------------------------------------------------------------===//
 // iree::hal::DescriptorSet
 //===----------------------------------------------------------------------===//
@@ -1227,6 +1291,34 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_executable_cache_create(
   return IREE_STATUS_OK;
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_executable_cache_create_with_data(
+    iree_hal_device_t* device, iree_string_view_t identifier,
+    iree_const_byte_span_t initial_data, iree_allocator_t allocator,
+    iree_hal_executable_cache_t** out_executable_cache) {
+  IREE_TRACE_SCOPE0("iree_hal_executable_cache_create_with_data");
+  if (!out_executable_cache) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  *out_executable_cache = nullptr;
+  auto* handle = reinterpret_cast<Device*>(device);
+  if (!handle) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  if (!initial_data.data && initial_data.data_length) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  IREE_API_ASSIGN_OR_RETURN(
+      auto executable_cache,
+      handle->CreateExecutableCache(
+          {initial_data.data, initial_data.data_length}));
+
+  *out_executable_cache = reinterpret_cast<iree_hal_executable_cache_t*>(
+      executable_cache.release());
+  return IREE_STATUS_OK;
+}
+
 IREE_API_EXPORT bool IREE_API_CALL iree_hal_executable_cache_can_prepare_format(
     iree_hal_executable_cache_t* executable_cache,
     iree_hal_executable_format_t format) {
@@ -1237,6 +1329,29 @@ IREE_API_EXPORT bool IREE_API_CALL iree_hal_executable_cache_can_prepare_format(
   return handle->CanPrepareFormat(format);
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_executable_cache_serialize(
+    iree_hal_executable_cache_t* executable_cache, iree_allocator_t allocator,
+    iree_byte_span_t* out_data) {
+  IREE_TRACE_SCOPE0("iree_hal_executable_cache_serialize");
+  if (!out_data) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  *out_data = {nullptr, 0};
+  auto* handle = reinterpret_cast<ExecutableCache*>(executable_cache);
+  if (!handle) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+
+  IREE_API_ASSIGN_OR_RETURN(auto data, handle->Serialize());
+  if (data.empty()) return IREE_STATUS_OK;
+
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, data.size(), reinterpret_cast<void**>(&out_data->data)));
+  std::memcpy(out_data->data, data.data(), data.size());
+  out_data->data_length = data.size();
+  return IREE_STATUS_OK;
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_executable_cache_prepare_executable(
     iree_hal_executable_cache_t* executable_cache,
@@ -242,6 +242,30 @@ typedef struct {
   iree_device_size_t length;
 } iree_hal_descriptor_set_binding_t;
 
+// Specifies a descriptor set binding whose buffer range is provided at
+// submission time by the binding table of the command buffer.
+// See iree_hal_command_buffer_bind.
+typedef struct {
+  // The binding number of this entry and corresponds to a resource of the
+  // same binding number in the executable interface.
+  int32_t binding;
+  // Ordinal of the buffer range in the binding table.
+  int32_t slot;
+} iree_hal_descriptor_set_slot_binding_t;
+
+// Specifies the buffer range provided for a slot of the binding table a
+// command buffer is submitted with.
+// See iree_hal_command_buffer_bind.
+typedef struct {
+  // Buffer bound to the slot.
+  iree_hal_buffer_t* buffer;
+  // Offset, in bytes, into the buffer that the binding starts at.
+  iree_device_size_t offset;
+  // Length, in bytes, of the buffer that is available to the executable.
+  // This can be IREE_WHOLE_BUFFER.
+  iree_device_size_t length;
+} iree_hal_binding_table_entry_t;
+
 // Specifies the usage type of the descriptor set.
 typedef enum {
   // Descriptor set will be initialized once and never changed.
@@ -840,6 +864,17 @@ iree_hal_command_buffer_push_descriptor_set(
     iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings);
 
+// Pushes a descriptor set and associates it with |set| as with
+// iree_hal_command_buffer_push_descriptor_set but with the buffers taken from
+// the binding table the command buffer is submitted with.
+// See iree_hal_command_buffer_bind.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_command_buffer_push_descriptor_set_slots(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_executable_layout_t* executable_layout, int32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_slot_binding_t* bindings);
+
 // Binds a descriptor set to the given |set| matching that used in the
 // executable layout interface.
 //
@@ -887,6 +922,19 @@ iree_hal_command_buffer_dispatch_indirect(
     iree_hal_executable_t* executable, int32_t entry_point,
     iree_hal_buffer_t* workgroups_buffer, iree_device_size_t workgroups_offset);
 
+// Returns a command buffer that submits the commands recorded in
+// |command_buffer| with |binding_table| providing the buffer ranges of the
+// descriptor sets pushed with
+// iree_hal_command_buffer_push_descriptor_set_slots. The buffers are retained
+// by the returned command buffer. A command buffer can be recorded once and
+// bound any number of times to submit it with different buffers, offsets, and
+// lengths.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_command_buffer_bind(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_host_size_t binding_table_count,
+    const iree_hal_binding_table_entry_t* binding_table,
+    iree_allocator_t allocator, iree_hal_command_buffer_t** out_command_buffer);
+
 #endif  // IREE_API_NO_PROTOTYPES
 
 //===----------------------------------------------------------------------===//
@@ -1065,6 +1113,16 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_executable_cache_create(
     iree_allocator_t allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
+// Creates an executable cache as with iree_hal_executable_cache_create and
+// populates it with |initial_data| previously returned from
+// iree_hal_executable_cache_serialize. Data produced by an incompatible device
+// is ignored and an empty cache is returned.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_executable_cache_create_with_data(
+    iree_hal_device_t* device, iree_string_view_t identifier,
+    iree_const_byte_span_t initial_data, iree_allocator_t allocator,
+    iree_hal_executable_cache_t** out_executable_cache);
+
 // Retains the given |executable_cache| for the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_executable_cache_retain(iree_hal_executable_cache_t* executable_cache);
@@ -1080,6 +1138,15 @@ IREE_API_EXPORT bool IREE_API_CALL iree_hal_executable_cache_can_prepare_format(
     iree_hal_executable_cache_t* executable_cache,
     iree_hal_executable_format_t format);
 
+// Serializes the contents of |executable_cache| such that a cache created with
+// iree_hal_executable_cache_create_with_data can skip preparation work for the
+// executables prepared by this cache. The data is allocated from |allocator|
+// and must be freed by the caller with iree_allocator_free. Caches that have
+// nothing to persist return empty data.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_executable_cache_serialize(
+    iree_hal_executable_cache_t* executable_cache, iree_allocator_t allocator,
+    iree_byte_span_t* out_data);
+
 // Prepares an executable for use.
 // The provided |executable_data| will be used to either lookup a previously
 // prepared executable in the cache or prepare a new one.
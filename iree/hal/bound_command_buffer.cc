@@ -0,0 +1,150 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/bound_command_buffer.h"
+
+#include <utility>
+#include <vector>
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// Pairs a recorded command buffer with the binding table it is submitted with.
+// Queues process impl() (the recorded commands) and resolve binding table
+// slots with binding_table().
+class BoundCommandBuffer final : public CommandBuffer {
+ public:
+  BoundCommandBuffer(ref_ptr<CommandBuffer> command_buffer,
+                     absl::Span<const BindingTableEntry> binding_table)
+      : CommandBuffer(command_buffer->allocator(), command_buffer->mode(),
+                      command_buffer->command_categories()),
+        command_buffer_(std::move(command_buffer)),
+        binding_table_(binding_table.begin(), binding_table.end()) {
+    retained_buffers_.reserve(binding_table_.size());
+    for (const auto& entry : binding_table_) {
+      retained_buffers_.push_back(add_ref(entry.buffer));
+    }
+  }
+
+  CommandBuffer* impl() override { return command_buffer_->impl(); }
+
+  absl::Span<const BindingTableEntry> binding_table() const override {
+    return binding_table_;
+  }
+
+  bool is_recording() const override { return false; }
+
+  Status Begin() override { return NotRecordable(); }
+  Status End() override { return NotRecordable(); }
+
+  Status ExecutionBarrier(
+      ExecutionStageBitfield source_stage_mask,
+      ExecutionStageBitfield target_stage_mask,
+      absl::Span<const MemoryBarrier> memory_barriers,
+      absl::Span<const BufferBarrier> buffer_barriers) override {
+    return NotRecordable();
+  }
+  Status SignalEvent(Event* event,
+                     ExecutionStageBitfield source_stage_mask) override {
+    return NotRecordable();
+  }
+  Status ResetEvent(Event* event,
+                    ExecutionStageBitfield source_stage_mask) override {
+    return NotRecordable();
+  }
+  Status WaitEvents(absl::Span<Event*> events,
+                    ExecutionStageBitfield source_stage_mask,
+                    ExecutionStageBitfield target_stage_mask,
+                    absl::Span<const MemoryBarrier> memory_barriers,
+                    absl::Span<const BufferBarrier> buffer_barriers) override {
+    return NotRecordable();
+  }
+  Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length, const void* pattern,
+                    size_t pattern_length) override {
+    return NotRecordable();
+  }
+  Status DiscardBuffer(Buffer* buffer) override { return NotRecordable(); }
+  Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
+                      Buffer* target_buffer, device_size_t target_offset,
+                      device_size_t length) override {
+    return NotRecordable();
+  }
+  Status CopyBuffer(Buffer* source_buffer, device_size_t source_offset,
+                    Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length) override {
+    return NotRecordable();
+  }
+  Status PushConstants(ExecutableLayout* executable_layout, size_t offset,
+                       absl::Span<const uint32_t> values) override {
+    return NotRecordable();
+  }
+  Status PushDescriptorSet(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::Binding> bindings) override {
+    return NotRecordable();
+  }
+  Status PushDescriptorSetSlots(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::SlotBinding> bindings) override {
+    return NotRecordable();
+  }
+  Status BindDescriptorSet(
+      ExecutableLayout* executable_layout, int32_t set,
+      DescriptorSet* descriptor_set,
+      absl::Span<const device_size_t> dynamic_offsets) override {
+    return NotRecordable();
+  }
+  Status Dispatch(Executable* executable, int32_t entry_point,
+                  std::array<uint32_t, 3> workgroups) override {
+    return NotRecordable();
+  }
+  Status DispatchIndirect(Executable* executable, int32_t entry_point,
+                          Buffer* workgroups_buffer,
+                          device_size_t workgroups_offset) override {
+    return NotRecordable();
+  }
+
+ private:
+  Status NotRecordable() const {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Bound command buffers cannot be recorded into; record into "
+              "the original command buffer instead";
+  }
+
+  ref_ptr<CommandBuffer> command_buffer_;
+  std::vector<BindingTableEntry> binding_table_;
+  std::vector<ref_ptr<Buffer>> retained_buffers_;
+};
+
+}  // namespace
+
+StatusOr<ref_ptr<CommandBuffer>> BindCommandBuffer(
+    ref_ptr<CommandBuffer> command_buffer,
+    absl::Span<const BindingTableEntry> binding_table) {
+  if (!command_buffer) {
+    return InvalidArgumentErrorBuilder(IREE_LOC) << "No command buffer";
+  }
+  if (command_buffer->is_recording()) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Command buffer must have ended recording before being bound";
+  }
+  return make_ref<BoundCommandBuffer>(std::move(command_buffer),
+                                      binding_table);
+}
+
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,41 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_BOUND_COMMAND_BUFFER_H_
+#define IREE_HAL_BOUND_COMMAND_BUFFER_H_
+
+#include "iree/base/status.h"
+#include "iree/hal/buffer.h"
+#include "iree/hal/command_buffer.h"
+
+namespace iree {
+namespace hal {
+
+// Returns a command buffer that submits the commands recorded in
+// |command_buffer| with |binding_table| providing the buffer ranges of any
+// descriptor sets pushed with PushDescriptorSetSlots. The buffers are retained
+// until the returned command buffer is released.
+//
+// The returned command buffer cannot be recorded into. The recorded command
+// buffer must not be recorded into again while any bound command buffer
+// referencing it is in-flight, though it may be bound any number of times to
+// different binding tables.
+StatusOr<ref_ptr<CommandBuffer>> BindCommandBuffer(
+    ref_ptr<CommandBuffer> command_buffer,
+    absl::Span<const BindingTableEntry> binding_table);
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_BOUND_COMMAND_BUFFER_H_
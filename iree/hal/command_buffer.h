@@ -135,6 +135,20 @@ struct BufferBarrier {
   device_size_t length = kWholeBuffer;
 };
 
+// Defines the buffer range provided for a slot of the binding table a command
+// buffer is submitted with. Descriptor sets pushed with PushDescriptorSetSlots
+// reference entries by slot ordinal.
+// See BindCommandBuffer.
+struct BindingTableEntry {
+  // Buffer bound to the slot.
+  Buffer* buffer = nullptr;
+  // Offset, in bytes, into the buffer that the binding starts at.
+  device_size_t offset = 0;
+  // Length, in bytes, of the buffer that is available to the executable.
+  // This can be kWholeBuffer.
+  device_size_t length = kWholeBuffer;
+};
+
 // Asynchronous command buffer recording interface.
 // Commands are recorded by the implementation for later submission to command
 // queues.
@@ -165,6 +179,13 @@ class CommandBuffer : public Resource {
  public:
   virtual CommandBuffer* impl() { return this; }
 
+  // Buffer ranges referenced by slot from descriptor sets pushed with
+  // PushDescriptorSetSlots. Empty unless the command buffer was produced by
+  // BindCommandBuffer.
+  virtual absl::Span<const BindingTableEntry> binding_table() const {
+    return {};
+  }
+
   // Device allocator that commands encoded into the buffer share compatibility
   // with.
   Allocator* allocator() const { return allocator_; }
@@ -304,6 +325,20 @@ class CommandBuffer : public Resource {
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) = 0;
 
+  // Pushes a descriptor set and associates it with |set| as with
+  // PushDescriptorSet but with the buffers taken from the binding table the
+  // command buffer is submitted with. This allows a command buffer to be
+  // recorded once and then submitted many times with different buffers.
+  //
+  // Implementations that do not support binding tables return
+  // UNIMPLEMENTED.
+  virtual Status PushDescriptorSetSlots(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::SlotBinding> bindings) {
+    return UnimplementedErrorBuilder(IREE_LOC)
+           << "Binding table slots not supported by this command buffer";
+  }
+
   // Binds a descriptor set to the given |set| matching that used in the
   // executable layout interface.
   //
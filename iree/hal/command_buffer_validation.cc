@@ -68,6 +68,9 @@ class ValidatingCommandBuffer : public CommandBuffer {
   Status PushDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) override;
+  Status PushDescriptorSetSlots(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::SlotBinding> bindings) override;
   Status BindDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       DescriptorSet* descriptor_set,
@@ -416,6 +419,28 @@ Status ValidatingCommandBuffer::PushDescriptorSet(
   return impl_->PushDescriptorSet(executable_layout, set, bindings);
 }
 
+Status ValidatingCommandBuffer::PushDescriptorSetSlots(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const DescriptorSet::SlotBinding> bindings) {
+  DVLOG(3) << "CommandBuffer::PushDescriptorSetSlots("
+           << executable_layout->DebugString() << ", " << set << ", ["
+           << absl::StrJoin(bindings, ", ",
+                            DescriptorSetSlotBindingFormatter())
+           << "])";
+
+  RETURN_IF_ERROR(ValidateCategories(CommandCategory::kDispatch));
+
+  for (const auto& binding : bindings) {
+    if (binding.slot < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Binding " << binding.binding << " has invalid slot "
+             << binding.slot;
+    }
+  }
+
+  return impl_->PushDescriptorSetSlots(executable_layout, set, bindings);
+}
+
 Status ValidatingCommandBuffer::BindDescriptorSet(
     ExecutableLayout* executable_layout, int32_t set,
     DescriptorSet* descriptor_set,
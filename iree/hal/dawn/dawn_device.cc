@@ -107,6 +107,12 @@ ref_ptr<ExecutableCache> DawnDevice::CreateExecutableCache() {
   return make_ref<NoopExecutableCache>();
 }
 
+StatusOr<ref_ptr<ExecutableCache>> DawnDevice::CreateExecutableCache(
+    absl::Span<const uint8_t> initial_data) {
+  IREE_TRACE_SCOPE0("DawnDevice::CreateExecutableCache");
+  return CreateExecutableCache();
+}
+
 StatusOr<ref_ptr<ExecutableLayout>> DawnDevice::CreateExecutableLayout(
     absl::Span<DescriptorSetLayout* const> set_layouts, size_t push_constants) {
   IREE_TRACE_SCOPE0("DawnDevice::CreateExecutableLayout");
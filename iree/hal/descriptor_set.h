@@ -52,6 +52,21 @@ class DescriptorSet : public Resource {
                           ", offset=", offset, ", length=", length);
     }
   };
+
+  // Specifies a descriptor set binding whose buffer range is provided at
+  // submission time by the binding table of the command buffer (see
+  // BindCommandBuffer).
+  struct SlotBinding {
+    // The binding number of this entry and corresponds to a resource of the
+    // same binding number in the executable interface.
+    int32_t binding = 0;
+    // Ordinal of the buffer range in the binding table.
+    int32_t slot = 0;
+
+    std::string DebugStringShort() const {
+      return absl::StrCat("binding=", binding, ", slot=", slot);
+    }
+  };
 };
 
 struct DescriptorSetBindingFormatter {
@@ -63,6 +78,15 @@ struct DescriptorSetBindingFormatter {
   }
 };
 
+struct DescriptorSetSlotBindingFormatter {
+  void operator()(std::string* out,
+                  const DescriptorSet::SlotBinding& binding) const {
+    out->append("<");
+    out->append(binding.DebugStringShort());
+    out->append(">");
+  }
+};
+
 }  // namespace hal
 }  // namespace iree
 
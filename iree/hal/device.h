@@ -70,7 +70,6 @@ class Device : public RefObject<Device> {
   // list may be the same as (or a subset of) dispatch_queues.
   virtual absl::Span<CommandQueue*> transfer_queues() const = 0;
 
-  // TODO(b/137153339): accept initial cache data.
   // Creates a device-specific cache for executables prepared for dispatch.
   // The cache manages executable compilation, caching (on disk or in memory),
   // and lifetime. Users can decide to use one or more caches to allow differing
@@ -81,6 +80,13 @@ class Device : public RefObject<Device> {
   // using the cache are no longer in-flight.
   virtual ref_ptr<ExecutableCache> CreateExecutableCache() = 0;
 
+  // Creates an executable cache as with CreateExecutableCache() and populates
+  // it with |initial_data| previously returned from ExecutableCache::Serialize.
+  // Data produced by an incompatible device is ignored; malformed data fails
+  // with INVALID_ARGUMENT. Empty data creates an empty cache.
+  virtual StatusOr<ref_ptr<ExecutableCache>> CreateExecutableCache(
+      absl::Span<const uint8_t> initial_data) = 0;
+
   // Creates a descriptor set layout with the given bindings.
   virtual StatusOr<ref_ptr<DescriptorSetLayout>> CreateDescriptorSetLayout(
       DescriptorSetLayout::UsageType usage_type,
@@ -0,0 +1,57 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_DYLIB_DYLIB_DRIVER_H_
+#define IREE_HAL_DYLIB_DYLIB_DRIVER_H_
+
+#include "iree/hal/driver.h"
+#include "iree/hal/host/host_buffer_pool.h"
+#include "iree/hal/host/task_executor.h"
+#include "iree/hal/host/workgroup_pool.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+class DyLibDriver final : public Driver {
+ public:
+  struct Options {
+    // Controls the threads used to execute dispatch workgroups on each device.
+    WorkgroupPool::Options workgroup_pool_options;
+    // Controls the caching of buffer memory by the allocator of each device.
+    HostBufferPool::Options allocator_pool_options;
+    // Controls the threads used to execute queue submissions. These are
+    // shared with all other host devices and only used if the shared
+    // executor has not yet been created.
+    TaskExecutor::Options executor_options;
+  };
+
+  explicit DyLibDriver(Options options);
+  ~DyLibDriver() override;
+
+  StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
+
+  StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
+
+  StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  Options options_;
+};
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_DYLIB_DYLIB_DRIVER_H_
@@ -0,0 +1,69 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/numbers.h"
+#include "iree/base/init.h"
+#include "iree/base/status.h"
+#include "iree/hal/driver_registry.h"
+#include "iree/hal/dylib/dylib_driver.h"
+#include "iree/hal/host/host_buffer_pool_flags.h"
+#include "iree/hal/host/task_executor_flags.h"
+
+ABSL_FLAG(int, dylib_worker_count, 0,
+          "Number of threads used to execute dispatch workgroups, including "
+          "the submitting thread. 0 uses one per hardware thread.");
+ABSL_FLAG(std::vector<std::string>, dylib_worker_affinity, {},
+          "Comma-separated logical CPU IDs to pin workgroup worker threads to. "
+          "The submitting thread is not pinned.");
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+static StatusOr<ref_ptr<Driver>> CreateDyLibDriver() {
+  // Setup driver options from flags. We do this here as we want to enable other
+  // consumers that may not be using modules/command line flags to be able to
+  // set their options however they want.
+  DyLibDriver::Options options;
+  options.workgroup_pool_options.worker_count =
+      absl::GetFlag(FLAGS_dylib_worker_count);
+  for (const auto& cpu_str : absl::GetFlag(FLAGS_dylib_worker_affinity)) {
+    int cpu = 0;
+    if (!absl::SimpleAtoi(cpu_str, &cpu) || cpu < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Invalid --dylib_worker_affinity CPU ID '" << cpu_str << "'";
+    }
+    options.workgroup_pool_options.worker_affinity.push_back(cpu);
+  }
+  ASSIGN_OR_RETURN(options.allocator_pool_options,
+                   GetHostBufferPoolOptionsFromFlags());
+  ASSIGN_OR_RETURN(options.executor_options, GetTaskExecutorOptionsFromFlags());
+
+  return make_ref<DyLibDriver>(std::move(options));
+}
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
+
+IREE_REGISTER_MODULE_INITIALIZER(iree_hal_dylib_driver, {
+  QCHECK_OK(::iree::hal::DriverRegistry::shared_registry()->Register(
+      "dylib", ::iree::hal::dylib::CreateDyLibDriver));
+});
+IREE_REGISTER_MODULE_INITIALIZER_SEQUENCE(iree_hal, iree_hal_dylib_driver);
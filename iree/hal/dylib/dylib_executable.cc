@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/dylib/dylib_executable.h"
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/file_io.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+#include "iree/schemas/dylib_executable_def_generated.h"
+
+namespace iree {
+namespace hal {
+namespace dylib {
+
+// static
+StatusOr<ref_ptr<DyLibExecutable>> DyLibExecutable::Load(ExecutableSpec spec) {
+  auto executable = make_ref<DyLibExecutable>();
+  RETURN_IF_ERROR(executable->Initialize(spec));
+  return executable;
+}
+
+DyLibExecutable::DyLibExecutable() = default;
+
+DyLibExecutable::~DyLibExecutable() {
+  IREE_TRACE_SCOPE0("DyLibExecutable::dtor");
+  executable_library_.reset();
+  if (!library_temp_path_.empty()) {
+    file_io::DeleteFile(library_temp_path_).IgnoreError();
+  }
+}
+
+Status DyLibExecutable::Initialize(ExecutableSpec spec) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::Initialize");
+
+  if (spec.executable_data.size() < 16) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Flatbuffer data is not present or less than 16 bytes";
+  } else if (!iree::DyLibExecutableDefBufferHasIdentifier(
+                 spec.executable_data.data())) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Flatbuffer data does not have dylib executable identifier";
+  }
+  ::flatbuffers::Verifier verifier(spec.executable_data.data(),
+                                   spec.executable_data.size());
+  if (!iree::VerifyDyLibExecutableDefBuffer(verifier)) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Flatbuffer data failed verification";
+  }
+
+  const auto* executable_def = ::flatbuffers::GetRoot<iree::DyLibExecutableDef>(
+      spec.executable_data.data());
+  const auto* library_embedded = executable_def->library_embedded();
+  const auto* entry_points = executable_def->entry_points();
+  if (!library_embedded || library_embedded->size() == 0 || !entry_points) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Executable is missing its library or entry points";
+  }
+
+  // The platform loaders can only load libraries from files so we extract the
+  // embedded library to a temporary file. On POSIX systems the file can be
+  // unlinked as soon as it is mapped; elsewhere it is deleted with the
+  // executable.
+  ASSIGN_OR_RETURN(library_temp_path_, file_io::GetTempFile("iree_dylib"));
+  RETURN_IF_ERROR(file_io::SetFileContents(
+      library_temp_path_,
+      std::string(reinterpret_cast<const char*>(library_embedded->data()),
+                  library_embedded->size())));
+  auto library_or = DynamicLibrary::Load(library_temp_path_.c_str());
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+  file_io::DeleteFile(library_temp_path_).IgnoreError();
+  library_temp_path_.clear();
+#endif  // IREE_PLATFORM_*
+  RETURN_IF_ERROR(library_or.status());
+  executable_library_ = std::move(library_or).value();
+
+  entry_functions_.resize(entry_points->size());
+  for (int i = 0; i < entry_functions_.size(); ++i) {
+    std::string symbol_name =
+        std::string("invoke_") + entry_points->Get(i)->str();
+    entry_functions_[i] = executable_library_->GetSymbol(symbol_name.c_str());
+    if (!entry_functions_[i]) {
+      return NotFoundErrorBuilder(IREE_LOC)
+             << "Could not find symbol '" << symbol_name << "' in library";
+    }
+  }
+
+  return OkStatus();
+}
+
+Status DyLibExecutable::Invoke(int ordinal, absl::Span<void*> args) const {
+  if (ordinal < 0 || ordinal >= entry_functions_.size()) {
+    return OutOfRangeErrorBuilder(IREE_LOC)
+           << "Entry point ordinal " << ordinal << " out of range";
+  }
+  auto entry_function =
+      reinterpret_cast<void (*)(void**)>(entry_functions_[ordinal]);
+  entry_function(args.data());
+  return OkStatus();
+}
+
+}  // namespace dylib
+}  // namespace hal
+}  // namespace iree
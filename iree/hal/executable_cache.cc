@@ -21,5 +21,9 @@ ExecutableCache::ExecutableCache() = default;
 
 ExecutableCache::~ExecutableCache() = default;
 
+StatusOr<std::vector<uint8_t>> ExecutableCache::Serialize() const {
+  return std::vector<uint8_t>{};
+}
+
 }  // namespace hal
 }  // namespace iree
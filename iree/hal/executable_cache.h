@@ -15,6 +15,9 @@
 #ifndef IREE_HAL_EXECUTABLE_CACHE_H_
 #define IREE_HAL_EXECUTABLE_CACHE_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "iree/base/bitfield.h"
 #include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
@@ -96,7 +99,15 @@ class ExecutableCache : public RefObject<ExecutableCache> {
 
   // TODO(benvanik): status/queries (size, etc).
 
-  // TODO(b/137153339): serialization/deserialization.
+  // Serializes the contents of the cache such that a cache created from the
+  // returned data with Device::CreateExecutableCache can skip some or all of
+  // the work required to prepare the executables that had been prepared with
+  // this cache. The data is only valid for the same driver and is ignored by
+  // devices that are not compatible with the device that produced it (such as
+  // a different GPU or CPU).
+  //
+  // Caches that have nothing to persist return empty data.
+  virtual StatusOr<std::vector<uint8_t>> Serialize() const;
 
   // Returns true if the executable cache can prepare the given executable input
   // format. Preparation may still fail if the particular version or features
@@ -21,93 +21,125 @@
 namespace iree {
 namespace hal {
 
-AsyncCommandQueue::AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue)
+struct AsyncCommandQueue::WakeTarget {
+  // Guards the executor used to schedule wakes. May be acquired with the
+  // submission_mutex_ of the queue held (when the queue itself signals a
+  // timeline semaphore).
+  absl::Mutex executor_mutex;
+  ref_ptr<TaskExecutor> executor ABSL_GUARDED_BY(executor_mutex);
+
+  // Held while calling into the queue so that it cannot be destroyed
+  // underneath a wake. Acquired before the submission_mutex_ of the queue.
+  absl::Mutex queue_mutex;
+  AsyncCommandQueue* queue ABSL_GUARDED_BY(queue_mutex) = nullptr;
+};
+
+AsyncCommandQueue::AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                                     ref_ptr<TaskExecutor> executor)
     : CommandQueue(target_queue->name(), target_queue->supported_categories()),
-      target_queue_(std::move(target_queue)) {
-  IREE_TRACE_SCOPE0("AsyncCommandQueue::ctor");
-  thread_ = std::thread([this]() { ThreadMain(); });
+      target_queue_(std::move(target_queue)),
+      executor_(std::move(executor)),
+      wake_target_(std::make_shared<WakeTarget>()),
+      submission_queue_([wake_target = wake_target_]() { Wake(wake_target); }) {
+  {
+    absl::MutexLock lock(&wake_target_->executor_mutex);
+    wake_target_->executor = add_ref(executor_);
+  }
+  {
+    absl::MutexLock lock(&wake_target_->queue_mutex);
+    wake_target_->queue = this;
+  }
 }
 
 AsyncCommandQueue::~AsyncCommandQueue() {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::dtor");
   {
-    // Signal to thread that we want to stop. Note that the thread may have
-    // already been stopped and that's ok (as we'll Join right away).
-    // The thread will finish processing any queued submissions.
     absl::MutexLock lock(&submission_mutex_);
     submission_queue_.SignalShutdown();
+
+    // Wait for any batches still executing on the executor as they reference
+    // us. The queue finishes processing any submissions that become ready
+    // while we wait.
+    submission_mutex_.Await(absl::Condition(
+        +[](HostSubmissionQueue* queue) {
+          return queue->in_flight_count() == 0;
+        },
+        &submission_queue_));
+    CHECK(submission_queue_.empty())
+        << "Dirty shutdown of async queue (submissions still waiting)";
   }
-  thread_.join();
 
-  // Ensure we shut down OK.
+  // Detach from any notifications still registered on timeline semaphores.
+  // This waits for wakes that are currently running against the queue.
   {
-    absl::MutexLock lock(&submission_mutex_);
-    CHECK(submission_queue_.empty())
-        << "Dirty shutdown of async queue (unexpected thread exit?)";
+    absl::MutexLock lock(&wake_target_->executor_mutex);
+    wake_target_->executor.reset();
+  }
+  {
+    absl::MutexLock lock(&wake_target_->queue_mutex);
+    wake_target_->queue = nullptr;
   }
 }
 
-void AsyncCommandQueue::ThreadMain() {
-  // TODO(benvanik): make this safer (may die if trace is flushed late).
-  IREE_TRACE_THREAD_ENABLE(target_queue_->name().c_str());
-
-  bool is_exiting = false;
-  while (!is_exiting) {
-    // Block until we are either requested to exit or there are pending
-    // submissions.
-    submission_mutex_.Lock();
-    submission_mutex_.Await(absl::Condition(
-        +[](HostSubmissionQueue* queue) {
-          return queue->has_shutdown() || !queue->empty();
-        },
-        &submission_queue_));
-    if (!submission_queue_.empty()) {
-      // Run all ready submissions (this may be called many times).
-      submission_mutex_.AssertHeld();
-      submission_queue_
-          .ProcessBatches(
-              [this](absl::Span<CommandBuffer* const> command_buffers)
-                  ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_) {
-                    // Release the lock while we perform the processing so that
-                    // other threads can submit more work.
-                    submission_mutex_.AssertHeld();
-                    submission_mutex_.Unlock();
-
-                    // Relay the command buffers to the target queue.
-                    // Since we are taking care of all synchronization they
-                    // don't need any waiters or fences.
-                    auto status = target_queue_->Submit(
-                        {{}, command_buffers, {}}, {nullptr, 0u});
-
-                    // Take back the lock so we can manipulate the queue safely.
-                    submission_mutex_.Lock();
-                    submission_mutex_.AssertHeld();
-
-                    return status;
-                  })
-          .IgnoreError();
-      submission_mutex_.AssertHeld();
-    }
-    if (submission_queue_.has_shutdown()) {
-      // Exit when there are no more submissions to process and an exit was
-      // requested (or we errored out).
-      is_exiting = true;
+// static
+void AsyncCommandQueue::Wake(const std::shared_ptr<WakeTarget>& wake_target) {
+  // We may be called from within the queue (with its lock held) so we can't
+  // reschedule inline; bounce to the executor instead.
+  absl::MutexLock lock(&wake_target->executor_mutex);
+  if (!wake_target->executor) return;
+  wake_target->executor->Submit([wake_target]() {
+    absl::MutexLock lock(&wake_target->queue_mutex);
+    if (wake_target->queue) {
+      wake_target->queue->OnTimelineSemaphoreSignaled();
     }
-    submission_mutex_.Unlock();
+  });
+}
+
+void AsyncCommandQueue::OnTimelineSemaphoreSignaled() {
+  IREE_TRACE_SCOPE0("AsyncCommandQueue::OnTimelineSemaphoreSignaled");
+  absl::MutexLock lock(&submission_mutex_);
+  ScheduleReadyBatches();
+}
+
+void AsyncCommandQueue::ScheduleReadyBatches() {
+  HostSubmissionQueue::ReadyBatch batch;
+  while (submission_queue_.AcquireReadyBatch(&batch)) {
+    executor_->Submit([this, batch]() { ExecuteBatch(batch); });
   }
 }
 
+void AsyncCommandQueue::ExecuteBatch(
+    const HostSubmissionQueue::ReadyBatch& batch) {
+  IREE_TRACE_SCOPE0("AsyncCommandQueue::ExecuteBatch");
+
+  // Relay the command buffers to the target queue.
+  // Since we are taking care of all synchronization they don't need any
+  // waiters or fences.
+  auto status =
+      target_queue_->Submit({{}, batch.command_buffers, {}}, {nullptr, 0u});
+
+  // Failures (of the batch itself or of signaling its semaphores and fences)
+  // are sticky on the submission queue and fail all pending submissions; they
+  // are reported by WaitIdle and the submission fences.
+  absl::MutexLock lock(&submission_mutex_);
+  auto retire_status = submission_queue_.RetireBatch(batch, std::move(status));
+  if (!retire_status.ok()) return;
+  ScheduleReadyBatches();
+}
+
 Status AsyncCommandQueue::Submit(absl::Span<const SubmissionBatch> batches,
                                  FenceValue fence) {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::Submit");
   absl::MutexLock lock(&submission_mutex_);
-  return submission_queue_.Enqueue(batches, fence);
+  RETURN_IF_ERROR(submission_queue_.Enqueue(batches, fence));
+  ScheduleReadyBatches();
+  return OkStatus();
 }
 
 Status AsyncCommandQueue::WaitIdle(absl::Time deadline) {
   IREE_TRACE_SCOPE0("AsyncCommandQueue::WaitIdle");
 
-  // Wait until the deadline, the thread exits, or there are no more pending
+  // Wait until the deadline, a failure occurs, or there are no more pending
   // submissions.
   absl::MutexLock lock(&submission_mutex_);
   if (!submission_mutex_.AwaitWithDeadline(
@@ -118,7 +150,7 @@ Status AsyncCommandQueue::WaitIdle(absl::Time deadline) {
               &submission_queue_),
           deadline)) {
     return DeadlineExceededErrorBuilder(IREE_LOC)
-           << "Deadline exceeded waiting for submission thread to go idle";
+           << "Deadline exceeded waiting for submissions to complete";
   }
   return submission_queue_.permanent_error();
 }
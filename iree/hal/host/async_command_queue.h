@@ -16,21 +16,26 @@
 #define IREE_HAL_HOST_ASYNC_COMMAND_QUEUE_H_
 
 #include <memory>
-#include <thread>  // NOLINT
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "iree/base/ref_ptr.h"
 #include "iree/hal/command_queue.h"
 #include "iree/hal/fence.h"
 #include "iree/hal/host/host_submission_queue.h"
+#include "iree/hal/host/task_executor.h"
 
 namespace iree {
 namespace hal {
 
 // Asynchronous command queue wrapper.
-// This creates a single thread to perform all CommandQueue operations. Any
-// submitted CommandBuffer is dispatched in FIFO order on the queue thread
-// against the provided |target_queue|.
+// Submitted batches are executed against the provided |target_queue| on the
+// worker threads of a TaskExecutor as soon as the semaphores they wait on are
+// signaled. Timeline semaphores may be signaled by other queues or the host
+// and any batches they unblock are scheduled immediately. Batches that do not
+// depend on each other (such as those submitted by independent requests) may
+// execute concurrently, so |target_queue| must support concurrent Submit
+// calls. The executor is usually shared with the queues of other devices.
 //
 // Target queues will receive submissions containing only command buffers as
 // all semaphore synchronization is handled by the wrapper. Fences will also be
@@ -41,7 +46,8 @@ namespace hal {
 // such a case depends entirely on the synchronization primitives provided.
 class AsyncCommandQueue final : public CommandQueue {
  public:
-  explicit AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue);
+  AsyncCommandQueue(std::unique_ptr<CommandQueue> target_queue,
+                    ref_ptr<TaskExecutor> executor);
   ~AsyncCommandQueue() override;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -50,15 +56,32 @@ class AsyncCommandQueue final : public CommandQueue {
   Status WaitIdle(absl::Time deadline) override;
 
  private:
-  // Thread entry point for the async worker thread.
-  // Waits for submissions to be queued up and processes them eagerly.
-  void ThreadMain();
+  // Schedules all batches that are ready to execute on the executor.
+  void ScheduleReadyBatches() ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_);
+
+  // Executes |batch| against the target queue and retires it, scheduling any
+  // batches that became ready as a result. Runs on an executor worker.
+  void ExecuteBatch(const HostSubmissionQueue::ReadyBatch& batch);
+
+  // Relays timeline semaphore notifications to the queue; defined in the .cc.
+  struct WakeTarget;
+
+  // Schedules a task that reschedules the queue of |wake_target| if it still
+  // exists. May be called with the submission_mutex_ of the queue held.
+  static void Wake(const std::shared_ptr<WakeTarget>& wake_target);
+
+  // Schedules any batches made ready by a timeline semaphore signal.
+  void OnTimelineSemaphoreSignaled();
 
   // CommandQueue that the async queue relays submissions into.
   std::unique_ptr<CommandQueue> target_queue_;
 
-  // Thread that runs the ThreadMain() function and processes submissions.
-  std::thread thread_;
+  // Executor running the batches. Outlives all of the batch tasks.
+  ref_ptr<TaskExecutor> executor_;
+
+  // Shared with the notifications registered on timeline semaphores, which may
+  // outlive the queue.
+  std::shared_ptr<WakeTarget> wake_target_;
 
   // Queue that manages submission ordering.
   mutable absl::Mutex submission_mutex_;
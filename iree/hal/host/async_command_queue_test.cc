@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/async_command_queue.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -26,6 +27,7 @@
 #include "iree/base/time.h"
 #include "iree/hal/command_queue.h"
 #include "iree/hal/host/host_submission_queue.h"
+#include "iree/hal/host/task_executor.h"
 #include "iree/hal/testing/mock_command_buffer.h"
 #include "iree/hal/testing/mock_command_queue.h"
 #include "iree/testing/gtest.h"
@@ -40,19 +42,25 @@ using testing::MockCommandBuffer;
 using testing::MockCommandQueue;
 
 struct AsyncCommandQueueTest : public ::testing::Test {
+  ref_ptr<TaskExecutor> executor;
   MockCommandQueue* mock_target_queue;
   std::unique_ptr<CommandQueue> command_queue;
 
   void SetUp() override {
+    TaskExecutor::Options options;
+    options.worker_count = 2;
+    executor = make_ref<TaskExecutor>(options);
     auto mock_queue = absl::make_unique<MockCommandQueue>(
         "mock", CommandCategory::kTransfer | CommandCategory::kDispatch);
     mock_target_queue = mock_queue.get();
-    command_queue = absl::make_unique<AsyncCommandQueue>(std::move(mock_queue));
+    command_queue = absl::make_unique<AsyncCommandQueue>(std::move(mock_queue),
+                                                         add_ref(executor));
   }
 
   void TearDown() override {
     command_queue.reset();
     mock_target_queue = nullptr;
+    executor.reset();
   }
 };
 
@@ -160,6 +168,161 @@ TEST_F(AsyncCommandQueueTest, WaitIdleAndProgress) {
   ASSERT_EQ(1u, value_1);
 }
 
+// Tests that independent submissions execute concurrently. Each submission
+// blocks until the other has started, which would deadlock if they were
+// executed one at a time.
+TEST_F(AsyncCommandQueueTest, IndependentSubmissionsRunConcurrently) {
+  std::atomic<int> running_count{0};
+  EXPECT_CALL(*mock_target_queue, Submit(_, _))
+      .Times(2)
+      .WillRepeatedly([&](absl::Span<const SubmissionBatch> batches,
+                          FenceValue fence) -> Status {
+        ++running_count;
+        absl::Time deadline = absl::Now() + absl::Seconds(10);
+        while (running_count < 2) {
+          if (absl::Now() > deadline) {
+            return DeadlineExceededErrorBuilder(IREE_LOC)
+                   << "Submissions were not executed concurrently";
+          }
+          Sleep(absl::Milliseconds(1));
+        }
+        return OkStatus();
+      });
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  HostFence fence_0(0u);
+  ASSERT_OK(
+      command_queue->Submit({{}, {cmd_buffer_0.get()}, {}}, {&fence_0, 1u}));
+  HostFence fence_1(0u);
+  ASSERT_OK(
+      command_queue->Submit({{}, {cmd_buffer_1.get()}, {}}, {&fence_1, 1u}));
+
+  ASSERT_OK(command_queue->WaitIdle());
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+}
+
+// Tests that a submission waiting on a semaphore only executes after the
+// submission signaling it has completed.
+TEST_F(AsyncCommandQueueTest, SemaphoreOrdersSubmissions) {
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+
+  std::atomic<bool> first_completed{false};
+  EXPECT_CALL(*mock_target_queue, Submit(_, _))
+      .Times(2)
+      .WillRepeatedly([&](absl::Span<const SubmissionBatch> batches,
+                          FenceValue fence) -> Status {
+        if (batches[0].command_buffers[0] == cmd_buffer_0.get()) {
+          Sleep(absl::Milliseconds(50));
+          first_completed = true;
+          return OkStatus();
+        }
+        if (!first_completed) {
+          return DataLossErrorBuilder(IREE_LOC)
+                 << "Dependent submission executed early";
+        }
+        return OkStatus();
+      });
+
+  // Submit the dependent work first to ensure it is held back.
+  HostBinarySemaphore semaphore_0_1(false);
+  HostFence fence_1(0u);
+  ASSERT_OK(command_queue->Submit({{&semaphore_0_1}, {cmd_buffer_1.get()}, {}},
+                                  {&fence_1, 1u}));
+  HostFence fence_0(0u);
+  ASSERT_OK(command_queue->Submit({{}, {cmd_buffer_0.get()}, {&semaphore_0_1}},
+                                  {&fence_0, 1u}));
+
+  ASSERT_OK(command_queue->WaitIdle());
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+}
+
+// Tests that submissions waiting on a timeline semaphore are scheduled when the
+// host signals it.
+TEST_F(AsyncCommandQueueTest, TimelineSignaledFromHost) {
+  auto cmd_buffer = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  std::atomic<bool> executed{false};
+  EXPECT_CALL(*mock_target_queue, Submit(_, _))
+      .WillOnce([&](absl::Span<const SubmissionBatch> batches,
+                    FenceValue fence) -> Status {
+        executed = true;
+        return OkStatus();
+      });
+
+  HostTimelineSemaphore semaphore(0u);
+  SemaphoreValue wait_1 = std::make_pair(&semaphore, 1u);
+  HostFence fence(0u);
+  ASSERT_OK(command_queue->Submit({{wait_1}, {cmd_buffer.get()}, {}},
+                                  {&fence, 1u}));
+  Sleep(absl::Milliseconds(50));
+  EXPECT_FALSE(executed);
+
+  ASSERT_OK(semaphore.Signal(1u));
+  ASSERT_OK(HostFence::WaitForFences({{&fence, 1u}}, /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+  EXPECT_TRUE(executed);
+}
+
+// Tests that a timeline semaphore signaled by one queue wakes submissions
+// waiting on it in another queue.
+TEST_F(AsyncCommandQueueTest, TimelineAcrossQueues) {
+  auto other_mock_queue = absl::make_unique<MockCommandQueue>(
+      "other", CommandCategory::kTransfer | CommandCategory::kDispatch);
+  auto* other_mock_target_queue = other_mock_queue.get();
+  std::unique_ptr<CommandQueue> other_command_queue =
+      absl::make_unique<AsyncCommandQueue>(std::move(other_mock_queue),
+                                           add_ref(executor));
+
+  auto cmd_buffer_0 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  auto cmd_buffer_1 = make_ref<MockCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+  std::atomic<bool> first_completed{false};
+  EXPECT_CALL(*mock_target_queue, Submit(_, _))
+      .WillOnce([&](absl::Span<const SubmissionBatch> batches,
+                    FenceValue fence) -> Status {
+        Sleep(absl::Milliseconds(50));
+        first_completed = true;
+        return OkStatus();
+      });
+  EXPECT_CALL(*other_mock_target_queue, Submit(_, _))
+      .WillOnce([&](absl::Span<const SubmissionBatch> batches,
+                    FenceValue fence) -> Status {
+        if (!first_completed) {
+          return DataLossErrorBuilder(IREE_LOC)
+                 << "Dependent submission executed early";
+        }
+        return OkStatus();
+      });
+
+  // Submit the dependent work first to ensure it is held back.
+  HostTimelineSemaphore semaphore(0u);
+  SemaphoreValue semaphore_1 = std::make_pair(&semaphore, 1u);
+  HostFence fence_1(0u);
+  ASSERT_OK(other_command_queue->Submit(
+      {{semaphore_1}, {cmd_buffer_1.get()}, {}}, {&fence_1, 1u}));
+  HostFence fence_0(0u);
+  ASSERT_OK(command_queue->Submit({{}, {cmd_buffer_0.get()}, {semaphore_1}},
+                                  {&fence_0, 1u}));
+
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/true,
+                                     absl::InfiniteFuture()));
+  ASSERT_OK(semaphore.Wait(1u, absl::InfiniteFuture()));
+  ASSERT_OK(other_command_queue->WaitIdle());
+  other_command_queue.reset();
+}
+
 // Tests that failures are sticky.
 TEST_F(AsyncCommandQueueTest, StickyFailures) {
   ::testing::InSequence sequence;
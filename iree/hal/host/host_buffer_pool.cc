@@ -0,0 +1,293 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_buffer_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "iree/base/math.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+std::atomic<uint64_t> next_pool_id{1};
+
+int Log2Ceil(size_t value) {
+  if (value <= 1) return 0;
+  return 64 - CountLeadingZeros64(static_cast<uint64_t>(value) - 1);
+}
+
+HostBufferPool::Options NormalizeOptions(HostBufferPool::Options options) {
+  options.min_block_size =
+      size_t{1} << Log2Ceil(std::max<size_t>(16, options.min_block_size));
+  options.max_block_size =
+      size_t{1}
+      << Log2Ceil(std::max(options.min_block_size, options.max_block_size));
+  options.thread_cache_block_count =
+      std::max(0, options.thread_cache_block_count);
+  return options;
+}
+
+}  // namespace
+
+HostBufferPool::HostBufferPool(Options options)
+    : options_(NormalizeOptions(std::move(options))),
+      pool_id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)) {
+  if (options_.max_cached_bytes > 0) {
+    min_block_size_log2_ = Log2Ceil(options_.min_block_size);
+    size_class_count_ =
+        Log2Ceil(options_.max_block_size) - min_block_size_log2_ + 1;
+    size_classes_ = absl::make_unique<SizeClass[]>(size_class_count_);
+    for (int i = 0; i < size_class_count_; ++i) {
+      size_classes_[i].block_size = options_.min_block_size << i;
+    }
+    absl::MutexLock lock(&mutex_);
+    shared_blocks_.resize(size_class_count_);
+  }
+
+  if (size_class_count_ > 0 &&
+      options_.idle_trim_delay > absl::ZeroDuration()) {
+    trim_thread_ = std::thread([this]() { TrimThreadMain(); });
+  }
+}
+
+HostBufferPool::~HostBufferPool() {
+  IREE_TRACE_SCOPE0("HostBufferPool::dtor");
+  if (trim_thread_.joinable()) {
+    {
+      absl::MutexLock lock(&trim_mutex_);
+      has_shutdown_ = true;
+    }
+    trim_thread_.join();
+  }
+
+  // Threads may still reference their caches; they notice the pool is gone
+  // the next time they look up a cache.
+  absl::MutexLock lock(&mutex_);
+  for (auto& thread_cache : thread_caches_) {
+    FreeThreadCacheBlocks(thread_cache.get());
+    thread_cache->is_orphaned = true;
+  }
+  thread_caches_.clear();
+  FreeBlocks(&shared_blocks_);
+}
+
+int HostBufferPool::SizeClassIndex(size_t size) const {
+  if (size_class_count_ == 0 || size > options_.max_block_size) return -1;
+  if (size <= options_.min_block_size) return 0;
+  return Log2Ceil(size) - min_block_size_log2_;
+}
+
+HostBufferPool::ThreadCache* HostBufferPool::GetThreadCache() {
+  // Pools are rarely created so the list is short; entries of destroyed pools
+  // are dropped as they are found.
+  static thread_local std::vector<
+      std::pair<uint64_t, std::shared_ptr<ThreadCache>>>
+      thread_cache_entries;
+  for (auto it = thread_cache_entries.begin();
+       it != thread_cache_entries.end();) {
+    if (it->first == pool_id_) return it->second.get();
+    if (it->second->is_orphaned) {
+      it = thread_cache_entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto thread_cache = std::make_shared<ThreadCache>();
+  thread_cache->block_count = options_.thread_cache_block_count;
+  thread_cache->slots = absl::make_unique<std::atomic<void*>[]>(
+      size_class_count_ * options_.thread_cache_block_count);
+  {
+    absl::MutexLock lock(&mutex_);
+    thread_caches_.push_back(thread_cache);
+  }
+  thread_cache_entries.emplace_back(pool_id_, thread_cache);
+  return thread_cache.get();
+}
+
+void* HostBufferPool::Acquire(size_t size) {
+  int size_class_index = SizeClassIndex(size);
+  if (size_class_index < 0) {
+    unpooled_count_.fetch_add(1, std::memory_order_relaxed);
+    return std::calloc(1, size);
+  }
+  allocation_epoch_.fetch_add(1, std::memory_order_relaxed);
+  auto& size_class = size_classes_[size_class_index];
+
+  void* block = nullptr;
+  auto* thread_cache = GetThreadCache();
+  auto* slots =
+      &thread_cache->slots[size_class_index * thread_cache->block_count];
+  for (int i = 0; i < thread_cache->block_count && !block; ++i) {
+    // Trim may empty the slot between the load and the exchange.
+    if (slots[i].load(std::memory_order_relaxed)) {
+      block = slots[i].exchange(nullptr, std::memory_order_acquire);
+    }
+  }
+  if (!block) {
+    absl::MutexLock lock(&mutex_);
+    auto& blocks = shared_blocks_[size_class_index];
+    if (!blocks.empty()) {
+      block = blocks.back();
+      blocks.pop_back();
+    }
+  }
+
+  if (!block) {
+    size_class.miss_count.fetch_add(1, std::memory_order_relaxed);
+    // Fresh pages from calloc are usually already zeroed by the system.
+    return std::calloc(1, size_class.block_size);
+  }
+  size_class.hit_count.fetch_add(1, std::memory_order_relaxed);
+  cached_bytes_.fetch_sub(size_class.block_size, std::memory_order_relaxed);
+  std::memset(block, 0, size);
+  return block;
+}
+
+void HostBufferPool::Release(void* block, size_t size) {
+  int size_class_index = SizeClassIndex(size);
+  if (size_class_index < 0) {
+    std::free(block);
+    return;
+  }
+  size_t block_size = size_classes_[size_class_index].block_size;
+
+  // Reserve space under the high-water mark before caching the block.
+  size_t cached_bytes =
+      cached_bytes_.fetch_add(block_size, std::memory_order_relaxed) +
+      block_size;
+  if (cached_bytes > options_.max_cached_bytes) {
+    cached_bytes_.fetch_sub(block_size, std::memory_order_relaxed);
+    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    std::free(block);
+    return;
+  }
+  size_t peak_cached_bytes =
+      peak_cached_bytes_.load(std::memory_order_relaxed);
+  while (cached_bytes > peak_cached_bytes &&
+         !peak_cached_bytes_.compare_exchange_weak(
+             peak_cached_bytes, cached_bytes, std::memory_order_relaxed)) {
+  }
+
+  auto* thread_cache = GetThreadCache();
+  auto* slots =
+      &thread_cache->slots[size_class_index * thread_cache->block_count];
+  for (int i = 0; i < thread_cache->block_count; ++i) {
+    void* empty_slot = nullptr;
+    if (slots[i].compare_exchange_strong(empty_slot, block,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  absl::MutexLock lock(&mutex_);
+  shared_blocks_[size_class_index].push_back(block);
+}
+
+size_t HostBufferPool::FreeBlocks(std::vector<std::vector<void*>>* blocks) {
+  size_t freed_bytes = 0;
+  for (size_t i = 0; i < blocks->size(); ++i) {
+    for (void* block : (*blocks)[i]) {
+      std::free(block);
+    }
+    freed_bytes += (*blocks)[i].size() * size_classes_[i].block_size;
+    (*blocks)[i].clear();
+  }
+  return freed_bytes;
+}
+
+size_t HostBufferPool::FreeThreadCacheBlocks(ThreadCache* thread_cache) {
+  size_t freed_bytes = 0;
+  for (int i = 0; i < size_class_count_; ++i) {
+    auto* slots = &thread_cache->slots[i * thread_cache->block_count];
+    for (int j = 0; j < thread_cache->block_count; ++j) {
+      // The owning thread may be using the cache concurrently; the exchange
+      // ensures each block is taken by only one of us.
+      void* block = slots[j].exchange(nullptr, std::memory_order_acquire);
+      if (block) {
+        std::free(block);
+        freed_bytes += size_classes_[i].block_size;
+      }
+    }
+  }
+  return freed_bytes;
+}
+
+void HostBufferPool::Trim() {
+  IREE_TRACE_SCOPE0("HostBufferPool::Trim");
+  trim_count_.fetch_add(1, std::memory_order_relaxed);
+  if (size_class_count_ == 0) return;
+
+  absl::MutexLock lock(&mutex_);
+  size_t freed_bytes = FreeBlocks(&shared_blocks_);
+  for (auto it = thread_caches_.begin(); it != thread_caches_.end();) {
+    freed_bytes += FreeThreadCacheBlocks(it->get());
+    // Caches only referenced by the pool belong to threads that have exited.
+    if (it->use_count() == 1) {
+      it = thread_caches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  cached_bytes_.fetch_sub(freed_bytes, std::memory_order_relaxed);
+}
+
+HostBufferPool::Statistics HostBufferPool::statistics() const {
+  Statistics statistics;
+  statistics.unpooled_count = unpooled_count_.load(std::memory_order_relaxed);
+  statistics.overflow_count = overflow_count_.load(std::memory_order_relaxed);
+  statistics.trim_count = trim_count_.load(std::memory_order_relaxed);
+  statistics.cached_bytes = cached_bytes_.load(std::memory_order_relaxed);
+  statistics.peak_cached_bytes =
+      peak_cached_bytes_.load(std::memory_order_relaxed);
+  statistics.size_classes.resize(size_class_count_);
+  for (int i = 0; i < size_class_count_; ++i) {
+    auto& size_class_statistics = statistics.size_classes[i];
+    size_class_statistics.block_size = size_classes_[i].block_size;
+    size_class_statistics.hit_count =
+        size_classes_[i].hit_count.load(std::memory_order_relaxed);
+    size_class_statistics.miss_count =
+        size_classes_[i].miss_count.load(std::memory_order_relaxed);
+    statistics.hit_count += size_class_statistics.hit_count;
+    statistics.miss_count += size_class_statistics.miss_count;
+  }
+  return statistics;
+}
+
+void HostBufferPool::TrimThreadMain() {
+  uint64_t last_allocation_epoch =
+      allocation_epoch_.load(std::memory_order_relaxed);
+  absl::MutexLock lock(&trim_mutex_);
+  while (!trim_mutex_.AwaitWithTimeout(absl::Condition(&has_shutdown_),
+                                       options_.idle_trim_delay)) {
+    uint64_t allocation_epoch =
+        allocation_epoch_.load(std::memory_order_relaxed);
+    if (allocation_epoch == last_allocation_epoch &&
+        cached_bytes_.load(std::memory_order_relaxed) > 0) {
+      Trim();
+    }
+    last_allocation_epoch = allocation_epoch;
+  }
+}
+
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,184 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_HOST_BUFFER_POOL_H_
+#define IREE_HAL_HOST_HOST_BUFFER_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace iree {
+namespace hal {
+
+// A cache of host memory blocks used to back HostBuffers.
+//
+// Allocations are rounded up to power-of-two size classes and blocks released
+// back to the pool are kept for reuse by later allocations of the same class.
+// Each thread has a small cache of its own that is checked before the shared
+// cache so that the common case of a thread allocating and releasing buffers in
+// a loop takes no locks and does not contend with other threads. Allocations
+// larger than the largest size class always go to the system heap.
+//
+// The total size of all cached blocks is bounded by a high-water mark; blocks
+// released while the pool is at the mark are returned to the system heap.
+// Cached blocks are also returned to the system heap when the pool has not
+// been allocated from for a while (see Options::idle_trim_delay) or when Trim
+// is called explicitly.
+//
+// Thread-safe.
+class HostBufferPool final {
+ public:
+  struct Options {
+    // Smallest size class, in bytes. Rounded up to a power of two.
+    size_t min_block_size = 256;
+
+    // Largest size class, in bytes. Rounded up to a power of two. Allocations
+    // larger than this are not pooled.
+    size_t max_block_size = 64 * 1024 * 1024;
+
+    // Maximum total size of the cached blocks, in bytes. 0 disables pooling.
+    size_t max_cached_bytes = 256 * 1024 * 1024;
+
+    // Maximum number of blocks of each size class cached by each thread.
+    // Blocks beyond this go to the cache shared by all threads.
+    int thread_cache_block_count = 4;
+
+    // Time without any allocations after which all cached blocks are
+    // returned to the system heap. Zero disables trimming on idle.
+    absl::Duration idle_trim_delay = absl::Seconds(10);
+  };
+
+  struct SizeClassStatistics {
+    // Size of the blocks in the class, in bytes.
+    size_t block_size = 0;
+    // Allocations satisfied from a cached block.
+    int64_t hit_count = 0;
+    // Allocations that had to go to the system heap.
+    int64_t miss_count = 0;
+  };
+
+  struct Statistics {
+    // Totals over all size classes.
+    int64_t hit_count = 0;
+    int64_t miss_count = 0;
+    // Allocations that bypassed the pool as they were larger than the largest
+    // size class or pooling is disabled. Not included in |miss_count|.
+    int64_t unpooled_count = 0;
+    // Released blocks returned to the system heap as the cache was full.
+    int64_t overflow_count = 0;
+    // Number of times cached blocks were trimmed, either explicitly or on idle.
+    int64_t trim_count = 0;
+    // Current and maximum total size of the cached blocks, in bytes.
+    size_t cached_bytes = 0;
+    size_t peak_cached_bytes = 0;
+    std::vector<SizeClassStatistics> size_classes;
+  };
+
+  explicit HostBufferPool(Options options);
+  ~HostBufferPool();
+
+  HostBufferPool(const HostBufferPool&) = delete;
+  HostBufferPool& operator=(const HostBufferPool&) = delete;
+
+  // Returns a block of at least |size| bytes with the first |size| bytes
+  // zeroed, or nullptr if the system heap is exhausted. The block must be
+  // returned with Release with the same |size|.
+  void* Acquire(size_t size);
+
+  // Returns a block acquired with Acquire(|size|) to the pool.
+  void Release(void* block, size_t size);
+
+  // Returns all cached blocks to the system heap.
+  void Trim();
+
+  // Returns a snapshot of the pool statistics.
+  Statistics statistics() const;
+
+ private:
+  struct SizeClass {
+    size_t block_size = 0;
+    std::atomic<int64_t> hit_count{0};
+    std::atomic<int64_t> miss_count{0};
+  };
+
+  // Blocks cached by a single thread. Shared between the pool and the thread
+  // so that either may outlive the other.
+  //
+  // Only the owning thread adds blocks but Trim and the destructor take them
+  // from other threads, so each slot is claimed with an atomic exchange
+  // rather than under a lock.
+  struct ThreadCache {
+    // |block_count| slots per size class, in size class order. Empty slots
+    // are nullptr.
+    int block_count = 0;
+    std::unique_ptr<std::atomic<void*>[]> slots;
+    // Set when the pool is destroyed; the thread drops the cache on its next
+    // lookup.
+    std::atomic<bool> is_orphaned{false};
+  };
+
+  // Returns the size class index for |size| or -1 if |size| is not pooled.
+  int SizeClassIndex(size_t size) const;
+
+  // Returns the cache of the calling thread, creating it if needed.
+  ThreadCache* GetThreadCache();
+
+  // Frees all blocks in |blocks| and returns their total size in bytes.
+  size_t FreeBlocks(std::vector<std::vector<void*>>* blocks);
+
+  // Frees all blocks in |thread_cache| and returns their total size in bytes.
+  size_t FreeThreadCacheBlocks(ThreadCache* thread_cache);
+
+  // Thread entry point trimming the pool when it goes idle.
+  void TrimThreadMain();
+
+  // Options with block sizes rounded up to powers of two.
+  const Options options_;
+  // Unique for the lifetime of the process; identifies the pool in the
+  // thread-local cache lists.
+  const uint64_t pool_id_;
+  int min_block_size_log2_ = 0;
+  std::unique_ptr<SizeClass[]> size_classes_;
+  int size_class_count_ = 0;
+
+  std::atomic<size_t> cached_bytes_{0};
+  std::atomic<size_t> peak_cached_bytes_{0};
+  std::atomic<int64_t> unpooled_count_{0};
+  std::atomic<int64_t> overflow_count_{0};
+  std::atomic<int64_t> trim_count_{0};
+  // Incremented on each allocation so that the trim thread can detect idling.
+  std::atomic<uint64_t> allocation_epoch_{0};
+
+  mutable absl::Mutex mutex_;
+  std::vector<std::vector<void*>> shared_blocks_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_
+      ABSL_GUARDED_BY(mutex_);
+
+  absl::Mutex trim_mutex_;
+  bool has_shutdown_ ABSL_GUARDED_BY(trim_mutex_) = false;
+  std::thread trim_thread_;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_HOST_BUFFER_POOL_H_
@@ -0,0 +1,54 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_buffer_pool_flags.h"
+
+#include "absl/flags/flag.h"
+#include "absl/time/time.h"
+
+ABSL_FLAG(int64_t, host_allocator_max_cached_bytes, 256 * 1024 * 1024,
+          "Maximum total size of the buffer memory cached by each host device "
+          "allocator. 0 disables caching.");
+ABSL_FLAG(int64_t, host_allocator_max_block_size, 64 * 1024 * 1024,
+          "Size of the largest buffer whose memory is cached by host device "
+          "allocators.");
+ABSL_FLAG(absl::Duration, host_allocator_idle_trim_delay, absl::Seconds(10),
+          "Time without allocations after which host device allocators "
+          "release their cached buffer memory. 0 disables trimming.");
+
+namespace iree {
+namespace hal {
+
+StatusOr<HostBufferPool::Options> GetHostBufferPoolOptionsFromFlags() {
+  HostBufferPool::Options options;
+  int64_t max_cached_bytes =
+      absl::GetFlag(FLAGS_host_allocator_max_cached_bytes);
+  int64_t max_block_size = absl::GetFlag(FLAGS_host_allocator_max_block_size);
+  absl::Duration idle_trim_delay =
+      absl::GetFlag(FLAGS_host_allocator_idle_trim_delay);
+  if (max_cached_bytes < 0 || max_block_size <= 0 ||
+      idle_trim_delay < absl::ZeroDuration()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Invalid host allocator flags; max_cached_bytes="
+           << max_cached_bytes << ", max_block_size=" << max_block_size
+           << ", idle_trim_delay=" << absl::FormatDuration(idle_trim_delay);
+  }
+  options.max_cached_bytes = static_cast<size_t>(max_cached_bytes);
+  options.max_block_size = static_cast<size_t>(max_block_size);
+  options.idle_trim_delay = idle_trim_delay;
+  return options;
+}
+
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,219 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_buffer_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+HostBufferPool::Options MakeOptions() {
+  HostBufferPool::Options options;
+  options.min_block_size = 256;
+  options.max_block_size = 64 * 1024;
+  options.max_cached_bytes = 1024 * 1024;
+  options.idle_trim_delay = absl::ZeroDuration();
+  return options;
+}
+
+bool IsZeroed(const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    if (bytes[i]) return false;
+  }
+  return true;
+}
+
+TEST(HostBufferPoolTest, ReusesReleasedBlocks) {
+  HostBufferPool pool(MakeOptions());
+  void* block = pool.Acquire(1000);
+  ASSERT_NE(nullptr, block);
+  EXPECT_TRUE(IsZeroed(block, 1000));
+  std::memset(block, 0xCD, 1000);
+  pool.Release(block, 1000);
+  EXPECT_EQ(1024, pool.statistics().cached_bytes);
+
+  // Any size in the same class reuses the block and it is zeroed again.
+  void* reused_block = pool.Acquire(600);
+  EXPECT_EQ(block, reused_block);
+  EXPECT_TRUE(IsZeroed(reused_block, 600));
+  pool.Release(reused_block, 600);
+
+  auto statistics = pool.statistics();
+  EXPECT_EQ(1, statistics.hit_count);
+  EXPECT_EQ(1, statistics.miss_count);
+  EXPECT_EQ(0, statistics.unpooled_count);
+  EXPECT_EQ(1024, statistics.peak_cached_bytes);
+}
+
+TEST(HostBufferPoolTest, SizeClasses) {
+  HostBufferPool pool(MakeOptions());
+  auto statistics = pool.statistics();
+  ASSERT_EQ(9, statistics.size_classes.size());
+  EXPECT_EQ(256, statistics.size_classes.front().block_size);
+  EXPECT_EQ(64 * 1024, statistics.size_classes.back().block_size);
+
+  // Blocks are only reused within their own class.
+  pool.Release(pool.Acquire(1), 1);
+  pool.Release(pool.Acquire(512), 512);
+  pool.Release(pool.Acquire(513), 513);
+  pool.Release(pool.Acquire(256), 256);
+  statistics = pool.statistics();
+  EXPECT_EQ(1, statistics.size_classes[0].hit_count);
+  EXPECT_EQ(1, statistics.size_classes[0].miss_count);
+  EXPECT_EQ(1, statistics.size_classes[1].miss_count);
+  EXPECT_EQ(1, statistics.size_classes[2].miss_count);
+  EXPECT_EQ(256 + 512 + 1024, statistics.cached_bytes);
+}
+
+TEST(HostBufferPoolTest, LargeAllocationsAreNotPooled) {
+  HostBufferPool pool(MakeOptions());
+  size_t size = 64 * 1024 + 1;
+  void* block = pool.Acquire(size);
+  ASSERT_NE(nullptr, block);
+  EXPECT_TRUE(IsZeroed(block, size));
+  pool.Release(block, size);
+  auto statistics = pool.statistics();
+  EXPECT_EQ(1, statistics.unpooled_count);
+  EXPECT_EQ(0, statistics.miss_count);
+  EXPECT_EQ(0, statistics.cached_bytes);
+}
+
+TEST(HostBufferPoolTest, DisabledPooling) {
+  auto options = MakeOptions();
+  options.max_cached_bytes = 0;
+  HostBufferPool pool(options);
+  pool.Release(pool.Acquire(1000), 1000);
+  auto statistics = pool.statistics();
+  EXPECT_EQ(1, statistics.unpooled_count);
+  EXPECT_EQ(0, statistics.cached_bytes);
+  EXPECT_TRUE(statistics.size_classes.empty());
+}
+
+TEST(HostBufferPoolTest, HighWaterMark) {
+  auto options = MakeOptions();
+  options.max_cached_bytes = 1024;
+  HostBufferPool pool(options);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 3; ++i) {
+    blocks.push_back(pool.Acquire(512));
+  }
+  for (void* block : blocks) {
+    pool.Release(block, 512);
+  }
+  auto statistics = pool.statistics();
+  EXPECT_EQ(1024, statistics.cached_bytes);
+  EXPECT_EQ(1, statistics.overflow_count);
+}
+
+TEST(HostBufferPoolTest, Trim) {
+  HostBufferPool pool(MakeOptions());
+  std::vector<void*> blocks;
+  for (int i = 0; i < 8; ++i) {
+    blocks.push_back(pool.Acquire(4096));
+  }
+  for (void* block : blocks) {
+    pool.Release(block, 4096);
+  }
+  EXPECT_EQ(8 * 4096, pool.statistics().cached_bytes);
+  pool.Trim();
+  auto statistics = pool.statistics();
+  EXPECT_EQ(0, statistics.cached_bytes);
+  EXPECT_EQ(1, statistics.trim_count);
+  pool.Release(pool.Acquire(4096), 4096);
+  EXPECT_EQ(9, pool.statistics().miss_count);
+}
+
+TEST(HostBufferPoolTest, TrimOnIdle) {
+  auto options = MakeOptions();
+  options.idle_trim_delay = absl::Milliseconds(10);
+  HostBufferPool pool(options);
+  pool.Release(pool.Acquire(4096), 4096);
+  absl::Time deadline = absl::Now() + absl::Seconds(10);
+  while (pool.statistics().cached_bytes > 0 && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  auto statistics = pool.statistics();
+  EXPECT_EQ(0, statistics.cached_bytes);
+  EXPECT_GE(statistics.trim_count, 1);
+}
+
+// Tests that blocks released on one thread beyond its own cache are reused by
+// other threads and that the caches of exited threads are freed on trim.
+TEST(HostBufferPoolTest, CrossThreadReuse) {
+  auto options = MakeOptions();
+  options.thread_cache_block_count = 2;
+  HostBufferPool pool(options);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 3; ++i) {
+    blocks.push_back(pool.Acquire(1024));
+  }
+  std::thread([&]() {
+    for (void* block : blocks) {
+      pool.Release(block, 1024);
+    }
+  }).join();
+
+  void* block = pool.Acquire(1024);
+  EXPECT_EQ(blocks.back(), block);
+  pool.Release(block, 1024);
+  auto statistics = pool.statistics();
+  EXPECT_EQ(1, statistics.hit_count);
+  EXPECT_EQ(3 * 1024, statistics.cached_bytes);
+
+  pool.Trim();
+  EXPECT_EQ(0, pool.statistics().cached_bytes);
+}
+
+// Tests that concurrent allocations from many threads keep the accounting
+// consistent.
+TEST(HostBufferPoolTest, ConcurrentAcquireRelease) {
+  HostBufferPool pool(MakeOptions());
+  constexpr int kThreadCount = 8;
+  constexpr int kIterationCount = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&pool, i]() {
+      for (int j = 0; j < kIterationCount; ++j) {
+        size_t size = 256 << ((i + j) % 4);
+        void* block = pool.Acquire(size);
+        std::memset(block, i, size);
+        pool.Release(block, size);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto statistics = pool.statistics();
+  EXPECT_EQ(kThreadCount * kIterationCount,
+            statistics.hit_count + statistics.miss_count);
+  EXPECT_LE(statistics.cached_bytes, 1024 * 1024);
+  pool.Trim();
+  EXPECT_EQ(0, pool.statistics().cached_bytes);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -20,6 +20,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
 namespace iree {
@@ -27,7 +28,11 @@ namespace hal {
 
 HostFence::HostFence(uint64_t initial_value) : value_(initial_value) {}
 
-HostFence::~HostFence() = default;
+HostFence::~HostFence() {
+  // Wake anyone still waiting on handles; they'll outlive us.
+  absl::MutexLock lock(&mutex_);
+  SetWaiters(UINT64_MAX);
+}
 
 Status HostFence::status() const {
   absl::MutexLock lock(&mutex_);
@@ -43,10 +48,16 @@ Status HostFence::Signal(uint64_t value) {
   if (!status_.ok()) {
     return status_;
   }
-  if (value_.exchange(value) >= value) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Fence values must be monotonically increasing";
-  }
+  uint64_t current_value = value_.load(std::memory_order_acquire);
+  do {
+    if (current_value >= value) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Fence values must be monotonically increasing";
+    }
+  } while (!value_.compare_exchange_weak(current_value, value,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire));
+  SetWaiters(value);
   return OkStatus();
 }
 
@@ -54,9 +65,42 @@ Status HostFence::Fail(Status status) {
   absl::MutexLock lock(&mutex_);
   status_ = status;
   value_.store(UINT64_MAX, std::memory_order_release);
+  SetWaiters(UINT64_MAX);
   return OkStatus();
 }
 
+WaitHandle HostFence::OnValue(uint64_t value) {
+  absl::MutexLock lock(&mutex_);
+  if (value_.load(std::memory_order_acquire) >= value) {
+    auto event = make_ref<ManualResetEvent>();
+    event->Set().IgnoreError();
+    return event->OnSet();
+  }
+
+  // Share the event with any other waiters for the same value. This keeps
+  // callers repeatedly waiting with short deadlines (such as WaitForFences)
+  // from growing the waiter list.
+  for (auto& waiter : waiters_) {
+    if (waiter.first == value) return waiter.second->OnSet();
+  }
+  auto event = make_ref<ManualResetEvent>();
+  auto wait_handle = event->OnSet();
+  waiters_.push_back({value, std::move(event)});
+  return wait_handle;
+}
+
+void HostFence::SetWaiters(uint64_t value) {
+  for (size_t i = 0; i < waiters_.size();) {
+    if (waiters_[i].first <= value) {
+      waiters_[i].second->Set().IgnoreError();
+      waiters_[i] = std::move(waiters_.back());
+      waiters_.pop_back();
+    } else {
+      ++i;
+    }
+  }
+}
+
 // static
 Status HostFence::WaitForFences(absl::Span<const FenceValue> fences,
                                 bool wait_all, absl::Time deadline) {
@@ -79,11 +123,40 @@ Status HostFence::WaitForFences(absl::Span<const FenceValue> fences,
     }
   }
 
+  if (waitable_fences.empty()) {
+    // All fences already reached their values.
+    return OkStatus();
+  }
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+  if (!wait_all) {
+    if (waitable_fences.size() < fences.size()) {
+      // At least one fence has already reached its value.
+      return OkStatus();
+    }
+
+    // Wait on fd-backed handles for each fence so that we wake on whichever
+    // fence reaches its value first.
+    absl::InlinedVector<WaitHandle, 4> wait_handles;
+    absl::InlinedVector<WaitHandle*, 4> wait_handle_ptrs;
+    wait_handles.reserve(waitable_fences.size());
+    for (auto& fence_value : waitable_fences) {
+      wait_handles.push_back(fence_value.first->OnValue(fence_value.second));
+    }
+    for (auto& wait_handle : wait_handles) {
+      wait_handle_ptrs.push_back(&wait_handle);
+    }
+    ASSIGN_OR_RETURN(int signaled_index,
+                     WaitHandle::WaitAny(wait_handle_ptrs, deadline));
+    return waitable_fences[signaled_index].first->status();
+  }
+#endif  // !IREE_PLATFORM_WINDOWS
+
   // TODO(benvanik): maybe sort fences by value in case we are waiting on
   // multiple values from the same fence.
 
   // Loop over the fences and wait for them to complete.
-  // TODO(b/140026716): add WaitHandle support for !wait_all (wait any).
+  // TODO(b/140026716): port WaitHandle to win32 for !wait_all (wait any).
   for (auto& fence_value : waitable_fences) {
     auto* fence = fence_value.first;
     absl::MutexLock lock(&fence->mutex_);
@@ -17,19 +17,27 @@
 
 #include <atomic>
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
+#include "iree/base/ref_ptr.h"
 #include "iree/base/status.h"
+#include "iree/base/wait_handle.h"
 #include "iree/hal/fence.h"
 
 namespace iree {
 namespace hal {
 
-// TODO(b/140026716): add WaitHandle support for better multi-wait.
 // Simple host-only fence semaphore implemented with a mutex.
 //
+// Waits for specific values may also be performed on WaitHandles (see OnValue)
+// backed by file descriptors (eventfds where available). These can be waited
+// on with WaitHandle::WaitAny or have their fds registered with an external
+// event loop so that a single thread can multiplex fences with other I/O.
+//
 // Thread-safe (as instances may be imported and used by others).
 class HostFence final : public Fence {
  public:
@@ -46,6 +54,16 @@ class HostFence final : public Fence {
   Status Signal(uint64_t value);
   Status Fail(Status status);
 
+  // Returns a WaitHandle that is signaled once the fence reaches |value|. The
+  // handle is also signaled if the fence fails or is destroyed; query status()
+  // to distinguish the failure case. Handles for the same value share a single
+  // event that is created on first use and released once signaled.
+  //
+  // The fd of the handle, as returned by WaitableObject::AcquireFdForWait on
+  // handle.object(), becomes readable when signaled and can be polled
+  // alongside other fds (such as sockets).
+  WaitHandle OnValue(uint64_t value);
+
  private:
   // The mutex is not required to query the value; this lets us quickly check if
   // a required value has been exceeded. The mutex is only used to update and
@@ -56,6 +74,16 @@ class HostFence final : public Fence {
   // changes.
   mutable absl::Mutex mutex_;
   Status status_ ABSL_GUARDED_BY(mutex_);
+
+  // Sets the events of all waiters for values at or below |value| and removes
+  // them from the waiter list.
+  void SetWaiters(uint64_t value) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Events backing the handles returned by OnValue that have not yet been set,
+  // paired with the value they are waiting for. There is at most one event per
+  // value.
+  std::vector<std::pair<uint64_t, ref_ptr<ManualResetEvent>>> waiters_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace hal
@@ -17,9 +17,11 @@
 #include <cstdint>
 #include <thread>  // NOLINT
 
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "iree/base/status.h"
 #include "iree/base/status_matchers.h"
+#include "iree/base/wait_handle.h"
 #include "iree/testing/gtest.h"
 
 namespace iree {
@@ -142,6 +144,87 @@ TEST(HostFenceTest, FailNotifies) {
   ASSERT_TRUE(got_failure);
 }
 
+// Tests that WaitForFences with !wait_all wakes on the first fence to reach
+// its value.
+TEST(HostFenceTest, WaitAny) {
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  EXPECT_TRUE(IsDeadlineExceeded(
+      HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                               /*wait_all=*/false, absl::InfinitePast())));
+  std::thread thread([&]() {
+    absl::SleepFor(absl::Milliseconds(10));
+    ASSERT_OK(fence_1.Signal(1u));
+  });
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/false,
+                                     absl::InfiniteFuture()));
+  thread.join();
+  EXPECT_EQ(0u, fence_0.QueryValue().value());
+
+  // Already reached values return immediately.
+  ASSERT_OK(HostFence::WaitForFences({{&fence_0, 1u}, {&fence_1, 1u}},
+                                     /*wait_all=*/false, absl::InfinitePast()));
+}
+
+// Tests that wait handles are signaled when the fence reaches their value.
+TEST(HostFenceTest, OnValue) {
+  HostFence fence(1u);
+  WaitHandle reached_handle = fence.OnValue(1u);
+  ASSERT_OK_AND_ASSIGN(bool reached, reached_handle.TryWait());
+  EXPECT_TRUE(reached);
+
+  WaitHandle wait_handle_2 = fence.OnValue(2u);
+  WaitHandle wait_handle_3 = fence.OnValue(3u);
+  ASSERT_OK_AND_ASSIGN(bool signaled_2, wait_handle_2.TryWait());
+  EXPECT_FALSE(signaled_2);
+
+  // The handles can be waited on as fds by external pollers.
+  ASSERT_OK_AND_ASSIGN(
+      auto fd_info,
+      wait_handle_2.object()->AcquireFdForWait(absl::InfinitePast()));
+  EXPECT_GE(fd_info.second, 0);
+
+  ASSERT_OK(fence.Signal(2u));
+  ASSERT_OK(wait_handle_2.Wait(absl::InfiniteFuture()));
+  ASSERT_OK_AND_ASSIGN(bool signaled_3, wait_handle_3.TryWait());
+  EXPECT_FALSE(signaled_3);
+
+  // Failure wakes the remaining waiters.
+  ASSERT_OK(fence.Fail(UnknownErrorBuilder(IREE_LOC)));
+  ASSERT_OK(wait_handle_3.Wait(absl::InfiniteFuture()));
+  EXPECT_TRUE(IsUnknown(fence.status()));
+}
+
+// Tests that handles waiting on the same value share an event.
+TEST(HostFenceTest, OnValueSharesEvents) {
+  HostFence fence(0u);
+  WaitHandle wait_handle_a = fence.OnValue(1u);
+  WaitHandle wait_handle_b = fence.OnValue(1u);
+  WaitHandle wait_handle_c = fence.OnValue(2u);
+  EXPECT_EQ(wait_handle_a.object(), wait_handle_b.object());
+  EXPECT_NE(wait_handle_a.object(), wait_handle_c.object());
+
+  // Timed out waits don't leave anything behind that prevents waking.
+  EXPECT_TRUE(IsDeadlineExceeded(HostFence::WaitForFences(
+      {{&fence, 1u}, {&fence, 2u}}, /*wait_all=*/false, absl::InfinitePast())));
+  ASSERT_OK(fence.Signal(1u));
+  ASSERT_OK(wait_handle_a.Wait(absl::InfiniteFuture()));
+  ASSERT_OK(wait_handle_b.Wait(absl::InfiniteFuture()));
+  ASSERT_OK_AND_ASSIGN(bool signaled_c, wait_handle_c.TryWait());
+  EXPECT_FALSE(signaled_c);
+}
+
+// Tests that handles outliving their fence are signaled.
+TEST(HostFenceTest, OnValueOutlivesFence) {
+  WaitHandle wait_handle;
+  {
+    HostFence fence(0u);
+    wait_handle = fence.OnValue(1u);
+  }
+  ASSERT_OK(wait_handle.Wait(absl::InfiniteFuture()));
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -14,7 +14,7 @@
 
 #include "iree/hal/host/host_local_allocator.h"
 
-#include <cstdlib>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -26,7 +26,33 @@
 namespace iree {
 namespace hal {
 
-HostLocalAllocator::HostLocalAllocator() = default;
+namespace {
+
+// A HostBuffer whose memory is returned to a HostBufferPool when released.
+class PooledHostBuffer final : public HostBuffer {
+ public:
+  PooledHostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+                   BufferUsageBitfield usage, device_size_t allocation_size,
+                   void* data, std::shared_ptr<HostBufferPool> pool)
+      : HostBuffer(allocator, memory_type, MemoryAccess::kAll, usage,
+                   allocation_size, data, /*owns_data=*/false),
+        pool_(std::move(pool)) {}
+
+  ~PooledHostBuffer() override {
+    pool_->Release(mutable_data(), allocation_size());
+  }
+
+ private:
+  std::shared_ptr<HostBufferPool> pool_;
+};
+
+}  // namespace
+
+HostLocalAllocator::HostLocalAllocator()
+    : HostLocalAllocator(HostBufferPool::Options{}) {}
+
+HostLocalAllocator::HostLocalAllocator(HostBufferPool::Options pool_options)
+    : pool_(std::make_shared<HostBufferPool>(std::move(pool_options))) {}
 
 HostLocalAllocator::~HostLocalAllocator() = default;
 
@@ -95,17 +121,22 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
   // Make compatible with our requirements.
   RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
 
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
+  void* data = pool_->Acquire(allocation_size);
+  if (!data) {
     return ResourceExhaustedErrorBuilder(IREE_LOC)
            << "Failed to malloc " << allocation_size << " bytes";
   }
 
-  auto buffer =
-      make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
+  auto buffer = make_ref<PooledHostBuffer>(
+      this, memory_type, buffer_usage, allocation_size, data, pool_);
   return buffer;
 }
 
+void HostLocalAllocator::Trim() { pool_->Trim(); }
+
+HostBufferPool::Statistics HostLocalAllocator::pool_statistics() const {
+  return pool_->statistics();
+}
+
 }  // namespace hal
 }  // namespace iree
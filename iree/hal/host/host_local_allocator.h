@@ -21,6 +21,7 @@
 #include "iree/base/status.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
+#include "iree/hal/host/host_buffer_pool.h"
 
 namespace iree {
 namespace hal {
@@ -32,9 +33,14 @@ namespace hal {
 // the 'device' in the case of a host-local queue *is* the host. To keep code
 // written initially for a host-local queue working when other queues are used
 // the allocator only works with buffers that are kDeviceVisible.
+//
+// Buffer memory is cached in a HostBufferPool so that the transient buffers
+// allocated and released for each invocation do not hit the system heap. The
+// pool may outlive the allocator as it is retained by the buffers it backs.
 class HostLocalAllocator : public Allocator {
  public:
   HostLocalAllocator();
+  explicit HostLocalAllocator(HostBufferPool::Options pool_options);
   ~HostLocalAllocator() override;
 
   bool CanUseBufferLike(Allocator* source_allocator,
@@ -52,6 +58,15 @@ class HostLocalAllocator : public Allocator {
   StatusOr<ref_ptr<Buffer>> Allocate(MemoryTypeBitfield memory_type,
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
+
+  // Returns all memory cached by the allocator to the system heap.
+  void Trim();
+
+  // Returns the hit and miss statistics of the buffer memory pool.
+  HostBufferPool::Statistics pool_statistics() const;
+
+ private:
+  std::shared_ptr<HostBufferPool> pool_;
 };
 
 }  // namespace hal
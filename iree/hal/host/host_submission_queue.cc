@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <utility>
 
 #include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
@@ -88,8 +89,125 @@ Status HostBinarySemaphore::EndWaiting() {
   return OkStatus();
 }
 
+HostTimelineSemaphore::HostTimelineSemaphore(uint64_t initial_value)
+    : value_(initial_value) {}
+
+HostTimelineSemaphore::~HostTimelineSemaphore() = default;
+
+bool HostTimelineSemaphore::has_reached(uint64_t value) const {
+  return value_.load(std::memory_order_acquire) >= value;
+}
+
+Status HostTimelineSemaphore::status() const {
+  absl::MutexLock lock(&mutex_);
+  return status_;
+}
+
+StatusOr<uint64_t> HostTimelineSemaphore::QueryValue() {
+  return value_.load(std::memory_order_acquire);
+}
+
+Status HostTimelineSemaphore::Signal(uint64_t value) {
+  IREE_TRACE_SCOPE0("HostTimelineSemaphore::Signal");
+  std::vector<NotifyFn> ready_notifications;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (value_.load(std::memory_order_acquire) >= value) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Timeline semaphore values must be monotonically increasing";
+    }
+    ready_notifications = SetValue(value);
+  }
+  for (auto& notify_fn : ready_notifications) {
+    notify_fn();
+  }
+  return OkStatus();
+}
+
+Status HostTimelineSemaphore::AdvanceTo(uint64_t value) {
+  std::vector<NotifyFn> ready_notifications;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!status_.ok()) {
+      return status_;
+    }
+    if (value_.load(std::memory_order_acquire) >= value) {
+      return OkStatus();
+    }
+    ready_notifications = SetValue(value);
+  }
+  for (auto& notify_fn : ready_notifications) {
+    notify_fn();
+  }
+  return OkStatus();
+}
+
+Status HostTimelineSemaphore::Fail(Status status) {
+  std::vector<NotifyFn> ready_notifications;
+  {
+    absl::MutexLock lock(&mutex_);
+    status_ = std::move(status);
+    ready_notifications = SetValue(UINT64_MAX);
+  }
+  for (auto& notify_fn : ready_notifications) {
+    notify_fn();
+  }
+  return OkStatus();
+}
+
+Status HostTimelineSemaphore::Wait(uint64_t value, absl::Time deadline) {
+  IREE_TRACE_SCOPE0("HostTimelineSemaphore::Wait");
+  using WaitPoint = std::pair<HostTimelineSemaphore*, uint64_t>;
+  WaitPoint wait_point = {this, value};
+  absl::MutexLock lock(&mutex_);
+  if (!mutex_.AwaitWithDeadline(
+          absl::Condition(
+              +[](WaitPoint* wait_point) {
+                return wait_point->first->has_reached(wait_point->second);
+              },
+              &wait_point),
+          deadline)) {
+    return DeadlineExceededErrorBuilder(IREE_LOC)
+           << "Deadline exceeded waiting for timeline semaphore";
+  }
+  return status_;
+}
+
+void HostTimelineSemaphore::NotifyAt(uint64_t value, NotifyFn notify_fn) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!has_reached(value)) {
+      notifications_.push_back({value, std::move(notify_fn)});
+      return;
+    }
+  }
+  notify_fn();
+}
+
+std::vector<HostTimelineSemaphore::NotifyFn> HostTimelineSemaphore::SetValue(
+    uint64_t value) {
+  value_.store(value, std::memory_order_release);
+  std::vector<NotifyFn> ready_notifications;
+  for (size_t i = 0; i < notifications_.size();) {
+    if (notifications_[i].first <= value) {
+      ready_notifications.push_back(std::move(notifications_[i].second));
+      notifications_[i] = std::move(notifications_.back());
+      notifications_.pop_back();
+    } else {
+      ++i;
+    }
+  }
+  return ready_notifications;
+}
+
 HostSubmissionQueue::HostSubmissionQueue() = default;
 
+HostSubmissionQueue::HostSubmissionQueue(WakeFn wake_fn)
+    : wake_fn_(std::move(wake_fn)) {}
+
 HostSubmissionQueue::~HostSubmissionQueue() = default;
 
 bool HostSubmissionQueue::IsBatchReady(const PendingBatch& batch) const {
@@ -101,13 +219,50 @@ bool HostSubmissionQueue::IsBatchReady(const PendingBatch& batch) const {
         return false;
       }
     } else {
-      // TODO(b/140141417): implement timeline semaphores.
-      return false;
+      auto& timeline_value = absl::get<1>(wait_point);
+      auto* timeline_semaphore =
+          static_cast<HostTimelineSemaphore*>(timeline_value.first);
+      if (!timeline_semaphore->has_reached(timeline_value.second)) {
+        return false;
+      }
     }
   }
   return true;
 }
 
+Status HostSubmissionQueue::EndWaiting(const PendingBatch& batch) {
+  for (auto& wait_point : batch.wait_semaphores) {
+    if (wait_point.index() == 0) {
+      auto* binary_semaphore =
+          reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(wait_point));
+      RETURN_IF_ERROR(binary_semaphore->EndWaiting());
+    } else {
+      // Timeline waits don't consume anything; we only need to propagate
+      // failures of the semaphore.
+      auto* timeline_semaphore =
+          static_cast<HostTimelineSemaphore*>(absl::get<1>(wait_point).first);
+      RETURN_IF_ERROR(timeline_semaphore->status());
+    }
+  }
+  return OkStatus();
+}
+
+Status HostSubmissionQueue::SignalSemaphores(const ReadyBatch& batch) {
+  for (auto& semaphore_value : batch.signal_semaphores) {
+    if (semaphore_value.index() == 0) {
+      auto* binary_semaphore = reinterpret_cast<HostBinarySemaphore*>(
+          absl::get<0>(semaphore_value));
+      RETURN_IF_ERROR(binary_semaphore->EndSignaling());
+    } else {
+      auto& timeline_value = absl::get<1>(semaphore_value);
+      auto* timeline_semaphore =
+          static_cast<HostTimelineSemaphore*>(timeline_value.first);
+      RETURN_IF_ERROR(timeline_semaphore->AdvanceTo(timeline_value.second));
+    }
+  }
+  return OkStatus();
+}
+
 Status HostSubmissionQueue::Enqueue(absl::Span<const SubmissionBatch> batches,
                                     FenceValue fence) {
   IREE_TRACE_SCOPE0("HostSubmissionQueue::Enqueue");
@@ -119,18 +274,16 @@ Status HostSubmissionQueue::Enqueue(absl::Span<const SubmissionBatch> batches,
     return permanent_error_;
   }
 
-  // Verify waiting/signaling behavior on semaphores and prepare them all.
-  // We need to track this to ensure that we are modeling the Vulkan behavior
-  // and are consistent across HAL implementations.
+  // Verify waiting/signaling behavior on binary semaphores and prepare them
+  // all. We need to track this to ensure that we are modeling the Vulkan
+  // behavior and are consistent across HAL implementations. Timeline
+  // semaphores may be waited on and signaled any number of times.
   for (auto& batch : batches) {
     for (auto& semaphore_value : batch.wait_semaphores) {
       if (semaphore_value.index() == 0) {
         auto* binary_semaphore = reinterpret_cast<HostBinarySemaphore*>(
             absl::get<0>(semaphore_value));
         RETURN_IF_ERROR(binary_semaphore->BeginWaiting());
-      } else {
-        // TODO(b/140141417): implement timeline semaphores.
-        return UnimplementedErrorBuilder(IREE_LOC) << "Timeline semaphores NYI";
       }
     }
     for (auto& semaphore_value : batch.signal_semaphores) {
@@ -138,9 +291,22 @@ Status HostSubmissionQueue::Enqueue(absl::Span<const SubmissionBatch> batches,
         auto* binary_semaphore = reinterpret_cast<HostBinarySemaphore*>(
             absl::get<0>(semaphore_value));
         RETURN_IF_ERROR(binary_semaphore->BeginSignaling());
-      } else {
-        // TODO(b/140141417): implement timeline semaphores.
-        return UnimplementedErrorBuilder(IREE_LOC) << "Timeline semaphores NYI";
+      }
+    }
+  }
+
+  // Ask to be woken when the timeline values we wait on are reached as they
+  // may be signaled from outside of this queue.
+  if (wake_fn_) {
+    for (auto& batch : batches) {
+      for (auto& semaphore_value : batch.wait_semaphores) {
+        if (semaphore_value.index() != 1) continue;
+        auto& timeline_value = absl::get<1>(semaphore_value);
+        auto* timeline_semaphore =
+            static_cast<HostTimelineSemaphore*>(timeline_value.first);
+        if (!timeline_semaphore->has_reached(timeline_value.second)) {
+          timeline_semaphore->NotifyAt(timeline_value.second, wake_fn_);
+        }
       }
     }
   }
@@ -170,91 +336,105 @@ Status HostSubmissionQueue::ProcessBatches(ExecuteFn execute_fn) {
     return permanent_error_;
   }
 
-  // Repeated try to run things until we quiesce or are blocked.
-  while (permanent_error_.ok() && !list_.empty()) {
-    // NOTE: to support re-entrancy where |execute_fn| may modify the submission
-    // list we need to always start from the beginning. If we wanted we could
-    // track a list of ready submissions however that's a lot of bookkeeping and
-    // the list is usually short.
-    bool restart_iteration = false;
-    for (auto* submission : list_) {
-      for (int i = 0; i < submission->pending_batches.size(); ++i) {
-        auto& batch = submission->pending_batches[i];
-        if (!IsBatchReady(batch)) {
-          // Try the next batch in the submission until we find one that is
-          // ready. If none are ready we'll return to the caller.
-          continue;
-        }
+  // Repeatedly try to run things until we quiesce or are blocked. Retiring a
+  // batch may make batches of earlier submissions ready and since we want to
+  // preserve submission order AcquireReadyBatch always starts from the first
+  // submission.
+  ReadyBatch batch;
+  while (AcquireReadyBatch(&batch)) {
+    auto batch_status = execute_fn(batch.command_buffers);
+    RETURN_IF_ERROR(RetireBatch(batch, std::move(batch_status)));
+  }
 
-        // Batch can run! Process now and remove it from the list so we don't
-        // try to run it again.
-        auto batch_status = ProcessBatch(batch, execute_fn);
-        submission->pending_batches.erase(submission->pending_batches.begin() +
-                                          i);
-        if (batch_status.ok()) {
-          // Batch succeeded. Since we want to preserve submission order we'll
-          // break out of the loop and try from the first submission again.
-          if (submission->pending_batches.empty()) {
-            // All work for this submission completed successfully. Signal the
-            // fence and remove the submission from the list.
-            RETURN_IF_ERROR(CompleteSubmission(submission, OkStatus()));
-            list_.take(submission).reset();
-          }
-        } else {
-          // Batch failed; set the permanent error flag and abort so we don't
-          // try to process anything else.
-          permanent_error_ = batch_status;
-          RETURN_IF_ERROR(CompleteSubmission(submission, batch_status));
-          list_.take(submission).reset();
-        }
-        restart_iteration = true;
-        break;
+  return permanent_error_;
+}
+
+bool HostSubmissionQueue::AcquireReadyBatch(ReadyBatch* out_batch) {
+  IREE_TRACE_SCOPE0("HostSubmissionQueue::AcquireReadyBatch");
+
+  if (!permanent_error_.ok()) return false;
+
+  for (auto* submission : list_) {
+    auto& pending_batches = submission->pending_batches;
+    for (size_t i = 0; i < pending_batches.size(); ++i) {
+      auto& batch = pending_batches[i];
+      if (!IsBatchReady(batch)) {
+        // Try the next batch in the submission until we find one that is
+        // ready. If none are ready we'll return to the caller.
+        continue;
       }
-      if (restart_iteration) break;
+
+      // Complete the waits on all semaphores and reset them.
+      auto wait_status = EndWaiting(batch);
+      if (!wait_status.ok()) {
+        // The batch can never run; fail everything as if it had.
+        permanent_error_ = std::move(wait_status);
+        FailAllPending(permanent_error_);
+        return false;
+      }
+
+      // Batch can run! Hand it to the caller and remove it from the list so
+      // we don't try to run it again.
+      out_batch->command_buffers = std::move(batch.command_buffers);
+      out_batch->signal_semaphores = std::move(batch.signal_semaphores);
+      out_batch->submission = submission;
+      pending_batches.erase(pending_batches.begin() + i);
+      ++submission->in_flight_count;
+      ++in_flight_count_;
+      return true;
     }
   }
+  return false;
+}
+
+Status HostSubmissionQueue::RetireBatch(const ReadyBatch& batch,
+                                        Status status) {
+  IREE_TRACE_SCOPE0("HostSubmissionQueue::RetireBatch");
+
+  auto* submission = batch.submission;
+  --submission->in_flight_count;
+  --in_flight_count_;
 
+  if (status.ok() && permanent_error_.ok()) {
+    // Signal all semaphores to allow them to unblock waiters.
+    status = SignalSemaphores(batch);
+  }
+
+  if (!status.ok() && permanent_error_.ok()) {
+    // Batch failed; set the permanent error flag so we don't try to process
+    // anything else.
+    permanent_error_ = std::move(status);
+  }
   if (!permanent_error_.ok()) {
-    // If the sticky error got set while processing we need to abort all
-    // remaining submissions (simulating a device loss).
+    // Abort all remaining submissions (simulating a device loss). This
+    // includes the submission of |batch| if nothing else of it is in flight.
+    FailTimelineSemaphores(batch.signal_semaphores, permanent_error_);
     FailAllPending(permanent_error_);
     return permanent_error_;
   }
 
-  return OkStatus();
-}
-
-Status HostSubmissionQueue::ProcessBatch(const PendingBatch& batch,
-                                         const ExecuteFn& execute_fn) {
-  IREE_TRACE_SCOPE0("HostSubmissionQueue::ProcessBatch");
-
-  // Complete the waits on all semaphores and reset them.
-  for (auto& semaphore_value : batch.wait_semaphores) {
-    if (semaphore_value.index() == 0) {
-      auto* binary_semaphore =
-          reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(semaphore_value));
-      RETURN_IF_ERROR(binary_semaphore->EndWaiting());
-    } else {
-      // TODO(b/140141417): implement timeline semaphores.
-      return UnimplementedErrorBuilder(IREE_LOC) << "Timeline semaphores NYI";
+  if (submission->pending_batches.empty() &&
+      submission->in_flight_count == 0) {
+    // All work for this submission completed successfully. Its fence is
+    // signaled once all submissions before it have completed as well.
+    submission->completed = true;
+    auto complete_status = CompleteReadySubmissions();
+    if (!complete_status.ok()) {
+      permanent_error_ = std::move(complete_status);
+      FailAllPending(permanent_error_);
+      return permanent_error_;
     }
   }
+  return OkStatus();
+}
 
-  // Let the caller handle execution of the command buffers.
-  RETURN_IF_ERROR(execute_fn(batch.command_buffers));
-
-  // Signal all semaphores to allow them to unblock waiters.
-  for (auto& semaphore_value : batch.signal_semaphores) {
-    if (semaphore_value.index() == 0) {
-      auto* binary_semaphore =
-          reinterpret_cast<HostBinarySemaphore*>(absl::get<0>(semaphore_value));
-      RETURN_IF_ERROR(binary_semaphore->EndSignaling());
-    } else {
-      // TODO(b/140141417): implement timeline semaphores.
-      return UnimplementedErrorBuilder(IREE_LOC) << "Timeline semaphores NYI";
-    }
+Status HostSubmissionQueue::CompleteReadySubmissions() {
+  while (!list_.empty() && list_.front()->completed) {
+    auto* submission = list_.front();
+    auto complete_status = CompleteSubmission(submission, OkStatus());
+    list_.take(submission).reset();
+    RETURN_IF_ERROR(complete_status);
   }
-
   return OkStatus();
 }
 
@@ -279,10 +459,28 @@ Status HostSubmissionQueue::CompleteSubmission(Submission* submission,
 
 void HostSubmissionQueue::FailAllPending(Status status) {
   IREE_TRACE_SCOPE0("HostSubmissionQueue::FailAllPending");
-  while (!list_.empty()) {
-    auto submission = list_.take(list_.front());
-    CompleteSubmission(submission.get(), status).IgnoreError();
-    submission.reset();
+  auto* submission = list_.front();
+  while (submission) {
+    auto* next_submission = list_.next(submission);
+    for (auto& batch : submission->pending_batches) {
+      FailTimelineSemaphores(batch.signal_semaphores, status);
+    }
+    submission->pending_batches.clear();
+    if (submission->in_flight_count == 0) {
+      CompleteSubmission(submission, status).IgnoreError();
+      list_.take(submission).reset();
+    }
+    submission = next_submission;
+  }
+}
+
+void HostSubmissionQueue::FailTimelineSemaphores(
+    absl::Span<const SemaphoreValue> semaphore_values, const Status& status) {
+  for (auto& semaphore_value : semaphore_values) {
+    if (semaphore_value.index() != 1) continue;
+    auto* timeline_semaphore = static_cast<HostTimelineSemaphore*>(
+        absl::get<1>(semaphore_value).first);
+    timeline_semaphore->Fail(status).IgnoreError();
   }
 }
 
@@ -15,6 +15,12 @@
 #ifndef IREE_HAL_HOST_HOST_SUBMISSION_QUEUE_H_
 #define IREE_HAL_HOST_HOST_SUBMISSION_QUEUE_H_
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
@@ -67,17 +73,79 @@ class HostBinarySemaphore final : public BinarySemaphore {
 };
 
 // Simple host-only timeline semaphore implemented with a mutex.
+// Batches waiting on a payload value become ready as soon as the semaphore is
+// signaled to (or beyond) that value, regardless of which queue (or the host)
+// signaled it.
+//
+// Like HostFence a failed semaphore has its payload set to UINT64_MAX so that
+// all waiters wake and observe the failure status.
 //
 // Thread-safe (as instances may be imported and used by others).
 class HostTimelineSemaphore final : public TimelineSemaphore {
  public:
-  // TODO(b/140141417): implement timeline semaphores.
+  using NotifyFn = std::function<void()>;
+
+  explicit HostTimelineSemaphore(uint64_t initial_value);
+  ~HostTimelineSemaphore() override;
+
+  // Returns true if the payload is greater-than or equal-to |value|, which is
+  // always the case once the semaphore has failed.
+  bool has_reached(uint64_t value) const;
+
+  // Returns a permanent failure status if the semaphore has failed.
+  Status status() const;
+
+  StatusOr<uint64_t> QueryValue() override;
+  Status Signal(uint64_t value) override;
+  Status Wait(uint64_t value, absl::Time deadline) override;
+
+  // Sets the semaphore to a permanently failed state with |status|, waking
+  // all waiters.
+  Status Fail(Status status);
+
+  // Calls |notify_fn| once the payload is greater-than or equal-to |value| or
+  // the semaphore fails. If the value has already been reached |notify_fn| is
+  // called immediately on the calling thread; otherwise it is called on the
+  // thread signaling the semaphore. No semaphore locks are held during the
+  // call but the signaler may hold its own locks and |notify_fn| must not
+  // block on them.
+  void NotifyAt(uint64_t value, NotifyFn notify_fn);
+
+ private:
+  friend class HostSubmissionQueue;
+
+  // Advances the payload to |value| on behalf of a queue batch. Batches
+  // without dependencies between them may retire out of order so values at or
+  // below the current payload are ignored instead of treated as errors.
+  Status AdvanceTo(uint64_t value);
+
+  // Updates the payload and returns the notifications that are now ready.
+  // Callers must issue them after releasing |mutex_|.
+  std::vector<NotifyFn> SetValue(uint64_t value)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // The mutex is not required to query the value; this lets us quickly check if
+  // a required value has been reached. The mutex is only used to update and
+  // notify waiters.
+  std::atomic<uint64_t> value_{0};
+
+  mutable absl::Mutex mutex_;
+  Status status_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::pair<uint64_t, NotifyFn>> notifications_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 // A queue managing CommandQueue submissions that uses host-local
 // synchronization primitives. Evaluates submission order by respecting the
 // wait and signal semaphores defined per batch and notifies fences upon
-// submission completion.
+// submission completion. Fences are always signaled in submission order even
+// if the batches of later submissions complete first.
+//
+// Batches may either be processed serially with ProcessBatches or claimed
+// with AcquireReadyBatch and executed concurrently by the caller, retiring
+// each with RetireBatch once complete. Batches without dependencies between
+// them (including those from different submissions) may be in flight at the
+// same time.
 //
 // Note that it's possible for HAL users to deadlock themselves; we don't try to
 // avoid that as in device backends it may not be possible and we want to have
@@ -85,15 +153,39 @@ class HostTimelineSemaphore final : public TimelineSemaphore {
 //
 // Thread-compatible. Const methods may be called from any thread.
 class HostSubmissionQueue {
+ private:
+  struct Submission;
+
  public:
   using ExecuteFn =
       std::function<Status(absl::Span<CommandBuffer* const> command_buffers)>;
 
+  // Called when a timeline semaphore that a pending batch is waiting on
+  // reaches the waited value and batches may have become ready. See
+  // HostTimelineSemaphore::NotifyAt for the restrictions on what it may do.
+  using WakeFn = std::function<void()>;
+
+  // A batch claimed for execution with AcquireReadyBatch.
+  struct ReadyBatch {
+    // Command buffers to execute, in order.
+    absl::InlinedVector<CommandBuffer*, 4> command_buffers;
+    // Semaphores to signal once the command buffers have executed.
+    absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
+    // Submission the batch was part of.
+    Submission* submission = nullptr;
+  };
+
   HostSubmissionQueue();
+  // Creates a queue that calls |wake_fn| when timeline semaphores waited on by
+  // its batches are signaled (by this queue, another queue, or the host).
+  explicit HostSubmissionQueue(WakeFn wake_fn);
   ~HostSubmissionQueue();
 
-  // Returns true if the queue is currently empty.
+  // Returns true if the queue is currently empty, including batches that are
+  // in flight.
   bool empty() const { return list_.empty(); }
+  // Returns the number of batches acquired and not yet retired.
+  int in_flight_count() const { return in_flight_count_; }
   // Returns true if SignalShutdown has been called.
   bool has_shutdown() const { return has_shutdown_; }
   // The sticky error status, if an error has occurred.
@@ -112,6 +204,22 @@ class HostSubmissionQueue {
   // aborted, the permanent_error() is set, and the queue is shutdown.
   Status ProcessBatches(ExecuteFn execute_fn);
 
+  // Claims the first batch (in submission order) whose wait semaphores are all
+  // signaled (or, for timeline semaphores, have reached the waited value),
+  // completing the waits. Batches are released as soon as their own waits are
+  // satisfied even if batches submitted before them are still blocked.
+  // Returns false if no batch is ready or the queue has failed. The batch must
+  // be passed to RetireBatch once its command buffers have executed.
+  bool AcquireReadyBatch(ReadyBatch* out_batch);
+
+  // Retires a batch claimed with AcquireReadyBatch with the |status| of its
+  // execution. On success the batch semaphores are signaled and, if this was
+  // the last batch of its submission, the fences of all completed submissions
+  // up to the first incomplete one are signaled. On failure (including
+  // failures signaling semaphores or fences) the permanent error is set, all
+  // submissions are failed as they retire, and the error is returned.
+  Status RetireBatch(const ReadyBatch& batch, Status status);
+
   // Marks the queue as having shutdown. All pending submissions will be allowed
   // to complete but future enqueues will fail.
   void SignalShutdown();
@@ -123,27 +231,52 @@ class HostSubmissionQueue {
     absl::InlinedVector<CommandBuffer*, 4> command_buffers;
     absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
   };
-  struct Submission : public IntrusiveLinkBase<void> {
+  // The list link is a member rather than a base so that the type remains
+  // standard-layout, which IntrusiveList requires to offsetof the link.
+  struct Submission {
+    IntrusiveListLink link;
     absl::InlinedVector<PendingBatch, 4> pending_batches;
+    // Number of batches acquired and not yet retired.
+    int in_flight_count = 0;
+    // True once all batches have retired successfully. The fence is signaled
+    // when all prior submissions have also completed.
+    bool completed = false;
     FenceValue fence;
   };
 
   // Returns true if all wait semaphores in the |batch| are signaled.
   bool IsBatchReady(const PendingBatch& batch) const;
 
-  // Processes a batch by resetting semaphores, dispatching the command buffers
-  // to the specified |execute_fn|, and signaling semaphores.
-  //
-  // Preconditions: IsBatchReady(batch) == true
-  Status ProcessBatch(const PendingBatch& batch, const ExecuteFn& execute_fn);
+  // Completes the waits of a ready |batch|, returning the failure status of
+  // any failed semaphore it waited on.
+  Status EndWaiting(const PendingBatch& batch);
+
+  // Signals the semaphores of a retired |batch|.
+  Status SignalSemaphores(const ReadyBatch& batch);
 
   // Completes a submission by signaling the fence with the given |status|.
   Status CompleteSubmission(Submission* submission, Status status);
 
-  // Fails all pending submissions with the given status.
+  // Completes and removes the completed submissions at the front of the list
+  // so that fences are signaled in submission order.
+  Status CompleteReadySubmissions();
+
+  // Fails the timeline semaphores in |semaphore_values| with |status| so that
+  // waiters outside of the queue observe the failure. Binary semaphores have
+  // no failure state and are left as-is.
+  void FailTimelineSemaphores(absl::Span<const SemaphoreValue> semaphore_values,
+                              const Status& status);
+
+  // Fails all pending submissions with the given status, including the timeline
+  // semaphores their batches would have signaled. Submissions with batches in
+  // flight have their remaining batches dropped and are failed when the last
+  // in-flight batch retires.
   // Errors that occur during this process are silently ignored.
   void FailAllPending(Status status);
 
+  // Optional function called when waited timeline semaphores are signaled.
+  WakeFn wake_fn_;
+
   // True to exit the thread after all submissions complete.
   bool has_shutdown_ = false;
 
@@ -152,6 +285,9 @@ class HostSubmissionQueue {
   // error.
   Status permanent_error_;
 
+  // Total number of batches acquired and not yet retired.
+  int in_flight_count_ = 0;
+
   // Pending submissions in submission order.
   // Note that we may evaluate batches within the list out of order.
   IntrusiveList<std::unique_ptr<Submission>> list_;
@@ -14,14 +14,303 @@
 
 #include "iree/hal/host/host_submission_queue.h"
 
+#include <vector>
+
+#include "absl/time/time.h"
+
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/hal/host/host_fence.h"
+#include "iree/hal/testing/mock_command_buffer.h"
 #include "iree/testing/gtest.h"
 
 namespace iree {
 namespace hal {
 namespace {
 
-TEST(HostSubmissionQueueTest, TBD) {
-  // TODO(benvanik): test!
+using testing::MockCommandBuffer;
+
+ref_ptr<CommandBuffer> MakeCommandBuffer() {
+  return make_ref<MockCommandBuffer>(nullptr, CommandBufferMode::kOneShot,
+                                     CommandCategory::kTransfer);
+}
+
+TEST(HostTimelineSemaphoreTest, SignalAndQuery) {
+  HostTimelineSemaphore semaphore(1u);
+  ASSERT_OK_AND_ASSIGN(uint64_t value, semaphore.QueryValue());
+  EXPECT_EQ(1u, value);
+  EXPECT_TRUE(semaphore.has_reached(1u));
+  EXPECT_FALSE(semaphore.has_reached(2u));
+
+  ASSERT_OK(semaphore.Signal(3u));
+  ASSERT_OK_AND_ASSIGN(value, semaphore.QueryValue());
+  EXPECT_EQ(3u, value);
+  ASSERT_OK(semaphore.Wait(2u, absl::InfinitePast()));
+
+  // Values must increase.
+  EXPECT_TRUE(IsInvalidArgument(semaphore.Signal(3u)));
+  EXPECT_TRUE(IsDeadlineExceeded(semaphore.Wait(4u, absl::InfinitePast())));
+}
+
+TEST(HostTimelineSemaphoreTest, NotifyAt) {
+  HostTimelineSemaphore semaphore(0u);
+  std::vector<int> notified;
+  semaphore.NotifyAt(2u, [&]() { notified.push_back(2); });
+  semaphore.NotifyAt(1u, [&]() { notified.push_back(1); });
+  EXPECT_TRUE(notified.empty());
+
+  ASSERT_OK(semaphore.Signal(1u));
+  EXPECT_EQ(std::vector<int>({1}), notified);
+  ASSERT_OK(semaphore.Signal(5u));
+  EXPECT_EQ(std::vector<int>({1, 2}), notified);
+
+  // Already reached values notify immediately.
+  semaphore.NotifyAt(3u, [&]() { notified.push_back(3); });
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), notified);
+}
+
+TEST(HostTimelineSemaphoreTest, Fail) {
+  HostTimelineSemaphore semaphore(0u);
+  bool notified = false;
+  semaphore.NotifyAt(10u, [&]() { notified = true; });
+  ASSERT_OK(semaphore.Fail(DataLossErrorBuilder(IREE_LOC)));
+  EXPECT_TRUE(notified);
+  EXPECT_TRUE(IsDataLoss(semaphore.status()));
+  EXPECT_TRUE(IsDataLoss(semaphore.Wait(10u, absl::InfiniteFuture())));
+  EXPECT_TRUE(IsDataLoss(semaphore.Signal(11u)));
+}
+
+// Tests that independent batches can be in flight at the same time and that
+// fences are signaled in submission order as their submissions retire.
+TEST(HostSubmissionQueueTest, IndependentBatchesInFlight) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_0.get()}, {}}}, {&fence_0, 1u}));
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_1.get()}, {}}}, {&fence_1, 1u}));
+
+  HostSubmissionQueue::ReadyBatch batch_0;
+  HostSubmissionQueue::ReadyBatch batch_1;
+  HostSubmissionQueue::ReadyBatch batch_2;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_0));
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_1));
+  EXPECT_FALSE(queue.AcquireReadyBatch(&batch_2));
+  EXPECT_EQ(cmd_buffer_0.get(), batch_0.command_buffers[0]);
+  EXPECT_EQ(cmd_buffer_1.get(), batch_1.command_buffers[0]);
+  EXPECT_EQ(2, queue.in_flight_count());
+
+  // Retire out of order. The second fence is held until the first submission
+  // completes.
+  ASSERT_OK(queue.RetireBatch(batch_1, OkStatus()));
+  ASSERT_OK_AND_ASSIGN(uint64_t value_1, fence_1.QueryValue());
+  EXPECT_EQ(0u, value_1);
+  ASSERT_OK_AND_ASSIGN(uint64_t value_0, fence_0.QueryValue());
+  EXPECT_EQ(0u, value_0);
+  EXPECT_FALSE(queue.empty());
+
+  ASSERT_OK(queue.RetireBatch(batch_0, OkStatus()));
+  ASSERT_OK_AND_ASSIGN(value_0, fence_0.QueryValue());
+  EXPECT_EQ(1u, value_0);
+  ASSERT_OK_AND_ASSIGN(value_1, fence_1.QueryValue());
+  EXPECT_EQ(1u, value_1);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0, queue.in_flight_count());
+}
+
+// Tests that submissions signaling increasing values of the same fence can
+// retire out of order.
+TEST(HostSubmissionQueueTest, SharedFenceRetiresOutOfOrder) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostFence fence(0u);
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_0.get()}, {}}}, {&fence, 1u}));
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_1.get()}, {}}}, {&fence, 2u}));
+
+  HostSubmissionQueue::ReadyBatch batch_0;
+  HostSubmissionQueue::ReadyBatch batch_1;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_0));
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_1));
+  ASSERT_OK(queue.RetireBatch(batch_1, OkStatus()));
+  ASSERT_OK(queue.RetireBatch(batch_0, OkStatus()));
+
+  ASSERT_OK(fence.status());
+  ASSERT_OK_AND_ASSIGN(uint64_t value, fence.QueryValue());
+  EXPECT_EQ(2u, value);
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that a batch waiting on a semaphore is not ready until the batch
+// signaling it retires.
+TEST(HostSubmissionQueueTest, SemaphoreDependency) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostBinarySemaphore semaphore(false);
+  HostFence fence(0u);
+  ASSERT_OK(queue.Enqueue({{{&semaphore}, {cmd_buffer_1.get()}, {}},
+                           {{}, {cmd_buffer_0.get()}, {&semaphore}}},
+                          {&fence, 1u}));
+
+  HostSubmissionQueue::ReadyBatch batch;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  EXPECT_EQ(cmd_buffer_0.get(), batch.command_buffers[0]);
+  HostSubmissionQueue::ReadyBatch blocked_batch;
+  EXPECT_FALSE(queue.AcquireReadyBatch(&blocked_batch));
+
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  EXPECT_EQ(cmd_buffer_1.get(), batch.command_buffers[0]);
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+
+  ASSERT_OK_AND_ASSIGN(uint64_t value, fence.QueryValue());
+  EXPECT_EQ(1u, value);
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that batches waiting on timeline values are released as soon as their
+// values are reached, regardless of submission order.
+TEST(HostSubmissionQueueTest, TimelineDependency) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  auto cmd_buffer_2 = MakeCommandBuffer();
+  HostTimelineSemaphore semaphore(0u);
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  HostFence fence_2(0u);
+  SemaphoreValue wait_1 = std::make_pair(&semaphore, 1u);
+  SemaphoreValue wait_2 = std::make_pair(&semaphore, 2u);
+  SemaphoreValue signal_2 = std::make_pair(&semaphore, 2u);
+  ASSERT_OK(queue.Enqueue({{{wait_2}, {cmd_buffer_0.get()}, {}}},
+                          {&fence_0, 1u}));
+  ASSERT_OK(queue.Enqueue({{{wait_1}, {cmd_buffer_1.get()}, {signal_2}}},
+                          {&fence_1, 1u}));
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_2.get()}, {}}}, {&fence_2, 1u}));
+
+  // Only the submission without waits can run.
+  HostSubmissionQueue::ReadyBatch batch;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  EXPECT_EQ(cmd_buffer_2.get(), batch.command_buffers[0]);
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+  EXPECT_FALSE(queue.AcquireReadyBatch(&batch));
+
+  // Signaling from the host releases the second submission ahead of the first.
+  ASSERT_OK(semaphore.Signal(1u));
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  EXPECT_EQ(cmd_buffer_1.get(), batch.command_buffers[0]);
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+  ASSERT_OK_AND_ASSIGN(uint64_t value, semaphore.QueryValue());
+  EXPECT_EQ(2u, value);
+
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  EXPECT_EQ(cmd_buffer_0.get(), batch.command_buffers[0]);
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that the wake function is called when waited timeline values are
+// reached.
+TEST(HostSubmissionQueueTest, TimelineWake) {
+  int wake_count = 0;
+  HostSubmissionQueue queue([&]() { ++wake_count; });
+  auto cmd_buffer = MakeCommandBuffer();
+  HostTimelineSemaphore semaphore(0u);
+  HostFence fence(0u);
+  SemaphoreValue wait_1 = std::make_pair(&semaphore, 1u);
+  ASSERT_OK(
+      queue.Enqueue({{{wait_1}, {cmd_buffer.get()}, {}}}, {&fence, 1u}));
+  EXPECT_EQ(0, wake_count);
+  ASSERT_OK(semaphore.Signal(1u));
+  EXPECT_EQ(1, wake_count);
+
+  HostSubmissionQueue::ReadyBatch batch;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch));
+  ASSERT_OK(queue.RetireBatch(batch, OkStatus()));
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that failures propagate through timeline semaphores in both
+// directions: failed batches fail the semaphores they signal and failed
+// semaphores fail the batches waiting on them.
+TEST(HostSubmissionQueueTest, TimelineFailure) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostTimelineSemaphore semaphore_0(0u);
+  HostTimelineSemaphore semaphore_1(0u);
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  SemaphoreValue wait_1 = std::make_pair(&semaphore_0, 1u);
+  SemaphoreValue signal_1 = std::make_pair(&semaphore_1, 1u);
+  ASSERT_OK(queue.Enqueue({{{wait_1}, {cmd_buffer_0.get()}, {signal_1}}},
+                          {&fence_0, 1u}));
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_1.get()}, {}}}, {&fence_1, 1u}));
+
+  ASSERT_OK(semaphore_0.Fail(DataLossErrorBuilder(IREE_LOC)));
+  HostSubmissionQueue::ReadyBatch batch;
+  EXPECT_FALSE(queue.AcquireReadyBatch(&batch));
+  EXPECT_TRUE(IsDataLoss(queue.permanent_error()));
+  EXPECT_TRUE(IsDataLoss(fence_0.status()));
+  EXPECT_TRUE(IsDataLoss(fence_1.status()));
+  EXPECT_TRUE(IsDataLoss(semaphore_1.status()));
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that a failed batch fails all pending submissions, including those
+// with batches still in flight once they retire.
+TEST(HostSubmissionQueueTest, FailureFailsInFlight) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostFence fence_0(0u);
+  HostFence fence_1(0u);
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_0.get()}, {}}}, {&fence_0, 1u}));
+  ASSERT_OK(queue.Enqueue({{{}, {cmd_buffer_1.get()}, {}}}, {&fence_1, 1u}));
+
+  HostSubmissionQueue::ReadyBatch batch_0;
+  HostSubmissionQueue::ReadyBatch batch_1;
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_0));
+  ASSERT_TRUE(queue.AcquireReadyBatch(&batch_1));
+
+  EXPECT_TRUE(
+      IsDataLoss(queue.RetireBatch(batch_0, DataLossErrorBuilder(IREE_LOC))));
+  EXPECT_TRUE(IsDataLoss(fence_0.status()));
+  EXPECT_TRUE(fence_1.status().ok());
+  EXPECT_TRUE(IsDataLoss(queue.permanent_error()));
+  EXPECT_FALSE(queue.empty());
+
+  // The second batch succeeded but its submission still fails.
+  EXPECT_TRUE(IsDataLoss(queue.RetireBatch(batch_1, OkStatus())));
+  EXPECT_TRUE(IsDataLoss(fence_1.status()));
+  EXPECT_TRUE(queue.empty());
+}
+
+// Tests that ProcessBatches runs batches in dependency order.
+TEST(HostSubmissionQueueTest, ProcessBatches) {
+  HostSubmissionQueue queue;
+  auto cmd_buffer_0 = MakeCommandBuffer();
+  auto cmd_buffer_1 = MakeCommandBuffer();
+  HostBinarySemaphore semaphore(false);
+  HostFence fence(0u);
+  ASSERT_OK(queue.Enqueue({{{&semaphore}, {cmd_buffer_1.get()}, {}},
+                           {{}, {cmd_buffer_0.get()}, {&semaphore}}},
+                          {&fence, 1u}));
+
+  std::vector<CommandBuffer*> executed;
+  ASSERT_OK(queue.ProcessBatches(
+      [&](absl::Span<CommandBuffer* const> command_buffers) {
+        executed.insert(executed.end(), command_buffers.begin(),
+                        command_buffers.end());
+        return OkStatus();
+      }));
+  ASSERT_EQ(2, executed.size());
+  EXPECT_EQ(cmd_buffer_0.get(), executed[0]);
+  EXPECT_EQ(cmd_buffer_1.get(), executed[1]);
+  ASSERT_OK_AND_ASSIGN(uint64_t value, fence.QueryValue());
+  EXPECT_EQ(1u, value);
 }
 
 }  // namespace
@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/inproc_command_buffer.h"
 
+#include "absl/container/inlined_vector.h"
 #include "iree/base/tracing.h"
 
 namespace iree {
@@ -159,6 +160,17 @@ Status InProcCommandBuffer::PushDescriptorSet(
   return OkStatus();
 }
 
+Status InProcCommandBuffer::PushDescriptorSetSlots(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const DescriptorSet::SlotBinding> bindings) {
+  IREE_TRACE_SCOPE0("InProcCommandBuffer::PushDescriptorSetSlots");
+  ASSIGN_OR_RETURN(auto* cmd, AppendCmd<PushDescriptorSetSlotsCmd>());
+  cmd->executable_layout = executable_layout;
+  cmd->set = set;
+  cmd->bindings = AppendStructSpan(bindings);
+  return OkStatus();
+}
+
 Status InProcCommandBuffer::BindDescriptorSet(
     ExecutableLayout* executable_layout, int32_t set,
     DescriptorSet* descriptor_set,
@@ -230,7 +242,9 @@ void* InProcCommandBuffer::AppendCmdData(const void* source_buffer,
   return allocated_bytes;
 }
 
-Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
+Status InProcCommandBuffer::Process(
+    CommandBuffer* command_processor,
+    absl::Span<const BindingTableEntry> binding_table) const {
   IREE_TRACE_SCOPE0("InProcCommandBuffer::Process");
 
   RETURN_IF_ERROR(command_processor->Begin());
@@ -239,7 +253,8 @@ Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
   auto* cmd_list = &current_cmd_list_;
   for (CmdHeader* cmd_header = cmd_list->head; cmd_header != nullptr;
        cmd_header = cmd_header->next) {
-    auto command_status = ProcessCmd(cmd_header, command_processor);
+    auto command_status =
+        ProcessCmd(cmd_header, command_processor, binding_table);
     if (!command_status.ok()) {
       LOG(ERROR) << "DeviceQueue failure while executing command; permanently "
                     "failing all future commands: "
@@ -252,8 +267,9 @@ Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
   return OkStatus();
 }
 
-Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
-                                       CommandBuffer* command_processor) const {
+Status InProcCommandBuffer::ProcessCmd(
+    CmdHeader* cmd_header, CommandBuffer* command_processor,
+    absl::Span<const BindingTableEntry> binding_table) const {
   switch (cmd_header->type) {
     case CmdType::kExecutionBarrier: {
       auto* cmd = reinterpret_cast<ExecutionBarrierCmd*>(cmd_header + 1);
@@ -307,6 +323,28 @@ Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
       return command_processor->PushDescriptorSet(cmd->executable_layout,
                                                   cmd->set, cmd->bindings);
     }
+    case CmdType::kPushDescriptorSetSlots: {
+      auto* cmd = reinterpret_cast<PushDescriptorSetSlotsCmd*>(cmd_header + 1);
+      absl::InlinedVector<DescriptorSet::Binding, 8> bindings(
+          cmd->bindings.size());
+      for (int i = 0; i < cmd->bindings.size(); ++i) {
+        const auto& slot_binding = cmd->bindings[i];
+        if (slot_binding.slot < 0 ||
+            slot_binding.slot >= binding_table.size()) {
+          return InvalidArgumentErrorBuilder(IREE_LOC)
+                 << "Binding " << slot_binding.binding << " references slot "
+                 << slot_binding.slot << " but the binding table has "
+                 << binding_table.size() << " entries";
+        }
+        const auto& entry = binding_table[slot_binding.slot];
+        bindings[i].binding = slot_binding.binding;
+        bindings[i].buffer = entry.buffer;
+        bindings[i].offset = entry.offset;
+        bindings[i].length = entry.length;
+      }
+      return command_processor->PushDescriptorSet(cmd->executable_layout,
+                                                  cmd->set, bindings);
+    }
     case CmdType::kBindDescriptorSet: {
       auto* cmd = reinterpret_cast<BindDescriptorSetCmd*>(cmd_header + 1);
       return command_processor->BindDescriptorSet(cmd->executable_layout,
@@ -80,6 +80,10 @@ class InProcCommandBuffer final : public CommandBuffer {
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) override;
 
+  Status PushDescriptorSetSlots(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const DescriptorSet::SlotBinding> bindings) override;
+
   Status BindDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       DescriptorSet* descriptor_set,
@@ -93,8 +97,11 @@ class InProcCommandBuffer final : public CommandBuffer {
                           device_size_t workgroups_offset) override;
 
   // Processes all commands in the buffer using the given |command_processor|.
-  // The commands are issued in the order they were recorded.
-  Status Process(CommandBuffer* command_processor) const;
+  // The commands are issued in the order they were recorded. Descriptor sets
+  // pushed with PushDescriptorSetSlots are issued as PushDescriptorSet with
+  // their buffer ranges taken from |binding_table|.
+  Status Process(CommandBuffer* command_processor,
+                 absl::Span<const BindingTableEntry> binding_table = {}) const;
 
  private:
   // Type of Cmd, used by CmdHeader to identify the command payload.
@@ -109,6 +116,7 @@ class InProcCommandBuffer final : public CommandBuffer {
     kCopyBuffer,
     kPushConstants,
     kPushDescriptorSet,
+    kPushDescriptorSetSlots,
     kBindDescriptorSet,
     kDispatch,
     kDispatchIndirect,
@@ -226,6 +234,15 @@ class InProcCommandBuffer final : public CommandBuffer {
     absl::Span<const DescriptorSet::Binding> bindings;
   };
 
+  // Pushes an inline descriptor set update with buffers from the binding
+  // table.
+  struct PushDescriptorSetSlotsCmd {
+    static constexpr CmdType kType = CmdType::kPushDescriptorSetSlots;
+    ExecutableLayout* executable_layout;
+    int32_t set;
+    absl::Span<const DescriptorSet::SlotBinding> bindings;
+  };
+
   // Binds a descriptor set.
   struct BindDescriptorSetCmd {
     static constexpr CmdType kType = CmdType::kBindDescriptorSet;
@@ -283,8 +300,8 @@ class InProcCommandBuffer final : public CommandBuffer {
   }
 
   // Processes a single command.
-  Status ProcessCmd(CmdHeader* cmd_header,
-                    CommandBuffer* command_processor) const;
+  Status ProcessCmd(CmdHeader* cmd_header, CommandBuffer* command_processor,
+                    absl::Span<const BindingTableEntry> binding_table) const;
 
   bool is_recording_ = false;
 
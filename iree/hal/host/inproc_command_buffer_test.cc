@@ -0,0 +1,166 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/inproc_command_buffer.h"
+
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/hal/bound_command_buffer.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/hal/testing/mock_command_buffer.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+using testing::MockCommandBuffer;
+
+// Records a single dispatch whose two bindings come from the binding table.
+ref_ptr<InProcCommandBuffer> RecordSlotDispatch() {
+  auto command_buffer = make_ref<InProcCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kDispatch);
+  EXPECT_OK(command_buffer->Begin());
+  DescriptorSet::SlotBinding bindings[2];
+  bindings[0].binding = 0;
+  bindings[0].slot = 1;
+  bindings[1].binding = 1;
+  bindings[1].slot = 0;
+  EXPECT_OK(command_buffer->PushDescriptorSetSlots(nullptr, 0, bindings));
+  EXPECT_OK(command_buffer->Dispatch(nullptr, 0, {1, 1, 1}));
+  EXPECT_OK(command_buffer->End());
+  return command_buffer;
+}
+
+// Processes |command_buffer| and returns the bindings it pushed.
+std::vector<DescriptorSet::Binding> ProcessBindings(
+    CommandBuffer* command_buffer) {
+  MockCommandBuffer processor(nullptr, CommandBufferMode::kOneShot,
+                              CommandCategory::kDispatch);
+  std::vector<DescriptorSet::Binding> pushed_bindings;
+  EXPECT_CALL(processor, Begin()).WillOnce(Return(OkStatus()));
+  EXPECT_CALL(processor, PushDescriptorSet(_, 0, _))
+      .WillOnce([&](ExecutableLayout* executable_layout, int32_t set,
+                    absl::Span<const DescriptorSet::Binding> bindings) {
+        pushed_bindings.assign(bindings.begin(), bindings.end());
+        return OkStatus();
+      });
+  EXPECT_CALL(processor, Dispatch(_, 0, _)).WillOnce(Return(OkStatus()));
+  EXPECT_CALL(processor, End()).WillOnce(Return(OkStatus()));
+  auto* inproc_command_buffer =
+      static_cast<InProcCommandBuffer*>(command_buffer->impl());
+  EXPECT_OK(inproc_command_buffer->Process(&processor,
+                                           command_buffer->binding_table()));
+  return pushed_bindings;
+}
+
+TEST(InProcCommandBufferTest, ResolvesSlotsFromBindingTable) {
+  auto command_buffer = RecordSlotDispatch();
+  auto buffer_a = HeapBuffer::Allocate(BufferUsage::kAll, 64);
+  auto buffer_b = HeapBuffer::Allocate(BufferUsage::kAll, 64);
+
+  BindingTableEntry binding_table[2];
+  binding_table[0].buffer = buffer_a.get();
+  binding_table[0].offset = 16;
+  binding_table[0].length = 32;
+  binding_table[1].buffer = buffer_b.get();
+  ASSERT_OK_AND_ASSIGN(auto bound_command_buffer,
+                       BindCommandBuffer(add_ref(command_buffer),
+                                         binding_table));
+  auto bindings = ProcessBindings(bound_command_buffer.get());
+  ASSERT_EQ(2, bindings.size());
+  EXPECT_EQ(0, bindings[0].binding);
+  EXPECT_EQ(buffer_b.get(), bindings[0].buffer);
+  EXPECT_EQ(0, bindings[0].offset);
+  EXPECT_EQ(kWholeBuffer, bindings[0].length);
+  EXPECT_EQ(1, bindings[1].binding);
+  EXPECT_EQ(buffer_a.get(), bindings[1].buffer);
+  EXPECT_EQ(16, bindings[1].offset);
+  EXPECT_EQ(32, bindings[1].length);
+}
+
+// Tests that one recording can be submitted with different binding tables.
+TEST(InProcCommandBufferTest, RebindsWithoutRerecording) {
+  auto command_buffer = RecordSlotDispatch();
+  auto buffer_a = HeapBuffer::Allocate(BufferUsage::kAll, 64);
+  auto buffer_b = HeapBuffer::Allocate(BufferUsage::kAll, 64);
+
+  BindingTableEntry binding_table_ab[2];
+  binding_table_ab[0].buffer = buffer_a.get();
+  binding_table_ab[1].buffer = buffer_b.get();
+  BindingTableEntry binding_table_ba[2];
+  binding_table_ba[0].buffer = buffer_b.get();
+  binding_table_ba[1].buffer = buffer_a.get();
+  binding_table_ba[1].offset = 48;
+  binding_table_ba[1].length = 16;
+  ASSERT_OK_AND_ASSIGN(auto bound_ab,
+                       BindCommandBuffer(add_ref(command_buffer),
+                                         binding_table_ab));
+  ASSERT_OK_AND_ASSIGN(auto bound_ba,
+                       BindCommandBuffer(add_ref(command_buffer),
+                                         binding_table_ba));
+  auto bindings_ab = ProcessBindings(bound_ab.get());
+  auto bindings_ba = ProcessBindings(bound_ba.get());
+  ASSERT_EQ(2, bindings_ab.size());
+  ASSERT_EQ(2, bindings_ba.size());
+  EXPECT_EQ(buffer_b.get(), bindings_ab[0].buffer);
+  EXPECT_EQ(0, bindings_ab[0].offset);
+  EXPECT_EQ(kWholeBuffer, bindings_ab[0].length);
+  EXPECT_EQ(buffer_a.get(), bindings_ba[0].buffer);
+  EXPECT_EQ(48, bindings_ba[0].offset);
+  EXPECT_EQ(16, bindings_ba[0].length);
+}
+
+// Tests that bound command buffers retain their binding table buffers.
+TEST(InProcCommandBufferTest, BindingTableIsRetained) {
+  auto command_buffer = RecordSlotDispatch();
+  auto buffer = HeapBuffer::Allocate(BufferUsage::kAll, 64);
+  Buffer* buffer_ptr = buffer.get();
+  BindingTableEntry binding_table[2];
+  binding_table[0].buffer = buffer_ptr;
+  binding_table[1].buffer = buffer_ptr;
+  ASSERT_OK_AND_ASSIGN(auto bound_command_buffer,
+                       BindCommandBuffer(add_ref(command_buffer),
+                                         binding_table));
+  buffer.reset();
+  auto bindings = ProcessBindings(bound_command_buffer.get());
+  ASSERT_EQ(2, bindings.size());
+  EXPECT_EQ(buffer_ptr, bindings[0].buffer);
+  EXPECT_EQ(64, bindings[0].buffer->byte_length());
+}
+
+TEST(InProcCommandBufferTest, BoundCommandBufferIsNotRecordable) {
+  auto command_buffer = RecordSlotDispatch();
+  ASSERT_OK_AND_ASSIGN(auto bound_command_buffer,
+                       BindCommandBuffer(add_ref(command_buffer), {}));
+  EXPECT_TRUE(IsFailedPrecondition(bound_command_buffer->Begin()));
+  EXPECT_TRUE(IsFailedPrecondition(
+      bound_command_buffer->Dispatch(nullptr, 0, {1, 1, 1})));
+}
+
+TEST(InProcCommandBufferTest, BindRequiresEndedRecording) {
+  auto command_buffer = make_ref<InProcCommandBuffer>(
+      nullptr, CommandBufferMode::kOneShot, CommandCategory::kDispatch);
+  ASSERT_OK(command_buffer->Begin());
+  EXPECT_TRUE(IsFailedPrecondition(
+      BindCommandBuffer(add_ref(command_buffer), {}).status()));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,171 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task_executor.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/thread_affinity.h"
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// The executor and worker ordinal of the calling thread, if it is a worker.
+thread_local TaskExecutor* current_executor = nullptr;
+thread_local int current_worker_ordinal = -1;
+
+}  // namespace
+
+// static
+ref_ptr<TaskExecutor> TaskExecutor::GetOrCreateShared(const Options& options) {
+  static absl::Mutex shared_mutex(absl::kConstInit);
+  // Intentionally leaked so that workers never need to be joined during static
+  // destruction; idle workers are just blocked waiting for tasks.
+  static TaskExecutor* shared_executor = nullptr;
+  absl::MutexLock lock(&shared_mutex);
+  if (!shared_executor) {
+    shared_executor = new TaskExecutor(options);
+  }
+  return add_ref(shared_executor);
+}
+
+TaskExecutor::TaskExecutor(Options options) {
+  IREE_TRACE_SCOPE0("TaskExecutor::ctor");
+  int worker_count = options.worker_count;
+  if (worker_count <= 0) {
+    worker_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // All workers must exist before any thread starts as threads steal from each
+  // other.
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.push_back(absl::make_unique<Worker>());
+  }
+  for (int worker_ordinal = 0; worker_ordinal < worker_count;
+       ++worker_ordinal) {
+    int cpu =
+        worker_ordinal < static_cast<int>(options.worker_affinity.size())
+            ? options.worker_affinity[worker_ordinal]
+            : -1;
+    workers_[worker_ordinal]->thread =
+        std::thread([this, worker_ordinal, cpu]() {
+          if (cpu >= 0) PinCurrentThreadToCpu(cpu);
+          ThreadMain(worker_ordinal);
+        });
+  }
+}
+
+TaskExecutor::~TaskExecutor() {
+  IREE_TRACE_SCOPE0("TaskExecutor::dtor");
+  {
+    // Workers drain any remaining tasks before exiting.
+    absl::MutexLock lock(&wake_mutex_);
+    has_shutdown_ = true;
+    wake_cond_.SignalAll();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void TaskExecutor::Submit(TaskFn task) {
+  if (current_executor == this) {
+    // Submitted from one of our workers; keep it local as it is likely to
+    // touch the same data as the task that submitted it.
+    auto* worker = workers_[current_worker_ordinal].get();
+    absl::MutexLock lock(&worker->mutex);
+    worker->tasks.push_front(std::move(task));
+  } else {
+    uint32_t worker_ordinal =
+        next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    auto* worker = workers_[worker_ordinal].get();
+    absl::MutexLock lock(&worker->mutex);
+    worker->tasks.push_back(std::move(task));
+  }
+  pending_task_count_.fetch_add(1, std::memory_order_release);
+
+  // Wake an idle worker. Workers check the pending count with |wake_mutex_|
+  // held before sleeping so they cannot miss this.
+  absl::MutexLock lock(&wake_mutex_);
+  if (idle_worker_count_ > 0) {
+    wake_cond_.Signal();
+  }
+}
+
+void TaskExecutor::ThreadMain(int worker_ordinal) {
+  // TODO(benvanik): make this safer (may die if trace is flushed late).
+  std::string thread_name = absl::StrCat("executor", worker_ordinal);
+  IREE_TRACE_THREAD_ENABLE(thread_name.c_str());
+
+  current_executor = this;
+  current_worker_ordinal = worker_ordinal;
+
+  while (true) {
+    TaskFn task;
+    if (TryPopTask(worker_ordinal, &task) ||
+        TryStealTask(worker_ordinal, &task)) {
+      pending_task_count_.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      continue;
+    }
+
+    // Nothing to do; sleep until new tasks are submitted or we are shutting
+    // down. A task may have been submitted after our last scan so we recheck
+    // the pending count with the mutex held. The count may briefly be negative
+    // if a task was claimed before its submitter incremented it.
+    absl::MutexLock lock(&wake_mutex_);
+    while (pending_task_count_.load(std::memory_order_acquire) <= 0) {
+      if (has_shutdown_) {
+        current_executor = nullptr;
+        current_worker_ordinal = -1;
+        return;
+      }
+      ++idle_worker_count_;
+      wake_cond_.Wait(&wake_mutex_);
+      --idle_worker_count_;
+    }
+  }
+}
+
+bool TaskExecutor::TryPopTask(int worker_ordinal, TaskFn* out_task) {
+  auto* worker = workers_[worker_ordinal].get();
+  absl::MutexLock lock(&worker->mutex);
+  if (worker->tasks.empty()) return false;
+  *out_task = std::move(worker->tasks.front());
+  worker->tasks.pop_front();
+  return true;
+}
+
+bool TaskExecutor::TryStealTask(int worker_ordinal, TaskFn* out_task) {
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    auto* victim = workers_[(worker_ordinal + i) % workers_.size()].get();
+    absl::MutexLock lock(&victim->mutex);
+    if (victim->tasks.empty()) continue;
+    *out_task = std::move(victim->tasks.back());
+    victim->tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+}  // namespace hal
+}  // namespace iree
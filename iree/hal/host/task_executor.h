@@ -0,0 +1,113 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_EXECUTOR_H_
+#define IREE_HAL_HOST_TASK_EXECUTOR_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/ref_ptr.h"
+
+namespace iree {
+namespace hal {
+
+// A pool of worker threads executing independent tasks, such as the command
+// buffer batches of host queue submissions.
+//
+// Each worker has its own task deque. Tasks submitted from a worker are pushed
+// to the front of that worker's deque and run LIFO for locality while tasks
+// submitted from other threads are distributed round-robin across the workers.
+// Workers that run out of tasks steal from the back of the deques of other
+// workers before going to sleep.
+//
+// Executors are reference counted so that a single executor can be shared by
+// all of the queues of all host devices (see GetOrCreateShared). Tasks
+// remaining when the last reference is released are run before the workers
+// exit; the last reference must not be released from a task.
+//
+// Thread-safe.
+class TaskExecutor final : public RefObject<TaskExecutor> {
+ public:
+  struct Options {
+    // Number of worker threads. 0 uses one worker per hardware thread.
+    int worker_count = 0;
+
+    // Logical CPU IDs that the workers are pinned to, where entry i applies to
+    // worker i. Workers beyond the end of the list are left unpinned.
+    std::vector<int> worker_affinity;
+  };
+
+  using TaskFn = std::function<void()>;
+
+  // Returns the process-wide executor shared by host devices, creating it with
+  // |options| on first use. |options| are ignored if the executor already
+  // exists.
+  static ref_ptr<TaskExecutor> GetOrCreateShared(const Options& options);
+
+  explicit TaskExecutor(Options options);
+  ~TaskExecutor();
+
+  TaskExecutor(const TaskExecutor&) = delete;
+  TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+  // Number of worker threads executing tasks.
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Schedules |task| to run on a worker thread. Tasks may run in any order and
+  // concurrently with each other; callers must order dependent work
+  // themselves (usually by submitting it from the task it depends on).
+  void Submit(TaskFn task);
+
+ private:
+  struct Worker {
+    absl::Mutex mutex;
+    std::deque<TaskFn> tasks ABSL_GUARDED_BY(mutex);
+    std::thread thread;
+  };
+
+  // Thread entry point for worker |worker_ordinal|.
+  void ThreadMain(int worker_ordinal);
+
+  // Pops a task from the front of the deque of worker |worker_ordinal|.
+  bool TryPopTask(int worker_ordinal, TaskFn* out_task);
+  // Steals a task from the back of the deque of any worker other than
+  // |worker_ordinal|.
+  bool TryStealTask(int worker_ordinal, TaskFn* out_task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Worker that the next task submitted from a non-worker thread goes to.
+  std::atomic<uint32_t> next_worker_{0};
+
+  // Number of tasks submitted and not yet claimed by a worker. Incremented
+  // before waking workers so that a worker never sleeps while tasks remain.
+  std::atomic<int64_t> pending_task_count_{0};
+
+  absl::Mutex wake_mutex_;
+  absl::CondVar wake_cond_;
+  int idle_worker_count_ ABSL_GUARDED_BY(wake_mutex_) = 0;
+  bool has_shutdown_ ABSL_GUARDED_BY(wake_mutex_) = false;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_EXECUTOR_H_
@@ -0,0 +1,50 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task_executor_flags.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/numbers.h"
+
+ABSL_FLAG(int, host_executor_worker_count, 0,
+          "Number of threads executing queue submissions for all host "
+          "devices. 0 uses one per hardware thread.");
+ABSL_FLAG(std::vector<std::string>, host_executor_worker_affinity, {},
+          "Comma-separated logical CPU IDs to pin host queue executor threads "
+          "to.");
+
+namespace iree {
+namespace hal {
+
+StatusOr<TaskExecutor::Options> GetTaskExecutorOptionsFromFlags() {
+  TaskExecutor::Options options;
+  options.worker_count = absl::GetFlag(FLAGS_host_executor_worker_count);
+  for (const auto& cpu_str :
+       absl::GetFlag(FLAGS_host_executor_worker_affinity)) {
+    int cpu = 0;
+    if (!absl::SimpleAtoi(cpu_str, &cpu) || cpu < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Invalid --host_executor_worker_affinity CPU ID '" << cpu_str
+             << "'";
+    }
+    options.worker_affinity.push_back(cpu);
+  }
+  return options;
+}
+
+}  // namespace hal
+}  // namespace iree
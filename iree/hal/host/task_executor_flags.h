@@ -0,0 +1,32 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_EXECUTOR_FLAGS_H_
+#define IREE_HAL_HOST_TASK_EXECUTOR_FLAGS_H_
+
+#include "iree/base/status.h"
+#include "iree/hal/host/task_executor.h"
+
+namespace iree {
+namespace hal {
+
+// Returns the options of the shared host TaskExecutor as specified by the
+// --host_executor_* flags. These are shared by all host drivers as they all
+// share one executor.
+StatusOr<TaskExecutor::Options> GetTaskExecutorOptionsFromFlags();
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_EXECUTOR_FLAGS_H_
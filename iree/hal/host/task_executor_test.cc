@@ -0,0 +1,118 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task_executor.h"
+
+#include <atomic>
+#include <set>
+#include <thread>  // NOLINT
+
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+TaskExecutor::Options MakeOptions(int worker_count) {
+  TaskExecutor::Options options;
+  options.worker_count = worker_count;
+  return options;
+}
+
+TEST(TaskExecutorTest, DefaultWorkerCount) {
+  auto executor = make_ref<TaskExecutor>(MakeOptions(0));
+  EXPECT_GE(executor->worker_count(), 1);
+}
+
+TEST(TaskExecutorTest, RunsAllTasks) {
+  auto executor = make_ref<TaskExecutor>(MakeOptions(4));
+  constexpr int kTaskCount = 1000;
+  std::atomic<int> run_count{0};
+  absl::BlockingCounter counter(kTaskCount);
+  for (int i = 0; i < kTaskCount; ++i) {
+    executor->Submit([&]() {
+      ++run_count;
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  EXPECT_EQ(kTaskCount, run_count);
+}
+
+// Tests that tasks submitted from within tasks are run.
+TEST(TaskExecutorTest, NestedSubmit) {
+  auto executor = make_ref<TaskExecutor>(MakeOptions(2));
+  constexpr int kFanout = 16;
+  absl::BlockingCounter counter(kFanout * kFanout);
+  for (int i = 0; i < kFanout; ++i) {
+    executor->Submit([&]() {
+      for (int j = 0; j < kFanout; ++j) {
+        executor->Submit([&]() { counter.DecrementCount(); });
+      }
+    });
+  }
+  counter.Wait();
+}
+
+// Tests that idle workers steal tasks queued behind a blocked task. All tasks
+// submitted from a worker land on its own deque so the only way for them to
+// complete while the submitting task blocks is for another worker to steal
+// them.
+TEST(TaskExecutorTest, IdleWorkersSteal) {
+  auto executor = make_ref<TaskExecutor>(MakeOptions(2));
+  absl::Mutex mutex;
+  std::set<std::thread::id> thread_ids;
+  absl::BlockingCounter stolen_counter(4);
+  absl::BlockingCounter done_counter(1);
+  executor->Submit([&]() {
+    for (int i = 0; i < 4; ++i) {
+      executor->Submit([&]() {
+        {
+          absl::MutexLock lock(&mutex);
+          thread_ids.insert(std::this_thread::get_id());
+        }
+        stolen_counter.DecrementCount();
+      });
+    }
+    stolen_counter.Wait();
+    done_counter.DecrementCount();
+  });
+  done_counter.Wait();
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ(1, thread_ids.size());
+}
+
+// Tests that tasks still queued when the executor is destroyed are run.
+TEST(TaskExecutorTest, DrainsOnDestruction) {
+  std::atomic<int> run_count{0};
+  {
+    auto executor = make_ref<TaskExecutor>(MakeOptions(1));
+    for (int i = 0; i < 100; ++i) {
+      executor->Submit([&]() { ++run_count; });
+    }
+  }
+  EXPECT_EQ(100, run_count);
+}
+
+TEST(TaskExecutorTest, SharedExecutorIsShared) {
+  auto executor_a = TaskExecutor::GetOrCreateShared(MakeOptions(1));
+  auto executor_b = TaskExecutor::GetOrCreateShared(MakeOptions(3));
+  EXPECT_EQ(executor_a.get(), executor_b.get());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,45 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/thread_affinity.h"
+
+#include "iree/base/logging.h"
+#include "iree/base/platform_headers.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#include <sched.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+namespace iree {
+namespace hal {
+
+void PinCurrentThreadToCpu(int cpu) {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG(WARNING) << "Unable to pin thread to CPU " << cpu;
+  }
+#elif defined(IREE_PLATFORM_WINDOWS)
+  if (!::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpu)) {
+    LOG(WARNING) << "Unable to pin thread to CPU " << cpu;
+  }
+#else
+  // Affinity not supported on this platform; threads float.
+#endif  // IREE_PLATFORM_*
+}
+
+}  // namespace hal
+}  // namespace iree
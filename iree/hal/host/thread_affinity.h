@@ -0,0 +1,28 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_THREAD_AFFINITY_H_
+#define IREE_HAL_HOST_THREAD_AFFINITY_H_
+
+namespace iree {
+namespace hal {
+
+// Pins the calling thread to the given logical CPU, if supported by the
+// platform. Failures are logged and the thread is left floating.
+void PinCurrentThreadToCpu(int cpu);
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_THREAD_AFFINITY_H_
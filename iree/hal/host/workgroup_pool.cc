@@ -0,0 +1,202 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/workgroup_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/thread_affinity.h"
+
+namespace iree {
+namespace hal {
+
+// A grid being executed by the pool. Lives on the stack of DispatchGrid.
+struct WorkgroupPool::Grid {
+  const WorkgroupFn* workgroup_fn = nullptr;
+  std::array<uint32_t, 3> workgroup_count;
+  uint64_t workgroup_total = 0;
+  uint64_t tile_size = 1;
+
+  // Linear index of the next unclaimed workgroup.
+  std::atomic<uint64_t> next_workgroup{0};
+
+  absl::Mutex status_mutex;
+  Status status ABSL_GUARDED_BY(status_mutex);
+};
+
+WorkgroupPool::WorkgroupPool(Options options) {
+  IREE_TRACE_SCOPE0("WorkgroupPool::ctor");
+  worker_count_ = options.worker_count;
+  if (worker_count_ <= 0) {
+    worker_count_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+  tiles_per_worker_ = std::max(1, options.tiles_per_worker);
+
+  // Worker 0 is the thread calling DispatchGrid; we only need threads for the
+  // remainder.
+  threads_.reserve(worker_count_ - 1);
+  for (int worker_ordinal = 1; worker_ordinal < worker_count_;
+       ++worker_ordinal) {
+    size_t affinity_ordinal = worker_ordinal - 1;
+    int cpu = affinity_ordinal < options.worker_affinity.size()
+                  ? options.worker_affinity[affinity_ordinal]
+                  : -1;
+    threads_.emplace_back([this, worker_ordinal, cpu]() {
+      if (cpu >= 0) PinCurrentThreadToCpu(cpu);
+      ThreadMain(worker_ordinal);
+    });
+  }
+}
+
+WorkgroupPool::~WorkgroupPool() {
+  IREE_TRACE_SCOPE0("WorkgroupPool::dtor");
+  {
+    absl::MutexLock lock(&mutex_);
+    has_shutdown_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkgroupPool::ThreadMain(int worker_ordinal) {
+  // TODO(benvanik): make this safer (may die if trace is flushed late).
+  std::string thread_name = absl::StrCat("workgroup", worker_ordinal);
+  IREE_TRACE_THREAD_ENABLE(thread_name.c_str());
+
+  uint64_t last_epoch = 0;
+  while (true) {
+    Grid* grid = nullptr;
+    {
+      absl::MutexLock lock(&mutex_);
+      auto has_work = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+        return has_shutdown_ || grid_epoch_ != last_epoch;
+      };
+      mutex_.Await(absl::Condition(&has_work));
+      if (has_shutdown_) return;
+      last_epoch = grid_epoch_;
+      // The grid may have already been retired by the time we woke; we'll
+      // just go back to sleep until the next one.
+      grid = grid_;
+      if (!grid) continue;
+      ++active_workers_;
+    }
+
+    RunTiles(grid, worker_ordinal);
+
+    {
+      absl::MutexLock lock(&mutex_);
+      --active_workers_;
+    }
+  }
+}
+
+// static
+void WorkgroupPool::RunTiles(Grid* grid, int worker_ordinal) {
+  const auto& workgroup_count = grid->workgroup_count;
+  const uint64_t count_xy =
+      static_cast<uint64_t>(workgroup_count[0]) * workgroup_count[1];
+  WorkgroupState state;
+  state.workgroup_count = workgroup_count;
+  while (true) {
+    uint64_t tile_begin = grid->next_workgroup.fetch_add(
+        grid->tile_size, std::memory_order_relaxed);
+    if (tile_begin >= grid->workgroup_total) break;
+    uint64_t tile_end =
+        std::min(tile_begin + grid->tile_size, grid->workgroup_total);
+    for (uint64_t i = tile_begin; i < tile_end; ++i) {
+      state.workgroup_id = {
+          static_cast<uint32_t>(i % workgroup_count[0]),
+          static_cast<uint32_t>((i / workgroup_count[0]) % workgroup_count[1]),
+          static_cast<uint32_t>(i / count_xy),
+      };
+      auto status = (*grid->workgroup_fn)(worker_ordinal, state);
+      if (!status.ok()) {
+        absl::MutexLock lock(&grid->status_mutex);
+        if (grid->status.ok()) grid->status = std::move(status);
+        // Prevent any further tiles from being claimed.
+        grid->next_workgroup.store(grid->workgroup_total,
+                                   std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+}
+
+Status WorkgroupPool::DispatchGrid(std::array<uint32_t, 3> workgroup_count,
+                                   const WorkgroupFn& workgroup_fn) {
+  IREE_TRACE_SCOPE0("WorkgroupPool::DispatchGrid");
+
+  uint64_t workgroup_total = static_cast<uint64_t>(workgroup_count[0]) *
+                             workgroup_count[1] * workgroup_count[2];
+  if (workgroup_total == 0) return OkStatus();
+
+  // Fast path for grids that are not worth distributing.
+  if (workgroup_total == 1 || threads_.empty()) {
+    WorkgroupState state;
+    state.workgroup_count = workgroup_count;
+    for (uint32_t z = 0; z < workgroup_count[2]; ++z) {
+      for (uint32_t y = 0; y < workgroup_count[1]; ++y) {
+        for (uint32_t x = 0; x < workgroup_count[0]; ++x) {
+          state.workgroup_id = {x, y, z};
+          RETURN_IF_ERROR(workgroup_fn(/*worker_ordinal=*/0, state));
+        }
+      }
+    }
+    return OkStatus();
+  }
+
+  absl::MutexLock dispatch_lock(&dispatch_mutex_);
+
+  Grid grid;
+  grid.workgroup_fn = &workgroup_fn;
+  grid.workgroup_count = workgroup_count;
+  grid.workgroup_total = workgroup_total;
+  uint64_t tile_count = std::min<uint64_t>(
+      workgroup_total,
+      static_cast<uint64_t>(worker_count_) * tiles_per_worker_);
+  grid.tile_size = (workgroup_total + tile_count - 1) / tile_count;
+
+  // Publish the grid and wake the pool threads.
+  {
+    absl::MutexLock lock(&mutex_);
+    grid_ = &grid;
+    ++grid_epoch_;
+  }
+
+  // Participate as worker 0.
+  RunTiles(&grid, /*worker_ordinal=*/0);
+
+  // Retire the grid so that late waking threads don't pick it up and then wait
+  // for any threads still executing tiles to finish. After this point no
+  // thread may reference |grid|.
+  {
+    absl::MutexLock lock(&mutex_);
+    grid_ = nullptr;
+    auto is_idle = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return active_workers_ == 0;
+    };
+    mutex_.Await(absl::Condition(&is_idle));
+  }
+
+  absl::MutexLock lock(&grid.status_mutex);
+  return grid.status;
+}
+
+}  // namespace hal
+}  // namespace iree
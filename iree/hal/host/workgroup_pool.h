@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_WORKGROUP_POOL_H_
+#define IREE_HAL_HOST_WORKGROUP_POOL_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+
+namespace iree {
+namespace hal {
+
+// Identifies a single workgroup within a dispatch grid.
+// Executables use this to select the portion of the workload they are
+// responsible for.
+struct WorkgroupState {
+  std::array<uint32_t, 3> workgroup_id;
+  std::array<uint32_t, 3> workgroup_count;
+};
+
+// A pool of worker threads that executes the workgroups of a dispatch grid in
+// parallel. The grid is linearized (x fastest, then y, then z) and split into
+// contiguous tiles of workgroups that are claimed by workers until none remain.
+// The thread issuing the dispatch participates as worker 0 so that small grids
+// do not pay for a thread handoff.
+//
+// Only one grid is executed at a time; concurrent DispatchGrid calls are
+// serialized.
+//
+// Thread-safe.
+class WorkgroupPool final {
+ public:
+  struct Options {
+    // Total number of workers executing workgroups, including the thread that
+    // calls DispatchGrid. 0 uses one worker per hardware thread.
+    int worker_count = 0;
+
+    // Logical CPU IDs that the pool threads are pinned to, where entry i
+    // applies to worker i + 1 (the calling thread is never pinned). Threads
+    // beyond the end of the list are left unpinned.
+    std::vector<int> worker_affinity;
+
+    // Number of tiles each worker is expected to claim per dispatch. Larger
+    // values balance uneven workgroups better at the cost of more contention.
+    int tiles_per_worker = 4;
+  };
+
+  // Called once per workgroup. |worker_ordinal| is in [0, worker_count()) and
+  // identifies the worker within a single grid so it may be used to index
+  // per-dispatch scratch state. Calls with the same ordinal never overlap
+  // within a grid.
+  using WorkgroupFn =
+      std::function<Status(int worker_ordinal, const WorkgroupState& state)>;
+
+  explicit WorkgroupPool(Options options);
+  ~WorkgroupPool();
+
+  WorkgroupPool(const WorkgroupPool&) = delete;
+  WorkgroupPool& operator=(const WorkgroupPool&) = delete;
+
+  // Total number of workers, including the calling thread.
+  int worker_count() const { return worker_count_; }
+
+  // Executes |workgroup_fn| for each workgroup in |workgroup_count| and blocks
+  // until all have completed. If any invocation fails the remaining unclaimed
+  // workgroups are skipped and the first error is returned.
+  Status DispatchGrid(std::array<uint32_t, 3> workgroup_count,
+                      const WorkgroupFn& workgroup_fn);
+
+ private:
+  struct Grid;
+
+  // Thread entry point for pool worker |worker_ordinal|.
+  void ThreadMain(int worker_ordinal);
+
+  // Claims and executes tiles from |grid| until none remain.
+  static void RunTiles(Grid* grid, int worker_ordinal);
+
+  int worker_count_ = 1;
+  int tiles_per_worker_ = 1;
+  std::vector<std::thread> threads_;
+
+  // Serializes DispatchGrid callers so that only one grid is in flight.
+  absl::Mutex dispatch_mutex_;
+
+  absl::Mutex mutex_;
+  bool has_shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  // Incremented each time a new grid is published to the workers.
+  uint64_t grid_epoch_ ABSL_GUARDED_BY(mutex_) = 0;
+  Grid* grid_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  // Number of pool threads currently executing tiles from |grid_|.
+  int active_workers_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_WORKGROUP_POOL_H_
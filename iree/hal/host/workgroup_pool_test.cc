@@ -0,0 +1,112 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/workgroup_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Returns a pool with |worker_count| workers (including the caller).
+WorkgroupPool::Options MakeOptions(int worker_count) {
+  WorkgroupPool::Options options;
+  options.worker_count = worker_count;
+  return options;
+}
+
+// Tests that an empty grid never calls the workgroup function.
+TEST(WorkgroupPoolTest, EmptyGrid) {
+  WorkgroupPool pool(MakeOptions(4));
+  EXPECT_OK(pool.DispatchGrid({0, 4, 4}, [](int, const WorkgroupState&) {
+    ADD_FAILURE() << "Workgroup function should not be called";
+    return OkStatus();
+  }));
+}
+
+// Tests that a single-worker pool runs all workgroups inline in order.
+TEST(WorkgroupPoolTest, InlineExecution) {
+  WorkgroupPool pool(MakeOptions(1));
+  EXPECT_EQ(1, pool.worker_count());
+  std::vector<std::array<uint32_t, 3>> ids;
+  ASSERT_OK(pool.DispatchGrid(
+      {2, 2, 1}, [&](int worker_ordinal, const WorkgroupState& state) {
+        EXPECT_EQ(0, worker_ordinal);
+        EXPECT_EQ(2, state.workgroup_count[0]);
+        EXPECT_EQ(2, state.workgroup_count[1]);
+        EXPECT_EQ(1, state.workgroup_count[2]);
+        ids.push_back(state.workgroup_id);
+        return OkStatus();
+      }));
+  ASSERT_EQ(4, ids.size());
+  EXPECT_EQ((std::array<uint32_t, 3>{0, 0, 0}), ids[0]);
+  EXPECT_EQ((std::array<uint32_t, 3>{1, 0, 0}), ids[1]);
+  EXPECT_EQ((std::array<uint32_t, 3>{0, 1, 0}), ids[2]);
+  EXPECT_EQ((std::array<uint32_t, 3>{1, 1, 0}), ids[3]);
+}
+
+// Tests that every workgroup in a large grid is executed exactly once across
+// all workers and that worker ordinals are in range.
+TEST(WorkgroupPoolTest, ParallelExecution) {
+  WorkgroupPool pool(MakeOptions(4));
+  EXPECT_EQ(4, pool.worker_count());
+  const std::array<uint32_t, 3> workgroup_count = {17, 5, 3};
+  std::vector<std::atomic<int>> hits(workgroup_count[0] * workgroup_count[1] *
+                                     workgroup_count[2]);
+  for (int i = 0; i < 2; ++i) {
+    for (auto& hit : hits) hit = 0;
+    ASSERT_OK(pool.DispatchGrid(
+        workgroup_count, [&](int worker_ordinal, const WorkgroupState& state) {
+          EXPECT_GE(worker_ordinal, 0);
+          EXPECT_LT(worker_ordinal, pool.worker_count());
+          const auto& id = state.workgroup_id;
+          hits[(id[2] * workgroup_count[1] + id[1]) * workgroup_count[0] +
+               id[0]]
+              .fetch_add(1);
+          return OkStatus();
+        }));
+    for (auto& hit : hits) {
+      EXPECT_EQ(1, hit.load());
+    }
+  }
+}
+
+// Tests that failures are propagated to the caller and stop execution.
+TEST(WorkgroupPoolTest, FailurePropagation) {
+  WorkgroupPool pool(MakeOptions(3));
+  auto status = pool.DispatchGrid(
+      {1024, 1, 1},
+      [&](int worker_ordinal, const WorkgroupState& state) -> Status {
+        if (state.workgroup_id[0] == 0) {
+          return InternalErrorBuilder(IREE_LOC) << "Expected failure";
+        }
+        return OkStatus();
+      });
+  EXPECT_TRUE(IsInternal(status));
+
+  // The pool must remain usable after a failure.
+  EXPECT_OK(pool.DispatchGrid(
+      {8, 1, 1}, [](int, const WorkgroupState&) { return OkStatus(); }));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -28,8 +28,9 @@ namespace llvmjit {
 
 LLVMJITCommandProcessor::LLVMJITCommandProcessor(
     Allocator* allocator, CommandBufferModeBitfield mode,
-    CommandCategoryBitfield command_categories)
-    : HostLocalCommandProcessor(allocator, mode, command_categories) {}
+    CommandCategoryBitfield command_categories, WorkgroupPool* workgroup_pool)
+    : HostLocalCommandProcessor(allocator, mode, command_categories),
+      workgroup_pool_(workgroup_pool) {}
 
 LLVMJITCommandProcessor::~LLVMJITCommandProcessor() = default;
 
@@ -54,7 +55,19 @@ Status LLVMJITCommandProcessor::DispatchInline(
       args.push_back(&descriptor->descriptor);
     }
   }
-  auto status = llvmjit_executable->Invoke(entry_point, args);
+
+  // The workgroup ID and count are passed as trailing arguments after the
+  // bindings. Each workgroup gets its own copy of the argument list as the
+  // trailing pointers differ per invocation.
+  auto status = workgroup_pool_->DispatchGrid(
+      workgroups, [&](int worker_ordinal, const WorkgroupState& state) {
+        llvm::SmallVector<void*, 8> workgroup_args(args.begin(), args.end());
+        workgroup_args.push_back(
+            const_cast<uint32_t*>(state.workgroup_id.data()));
+        workgroup_args.push_back(
+            const_cast<uint32_t*>(state.workgroup_count.data()));
+        return llvmjit_executable->Invoke(entry_point, workgroup_args);
+      });
 
   for (int i = 0; i < descriptors.size(); ++i) {
     freeUnrankedDescriptor(descriptors[i]);
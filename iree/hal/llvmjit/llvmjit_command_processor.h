@@ -15,6 +15,7 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_COMMAND_PROCESSOR_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_COMMAND_PROCESSOR_H_
 #include "iree/hal/host/host_local_command_processor.h"
+#include "iree/hal/host/workgroup_pool.h"
 
 namespace iree {
 namespace hal {
@@ -23,7 +24,8 @@ namespace llvmjit {
 class LLVMJITCommandProcessor final : public HostLocalCommandProcessor {
  public:
   LLVMJITCommandProcessor(Allocator* allocator, CommandBufferModeBitfield mode,
-                          CommandCategoryBitfield command_categories);
+                          CommandCategoryBitfield command_categories,
+                          WorkgroupPool* workgroup_pool);
   ~LLVMJITCommandProcessor() override;
 
   Status DispatchInline(
@@ -32,6 +34,9 @@ class LLVMJITCommandProcessor final : public HostLocalCommandProcessor {
       const PushConstantBlock& push_constants,
       absl::Span<const absl::Span<const DescriptorSet::Binding>> set_bindings)
       override;
+
+ private:
+  WorkgroupPool* workgroup_pool_;
 };
 
 }  // namespace llvmjit
@@ -50,9 +50,11 @@ namespace {
 class UnsynchronizedCommandQueue final : public CommandQueue {
  public:
   UnsynchronizedCommandQueue(Allocator* allocator, std::string name,
-                             CommandCategoryBitfield supported_categories)
+                             CommandCategoryBitfield supported_categories,
+                             WorkgroupPool* workgroup_pool)
       : CommandQueue(std::move(name), supported_categories),
-        allocator_(allocator) {}
+        allocator_(allocator),
+        workgroup_pool_(workgroup_pool) {}
   ~UnsynchronizedCommandQueue() override = default;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -89,47 +91,81 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
       LLVMJITCommandProcessor command_processor(
-          allocator_, command_buffer->mode(), supported_categories());
-      RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
+          allocator_, command_buffer->mode(), supported_categories(),
+          workgroup_pool_);
+      RETURN_IF_ERROR(inproc_command_buffer->Process(
+          &command_processor, command_buffer->binding_table()));
     }
     return OkStatus();
   }
 
   Allocator* const allocator_;
+  WorkgroupPool* const workgroup_pool_;
 };
 
 }  // namespace
 
-LLVMJITDevice::LLVMJITDevice(DeviceInfo device_info)
-    : Device(std::move(device_info)) {
+LLVMJITDevice::LLVMJITDevice(DeviceInfo device_info,
+                             WorkgroupPool::Options workgroup_pool_options,
+                             HostBufferPool::Options allocator_pool_options,
+                             ref_ptr<TaskExecutor> executor,
+                             std::string object_cache_dir)
+    : Device(std::move(device_info)),
+      allocator_(std::move(allocator_pool_options)),
+      object_cache_(
+          absl::make_unique<LLVMJITObjectCache>(std::move(object_cache_dir))),
+      workgroup_pool_(
+          absl::make_unique<WorkgroupPool>(std::move(workgroup_pool_options))) {
   // We currently only expose a single command queue.
   auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
       &allocator_, "cpu0",
-      CommandCategory::kTransfer | CommandCategory::kDispatch);
+      CommandCategory::kTransfer | CommandCategory::kDispatch,
+      workgroup_pool_.get());
 
   // TODO(benvanik): allow injection of the wrapper type to support
   // SyncCommandQueue without always linking in both.
-  auto async_command_queue =
-      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
+  auto async_command_queue = absl::make_unique<AsyncCommandQueue>(
+      std::move(command_queue), std::move(executor));
   command_queues_.push_back(std::move(async_command_queue));
 }
 
 StatusOr<ref_ptr<LLVMJITDevice>> LLVMJITDevice::CreateLLVMJITDevice(
-    DeviceInfo device_info) {
-  return make_ref<LLVMJITDevice>(device_info);
+    DeviceInfo device_info, WorkgroupPool::Options workgroup_pool_options,
+    HostBufferPool::Options allocator_pool_options,
+    ref_ptr<TaskExecutor> executor, std::string object_cache_dir) {
+  return make_ref<LLVMJITDevice>(device_info, std::move(workgroup_pool_options),
+                                 std::move(allocator_pool_options),
+                                 std::move(executor),
+                                 std::move(object_cache_dir));
 }
 
 LLVMJITDevice::~LLVMJITDevice() = default;
 
 std::string LLVMJITDevice::DebugString() const {
+  std::string object_cache_info = absl::StrCat(
+      object_cache_->cache_dir().empty() ? "in-memory"
+                                         : object_cache_->cache_dir(),
+      " (", object_cache_->hit_count(), " hits, ",
+      object_cache_->miss_count(), " misses)");
   return absl::StrCat(Device::DebugString(),  //
                       "\n[LLVMJITDevice]",    //
-                      "\n  Command Queues: ", command_queues_.size());
+                      "\n  Command Queues: ", command_queues_.size(),
+                      "\n  Workgroup Workers: ",
+                      workgroup_pool_->worker_count(),
+                      "\n  Object Cache: ", object_cache_info);
 }
 
 ref_ptr<ExecutableCache> LLVMJITDevice::CreateExecutableCache() {
   IREE_TRACE_SCOPE0("LLVMJITDevice::CreateExecutableCache");
-  return make_ref<LLVMJITExecutableCache>(&allocator_);
+  return make_ref<LLVMJITExecutableCache>(&allocator_, object_cache_.get());
+}
+
+StatusOr<ref_ptr<ExecutableCache>> LLVMJITDevice::CreateExecutableCache(
+    absl::Span<const uint8_t> initial_data) {
+  IREE_TRACE_SCOPE0("LLVMJITDevice::CreateExecutableCache");
+  // Compiled objects are shared by all caches created from this device.
+  RETURN_IF_ERROR(object_cache_->Deserialize(initial_data));
+  return make_ref<LLVMJITExecutableCache>(&allocator_, object_cache_.get());
 }
 
 StatusOr<ref_ptr<DescriptorSetLayout>> LLVMJITDevice::CreateDescriptorSetLayout(
@@ -174,10 +210,7 @@ StatusOr<ref_ptr<BinarySemaphore>> LLVMJITDevice::CreateBinarySemaphore(
 StatusOr<ref_ptr<TimelineSemaphore>> LLVMJITDevice::CreateTimelineSemaphore(
     uint64_t initial_value) {
   IREE_TRACE_SCOPE0("LLVMJITDevice::CreateTimelineSemaphore");
-
-  // TODO(b/140141417): implement timeline semaphores.
-  return UnimplementedErrorBuilder(IREE_LOC)
-         << "Timeline semaphores not yet implemented";
+  return make_ref<HostTimelineSemaphore>(initial_value);
 }
 
 StatusOr<ref_ptr<Fence>> LLVMJITDevice::CreateFence(uint64_t initial_value) {
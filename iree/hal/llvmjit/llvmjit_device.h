@@ -20,6 +20,9 @@
 #include "iree/base/memory.h"
 #include "iree/hal/device.h"
 #include "iree/hal/host/host_local_allocator.h"
+#include "iree/hal/host/task_executor.h"
+#include "iree/hal/host/workgroup_pool.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -27,9 +30,16 @@ namespace llvmjit {
 
 class LLVMJITDevice final : public Device {
  public:
+  // Compiled objects are retained in memory for the lifetime of the device and
+  // also persisted to |object_cache_dir| if not empty.
   static StatusOr<ref_ptr<LLVMJITDevice>> CreateLLVMJITDevice(
-      DeviceInfo device_info);
-  explicit LLVMJITDevice(DeviceInfo device_info);
+      DeviceInfo device_info, WorkgroupPool::Options workgroup_pool_options,
+      HostBufferPool::Options allocator_pool_options,
+      ref_ptr<TaskExecutor> executor, std::string object_cache_dir = "");
+  LLVMJITDevice(DeviceInfo device_info,
+                WorkgroupPool::Options workgroup_pool_options,
+                HostBufferPool::Options allocator_pool_options,
+                ref_ptr<TaskExecutor> executor, std::string object_cache_dir);
   ~LLVMJITDevice() override;
 
   std::string DebugString() const override;
@@ -45,6 +55,8 @@ class LLVMJITDevice final : public Device {
   }
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+  StatusOr<ref_ptr<ExecutableCache>> CreateExecutableCache(
+      absl::Span<const uint8_t> initial_data) override;
 
   StatusOr<ref_ptr<DescriptorSetLayout>> CreateDescriptorSetLayout(
       DescriptorSetLayout::UsageType usage_type,
@@ -76,8 +88,15 @@ class LLVMJITDevice final : public Device {
 
   Status WaitIdle(absl::Time deadline) override;
 
+  // Returns the persistent object cache, if enabled.
+  LLVMJITObjectCache* object_cache() const { return object_cache_.get(); }
+
  private:
   mutable HostLocalAllocator allocator_;
+  // Shared by all executable caches and must outlive them.
+  std::unique_ptr<LLVMJITObjectCache> object_cache_;
+  // Must outlive the command queues as they dispatch workgroups into it.
+  std::unique_ptr<WorkgroupPool> workgroup_pool_;
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 1> command_queues_;
 };
 
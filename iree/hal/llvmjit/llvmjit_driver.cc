@@ -37,7 +37,8 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-LLVMJITDriver::LLVMJITDriver() : Driver("llvmjit") {}
+LLVMJITDriver::LLVMJITDriver(Options options)
+    : Driver("llvmjit"), options_(std::move(options)) {}
 
 LLVMJITDriver::~LLVMJITDriver() = default;
 
@@ -53,7 +54,11 @@ StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDevice(
     DriverDeviceID device_id) {
-  return LLVMJITDevice::CreateLLVMJITDevice(GetDefaultDeviceInfo());
+  return LLVMJITDevice::CreateLLVMJITDevice(
+      GetDefaultDeviceInfo(), options_.workgroup_pool_options,
+      options_.allocator_pool_options,
+      TaskExecutor::GetOrCreateShared(options_.executor_options),
+      options_.object_cache_dir);
 }
 
 }  // namespace llvmjit
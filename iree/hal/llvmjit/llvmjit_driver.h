@@ -15,7 +15,12 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 
+#include <string>
+
 #include "iree/hal/driver.h"
+#include "iree/hal/host/host_buffer_pool.h"
+#include "iree/hal/host/task_executor.h"
+#include "iree/hal/host/workgroup_pool.h"
 
 namespace iree {
 namespace hal {
@@ -23,7 +28,21 @@ namespace llvmjit {
 
 class LLVMJITDriver final : public Driver {
  public:
-  LLVMJITDriver();
+  struct Options {
+    // Controls the threads used to execute dispatch workgroups on each device.
+    WorkgroupPool::Options workgroup_pool_options;
+    // Controls the caching of buffer memory by the allocator of each device.
+    HostBufferPool::Options allocator_pool_options;
+    // Controls the threads used to execute queue submissions. These are
+    // shared with all other host devices and only used if the shared
+    // executor has not yet been created.
+    TaskExecutor::Options executor_options;
+    // Directory used to persist JIT compiled objects across processes.
+    // Disabled if empty.
+    std::string object_cache_dir;
+  };
+
+  explicit LLVMJITDriver(Options options);
   ~LLVMJITDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +50,9 @@ class LLVMJITDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  Options options_;
 };
 
 }  // namespace llvmjit
@@ -13,13 +13,30 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/strings/numbers.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
+#include "iree/hal/host/host_buffer_pool_flags.h"
+#include "iree/hal/host/task_executor_flags.h"
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 #include "llvm/Support/TargetSelect.h"
 
+ABSL_FLAG(int, llvmjit_worker_count, 0,
+          "Number of threads used to execute dispatch workgroups, including "
+          "the submitting thread. 0 uses one per hardware thread.");
+ABSL_FLAG(std::vector<std::string>, llvmjit_worker_affinity, {},
+          "Comma-separated logical CPU IDs to pin workgroup worker threads to. "
+          "The submitting thread is not pinned.");
+ABSL_FLAG(std::string, llvmjit_object_cache_dir, "",
+          "Directory used to persist JIT compiled executable objects. "
+          "Executables found in the cache are loaded without recompiling. "
+          "The directory may be shared by multiple processes.");
+
 namespace iree {
 namespace hal {
 namespace llvmjit {
@@ -27,7 +44,27 @@ namespace llvmjit {
 static StatusOr<ref_ptr<Driver>> CreateLLVMJITDriver() {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
-  return make_ref<LLVMJITDriver>();
+
+  // Setup driver options from flags. We do this here as we want to enable other
+  // consumers that may not be using modules/command line flags to be able to
+  // set their options however they want.
+  LLVMJITDriver::Options options;
+  options.workgroup_pool_options.worker_count =
+      absl::GetFlag(FLAGS_llvmjit_worker_count);
+  for (const auto& cpu_str : absl::GetFlag(FLAGS_llvmjit_worker_affinity)) {
+    int cpu = 0;
+    if (!absl::SimpleAtoi(cpu_str, &cpu) || cpu < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Invalid --llvmjit_worker_affinity CPU ID '" << cpu_str << "'";
+    }
+    options.workgroup_pool_options.worker_affinity.push_back(cpu);
+  }
+  ASSIGN_OR_RETURN(options.allocator_pool_options,
+                   GetHostBufferPoolOptionsFromFlags());
+  ASSIGN_OR_RETURN(options.executor_options, GetTaskExecutorOptionsFromFlags());
+  options.object_cache_dir = absl::GetFlag(FLAGS_llvmjit_object_cache_dir);
+
+  return make_ref<LLVMJITDriver>(std::move(options));
 }
 
 }  // namespace llvmjit
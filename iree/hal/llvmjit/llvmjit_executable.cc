@@ -23,6 +23,9 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/Error.h"
@@ -35,7 +38,8 @@ namespace llvmjit {
 
 // static
 StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
-    hal::Allocator* allocator, ExecutableSpec spec, bool allow_aliasing_data) {
+    hal::Allocator* allocator, ExecutableSpec spec, bool allow_aliasing_data,
+    LLVMJITObjectCache* object_cache) {
   auto module_def =
       ::flatbuffers::GetRoot<LLVMIRExecutableDef>(spec.executable_data.data());
   auto data =
@@ -50,9 +54,42 @@ StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
     return InvalidArgumentErrorBuilder(IREE_LOC) << "Can't parse LLVMIR Module";
   auto dataLayout = module->getDataLayout();
   const auto entry_points = module_def->entry_points();
+
+  llvm::orc::LLJITBuilder ll_jit_builder;
+  if (object_cache) {
+    auto target_machine_builder =
+        llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (!target_machine_builder) {
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Can't detect host target: "
+             << llvm::toString(target_machine_builder.takeError());
+    }
+    // The object cache identifies modules by their identifier.
+    module->setModuleIdentifier(LLVMJITObjectCache::ComputeModuleKey(
+        absl::MakeConstSpan(module_def->llvmir_module()->data(),
+                            module_def->llvmir_module()->size()),
+        *target_machine_builder));
+    ll_jit_builder.setJITTargetMachineBuilder(
+        std::move(*target_machine_builder));
+    ll_jit_builder.setCompileFunctionCreator(
+        [object_cache](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<
+                std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          auto target_machine = jtmb.createTargetMachine();
+          if (!target_machine) return target_machine.takeError();
+          return std::make_unique<llvm::orc::TMOwningSimpleCompiler>(
+              std::move(*target_machine), object_cache);
+        });
+  }
+
   llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
                                                  std::move(llvm_context));
-  auto ll_jit = llvm::cantFail(llvm::orc::LLJITBuilder().create());
+  auto ll_jit_or = ll_jit_builder.create();
+  if (!ll_jit_or) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create LLJIT: " << llvm::toString(ll_jit_or.takeError());
+  }
+  auto ll_jit = std::move(*ll_jit_or);
 
   llvm::Error err = ll_jit->addIRModule(std::move(thread_safe_module));
   if (err)
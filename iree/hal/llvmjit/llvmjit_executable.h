@@ -22,6 +22,7 @@
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_spec.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
@@ -34,9 +35,11 @@ struct MemrefType;
 
 class LLVMJITExecutable final : public Executable {
  public:
-  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(hal::Allocator* allocator,
-                                                   ExecutableSpec spec,
-                                                   bool allow_aliasing_data);
+  // Loads the executable in |spec|. If |object_cache| is provided then it is
+  // used to load previously compiled objects and store newly compiled ones.
+  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(
+      hal::Allocator* allocator, ExecutableSpec spec, bool allow_aliasing_data,
+      LLVMJITObjectCache* object_cache = nullptr);
   LLVMJITExecutable(hal::Allocator* allocator, ExecutableSpec spec,
                     std::unique_ptr<llvm::orc::LLJIT> ll_jit,
                     bool allow_aliasing_data);
@@ -24,11 +24,18 @@ namespace iree {
 namespace hal {
 namespace llvmjit {
 
-LLVMJITExecutableCache::LLVMJITExecutableCache(hal::Allocator* allocator)
-    : allocator_(allocator) {}
+LLVMJITExecutableCache::LLVMJITExecutableCache(
+    hal::Allocator* allocator, LLVMJITObjectCache* object_cache)
+    : allocator_(allocator), object_cache_(object_cache) {}
 
 LLVMJITExecutableCache::~LLVMJITExecutableCache() = default;
 
+StatusOr<std::vector<uint8_t>> LLVMJITExecutableCache::Serialize() const {
+  IREE_TRACE_SCOPE0("LLVMJITExecutableCache::Serialize");
+  if (!object_cache_) return std::vector<uint8_t>{};
+  return object_cache_->Serialize();
+}
+
 bool LLVMJITExecutableCache::CanPrepareFormat(ExecutableFormat format) const {
   return format == kExecutableFormatLLVM;
 }
@@ -43,7 +50,8 @@ StatusOr<ref_ptr<Executable>> LLVMJITExecutableCache::PrepareExecutable(
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
   ASSIGN_OR_RETURN(
       auto executable,
-      LLVMJITExecutable::Load(allocator_, spec, !allow_aliasing_data));
+      LLVMJITExecutable::Load(allocator_, spec, !allow_aliasing_data,
+                              object_cache_));
 
   return executable;
 }
@@ -18,6 +18,7 @@
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -25,9 +26,15 @@ namespace llvmjit {
 
 class LLVMJITExecutableCache final : public ExecutableCache {
  public:
-  explicit LLVMJITExecutableCache(hal::Allocator* allocator);
+  // |object_cache| is optional and must outlive the executable cache. The
+  // object cache may be shared with other executable caches, in which case the
+  // serialized cache contains the objects compiled by all of them.
+  LLVMJITExecutableCache(hal::Allocator* allocator,
+                         LLVMJITObjectCache* object_cache = nullptr);
   ~LLVMJITExecutableCache() override;
 
+  StatusOr<std::vector<uint8_t>> Serialize() const override;
+
   bool CanPrepareFormat(ExecutableFormat format) const override;
 
   StatusOr<ref_ptr<Executable>> PrepareExecutable(
@@ -36,6 +43,7 @@ class LLVMJITExecutableCache final : public ExecutableCache {
 
  private:
   hal::Allocator* allocator_;
+  LLVMJITObjectCache* object_cache_;
 };
 
 }  // namespace llvmjit
@@ -0,0 +1,195 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/logging.h"
+#include "iree/base/source_location.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/executable_format.h"
+#include "iree/schemas/executable_cache_def_generated.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+LLVMJITObjectCache::LLVMJITObjectCache(std::string cache_dir)
+    : cache_dir_(std::move(cache_dir)) {
+  if (cache_dir_.empty()) return;
+  if (auto ec = llvm::sys::fs::create_directories(cache_dir_)) {
+    LOG(WARNING) << "Unable to create LLVMJIT object cache directory '"
+                 << cache_dir_ << "': " << ec.message();
+  }
+}
+
+LLVMJITObjectCache::~LLVMJITObjectCache() = default;
+
+// static
+std::string LLVMJITObjectCache::ComputeModuleKey(
+    absl::Span<const uint8_t> module_data,
+    const llvm::orc::JITTargetMachineBuilder& target_machine_builder) {
+  // The object code depends on both the module contents and everything that
+  // influences code generation for the host.
+  llvm::SHA1 hasher;
+  hasher.update(llvm::ArrayRef<uint8_t>(module_data.data(),
+                                        module_data.size()));
+  hasher.update(target_machine_builder.getTargetTriple().str());
+  hasher.update(target_machine_builder.getCPU());
+  hasher.update(target_machine_builder.getFeatures().getString());
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string LLVMJITObjectCache::GetObjectPath(
+    const llvm::Module* module) const {
+  llvm::SmallString<256> path(cache_dir_);
+  llvm::sys::path::append(path, module->getModuleIdentifier() + ".o");
+  return path.str().str();
+}
+
+StatusOr<std::vector<uint8_t>> LLVMJITObjectCache::Serialize() const {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Serialize");
+  ::flatbuffers::FlatBufferBuilder fbb;
+  std::vector<::flatbuffers::Offset<iree::ExecutableCacheEntryDef>> entries;
+  {
+    absl::MutexLock lock(&mutex_);
+    entries.reserve(objects_.size());
+    for (const auto& it : objects_) {
+      auto key_offset = fbb.CreateString(it.first);
+      auto data_offset = fbb.CreateVector(
+          reinterpret_cast<const uint8_t*>(it.second.data()),
+          it.second.size());
+      entries.push_back(
+          iree::CreateExecutableCacheEntryDef(fbb, key_offset, data_offset));
+    }
+  }
+  auto entries_offset = fbb.CreateVector(entries);
+  iree::FinishExecutableCacheDefBuffer(
+      fbb, iree::CreateExecutableCacheDef(fbb, kExecutableFormatLLVM,
+                                          entries_offset));
+  return std::vector<uint8_t>(fbb.GetBufferPointer(),
+                              fbb.GetBufferPointer() + fbb.GetSize());
+}
+
+Status LLVMJITObjectCache::Deserialize(absl::Span<const uint8_t> data) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Deserialize");
+  if (data.empty()) return OkStatus();
+  ::flatbuffers::Verifier verifier(data.data(), data.size());
+  if (!iree::VerifyExecutableCacheDefBuffer(verifier)) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Supplied cache data does not contain a valid ExecutableCacheDef";
+  }
+  const auto& cache_def =
+      *::flatbuffers::GetRoot<iree::ExecutableCacheDef>(data.data());
+  if (cache_def.format() != kExecutableFormatLLVM || !cache_def.entries()) {
+    // Produced by another driver; nothing we can use.
+    return OkStatus();
+  }
+
+  // Objects compiled for another target are keyed differently and will never
+  // be looked up, so there's no need to filter them here.
+  absl::MutexLock lock(&mutex_);
+  for (const auto* entry_def : *cache_def.entries()) {
+    if (!entry_def->key() || !entry_def->data()) continue;
+    objects_.emplace(
+        entry_def->key()->str(),
+        std::string(reinterpret_cast<const char*>(entry_def->data()->data()),
+                    entry_def->data()->size()));
+  }
+  return OkStatus();
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::notifyObjectCompiled");
+  {
+    absl::MutexLock lock(&mutex_);
+    objects_[module->getModuleIdentifier()] = object.getBuffer().str();
+  }
+  if (!cache_dir_.empty()) {
+    WriteObjectFile(module, object);
+  }
+}
+
+void LLVMJITObjectCache::WriteObjectFile(const llvm::Module* module,
+                                         llvm::MemoryBufferRef object) {
+  // Write to a unique temporary file and then rename it into place so that
+  // concurrent processes sharing the directory never observe partial objects.
+  std::string object_path = GetObjectPath(module);
+  int fd = -1;
+  llvm::SmallString<256> temp_path;
+  if (auto ec = llvm::sys::fs::createUniqueFile(object_path + ".%%%%%%.tmp",
+                                                fd, temp_path)) {
+    LOG(WARNING) << "Unable to create LLVMJIT object cache file: "
+                 << ec.message();
+    return;
+  }
+  {
+    llvm::raw_fd_ostream stream(fd, /*shouldClose=*/true);
+    stream << object.getBuffer();
+    if (stream.has_error()) {
+      stream.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      LOG(WARNING) << "Unable to write LLVMJIT object cache file '"
+                   << temp_path.str().str() << "'";
+      return;
+    }
+  }
+  if (auto ec = llvm::sys::fs::rename(temp_path, object_path)) {
+    llvm::sys::fs::remove(temp_path);
+    LOG(WARNING) << "Unable to commit LLVMJIT object cache file '"
+                 << object_path << "': " << ec.message();
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(
+    const llvm::Module* module) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::getObject");
+  const std::string& key = module->getModuleIdentifier();
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = objects_.find(key);
+    if (it != objects_.end()) {
+      ++hit_count_;
+      return llvm::MemoryBuffer::getMemBufferCopy(it->second, key);
+    }
+  }
+  if (cache_dir_.empty()) {
+    ++miss_count_;
+    return nullptr;
+  }
+  auto buffer_or = llvm::MemoryBuffer::getFile(GetObjectPath(module));
+  if (!buffer_or) {
+    ++miss_count_;
+    return nullptr;
+  }
+  ++hit_count_;
+  {
+    absl::MutexLock lock(&mutex_);
+    objects_.emplace(key, (*buffer_or)->getBuffer().str());
+  }
+  return std::move(*buffer_or);
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
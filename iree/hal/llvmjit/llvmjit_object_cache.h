@@ -0,0 +1,95 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// An llvm::ObjectCache that retains JIT compiled objects in memory and
+// optionally persists them to a directory. Processes loading the same
+// executables on the same target (such as after a restart or on another replica
+// sharing the directory) load the compiled objects instead of running code
+// generation again. The in-memory objects can also be carried between processes
+// with Serialize/Deserialize when no shared directory is available.
+//
+// Modules are identified by their module identifier, which must be set to the
+// key returned by ComputeModuleKey prior to being added to the JIT.
+// Thread-safe.
+class LLVMJITObjectCache final : public llvm::ObjectCache {
+ public:
+  // Objects are only retained in memory if |cache_dir| is empty.
+  explicit LLVMJITObjectCache(std::string cache_dir = "");
+  ~LLVMJITObjectCache() override;
+
+  // Returns a key uniquely identifying the object code produced for the
+  // |module_data| compiled with |target_machine_builder|.
+  static std::string ComputeModuleKey(
+      absl::Span<const uint8_t> module_data,
+      const llvm::orc::JITTargetMachineBuilder& target_machine_builder);
+
+  const std::string& cache_dir() const { return cache_dir_; }
+
+  // Serializes all objects compiled or loaded by the cache.
+  StatusOr<std::vector<uint8_t>> Serialize() const;
+
+  // Adds all objects from |data| produced by Serialize to the in-memory cache.
+  Status Deserialize(absl::Span<const uint8_t> data);
+
+  // Total number of objects loaded from the cache.
+  int64_t hit_count() const { return hit_count_; }
+  // Total number of objects that were not found in the cache and compiled.
+  int64_t miss_count() const { return miss_count_; }
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  std::string GetObjectPath(const llvm::Module* module) const;
+  void WriteObjectFile(const llvm::Module* module,
+                       llvm::MemoryBufferRef object);
+
+  std::string cache_dir_;
+  mutable absl::Mutex mutex_;
+  // Object file contents keyed by module key.
+  absl::flat_hash_map<std::string, std::string> objects_
+      ABSL_GUARDED_BY(mutex_);
+  std::atomic<int64_t> hit_count_{0};
+  std::atomic<int64_t> miss_count_{0};
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
@@ -0,0 +1,70 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include "iree/base/status_matchers.h"
+#include "iree/testing/gtest.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+TEST(LLVMJITObjectCacheTest, SerializeRoundTrip) {
+  llvm::LLVMContext context;
+  llvm::Module module_a("key_a", context);
+  llvm::Module module_b("key_b", context);
+  llvm::Module module_c("key_c", context);
+
+  std::vector<uint8_t> cache_data;
+  {
+    LLVMJITObjectCache cache;
+    EXPECT_EQ(nullptr, cache.getObject(&module_a));
+    EXPECT_EQ(1, cache.miss_count());
+    cache.notifyObjectCompiled(&module_a,
+                               llvm::MemoryBufferRef("object a", "key_a"));
+    cache.notifyObjectCompiled(&module_b,
+                               llvm::MemoryBufferRef("object b", "key_b"));
+    ASSERT_OK_AND_ASSIGN(cache_data, cache.Serialize());
+  }
+
+  // A new cache loads the objects without them being compiled again.
+  LLVMJITObjectCache cache;
+  ASSERT_OK(cache.Deserialize(cache_data));
+  auto object_a = cache.getObject(&module_a);
+  ASSERT_NE(nullptr, object_a);
+  EXPECT_EQ("object a", object_a->getBuffer().str());
+  auto object_b = cache.getObject(&module_b);
+  ASSERT_NE(nullptr, object_b);
+  EXPECT_EQ("object b", object_b->getBuffer().str());
+  EXPECT_EQ(nullptr, cache.getObject(&module_c));
+  EXPECT_EQ(2, cache.hit_count());
+  EXPECT_EQ(1, cache.miss_count());
+}
+
+TEST(LLVMJITObjectCacheTest, RejectsInvalidData) {
+  LLVMJITObjectCache cache;
+  std::vector<uint8_t> garbage(64, 0xCD);
+  EXPECT_TRUE(IsInvalidArgument(cache.Deserialize(garbage)));
+  ASSERT_OK(cache.Deserialize({}));
+}
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
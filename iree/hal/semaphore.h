@@ -15,7 +15,11 @@
 #ifndef IREE_HAL_SEMAPHORE_H_
 #define IREE_HAL_SEMAPHORE_H_
 
+#include <cstdint>
+
+#include "absl/time/time.h"
 #include "absl/types/variant.h"
+#include "iree/base/status.h"
 #include "iree/hal/resource.h"
 
 namespace iree {
@@ -45,8 +49,19 @@ class BinarySemaphore : public Semaphore {
 // efficient due to system-level coalescing.
 class TimelineSemaphore : public Semaphore {
  public:
-  // TODO(benvanik): add value query support.
-  // TODO(benvanik): add host-side signal/wait.
+  // Queries the current payload of the semaphore. As the payload is
+  // monotonically increasing it is guaranteed that the value is at least equal
+  // to the previous result of a QueryValue call.
+  virtual StatusOr<uint64_t> QueryValue() = 0;
+
+  // Signals the semaphore from the host, setting the payload to |value|.
+  // |value| must be greater than the current payload.
+  virtual Status Signal(uint64_t value) = 0;
+
+  // Blocks the caller until the payload is greater-than or equal-to |value| or
+  // the |deadline| elapses. Returns the failure status if the semaphore has
+  // failed.
+  virtual Status Wait(uint64_t value, absl::Time deadline) = 0;
 };
 
 // A reference to a strongly-typed semaphore and associated information.
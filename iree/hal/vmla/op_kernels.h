@@ -29,12 +29,13 @@
 // All kernels are templated to enable specialization of particular types or
 // type combinations. By default the op_kernels_generic.h will provide C++
 // semantics as reference and platform-specific versions can be implemented
-// as needed.
+// as needed (such as the f32 elementwise kernels in op_kernels_simd.h).
 
 #ifndef IREE_HAL_VMLA_OP_KERNELS_H_
 #define IREE_HAL_VMLA_OP_KERNELS_H_
 
 #include <cstdint>
+#include <memory>
 
 #include "absl/types/span.h"
 #include "iree/base/shape.h"
@@ -46,6 +47,16 @@ namespace hal {
 namespace vmla {
 namespace kernels {
 
+// IEEE half precision (f16) and bfloat16 (bf16) values as stored in buffers.
+// Kernels supporting them widen to f32 for compute and round the results back
+// to nearest even (see op_kernels_simd.h); there is no generic implementation.
+struct Half {
+  uint16_t bits;
+};
+struct BFloat16 {
+  uint16_t bits;
+};
+
 struct CompareEQ {
   template <typename T>
   static Status Execute(absl::Span<const T> lhs_buffer,
@@ -83,17 +94,6 @@ struct CompareGE {
                         absl::Span<uint8_t> dst_buffer);
 };
 
-struct Conv2D {
-  template <typename T>
-  static Status Execute(absl::Span<const T> input_buffer,
-                        const Shape& input_shape,
-                        absl::Span<const T> filter_buffer,
-                        const Shape& filter_shape, absl::Span<T> dst_buffer,
-                        const Shape& dst_shape, const Shape& strides,
-                        const Shape& pad_h, const Shape& pad_w,
-                        const Shape& dilation, const int32_t groups);
-};
-
 struct Copy {
   template <int element_size>
   static Status Execute(absl::Span<const uint8_t> src_buffer,
@@ -334,33 +334,105 @@ struct Convert {
                         absl::Span<DST> dst_buffer);
 };
 
+// Bounds the threads used by MatMul (and GEMM-based kernels) across all of the
+// MatMul::RuntimeStates using it, such as those of all executables on a
+// device. See op_kernels_ruy.h.
+class MatMulThreadPool;
+
 struct MatMul {
   struct RuntimeState;
 
   static std::unique_ptr<RuntimeState> CreateRuntimeState();
 
-  template <typename T, typename ACC>
+  // Creates a thread pool allowing up to |max_threads| threads to be used by
+  // concurrently executing kernels, or one per hardware thread if 0.
+  static std::unique_ptr<MatMulThreadPool> CreateThreadPool(int max_threads);
+
+  // Operands of type T are multiplied with ACC accumulators. For integer
+  // types the DST results are either the raw accumulators (when DST is ACC)
+  // or requantized with the fixed-point multipliers (such as i8*i8->i32->i8).
+  template <typename T, typename ACC, typename DST = T>
   struct Buffers {
     Shape lhs_shape;
     absl::Span<const T> lhs_buffer;
     Shape rhs_shape;
     absl::Span<const T> rhs_buffer;
     Shape dst_shape;
-    absl::Span<T> dst_buffer;
+    absl::Span<DST> dst_buffer;
+
+    // Zero points of quantized operands and results. Must be 0 for floats.
+    T lhs_zero_point = T();
+    T rhs_zero_point = T();
+    DST dst_zero_point = DST();
 
     // Optional bias buffer.
     absl::Span<const ACC> bias_buffer;
 
     // Fixed-point multiplier mantissa/exponent. May be a single value (for
     // uniform quantization) or one element per row of the destination matrix
-    // for per-channel.
+    // for per-channel. Only used when requantizing to a DST narrower than ACC.
+    // Both buffers must have the same size.
     absl::Span<const ACC> multiplier_mantissa_buffer;
     absl::Span<const int32_t> multiplier_exponent_buffer;
   };
 
-  template <typename T, typename ACC>
+  template <typename T, typename ACC, typename DST>
   static Status Execute(RuntimeState* runtime_state,
-                        const Buffers<T, ACC>& buffers);
+                        const Buffers<T, ACC, DST>& buffers);
+};
+
+// 2D (grouped) convolution of a single example.
+//
+// |input_shape| is [H, W, C], |filter_shape| is [KH, KW, C / groups, Co] and
+// |dst_shape| is [Ho, Wo, Co]. |strides| and |dilation| are the window strides
+// and filter (rhs) dilation along H and W; |pad_h| and |pad_w| are the
+// {low, high} padding of each spatial dimension.
+struct Conv2D {
+  // Zero points and requantization of integer convolutions, matching those of
+  // MatMul::Buffers with per-channel multipliers being per output channel.
+  // Padding is filled with the input zero point.
+  template <typename T, typename ACC, typename DST>
+  struct Quantization {
+    T input_zero_point = T();
+    T filter_zero_point = T();
+    DST dst_zero_point = DST();
+    absl::Span<const ACC> multiplier_mantissa_buffer;
+    absl::Span<const int32_t> multiplier_exponent_buffer;
+  };
+
+  // Direct reference implementation (op_kernels_generic.h).
+  template <typename T>
+  static Status Execute(absl::Span<const T> input_buffer,
+                        const Shape& input_shape,
+                        absl::Span<const T> filter_buffer,
+                        const Shape& filter_shape, absl::Span<T> dst_buffer,
+                        const Shape& dst_shape, const Shape& strides,
+                        const Shape& pad_h, const Shape& pad_w,
+                        const Shape& dilation, const int32_t groups);
+
+  // GEMM implementation packing input patches (im2col) for ruy::Mul using the
+  // context and scratch storage of |runtime_state| (op_kernels_ruy.h).
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer,
+                        const Shape& input_shape,
+                        absl::Span<const T> filter_buffer,
+                        const Shape& filter_shape, absl::Span<T> dst_buffer,
+                        const Shape& dst_shape, const Shape& strides,
+                        const Shape& pad_h, const Shape& pad_w,
+                        const Shape& dilation, const int32_t groups);
+
+  // GEMM implementation of quantized (or otherwise mixed type) convolutions.
+  template <typename T, typename ACC, typename DST>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer,
+                        const Shape& input_shape,
+                        absl::Span<const T> filter_buffer,
+                        const Shape& filter_shape, absl::Span<DST> dst_buffer,
+                        const Shape& dst_shape, const Shape& strides,
+                        const Shape& pad_h, const Shape& pad_w,
+                        const Shape& dilation, const int32_t groups,
+                        const Quantization<T, ACC, DST>& quantization);
 };
 
 struct RuntimeState {
@@ -426,5 +498,6 @@ struct PoolingMax {
 
 #include "iree/hal/vmla/op_kernels_generic.h"  // IWYU pragma: export
 #include "iree/hal/vmla/op_kernels_ruy.h"      // IWYU pragma: export
+#include "iree/hal/vmla/op_kernels_simd.h"     // IWYU pragma: export
 
 #endif  // IREE_HAL_VMLA_OP_KERNELS_H_
@@ -0,0 +1,218 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the SIMD elementwise kernels against the scalar kernels (which
+// match op_kernels_generic.h) for each instruction set supported by the host.
+//
+// Arguments are {isa, element count} with isa being the simd::Isa value:
+//   0 = scalar, 1 = sse4.2, 2 = avx2, 3 = avx512
+//
+// Conv2D compares the direct reference implementation against the GEMM
+// implementation with arguments {size, input channels, output channels,
+// kernel size, groups} for a size x size input, stride 1 and same padding.
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+namespace {
+
+using iree::Shape;
+using iree::hal::vmla::kernels::Conv2D;
+using iree::hal::vmla::kernels::MatMul;
+using iree::hal::vmla::kernels::simd::DetectIsa;
+using iree::hal::vmla::kernels::simd::GetKernelTable;
+using iree::hal::vmla::kernels::simd::Isa;
+using iree::hal::vmla::kernels::simd::KernelTable;
+
+// Returns the kernel table for the benchmark's isa argument or nullptr (with
+// the benchmark skipped) if the host does not support it.
+const KernelTable* GetBenchmarkKernelTable(benchmark::State& state) {
+  Isa isa = static_cast<Isa>(state.range(0));
+  if (static_cast<int>(isa) > static_cast<int>(DetectIsa()) ||
+      !GetKernelTable(isa)) {
+    state.SkipWithError("instruction set not supported by the host");
+    return nullptr;
+  }
+  return GetKernelTable(isa);
+}
+
+// Values within the domain of all of the benchmarked kernels.
+std::vector<float> MakeInput(size_t count, float offset) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = offset + static_cast<float>(i % 1024) / 128.0f;
+  }
+  return values;
+}
+
+template <KernelTable::BinaryFn KernelTable::*kFn>
+void BM_Binary(benchmark::State& state) {
+  const KernelTable* table = GetBenchmarkKernelTable(state);
+  if (!table) return;
+  size_t count = static_cast<size_t>(state.range(1));
+  auto lhs = MakeInput(count, 0.5f);
+  auto rhs = MakeInput(count, 1.5f);
+  std::vector<float> dst(count);
+  for (auto _ : state) {
+    (table->*kFn)(lhs.data(), rhs.data(), dst.data(), count);
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * 3 * sizeof(float));
+}
+
+template <KernelTable::UnaryFn KernelTable::*kFn>
+void BM_Unary(benchmark::State& state) {
+  const KernelTable* table = GetBenchmarkKernelTable(state);
+  if (!table) return;
+  size_t count = static_cast<size_t>(state.range(1));
+  auto src = MakeInput(count, 0.25f);
+  std::vector<float> dst(count);
+  for (auto _ : state) {
+    (table->*kFn)(src.data(), dst.data(), count);
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * count * 2 * sizeof(float));
+}
+
+void BM_CompareLT(benchmark::State& state) {
+  const KernelTable* table = GetBenchmarkKernelTable(state);
+  if (!table) return;
+  size_t count = static_cast<size_t>(state.range(1));
+  auto lhs = MakeInput(count, 0.5f);
+  auto rhs = MakeInput(count, 0.0f);
+  std::vector<uint8_t> dst(count);
+  for (auto _ : state) {
+    table->compare_lt(lhs.data(), rhs.data(), dst.data(), count);
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_ConvertF32ToI32(benchmark::State& state) {
+  const KernelTable* table = GetBenchmarkKernelTable(state);
+  if (!table) return;
+  size_t count = static_cast<size_t>(state.range(1));
+  auto src = MakeInput(count, -4.0f);
+  std::vector<int32_t> dst(count);
+  for (auto _ : state) {
+    table->convert_f32_to_i32(src.data(), dst.data(), count);
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Element counts of typical activations: a 1x8x8x64 tile, a 1x56x56x64 feature
+// map and a 1x224x224x32 feature map.
+void KernelArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int isa = static_cast<int>(Isa::kScalar);
+       isa <= static_cast<int>(Isa::kAVX512); ++isa) {
+    for (int count : {4096, 200704, 1605632}) {
+      benchmark->Args({isa, count});
+    }
+  }
+}
+
+struct Conv2DProblem {
+  explicit Conv2DProblem(const benchmark::State& state)
+      : input_shape({static_cast<int>(state.range(0)),
+                     static_cast<int>(state.range(0)),
+                     static_cast<int>(state.range(1))}),
+        filter_shape({static_cast<int>(state.range(3)),
+                      static_cast<int>(state.range(3)),
+                      static_cast<int>(state.range(1) / state.range(4)),
+                      static_cast<int>(state.range(2))}),
+        dst_shape({static_cast<int>(state.range(0)),
+                   static_cast<int>(state.range(0)),
+                   static_cast<int>(state.range(2))}),
+        pad({static_cast<int>(state.range(3) / 2),
+             static_cast<int>((state.range(3) - 1) / 2)}),
+        groups(static_cast<int32_t>(state.range(4))),
+        input(MakeInput(input_shape.element_count(), -4.0f)),
+        filter(MakeInput(filter_shape.element_count(), -4.0f)),
+        dst(dst_shape.element_count()) {}
+
+  int64_t flops() const {
+    return 2ll * dst_shape.element_count() * filter_shape[0] *
+           filter_shape[1] * filter_shape[2];
+  }
+
+  Shape input_shape;
+  Shape filter_shape;
+  Shape dst_shape;
+  Shape strides = {1, 1};
+  Shape pad;
+  Shape dilation = {1, 1};
+  int32_t groups;
+  std::vector<float> input;
+  std::vector<float> filter;
+  std::vector<float> dst;
+};
+
+void BM_Conv2DReference(benchmark::State& state) {
+  Conv2DProblem p(state);
+  for (auto _ : state) {
+    Conv2D::Execute<float>(p.input, p.input_shape, p.filter, p.filter_shape,
+                           absl::MakeSpan(p.dst), p.dst_shape, p.strides,
+                           p.pad, p.pad, p.dilation, p.groups);
+    benchmark::DoNotOptimize(p.dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * p.flops());
+}
+
+void BM_Conv2DGemm(benchmark::State& state) {
+  Conv2DProblem p(state);
+  auto runtime_state = MatMul::CreateRuntimeState();
+  for (auto _ : state) {
+    Conv2D::Execute<float>(runtime_state.get(), p.input, p.input_shape,
+                           p.filter, p.filter_shape, absl::MakeSpan(p.dst),
+                           p.dst_shape, p.strides, p.pad, p.pad, p.dilation,
+                           p.groups);
+    benchmark::DoNotOptimize(p.dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * p.flops());
+}
+
+// Typical layers: a 3x3 conv of a 56x56x64 feature map, its 1x1 projection,
+// a 3x3 depthwise conv and a 3x3 conv of a 224x224 RGB image.
+void Conv2DArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->Args({56, 64, 64, 3, 1});
+  benchmark->Args({56, 64, 256, 1, 1});
+  benchmark->Args({56, 64, 64, 3, 64});
+  benchmark->Args({224, 3, 32, 3, 1});
+}
+
+BENCHMARK_TEMPLATE(BM_Binary, &KernelTable::add)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Binary, &KernelTable::mul)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Binary, &KernelTable::max)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Unary, &KernelTable::exp)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Unary, &KernelTable::log)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Unary, &KernelTable::tanh)->Apply(KernelArgs);
+BENCHMARK_TEMPLATE(BM_Unary, &KernelTable::rsqrt)->Apply(KernelArgs);
+BENCHMARK(BM_CompareLT)->Apply(KernelArgs);
+BENCHMARK(BM_ConvertF32ToI32)->Apply(KernelArgs);
+BENCHMARK(BM_Conv2DReference)->Apply(Conv2DArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Conv2DGemm)->Apply(Conv2DArgs)->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -164,17 +164,19 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer,
                        const Shape& dst_shape, const Shape& window_strides,
                        const Shape& pad_h, const Shape& pad_w,
                        const Shape& dilation, const int32_t groups) {
+  const int output_group_size = dst_shape[2] / groups;
+  const int input_group_size = input_shape[2] / groups;
   const Shape input_strides = {input_shape[1] * input_shape[2], input_shape[2],
                                1};
+  // The filter is [KH, KW, C / groups, Co]; the channel extents are derived
+  // from the input and output so that only the spatial extents are read.
   const Shape filter_strides = {
-      filter_shape[1] * filter_shape[2] * filter_shape[3],
-      filter_shape[2] * filter_shape[3], filter_shape[3], 1};
+      filter_shape[1] * input_group_size * dst_shape[2],
+      input_group_size * dst_shape[2], dst_shape[2], 1};
   const Shape dst_strides = {dst_shape[1] * dst_shape[2], dst_shape[2], 1};
   // Direct 2d (grouped) convolution slow implementation. ref:
   // https://www.tensorflow.org/versions/r2.0/api_docs/python/tf/nn/convolution)
-  // TODO(ataei): Implement tiled GEMM based implementation.
-  const int output_group_size = dst_shape[2] / groups;
-  const int input_group_size = input_shape[2] / groups;
+  // See op_kernels_ruy.h for the GEMM based implementation.
   for (int ho = 0; ho < dst_shape[0]; ho++) {
     for (int wo = 0; wo < dst_shape[1]; wo++) {
       for (int g = 0; g < groups; ++g) {
@@ -182,19 +184,20 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer,
           const int cg_o = g * output_group_size + co;
           const int y_i = ho * dst_strides[0] + wo * dst_strides[1] + cg_o;
           T dst_value = T(0);
-          for (int ci = 0; ci < input_group_size; ci++) {
-            for (int kh = 0; kh < filter_shape[0]; kh++) {
-              const int ih = ho * window_strides[0] + kh - pad_h[0];
+          for (int kh = 0; kh < filter_shape[0]; kh++) {
+            const int ih = ho * window_strides[0] + kh * dilation[0] - pad_h[0];
+            // top-bottom padding condition.
+            if (ih < 0 || ih >= input_shape[0]) continue;
+            for (int kw = 0; kw < filter_shape[1]; kw++) {
               // left-right padding condition.
-              if (ih < 0 || ih >= input_shape[0]) continue;
-              for (int kw = 0; kw < filter_shape[1]; kw++) {
-                // top-bottom padding condition.
-                const int iw = wo * window_strides[1] + kw - pad_w[0];
-                if (iw < 0 || iw >= input_shape[1]) continue;
+              const int iw =
+                  wo * window_strides[1] + kw * dilation[1] - pad_w[0];
+              if (iw < 0 || iw >= input_shape[1]) continue;
+              for (int ci = 0; ci < input_group_size; ci++) {
                 const int cg_i = g * input_group_size + ci;
-                const int w_i = kh * dilation[0] * filter_strides[0] +
-                                kw * dilation[1] * filter_strides[1] +
-                                cg_i * filter_strides[2] + co;
+                const int w_i = kh * filter_strides[0] +
+                                kw * filter_strides[1] +
+                                ci * filter_strides[2] + cg_o;
                 const int x_i =
                     ih * input_strides[0] + iw * input_strides[1] + cg_i;
                 dst_value += input_buffer[x_i] * filter_buffer[w_i];
@@ -15,8 +15,17 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <vector>
+
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "ruy/context.h"
 #include "ruy/ruy.h"
@@ -26,50 +35,389 @@ namespace hal {
 namespace vmla {
 namespace kernels {
 
-// TODO(benvanik): something more clever for making this shareable.
-// Maybe a factory fn based on the impl selected?
+// Shares a budget of threads between all of the ruy contexts it hands out.
+//
+// ruy contexts own their threads and cannot share them with other contexts, so
+// instead contexts (and the threads they have started) are reused across
+// kernel invocations and each is limited to a share of the budget not
+// currently held by other contexts. Concurrently executing kernels then
+// divide the cores between them instead of each using all of them.
+class MatMulThreadPool {
+ public:
+  explicit MatMulThreadPool(int max_threads)
+      : max_threads_(max_threads > 0
+                         ? max_threads
+                         : std::max(1u, std::thread::hardware_concurrency())) {
+  }
+
+  // Maximum number of threads used by all contexts combined.
+  int max_threads() const { return max_threads_; }
+
+  // Acquires a context not in use by any other thread that will use up to
+  // |thread_hint| threads (or max_threads() if 0) including the calling
+  // thread. Fewer threads are used if other contexts hold the remainder of
+  // the budget. The context must be returned with ReleaseContext.
+  std::unique_ptr<ruy::Context> AcquireContext(int thread_hint) {
+    absl::MutexLock lock(&mutex_);
+    std::unique_ptr<ruy::Context> context;
+    if (!free_contexts_.empty()) {
+      context = std::move(free_contexts_.back());
+      free_contexts_.pop_back();
+    } else {
+      context = absl::make_unique<ruy::Context>();
+    }
+    int thread_count = thread_hint > 0 ? std::min(thread_hint, max_threads_)
+                                       : max_threads_;
+    thread_count =
+        std::max(1, std::min(thread_count, max_threads_ - threads_in_use_));
+    context->set_max_num_threads(thread_count);
+    threads_in_use_ += thread_count;
+    return context;
+  }
+
+  // Returns |context| to the pool for reuse by future invocations.
+  void ReleaseContext(std::unique_ptr<ruy::Context> context) {
+    absl::MutexLock lock(&mutex_);
+    threads_in_use_ -= context->max_num_threads();
+    free_contexts_.push_back(std::move(context));
+  }
+
+ private:
+  const int max_threads_;
+  absl::Mutex mutex_;
+  int threads_in_use_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<std::unique_ptr<ruy::Context>> free_contexts_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
+  // Context used when no thread pool is set.
   ruy::Context context;
+
+  // Thread pool shared with other runtime states (such as those of all
+  // executables on a device) and the number of threads each kernel should use
+  // from it, or 0 to use as many as are available. Set per dispatch.
+  MatMulThreadPool* thread_pool = nullptr;
+  int thread_hint = 0;
+
+  // Scratch storage for packed Conv2D input patches, reused across calls.
+  std::vector<uint8_t> conv_patch_buffer;
+
+  // Scratch storage for f16/bf16 operands and results widened to f32, reused
+  // across calls (see op_kernels_simd.h).
+  std::vector<float> widened_buffer;
 };
 
 inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
   return absl::make_unique<RuntimeState>();
 }
 
-template <typename T, typename ACC>
+inline std::unique_ptr<MatMulThreadPool> MatMul::CreateThreadPool(
+    int max_threads) {
+  return absl::make_unique<MatMulThreadPool>(max_threads);
+}
+
+namespace impl {
+
+// Provides the ruy context for a kernel invocation, acquired from the thread
+// pool of |runtime_state| for the duration of the scope if it has one.
+class ScopedRuyContext {
+ public:
+  explicit ScopedRuyContext(MatMul::RuntimeState* runtime_state)
+      : thread_pool_(runtime_state->thread_pool) {
+    if (thread_pool_) {
+      pooled_context_ =
+          thread_pool_->AcquireContext(runtime_state->thread_hint);
+      context_ = pooled_context_.get();
+    } else {
+      context_ = &runtime_state->context;
+    }
+  }
+  ~ScopedRuyContext() {
+    if (thread_pool_) thread_pool_->ReleaseContext(std::move(pooled_context_));
+  }
+
+  ruy::Context* get() const { return context_; }
+
+ private:
+  MatMulThreadPool* thread_pool_;
+  std::unique_ptr<ruy::Context> pooled_context_;
+  ruy::Context* context_;
+};
+
+}  // namespace impl
+
+namespace impl {
+
+// Sets the fixed-point requantization multipliers of |mul_params|. A single
+// multiplier applies to all rows while more provide one per row (channel).
+template <typename ACC, typename DST>
+void SetMultipliers(absl::Span<const ACC> mantissas,
+                    absl::Span<const int32_t> exponents,
+                    ruy::MulParams<ACC, DST>* mul_params, std::true_type) {
+  if (mantissas.size() == 1) {
+    mul_params->set_multiplier_fixedpoint(mantissas[0]);
+    mul_params->set_multiplier_exponent(exponents[0]);
+  } else if (!mantissas.empty()) {
+    mul_params->set_multiplier_fixedpoint_perchannel(mantissas.data());
+    mul_params->set_multiplier_exponent_perchannel(exponents.data());
+  }
+}
+
+// Ensures the multiplier mantissas and exponents are either both uniform or
+// both per-channel; SetMultipliers picks the path from the mantissas alone.
+// Per-channel multipliers must cover all |channel_count| output channels as
+// ruy reads one for each row of the destination.
+template <typename ACC>
+Status ValidateMultipliers(absl::Span<const ACC> mantissas,
+                           absl::Span<const int32_t> exponents,
+                           int channel_count) {
+  if (mantissas.size() != exponents.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Requantization multiplier mantissa count " << mantissas.size()
+           << " does not match exponent count " << exponents.size();
+  }
+  if (mantissas.size() > 1 &&
+      mantissas.size() != static_cast<size_t>(channel_count)) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Per-channel requantization multiplier count " << mantissas.size()
+           << " does not match output channel count " << channel_count;
+  }
+  return OkStatus();
+}
+
+// Results that are the accumulators (floats and raw i32) have no multipliers.
+template <typename ACC, typename DST>
+void SetMultipliers(absl::Span<const ACC> mantissas,
+                    absl::Span<const int32_t> exponents,
+                    ruy::MulParams<ACC, DST>* mul_params, std::false_type) {}
+
+template <typename ACC, typename DST>
+void SetMultipliers(absl::Span<const ACC> mantissas,
+                    absl::Span<const int32_t> exponents,
+                    ruy::MulParams<ACC, DST>* mul_params) {
+  SetMultipliers(
+      mantissas, exponents, mul_params,
+      std::integral_constant<bool, !std::is_same<ACC, DST>::value>());
+}
+
+}  // namespace impl
+
+template <typename T, typename ACC, typename DST>
 Status MatMul::Execute(RuntimeState* runtime_state,
-                       const Buffers<T, ACC>& buffers) {
+                       const Buffers<T, ACC, DST>& buffers) {
+  RETURN_IF_ERROR(impl::ValidateMultipliers(
+      buffers.multiplier_mantissa_buffer, buffers.multiplier_exponent_buffer,
+      /*channel_count=*/buffers.lhs_shape[0]));
+
   ruy::Matrix<T> lhs;
   lhs.set_data(buffers.lhs_buffer.data());
+  lhs.set_zero_point(buffers.lhs_zero_point);
   ruy::MakeSimpleLayout(buffers.lhs_shape[0], buffers.lhs_shape[1],
                         ruy::Order::kRowMajor, lhs.mutable_layout());
 
   ruy::Matrix<T> rhs;
   rhs.set_data(buffers.rhs_buffer.data());
+  rhs.set_zero_point(buffers.rhs_zero_point);
   ruy::MakeSimpleLayout(buffers.rhs_shape[1], buffers.rhs_shape[0],
                         ruy::Order::kColMajor, rhs.mutable_layout());
 
-  ruy::Matrix<T> dst;
+  ruy::Matrix<DST> dst;
   dst.set_data(buffers.dst_buffer.data());
+  dst.set_zero_point(buffers.dst_zero_point);
   ruy::MakeSimpleLayout(buffers.dst_shape[1], buffers.dst_shape[0],
                         ruy::Order::kColMajor, dst.mutable_layout());
 
-  ruy::MulParams<ACC, T> mul_params;
+  ruy::MulParams<ACC, DST> mul_params;
   mul_params.set_bias(buffers.bias_buffer.data());
+  impl::SetMultipliers(buffers.multiplier_mantissa_buffer,
+                       buffers.multiplier_exponent_buffer, &mul_params);
+
+  impl::ScopedRuyContext context(runtime_state);
+  ruy::Mul(lhs, rhs, mul_params, context.get(), &dst);
+
+  return OkStatus();
+}
+
+namespace impl {
+
+// Upper bound on the packed patch storage used by Conv2D. Output rows are
+// processed in bands small enough to stay under this limit (but always at
+// least one row at a time).
+constexpr size_t kConv2DMaxPatchBytes = 2 * 1024 * 1024;
 
-  if (buffers.multiplier_mantissa_buffer.size() == 1) {
-    mul_params.set_multiplier_fixedpoint(buffers.multiplier_mantissa_buffer[0]);
-    mul_params.set_multiplier_exponent(buffers.multiplier_exponent_buffer[0]);
-  } else {
-    mul_params.set_multiplier_fixedpoint_perchannel(
-        buffers.multiplier_mantissa_buffer.data());
-    mul_params.set_multiplier_exponent_perchannel(
-        buffers.multiplier_exponent_buffer.data());
+// Packs the input patches of |group| for output rows [ho_begin, ho_end) into
+// |patches| as a row-major [(ho_end - ho_begin) * Wo, KH * KW * igs] matrix.
+// Taps falling into the padding are |pad_value|.
+template <typename T>
+void PackConv2DPatches(const T* input, const Shape& input_shape,
+                       const Shape& filter_shape, const Shape& dst_shape,
+                       const Shape& strides, const Shape& pad_h,
+                       const Shape& pad_w, const Shape& dilation,
+                       int input_group_size, int group, int ho_begin,
+                       int ho_end, T pad_value, T* patches) {
+  const int input_channels = input_shape[2];
+  const size_t tap_bytes = input_group_size * sizeof(T);
+  T* patch = patches;
+  for (int ho = ho_begin; ho < ho_end; ++ho) {
+    for (int wo = 0; wo < dst_shape[1]; ++wo) {
+      for (int kh = 0; kh < filter_shape[0]; ++kh) {
+        const int ih = ho * strides[0] + kh * dilation[0] - pad_h[0];
+        const bool row_in_bounds = ih >= 0 && ih < input_shape[0];
+        for (int kw = 0; kw < filter_shape[1]; ++kw) {
+          const int iw = wo * strides[1] + kw * dilation[1] - pad_w[0];
+          if (row_in_bounds && iw >= 0 && iw < input_shape[1]) {
+            std::memcpy(patch,
+                        input + (ih * input_shape[1] + iw) * input_channels +
+                            group * input_group_size,
+                        tap_bytes);
+          } else {
+            std::fill(patch, patch + input_group_size, pad_value);
+          }
+          patch += input_group_size;
+        }
+      }
+    }
   }
+}
+
+// Computes |pixel_count| output pixels of |group| as the product of the
+// group's filter slice [ogs, K] and the [K, pixel_count] patch matrix |rhs|.
+template <typename T, typename ACC, typename DST>
+void MulConv2DGroup(ruy::Context* context, const T* filter, int reduction_size,
+                    int output_channels, int output_group_size, int group,
+                    const T* rhs_data, int rhs_stride, int pixel_count,
+                    const Conv2D::Quantization<T, ACC, DST>& quantization,
+                    DST* dst) {
+  // The filter is [K, Co] row-major; the group's columns viewed as a
+  // col-major [ogs, K] matrix with a stride of Co.
+  ruy::Matrix<T> lhs;
+  lhs.set_data(filter + group * output_group_size);
+  lhs.set_zero_point(quantization.filter_zero_point);
+  ruy::MakeSimpleLayout(output_group_size, reduction_size,
+                        ruy::Order::kColMajor, lhs.mutable_layout());
+  lhs.mutable_layout()->set_stride(output_channels);
 
-  ruy::Mul(lhs, rhs, mul_params, &runtime_state->context, &dst);
+  ruy::Matrix<T> rhs;
+  rhs.set_data(rhs_data);
+  rhs.set_zero_point(quantization.input_zero_point);
+  ruy::MakeSimpleLayout(reduction_size, pixel_count, ruy::Order::kColMajor,
+                        rhs.mutable_layout());
+  rhs.mutable_layout()->set_stride(rhs_stride);
 
+  // Each output pixel is a column of Co channels of which the group owns ogs.
+  ruy::Matrix<DST> dst_matrix;
+  dst_matrix.set_data(dst + group * output_group_size);
+  dst_matrix.set_zero_point(quantization.dst_zero_point);
+  ruy::MakeSimpleLayout(output_group_size, pixel_count, ruy::Order::kColMajor,
+                        dst_matrix.mutable_layout());
+  dst_matrix.mutable_layout()->set_stride(output_channels);
+
+  // Per-channel multipliers are per output channel and thus per row of the
+  // group's results.
+  auto mantissas = quantization.multiplier_mantissa_buffer;
+  auto exponents = quantization.multiplier_exponent_buffer;
+  if (mantissas.size() > 1) {
+    mantissas = mantissas.subspan(group * output_group_size, output_group_size);
+    exponents = exponents.subspan(group * output_group_size, output_group_size);
+  }
+  ruy::MulParams<ACC, DST> mul_params;
+  SetMultipliers(mantissas, exponents, &mul_params);
+  ruy::Mul(lhs, rhs, mul_params, context, &dst_matrix);
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Conv2D::Execute(MatMul::RuntimeState* runtime_state,
+                       absl::Span<const T> input_buffer,
+                       const Shape& input_shape,
+                       absl::Span<const T> filter_buffer,
+                       const Shape& filter_shape, absl::Span<T> dst_buffer,
+                       const Shape& dst_shape, const Shape& strides,
+                       const Shape& pad_h, const Shape& pad_w,
+                       const Shape& dilation, const int32_t groups) {
+  return Execute(runtime_state, input_buffer, input_shape, filter_buffer,
+                 filter_shape, dst_buffer, dst_shape, strides, pad_h, pad_w,
+                 dilation, groups, Quantization<T, T, T>());
+}
+
+template <typename T, typename ACC, typename DST>
+Status Conv2D::Execute(MatMul::RuntimeState* runtime_state,
+                       absl::Span<const T> input_buffer,
+                       const Shape& input_shape,
+                       absl::Span<const T> filter_buffer,
+                       const Shape& filter_shape, absl::Span<DST> dst_buffer,
+                       const Shape& dst_shape, const Shape& strides,
+                       const Shape& pad_h, const Shape& pad_w,
+                       const Shape& dilation, const int32_t groups,
+                       const Quantization<T, ACC, DST>& quantization) {
+  RETURN_IF_ERROR(impl::ValidateMultipliers(
+      quantization.multiplier_mantissa_buffer,
+      quantization.multiplier_exponent_buffer,
+      /*channel_count=*/dst_shape[2]));
+
+  const int input_group_size = input_shape[2] / groups;
+  const int output_group_size = dst_shape[2] / groups;
+  const int output_channels = dst_shape[2];
+  const int output_width = dst_shape[1];
+  const int reduction_size =
+      filter_shape[0] * filter_shape[1] * input_group_size;
+  if (dst_shape[0] * output_width == 0 || output_group_size == 0) {
+    return OkStatus();
+  }
+  if (reduction_size == 0) {
+    std::fill(dst_buffer.begin(), dst_buffer.end(),
+              quantization.dst_zero_point);
+    return OkStatus();
+  }
+
+  impl::ScopedRuyContext context(runtime_state);
+
+  // 1x1 convolutions without striding or padding read each input pixel
+  // exactly once: the input is already the [igs, H * W] patch matrix (with a
+  // stride of C) and no packing is required.
+  if (filter_shape[0] == 1 && filter_shape[1] == 1 && strides[0] == 1 &&
+      strides[1] == 1 && pad_h[0] == 0 && pad_h[1] == 0 && pad_w[0] == 0 &&
+      pad_w[1] == 0 && input_shape[0] == dst_shape[0] &&
+      input_shape[1] == dst_shape[1]) {
+    for (int g = 0; g < groups; ++g) {
+      impl::MulConv2DGroup(context.get(), filter_buffer.data(), reduction_size,
+                           output_channels, output_group_size, g,
+                           input_buffer.data() + g * input_group_size,
+                           input_shape[2], dst_shape[0] * output_width,
+                           quantization, dst_buffer.data());
+    }
+    return OkStatus();
+  }
+
+  // Pack and multiply bands of output rows so that the patch storage stays
+  // bounded regardless of the image size.
+  const size_t row_patch_size =
+      static_cast<size_t>(output_width) * reduction_size;
+  const int band_rows = static_cast<int>(std::min<size_t>(
+      dst_shape[0],
+      std::max<size_t>(1, impl::kConv2DMaxPatchBytes /
+                              (row_patch_size * sizeof(T)))));
+  auto& patch_storage = runtime_state->conv_patch_buffer;
+  patch_storage.resize(
+      std::max(patch_storage.size(), band_rows * row_patch_size * sizeof(T)));
+  T* patches = reinterpret_cast<T*>(patch_storage.data());
+  for (int ho_begin = 0; ho_begin < dst_shape[0]; ho_begin += band_rows) {
+    const int ho_end = std::min<int>(ho_begin + band_rows, dst_shape[0]);
+    DST* band_dst =
+        dst_buffer.data() + ho_begin * output_width * output_channels;
+    for (int g = 0; g < groups; ++g) {
+      impl::PackConv2DPatches(input_buffer.data(), input_shape, filter_shape,
+                              dst_shape, strides, pad_h, pad_w, dilation,
+                              input_group_size, g, ho_begin, ho_end,
+                              quantization.input_zero_point, patches);
+      impl::MulConv2DGroup(context.get(), filter_buffer.data(), reduction_size,
+                           output_channels, output_group_size, g, patches,
+                           reduction_size, (ho_end - ho_begin) * output_width,
+                           quantization, band_dst);
+    }
+  }
   return OkStatus();
 }
 
@@ -0,0 +1,303 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "iree/base/target_platform.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+#if defined(_MSC_VER) && \
+    (defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64))
+#include <immintrin.h>
+#include <intrin.h>
+#endif  // _MSC_VER && x86
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+namespace {
+
+// Scalar kernels matching op_kernels_generic.h, used when no SIMD variant is
+// available for the host.
+template <typename Op>
+void ScalarBinary(const float* lhs, const float* rhs, float* dst,
+                  size_t count) {
+  for (size_t i = 0; i < count; ++i) dst[i] = Op::Apply(lhs[i], rhs[i]);
+}
+template <typename Op>
+void ScalarUnary(const float* src, float* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) dst[i] = Op::Apply(src[i]);
+}
+template <typename Op>
+void ScalarCompare(const float* lhs, const float* rhs, uint8_t* dst,
+                   size_t count) {
+  for (size_t i = 0; i < count; ++i) dst[i] = Op::Apply(lhs[i], rhs[i]);
+}
+template <typename SRC, typename DST>
+void ScalarConvert(const SRC* src, DST* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) dst[i] = static_cast<DST>(src[i]);
+}
+
+// f16 and bf16 conversions matching the SIMD variants bit for bit (see
+// op_kernels_simd_x86.h).
+float BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+uint32_t FloatToBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+void ScalarConvertF16ToF32(const Half* src, float* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t exponent_mantissa = src[i].bits & 0x7FFFu;
+    uint32_t sign = static_cast<uint32_t>(src[i].bits & 0x8000u) << 16;
+    // Rebiasing by multiplying with 2^112 is exact, including for denormals.
+    float shifted = BitsToFloat(exponent_mantissa << 13);
+    uint32_t bits = FloatToBits(shifted * BitsToFloat((127 + 112) << 23));
+    if (exponent_mantissa >= 0x7C00u) bits |= 0x7F800000u;
+    dst[i] = BitsToFloat(bits | sign);
+  }
+}
+
+void ScalarConvertF32ToF16(const float* src, Half* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t bits = FloatToBits(src[i]);
+    uint32_t sign = (bits & 0x80000000u) >> 16;
+    float abs_value = std::abs(src[i]);
+    uint32_t abs_bits = FloatToBits(abs_value);
+    uint32_t result;
+    if (std::isnan(src[i])) {
+      result = 0x7E00u;
+    } else if (abs_value >= 65536.0f) {
+      result = 0x7C00u;
+    } else if (abs_value < 6.103515625e-05f) {
+      // Adding 0.5 aligns the f16 denormal ulp (2^-24) with the f32 ulp so
+      // that the addition rounds to nearest even.
+      result = FloatToBits(abs_value + 0.5f) - (126u << 23);
+    } else {
+      uint32_t mantissa_odd = (abs_bits >> 13) & 1u;
+      result = (abs_bits - ((112u << 23) - 0xFFFu) + mantissa_odd) >> 13;
+    }
+    dst[i].bits = static_cast<uint16_t>(result | sign);
+  }
+}
+
+void ScalarConvertBF16ToF32(const BFloat16* src, float* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = BitsToFloat(static_cast<uint32_t>(src[i].bits) << 16);
+  }
+}
+
+void ScalarConvertF32ToBF16(const float* src, BFloat16* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t bits = FloatToBits(src[i]);
+    uint32_t result;
+    if (std::isnan(src[i])) {
+      result = (bits >> 16) | 0x0040u;
+    } else {
+      result = (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+    }
+    dst[i].bits = static_cast<uint16_t>(result);
+  }
+}
+
+struct AddOp {
+  static float Apply(float x, float y) { return x + y; }
+};
+struct SubOp {
+  static float Apply(float x, float y) { return x - y; }
+};
+struct MulOp {
+  static float Apply(float x, float y) { return x * y; }
+};
+struct DivOp {
+  static float Apply(float x, float y) { return x / y; }
+};
+struct MinOp {
+  static float Apply(float x, float y) { return std::min(x, y); }
+};
+struct MaxOp {
+  static float Apply(float x, float y) { return std::max(x, y); }
+};
+struct AbsOp {
+  static float Apply(float x) { return std::abs(x); }
+};
+struct NegOp {
+  static float Apply(float x) { return -x; }
+};
+struct SqrtOp {
+  static float Apply(float x) { return std::sqrt(x); }
+};
+struct FloorOp {
+  static float Apply(float x) { return std::floor(x); }
+};
+struct CeilOp {
+  static float Apply(float x) { return std::ceil(x); }
+};
+struct ExpOp {
+  static float Apply(float x) { return std::exp(x); }
+};
+struct LogOp {
+  static float Apply(float x) { return std::log(x); }
+};
+struct RsqrtOp {
+  static float Apply(float x) { return 1.0 / std::sqrt(x); }
+};
+struct TanhOp {
+  static float Apply(float x) { return std::tanh(x); }
+};
+struct CompareEQOp {
+  static uint8_t Apply(float x, float y) { return x == y; }
+};
+struct CompareNEOp {
+  static uint8_t Apply(float x, float y) { return x != y; }
+};
+struct CompareLTOp {
+  static uint8_t Apply(float x, float y) { return x < y; }
+};
+struct CompareLEOp {
+  static uint8_t Apply(float x, float y) { return x <= y; }
+};
+struct CompareGTOp {
+  static uint8_t Apply(float x, float y) { return x > y; }
+};
+struct CompareGEOp {
+  static uint8_t Apply(float x, float y) { return x >= y; }
+};
+
+const KernelTable kScalarKernelTable = {
+    /*add=*/&ScalarBinary<AddOp>,
+    /*sub=*/&ScalarBinary<SubOp>,
+    /*mul=*/&ScalarBinary<MulOp>,
+    /*div=*/&ScalarBinary<DivOp>,
+    /*min=*/&ScalarBinary<MinOp>,
+    /*max=*/&ScalarBinary<MaxOp>,
+    /*abs=*/&ScalarUnary<AbsOp>,
+    /*neg=*/&ScalarUnary<NegOp>,
+    /*sqrt=*/&ScalarUnary<SqrtOp>,
+    /*floor=*/&ScalarUnary<FloorOp>,
+    /*ceil=*/&ScalarUnary<CeilOp>,
+    /*exp=*/&ScalarUnary<ExpOp>,
+    /*log=*/&ScalarUnary<LogOp>,
+    /*rsqrt=*/&ScalarUnary<RsqrtOp>,
+    /*tanh=*/&ScalarUnary<TanhOp>,
+    /*compare_eq=*/&ScalarCompare<CompareEQOp>,
+    /*compare_ne=*/&ScalarCompare<CompareNEOp>,
+    /*compare_lt=*/&ScalarCompare<CompareLTOp>,
+    /*compare_le=*/&ScalarCompare<CompareLEOp>,
+    /*compare_gt=*/&ScalarCompare<CompareGTOp>,
+    /*compare_ge=*/&ScalarCompare<CompareGEOp>,
+    /*convert_f32_to_i32=*/&ScalarConvert<float, int32_t>,
+    /*convert_i32_to_f32=*/&ScalarConvert<int32_t, float>,
+    /*convert_f16_to_f32=*/&ScalarConvertF16ToF32,
+    /*convert_f32_to_f16=*/&ScalarConvertF32ToF16,
+    /*convert_bf16_to_f32=*/&ScalarConvertBF16ToF32,
+    /*convert_f32_to_bf16=*/&ScalarConvertF32ToBF16,
+};
+
+#if defined(_MSC_VER) && \
+    (defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64))
+Isa DetectIsaFromCpuid() {
+  int regs[4];
+  __cpuid(regs, 0);
+  const int max_leaf = regs[0];
+  __cpuid(regs, 1);
+  const bool has_sse42 = (regs[2] & (1 << 20)) != 0;
+  const bool has_fma = (regs[2] & (1 << 12)) != 0;
+  const bool has_osxsave = (regs[2] & (1 << 27)) != 0;
+  const bool has_avx = (regs[2] & (1 << 28)) != 0;
+  if (!has_sse42) return Isa::kScalar;
+  if (!has_osxsave || !has_avx || max_leaf < 7) return Isa::kSSE42;
+
+  // The OS must also preserve the wider register state across context
+  // switches: XMM|YMM for AVX and additionally opmask|ZMM for AVX-512.
+  const uint64_t xcr0 = _xgetbv(0);
+  if ((xcr0 & 0x06) != 0x06) return Isa::kSSE42;
+  __cpuidex(regs, 7, 0);
+  const bool has_avx2 = (regs[1] & (1 << 5)) != 0;
+  const bool has_avx512f = (regs[1] & (1 << 16)) != 0;
+  if (has_avx512f && (xcr0 & 0xE6) == 0xE6) return Isa::kAVX512;
+  if (has_avx2 && has_fma) return Isa::kAVX2;
+  return Isa::kSSE42;
+}
+#endif  // _MSC_VER && x86
+
+}  // namespace
+
+const char* IsaName(Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return "scalar";
+    case Isa::kSSE42:
+      return "sse4.2";
+    case Isa::kAVX2:
+      return "avx2";
+    case Isa::kAVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+Isa DetectIsa() {
+#if defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64)
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return Isa::kAVX512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return Isa::kAVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) return Isa::kSSE42;
+#elif defined(_MSC_VER)
+  return DetectIsaFromCpuid();
+#endif  // __GNUC__ || __clang__
+#endif  // IREE_ARCH_X86_32 || IREE_ARCH_X86_64
+  return Isa::kScalar;
+}
+
+const KernelTable* GetKernelTable(Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return &kScalarKernelTable;
+#if defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64)
+    case Isa::kSSE42:
+      return GetSSE42KernelTable();
+    case Isa::kAVX2:
+      return GetAVX2KernelTable();
+    case Isa::kAVX512:
+      return GetAVX512KernelTable();
+#endif  // IREE_ARCH_X86_32 || IREE_ARCH_X86_64
+    default:
+      return nullptr;
+  }
+}
+
+const KernelTable& GetSelectedKernelTable() {
+  static const KernelTable* selected_table = GetKernelTable(DetectIsa());
+  return *selected_table;
+}
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,424 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// SIMD specializations of the f32 elementwise kernels.
+//
+// The kernels themselves are compiled once per instruction set (see
+// op_kernels_simd_x86.h) and the best variant supported by the host CPU is
+// selected the first time any of them is used. Targets without a SIMD variant
+// use a scalar table matching op_kernels_generic.h.
+//
+// Arithmetic, min/max, sqrt, floor/ceil, compares and conversions produce the
+// same results as the generic kernels. Exp, Log, Tanh and Rsqrt use polynomial
+// and Newton-Raphson approximations; their error bounds are documented on the
+// implementations in op_kernels_simd_x86.h.
+//
+// f16 and bf16 (Half and BFloat16) buffers are widened to f32 in blocks for
+// the elementwise kernels and wholesale for MatMul and Conv2D, with results
+// rounded back to nearest even. Widening is exact, so the basic arithmetic
+// results are correctly rounded f16/bf16 values.
+
+#ifndef IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+#define IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/base/target_platform.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+// Instruction sets with kernel variants, ordered such that each implies
+// support for all of those before it.
+enum class Isa {
+  kScalar = 0,
+  kSSE42,
+  kAVX2,
+  kAVX512,
+};
+
+// Returns a human-readable name for |isa| (such as 'avx2').
+const char* IsaName(Isa isa);
+
+// Returns the best instruction set supported by the host CPU and OS.
+Isa DetectIsa();
+
+// Contiguous f32 kernels operating on |count| elements.
+struct KernelTable {
+  using BinaryFn = void (*)(const float* lhs, const float* rhs, float* dst,
+                            size_t count);
+  using UnaryFn = void (*)(const float* src, float* dst, size_t count);
+  using CompareFn = void (*)(const float* lhs, const float* rhs, uint8_t* dst,
+                             size_t count);
+
+  BinaryFn add;
+  BinaryFn sub;
+  BinaryFn mul;
+  BinaryFn div;
+  BinaryFn min;
+  BinaryFn max;
+  UnaryFn abs;
+  UnaryFn neg;
+  UnaryFn sqrt;
+  UnaryFn floor;
+  UnaryFn ceil;
+  UnaryFn exp;
+  UnaryFn log;
+  UnaryFn rsqrt;
+  UnaryFn tanh;
+  CompareFn compare_eq;
+  CompareFn compare_ne;
+  CompareFn compare_lt;
+  CompareFn compare_le;
+  CompareFn compare_gt;
+  CompareFn compare_ge;
+  void (*convert_f32_to_i32)(const float* src, int32_t* dst, size_t count);
+  void (*convert_i32_to_f32)(const int32_t* src, float* dst, size_t count);
+  void (*convert_f16_to_f32)(const Half* src, float* dst, size_t count);
+  void (*convert_f32_to_f16)(const float* src, Half* dst, size_t count);
+  void (*convert_bf16_to_f32)(const BFloat16* src, float* dst, size_t count);
+  void (*convert_f32_to_bf16)(const float* src, BFloat16* dst, size_t count);
+};
+
+// Returns the kernel table for |isa| or nullptr if the variant was not
+// compiled into this binary. The caller must ensure the host supports |isa|
+// (see DetectIsa) before calling any of the kernels.
+const KernelTable* GetKernelTable(Isa isa);
+
+// Returns the kernel table for DetectIsa(), selected once per process.
+const KernelTable& GetSelectedKernelTable();
+
+#if defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64)
+const KernelTable* GetSSE42KernelTable();
+const KernelTable* GetAVX2KernelTable();
+const KernelTable* GetAVX512KernelTable();
+#endif  // IREE_ARCH_X86_32 || IREE_ARCH_X86_64
+
+namespace impl {
+
+// Elements widened to f32 on the stack at a time by the elementwise kernels.
+constexpr size_t kWidenBlockSize = 256;
+
+inline void Widen(const Half* src, float* dst, size_t count) {
+  GetSelectedKernelTable().convert_f16_to_f32(src, dst, count);
+}
+inline void Widen(const BFloat16* src, float* dst, size_t count) {
+  GetSelectedKernelTable().convert_bf16_to_f32(src, dst, count);
+}
+inline void Narrow(const float* src, Half* dst, size_t count) {
+  GetSelectedKernelTable().convert_f32_to_f16(src, dst, count);
+}
+inline void Narrow(const float* src, BFloat16* dst, size_t count) {
+  GetSelectedKernelTable().convert_f32_to_bf16(src, dst, count);
+}
+
+template <typename T>
+void WidenedBinary(KernelTable::BinaryFn fn, const T* lhs, const T* rhs,
+                   T* dst, size_t count) {
+  float lhs_block[kWidenBlockSize];
+  float rhs_block[kWidenBlockSize];
+  float dst_block[kWidenBlockSize];
+  for (size_t i = 0; i < count; i += kWidenBlockSize) {
+    size_t block_size = std::min(kWidenBlockSize, count - i);
+    Widen(lhs + i, lhs_block, block_size);
+    Widen(rhs + i, rhs_block, block_size);
+    fn(lhs_block, rhs_block, dst_block, block_size);
+    Narrow(dst_block, dst + i, block_size);
+  }
+}
+
+template <typename T>
+void WidenedUnary(KernelTable::UnaryFn fn, const T* src, T* dst,
+                  size_t count) {
+  float src_block[kWidenBlockSize];
+  float dst_block[kWidenBlockSize];
+  for (size_t i = 0; i < count; i += kWidenBlockSize) {
+    size_t block_size = std::min(kWidenBlockSize, count - i);
+    Widen(src + i, src_block, block_size);
+    fn(src_block, dst_block, block_size);
+    Narrow(dst_block, dst + i, block_size);
+  }
+}
+
+// Multiplies f16/bf16 matrices with ruy in f32, as ruy has no 16-bit float
+// kernels. The operands and result are staged in the runtime state.
+template <typename T>
+Status WidenedMatMul(MatMul::RuntimeState* runtime_state,
+                     const MatMul::Buffers<T, float, T>& buffers) {
+  const size_t lhs_size = buffers.lhs_buffer.size();
+  const size_t rhs_size = buffers.rhs_buffer.size();
+  const size_t dst_size = buffers.dst_buffer.size();
+  auto& storage = runtime_state->widened_buffer;
+  if (storage.size() < lhs_size + rhs_size + dst_size) {
+    storage.resize(lhs_size + rhs_size + dst_size);
+  }
+  float* lhs = storage.data();
+  float* rhs = lhs + lhs_size;
+  float* dst = rhs + rhs_size;
+  Widen(buffers.lhs_buffer.data(), lhs, lhs_size);
+  Widen(buffers.rhs_buffer.data(), rhs, rhs_size);
+
+  MatMul::Buffers<float, float, float> widened_buffers;
+  widened_buffers.lhs_shape = buffers.lhs_shape;
+  widened_buffers.lhs_buffer = absl::MakeConstSpan(lhs, lhs_size);
+  widened_buffers.rhs_shape = buffers.rhs_shape;
+  widened_buffers.rhs_buffer = absl::MakeConstSpan(rhs, rhs_size);
+  widened_buffers.dst_shape = buffers.dst_shape;
+  widened_buffers.dst_buffer = absl::MakeSpan(dst, dst_size);
+  widened_buffers.bias_buffer = buffers.bias_buffer;
+  RETURN_IF_ERROR(MatMul::Execute(runtime_state, widened_buffers));
+
+  Narrow(dst, buffers.dst_buffer.data(), dst_size);
+  return OkStatus();
+}
+
+// Convolves f16/bf16 buffers with the f32 GEMM implementation.
+template <typename T>
+Status WidenedConv2D(MatMul::RuntimeState* runtime_state,
+                     absl::Span<const T> input_buffer, const Shape& input_shape,
+                     absl::Span<const T> filter_buffer,
+                     const Shape& filter_shape, absl::Span<T> dst_buffer,
+                     const Shape& dst_shape, const Shape& strides,
+                     const Shape& pad_h, const Shape& pad_w,
+                     const Shape& dilation, const int32_t groups) {
+  const size_t input_size = input_buffer.size();
+  const size_t filter_size = filter_buffer.size();
+  const size_t dst_size = dst_buffer.size();
+  auto& storage = runtime_state->widened_buffer;
+  if (storage.size() < input_size + filter_size + dst_size) {
+    storage.resize(input_size + filter_size + dst_size);
+  }
+  float* input = storage.data();
+  float* filter = input + input_size;
+  float* dst = filter + filter_size;
+  Widen(input_buffer.data(), input, input_size);
+  Widen(filter_buffer.data(), filter, filter_size);
+  RETURN_IF_ERROR(Conv2D::Execute<float>(
+      runtime_state, absl::MakeConstSpan(input, input_size), input_shape,
+      absl::MakeConstSpan(filter, filter_size), filter_shape,
+      absl::MakeSpan(dst, dst_size), dst_shape, strides, pad_h, pad_w,
+      dilation, groups));
+  Narrow(dst, dst_buffer.data(), dst_size);
+  return OkStatus();
+}
+
+}  // namespace impl
+}  // namespace simd
+
+#define IREE_VMLA_SIMD_BINARY_KERNEL(kernel, fn)                              \
+  template <>                                                                 \
+  inline Status kernel::Execute<float>(absl::Span<const float> lhs_buffer,    \
+                                       absl::Span<const float> rhs_buffer,    \
+                                       absl::Span<float> dst_buffer) {        \
+    simd::GetSelectedKernelTable().fn(lhs_buffer.data(), rhs_buffer.data(),   \
+                                      dst_buffer.data(), dst_buffer.size());  \
+    return OkStatus();                                                        \
+  }                                                                           \
+  IREE_VMLA_SIMD_WIDENED_BINARY_KERNEL(kernel, fn, Half)                      \
+  IREE_VMLA_SIMD_WIDENED_BINARY_KERNEL(kernel, fn, BFloat16)
+#define IREE_VMLA_SIMD_UNARY_KERNEL(kernel, fn)                               \
+  template <>                                                                 \
+  inline Status kernel::Execute<float>(absl::Span<const float> src_buffer,    \
+                                       absl::Span<float> dst_buffer) {        \
+    simd::GetSelectedKernelTable().fn(src_buffer.data(), dst_buffer.data(),   \
+                                      dst_buffer.size());                     \
+    return OkStatus();                                                        \
+  }                                                                           \
+  IREE_VMLA_SIMD_WIDENED_UNARY_KERNEL(kernel, fn, Half)                       \
+  IREE_VMLA_SIMD_WIDENED_UNARY_KERNEL(kernel, fn, BFloat16)
+#define IREE_VMLA_SIMD_WIDENED_BINARY_KERNEL(kernel, fn, type)                \
+  template <>                                                                 \
+  inline Status kernel::Execute<type>(absl::Span<const type> lhs_buffer,      \
+                                      absl::Span<const type> rhs_buffer,      \
+                                      absl::Span<type> dst_buffer) {          \
+    simd::impl::WidenedBinary(simd::GetSelectedKernelTable().fn,              \
+                              lhs_buffer.data(), rhs_buffer.data(),           \
+                              dst_buffer.data(), dst_buffer.size());          \
+    return OkStatus();                                                        \
+  }
+#define IREE_VMLA_SIMD_WIDENED_UNARY_KERNEL(kernel, fn, type)                 \
+  template <>                                                                 \
+  inline Status kernel::Execute<type>(absl::Span<const type> src_buffer,      \
+                                      absl::Span<type> dst_buffer) {          \
+    simd::impl::WidenedUnary(simd::GetSelectedKernelTable().fn,               \
+                             src_buffer.data(), dst_buffer.data(),            \
+                             dst_buffer.size());                              \
+    return OkStatus();                                                        \
+  }
+#define IREE_VMLA_SIMD_COMPARE_KERNEL(kernel, fn)                             \
+  template <>                                                                 \
+  inline Status kernel::Execute<float>(absl::Span<const float> lhs_buffer,    \
+                                       absl::Span<const float> rhs_buffer,    \
+                                       absl::Span<uint8_t> dst_buffer) {      \
+    simd::GetSelectedKernelTable().fn(lhs_buffer.data(), rhs_buffer.data(),   \
+                                      dst_buffer.data(), dst_buffer.size());  \
+    return OkStatus();                                                        \
+  }
+
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareEQ, compare_eq)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareNE, compare_ne)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLT, compare_lt)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareLE, compare_le)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGT, compare_gt)
+IREE_VMLA_SIMD_COMPARE_KERNEL(CompareGE, compare_ge)
+IREE_VMLA_SIMD_BINARY_KERNEL(Add, add)
+IREE_VMLA_SIMD_BINARY_KERNEL(Sub, sub)
+IREE_VMLA_SIMD_UNARY_KERNEL(Abs, abs)
+IREE_VMLA_SIMD_UNARY_KERNEL(Neg, neg)
+IREE_VMLA_SIMD_BINARY_KERNEL(Mul, mul)
+IREE_VMLA_SIMD_BINARY_KERNEL(Div, div)
+IREE_VMLA_SIMD_UNARY_KERNEL(Exp, exp)
+IREE_VMLA_SIMD_UNARY_KERNEL(Rsqrt, rsqrt)
+IREE_VMLA_SIMD_UNARY_KERNEL(Sqrt, sqrt)
+IREE_VMLA_SIMD_UNARY_KERNEL(Log, log)
+IREE_VMLA_SIMD_UNARY_KERNEL(Tanh, tanh)
+IREE_VMLA_SIMD_BINARY_KERNEL(Min, min)
+IREE_VMLA_SIMD_BINARY_KERNEL(Max, max)
+IREE_VMLA_SIMD_UNARY_KERNEL(Floor, floor)
+IREE_VMLA_SIMD_UNARY_KERNEL(Ceil, ceil)
+
+#undef IREE_VMLA_SIMD_BINARY_KERNEL
+#undef IREE_VMLA_SIMD_UNARY_KERNEL
+#undef IREE_VMLA_SIMD_WIDENED_BINARY_KERNEL
+#undef IREE_VMLA_SIMD_WIDENED_UNARY_KERNEL
+#undef IREE_VMLA_SIMD_COMPARE_KERNEL
+
+template <>
+inline Status Convert::Execute<float, int32_t>(
+    absl::Span<const float> src_buffer, absl::Span<int32_t> dst_buffer) {
+  simd::GetSelectedKernelTable().convert_f32_to_i32(
+      src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<int32_t, float>(
+    absl::Span<const int32_t> src_buffer, absl::Span<float> dst_buffer) {
+  simd::GetSelectedKernelTable().convert_i32_to_f32(
+      src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<Half, float>(absl::Span<const Half> src_buffer,
+                                            absl::Span<float> dst_buffer) {
+  simd::impl::Widen(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<float, Half>(absl::Span<const float> src_buffer,
+                                            absl::Span<Half> dst_buffer) {
+  simd::impl::Narrow(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<BFloat16, float>(
+    absl::Span<const BFloat16> src_buffer, absl::Span<float> dst_buffer) {
+  simd::impl::Widen(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status Convert::Execute<float, BFloat16>(
+    absl::Span<const float> src_buffer, absl::Span<BFloat16> dst_buffer) {
+  simd::impl::Narrow(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return OkStatus();
+}
+
+template <>
+inline Status MatMul::Execute<Half, float, Half>(
+    RuntimeState* runtime_state, const Buffers<Half, float, Half>& buffers) {
+  return simd::impl::WidenedMatMul(runtime_state, buffers);
+}
+
+template <>
+inline Status MatMul::Execute<BFloat16, float, BFloat16>(
+    RuntimeState* runtime_state,
+    const Buffers<BFloat16, float, BFloat16>& buffers) {
+  return simd::impl::WidenedMatMul(runtime_state, buffers);
+}
+
+template <>
+inline Status Conv2D::Execute<Half>(
+    MatMul::RuntimeState* runtime_state, absl::Span<const Half> input_buffer,
+    const Shape& input_shape, absl::Span<const Half> filter_buffer,
+    const Shape& filter_shape, absl::Span<Half> dst_buffer,
+    const Shape& dst_shape, const Shape& strides, const Shape& pad_h,
+    const Shape& pad_w, const Shape& dilation, const int32_t groups) {
+  return simd::impl::WidenedConv2D(runtime_state, input_buffer, input_shape,
+                                   filter_buffer, filter_shape, dst_buffer,
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups);
+}
+
+template <>
+inline Status Conv2D::Execute<BFloat16>(
+    MatMul::RuntimeState* runtime_state,
+    absl::Span<const BFloat16> input_buffer, const Shape& input_shape,
+    absl::Span<const BFloat16> filter_buffer, const Shape& filter_shape,
+    absl::Span<BFloat16> dst_buffer, const Shape& dst_shape,
+    const Shape& strides, const Shape& pad_h, const Shape& pad_w,
+    const Shape& dilation, const int32_t groups) {
+  return simd::impl::WidenedConv2D(runtime_state, input_buffer, input_shape,
+                                   filter_buffer, filter_shape, dst_buffer,
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups);
+}
+
+// f16/bf16 have no zero points or requantization: the default quantization
+// the mixed type overload is called with is ignored.
+template <>
+inline Status Conv2D::Execute<Half, float, Half>(
+    MatMul::RuntimeState* runtime_state, absl::Span<const Half> input_buffer,
+    const Shape& input_shape, absl::Span<const Half> filter_buffer,
+    const Shape& filter_shape, absl::Span<Half> dst_buffer,
+    const Shape& dst_shape, const Shape& strides, const Shape& pad_h,
+    const Shape& pad_w, const Shape& dilation, const int32_t groups,
+    const Quantization<Half, float, Half>& quantization) {
+  return simd::impl::WidenedConv2D(runtime_state, input_buffer, input_shape,
+                                   filter_buffer, filter_shape, dst_buffer,
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups);
+}
+
+template <>
+inline Status Conv2D::Execute<BFloat16, float, BFloat16>(
+    MatMul::RuntimeState* runtime_state,
+    absl::Span<const BFloat16> input_buffer, const Shape& input_shape,
+    absl::Span<const BFloat16> filter_buffer, const Shape& filter_shape,
+    absl::Span<BFloat16> dst_buffer, const Shape& dst_shape,
+    const Shape& strides, const Shape& pad_h, const Shape& pad_w,
+    const Shape& dilation, const int32_t groups,
+    const Quantization<BFloat16, float, BFloat16>& quantization) {
+  return simd::impl::WidenedConv2D(runtime_state, input_buffer, input_shape,
+                                   filter_buffer, filter_shape, dst_buffer,
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups);
+}
+
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
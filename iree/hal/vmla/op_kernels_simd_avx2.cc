@@ -0,0 +1,163 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// AVX2 variant of the SIMD kernels; see op_kernels_simd_x86.h.
+
+#include "iree/base/target_platform.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+#if defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64)
+
+#include <immintrin.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif  // __clang__
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+namespace avx2 {
+namespace {
+
+struct V {
+  using F = __m256;
+  using I = __m256i;
+  using M = __m256;
+  static constexpr size_t kWidth = 8;
+
+  static F Load(const float* p) { return _mm256_loadu_ps(p); }
+  static void Store(float* p, F v) { _mm256_storeu_ps(p, v); }
+  static I LoadI(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void StoreI(int32_t* p, I v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+  // Zero-extends 16-bit lanes and truncates them back (values are < 2^16).
+  static I LoadU16(const uint16_t* p) {
+    return _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+  static void StoreU16(uint16_t* p, I v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                     _mm_packus_epi32(_mm256_castsi256_si128(v),
+                                      _mm256_extracti128_si256(v, 1)));
+  }
+  static void StoreMask(uint8_t* p, M m) {
+    I ones = _mm256_srli_epi32(_mm256_castps_si256(m), 31);
+    __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(ones),
+                                    _mm256_extracti128_si256(ones, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p),
+                     _mm_packus_epi16(words, words));
+  }
+  static F Set1(float value) { return _mm256_set1_ps(value); }
+  static I Set1I(int32_t value) { return _mm256_set1_epi32(value); }
+
+  static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+  // a * b + c and c - a * b.
+  static F MulAdd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static F NegMulAdd(F a, F b, F c) { return _mm256_fnmadd_ps(a, b, c); }
+  static F Min(F a, F b) { return _mm256_min_ps(a, b); }
+  static F Max(F a, F b) { return _mm256_max_ps(a, b); }
+  static F Sqrt(F a) { return _mm256_sqrt_ps(a); }
+  static F RsqrtEstimate(F a) { return _mm256_rsqrt_ps(a); }
+  static F Abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+  static F Floor(F a) { return _mm256_floor_ps(a); }
+  static F Ceil(F a) { return _mm256_ceil_ps(a); }
+  static F Round(F a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static F And(F a, F b) { return _mm256_and_ps(a, b); }
+  static F Or(F a, F b) { return _mm256_or_ps(a, b); }
+  static F Xor(F a, F b) { return _mm256_xor_ps(a, b); }
+
+  static M CmpEQ(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static M CmpNE(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+  static M CmpLT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static M CmpLE(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+  static M CmpGT(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static M CmpGE(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+  static M CmpUnordered(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_UNORD_Q); }
+  // Returns |if_true| in lanes where |m| is set and |if_false| elsewhere.
+  static F Select(M m, F if_true, F if_false) {
+    return _mm256_blendv_ps(if_false, if_true, m);
+  }
+
+  static I TruncateToI(F a) { return _mm256_cvttps_epi32(a); }
+  static I RoundToI(F a) { return _mm256_cvtps_epi32(a); }
+  static F ConvertI(I a) { return _mm256_cvtepi32_ps(a); }
+  static I CastToI(F a) { return _mm256_castps_si256(a); }
+  static F CastToF(I a) { return _mm256_castsi256_ps(a); }
+  static I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+  static I SubI(I a, I b) { return _mm256_sub_epi32(a, b); }
+  static I AndI(I a, I b) { return _mm256_and_si256(a, b); }
+  static I OrI(I a, I b) { return _mm256_or_si256(a, b); }
+  template <int N>
+  static I ShiftLeftI(I a) {
+    return _mm256_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogicalI(I a) {
+    return _mm256_srli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightArithI(I a) {
+    return _mm256_srai_epi32(a, N);
+  }
+};
+
+#include "iree/hal/vmla/op_kernels_simd_x86.h"  // IWYU pragma: keep
+
+}  // namespace
+}  // namespace avx2
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif  // __clang__
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+const KernelTable* GetAVX2KernelTable() { return &avx2::kKernelTable; }
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_ARCH_X86_32 || IREE_ARCH_X86_64
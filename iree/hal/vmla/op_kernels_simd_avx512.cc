@@ -0,0 +1,165 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// AVX-512 variant of the SIMD kernels; see op_kernels_simd_x86.h.
+
+#include "iree/base/target_platform.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+#if defined(IREE_ARCH_X86_32) || defined(IREE_ARCH_X86_64)
+
+#include <immintrin.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), \
+                             apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif  // __clang__
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+namespace avx512 {
+namespace {
+
+struct V {
+  using F = __m512;
+  using I = __m512i;
+  using M = __mmask16;
+  static constexpr size_t kWidth = 16;
+
+  static F Load(const float* p) { return _mm512_loadu_ps(p); }
+  static void Store(float* p, F v) { _mm512_storeu_ps(p, v); }
+  static I LoadI(const int32_t* p) { return _mm512_loadu_si512(p); }
+  static void StoreI(int32_t* p, I v) { _mm512_storeu_si512(p, v); }
+  // Zero-extends 16-bit lanes and truncates them back (values are < 2^16).
+  static I LoadU16(const uint16_t* p) {
+    return _mm512_cvtepu16_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  }
+  static void StoreU16(uint16_t* p, I v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p),
+                        _mm512_cvtepi32_epi16(v));
+  }
+  static void StoreMask(uint8_t* p, M m) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                     _mm512_cvtepi32_epi8(_mm512_maskz_set1_epi32(m, 1)));
+  }
+  static F Set1(float value) { return _mm512_set1_ps(value); }
+  static I Set1I(int32_t value) { return _mm512_set1_epi32(value); }
+
+  static F Add(F a, F b) { return _mm512_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm512_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm512_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm512_div_ps(a, b); }
+  // a * b + c and c - a * b.
+  static F MulAdd(F a, F b, F c) { return _mm512_fmadd_ps(a, b, c); }
+  static F NegMulAdd(F a, F b, F c) { return _mm512_fnmadd_ps(a, b, c); }
+  static F Min(F a, F b) { return _mm512_min_ps(a, b); }
+  static F Max(F a, F b) { return _mm512_max_ps(a, b); }
+  static F Sqrt(F a) { return _mm512_sqrt_ps(a); }
+  static F RsqrtEstimate(F a) { return _mm512_rsqrt14_ps(a); }
+  static F Abs(F a) { return And(a, CastToF(Set1I(0x7FFFFFFF))); }
+  static F Floor(F a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  }
+  static F Ceil(F a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC);
+  }
+  static F Round(F a) {
+    return _mm512_roundscale_ps(a,
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  // The f32 logic ops require AVX512DQ so use their integer equivalents.
+  static F And(F a, F b) { return CastToF(AndI(CastToI(a), CastToI(b))); }
+  static F Or(F a, F b) { return CastToF(OrI(CastToI(a), CastToI(b))); }
+  static F Xor(F a, F b) {
+    return CastToF(_mm512_xor_si512(CastToI(a), CastToI(b)));
+  }
+
+  static M CmpEQ(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static M CmpNE(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_NEQ_UQ); }
+  static M CmpLT(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static M CmpLE(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+  static M CmpGT(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static M CmpGE(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ); }
+  static M CmpUnordered(F a, F b) {
+    return _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q);
+  }
+  // Returns |if_true| in lanes where |m| is set and |if_false| elsewhere.
+  static F Select(M m, F if_true, F if_false) {
+    return _mm512_mask_blend_ps(m, if_false, if_true);
+  }
+
+  static I TruncateToI(F a) { return _mm512_cvttps_epi32(a); }
+  static I RoundToI(F a) { return _mm512_cvtps_epi32(a); }
+  static F ConvertI(I a) { return _mm512_cvtepi32_ps(a); }
+  static I CastToI(F a) { return _mm512_castps_si512(a); }
+  static F CastToF(I a) { return _mm512_castsi512_ps(a); }
+  static I AddI(I a, I b) { return _mm512_add_epi32(a, b); }
+  static I SubI(I a, I b) { return _mm512_sub_epi32(a, b); }
+  static I AndI(I a, I b) { return _mm512_and_si512(a, b); }
+  static I OrI(I a, I b) { return _mm512_or_si512(a, b); }
+  template <int N>
+  static I ShiftLeftI(I a) {
+    return _mm512_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogicalI(I a) {
+    return _mm512_srli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightArithI(I a) {
+    return _mm512_srai_epi32(a, N);
+  }
+};
+
+#include "iree/hal/vmla/op_kernels_simd_x86.h"  // IWYU pragma: keep
+
+}  // namespace
+}  // namespace avx512
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif  // __clang__
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+const KernelTable* GetAVX512KernelTable() { return &avx512::kKernelTable; }
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_ARCH_X86_32 || IREE_ARCH_X86_64
@@ -0,0 +1,489 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "iree/base/status_matchers.h"
+#include "iree/hal/vmla/op_kernels.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kDenormMin = std::numeric_limits<float>::denorm_min();
+constexpr float kFloatMin = std::numeric_limits<float>::min();
+
+// Returns the distance between |a| and |b| in units in the last place.
+int64_t UlpDistance(float a, float b) {
+  if (std::isnan(a) || std::isnan(b)) {
+    return std::isnan(a) && std::isnan(b) ? 0 : INT64_MAX;
+  }
+  auto ordered = [](float f) -> int64_t {
+    int32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : bits;
+  };
+  int64_t distance = ordered(a) - ordered(b);
+  return distance < 0 ? -distance : distance;
+}
+
+// Returns every |stride|th f32 bit pattern, covering the full range of values
+// (including denormals, infinities and NaNs) in a few hundred thousand floats.
+std::vector<float> SampleAllFloats(uint32_t stride = 9973) {
+  std::vector<float> values;
+  for (uint64_t bits = 0; bits <= UINT32_MAX; bits += stride) {
+    uint32_t value_bits = static_cast<uint32_t>(bits);
+    float value;
+    std::memcpy(&value, &value_bits, sizeof(value));
+    values.push_back(value);
+  }
+  return values;
+}
+
+// Odd-sized inputs exercising both the vector body and the remainder.
+std::vector<float> MakeSpecialValues() {
+  return {0.0f,       -0.0f,     1.0f,     -1.0f,      0.5f,   -2.5f,
+          3.5f,       -3.5f,     1e-3f,    -1e30f,     1e30f,  kInf,
+          -kInf,      kNaN,      kDenormMin, -kDenormMin, kFloatMin,
+          123456.7f,  -7.25f,    2147483520.0f, -0.75f,  0.25f,  42.0f};
+}
+
+// Returns the value of the f16 |bits| computed independently of the kernels.
+float ReferenceHalfToFloat(uint16_t bits) {
+  float sign = (bits & 0x8000) ? -1.0f : 1.0f;
+  int exponent = (bits >> 10) & 0x1F;
+  int mantissa = bits & 0x3FF;
+  if (exponent == 0x1F) return mantissa ? kNaN : sign * kInf;
+  if (exponent == 0) {
+    return sign * std::ldexp(static_cast<float>(mantissa), -24);
+  }
+  return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Returns all 2^16 bit patterns of the 16-bit float type T.
+template <typename T>
+std::vector<T> AllBitPatterns() {
+  std::vector<T> values(1 << 16);
+  for (uint32_t bits = 0; bits < values.size(); ++bits) {
+    values[bits].bits = static_cast<uint16_t>(bits);
+  }
+  return values;
+}
+
+class SimdKernelsTest : public ::testing::TestWithParam<Isa> {
+ protected:
+  void SetUp() override {
+    if (static_cast<int>(GetParam()) > static_cast<int>(DetectIsa())) {
+      GTEST_SKIP();
+      return;
+    }
+    table_ = GetKernelTable(GetParam());
+    if (!table_) {
+      GTEST_SKIP();
+      return;
+    }
+    scalar_ = GetKernelTable(Isa::kScalar);
+  }
+
+  void ExpectUnaryMatchesScalar(KernelTable::UnaryFn fn,
+                                KernelTable::UnaryFn scalar_fn,
+                                const std::vector<float>& src) {
+    std::vector<float> dst(src.size());
+    std::vector<float> expected(src.size());
+    fn(src.data(), dst.data(), src.size());
+    scalar_fn(src.data(), expected.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      EXPECT_EQ(UlpDistance(dst[i], expected[i]), 0)
+          << "src=" << src[i] << " dst=" << dst[i] << " expected="
+          << expected[i];
+    }
+  }
+
+  void ExpectBinaryMatchesScalar(KernelTable::BinaryFn fn,
+                                 KernelTable::BinaryFn scalar_fn) {
+    auto lhs = MakeSpecialValues();
+    auto rhs = lhs;
+    std::reverse(rhs.begin(), rhs.end());
+    std::vector<float> dst(lhs.size());
+    std::vector<float> expected(lhs.size());
+    fn(lhs.data(), rhs.data(), dst.data(), lhs.size());
+    scalar_fn(lhs.data(), rhs.data(), expected.data(), lhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      EXPECT_EQ(UlpDistance(dst[i], expected[i]), 0)
+          << lhs[i] << ", " << rhs[i] << " -> " << dst[i] << " expected "
+          << expected[i];
+    }
+  }
+
+  void ExpectCompareMatchesScalar(KernelTable::CompareFn fn,
+                                  KernelTable::CompareFn scalar_fn) {
+    auto lhs = MakeSpecialValues();
+    auto rhs = lhs;
+    std::reverse(rhs.begin(), rhs.end());
+    rhs[0] = lhs[0];
+    std::vector<uint8_t> dst(lhs.size());
+    std::vector<uint8_t> expected(lhs.size());
+    fn(lhs.data(), rhs.data(), dst.data(), lhs.size());
+    scalar_fn(lhs.data(), rhs.data(), expected.data(), lhs.size());
+    EXPECT_EQ(dst, expected);
+  }
+
+  // Checks that |fn| is within |max_ulp| of |reference| (evaluated in double
+  // and rounded to f32) for all sampled inputs in [|min|, |max|].
+  template <typename F>
+  void ExpectWithinUlp(KernelTable::UnaryFn fn, F reference, float min,
+                       float max, int64_t max_ulp) {
+    std::vector<float> src;
+    for (float value : SampleAllFloats()) {
+      if (value >= min && value <= max) src.push_back(value);
+    }
+    std::vector<float> dst(src.size());
+    fn(src.data(), dst.data(), src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      float expected = static_cast<float>(reference(src[i]));
+      ASSERT_LE(UlpDistance(dst[i], expected), max_ulp)
+          << "src=" << src[i] << " dst=" << dst[i] << " expected="
+          << expected;
+    }
+  }
+
+  const KernelTable* table_ = nullptr;
+  const KernelTable* scalar_ = nullptr;
+};
+
+TEST_P(SimdKernelsTest, Arithmetic) {
+  ExpectBinaryMatchesScalar(table_->add, scalar_->add);
+  ExpectBinaryMatchesScalar(table_->sub, scalar_->sub);
+  ExpectBinaryMatchesScalar(table_->mul, scalar_->mul);
+  ExpectBinaryMatchesScalar(table_->div, scalar_->div);
+}
+
+TEST_P(SimdKernelsTest, MinMax) {
+  ExpectBinaryMatchesScalar(table_->min, scalar_->min);
+  ExpectBinaryMatchesScalar(table_->max, scalar_->max);
+}
+
+TEST_P(SimdKernelsTest, ExactUnary) {
+  auto src = MakeSpecialValues();
+  ExpectUnaryMatchesScalar(table_->abs, scalar_->abs, src);
+  ExpectUnaryMatchesScalar(table_->neg, scalar_->neg, src);
+  ExpectUnaryMatchesScalar(table_->sqrt, scalar_->sqrt, src);
+  ExpectUnaryMatchesScalar(table_->floor, scalar_->floor, src);
+  ExpectUnaryMatchesScalar(table_->ceil, scalar_->ceil, src);
+}
+
+TEST_P(SimdKernelsTest, Compare) {
+  ExpectCompareMatchesScalar(table_->compare_eq, scalar_->compare_eq);
+  ExpectCompareMatchesScalar(table_->compare_ne, scalar_->compare_ne);
+  ExpectCompareMatchesScalar(table_->compare_lt, scalar_->compare_lt);
+  ExpectCompareMatchesScalar(table_->compare_le, scalar_->compare_le);
+  ExpectCompareMatchesScalar(table_->compare_gt, scalar_->compare_gt);
+  ExpectCompareMatchesScalar(table_->compare_ge, scalar_->compare_ge);
+}
+
+TEST_P(SimdKernelsTest, Convert) {
+  std::vector<float> src = {0.0f,  -0.0f, 0.5f,    -0.5f,  1.99f,  -1.99f,
+                            7.0f,  -8.0f, 1234.5f, 65536.f, -1e9f, 2.5f,
+                            -3.5f, 1e-5f, 100.25f, 33.0f,  -17.9f};
+  std::vector<int32_t> ints(src.size());
+  table_->convert_f32_to_i32(src.data(), ints.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(ints[i], static_cast<int32_t>(src[i]));
+  }
+  ints.push_back(INT32_MAX);
+  ints.push_back(INT32_MIN);
+  ints.push_back(16777217);
+  std::vector<float> floats(ints.size());
+  table_->convert_i32_to_f32(ints.data(), floats.data(), ints.size());
+  for (size_t i = 0; i < ints.size(); ++i) {
+    EXPECT_EQ(floats[i], static_cast<float>(ints[i]));
+  }
+}
+
+TEST_P(SimdKernelsTest, WidenF16) {
+  auto src = AllBitPatterns<Half>();
+  std::vector<float> dst(src.size());
+  table_->convert_f16_to_f32(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(UlpDistance(dst[i], ReferenceHalfToFloat(src[i].bits)), 0)
+        << "bits=" << src[i].bits << " dst=" << dst[i];
+  }
+}
+
+TEST_P(SimdKernelsTest, NarrowF16) {
+  // Every finite f16 value round trips and the midpoints between neighbors
+  // round to the even one.
+  std::vector<float> src;
+  std::vector<uint16_t> expected;
+  for (uint16_t sign : {0x0000, 0x8000}) {
+    for (uint16_t bits = 0; bits < 0x7C00; ++bits) {
+      src.push_back(ReferenceHalfToFloat(bits | sign));
+      expected.push_back(bits | sign);
+      if (bits + 1 < 0x7C00) {
+        src.push_back((ReferenceHalfToFloat(bits | sign) +
+                       ReferenceHalfToFloat((bits + 1) | sign)) /
+                      2.0f);
+        expected.push_back(((bits & 1) ? bits + 1 : bits) | sign);
+      }
+    }
+  }
+  // Overflow (including ties above the largest value) and tiny values.
+  for (auto value_bits : std::vector<std::pair<float, uint16_t>>{
+           {65519.0f, 0x7BFF},
+           {65520.0f, 0x7C00},
+           {1e9f, 0x7C00},
+           {kInf, 0x7C00},
+           {-kInf, 0xFC00},
+           {1e-9f, 0x0000},
+           {-kDenormMin, 0x8000},
+           {kFloatMin, 0x0000}}) {
+    src.push_back(value_bits.first);
+    expected.push_back(value_bits.second);
+  }
+  std::vector<Half> dst(src.size());
+  table_->convert_f32_to_f16(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(dst[i].bits, expected[i]) << "src=" << src[i];
+  }
+
+  Half nan;
+  table_->convert_f32_to_f16(&kNaN, &nan, 1);
+  EXPECT_EQ(nan.bits & 0x7E00, 0x7E00);
+}
+
+TEST_P(SimdKernelsTest, NarrowF16MatchesScalar) {
+  auto src = SampleAllFloats();
+  std::vector<Half> dst(src.size());
+  std::vector<Half> expected(src.size());
+  table_->convert_f32_to_f16(src.data(), dst.data(), src.size());
+  scalar_->convert_f32_to_f16(src.data(), expected.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(dst[i].bits, expected[i].bits) << "src=" << src[i];
+  }
+}
+
+TEST_P(SimdKernelsTest, WidenBF16) {
+  auto src = AllBitPatterns<BFloat16>();
+  std::vector<float> dst(src.size());
+  table_->convert_bf16_to_f32(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    float expected = BitsToFloat(static_cast<uint32_t>(src[i].bits) << 16);
+    EXPECT_EQ(UlpDistance(dst[i], expected), 0) << "bits=" << src[i].bits;
+  }
+}
+
+TEST_P(SimdKernelsTest, NarrowBF16) {
+  // Every finite bf16 value round trips and the midpoints between neighbors
+  // round to the even one (overflowing to infinity above the largest value).
+  std::vector<float> src;
+  std::vector<uint16_t> expected;
+  for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+    if ((bits & 0x7F80) == 0x7F80) continue;
+    src.push_back(BitsToFloat(bits << 16));
+    expected.push_back(static_cast<uint16_t>(bits));
+    src.push_back(BitsToFloat((bits << 16) | 0x8000));
+    expected.push_back(static_cast<uint16_t>((bits & 1) ? bits + 1 : bits));
+  }
+  src.push_back(kInf);
+  expected.push_back(0x7F80);
+  src.push_back(-kInf);
+  expected.push_back(0xFF80);
+  std::vector<BFloat16> dst(src.size());
+  table_->convert_f32_to_bf16(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(dst[i].bits, expected[i]) << "src=" << src[i];
+  }
+
+  BFloat16 nan;
+  table_->convert_f32_to_bf16(&kNaN, &nan, 1);
+  EXPECT_EQ(nan.bits & 0x7FC0, 0x7FC0);
+}
+
+TEST_P(SimdKernelsTest, NarrowBF16MatchesScalar) {
+  auto src = SampleAllFloats();
+  std::vector<BFloat16> dst(src.size());
+  std::vector<BFloat16> expected(src.size());
+  table_->convert_f32_to_bf16(src.data(), dst.data(), src.size());
+  scalar_->convert_f32_to_bf16(src.data(), expected.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(dst[i].bits, expected[i].bits) << "src=" << src[i];
+  }
+}
+
+TEST_P(SimdKernelsTest, ExpAccuracy) {
+  ExpectWithinUlp(
+      table_->exp, [](double x) { return std::exp(x); }, -87.3f, 88.7f, 1);
+  // Denormal results are only accurate to within one denormal step.
+  ExpectWithinUlp(
+      table_->exp, [](double x) { return std::exp(x); }, -103.9f, -87.4f, 1);
+}
+
+TEST_P(SimdKernelsTest, ExpSpecialValues) {
+  std::vector<float> src = {0.0f, -0.0f, kInf, -kInf, kNaN, 89.0f, -104.0f};
+  std::vector<float> dst(src.size());
+  table_->exp(src.data(), dst.data(), src.size());
+  EXPECT_EQ(dst[0], 1.0f);
+  EXPECT_EQ(dst[1], 1.0f);
+  EXPECT_EQ(dst[2], kInf);
+  EXPECT_EQ(dst[3], 0.0f);
+  EXPECT_TRUE(std::isnan(dst[4]));
+  EXPECT_EQ(dst[5], kInf);
+  EXPECT_EQ(dst[6], 0.0f);
+}
+
+TEST_P(SimdKernelsTest, LogAccuracy) {
+  ExpectWithinUlp(
+      table_->log, [](double x) { return std::log(x); }, kDenormMin,
+      std::numeric_limits<float>::max(), 1);
+}
+
+TEST_P(SimdKernelsTest, LogSpecialValues) {
+  std::vector<float> src = {0.0f, -0.0f, kInf, -kInf, kNaN, -1.0f, 1.0f};
+  std::vector<float> dst(src.size());
+  table_->log(src.data(), dst.data(), src.size());
+  EXPECT_EQ(dst[0], -kInf);
+  EXPECT_EQ(dst[1], -kInf);
+  EXPECT_EQ(dst[2], kInf);
+  EXPECT_TRUE(std::isnan(dst[3]));
+  EXPECT_TRUE(std::isnan(dst[4]));
+  EXPECT_TRUE(std::isnan(dst[5]));
+  EXPECT_EQ(dst[6], 0.0f);
+}
+
+TEST_P(SimdKernelsTest, TanhAccuracy) {
+  // The scalar kernel uses the C library tanhf, which (for example in glibc)
+  // may be off by 2 ULP.
+  int64_t max_ulp = GetParam() == Isa::kScalar ? 2 : 1;
+  ExpectWithinUlp(
+      table_->tanh, [](double x) { return std::tanh(x); },
+      -std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+      max_ulp);
+}
+
+TEST_P(SimdKernelsTest, TanhSpecialValues) {
+  std::vector<float> src = {0.0f, -0.0f, kInf, -kInf, kNaN};
+  std::vector<float> dst(src.size());
+  table_->tanh(src.data(), dst.data(), src.size());
+  EXPECT_EQ(UlpDistance(dst[0], 0.0f), 0);
+  EXPECT_EQ(UlpDistance(dst[1], -0.0f), 0);
+  EXPECT_EQ(dst[2], 1.0f);
+  EXPECT_EQ(dst[3], -1.0f);
+  EXPECT_TRUE(std::isnan(dst[4]));
+}
+
+TEST_P(SimdKernelsTest, RsqrtAccuracy) {
+  ExpectWithinUlp(
+      table_->rsqrt, [](double x) { return 1.0 / std::sqrt(x); }, kDenormMin,
+      std::numeric_limits<float>::max(), 1);
+}
+
+TEST_P(SimdKernelsTest, RsqrtSpecialValues) {
+  std::vector<float> src = {0.0f, -0.0f, kInf, -1.0f, kNaN, 4.0f};
+  std::vector<float> dst(src.size());
+  table_->rsqrt(src.data(), dst.data(), src.size());
+  EXPECT_EQ(dst[0], kInf);
+  EXPECT_EQ(dst[1], -kInf);
+  EXPECT_EQ(dst[2], 0.0f);
+  EXPECT_TRUE(std::isnan(dst[3]));
+  EXPECT_TRUE(std::isnan(dst[4]));
+  EXPECT_EQ(dst[5], 0.5f);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllIsas, SimdKernelsTest,
+                         ::testing::Values(Isa::kScalar, Isa::kSSE42,
+                                           Isa::kAVX2, Isa::kAVX512),
+                         [](const ::testing::TestParamInfo<Isa>& info) {
+                           std::string name = IsaName(info.param);
+                           name.erase(std::remove(name.begin(), name.end(),
+                                                  '.'),
+                                      name.end());
+                           return name;
+                         });
+
+TEST(SimdKernelsTest, SelectedKernelsBackSpanKernels) {
+  std::vector<float> src = {-1.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+  std::vector<float> dst(src.size());
+  EXPECT_OK(Exp::Execute<float>(src, absl::MakeSpan(dst)));
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_NEAR(dst[i], std::exp(src[i]), std::exp(src[i]) * 1e-6f);
+  }
+  std::vector<uint8_t> mask(src.size());
+  EXPECT_OK(CompareGE::Execute<float>(src, dst, absl::MakeSpan(mask)));
+  EXPECT_EQ(mask, std::vector<uint8_t>({0, 0, 0, 0, 0}));
+}
+
+TEST(SimdKernelsTest, WidenedKernelsRoundResults) {
+  // Enough elements to span several widened blocks.
+  const size_t count = 3 * impl::kWidenBlockSize + 7;
+  std::vector<Half> lhs(count);
+  std::vector<Half> rhs(count);
+  std::vector<float> lhs_values(count);
+  std::vector<float> rhs_values(count);
+  for (size_t i = 0; i < count; ++i) {
+    lhs_values[i] = static_cast<float>(i) * 0.37f - 100.0f;
+    rhs_values[i] = static_cast<float>(i % 17) * 1.3f + 0.1f;
+  }
+  // Round the operands to f16 and widen them back to get exact f32 values.
+  ASSERT_OK((Convert::Execute<float, Half>(lhs_values, absl::MakeSpan(lhs))));
+  ASSERT_OK((Convert::Execute<float, Half>(rhs_values, absl::MakeSpan(rhs))));
+  ASSERT_OK((Convert::Execute<Half, float>(lhs, absl::MakeSpan(lhs_values))));
+  ASSERT_OK((Convert::Execute<Half, float>(rhs, absl::MakeSpan(rhs_values))));
+
+  std::vector<Half> dst(count);
+  ASSERT_OK(Div::Execute<Half>(lhs, rhs, absl::MakeSpan(dst)));
+  std::vector<float> expected_values(count);
+  for (size_t i = 0; i < count; ++i) {
+    expected_values[i] = lhs_values[i] / rhs_values[i];
+  }
+  std::vector<Half> expected(count);
+  ASSERT_OK((Convert::Execute<float, Half>(expected_values,
+                                           absl::MakeSpan(expected))));
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(dst[i].bits, expected[i].bits) << "i=" << i;
+  }
+
+  std::vector<BFloat16> bf16_src(count);
+  std::vector<BFloat16> bf16_dst(count);
+  ASSERT_OK((Convert::Execute<float, BFloat16>(lhs_values,
+                                               absl::MakeSpan(bf16_src))));
+  ASSERT_OK(Abs::Execute<BFloat16>(bf16_src, absl::MakeSpan(bf16_dst)));
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(bf16_dst[i].bits, bf16_src[i].bits & 0x7FFF) << "i=" << i;
+  }
+}
+
+}  // namespace
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,412 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// x86 SIMD kernel bodies shared by all instruction set variants.
+//
+// This file is textually included once per variant (op_kernels_simd_sse42.cc,
+// op_kernels_simd_avx2.cc, op_kernels_simd_avx512.cc) from inside a
+// variant-specific namespace that defines a `V` struct wrapping the vector
+// intrinsics, with the compiler target options for that variant in effect.
+// Everything defined here is therefore compiled for the variant's ISA and must
+// only be called after checking that the CPU supports it.
+//
+// The transcendental approximations are evaluated in f32 and are within 1 ULP
+// of the correctly rounded result for every f32 input in all variants
+// (verified exhaustively), with the exception of exp results in the denormal
+// range (x < -87.3) which are within one denormal step (2^-149).
+//
+// Special values match the C library: exp(-inf)=0, exp(+inf)=+inf,
+// log(+-0)=-inf, log(x<0)=NaN, tanh(+-inf)=+-1, rsqrt(+-0)=+-inf,
+// rsqrt(+inf)=0, rsqrt(x<0)=NaN, and NaN inputs produce NaN.
+
+// NOTE: no include guards; see above.
+
+// Applies |Op| to |count| elements, |V::kWidth| at a time. The remainder is
+// staged through a full vector so that all elements see the same code path.
+template <typename Op>
+void BinaryKernel(const float* lhs, const float* rhs, float* dst,
+                  size_t count) {
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::Store(dst + i, Op::Apply(V::Load(lhs + i), V::Load(rhs + i)));
+  }
+  if (i < count) {
+    float lhs_tail[V::kWidth] = {0.0f};
+    float rhs_tail[V::kWidth] = {0.0f};
+    float dst_tail[V::kWidth];
+    for (size_t j = 0; j < count - i; ++j) {
+      lhs_tail[j] = lhs[i + j];
+      rhs_tail[j] = rhs[i + j];
+    }
+    V::Store(dst_tail, Op::Apply(V::Load(lhs_tail), V::Load(rhs_tail)));
+    for (size_t j = 0; j < count - i; ++j) dst[i + j] = dst_tail[j];
+  }
+}
+
+template <typename Op>
+void UnaryKernel(const float* src, float* dst, size_t count) {
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::Store(dst + i, Op::Apply(V::Load(src + i)));
+  }
+  if (i < count) {
+    float src_tail[V::kWidth] = {0.0f};
+    float dst_tail[V::kWidth];
+    for (size_t j = 0; j < count - i; ++j) src_tail[j] = src[i + j];
+    V::Store(dst_tail, Op::Apply(V::Load(src_tail)));
+    for (size_t j = 0; j < count - i; ++j) dst[i + j] = dst_tail[j];
+  }
+}
+
+template <typename Op>
+void CompareKernel(const float* lhs, const float* rhs, uint8_t* dst,
+                   size_t count) {
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::StoreMask(dst + i, Op::Apply(V::Load(lhs + i), V::Load(rhs + i)));
+  }
+  if (i < count) {
+    float lhs_tail[V::kWidth] = {0.0f};
+    float rhs_tail[V::kWidth] = {0.0f};
+    uint8_t dst_tail[V::kWidth];
+    for (size_t j = 0; j < count - i; ++j) {
+      lhs_tail[j] = lhs[i + j];
+      rhs_tail[j] = rhs[i + j];
+    }
+    V::StoreMask(dst_tail, Op::Apply(V::Load(lhs_tail), V::Load(rhs_tail)));
+    for (size_t j = 0; j < count - i; ++j) dst[i + j] = dst_tail[j];
+  }
+}
+
+void ConvertF32ToI32(const float* src, int32_t* dst, size_t count) {
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::StoreI(dst + i, V::TruncateToI(V::Load(src + i)));
+  }
+  for (; i < count; ++i) dst[i] = static_cast<int32_t>(src[i]);
+}
+
+void ConvertI32ToF32(const int32_t* src, float* dst, size_t count) {
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::Store(dst + i, V::ConvertI(V::LoadI(src + i)));
+  }
+  for (; i < count; ++i) dst[i] = static_cast<float>(src[i]);
+}
+
+// f16 and bf16 conversions operate on the bits in 32-bit lanes, using f32
+// arithmetic only where it is exact or correctly rounded. Widening is exact
+// (including f16 denormals) and narrowing rounds to nearest even with
+// overflow to infinity and NaNs quieted, matching the scalar kernels.
+struct F16Conversion {
+  static V::F Widen(V::I h) {
+    V::I exponent_mantissa = V::AndI(h, V::Set1I(0x7FFF));
+    V::I sign = V::ShiftLeftI<16>(V::SubI(h, exponent_mantissa));
+    // Rebiasing by multiplying with 2^112 is exact, including for denormals.
+    V::F shifted = V::CastToF(V::ShiftLeftI<13>(exponent_mantissa));
+    V::F scaled = V::Mul(shifted, V::CastToF(V::Set1I((127 + 112) << 23)));
+    V::M is_inf_nan = V::CmpGE(shifted, V::CastToF(V::Set1I(0x7C00 << 13)));
+    scaled = V::Select(
+        is_inf_nan, V::Or(scaled, V::CastToF(V::Set1I(0x7F800000))), scaled);
+    return V::Or(scaled, V::CastToF(sign));
+  }
+
+  static V::I Narrow(V::F x) {
+    V::I sign =
+        V::ShiftRightLogicalI<16>(V::CastToI(V::And(x, V::Set1(-0.0f))));
+    V::F abs = V::Abs(x);
+    V::I abs_bits = V::CastToI(abs);
+    // Adding 0.5 aligns the f16 denormal ulp (2^-24) with the f32 ulp so that
+    // the addition rounds to nearest even.
+    V::I denormal = V::SubI(V::CastToI(V::Add(abs, V::Set1(0.5f))),
+                            V::Set1I(126 << 23));
+    V::I mantissa_odd =
+        V::AndI(V::ShiftRightLogicalI<13>(abs_bits), V::Set1I(1));
+    V::I normal = V::ShiftRightLogicalI<13>(V::AddI(
+        V::SubI(abs_bits, V::Set1I((112 << 23) - 0xFFF)), mantissa_odd));
+    V::F result = V::Select(V::CmpLT(abs, V::Set1(6.103515625e-05f)),
+                            V::CastToF(denormal), V::CastToF(normal));
+    result = V::Select(V::CmpGE(abs, V::Set1(65536.0f)),
+                       V::CastToF(V::Set1I(0x7C00)), result);
+    result = V::Select(V::CmpUnordered(x, x), V::CastToF(V::Set1I(0x7E00)),
+                       result);
+    return V::OrI(V::CastToI(result), sign);
+  }
+};
+
+struct BF16Conversion {
+  static V::F Widen(V::I h) { return V::CastToF(V::ShiftLeftI<16>(h)); }
+
+  static V::I Narrow(V::F x) {
+    V::I bits = V::CastToI(x);
+    V::I lsb = V::AndI(V::ShiftRightLogicalI<16>(bits), V::Set1I(1));
+    V::I rounded = V::ShiftRightLogicalI<16>(
+        V::AddI(bits, V::AddI(lsb, V::Set1I(0x7FFF))));
+    V::I quiet_nan =
+        V::OrI(V::ShiftRightLogicalI<16>(bits), V::Set1I(0x0040));
+    return V::CastToI(V::Select(V::CmpUnordered(x, x), V::CastToF(quiet_nan),
+                                V::CastToF(rounded)));
+  }
+};
+
+template <typename Conversion, typename T>
+void WidenKernel(const T* src, float* dst, size_t count) {
+  const uint16_t* src_bits = reinterpret_cast<const uint16_t*>(src);
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::Store(dst + i, Conversion::Widen(V::LoadU16(src_bits + i)));
+  }
+  if (i < count) {
+    uint16_t src_tail[V::kWidth] = {0};
+    float dst_tail[V::kWidth];
+    for (size_t j = 0; j < count - i; ++j) src_tail[j] = src_bits[i + j];
+    V::Store(dst_tail, Conversion::Widen(V::LoadU16(src_tail)));
+    for (size_t j = 0; j < count - i; ++j) dst[i + j] = dst_tail[j];
+  }
+}
+
+template <typename Conversion, typename T>
+void NarrowKernel(const float* src, T* dst, size_t count) {
+  uint16_t* dst_bits = reinterpret_cast<uint16_t*>(dst);
+  size_t i = 0;
+  for (; i + V::kWidth <= count; i += V::kWidth) {
+    V::StoreU16(dst_bits + i, Conversion::Narrow(V::Load(src + i)));
+  }
+  if (i < count) {
+    float src_tail[V::kWidth] = {0.0f};
+    uint16_t dst_tail[V::kWidth];
+    for (size_t j = 0; j < count - i; ++j) src_tail[j] = src[i + j];
+    V::StoreU16(dst_tail, Conversion::Narrow(V::Load(src_tail)));
+    for (size_t j = 0; j < count - i; ++j) dst_bits[i + j] = dst_tail[j];
+  }
+}
+
+// Returns |x| with the sign bit of |sign| or'ed in.
+inline V::F OrSign(V::F x, V::F sign) {
+  return V::Or(x, V::And(sign, V::Set1(-0.0f)));
+}
+
+// Returns 2^n for integral n in [-126, 127].
+inline V::F Pow2I(V::I n) {
+  return V::CastToF(V::ShiftLeftI<23>(V::AddI(n, V::Set1I(127))));
+}
+
+// exp(x) = 2^n * e^r with n = round(x / ln2) and |r| <= ln2 / 2. The reduction
+// uses the Cody-Waite split of ln2 and e^r is a degree-6 minimax polynomial
+// (Cephes expf). 2^n is applied in two halves so that n in [-150, 128] (the
+// full range of finite non-zero results) is representable.
+inline V::F ExpApprox(V::F x) {
+  const V::F kMaxInput = V::Set1(88.72283935546875f);  // ln(FLT_MAX)
+  const V::F kMinInput = V::Set1(-103.97208404541015625f);  // ln(2^-150)
+  V::F clamped = V::Max(kMinInput, V::Min(kMaxInput, x));
+  V::F n = V::Round(V::Mul(clamped, V::Set1(1.44269504088896341f)));
+  V::F r = V::NegMulAdd(n, V::Set1(0.693359375f), clamped);
+  r = V::NegMulAdd(n, V::Set1(-2.12194440e-4f), r);
+
+  V::F p = V::Set1(1.9875691500e-4f);
+  p = V::MulAdd(p, r, V::Set1(1.3981999507e-3f));
+  p = V::MulAdd(p, r, V::Set1(8.3334519073e-3f));
+  p = V::MulAdd(p, r, V::Set1(4.1665795894e-2f));
+  p = V::MulAdd(p, r, V::Set1(1.6666665459e-1f));
+  p = V::MulAdd(p, r, V::Set1(5.0000001201e-1f));
+  V::F y = V::MulAdd(p, V::Mul(r, r), V::Add(r, V::Set1(1.0f)));
+
+  V::I ni = V::RoundToI(n);
+  V::I n_lo = V::ShiftRightArithI<1>(ni);
+  V::I n_hi = V::SubI(ni, n_lo);
+  y = V::Mul(V::Mul(y, Pow2I(n_lo)), Pow2I(n_hi));
+
+  y = V::Select(V::CmpGT(x, kMaxInput), V::Set1(INFINITY), y);
+  y = V::Select(V::CmpLT(x, kMinInput), V::Set1(0.0f), y);
+  return y;
+}
+
+// log(x) = e * ln2 + log(m) with x = m * 2^e and m in [sqrt(0.5), sqrt(2)).
+// log(1 + f) is evaluated as f - f^2/2 + f^3 * P(f) with a degree-8 minimax
+// polynomial P (Cephes logf). Denormals are scaled into the normal range first.
+inline V::F LogApprox(V::F x) {
+  const V::F kOne = V::Set1(1.0f);
+  V::M is_denormal = V::CmpLT(x, V::Set1(1.17549435e-38f));  // FLT_MIN
+  V::F xs = V::Select(is_denormal, V::Mul(x, V::Set1(8388608.0f)), x);  // 2^23
+  V::F e_bias = V::Select(is_denormal, V::Set1(23.0f), V::Set1(0.0f));
+  V::I bits = V::CastToI(xs);
+  V::F e = V::Sub(
+      V::ConvertI(V::SubI(V::ShiftRightLogicalI<23>(bits), V::Set1I(126))),
+      e_bias);
+  V::F m = V::CastToF(V::OrI(V::AndI(bits, V::Set1I(0x007FFFFF)),
+                             V::Set1I(0x3F000000)));  // [0.5, 1)
+  V::M is_small = V::CmpLT(m, V::Set1(0.707106781186547524f));
+  e = V::Sub(e, V::Select(is_small, kOne, V::Set1(0.0f)));
+  m = V::Sub(V::Add(m, V::Select(is_small, m, V::Set1(0.0f))), kOne);
+
+  V::F z = V::Mul(m, m);
+  V::F p = V::Set1(7.0376836292e-2f);
+  p = V::MulAdd(p, m, V::Set1(-1.1514610310e-1f));
+  p = V::MulAdd(p, m, V::Set1(1.1676998740e-1f));
+  p = V::MulAdd(p, m, V::Set1(-1.2420140846e-1f));
+  p = V::MulAdd(p, m, V::Set1(1.4249322787e-1f));
+  p = V::MulAdd(p, m, V::Set1(-1.6668057665e-1f));
+  p = V::MulAdd(p, m, V::Set1(2.0000714765e-1f));
+  p = V::MulAdd(p, m, V::Set1(-2.4999993993e-1f));
+  p = V::MulAdd(p, m, V::Set1(3.3333331174e-1f));
+  V::F y = V::Mul(V::Mul(p, m), z);
+  y = V::MulAdd(e, V::Set1(-2.12194440e-4f), y);
+  y = V::NegMulAdd(V::Set1(0.5f), z, y);
+  V::F result = V::Add(m, y);
+  result = V::MulAdd(e, V::Set1(0.693359375f), result);
+
+  result = V::Select(V::CmpEQ(x, V::Set1(INFINITY)), x, result);
+  result = V::Select(V::CmpLT(x, V::Set1(0.0f)), V::Set1(NAN), result);
+  result = V::Select(V::CmpEQ(x, V::Set1(0.0f)), V::Set1(-INFINITY), result);
+  result = V::Select(V::CmpUnordered(x, x), x, result);
+  return result;
+}
+
+// tanh(|x|) is an odd degree-9 minimax polynomial below 0.625 (Cephes tanhf)
+// and 1 - 2 / (exp(2|x|) + 1) above it; the sign of x is reapplied last.
+inline V::F TanhApprox(V::F x) {
+  const V::F kOne = V::Set1(1.0f);
+  V::F ax = V::Abs(x);
+
+  V::F z = V::Mul(ax, ax);
+  V::F p = V::Set1(-5.70498872745e-3f);
+  p = V::MulAdd(p, z, V::Set1(2.06390887954e-2f));
+  p = V::MulAdd(p, z, V::Set1(-5.37397155531e-2f));
+  p = V::MulAdd(p, z, V::Set1(1.33314422036e-1f));
+  p = V::MulAdd(p, z, V::Set1(-3.33332819422e-1f));
+  V::F small = V::MulAdd(V::Mul(p, z), ax, ax);
+
+  V::F t = ExpApprox(V::Add(ax, ax));
+  V::F large = V::Sub(kOne, V::Div(V::Set1(2.0f), V::Add(t, kOne)));
+
+  V::F result = V::Select(V::CmpLT(ax, V::Set1(0.625f)), small, large);
+  return OrSign(result, x);
+}
+
+// The hardware reciprocal square root estimate (12 bits for SSE/AVX, 14 bits
+// for AVX-512) refined with two Newton-Raphson steps in residual form
+// y += y/2 * (1 - x*y*y). Denormals are scaled by 2^24 first as the estimate
+// instructions treat them as zero.
+inline V::F RsqrtApprox(V::F x) {
+  V::M is_tiny = V::CmpLT(x, V::Set1(1.17549435e-38f));  // FLT_MIN
+  V::F xs = V::Select(is_tiny, V::Mul(x, V::Set1(16777216.0f)), x);
+  V::F y = V::RsqrtEstimate(xs);
+  for (int i = 0; i < 2; ++i) {
+    V::F residual = V::NegMulAdd(V::Mul(xs, y), y, V::Set1(1.0f));
+    y = V::MulAdd(V::Mul(y, V::Set1(0.5f)), residual, y);
+  }
+  y = V::Select(is_tiny, V::Mul(y, V::Set1(4096.0f)), y);  // 2^12
+
+  y = V::Select(V::CmpEQ(x, V::Set1(INFINITY)), V::Set1(0.0f), y);
+  y = V::Select(V::CmpEQ(x, V::Set1(0.0f)), OrSign(V::Set1(INFINITY), x), y);
+  return y;
+}
+
+struct AddOp {
+  static V::F Apply(V::F x, V::F y) { return V::Add(x, y); }
+};
+struct SubOp {
+  static V::F Apply(V::F x, V::F y) { return V::Sub(x, y); }
+};
+struct MulOp {
+  static V::F Apply(V::F x, V::F y) { return V::Mul(x, y); }
+};
+struct DivOp {
+  static V::F Apply(V::F x, V::F y) { return V::Div(x, y); }
+};
+// std::min(x, y) returns x unless y < x; the min/max instructions return their
+// second operand unless the first compares less/greater so swap them to match.
+struct MinOp {
+  static V::F Apply(V::F x, V::F y) { return V::Min(y, x); }
+};
+struct MaxOp {
+  static V::F Apply(V::F x, V::F y) { return V::Max(y, x); }
+};
+struct AbsOp {
+  static V::F Apply(V::F x) { return V::Abs(x); }
+};
+struct NegOp {
+  static V::F Apply(V::F x) { return V::Xor(x, V::Set1(-0.0f)); }
+};
+struct SqrtOp {
+  static V::F Apply(V::F x) { return V::Sqrt(x); }
+};
+struct FloorOp {
+  static V::F Apply(V::F x) { return V::Floor(x); }
+};
+struct CeilOp {
+  static V::F Apply(V::F x) { return V::Ceil(x); }
+};
+struct ExpOp {
+  static V::F Apply(V::F x) { return ExpApprox(x); }
+};
+struct LogOp {
+  static V::F Apply(V::F x) { return LogApprox(x); }
+};
+struct RsqrtOp {
+  static V::F Apply(V::F x) { return RsqrtApprox(x); }
+};
+struct TanhOp {
+  static V::F Apply(V::F x) { return TanhApprox(x); }
+};
+struct CompareEQOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpEQ(x, y); }
+};
+struct CompareNEOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpNE(x, y); }
+};
+struct CompareLTOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpLT(x, y); }
+};
+struct CompareLEOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpLE(x, y); }
+};
+struct CompareGTOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpGT(x, y); }
+};
+struct CompareGEOp {
+  static V::M Apply(V::F x, V::F y) { return V::CmpGE(x, y); }
+};
+
+// Constant-initialized so that no code built for the variant's ISA runs unless
+// one of the kernels is called.
+const KernelTable kKernelTable = {
+    /*add=*/&BinaryKernel<AddOp>,
+    /*sub=*/&BinaryKernel<SubOp>,
+    /*mul=*/&BinaryKernel<MulOp>,
+    /*div=*/&BinaryKernel<DivOp>,
+    /*min=*/&BinaryKernel<MinOp>,
+    /*max=*/&BinaryKernel<MaxOp>,
+    /*abs=*/&UnaryKernel<AbsOp>,
+    /*neg=*/&UnaryKernel<NegOp>,
+    /*sqrt=*/&UnaryKernel<SqrtOp>,
+    /*floor=*/&UnaryKernel<FloorOp>,
+    /*ceil=*/&UnaryKernel<CeilOp>,
+    /*exp=*/&UnaryKernel<ExpOp>,
+    /*log=*/&UnaryKernel<LogOp>,
+    /*rsqrt=*/&UnaryKernel<RsqrtOp>,
+    /*tanh=*/&UnaryKernel<TanhOp>,
+    /*compare_eq=*/&CompareKernel<CompareEQOp>,
+    /*compare_ne=*/&CompareKernel<CompareNEOp>,
+    /*compare_lt=*/&CompareKernel<CompareLTOp>,
+    /*compare_le=*/&CompareKernel<CompareLEOp>,
+    /*compare_gt=*/&CompareKernel<CompareGTOp>,
+    /*compare_ge=*/&CompareKernel<CompareGEOp>,
+    /*convert_f32_to_i32=*/&ConvertF32ToI32,
+    /*convert_i32_to_f32=*/&ConvertI32ToF32,
+    /*convert_f16_to_f32=*/&WidenKernel<F16Conversion, Half>,
+    /*convert_f32_to_f16=*/&NarrowKernel<F16Conversion, Half>,
+    /*convert_bf16_to_f32=*/&WidenKernel<BF16Conversion, BFloat16>,
+    /*convert_f32_to_bf16=*/&NarrowKernel<BF16Conversion, BFloat16>,
+};
@@ -14,6 +14,9 @@
 
 #include "iree/hal/vmla/op_kernels.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "iree/base/memory.h"
 #include "iree/base/status_matchers.h"
 #include "iree/testing/gtest.h"
@@ -520,6 +523,519 @@ TEST(Conv2d, DepthwiseConv) {
   }
 }
 
+// Runs the GEMM implementation and the reference implementation on the same
+// inputs and expects matching results.
+void ExpectGemmConv2DMatchesReference(const Shape& input_shape,
+                                      const Shape& filter_shape,
+                                      const Shape& dst_shape,
+                                      const Shape& strides, const Shape& pad_h,
+                                      const Shape& pad_w,
+                                      const Shape& dilation, int32_t groups) {
+  std::vector<float> input_buffer(input_shape.element_count());
+  for (int i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = static_cast<float>((i * 7) % 13) - 6.0f;
+  }
+  std::vector<float> filter_buffer(filter_shape[0] * filter_shape[1] *
+                                   (input_shape[2] / groups) * dst_shape[2]);
+  for (int i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = static_cast<float>((i * 5) % 11) * 0.25f - 1.0f;
+  }
+
+  std::vector<float> expected_dst(dst_shape.element_count(), 0.0f);
+  EXPECT_OK(Conv2D::Execute<float>(input_buffer, input_shape, filter_buffer,
+                                   filter_shape, absl::MakeSpan(expected_dst),
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups));
+
+  auto runtime_state = MatMul::CreateRuntimeState();
+  std::vector<float> dst_buffer(dst_shape.element_count(), -1.0f);
+  EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h,
+      pad_w, dilation, groups));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon) << "index " << i;
+  }
+}
+
+TEST(Conv2d, GemmNoDilation) {
+  Shape input_shape = {4, 5, 2};
+  Shape filter_shape = {3, 2, 2, 1};
+  Shape dst_shape = {2, 4, 1};
+  auto input_buffer = MakeIota<float>(input_shape.element_count());
+  auto filter_buffer = MakeIota<float>(filter_shape.element_count());
+  std::vector<float> expected_dst = {1310, 1466, 1622, 1778,
+                                     2090, 2246, 2402, 2558};
+  std::vector<float> dst_buffer(dst_shape.element_count(), 0.0f);
+
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, {1, 1}, {0, 0},
+      {0, 0}, {1, 1}, 1));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+}
+
+TEST(Conv2d, GemmDepthwiseConv) {
+  ExpectGemmConv2DMatchesReference({4, 5, 2}, {3, 2, 1, 4}, {2, 4, 4}, {1, 1},
+                                   {0, 0}, {0, 0}, {1, 1}, 2);
+}
+
+TEST(Conv2d, GemmGroupedConv) {
+  ExpectGemmConv2DMatchesReference({6, 7, 6}, {3, 3, 2, 9}, {4, 5, 9}, {1, 1},
+                                   {0, 0}, {0, 0}, {1, 1}, 3);
+}
+
+TEST(Conv2d, GemmDilatedConv) {
+  ExpectGemmConv2DMatchesReference({9, 8, 3}, {3, 2, 3, 4}, {5, 6, 4}, {1, 1},
+                                   {0, 0}, {0, 0}, {2, 2}, 1);
+}
+
+TEST(Conv2d, GemmStridedPaddedConv) {
+  ExpectGemmConv2DMatchesReference({7, 9, 4}, {3, 3, 4, 5}, {4, 5, 5}, {2, 2},
+                                   {1, 1}, {1, 2}, {1, 1}, 1);
+}
+
+TEST(Conv2d, GemmStridedPaddedDilatedGroupedConv) {
+  ExpectGemmConv2DMatchesReference({8, 8, 4}, {2, 3, 2, 6}, {5, 2, 6}, {2, 3},
+                                   {2, 1}, {1, 0}, {2, 2}, 2);
+}
+
+TEST(Conv2d, Gemm1x1Conv) {
+  ExpectGemmConv2DMatchesReference({5, 6, 8}, {1, 1, 8, 3}, {5, 6, 3}, {1, 1},
+                                   {0, 0}, {0, 0}, {1, 1}, 1);
+}
+
+TEST(Conv2d, Gemm1x1GroupedConv) {
+  ExpectGemmConv2DMatchesReference({5, 6, 8}, {1, 1, 2, 8}, {5, 6, 8}, {1, 1},
+                                   {0, 0}, {0, 0}, {1, 1}, 4);
+}
+
+TEST(Conv2d, GemmLargeImageConv) {
+  // Large enough to be processed in multiple bands of output rows.
+  ExpectGemmConv2DMatchesReference({130, 130, 16}, {3, 3, 16, 8},
+                                   {128, 128, 8}, {1, 1}, {0, 0}, {0, 0},
+                                   {1, 1}, 1);
+}
+
+TEST(Conv2d, GemmWithThreadPool) {
+  Shape input_shape = {4, 5, 2};
+  Shape filter_shape = {3, 2, 2, 1};
+  Shape dst_shape = {2, 4, 1};
+  auto input_buffer = MakeIota<float>(input_shape.element_count());
+  auto filter_buffer = MakeIota<float>(filter_shape.element_count());
+  std::vector<float> expected_dst = {1310, 1466, 1622, 1778,
+                                     2090, 2246, 2402, 2558};
+  std::vector<float> dst_buffer(dst_shape.element_count(), 0.0f);
+
+  auto thread_pool = MatMul::CreateThreadPool(4);
+  auto runtime_state = MatMul::CreateRuntimeState();
+  runtime_state->thread_pool = thread_pool.get();
+  runtime_state->thread_hint = 2;
+  EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, {1, 1}, {0, 0},
+      {0, 0}, {1, 1}, 1));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+}
+
+// Values spanning the int8 range with a pattern that doesn't repeat along
+// small dimensions.
+std::vector<int8_t> MakeQuantizedValues(int size, int seed) {
+  std::vector<int8_t> values(size);
+  for (int i = 0; i < size; ++i) {
+    values[i] = static_cast<int8_t>(((i + seed) * 37) % 256 - 128);
+  }
+  return values;
+}
+
+// Requantizes |value| as ruy does up to rounding of the fixed-point multiply.
+int32_t Requantize(int32_t value, int32_t mantissa, int32_t exponent,
+                   int32_t zero_point) {
+  double scaled = value * (mantissa / 2147483648.0) * std::ldexp(1.0, exponent);
+  return std::min(127, std::max(-128, static_cast<int32_t>(std::lround(
+                                          scaled)) + zero_point));
+}
+
+TEST(MatMul, QuantizedI8I8I32) {
+  const int m = 5, k = 7, n = 3;
+  auto lhs = MakeQuantizedValues(m * k, 1);
+  auto rhs = MakeQuantizedValues(n * k, 2);
+  std::vector<int32_t> dst(n * m);
+
+  MatMul::Buffers<int8_t, int32_t, int32_t> buffers;
+  buffers.lhs_shape = {m, k};
+  buffers.lhs_buffer = lhs;
+  buffers.rhs_shape = {n, k};
+  buffers.rhs_buffer = rhs;
+  buffers.dst_shape = {n, m};
+  buffers.dst_buffer = absl::MakeSpan(dst);
+  buffers.lhs_zero_point = 3;
+  buffers.rhs_zero_point = -5;
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(MatMul::Execute(runtime_state.get(), buffers));
+
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < m; ++j) {
+      int32_t expected = 0;
+      for (int l = 0; l < k; ++l) {
+        expected += (lhs[j * k + l] - 3) * (rhs[i * k + l] + 5);
+      }
+      EXPECT_EQ(expected, dst[i * m + j]) << "dst[" << i << ", " << j << "]";
+    }
+  }
+}
+
+TEST(MatMul, QuantizedI8I8I8PerChannel) {
+  const int m = 4, k = 16, n = 6;
+  auto lhs = MakeQuantizedValues(m * k, 3);
+  auto rhs = MakeQuantizedValues(n * k, 4);
+  std::vector<int8_t> dst(n * m);
+  // One multiplier per row of lhs (the destination channels).
+  std::vector<int32_t> mantissas = {1 << 30, 1 << 29, 1 << 30, 3 << 28};
+  std::vector<int32_t> exponents = {-9, -8, -10, -9};
+
+  MatMul::Buffers<int8_t, int32_t, int8_t> buffers;
+  buffers.lhs_shape = {m, k};
+  buffers.lhs_buffer = lhs;
+  buffers.rhs_shape = {n, k};
+  buffers.rhs_buffer = rhs;
+  buffers.dst_shape = {n, m};
+  buffers.dst_buffer = absl::MakeSpan(dst);
+  buffers.lhs_zero_point = -1;
+  buffers.rhs_zero_point = 2;
+  buffers.dst_zero_point = 10;
+  buffers.multiplier_mantissa_buffer = mantissas;
+  buffers.multiplier_exponent_buffer = exponents;
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(MatMul::Execute(runtime_state.get(), buffers));
+
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < m; ++j) {
+      int32_t accumulator = 0;
+      for (int l = 0; l < k; ++l) {
+        accumulator += (lhs[j * k + l] + 1) * (rhs[i * k + l] - 2);
+      }
+      int32_t expected =
+          Requantize(accumulator, mantissas[j], exponents[j], 10);
+      EXPECT_NEAR(expected, dst[i * m + j], 1)
+          << "dst[" << i << ", " << j << "]";
+    }
+  }
+}
+
+TEST(MatMul, RejectsMismatchedMultipliers) {
+  const int m = 4, k = 8, n = 2;
+  auto lhs = MakeQuantizedValues(m * k, 1);
+  auto rhs = MakeQuantizedValues(n * k, 2);
+  std::vector<int8_t> dst(n * m);
+  // Per-channel mantissas with a uniform exponent.
+  std::vector<int32_t> mantissas(m, 1 << 30);
+  std::vector<int32_t> exponents = {-8};
+
+  MatMul::Buffers<int8_t, int32_t, int8_t> buffers;
+  buffers.lhs_shape = {m, k};
+  buffers.lhs_buffer = lhs;
+  buffers.rhs_shape = {n, k};
+  buffers.rhs_buffer = rhs;
+  buffers.dst_shape = {n, m};
+  buffers.dst_buffer = absl::MakeSpan(dst);
+  buffers.multiplier_mantissa_buffer = mantissas;
+  buffers.multiplier_exponent_buffer = exponents;
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_TRUE(IsInvalidArgument(MatMul::Execute(runtime_state.get(), buffers)));
+
+  // And the reverse.
+  std::vector<int32_t> uniform_mantissa = {1 << 30};
+  std::vector<int32_t> per_channel_exponents(m, -8);
+  buffers.multiplier_mantissa_buffer = uniform_mantissa;
+  buffers.multiplier_exponent_buffer = per_channel_exponents;
+  EXPECT_TRUE(IsInvalidArgument(MatMul::Execute(runtime_state.get(), buffers)));
+
+  // Per-channel multipliers for fewer channels than the lhs has rows.
+  std::vector<int32_t> short_mantissas(m - 1, 1 << 30);
+  std::vector<int32_t> short_exponents(m - 1, -8);
+  buffers.multiplier_mantissa_buffer = short_mantissas;
+  buffers.multiplier_exponent_buffer = short_exponents;
+  EXPECT_TRUE(IsInvalidArgument(MatMul::Execute(runtime_state.get(), buffers)));
+}
+
+// Runs the quantized GEMM convolution and the float reference convolution on
+// the same (zero point adjusted) values and returns both results.
+void RunQuantizedConv2D(const Shape& input_shape, const Shape& filter_shape,
+                        const Shape& dst_shape, const Shape& strides,
+                        const Shape& pad_h, const Shape& pad_w,
+                        const Shape& dilation, int32_t groups,
+                        const Conv2D::Quantization<int8_t, int32_t, int32_t>&
+                            quantization,
+                        std::vector<int32_t>* dst,
+                        std::vector<float>* expected_dst) {
+  auto input = MakeQuantizedValues(input_shape.element_count(), 5);
+  auto filter = MakeQuantizedValues(filter_shape.element_count(), 6);
+  std::vector<float> input_values(input.size());
+  for (int i = 0; i < input.size(); ++i) {
+    input_values[i] = input[i] - quantization.input_zero_point;
+  }
+  std::vector<float> filter_values(filter.size());
+  for (int i = 0; i < filter.size(); ++i) {
+    filter_values[i] = filter[i] - quantization.filter_zero_point;
+  }
+
+  expected_dst->resize(dst_shape.element_count());
+  EXPECT_OK(Conv2D::Execute<float>(input_values, input_shape, filter_values,
+                                   filter_shape, absl::MakeSpan(*expected_dst),
+                                   dst_shape, strides, pad_h, pad_w, dilation,
+                                   groups));
+
+  dst->resize(dst_shape.element_count());
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(Conv2D::Execute<int8_t>(
+      runtime_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(*dst), dst_shape, strides, pad_h, pad_w, dilation, groups,
+      quantization));
+}
+
+TEST(Conv2d, QuantizedI8I8I32) {
+  Conv2D::Quantization<int8_t, int32_t, int32_t> quantization;
+  quantization.input_zero_point = -7;
+  quantization.filter_zero_point = 4;
+  std::vector<int32_t> dst;
+  std::vector<float> expected_dst;
+  RunQuantizedConv2D({7, 9, 4}, {3, 3, 2, 6}, {4, 5, 6}, {2, 2}, {1, 1},
+                     {1, 2}, {1, 1}, 2, quantization, &dst, &expected_dst);
+  for (int i = 0; i < dst.size(); ++i) {
+    EXPECT_EQ(static_cast<int32_t>(expected_dst[i]), dst[i]) << "index " << i;
+  }
+}
+
+TEST(Conv2d, Quantized1x1I8I8I32) {
+  Conv2D::Quantization<int8_t, int32_t, int32_t> quantization;
+  quantization.input_zero_point = 12;
+  quantization.filter_zero_point = -3;
+  std::vector<int32_t> dst;
+  std::vector<float> expected_dst;
+  RunQuantizedConv2D({5, 6, 8}, {1, 1, 8, 3}, {5, 6, 3}, {1, 1}, {0, 0},
+                     {0, 0}, {1, 1}, 1, quantization, &dst, &expected_dst);
+  for (int i = 0; i < dst.size(); ++i) {
+    EXPECT_EQ(static_cast<int32_t>(expected_dst[i]), dst[i]) << "index " << i;
+  }
+}
+
+TEST(Conv2d, QuantizedI8I8I8PerChannel) {
+  Shape input_shape = {6, 6, 4};
+  Shape filter_shape = {3, 3, 2, 4};
+  Shape dst_shape = {6, 6, 4};
+  Shape strides = {1, 1};
+  Shape pad = {1, 1};
+  Shape dilation = {1, 1};
+  const int32_t groups = 2;
+  std::vector<int32_t> mantissas = {1 << 30, 3 << 28, 1 << 29, 1 << 30};
+  std::vector<int32_t> exponents = {-9, -9, -8, -10};
+
+  // Compute the accumulators to requantize using the i32 kernel.
+  Conv2D::Quantization<int8_t, int32_t, int32_t> accumulator_quantization;
+  accumulator_quantization.input_zero_point = 3;
+  accumulator_quantization.filter_zero_point = -2;
+  std::vector<int32_t> accumulators;
+  std::vector<float> expected_accumulators;
+  RunQuantizedConv2D(input_shape, filter_shape, dst_shape, strides, pad, pad,
+                     dilation, groups, accumulator_quantization, &accumulators,
+                     &expected_accumulators);
+
+  Conv2D::Quantization<int8_t, int32_t, int8_t> quantization;
+  quantization.input_zero_point = 3;
+  quantization.filter_zero_point = -2;
+  quantization.dst_zero_point = -20;
+  quantization.multiplier_mantissa_buffer = mantissas;
+  quantization.multiplier_exponent_buffer = exponents;
+  auto input = MakeQuantizedValues(input_shape.element_count(), 5);
+  auto filter = MakeQuantizedValues(filter_shape.element_count(), 6);
+  std::vector<int8_t> dst(dst_shape.element_count());
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(Conv2D::Execute<int8_t>(
+      runtime_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, strides, pad, pad, dilation, groups,
+      quantization));
+
+  for (int i = 0; i < dst.size(); ++i) {
+    const int channel = i % dst_shape[2];
+    int32_t expected =
+        Requantize(static_cast<int32_t>(expected_accumulators[i]),
+                   mantissas[channel], exponents[channel], -20);
+    EXPECT_NEAR(expected, dst[i], 1) << "index " << i;
+  }
+}
+
+TEST(Conv2d, RejectsMismatchedMultipliers) {
+  Shape input_shape = {4, 4, 4};
+  Shape filter_shape = {3, 3, 2, 4};
+  Shape dst_shape = {2, 2, 4};
+  auto input = MakeQuantizedValues(input_shape.element_count(), 5);
+  auto filter = MakeQuantizedValues(filter_shape.element_count(), 6);
+  std::vector<int8_t> dst(dst_shape.element_count());
+  // Per-channel mantissas with a uniform exponent.
+  std::vector<int32_t> mantissas(dst_shape[2], 1 << 30);
+  std::vector<int32_t> exponents = {-8};
+
+  Conv2D::Quantization<int8_t, int32_t, int8_t> quantization;
+  quantization.multiplier_mantissa_buffer = mantissas;
+  quantization.multiplier_exponent_buffer = exponents;
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_TRUE(IsInvalidArgument(Conv2D::Execute<int8_t>(
+      runtime_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, {1, 1}, {0, 0}, {0, 0}, {1, 1},
+      /*groups=*/2, quantization)));
+
+  // Per-channel multipliers for only the first group's channels.
+  std::vector<int32_t> short_mantissas(dst_shape[2] / 2, 1 << 30);
+  std::vector<int32_t> short_exponents(dst_shape[2] / 2, -8);
+  quantization.multiplier_mantissa_buffer = short_mantissas;
+  quantization.multiplier_exponent_buffer = short_exponents;
+  EXPECT_TRUE(IsInvalidArgument(Conv2D::Execute<int8_t>(
+      runtime_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, {1, 1}, {0, 0}, {0, 0}, {1, 1},
+      /*groups=*/2, quantization)));
+}
+
+// Rounds |values| to the 16-bit float type T.
+template <typename T>
+std::vector<T> Narrow(absl::Span<const float> values) {
+  std::vector<T> narrowed(values.size());
+  EXPECT_OK((Convert::Execute<float, T>(values, absl::MakeSpan(narrowed))));
+  return narrowed;
+}
+
+// Runs the f32 and T (f16 or bf16) GEMM convolutions on the same values and
+// expects the T results to be the f32 results rounded to T. The values are
+// small integers so that they and the f32 accumulators are exact.
+template <typename T>
+void ExpectHalfConv2DMatchesF32(const Shape& input_shape,
+                                const Shape& filter_shape,
+                                const Shape& dst_shape, int32_t groups) {
+  std::vector<float> input(input_shape.element_count());
+  for (int i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>((i * 7) % 13) - 6.0f;
+  }
+  std::vector<float> filter(filter_shape.element_count());
+  for (int i = 0; i < filter.size(); ++i) {
+    filter[i] = static_cast<float>((i * 5) % 11) - 5.0f;
+  }
+  Shape strides = {1, 1};
+  Shape pad = {1, 1};
+  Shape dilation = {1, 1};
+
+  auto runtime_state = MatMul::CreateRuntimeState();
+  std::vector<float> dst(dst_shape.element_count());
+  EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input, input_shape, filter, filter_shape,
+      absl::MakeSpan(dst), dst_shape, strides, pad, pad, dilation, groups));
+  auto expected_dst = Narrow<T>(dst);
+
+  auto half_input = Narrow<T>(input);
+  auto half_filter = Narrow<T>(filter);
+  std::vector<T> half_dst(dst_shape.element_count());
+  EXPECT_OK(Conv2D::Execute<T>(runtime_state.get(), half_input, input_shape,
+                               half_filter, filter_shape,
+                               absl::MakeSpan(half_dst), dst_shape, strides,
+                               pad, pad, dilation, groups));
+
+  for (int i = 0; i < half_dst.size(); ++i) {
+    EXPECT_EQ(expected_dst[i].bits, half_dst[i].bits) << "index " << i;
+  }
+
+  // The mixed type overload (with its quantization ignored) matches as well.
+  std::vector<T> mixed_dst(dst_shape.element_count());
+  EXPECT_OK(Conv2D::Execute(runtime_state.get(),
+                            absl::MakeConstSpan(half_input), input_shape,
+                            absl::MakeConstSpan(half_filter), filter_shape,
+                            absl::MakeSpan(mixed_dst), dst_shape, strides, pad,
+                            pad, dilation, groups,
+                            Conv2D::Quantization<T, float, T>()));
+  for (int i = 0; i < mixed_dst.size(); ++i) {
+    EXPECT_EQ(expected_dst[i].bits, mixed_dst[i].bits) << "index " << i;
+  }
+}
+
+TEST(Conv2d, GemmF16) {
+  ExpectHalfConv2DMatchesF32<Half>({6, 7, 4}, {3, 3, 2, 6}, {6, 7, 6}, 2);
+}
+
+TEST(Conv2d, GemmBF16) {
+  ExpectHalfConv2DMatchesF32<BFloat16>({6, 7, 4}, {3, 3, 4, 5}, {6, 7, 5}, 1);
+}
+
+TEST(MatMul, F16F16F16) {
+  const int m = 5, k = 9, n = 4;
+  std::vector<float> lhs(m * k);
+  for (int i = 0; i < lhs.size(); ++i) lhs[i] = (i % 9) * 0.5f - 2.0f;
+  std::vector<float> rhs(n * k);
+  for (int i = 0; i < rhs.size(); ++i) rhs[i] = (i % 7) * 0.25f - 0.75f;
+  auto half_lhs = Narrow<Half>(lhs);
+  auto half_rhs = Narrow<Half>(rhs);
+  std::vector<Half> dst(n * m);
+
+  MatMul::Buffers<Half, float, Half> buffers;
+  buffers.lhs_shape = {m, k};
+  buffers.lhs_buffer = half_lhs;
+  buffers.rhs_shape = {n, k};
+  buffers.rhs_buffer = half_rhs;
+  buffers.dst_shape = {n, m};
+  buffers.dst_buffer = absl::MakeSpan(dst);
+  auto runtime_state = MatMul::CreateRuntimeState();
+  EXPECT_OK(MatMul::Execute(runtime_state.get(), buffers));
+
+  std::vector<float> expected(n * m);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < m; ++j) {
+      for (int l = 0; l < k; ++l) {
+        expected[i * m + j] += lhs[j * k + l] * rhs[i * k + l];
+      }
+    }
+  }
+  auto expected_dst = Narrow<Half>(expected);
+  for (int i = 0; i < dst.size(); ++i) {
+    EXPECT_EQ(expected_dst[i].bits, dst[i].bits) << "index " << i;
+  }
+}
+
+TEST(MatMulThreadPool, DefaultsToHardwareThreads) {
+  auto thread_pool = MatMul::CreateThreadPool(0);
+  EXPECT_GE(thread_pool->max_threads(), 1);
+}
+
+TEST(MatMulThreadPool, SharesThreadBudget) {
+  auto thread_pool = MatMul::CreateThreadPool(4);
+  EXPECT_EQ(4, thread_pool->max_threads());
+
+  // Hints are clamped to the budget left by contexts in use.
+  auto context_a = thread_pool->AcquireContext(/*thread_hint=*/3);
+  EXPECT_EQ(3, context_a->max_num_threads());
+  auto context_b = thread_pool->AcquireContext(/*thread_hint=*/0);
+  EXPECT_EQ(1, context_b->max_num_threads());
+
+  // The calling thread is always available even when the budget is used up.
+  auto context_c = thread_pool->AcquireContext(/*thread_hint=*/2);
+  EXPECT_EQ(1, context_c->max_num_threads());
+
+  thread_pool->ReleaseContext(std::move(context_a));
+  thread_pool->ReleaseContext(std::move(context_c));
+  auto context_d = thread_pool->AcquireContext(/*thread_hint=*/0);
+  EXPECT_EQ(3, context_d->max_num_threads());
+
+  thread_pool->ReleaseContext(std::move(context_b));
+  thread_pool->ReleaseContext(std::move(context_d));
+  auto context_e = thread_pool->AcquireContext(/*thread_hint=*/8);
+  EXPECT_EQ(4, context_e->max_num_threads());
+  thread_pool->ReleaseContext(std::move(context_e));
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
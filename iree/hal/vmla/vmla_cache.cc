@@ -18,12 +18,20 @@
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/executable_format.h"
-#include "iree/hal/vmla/vmla_executable.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace {
+
+absl::string_view ExecutableDataKey(absl::Span<const uint8_t> data) {
+  return absl::string_view(reinterpret_cast<const char*>(data.data()),
+                           data.size());
+}
+
+}  // namespace
+
 VMLACache::VMLACache(iree_vm_instance_t* instance,
                      iree_vm_module_t* vmla_module)
     : instance_(instance), vmla_module_(vmla_module) {
@@ -32,6 +40,10 @@ VMLACache::VMLACache(iree_vm_instance_t* instance,
 }
 
 VMLACache::~VMLACache() {
+  {
+    absl::MutexLock lock(&mutex_);
+    executables_.clear();
+  }
   iree_vm_module_release(vmla_module_);
   iree_vm_instance_release(instance_);
 }
@@ -44,14 +56,28 @@ StatusOr<ref_ptr<Executable>> VMLACache::PrepareExecutable(
     ExecutableLayout* executable_layout, ExecutableCachingModeBitfield mode,
     const ExecutableSpec& spec) {
   IREE_TRACE_SCOPE0("VMLACache::PrepareExecutable");
-  // Wrap the data (or copy it).
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = executables_.find(ExecutableDataKey(spec.executable_data));
+    if (it != executables_.end()) {
+      return add_ref(it->second);
+    }
+  }
+
+  // Wrap the data (or copy it). Aliased data is required to remain valid for
+  // the lifetime of the cache and can be used as the key.
   bool allow_aliasing_data =
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
   ASSIGN_OR_RETURN(auto executable,
                    VMLAExecutable::Load(instance_, vmla_module_, spec,
-                                        !allow_aliasing_data));
+                                        allow_aliasing_data));
 
-  return executable;
+  // Another thread may have prepared the same executable while we were
+  // loading; prefer the one already in the cache so that all callers share it.
+  absl::MutexLock lock(&mutex_);
+  auto key = ExecutableDataKey(executable->executable_data());
+  auto it = executables_.emplace(key, std::move(executable)).first;
+  return add_ref(it->second);
 }
 
 }  // namespace vmla
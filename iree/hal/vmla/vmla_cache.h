@@ -15,9 +15,15 @@
 #ifndef IREE_HAL_VMLA_VMLA_CACHE_H_
 #define IREE_HAL_VMLA_VMLA_CACHE_H_
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
+#include "iree/hal/vmla/vmla_executable.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
 
@@ -25,6 +31,10 @@ namespace iree {
 namespace hal {
 namespace vmla {
 
+// Executables are retained by the cache and shared by all callers preparing
+// the same executable data. VMLA executables are loaded directly from their
+// bytecode and have no prepared form to persist, so the cache has nothing to
+// serialize and cannot be warm-started.
 class VMLACache final : public ExecutableCache {
  public:
   explicit VMLACache(iree_vm_instance_t* instance,
@@ -40,6 +50,12 @@ class VMLACache final : public ExecutableCache {
  private:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_module_t* vmla_module_ = nullptr;
+
+  // Prepared executables keyed by their executable data. Keys reference the
+  // data retained (or aliased) by the executable itself.
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<absl::string_view, ref_ptr<VMLAExecutable>> executables_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace vmla
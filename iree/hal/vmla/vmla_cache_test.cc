@@ -0,0 +1,143 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/vmla_cache.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/status_matchers.h"
+#include "iree/hal/executable_format.h"
+#include "iree/hal/vmla/vmla_cache_test_module.h"
+#include "iree/hal/vmla/vmla_executable.h"
+#include "iree/hal/vmla/vmla_module.h"
+#include "iree/schemas/vmla_executable_def_generated.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+// Returns a VMLAExecutableDef wrapping the test bytecode module. Each
+// |padding| produces distinct executable data (trailing bytes are ignored by
+// the flatbuffer) for the same module.
+std::vector<uint8_t> MakeExecutableData(size_t padding = 0) {
+  const auto* module_file_toc = vmla_cache_test_module_create();
+  ::flatbuffers::FlatBufferBuilder fbb;
+  auto bytecode_module_offset = fbb.CreateVector(
+      reinterpret_cast<const int8_t*>(module_file_toc->data),
+      module_file_toc->size);
+  iree::FinishVMLAExecutableDefBuffer(
+      fbb, iree::CreateVMLAExecutableDef(fbb, bytecode_module_offset));
+  std::vector<uint8_t> data(fbb.GetBufferPointer(),
+                            fbb.GetBufferPointer() + fbb.GetSize());
+  data.resize(data.size() + padding);
+  return data;
+}
+
+absl::Span<const uint8_t> GetExecutableData(const ref_ptr<Executable>& e) {
+  return static_cast<VMLAExecutable*>(e.get())->executable_data();
+}
+
+class VMLACacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+    ASSERT_OK(ModuleRegisterTypes());
+    ASSERT_OK(ModuleCreate(IREE_ALLOCATOR_SYSTEM, &vmla_module_));
+  }
+
+  void TearDown() override {
+    iree_vm_module_release(vmla_module_);
+    iree_vm_instance_release(instance_);
+  }
+
+  StatusOr<ref_ptr<Executable>> Prepare(VMLACache* cache,
+                                        absl::Span<const uint8_t> data,
+                                        ExecutableCachingModeBitfield mode) {
+    ExecutableSpec spec;
+    spec.executable_data = data;
+    return cache->PrepareExecutable(/*executable_layout=*/nullptr, mode, spec);
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* vmla_module_ = nullptr;
+};
+
+TEST_F(VMLACacheTest, MemoizesByContent) {
+  VMLACache cache(instance_, vmla_module_);
+  auto data = MakeExecutableData();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      Prepare(&cache, data, ExecutableCachingMode::kAllowPersistentCaching));
+
+  // Preparing equal data from a different buffer returns the same executable.
+  auto data_copy = data;
+  ASSERT_OK_AND_ASSIGN(
+      auto same_executable,
+      Prepare(&cache, data_copy,
+              ExecutableCachingMode::kAllowPersistentCaching));
+  EXPECT_EQ(executable.get(), same_executable.get());
+
+  // Different data produces a different executable.
+  auto other_data = MakeExecutableData(/*padding=*/8);
+  ASSERT_OK_AND_ASSIGN(
+      auto other_executable,
+      Prepare(&cache, other_data,
+              ExecutableCachingMode::kAllowPersistentCaching));
+  EXPECT_NE(executable.get(), other_executable.get());
+}
+
+TEST_F(VMLACacheTest, AliasesDataOnlyWhenAllowed) {
+  VMLACache cache(instance_, vmla_module_);
+  auto aliased_data = MakeExecutableData();
+  ASSERT_OK_AND_ASSIGN(
+      auto aliased_executable,
+      Prepare(&cache, aliased_data, ExecutableCachingMode::kAliasProvidedData));
+  EXPECT_EQ(aliased_data.data(), GetExecutableData(aliased_executable).data());
+
+  // Without aliasing the executable (and the cache key) must own a copy that
+  // remains valid after the caller's data is gone.
+  auto cloned_data = MakeExecutableData(/*padding=*/8);
+  ASSERT_OK_AND_ASSIGN(
+      auto cloned_executable,
+      Prepare(&cache, cloned_data,
+              ExecutableCachingMode::kAllowPersistentCaching));
+  EXPECT_NE(cloned_data.data(), GetExecutableData(cloned_executable).data());
+  auto expected_data = cloned_data;
+  cloned_data.assign(cloned_data.size(), 0xCD);
+  ASSERT_OK_AND_ASSIGN(
+      auto memoized_executable,
+      Prepare(&cache, expected_data,
+              ExecutableCachingMode::kAllowPersistentCaching));
+  EXPECT_EQ(cloned_executable.get(), memoized_executable.get());
+}
+
+// VMLA executables have no prepared form so there is nothing to serialize.
+TEST_F(VMLACacheTest, SerializesNothing) {
+  VMLACache cache(instance_, vmla_module_);
+  auto data = MakeExecutableData();
+  ASSERT_OK_AND_ASSIGN(
+      auto executable,
+      Prepare(&cache, data, ExecutableCachingMode::kAllowPersistentCaching));
+  ASSERT_OK_AND_ASSIGN(auto serialized_data, cache.Serialize());
+  EXPECT_TRUE(serialized_data.empty());
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,8 @@
+// Minimal executable module loaded by vmla_cache_test.cc. The cache only needs
+// the module to load; the entry point is never invoked.
+vm.module @vmla_cache_test {
+  vm.export @entry
+  vm.func @entry() {
+    vm.return
+  }
+}
@@ -14,10 +14,16 @@
 
 #include "iree/hal/vmla/vmla_command_processor.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
 #include "iree/base/api_util.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
+#include "iree/hal/vmla/op_kernels.h"
 #include "iree/hal/vmla/vmla_executable.h"
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/vm/invocation.h"
@@ -29,8 +35,11 @@ namespace vmla {
 
 VMLACommandProcessor::VMLACommandProcessor(
     Allocator* allocator, CommandBufferModeBitfield mode,
-    CommandCategoryBitfield command_categories)
-    : HostLocalCommandProcessor(allocator, mode, command_categories) {}
+    CommandCategoryBitfield command_categories, WorkgroupPool* workgroup_pool,
+    kernels::MatMulThreadPool* thread_pool)
+    : HostLocalCommandProcessor(allocator, mode, command_categories),
+      workgroup_pool_(workgroup_pool),
+      thread_pool_(thread_pool) {}
 
 VMLACommandProcessor::~VMLACommandProcessor() = default;
 
@@ -46,9 +55,13 @@ Status VMLACommandProcessor::DispatchInline(
            << "Invalid entry point ordinal " << entry_point;
   }
 
-  auto interface = vmla_executable->interface();
-  RETURN_IF_ERROR(interface->SetConstants(push_constants.values));
-
+  // Wrap the bindings once; each worker context retains its own references.
+  struct WrappedBinding {
+    int32_t set;
+    int32_t binding;
+    vm::ref<Buffer> buffer;
+  };
+  absl::InlinedVector<WrappedBinding, 8> wrapped_bindings;
   for (int set_ordinal = 0; set_ordinal < set_bindings.size(); ++set_ordinal) {
     for (const auto& binding : set_bindings[set_ordinal]) {
       // TODO(benvanik): plumb binding directly into VMLA to avoid this.
@@ -59,17 +72,61 @@ Status VMLACommandProcessor::DispatchInline(
       ASSIGN_OR_RETURN(auto buffer,
                        Buffer::WrapMutable(data, binding.buffer->byte_length(),
                                            IREE_ALLOCATOR_NULL));
-      RETURN_IF_ERROR(interface->SetBinding(set_ordinal, binding.binding,
-                                            {std::move(buffer)}));
+      wrapped_bindings.push_back(
+          {set_ordinal, binding.binding, std::move(buffer)});
     }
   }
 
-  return FromApiStatus(
-      iree_vm_invoke(vmla_executable->context(),
-                     vmla_executable->entry_functions()[entry_point],
-                     /*policy=*/nullptr, vmla_executable->interface_inputs(),
-                     /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM),
-      IREE_LOC);
+  // Workgroups executing concurrently split the kernel threads of the device
+  // evenly between them; a dispatch with a single workgroup may use them all.
+  int thread_hint = 0;
+  if (thread_pool_) {
+    const uint64_t workgroup_count =
+        static_cast<uint64_t>(workgroups[0]) * workgroups[1] * workgroups[2];
+    const int concurrent_workgroups = static_cast<int>(std::max<uint64_t>(
+        1, std::min<uint64_t>(workgroup_count,
+                              workgroup_pool_->worker_count())));
+    thread_hint =
+        std::max(1, thread_pool_->max_threads() / concurrent_workgroups);
+  }
+
+  // Each worker lazily acquires its own context the first time it executes a
+  // workgroup of this dispatch so that single-workgroup dispatches (and
+  // workers that never get scheduled) don't pay for additional contexts.
+  std::vector<std::unique_ptr<VMLAExecutable::InvocationState>>
+      worker_states(workgroup_pool_->worker_count());
+  auto workgroup_fn = [&](int worker_ordinal,
+                          const WorkgroupState& workgroup_state) -> Status {
+    auto& invocation_state = worker_states[worker_ordinal];
+    if (!invocation_state) {
+      ASSIGN_OR_RETURN(invocation_state,
+                       vmla_executable->AcquireInvocationState());
+      auto* interface = invocation_state->interface;
+      interface->SetThreadPool(thread_pool_, thread_hint);
+      RETURN_IF_ERROR(interface->SetConstants(push_constants.values));
+      for (const auto& wrapped_binding : wrapped_bindings) {
+        RETURN_IF_ERROR(interface->SetBinding(
+            wrapped_binding.set, wrapped_binding.binding,
+            {vm::retain_ref(wrapped_binding.buffer)}));
+      }
+    }
+    invocation_state->interface->SetWorkgroup(workgroup_state.workgroup_id,
+                                              workgroup_state.workgroup_count);
+    return FromApiStatus(
+        iree_vm_invoke(invocation_state->context,
+                       vmla_executable->entry_functions()[entry_point],
+                       /*policy=*/nullptr, invocation_state->interface_inputs,
+                       /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM),
+        IREE_LOC);
+  };
+  auto status = workgroup_pool_->DispatchGrid(workgroups, workgroup_fn);
+
+  for (auto& invocation_state : worker_states) {
+    if (invocation_state) {
+      vmla_executable->ReleaseInvocationState(std::move(invocation_state));
+    }
+  }
+  return status;
 }
 
 }  // namespace vmla
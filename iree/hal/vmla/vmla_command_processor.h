@@ -16,15 +16,22 @@
 #define IREE_HAL_VMLA_VMLA_COMMAND_PROCESSOR_H_
 
 #include "iree/hal/host/host_local_command_processor.h"
+#include "iree/hal/host/workgroup_pool.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace kernels {
+class MatMulThreadPool;
+}  // namespace kernels
+
 class VMLACommandProcessor final : public HostLocalCommandProcessor {
  public:
   VMLACommandProcessor(Allocator* allocator, CommandBufferModeBitfield mode,
-                       CommandCategoryBitfield command_categories);
+                       CommandCategoryBitfield command_categories,
+                       WorkgroupPool* workgroup_pool,
+                       kernels::MatMulThreadPool* thread_pool);
   ~VMLACommandProcessor() override;
 
   Status DispatchInline(
@@ -33,6 +40,10 @@ class VMLACommandProcessor final : public HostLocalCommandProcessor {
       const PushConstantBlock& push_constants,
       absl::Span<const absl::Span<const DescriptorSet::Binding>> set_bindings)
       override;
+
+ private:
+  WorkgroupPool* workgroup_pool_;
+  kernels::MatMulThreadPool* thread_pool_;
 };
 
 }  // namespace vmla
@@ -50,9 +50,13 @@ namespace {
 class UnsynchronizedCommandQueue final : public CommandQueue {
  public:
   UnsynchronizedCommandQueue(Allocator* allocator, std::string name,
-                             CommandCategoryBitfield supported_categories)
+                             CommandCategoryBitfield supported_categories,
+                             WorkgroupPool* workgroup_pool,
+                             kernels::MatMulThreadPool* kernel_thread_pool)
       : CommandQueue(std::move(name), supported_categories),
-        allocator_(allocator) {}
+        allocator_(allocator),
+        workgroup_pool_(workgroup_pool),
+        kernel_thread_pool_(kernel_thread_pool) {}
   ~UnsynchronizedCommandQueue() override = default;
 
   Status Submit(absl::Span<const SubmissionBatch> batches,
@@ -88,21 +92,34 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
     for (auto* command_buffer : command_buffers) {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
-      VMLACommandProcessor command_processor(allocator_, command_buffer->mode(),
-                                             supported_categories());
-      RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
+      VMLACommandProcessor command_processor(
+          allocator_, command_buffer->mode(), supported_categories(),
+          workgroup_pool_, kernel_thread_pool_);
+      RETURN_IF_ERROR(inproc_command_buffer->Process(
+          &command_processor, command_buffer->binding_table()));
     }
     return OkStatus();
   }
 
   Allocator* const allocator_;
+  WorkgroupPool* const workgroup_pool_;
+  kernels::MatMulThreadPool* const kernel_thread_pool_;
 };
 
 }  // namespace
 
-VMLADevice::VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
+VMLADevice::VMLADevice(DeviceInfo device_info,
+                       WorkgroupPool::Options workgroup_pool_options,
+                       HostBufferPool::Options allocator_pool_options,
+                       int kernel_max_threads, ref_ptr<TaskExecutor> executor,
+                       iree_vm_instance_t* instance,
                        iree_vm_module_t* vmla_module)
     : Device(std::move(device_info)),
+      allocator_(std::move(allocator_pool_options)),
+      workgroup_pool_(
+          absl::make_unique<WorkgroupPool>(std::move(workgroup_pool_options))),
+      kernel_thread_pool_(
+          kernels::MatMul::CreateThreadPool(kernel_max_threads)),
       instance_(instance),
       vmla_module_(vmla_module) {
   iree_vm_instance_retain(instance_);
@@ -111,12 +128,13 @@ VMLADevice::VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
   // We currently only expose a single command queue.
   auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
       &allocator_, "cpu0",
-      CommandCategory::kTransfer | CommandCategory::kDispatch);
+      CommandCategory::kTransfer | CommandCategory::kDispatch,
+      workgroup_pool_.get(), kernel_thread_pool_.get());
 
   // TODO(benvanik): allow injection of the wrapper type to support
   // SyncCommandQueue without always linking in both.
-  auto async_command_queue =
-      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
+  auto async_command_queue = absl::make_unique<AsyncCommandQueue>(
+      std::move(command_queue), std::move(executor));
   command_queues_.push_back(std::move(async_command_queue));
 }
 
@@ -128,7 +146,11 @@ VMLADevice::~VMLADevice() {
 std::string VMLADevice::DebugString() const {
   return absl::StrCat(Device::DebugString(),  //
                       "\n[VMLADevice]",       //
-                      "\n  Command Queues: ", command_queues_.size());
+                      "\n  Command Queues: ", command_queues_.size(),
+                      "\n  Workgroup Workers: ",
+                      workgroup_pool_->worker_count(),
+                      "\n  Kernel Threads: ",
+                      kernel_thread_pool_->max_threads());
 }
 
 ref_ptr<ExecutableCache> VMLADevice::CreateExecutableCache() {
@@ -136,6 +158,14 @@ ref_ptr<ExecutableCache> VMLADevice::CreateExecutableCache() {
   return make_ref<VMLACache>(instance_, vmla_module_);
 }
 
+StatusOr<ref_ptr<ExecutableCache>> VMLADevice::CreateExecutableCache(
+    absl::Span<const uint8_t> initial_data) {
+  IREE_TRACE_SCOPE0("VMLADevice::CreateExecutableCache");
+  // Executables are loaded directly from bytecode and there's nothing to warm
+  // up.
+  return CreateExecutableCache();
+}
+
 StatusOr<ref_ptr<DescriptorSetLayout>> VMLADevice::CreateDescriptorSetLayout(
     DescriptorSetLayout::UsageType usage_type,
     absl::Span<const DescriptorSetLayout::Binding> bindings) {
@@ -178,10 +208,7 @@ StatusOr<ref_ptr<BinarySemaphore>> VMLADevice::CreateBinarySemaphore(
 StatusOr<ref_ptr<TimelineSemaphore>> VMLADevice::CreateTimelineSemaphore(
     uint64_t initial_value) {
   IREE_TRACE_SCOPE0("VMLADevice::CreateTimelineSemaphore");
-
-  // TODO(b/140141417): implement timeline semaphores.
-  return UnimplementedErrorBuilder(IREE_LOC)
-         << "Timeline semaphores not yet implemented";
+  return make_ref<HostTimelineSemaphore>(initial_value);
 }
 
 StatusOr<ref_ptr<Fence>> VMLADevice::CreateFence(uint64_t initial_value) {
@@ -20,6 +20,9 @@
 #include "iree/base/memory.h"
 #include "iree/hal/device.h"
 #include "iree/hal/host/host_local_allocator.h"
+#include "iree/hal/host/task_executor.h"
+#include "iree/hal/host/workgroup_pool.h"
+#include "iree/hal/vmla/op_kernels.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
 
@@ -29,8 +32,14 @@ namespace vmla {
 
 class VMLADevice final : public Device {
  public:
-  explicit VMLADevice(DeviceInfo device_info, iree_vm_instance_t* instance,
-                      iree_vm_module_t* vmla_module);
+  // |kernel_max_threads| bounds the threads used by multithreaded kernels
+  // (such as matmul) of all executables on the device, with 0 using one per
+  // hardware thread.
+  VMLADevice(DeviceInfo device_info,
+             WorkgroupPool::Options workgroup_pool_options,
+             HostBufferPool::Options allocator_pool_options,
+             int kernel_max_threads, ref_ptr<TaskExecutor> executor,
+             iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
   ~VMLADevice() override;
 
   std::string DebugString() const override;
@@ -46,6 +55,8 @@ class VMLADevice final : public Device {
   }
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+  StatusOr<ref_ptr<ExecutableCache>> CreateExecutableCache(
+      absl::Span<const uint8_t> initial_data) override;
 
   StatusOr<ref_ptr<DescriptorSetLayout>> CreateDescriptorSetLayout(
       DescriptorSetLayout::UsageType usage_type,
@@ -80,6 +91,11 @@ class VMLADevice final : public Device {
 
  private:
   mutable HostLocalAllocator allocator_;
+  // Must outlive the command queues as they dispatch workgroups into it.
+  std::unique_ptr<WorkgroupPool> workgroup_pool_;
+  // Shared by the kernels of all workgroups executing on the device. Must
+  // outlive the command queues as workgroups acquire threads from it.
+  std::unique_ptr<kernels::MatMulThreadPool> kernel_thread_pool_;
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 1> command_queues_;
 
   iree_vm_instance_t* instance_ = nullptr;
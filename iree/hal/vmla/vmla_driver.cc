@@ -43,7 +43,7 @@ DeviceInfo GetDefaultDeviceInfo() {
 }  // namespace
 
 // static
-StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
+StatusOr<ref_ptr<Driver>> VMLADriver::Create(Options options) {
   IREE_TRACE_SCOPE0("VMLADriver::Create");
 
   // NOTE: we could use our own allocator here to hide these from any default
@@ -59,12 +59,15 @@ StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
   RETURN_IF_ERROR(ModuleCreate(IREE_ALLOCATOR_SYSTEM, &vmla_module))
       << "VMLA shared module creation failed";
 
-  return make_ref<VMLADriver>(instance, vmla_module);
+  return make_ref<VMLADriver>(std::move(options), instance, vmla_module);
 }
 
-VMLADriver::VMLADriver(iree_vm_instance_t* instance,
+VMLADriver::VMLADriver(Options options, iree_vm_instance_t* instance,
                        iree_vm_module_t* vmla_module)
-    : Driver("vmla"), instance_(instance), vmla_module_(vmla_module) {}
+    : Driver("vmla"),
+      options_(std::move(options)),
+      instance_(instance),
+      vmla_module_(vmla_module) {}
 
 VMLADriver::~VMLADriver() {
   IREE_TRACE_SCOPE0("VMLADriver::dtor");
@@ -83,8 +86,11 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
-  auto device =
-      make_ref<VMLADevice>(GetDefaultDeviceInfo(), instance_, vmla_module_);
+  auto device = make_ref<VMLADevice>(
+      GetDefaultDeviceInfo(), options_.workgroup_pool_options,
+      options_.allocator_pool_options, options_.kernel_max_threads,
+      TaskExecutor::GetOrCreateShared(options_.executor_options), instance_,
+      vmla_module_);
   return device;
 }
 
@@ -16,6 +16,9 @@
 #define IREE_HAL_VMLA_VMLA_DRIVER_H_
 
 #include "iree/hal/driver.h"
+#include "iree/hal/host/host_buffer_pool.h"
+#include "iree/hal/host/task_executor.h"
+#include "iree/hal/host/workgroup_pool.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
 
@@ -25,9 +28,25 @@ namespace vmla {
 
 class VMLADriver final : public Driver {
  public:
-  static StatusOr<ref_ptr<Driver>> Create();
+  struct Options {
+    // Controls the threads used to execute dispatch workgroups on each device.
+    WorkgroupPool::Options workgroup_pool_options;
+    // Maximum number of threads used by multithreaded kernels (such as
+    // matmul) on each device, shared by all executables. 0 uses one per
+    // hardware thread.
+    int kernel_max_threads = 0;
+    // Controls the caching of buffer memory by the allocator of each device.
+    HostBufferPool::Options allocator_pool_options;
+    // Controls the threads used to execute queue submissions. These are
+    // shared with all other host devices and only used if the shared
+    // executor has not yet been created.
+    TaskExecutor::Options executor_options;
+  };
 
-  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
+  static StatusOr<ref_ptr<Driver>> Create(Options options);
+
+  VMLADriver(Options options, iree_vm_instance_t* instance,
+             iree_vm_module_t* vmla_module);
   ~VMLADriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -37,6 +56,7 @@ class VMLADriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
 
  private:
+  Options options_;
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_module_t* vmla_module_ = nullptr;
 };
@@ -13,18 +13,57 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/strings/numbers.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
+#include "iree/hal/host/host_buffer_pool_flags.h"
+#include "iree/hal/host/task_executor_flags.h"
 #include "iree/hal/vmla/vmla_driver.h"
 
+ABSL_FLAG(int, vmla_worker_count, 0,
+          "Number of threads used to execute dispatch workgroups, including "
+          "the submitting thread. 0 uses one per hardware thread.");
+ABSL_FLAG(std::vector<std::string>, vmla_worker_affinity, {},
+          "Comma-separated logical CPU IDs to pin workgroup worker threads to. "
+          "The submitting thread is not pinned.");
+
+ABSL_FLAG(int, vmla_kernel_max_threads, 0,
+          "Maximum number of threads used by multithreaded kernels (such as "
+          "matmul) on each device, shared by all concurrently executing "
+          "workgroups. 0 uses one per hardware thread.");
+
 namespace iree {
 namespace hal {
 namespace vmla {
 namespace {
 
-StatusOr<ref_ptr<Driver>> CreateVMLADriver() { return VMLADriver::Create(); }
+StatusOr<ref_ptr<Driver>> CreateVMLADriver() {
+  // Setup driver options from flags. We do this here as we want to enable other
+  // consumers that may not be using modules/command line flags to be able to
+  // set their options however they want.
+  VMLADriver::Options options;
+  options.workgroup_pool_options.worker_count =
+      absl::GetFlag(FLAGS_vmla_worker_count);
+  for (const auto& cpu_str : absl::GetFlag(FLAGS_vmla_worker_affinity)) {
+    int cpu = 0;
+    if (!absl::SimpleAtoi(cpu_str, &cpu) || cpu < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Invalid --vmla_worker_affinity CPU ID '" << cpu_str << "'";
+    }
+    options.workgroup_pool_options.worker_affinity.push_back(cpu);
+  }
+  options.kernel_max_threads = absl::GetFlag(FLAGS_vmla_kernel_max_threads);
+  ASSIGN_OR_RETURN(options.allocator_pool_options,
+                   GetHostBufferPoolOptionsFromFlags());
+  ASSIGN_OR_RETURN(options.executor_options, GetTaskExecutorOptionsFromFlags());
+
+  return VMLADriver::Create(std::move(options));
+}
 
 }  // namespace
 }  // namespace vmla
@@ -15,9 +15,12 @@
 #ifndef IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 #define IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 #include "iree/hal/allocator.h"
@@ -36,6 +39,20 @@ class Interface;
 
 class VMLAExecutable final : public Executable {
  public:
+  // VM state used to invoke entry points. Workgroups executing concurrently
+  // each need their own as the VMLA module state (including the interface
+  // used to pass in bindings) is not thread-safe.
+  struct InvocationState {
+    ~InvocationState();
+
+    // VM context containing the loaded executable module.
+    iree_vm_context_t* context = nullptr;
+    // ABI vmla.interface binding block.
+    Interface* interface = nullptr;
+    // Entry point inputs list of a single vmla.interface.
+    iree_vm_variant_list_t* interface_inputs = nullptr;
+  };
+
   static StatusOr<ref_ptr<VMLAExecutable>> Load(iree_vm_instance_t* instance,
                                                 iree_vm_module_t* vmla_module,
                                                 ExecutableSpec spec,
@@ -51,31 +68,38 @@ class VMLAExecutable final : public Executable {
     return spec_.executable_data;
   }
 
-  // VM context containing the loaded executable module.
-  iree_vm_context_t* context() const { return context_; }
-
   // Entry point functions in export order.
   absl::Span<const iree_vm_function_t> entry_functions() const {
     return absl::MakeConstSpan(entry_functions_);
   }
 
-  // ABI vmla.interface binding block.
-  Interface* interface() const { return interface_; }
+  // Acquires invocation state not in use by any other thread, creating a new
+  // context if all existing ones are in use. The state must be returned with
+  // ReleaseInvocationState when the caller is done invoking.
+  StatusOr<std::unique_ptr<InvocationState>> AcquireInvocationState();
 
-  // Entry point inputs list of a single vmla.interface.
-  iree_vm_variant_list_t* interface_inputs() const { return interface_inputs_; }
+  // Returns |state| to the executable for reuse by future invocations.
+  void ReleaseInvocationState(std::unique_ptr<InvocationState> state);
 
  private:
   Status Initialize(iree_vm_instance_t* instance,
                     iree_vm_module_t* vmla_module);
 
+  // Creates a new context with the executable module loaded.
+  StatusOr<std::unique_ptr<InvocationState>> CreateInvocationState();
+
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
 
-  iree_vm_context_t* context_ = nullptr;
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* vmla_module_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
   absl::InlinedVector<iree_vm_function_t, 4> entry_functions_;
-  Interface* interface_ = nullptr;
-  iree_vm_variant_list_t* interface_inputs_ = nullptr;
+  iree_vm_function_t interface_current_function_;
+
+  absl::Mutex invocation_state_mutex_;
+  std::vector<std::unique_ptr<InvocationState>> free_invocation_states_
+      ABSL_GUARDED_BY(invocation_state_mutex_);
 };
 
 }  // namespace vmla
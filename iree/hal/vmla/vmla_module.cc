@@ -136,6 +136,8 @@ void Interface::Reset() {
       bindings_[i][j] = {};
     }
   }
+  thread_pool_ = nullptr;
+  thread_hint_ = 0;
 }
 
 StatusOr<uint32_t> Interface::GetConstant(uint32_t offset) const {
@@ -176,6 +178,34 @@ Status Interface::SetBinding(int32_t set, int32_t binding, Binding value) {
   return OkStatus();
 }
 
+StatusOr<uint32_t> Interface::GetWorkgroupID(int32_t dim) const {
+  if (dim < 0 || dim >= static_cast<int32_t>(workgroup_id_.size())) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Invalid workgroup dimension=" << dim;
+  }
+  return workgroup_id_[dim];
+}
+
+StatusOr<uint32_t> Interface::GetWorkgroupCount(int32_t dim) const {
+  if (dim < 0 || dim >= static_cast<int32_t>(workgroup_count_.size())) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Invalid workgroup dimension=" << dim;
+  }
+  return workgroup_count_[dim];
+}
+
+void Interface::SetWorkgroup(std::array<uint32_t, 3> workgroup_id,
+                             std::array<uint32_t, 3> workgroup_count) {
+  workgroup_id_ = workgroup_id;
+  workgroup_count_ = workgroup_count;
+}
+
+void Interface::SetThreadPool(kernels::MatMulThreadPool* thread_pool,
+                              int thread_hint) {
+  thread_pool_ = thread_pool;
+  thread_hint_ = thread_hint;
+}
+
 //===----------------------------------------------------------------------===//
 // Module state and method implementation
 //===----------------------------------------------------------------------===//
@@ -190,11 +220,8 @@ namespace {
 // Thread-compatible.
 class VMLAModuleState final {
  public:
-  VMLAModuleState(iree_allocator_t allocator,
-                  kernels::RuntimeState* kernel_state)
-      : allocator_(allocator),
-        interface_(vm::assign_ref(new Interface())),
-        kernel_state_(kernel_state) {}
+  explicit VMLAModuleState(iree_allocator_t allocator)
+      : allocator_(allocator), interface_(vm::assign_ref(new Interface())) {}
 
   ~VMLAModuleState() = default;
 
@@ -219,6 +246,18 @@ class VMLAModuleState final {
     return vm::retain_ref(value.buffer);
   }
 
+  StatusOr<uint32_t> InterfaceWorkgroupID(vm::ref<Interface> interface,
+                                          int32_t dim) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::InterfaceWorkgroupID");
+    return interface->GetWorkgroupID(dim);
+  }
+
+  StatusOr<uint32_t> InterfaceWorkgroupCount(vm::ref<Interface> interface,
+                                             int32_t dim) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::InterfaceWorkgroupCount");
+    return interface->GetWorkgroupCount(dim);
+  }
+
   //===--------------------------------------------------------------------===//
   // vmla.buffer.*
   //===--------------------------------------------------------------------===//
@@ -534,22 +573,32 @@ class VMLAModuleState final {
   IREE_VMLA_BINARY_OP(AddI16, kernels::Add, int16_t);
   IREE_VMLA_BINARY_OP(AddI32, kernels::Add, int32_t);
   IREE_VMLA_BINARY_OP(AddF32, kernels::Add, float);
+  IREE_VMLA_BINARY_OP(AddF16, kernels::Add, kernels::Half);
+  IREE_VMLA_BINARY_OP(AddBF16, kernels::Add, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(SubI8, kernels::Sub, int8_t);
   IREE_VMLA_BINARY_OP(SubI16, kernels::Sub, int16_t);
   IREE_VMLA_BINARY_OP(SubI32, kernels::Sub, int32_t);
   IREE_VMLA_BINARY_OP(SubF32, kernels::Sub, float);
+  IREE_VMLA_BINARY_OP(SubF16, kernels::Sub, kernels::Half);
+  IREE_VMLA_BINARY_OP(SubBF16, kernels::Sub, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(AbsI8, kernels::Abs, int8_t);
   IREE_VMLA_UNARY_OP(AbsI16, kernels::Abs, int16_t);
   IREE_VMLA_UNARY_OP(AbsI32, kernels::Abs, int32_t);
   IREE_VMLA_UNARY_OP(AbsF32, kernels::Abs, float);
+  IREE_VMLA_UNARY_OP(AbsF16, kernels::Abs, kernels::Half);
+  IREE_VMLA_UNARY_OP(AbsBF16, kernels::Abs, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(NegI8, kernels::Neg, int8_t);
   IREE_VMLA_UNARY_OP(NegI16, kernels::Neg, int16_t);
   IREE_VMLA_UNARY_OP(NegI32, kernels::Neg, int32_t);
   IREE_VMLA_UNARY_OP(NegF32, kernels::Neg, float);
+  IREE_VMLA_UNARY_OP(NegF16, kernels::Neg, kernels::Half);
+  IREE_VMLA_UNARY_OP(NegBF16, kernels::Neg, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(MulI8, kernels::Mul, int8_t);
   IREE_VMLA_BINARY_OP(MulI16, kernels::Mul, int16_t);
   IREE_VMLA_BINARY_OP(MulI32, kernels::Mul, int32_t);
   IREE_VMLA_BINARY_OP(MulF32, kernels::Mul, float);
+  IREE_VMLA_BINARY_OP(MulF16, kernels::Mul, kernels::Half);
+  IREE_VMLA_BINARY_OP(MulBF16, kernels::Mul, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(DivI8, kernels::Div, int8_t);
   IREE_VMLA_BINARY_OP(DivI16, kernels::Div, int16_t);
   IREE_VMLA_BINARY_OP(DivI32, kernels::Div, int32_t);
@@ -557,6 +606,8 @@ class VMLAModuleState final {
   IREE_VMLA_BINARY_OP(DivU16, kernels::Div, uint16_t);
   IREE_VMLA_BINARY_OP(DivU32, kernels::Div, uint32_t);
   IREE_VMLA_BINARY_OP(DivF32, kernels::Div, float);
+  IREE_VMLA_BINARY_OP(DivF16, kernels::Div, kernels::Half);
+  IREE_VMLA_BINARY_OP(DivBF16, kernels::Div, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(RemI8, kernels::Rem, int8_t);
   IREE_VMLA_BINARY_OP(RemI16, kernels::Rem, int16_t);
   IREE_VMLA_BINARY_OP(RemI32, kernels::Rem, int32_t);
@@ -566,28 +617,46 @@ class VMLAModuleState final {
   IREE_VMLA_BINARY_OP(RemF32, kernels::Rem, float);
   IREE_VMLA_BINARY_OP(PowF32, kernels::Pow, float);
   IREE_VMLA_UNARY_OP(ExpF32, kernels::Exp, float);
+  IREE_VMLA_UNARY_OP(ExpF16, kernels::Exp, kernels::Half);
+  IREE_VMLA_UNARY_OP(ExpBF16, kernels::Exp, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(LogF32, kernels::Log, float);
+  IREE_VMLA_UNARY_OP(LogF16, kernels::Log, kernels::Half);
+  IREE_VMLA_UNARY_OP(LogBF16, kernels::Log, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(RsqrtF32, kernels::Rsqrt, float);
+  IREE_VMLA_UNARY_OP(RsqrtF16, kernels::Rsqrt, kernels::Half);
+  IREE_VMLA_UNARY_OP(RsqrtBF16, kernels::Rsqrt, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(SqrtF32, kernels::Sqrt, float);
+  IREE_VMLA_UNARY_OP(SqrtF16, kernels::Sqrt, kernels::Half);
+  IREE_VMLA_UNARY_OP(SqrtBF16, kernels::Sqrt, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(CosF32, kernels::Cos, float);
   IREE_VMLA_UNARY_OP(SinF32, kernels::Sin, float);
   IREE_VMLA_UNARY_OP(TanhF32, kernels::Tanh, float);
+  IREE_VMLA_UNARY_OP(TanhF16, kernels::Tanh, kernels::Half);
+  IREE_VMLA_UNARY_OP(TanhBF16, kernels::Tanh, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(Atan2F32, kernels::Atan2, float);
 
   IREE_VMLA_BINARY_OP(MinI8, kernels::Min, int8_t);
   IREE_VMLA_BINARY_OP(MinI16, kernels::Min, int16_t);
   IREE_VMLA_BINARY_OP(MinI32, kernels::Min, int32_t);
   IREE_VMLA_BINARY_OP(MinF32, kernels::Min, float);
+  IREE_VMLA_BINARY_OP(MinF16, kernels::Min, kernels::Half);
+  IREE_VMLA_BINARY_OP(MinBF16, kernels::Min, kernels::BFloat16);
   IREE_VMLA_BINARY_OP(MaxI8, kernels::Max, int8_t);
   IREE_VMLA_BINARY_OP(MaxI16, kernels::Max, int16_t);
   IREE_VMLA_BINARY_OP(MaxI32, kernels::Max, int32_t);
   IREE_VMLA_BINARY_OP(MaxF32, kernels::Max, float);
+  IREE_VMLA_BINARY_OP(MaxF16, kernels::Max, kernels::Half);
+  IREE_VMLA_BINARY_OP(MaxBF16, kernels::Max, kernels::BFloat16);
   IREE_VMLA_TERNARY_OP(ClampI8, kernels::Clamp, int8_t);
   IREE_VMLA_TERNARY_OP(ClampI16, kernels::Clamp, int16_t);
   IREE_VMLA_TERNARY_OP(ClampI32, kernels::Clamp, int32_t);
   IREE_VMLA_TERNARY_OP(ClampF32, kernels::Clamp, float);
   IREE_VMLA_UNARY_OP(FloorF32, kernels::Floor, float);
+  IREE_VMLA_UNARY_OP(FloorF16, kernels::Floor, kernels::Half);
+  IREE_VMLA_UNARY_OP(FloorBF16, kernels::Floor, kernels::BFloat16);
   IREE_VMLA_UNARY_OP(CeilF32, kernels::Ceil, float);
+  IREE_VMLA_UNARY_OP(CeilF16, kernels::Ceil, kernels::Half);
+  IREE_VMLA_UNARY_OP(CeilBF16, kernels::Ceil, kernels::BFloat16);
 
   //===--------------------------------------------------------------------===//
   // VMLA Ops: conversion
@@ -611,6 +680,10 @@ class VMLAModuleState final {
   IREE_VMLA_CONVERSION_OP(ConvertF32I8, float, int8_t);
   IREE_VMLA_CONVERSION_OP(ConvertF32I16, float, int16_t);
   IREE_VMLA_CONVERSION_OP(ConvertF32I32, float, int32_t);
+  IREE_VMLA_CONVERSION_OP(ConvertF16F32, kernels::Half, float);
+  IREE_VMLA_CONVERSION_OP(ConvertF32F16, float, kernels::Half);
+  IREE_VMLA_CONVERSION_OP(ConvertBF16F32, kernels::BFloat16, float);
+  IREE_VMLA_CONVERSION_OP(ConvertF32BF16, float, kernels::BFloat16);
 
   //===--------------------------------------------------------------------===//
   // VMLA Ops: Convolution
@@ -626,42 +699,93 @@ class VMLAModuleState final {
                        const int32_t feature_group_count,
                        const int32_t batch_group_count) {
     IREE_TRACE_SCOPE0("VMLAModuleState::ConvF32F32F32");
-    if (input_shape.size() != 4 || filter_shape.size() != 4 ||
-        dst_shape.size() != 4) {
-      return InvalidArgumentErrorBuilder(IREE_LOC)
-             << "Expecting 4-d tensors for Conv2D kernel";
-    }
-    // 2D conv
-    const int32_t batch_size = input_shape[0];
-    const Shape input_example_shape{input_shape[1], input_shape[2],
-                                    input_shape[3]};
-    const Shape output_example_shape{dst_shape[1], dst_shape[2], dst_shape[3]};
-    const Shape filter_shape_4d(filter_shape.data(), 4);
-    const Shape dilation(lhs_dilation.data(), 2);
-    const Shape pad_h(padding.data(), 2);
-    const Shape pad_w(padding.subspan(2).data(), 2);
-    const Shape window_strides_2d(window_strides.data(), 2);
+    return Conv(std::move(input), input_shape, std::move(filter), filter_shape,
+                std::move(dst), dst_shape, window_strides, padding,
+                rhs_dilation, feature_group_count,
+                kernels::Conv2D::Quantization<float, float, float>());
+  }
 
-    const float* raw_inputs_data = input->As<float>().data();
-    const float* raw_filter_data = filter->As<float>().data();
-    float* raw_dst_data = dst->As<float>().data();
-    auto filter_buffer =
-        absl::MakeConstSpan(raw_filter_data, filter_shape_4d.element_count());
+  Status ConvF16F16F16(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+                       vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
+                       vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+                       absl::Span<const int32_t> window_strides,
+                       absl::Span<const int32_t> padding,
+                       absl::Span<const int32_t> lhs_dilation,
+                       absl::Span<const int32_t> rhs_dilation,
+                       const int32_t feature_group_count,
+                       const int32_t batch_group_count) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ConvF16F16F16");
+    return Conv(
+        std::move(input), input_shape, std::move(filter), filter_shape,
+        std::move(dst), dst_shape, window_strides, padding, rhs_dilation,
+        feature_group_count,
+        kernels::Conv2D::Quantization<kernels::Half, float, kernels::Half>());
+  }
 
-    const int input_stride = input_example_shape.element_count();
-    const int output_stride = output_example_shape.element_count();
+  Status ConvBF16BF16BF16(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+                          vm::ref<Buffer> filter,
+                          iree_vmla_shape_t filter_shape, vm::ref<Buffer> dst,
+                          iree_vmla_shape_t dst_shape,
+                          absl::Span<const int32_t> window_strides,
+                          absl::Span<const int32_t> padding,
+                          absl::Span<const int32_t> lhs_dilation,
+                          absl::Span<const int32_t> rhs_dilation,
+                          const int32_t feature_group_count,
+                          const int32_t batch_group_count) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ConvBF16BF16BF16");
+    return Conv(std::move(input), input_shape, std::move(filter), filter_shape,
+                std::move(dst), dst_shape, window_strides, padding,
+                rhs_dilation, feature_group_count,
+                kernels::Conv2D::Quantization<kernels::BFloat16, float,
+                                              kernels::BFloat16>());
+  }
 
-    for (int i = 0; i < batch_size; ++i) {
-      auto input_example =
-          absl::MakeConstSpan(raw_inputs_data + i * input_stride, input_stride);
-      auto output_example =
-          absl::MakeSpan(raw_dst_data + i * output_stride, output_stride);
-      RETURN_IF_ERROR(kernels::Conv2D::Execute(
-          input_example, input_example_shape, filter_buffer, filter_shape_4d,
-          output_example, output_example_shape, window_strides_2d, pad_h, pad_w,
-          dilation, feature_group_count));
+  Status ConvI8I8I32(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+                     int32_t input_zero_point, vm::ref<Buffer> filter,
+                     iree_vmla_shape_t filter_shape, int32_t filter_zero_point,
+                     vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+                     absl::Span<const int32_t> window_strides,
+                     absl::Span<const int32_t> padding,
+                     absl::Span<const int32_t> lhs_dilation,
+                     absl::Span<const int32_t> rhs_dilation,
+                     const int32_t feature_group_count,
+                     const int32_t batch_group_count) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ConvI8I8I32");
+    kernels::Conv2D::Quantization<int8_t, int32_t, int32_t> quantization;
+    quantization.input_zero_point = static_cast<int8_t>(input_zero_point);
+    quantization.filter_zero_point = static_cast<int8_t>(filter_zero_point);
+    return Conv(std::move(input), input_shape, std::move(filter), filter_shape,
+                std::move(dst), dst_shape, window_strides, padding,
+                rhs_dilation, feature_group_count, quantization);
+  }
+
+  Status ConvRequantI8I8I8(
+      vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+      int32_t input_zero_point, vm::ref<Buffer> filter,
+      iree_vmla_shape_t filter_shape, int32_t filter_zero_point,
+      vm::ref<Buffer> multiplier_mantissa, vm::ref<Buffer> multiplier_exponent,
+      vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape, int32_t dst_zero_point,
+      absl::Span<const int32_t> window_strides,
+      absl::Span<const int32_t> padding,
+      absl::Span<const int32_t> lhs_dilation,
+      absl::Span<const int32_t> rhs_dilation,
+      const int32_t feature_group_count, const int32_t batch_group_count) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::ConvRequantI8I8I8");
+    if (dst_shape.size() != 4) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Expecting 4-d tensors for Conv2D kernel";
     }
-    return OkStatus();
+    kernels::Conv2D::Quantization<int8_t, int32_t, int8_t> quantization;
+    quantization.input_zero_point = static_cast<int8_t>(input_zero_point);
+    quantization.filter_zero_point = static_cast<int8_t>(filter_zero_point);
+    quantization.dst_zero_point = static_cast<int8_t>(dst_zero_point);
+    RETURN_IF_ERROR(GetMultipliers(multiplier_mantissa, multiplier_exponent,
+                                   /*channel_count=*/dst_shape[3],
+                                   &quantization.multiplier_mantissa_buffer,
+                                   &quantization.multiplier_exponent_buffer));
+    return Conv(std::move(input), input_shape, std::move(filter), filter_shape,
+                std::move(dst), dst_shape, window_strides, padding,
+                rhs_dilation, feature_group_count, quantization);
   }
 
   //===--------------------------------------------------------------------===//
@@ -673,48 +797,65 @@ class VMLAModuleState final {
                               vm::ref<Buffer> dst,
                               iree_vmla_shape_t dst_shape) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BatchMatMulF32F32F32");
-    // Compiler guarantees. Here for documentation purposes.
-    assert(lhs_shape.size() == 3 && rhs_shape.size() == 3 &&
-           dst_shape.size() == 3);
-    assert(lhs_shape[0] == rhs_shape[0] && rhs_shape[0] == dst_shape[0]);
+    return BatchMatMul(std::move(lhs), lhs_shape, std::move(rhs), rhs_shape,
+                       std::move(dst), dst_shape,
+                       kernels::MatMul::Buffers<float, float, float>());
+  }
 
-    auto total_elements = [](absl::Span<const int32_t> extents) {
-      int32_t result = 1;
-      for (int32_t extent : extents) {
-        result *= extent;
-      }
-      return result;
-    };
+  Status BatchMatMulF16F16F16(vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape,
+                              vm::ref<Buffer> rhs, iree_vmla_shape_t rhs_shape,
+                              vm::ref<Buffer> dst,
+                              iree_vmla_shape_t dst_shape) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::BatchMatMulF16F16F16");
+    return BatchMatMul(
+        std::move(lhs), lhs_shape, std::move(rhs), rhs_shape, std::move(dst),
+        dst_shape,
+        kernels::MatMul::Buffers<kernels::Half, float, kernels::Half>());
+  }
 
-    iree_vmla_shape_t lhs_batch_element_shape = lhs_shape.subspan(1);
-    iree_vmla_shape_t rhs_batch_element_shape = rhs_shape.subspan(1);
-    iree_vmla_shape_t dst_batch_element_shape = dst_shape.subspan(1);
-    Shape lhs_batch_element_shape2(lhs_batch_element_shape.data(), 2);
-    Shape rhs_batch_element_shape2(rhs_batch_element_shape.data(), 2);
-    Shape dst_batch_element_shape2(dst_batch_element_shape.data(), 2);
-    int32_t lhs_batch_stride = total_elements(lhs_batch_element_shape);
-    int32_t rhs_batch_stride = total_elements(rhs_batch_element_shape);
-    int32_t dst_batch_stride = total_elements(dst_batch_element_shape);
-    float* lhs_batch_base = lhs->As<float>().data();
-    float* rhs_batch_base = rhs->As<float>().data();
-    float* dst_batch_base = dst->As<float>().data();
-    int32_t batch_dim = lhs_shape[0];
-    for (int i = 0; i < batch_dim; i++) {
-      kernels::MatMul::Buffers<float, float> buffers;
-      buffers.lhs_buffer = absl::MakeSpan(lhs_batch_base + i * lhs_batch_stride,
-                                          lhs_batch_stride);
-      buffers.lhs_shape = lhs_batch_element_shape2;
-      buffers.rhs_buffer = absl::MakeSpan(rhs_batch_base + i * rhs_batch_stride,
-                                          rhs_batch_stride);
-      buffers.rhs_shape = rhs_batch_element_shape2;
-      buffers.dst_buffer = absl::MakeSpan(dst_batch_base + i * dst_batch_stride,
-                                          dst_batch_stride);
-      buffers.dst_shape = dst_batch_element_shape2;
-
-      RETURN_IF_ERROR(kernels::MatMul::Execute(
-          kernel_state_->mat_mul_state.get(), buffers));
-    }
-    return OkStatus();
+  Status BatchMatMulBF16BF16BF16(vm::ref<Buffer> lhs,
+                                 iree_vmla_shape_t lhs_shape,
+                                 vm::ref<Buffer> rhs,
+                                 iree_vmla_shape_t rhs_shape,
+                                 vm::ref<Buffer> dst,
+                                 iree_vmla_shape_t dst_shape) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::BatchMatMulBF16BF16BF16");
+    return BatchMatMul(std::move(lhs), lhs_shape, std::move(rhs), rhs_shape,
+                       std::move(dst), dst_shape,
+                       kernels::MatMul::Buffers<kernels::BFloat16, float,
+                                                kernels::BFloat16>());
+  }
+
+  Status BatchMatMulI8I8I32(vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape,
+                            int32_t lhs_zero_point, vm::ref<Buffer> rhs,
+                            iree_vmla_shape_t rhs_shape, int32_t rhs_zero_point,
+                            vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::BatchMatMulI8I8I32");
+    kernels::MatMul::Buffers<int8_t, int32_t, int32_t> params;
+    params.lhs_zero_point = static_cast<int8_t>(lhs_zero_point);
+    params.rhs_zero_point = static_cast<int8_t>(rhs_zero_point);
+    return BatchMatMul(std::move(lhs), lhs_shape, std::move(rhs), rhs_shape,
+                       std::move(dst), dst_shape, params);
+  }
+
+  Status BatchMatMulRequantI8I8I8(
+      vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape, int32_t lhs_zero_point,
+      vm::ref<Buffer> rhs, iree_vmla_shape_t rhs_shape, int32_t rhs_zero_point,
+      vm::ref<Buffer> multiplier_mantissa, vm::ref<Buffer> multiplier_exponent,
+      vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+      int32_t dst_zero_point) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::BatchMatMulRequantI8I8I8");
+    // Per-channel multipliers are per row of the lhs (dst is [batch, N, M]).
+    kernels::MatMul::Buffers<int8_t, int32_t, int8_t> params;
+    params.lhs_zero_point = static_cast<int8_t>(lhs_zero_point);
+    params.rhs_zero_point = static_cast<int8_t>(rhs_zero_point);
+    params.dst_zero_point = static_cast<int8_t>(dst_zero_point);
+    RETURN_IF_ERROR(GetMultipliers(multiplier_mantissa, multiplier_exponent,
+                                   /*channel_count=*/lhs_shape[1],
+                                   &params.multiplier_mantissa_buffer,
+                                   &params.multiplier_exponent_buffer));
+    return BatchMatMul(std::move(lhs), lhs_shape, std::move(rhs), rhs_shape,
+                       std::move(dst), dst_shape, params);
   }
 
   //===--------------------------------------------------------------------===//
@@ -770,17 +911,145 @@ class VMLAModuleState final {
   IREE_VMLA_POOLING_OP(PoolingMaxF32, kernels::PoolingMax, float);
 
  private:
+  // Returns the MatMul state using the thread pool of the device executing
+  // the current invocation, as set on the interface by the command processor.
+  kernels::MatMul::RuntimeState* mat_mul_state() {
+    auto* state = kernel_state_.mat_mul_state.get();
+    state->thread_pool = interface_->thread_pool();
+    state->thread_hint = interface_->thread_hint();
+    return state;
+  }
+
+  // Gets the contents of the requantization multiplier mantissa and exponent
+  // buffers, which must both have either a single value or one per output
+  // |channel_count|.
+  Status GetMultipliers(const vm::ref<Buffer>& mantissa_buffer,
+                        const vm::ref<Buffer>& exponent_buffer,
+                        int32_t channel_count,
+                        absl::Span<const int32_t>* out_mantissas,
+                        absl::Span<const int32_t>* out_exponents) {
+    auto mantissas = mantissa_buffer->As<int32_t>();
+    auto exponents = exponent_buffer->As<int32_t>();
+    if (mantissas.size() != exponents.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Requantization multiplier mantissa count " << mantissas.size()
+             << " does not match exponent count " << exponents.size();
+    }
+    if (mantissas.size() != 1 &&
+        mantissas.size() != static_cast<size_t>(channel_count)) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Expected 1 or " << channel_count
+             << " requantization multipliers but have " << mantissas.size();
+    }
+    *out_mantissas = mantissas;
+    *out_exponents = exponents;
+    return OkStatus();
+  }
+
+  // Convolves each example of the batch with the zero points and
+  // requantization from |quantization|.
+  template <typename T, typename ACC, typename DST>
+  Status Conv(vm::ref<Buffer> input, iree_vmla_shape_t input_shape,
+              vm::ref<Buffer> filter, iree_vmla_shape_t filter_shape,
+              vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+              absl::Span<const int32_t> window_strides,
+              absl::Span<const int32_t> padding,
+              absl::Span<const int32_t> rhs_dilation,
+              const int32_t feature_group_count,
+              const kernels::Conv2D::Quantization<T, ACC, DST>& quantization) {
+    if (input_shape.size() != 4 || filter_shape.size() != 4 ||
+        dst_shape.size() != 4) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Expecting 4-d tensors for Conv2D kernel";
+    }
+    // 2D conv
+    const int32_t batch_size = input_shape[0];
+    const Shape input_example_shape{input_shape[1], input_shape[2],
+                                    input_shape[3]};
+    const Shape output_example_shape{dst_shape[1], dst_shape[2], dst_shape[3]};
+    const Shape filter_shape_4d(filter_shape.data(), 4);
+    const Shape dilation(rhs_dilation.data(), 2);
+    const Shape pad_h(padding.data(), 2);
+    const Shape pad_w(padding.subspan(2).data(), 2);
+    const Shape window_strides_2d(window_strides.data(), 2);
+
+    const T* raw_inputs_data = input->As<T>().data();
+    const T* raw_filter_data = filter->As<T>().data();
+    DST* raw_dst_data = dst->As<DST>().data();
+    auto filter_buffer =
+        absl::MakeConstSpan(raw_filter_data, filter_shape_4d.element_count());
+
+    const int input_stride = input_example_shape.element_count();
+    const int output_stride = output_example_shape.element_count();
+
+    for (int i = 0; i < batch_size; ++i) {
+      auto input_example =
+          absl::MakeConstSpan(raw_inputs_data + i * input_stride, input_stride);
+      auto output_example =
+          absl::MakeSpan(raw_dst_data + i * output_stride, output_stride);
+      RETURN_IF_ERROR(kernels::Conv2D::Execute(
+          mat_mul_state(), input_example, input_example_shape, filter_buffer,
+          filter_shape_4d, output_example, output_example_shape,
+          window_strides_2d, pad_h, pad_w, dilation, feature_group_count,
+          quantization));
+    }
+    return OkStatus();
+  }
+
+  // Multiplies each batch element with the zero points and requantization
+  // from |params|; its buffers and shapes are populated per batch element.
+  template <typename T, typename ACC, typename DST>
+  Status BatchMatMul(vm::ref<Buffer> lhs, iree_vmla_shape_t lhs_shape,
+                     vm::ref<Buffer> rhs, iree_vmla_shape_t rhs_shape,
+                     vm::ref<Buffer> dst, iree_vmla_shape_t dst_shape,
+                     kernels::MatMul::Buffers<T, ACC, DST> params) {
+    // Compiler guarantees. Here for documentation purposes.
+    assert(lhs_shape.size() == 3 && rhs_shape.size() == 3 &&
+           dst_shape.size() == 3);
+    assert(lhs_shape[0] == rhs_shape[0] && rhs_shape[0] == dst_shape[0]);
+
+    auto total_elements = [](absl::Span<const int32_t> extents) {
+      int32_t result = 1;
+      for (int32_t extent : extents) {
+        result *= extent;
+      }
+      return result;
+    };
+
+    iree_vmla_shape_t lhs_batch_element_shape = lhs_shape.subspan(1);
+    iree_vmla_shape_t rhs_batch_element_shape = rhs_shape.subspan(1);
+    iree_vmla_shape_t dst_batch_element_shape = dst_shape.subspan(1);
+    params.lhs_shape = Shape(lhs_batch_element_shape.data(), 2);
+    params.rhs_shape = Shape(rhs_batch_element_shape.data(), 2);
+    params.dst_shape = Shape(dst_batch_element_shape.data(), 2);
+    int32_t lhs_batch_stride = total_elements(lhs_batch_element_shape);
+    int32_t rhs_batch_stride = total_elements(rhs_batch_element_shape);
+    int32_t dst_batch_stride = total_elements(dst_batch_element_shape);
+    T* lhs_batch_base = lhs->As<T>().data();
+    T* rhs_batch_base = rhs->As<T>().data();
+    DST* dst_batch_base = dst->As<DST>().data();
+    int32_t batch_dim = lhs_shape[0];
+    for (int i = 0; i < batch_dim; i++) {
+      params.lhs_buffer = absl::MakeSpan(lhs_batch_base + i * lhs_batch_stride,
+                                         lhs_batch_stride);
+      params.rhs_buffer = absl::MakeSpan(rhs_batch_base + i * rhs_batch_stride,
+                                         rhs_batch_stride);
+      params.dst_buffer = absl::MakeSpan(dst_batch_base + i * dst_batch_stride,
+                                         dst_batch_stride);
+      RETURN_IF_ERROR(kernels::MatMul::Execute(mat_mul_state(), params));
+    }
+    return OkStatus();
+  }
+
   iree_allocator_t allocator_;
 
   // Shared interface that the command processor uses to pass bindings in during
   // execution.
   vm::ref<Interface> interface_;
 
-  // NOTE: kernel state must be externally synchronized as it is shared across
-  // all contexts using the VMLA module. This is fine in our current design as
-  // we only ever execute a single context at a time but if we start to allow
-  // concurrency across contexts we'll need to introduce locks.
-  kernels::RuntimeState* kernel_state_ = nullptr;
+  // Kernel state is owned per-context so that workgroups executing
+  // concurrently in different contexts never share it.
+  kernels::RuntimeState kernel_state_;
 };
 
 //===----------------------------------------------------------------------===//
@@ -793,6 +1062,10 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("interface.const", &VMLAModuleState::InterfaceConst),
     vm::MakeNativeFunction("interface.binding",
                            &VMLAModuleState::InterfaceBinding),
+    vm::MakeNativeFunction("interface.workgroup_id",
+                           &VMLAModuleState::InterfaceWorkgroupID),
+    vm::MakeNativeFunction("interface.workgroup_count",
+                           &VMLAModuleState::InterfaceWorkgroupCount),
 
     vm::MakeNativeFunction("buffer.const", &VMLAModuleState::BufferConst),
     vm::MakeNativeFunction("buffer.alloc", &VMLAModuleState::BufferAlloc),
@@ -855,22 +1128,32 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("add.i16", &VMLAModuleState::AddI16),
     vm::MakeNativeFunction("add.i32", &VMLAModuleState::AddI32),
     vm::MakeNativeFunction("add.f32", &VMLAModuleState::AddF32),
+    vm::MakeNativeFunction("add.f16", &VMLAModuleState::AddF16),
+    vm::MakeNativeFunction("add.bf16", &VMLAModuleState::AddBF16),
     vm::MakeNativeFunction("sub.i8", &VMLAModuleState::SubI8),
     vm::MakeNativeFunction("sub.i16", &VMLAModuleState::SubI16),
     vm::MakeNativeFunction("sub.i32", &VMLAModuleState::SubI32),
     vm::MakeNativeFunction("sub.f32", &VMLAModuleState::SubF32),
+    vm::MakeNativeFunction("sub.f16", &VMLAModuleState::SubF16),
+    vm::MakeNativeFunction("sub.bf16", &VMLAModuleState::SubBF16),
     vm::MakeNativeFunction("abs.i8", &VMLAModuleState::AbsI8),
     vm::MakeNativeFunction("abs.i16", &VMLAModuleState::AbsI16),
     vm::MakeNativeFunction("abs.i32", &VMLAModuleState::AbsI32),
     vm::MakeNativeFunction("abs.f32", &VMLAModuleState::AbsF32),
+    vm::MakeNativeFunction("abs.f16", &VMLAModuleState::AbsF16),
+    vm::MakeNativeFunction("abs.bf16", &VMLAModuleState::AbsBF16),
     vm::MakeNativeFunction("neg.i8", &VMLAModuleState::NegI8),
     vm::MakeNativeFunction("neg.i16", &VMLAModuleState::NegI16),
     vm::MakeNativeFunction("neg.i32", &VMLAModuleState::NegI32),
     vm::MakeNativeFunction("neg.f32", &VMLAModuleState::NegF32),
+    vm::MakeNativeFunction("neg.f16", &VMLAModuleState::NegF16),
+    vm::MakeNativeFunction("neg.bf16", &VMLAModuleState::NegBF16),
     vm::MakeNativeFunction("mul.i8", &VMLAModuleState::MulI8),
     vm::MakeNativeFunction("mul.i16", &VMLAModuleState::MulI16),
     vm::MakeNativeFunction("mul.i32", &VMLAModuleState::MulI32),
     vm::MakeNativeFunction("mul.f32", &VMLAModuleState::MulF32),
+    vm::MakeNativeFunction("mul.f16", &VMLAModuleState::MulF16),
+    vm::MakeNativeFunction("mul.bf16", &VMLAModuleState::MulBF16),
     vm::MakeNativeFunction("div.i8", &VMLAModuleState::DivI8),
     vm::MakeNativeFunction("div.i16", &VMLAModuleState::DivI16),
     vm::MakeNativeFunction("div.i32", &VMLAModuleState::DivI32),
@@ -878,6 +1161,8 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("div.u16", &VMLAModuleState::DivU16),
     vm::MakeNativeFunction("div.u32", &VMLAModuleState::DivU32),
     vm::MakeNativeFunction("div.f32", &VMLAModuleState::DivF32),
+    vm::MakeNativeFunction("div.f16", &VMLAModuleState::DivF16),
+    vm::MakeNativeFunction("div.bf16", &VMLAModuleState::DivBF16),
     vm::MakeNativeFunction("rem.i8", &VMLAModuleState::RemI8),
     vm::MakeNativeFunction("rem.i16", &VMLAModuleState::RemI16),
     vm::MakeNativeFunction("rem.i32", &VMLAModuleState::RemI32),
@@ -887,24 +1172,42 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("rem.f32", &VMLAModuleState::RemF32),
     vm::MakeNativeFunction("pow.f32", &VMLAModuleState::PowF32),
     vm::MakeNativeFunction("exp.f32", &VMLAModuleState::ExpF32),
+    vm::MakeNativeFunction("exp.f16", &VMLAModuleState::ExpF16),
+    vm::MakeNativeFunction("exp.bf16", &VMLAModuleState::ExpBF16),
     vm::MakeNativeFunction("log.f32", &VMLAModuleState::LogF32),
+    vm::MakeNativeFunction("log.f16", &VMLAModuleState::LogF16),
+    vm::MakeNativeFunction("log.bf16", &VMLAModuleState::LogBF16),
     vm::MakeNativeFunction("rsqrt.f32", &VMLAModuleState::RsqrtF32),
+    vm::MakeNativeFunction("rsqrt.f16", &VMLAModuleState::RsqrtF16),
+    vm::MakeNativeFunction("rsqrt.bf16", &VMLAModuleState::RsqrtBF16),
     vm::MakeNativeFunction("sqrt.f32", &VMLAModuleState::SqrtF32),
+    vm::MakeNativeFunction("sqrt.f16", &VMLAModuleState::SqrtF16),
+    vm::MakeNativeFunction("sqrt.bf16", &VMLAModuleState::SqrtBF16),
     vm::MakeNativeFunction("cos.f32", &VMLAModuleState::CosF32),
     vm::MakeNativeFunction("sin.f32", &VMLAModuleState::SinF32),
     vm::MakeNativeFunction("tanh.f32", &VMLAModuleState::TanhF32),
+    vm::MakeNativeFunction("tanh.f16", &VMLAModuleState::TanhF16),
+    vm::MakeNativeFunction("tanh.bf16", &VMLAModuleState::TanhBF16),
     vm::MakeNativeFunction("atan2.f32", &VMLAModuleState::Atan2F32),
 
     vm::MakeNativeFunction("min.i8", &VMLAModuleState::MinI8),
     vm::MakeNativeFunction("min.i16", &VMLAModuleState::MinI16),
     vm::MakeNativeFunction("min.i32", &VMLAModuleState::MinI32),
     vm::MakeNativeFunction("min.f32", &VMLAModuleState::MinF32),
+    vm::MakeNativeFunction("min.f16", &VMLAModuleState::MinF16),
+    vm::MakeNativeFunction("min.bf16", &VMLAModuleState::MinBF16),
     vm::MakeNativeFunction("max.i8", &VMLAModuleState::MaxI8),
     vm::MakeNativeFunction("max.i16", &VMLAModuleState::MaxI16),
     vm::MakeNativeFunction("max.i32", &VMLAModuleState::MaxI32),
     vm::MakeNativeFunction("max.f32", &VMLAModuleState::MaxF32),
+    vm::MakeNativeFunction("max.f16", &VMLAModuleState::MaxF16),
+    vm::MakeNativeFunction("max.bf16", &VMLAModuleState::MaxBF16),
     vm::MakeNativeFunction("floor.f32", &VMLAModuleState::FloorF32),
+    vm::MakeNativeFunction("floor.f16", &VMLAModuleState::FloorF16),
+    vm::MakeNativeFunction("floor.bf16", &VMLAModuleState::FloorBF16),
     vm::MakeNativeFunction("ceil.f32", &VMLAModuleState::CeilF32),
+    vm::MakeNativeFunction("ceil.f16", &VMLAModuleState::CeilF16),
+    vm::MakeNativeFunction("ceil.bf16", &VMLAModuleState::CeilBF16),
 
     vm::MakeNativeFunction("convert.i8.i16", &VMLAModuleState::ConvertI8I16),
     vm::MakeNativeFunction("convert.i8.i32", &VMLAModuleState::ConvertI8I32),
@@ -918,6 +1221,12 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("convert.f32.i8", &VMLAModuleState::ConvertF32I8),
     vm::MakeNativeFunction("convert.f32.i16", &VMLAModuleState::ConvertF32I16),
     vm::MakeNativeFunction("convert.f32.i32", &VMLAModuleState::ConvertF32I32),
+    vm::MakeNativeFunction("convert.f16.f32", &VMLAModuleState::ConvertF16F32),
+    vm::MakeNativeFunction("convert.f32.f16", &VMLAModuleState::ConvertF32F16),
+    vm::MakeNativeFunction("convert.bf16.f32",
+                           &VMLAModuleState::ConvertBF16F32),
+    vm::MakeNativeFunction("convert.f32.bf16",
+                           &VMLAModuleState::ConvertF32BF16),
 
     vm::MakeNativeFunction("reduce.sum.i8", &VMLAModuleState::ReduceSumI8),
     vm::MakeNativeFunction("reduce.sum.i16", &VMLAModuleState::ReduceSumI16),
@@ -947,8 +1256,22 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
 
     vm::MakeNativeFunction("batch.matmul.f32f32.f32",
                            &VMLAModuleState::BatchMatMulF32F32F32),
-
-    vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32)};
+    vm::MakeNativeFunction("batch.matmul.f16f16.f16",
+                           &VMLAModuleState::BatchMatMulF16F16F16),
+    vm::MakeNativeFunction("batch.matmul.bf16bf16.bf16",
+                           &VMLAModuleState::BatchMatMulBF16BF16BF16),
+    vm::MakeNativeFunction("batch.matmul.i8i8.i32",
+                           &VMLAModuleState::BatchMatMulI8I8I32),
+    vm::MakeNativeFunction("batch.matmul.requant.i8i8.i8",
+                           &VMLAModuleState::BatchMatMulRequantI8I8I8),
+
+    vm::MakeNativeFunction("conv.f32f32.f32", &VMLAModuleState::ConvF32F32F32),
+    vm::MakeNativeFunction("conv.f16f16.f16", &VMLAModuleState::ConvF16F16F16),
+    vm::MakeNativeFunction("conv.bf16bf16.bf16",
+                           &VMLAModuleState::ConvBF16BF16BF16),
+    vm::MakeNativeFunction("conv.i8i8.i32", &VMLAModuleState::ConvI8I8I32),
+    vm::MakeNativeFunction("conv.requant.i8i8.i8",
+                           &VMLAModuleState::ConvRequantI8I8I8)};
 
 // Per-device VMLA module.
 // One of these will be created per device and be shared across all executables
@@ -972,14 +1295,9 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
   StatusOr<std::unique_ptr<VMLAModuleState>> CreateState(
       iree_allocator_t allocator) override {
     IREE_TRACE_SCOPE0("VMLAModule::CreateState");
-    auto state = std::make_unique<VMLAModuleState>(allocator, &kernel_state_);
+    auto state = std::make_unique<VMLAModuleState>(allocator);
     return state;
   }
-
- private:
-  // NOTE: shared across all contexts with the VMLA module loaded. See
-  // VMLAModuleState::kernel_state_ for more information.
-  kernels::RuntimeState kernel_state_;
 };
 
 }  // namespace
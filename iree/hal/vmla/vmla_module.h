@@ -19,6 +19,7 @@
 #ifndef IREE_HAL_VMLA_VMLA_MODULE_H_
 #define IREE_HAL_VMLA_VMLA_MODULE_H_
 
+#include <array>
 #include <cstdint>
 
 #include "absl/types/span.h"
@@ -34,6 +35,10 @@ namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace kernels {
+class MatMulThreadPool;
+}  // namespace kernels
+
 using iree_vmla_size_t = uint32_t;
 using iree_vmla_shape_t = absl::Span<const int32_t>;
 
@@ -121,8 +126,33 @@ class Interface final : public RefObject<Interface> {
   // Sets a binding within a set to the given buffer value (possibly null).
   Status SetBinding(int32_t set, int32_t binding, Binding value);
 
+  // Gets the ID of the workgroup being executed along dimension |dim|.
+  StatusOr<uint32_t> GetWorkgroupID(int32_t dim) const;
+
+  // Gets the total number of workgroups dispatched along dimension |dim|.
+  StatusOr<uint32_t> GetWorkgroupCount(int32_t dim) const;
+
+  // Sets the workgroup ID and count of the invocation using the interface.
+  void SetWorkgroup(std::array<uint32_t, 3> workgroup_id,
+                    std::array<uint32_t, 3> workgroup_count);
+
+  // Thread pool of the device executing the invocation (possibly null) used
+  // by multithreaded kernels such as matmul.
+  kernels::MatMulThreadPool* thread_pool() const { return thread_pool_; }
+
+  // Number of threads each kernel of the invocation should use from the
+  // thread pool, or 0 to use as many as are available.
+  int thread_hint() const { return thread_hint_; }
+
+  // Sets the thread pool and per-kernel thread hint of the invocation.
+  void SetThreadPool(kernels::MatMulThreadPool* thread_pool, int thread_hint);
+
  private:
   std::array<uint32_t, kMaxConstants> constants_;
+  std::array<uint32_t, 3> workgroup_id_ = {0, 0, 0};
+  std::array<uint32_t, 3> workgroup_count_ = {1, 1, 1};
+  kernels::MatMulThreadPool* thread_pool_ = nullptr;
+  int thread_hint_ = 0;
   std::array<std::array<Binding, kMaxBindings>, kMaxSets> bindings_;
 };
 
@@ -27,10 +27,55 @@ namespace iree {
 namespace hal {
 namespace vulkan {
 
-PipelineCache::PipelineCache(ref_ptr<VkDeviceHandle> logical_device)
-    : logical_device_(std::move(logical_device)) {}
+// static
+StatusOr<ref_ptr<PipelineCache>> PipelineCache::Create(
+    ref_ptr<VkDeviceHandle> logical_device,
+    absl::Span<const uint8_t> initial_data) {
+  IREE_TRACE_SCOPE0("PipelineCache::Create");
+  VkPipelineCacheCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.pNext = nullptr;
+  create_info.flags = 0;
+  create_info.initialDataSize = initial_data.size();
+  create_info.pInitialData =
+      initial_data.empty() ? nullptr : initial_data.data();
+  VkPipelineCache handle = VK_NULL_HANDLE;
+  VK_RETURN_IF_ERROR(logical_device->syms()->vkCreatePipelineCache(
+      *logical_device, &create_info, logical_device->allocator(), &handle));
+  return make_ref<PipelineCache>(std::move(logical_device), handle);
+}
+
+PipelineCache::PipelineCache(ref_ptr<VkDeviceHandle> logical_device,
+                             VkPipelineCache handle)
+    : logical_device_(std::move(logical_device)), handle_(handle) {}
+
+PipelineCache::~PipelineCache() {
+  if (handle_ != VK_NULL_HANDLE) {
+    syms()->vkDestroyPipelineCache(*logical_device_, handle_,
+                                   logical_device_->allocator());
+  }
+}
+
+StatusOr<std::vector<uint8_t>> PipelineCache::Serialize() const {
+  IREE_TRACE_SCOPE0("PipelineCache::Serialize");
+  std::vector<uint8_t> data;
+  if (handle_ == VK_NULL_HANDLE) return data;
 
-PipelineCache::~PipelineCache() = default;
+  // The size may change between the query and the fetch if other threads are
+  // preparing pipelines; VK_INCOMPLETE indicates the data was truncated.
+  VkResult result = VK_INCOMPLETE;
+  while (result == VK_INCOMPLETE) {
+    size_t data_size = 0;
+    VK_RETURN_IF_ERROR(syms()->vkGetPipelineCacheData(
+        *logical_device_, handle_, &data_size, nullptr));
+    data.resize(data_size);
+    result = syms()->vkGetPipelineCacheData(*logical_device_, handle_,
+                                            &data_size, data.data());
+    data.resize(data_size);
+  }
+  VK_RETURN_IF_ERROR(result);
+  return data;
+}
 
 bool PipelineCache::CanPrepareFormat(ExecutableFormat format) const {
   return format == kExecutableFormatSpirV;
@@ -55,7 +100,7 @@ StatusOr<ref_ptr<Executable>> PipelineCache::PrepareExecutable(
       auto executable,
       PipelineExecutable::Create(
           add_ref(logical_device_),
-          /*pipeline_cache=*/VK_NULL_HANDLE,
+          handle_,
           static_cast<PipelineExecutableLayout*>(executable_layout), mode,
           spirv_executable_def));
   return executable;
@@ -17,7 +17,11 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
 #include "iree/hal/vulkan/handle_util.h"
@@ -28,15 +32,29 @@ namespace iree {
 namespace hal {
 namespace vulkan {
 
+// Executable cache backed by a VkPipelineCache. Serialized caches contain the
+// VkPipelineCache data, which the implementation will ignore if it was
+// produced by an incompatible device or driver version.
 class PipelineCache final : public ExecutableCache {
  public:
-  explicit PipelineCache(ref_ptr<VkDeviceHandle> logical_device);
+  // Creates a pipeline cache populated with |initial_data| (if any) previously
+  // returned from Serialize.
+  static StatusOr<ref_ptr<PipelineCache>> Create(
+      ref_ptr<VkDeviceHandle> logical_device,
+      absl::Span<const uint8_t> initial_data);
+
+  // |handle| may be VK_NULL_HANDLE to disable pipeline caching.
+  PipelineCache(ref_ptr<VkDeviceHandle> logical_device, VkPipelineCache handle);
   ~PipelineCache() override;
 
+  VkPipelineCache handle() const { return handle_; }
+
   const ref_ptr<DynamicSymbols>& syms() const {
     return logical_device_->syms();
   }
 
+  StatusOr<std::vector<uint8_t>> Serialize() const override;
+
   bool CanPrepareFormat(ExecutableFormat format) const override;
 
   StatusOr<ref_ptr<Executable>> PrepareExecutable(
@@ -45,6 +63,7 @@ class PipelineCache final : public ExecutableCache {
 
  private:
   ref_ptr<VkDeviceHandle> logical_device_;
+  VkPipelineCache handle_ = VK_NULL_HANDLE;
 };
 
 }  // namespace vulkan
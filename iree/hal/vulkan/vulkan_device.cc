@@ -496,7 +496,23 @@ std::string VulkanDevice::DebugString() const {
 
 ref_ptr<ExecutableCache> VulkanDevice::CreateExecutableCache() {
   IREE_TRACE_SCOPE0("VulkanDevice::CreateExecutableCache");
-  return make_ref<PipelineCache>(add_ref(logical_device_));
+  auto pipeline_cache_or = PipelineCache::Create(add_ref(logical_device_), {});
+  if (!pipeline_cache_or.ok()) {
+    // Pipeline caching is an optimization; fall back to not caching at all.
+    LOG(WARNING) << "Unable to create pipeline cache: "
+                 << pipeline_cache_or.status();
+    return make_ref<PipelineCache>(add_ref(logical_device_), VK_NULL_HANDLE);
+  }
+  return std::move(pipeline_cache_or).value();
+}
+
+StatusOr<ref_ptr<ExecutableCache>> VulkanDevice::CreateExecutableCache(
+    absl::Span<const uint8_t> initial_data) {
+  IREE_TRACE_SCOPE0("VulkanDevice::CreateExecutableCache");
+  ASSIGN_OR_RETURN(auto pipeline_cache,
+                   PipelineCache::Create(add_ref(logical_device_),
+                                         initial_data));
+  return pipeline_cache;
 }
 
 StatusOr<ref_ptr<DescriptorSetLayout>> VulkanDevice::CreateDescriptorSetLayout(
@@ -84,6 +84,8 @@ class VulkanDevice final : public Device {
   }
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+  StatusOr<ref_ptr<ExecutableCache>> CreateExecutableCache(
+      absl::Span<const uint8_t> initial_data) override;
 
   StatusOr<ref_ptr<DescriptorSetLayout>> CreateDescriptorSetLayout(
       DescriptorSetLayout::UsageType usage_type,
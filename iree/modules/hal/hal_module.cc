@@ -14,10 +14,15 @@
 
 #include "iree/modules/hal/hal_module.h"
 
+#include <memory>
+
 #include "absl/base/macros.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/api.h"
 #include "iree/base/api_util.h"
@@ -26,6 +31,9 @@
 #include "iree/hal/api_detail.h"
 #include "iree/hal/command_queue.h"
 #include "iree/hal/device.h"
+#include "iree/hal/executable.h"
+#include "iree/hal/executable_cache.h"
+#include "iree/hal/host/task_executor.h"
 #include "iree/vm/module_abi_cc.h"
 
 namespace iree {
@@ -101,6 +109,116 @@ IREE_VM_DEFINE_TYPE_ADAPTERS(iree_hal_executable_cache,
 IREE_VM_DEFINE_TYPE_ADAPTERS(iree_hal_executable_layout,
                              iree_hal_executable_layout_t);
 
+//===----------------------------------------------------------------------===//
+// Asynchronous executable preparation
+//===----------------------------------------------------------------------===//
+
+// An executable that is being prepared asynchronously.
+// Users must call Resolve to get the prepared executable prior to use, which
+// blocks until preparation has completed.
+class DeferredExecutable final : public Executable {
+ public:
+  DeferredExecutable() = default;
+  ~DeferredExecutable() override = default;
+
+  bool supports_debugging() const override {
+    auto executable_or = Resolve();
+    return executable_or.ok() && executable_or.value()->supports_debugging();
+  }
+
+  // Completes the preparation and wakes all threads waiting in Resolve.
+  void Complete(StatusOr<ref_ptr<Executable>> executable) {
+    absl::MutexLock lock(&mutex_);
+    executable_ = std::move(executable);
+    is_ready_ = true;
+  }
+
+  // Returns the prepared executable or the preparation error, blocking until
+  // preparation has completed. The executable remains valid for the lifetime of
+  // the deferred executable.
+  StatusOr<Executable*> Resolve() const {
+    absl::MutexLock lock(&mutex_);
+    if (!is_ready_) {
+      IREE_TRACE_SCOPE0("DeferredExecutable::Resolve:wait");
+      mutex_.Await(absl::Condition(&is_ready_));
+    }
+    if (!executable_.ok()) return executable_.status();
+    return executable_.value().get();
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  bool is_ready_ ABSL_GUARDED_BY(mutex_) = false;
+  StatusOr<ref_ptr<Executable>> executable_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Prepares executables concurrently on a TaskExecutor.
+// Preparations still outstanding when the preparer is destroyed are waited on
+// so that they complete before the caches and device they use are released.
+class AsyncExecutablePreparer final {
+ public:
+  explicit AsyncExecutablePreparer(ref_ptr<TaskExecutor> executor)
+      : executor_(std::move(executor)),
+        pending_(std::make_shared<PendingState>()) {}
+
+  ~AsyncExecutablePreparer() {
+    IREE_TRACE_SCOPE0("AsyncExecutablePreparer::dtor");
+    absl::MutexLock lock(&pending_->mutex);
+    pending_->mutex.Await(absl::Condition(
+        +[](int* count) { return *count == 0; }, &pending_->count));
+  }
+
+  // Schedules preparation of |executable_data| with |executable_cache| and
+  // returns an executable that resolves to the prepared executable.
+  ref_ptr<DeferredExecutable> Prepare(
+      vm::ref<iree_hal_executable_cache_t> executable_cache,
+      vm::ref<iree_hal_executable_layout_t> executable_layout,
+      iree_hal_executable_caching_mode_t caching_mode,
+      vm::ref<iree_vm_ro_byte_buffer_t> executable_data) {
+    IREE_TRACE_SCOPE0("AsyncExecutablePreparer::Prepare");
+    auto deferred_executable = make_ref<DeferredExecutable>();
+    {
+      absl::MutexLock lock(&pending_->mutex);
+      ++pending_->count;
+    }
+
+    // The task retains everything it uses and releases it before signaling
+    // completion. The pending state is shared so that it outlives the preparer
+    // if the task is still unwinding when the preparer is destroyed.
+    auto* deferred_executable_ptr = deferred_executable.get();
+    deferred_executable_ptr->AddReference();
+    executor_->Submit([pending = pending_, deferred_executable_ptr,
+                       executable_cache, executable_layout, caching_mode,
+                       executable_data]() mutable {
+      IREE_TRACE_SCOPE0("AsyncExecutablePreparer::PrepareTask");
+      ExecutableSpec spec;
+      spec.executable_data = {executable_data->data.data,
+                              executable_data->data.data_length};
+      deferred_executable_ptr->Complete(
+          reinterpret_cast<ExecutableCache*>(executable_cache.get())
+              ->PrepareExecutable(
+                  reinterpret_cast<ExecutableLayout*>(executable_layout.get()),
+                  static_cast<ExecutableCachingMode>(caching_mode), spec));
+      deferred_executable_ptr->ReleaseReference();
+      executable_data.reset();
+      executable_layout.reset();
+      executable_cache.reset();
+      absl::MutexLock lock(&pending->mutex);
+      --pending->count;
+    });
+    return deferred_executable;
+  }
+
+ private:
+  struct PendingState {
+    absl::Mutex mutex;
+    int count ABSL_GUARDED_BY(mutex) = 0;
+  };
+
+  ref_ptr<TaskExecutor> executor_;
+  std::shared_ptr<PendingState> pending_;
+};
+
 //===----------------------------------------------------------------------===//
 // Module type definitions
 //===----------------------------------------------------------------------===//
@@ -108,8 +226,12 @@ IREE_VM_DEFINE_TYPE_ADAPTERS(iree_hal_executable_layout,
 class HALModuleState final {
  public:
   HALModuleState(iree_allocator_t allocator, ref_ptr<Device> shared_device,
-                 ref_ptr<ExecutableCache> executable_cache)
-      : allocator_(allocator), shared_device_(std::move(shared_device)) {}
+                 ref_ptr<ExecutableCache> executable_cache,
+                 AsyncExecutablePreparer* async_preparer)
+      : allocator_(allocator),
+        shared_device_(std::move(shared_device)),
+        shared_executable_cache_(std::move(executable_cache)),
+        async_preparer_(async_preparer) {}
 
   ~HALModuleState() {
     for (auto& ref : deferred_releases_) {
@@ -137,8 +259,11 @@ class HALModuleState final {
     return OkStatus();
   }
 
-  Status ExSubmitAndWait(vm::ref<iree_hal_device_t> device,
-                         vm::ref<iree_hal_command_buffer_t> command_buffer) {
+  // Submits |command_buffer| and suspends the calling invocation until the
+  // submission fence is signaled instead of blocking the host thread.
+  StatusOr<vm::Wait> ExSubmitAndWait(
+      vm::ref<iree_hal_device_t> device,
+      vm::ref<iree_hal_command_buffer_t> command_buffer) {
     IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
 
     auto* device_ptr = reinterpret_cast<Device*>(device.get());
@@ -149,14 +274,21 @@ class HALModuleState final {
         reinterpret_cast<CommandBuffer*>(command_buffer.get())};
     batch.command_buffers = absl::MakeConstSpan(command_buffers);
     RETURN_IF_ERROR(queue->Submit(batch, {fence.get(), 1u}));
-    RETURN_IF_ERROR(queue->WaitIdle());
-
-    for (auto& ref : deferred_releases_) {
-      iree_vm_ref_release(&ref);
-    }
-    deferred_releases_.clear();
 
-    return OkStatus();
+    // The fence and command buffer are retained by the wait until the
+    // submission retires.
+    auto shared_fence = std::make_shared<ref_ptr<Fence>>(std::move(fence));
+    vm::Wait wait;
+    wait.poll = [this, shared_fence, command_buffer]() -> StatusOr<bool> {
+      ASSIGN_OR_RETURN(uint64_t value, (*shared_fence)->QueryValue());
+      if (value < 1u) return false;
+      for (auto& ref : deferred_releases_) {
+        iree_vm_ref_release(&ref);
+      }
+      deferred_releases_.clear();
+      return true;
+    };
+    return wait;
   }
 
   //===--------------------------------------------------------------------===//
@@ -564,6 +696,25 @@ class HALModuleState final {
     return OkStatus();
   }
 
+  Status CommandBufferPushDescriptorSetSlots(
+      vm::ref<iree_hal_command_buffer_t> command_buffer,
+      vm::ref<iree_hal_executable_layout_t> executable_layout, int32_t set,
+      absl::Span<const int32_t> binding_ordinals,
+      absl::Span<const int32_t> binding_slots) {
+    IREE_TRACE_SCOPE0("HALModuleState::CommandBufferPushDescriptorSetSlots");
+    absl::InlinedVector<iree_hal_descriptor_set_slot_binding_t, 4>
+        binding_structs(binding_ordinals.size());
+    for (int i = 0; i < binding_ordinals.size(); ++i) {
+      binding_structs[i] = {binding_ordinals[i], binding_slots[i]};
+    }
+    RETURN_IF_ERROR(
+        FromApiStatus(iree_hal_command_buffer_push_descriptor_set_slots(
+                          command_buffer.get(), executable_layout.get(), set,
+                          binding_structs.size(), binding_structs.data()),
+                      IREE_LOC));
+    return OkStatus();
+  }
+
   Status CommandBufferBindDescriptorSet(
       vm::ref<iree_hal_command_buffer_t> command_buffer,
       vm::ref<iree_hal_executable_layout_t> executable_layout, int32_t set,
@@ -590,10 +741,12 @@ class HALModuleState final {
       vm::ref<iree_hal_executable_t> executable, int32_t entry_point,
       uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
     IREE_TRACE_SCOPE0("HALModuleState::CommandBufferDispatch");
+    ASSIGN_OR_RETURN(auto* resolved_executable,
+                     ResolveExecutable(executable.get()));
     RETURN_IF_ERROR(FromApiStatus(
-        iree_hal_command_buffer_dispatch(command_buffer.get(), executable.get(),
-                                         entry_point, workgroup_x, workgroup_y,
-                                         workgroup_z),
+        iree_hal_command_buffer_dispatch(command_buffer.get(),
+                                         resolved_executable, entry_point,
+                                         workgroup_x, workgroup_y, workgroup_z),
         IREE_LOC));
     return OkStatus();
   }
@@ -603,14 +756,43 @@ class HALModuleState final {
       vm::ref<iree_hal_executable_t> executable, int32_t entry_point,
       vm::ref<iree_hal_buffer_t> workgroups_buffer, int32_t workgroups_offset) {
     IREE_TRACE_SCOPE0("HALModuleState::CommandBufferDispatchIndirect");
+    ASSIGN_OR_RETURN(auto* resolved_executable,
+                     ResolveExecutable(executable.get()));
     RETURN_IF_ERROR(
         FromApiStatus(iree_hal_command_buffer_dispatch_indirect(
-                          command_buffer.get(), executable.get(), entry_point,
-                          workgroups_buffer.get(), workgroups_offset),
+                          command_buffer.get(), resolved_executable,
+                          entry_point, workgroups_buffer.get(),
+                          workgroups_offset),
                       IREE_LOC));
     return OkStatus();
   }
 
+  StatusOr<vm::ref<iree_hal_command_buffer_t>> CommandBufferBind(
+      vm::ref<iree_hal_command_buffer_t> command_buffer,
+      absl::Span<const vm::ref<iree_hal_buffer_t>> binding_buffers,
+      absl::Span<const int32_t> binding_offsets,
+      absl::Span<const int32_t> binding_lengths) {
+    IREE_TRACE_SCOPE0("HALModuleState::CommandBufferBind");
+    absl::InlinedVector<iree_hal_binding_table_entry_t, 8> binding_table(
+        binding_buffers.size());
+    for (int i = 0; i < binding_buffers.size(); ++i) {
+      binding_table[i] = {
+          binding_buffers[i].get(),
+          static_cast<iree_device_size_t>(binding_offsets[i]),
+          static_cast<iree_device_size_t>(binding_lengths[i])};
+    }
+    vm::ref<iree_hal_command_buffer_t> bound_command_buffer;
+    RETURN_IF_ERROR(FromApiStatus(
+        iree_hal_command_buffer_bind(command_buffer.get(),
+                                     binding_table.size(),
+                                     binding_table.data(),
+                                     IREE_ALLOCATOR_SYSTEM,
+                                     &bound_command_buffer),
+        IREE_LOC))
+        << "Failed to bind command buffer";
+    return bound_command_buffer;
+  }
+
   //===--------------------------------------------------------------------===//
   // iree::hal::DescriptorSet
   //===--------------------------------------------------------------------===//
@@ -693,6 +875,13 @@ class HALModuleState final {
   StatusOr<vm::ref<iree_hal_executable_cache_t>> ExecutableCacheCreate(
       vm::ref<iree_hal_device_t> device, absl::string_view identifier) {
     IREE_TRACE_SCOPE0("HALModuleState::ExecutableCacheCreate");
+    // Caches for the shared device all use the module cache so that prepared
+    // executables are shared across contexts and can be serialized by the
+    // hosting application.
+    if (reinterpret_cast<Device*>(device.get()) == shared_device_.get()) {
+      return vm::retain_ref(reinterpret_cast<iree_hal_executable_cache_t*>(
+          shared_executable_cache_.get()));
+    }
     vm::ref<iree_hal_executable_cache_t> executable_cache;
     RETURN_IF_ERROR(FromApiStatus(
         iree_hal_executable_cache_create(
@@ -722,6 +911,16 @@ class HALModuleState final {
       iree_hal_executable_caching_mode_t caching_mode,
       vm::ref<iree_vm_ro_byte_buffer_t> executable_data) {
     IREE_TRACE_SCOPE0("HALModuleState::ExecutableCachePrepare");
+    if (async_preparer_) {
+      auto deferred_executable = async_preparer_->Prepare(
+          std::move(executable_cache), std::move(executable_layout),
+          caching_mode, std::move(executable_data));
+      auto* executable =
+          reinterpret_cast<iree_hal_executable_t*>(deferred_executable.get());
+      deferred_executables_[executable] = add_ref(deferred_executable);
+      return vm::assign_ref(reinterpret_cast<iree_hal_executable_t*>(
+          deferred_executable.release()));
+    }
     vm::ref<iree_hal_executable_t> executable;
     RETURN_IF_ERROR(FromApiStatus(
         iree_hal_executable_cache_prepare_executable(
@@ -753,8 +952,27 @@ class HALModuleState final {
   }
 
  private:
+  // Returns the executable that should be dispatched for |executable|, waiting
+  // for its preparation to complete if it was prepared asynchronously.
+  StatusOr<iree_hal_executable_t*> ResolveExecutable(
+      iree_hal_executable_t* executable) {
+    auto it = deferred_executables_.find(executable);
+    if (it == deferred_executables_.end()) return executable;
+    ASSIGN_OR_RETURN(auto* resolved_executable, it->second->Resolve());
+    return reinterpret_cast<iree_hal_executable_t*>(resolved_executable);
+  }
+
   iree_allocator_t allocator_;
   ref_ptr<Device> shared_device_;
+  ref_ptr<ExecutableCache> shared_executable_cache_;
+  // Set when executables are prepared asynchronously.
+  AsyncExecutablePreparer* async_preparer_ = nullptr;
+  // Executables prepared by |async_preparer_|. Executables passed to the
+  // module that are not in the map (such as those created by the host) are
+  // used as-is. The state retains the executables so that their addresses are
+  // not reused while it may still look them up.
+  absl::flat_hash_map<iree_hal_executable_t*, ref_ptr<DeferredExecutable>>
+      deferred_executables_;
 
   std::vector<iree_vm_ref_t> deferred_releases_;
 };
@@ -830,12 +1048,17 @@ static const vm::NativeFunction<HALModuleState> kHALModuleFunctions[] = {
                            &HALModuleState::CommandBufferPushConstants),
     vm::MakeNativeFunction("command_buffer.push_descriptor_set",
                            &HALModuleState::CommandBufferPushDescriptorSet),
+    vm::MakeNativeFunction(
+        "command_buffer.push_descriptor_set.slots",
+        &HALModuleState::CommandBufferPushDescriptorSetSlots),
     vm::MakeNativeFunction("command_buffer.bind_descriptor_set",
                            &HALModuleState::CommandBufferBindDescriptorSet),
     vm::MakeNativeFunction("command_buffer.dispatch",
                            &HALModuleState::CommandBufferDispatch),
     vm::MakeNativeFunction("command_buffer.dispatch.indirect",
                            &HALModuleState::CommandBufferDispatchIndirect),
+    vm::MakeNativeFunction("command_buffer.bind",
+                           &HALModuleState::CommandBufferBind),
 
     vm::MakeNativeFunction("descriptor_set.create",
                            &HALModuleState::DescriptorSetCreate),
@@ -865,10 +1088,22 @@ class HALModule final : public vm::NativeModule<HALModuleState> {
         shared_device_(std::move(shared_device)) {}
   ~HALModule() = default;
 
-  Status Initialize() {
+  Status Initialize(const iree_hal_module_options_t& options) {
     IREE_TRACE_SCOPE0("HALModule::Initialize");
 
-    executable_cache_ = shared_device_->CreateExecutableCache();
+    if (options.executable_cache) {
+      executable_cache_ =
+          add_ref(reinterpret_cast<ExecutableCache*>(options.executable_cache));
+    } else {
+      executable_cache_ = shared_device_->CreateExecutableCache();
+    }
+
+    if (options.async_executable_preparation) {
+      // Share the host worker threads; preparation is bursty and only happens
+      // while modules are being initialized.
+      async_preparer_ = absl::make_unique<AsyncExecutablePreparer>(
+          TaskExecutor::GetOrCreateShared(TaskExecutor::Options{}));
+    }
 
     return OkStatus();
   }
@@ -877,7 +1112,8 @@ class HALModule final : public vm::NativeModule<HALModuleState> {
       iree_allocator_t allocator) override {
     IREE_TRACE_SCOPE0("HALModule::CreateState");
     auto state = std::make_unique<HALModuleState>(
-        allocator, add_ref(shared_device_), add_ref(executable_cache_));
+        allocator, add_ref(shared_device_), add_ref(executable_cache_),
+        async_preparer_.get());
     // TODO(benvanik): allocate context-specific variables (allocator pool,
     // etc).
     return state;
@@ -886,16 +1122,35 @@ class HALModule final : public vm::NativeModule<HALModuleState> {
  private:
   ref_ptr<Device> shared_device_;
   ref_ptr<ExecutableCache> executable_cache_;
+  // Declared last so outstanding preparations complete before the cache and
+  // device are released.
+  std::unique_ptr<AsyncExecutablePreparer> async_preparer_;
 };
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_module_create(iree_hal_device_t* device, iree_allocator_t allocator,
                        iree_vm_module_t** out_module) {
+  iree_hal_module_options_t options;
+  iree_hal_module_options_initialize(&options);
+  return iree_hal_module_create_with_options(device, &options, allocator,
+                                             out_module);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_module_options_initialize(iree_hal_module_options_t* out_options) {
+  out_options->executable_cache = nullptr;
+  out_options->async_executable_preparation = false;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_module_create_with_options(
+    iree_hal_device_t* device, const iree_hal_module_options_t* options,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
   if (!out_module) return IREE_STATUS_INVALID_ARGUMENT;
   *out_module = nullptr;
+  if (!device || !options) return IREE_STATUS_INVALID_ARGUMENT;
   auto module = std::make_unique<HALModule>(
       allocator, add_ref(reinterpret_cast<Device*>(device)));
-  IREE_API_RETURN_IF_ERROR(module->Initialize());
+  IREE_API_RETURN_IF_ERROR(module->Initialize(*options));
   *out_module = module.release()->interface();
   return IREE_STATUS_OK;
 }
@@ -52,6 +52,30 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_module_create(iree_hal_device_t* device, iree_allocator_t allocator,
                        iree_vm_module_t** out_module);
 
+// Options controlling the HAL module.
+typedef struct {
+  // Executable cache used to prepare all executables for the device. The cache
+  // is retained by the module and can be serialized by the caller (such as
+  // after all executables have been prepared) to warm-start future processes.
+  // If NULL a new cache is created from the device.
+  iree_hal_executable_cache_t* executable_cache;
+
+  // Prepares executables concurrently on a shared pool of worker threads
+  // instead of one at a time in the module initializers. Executables block at
+  // first dispatch until their preparation has completed and preparation
+  // failures are reported by that dispatch.
+  bool async_executable_preparation;
+} iree_hal_module_options_t;
+
+// Initializes |out_options| to the defaults used by iree_hal_module_create.
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_module_options_initialize(iree_hal_module_options_t* out_options);
+
+// Creates the HAL module as with iree_hal_module_create using |options|.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_module_create_with_options(
+    iree_hal_device_t* device, const iree_hal_module_options_t* options,
+    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,307 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests asynchronous executable preparation by calling the HAL module exports
+// directly. Executables are prepared by a test cache that blocks until the test
+// allows preparation to proceed so that outstanding preparations can be
+// observed.
+
+#include "iree/modules/hal/hal_module.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/hal/api.h"
+#include "iree/hal/executable.h"
+#include "iree/hal/executable_cache.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/api.h"
+#include "iree/vm/ref_cc.h"
+#include "iree/vm/variant_list.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+constexpr absl::string_view kValidExecutableData = "valid";
+constexpr absl::string_view kInvalidExecutableData = "invalid";
+
+class TestExecutable final : public Executable {
+ public:
+  bool supports_debugging() const override { return false; }
+};
+
+// Executable cache that blocks all preparation until Unblock is called and
+// fails to prepare kInvalidExecutableData.
+class TestExecutableCache final : public ExecutableCache {
+ public:
+  void Unblock() {
+    if (!unblocked_.HasBeenNotified()) unblocked_.Notify();
+  }
+
+  int started_count() const { return started_count_; }
+  int completed_count() const { return completed_count_; }
+
+  bool CanPrepareFormat(ExecutableFormat format) const override {
+    return true;
+  }
+
+  StatusOr<ref_ptr<Executable>> PrepareExecutable(
+      ExecutableLayout* executable_layout, ExecutableCachingModeBitfield mode,
+      const ExecutableSpec& spec) override {
+    ++started_count_;
+    unblocked_.WaitForNotification();
+    absl::string_view executable_data(
+        reinterpret_cast<const char*>(spec.executable_data.data()),
+        spec.executable_data.size());
+    ref_ptr<Executable> executable;
+    if (executable_data != kInvalidExecutableData) {
+      executable = make_ref<TestExecutable>();
+    }
+    ++completed_count_;
+    if (!executable) {
+      return DataLossErrorBuilder(IREE_LOC) << "Corrupt executable data";
+    }
+    return executable;
+  }
+
+ private:
+  absl::Notification unblocked_;
+  std::atomic<int> started_count_{0};
+  std::atomic<int> completed_count_{0};
+};
+
+class HALModuleAsyncPreparationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
+    IREE_CHECK_OK(iree_hal_module_register_types());
+
+    iree_hal_driver_t* hal_driver = nullptr;
+    IREE_CHECK_OK(iree_hal_driver_registry_create_driver(
+        iree_make_cstring_view("vmla"), IREE_ALLOCATOR_SYSTEM, &hal_driver));
+    IREE_CHECK_OK(iree_hal_driver_create_default_device(
+        hal_driver, IREE_ALLOCATOR_SYSTEM, &device_));
+    iree_hal_driver_release(hal_driver);
+
+    executable_cache_ = make_ref<TestExecutableCache>();
+    iree_hal_module_options_t options;
+    iree_hal_module_options_initialize(&options);
+    options.executable_cache =
+        reinterpret_cast<iree_hal_executable_cache_t*>(executable_cache_.get());
+    options.async_executable_preparation = true;
+    IREE_CHECK_OK(iree_hal_module_create_with_options(
+        device_, &options, IREE_ALLOCATOR_SYSTEM, &hal_module_));
+
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &hal_module_, 1, IREE_ALLOCATOR_SYSTEM, &context_));
+
+    IREE_CHECK_OK(iree_hal_executable_layout_create(
+        device_, /*set_layout_count=*/0, /*set_layouts=*/nullptr,
+        /*push_constants=*/0, IREE_ALLOCATOR_SYSTEM, &executable_layout_));
+    IREE_CHECK_OK(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_ALLOCATOR_SYSTEM,
+        &command_buffer_));
+    IREE_CHECK_OK(iree_hal_command_buffer_begin(command_buffer_));
+
+    InitializeByteBuffer(kValidExecutableData, &valid_executable_data_);
+    InitializeByteBuffer(kInvalidExecutableData, &invalid_executable_data_);
+  }
+
+  void TearDown() override {
+    // Preparations may still be blocked if a test failed early.
+    executable_cache_->Unblock();
+    iree_hal_command_buffer_release(command_buffer_);
+    iree_hal_executable_layout_release(executable_layout_);
+    if (context_) iree_vm_context_release(context_);
+    if (hal_module_) iree_vm_module_release(hal_module_);
+    iree_hal_device_release(device_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Initializes an unowned byte buffer that the test keeps alive by holding
+  // the initial reference.
+  static void InitializeByteBuffer(absl::string_view data,
+                                   iree_vm_ro_byte_buffer_t* out_buffer) {
+    std::memset(out_buffer, 0, sizeof(*out_buffer));
+    iree_atomic_store(&out_buffer->ref_object.counter, 1);
+    out_buffer->data.data = reinterpret_cast<const uint8_t*>(data.data());
+    out_buffer->data.data_length = data.size();
+  }
+
+  iree_vm_function_t LookupFunction(absl::string_view function_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(hal_module_->lookup_function(
+        hal_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+    return function;
+  }
+
+  // Calls hal.executable_cache.prepare with |executable_data|.
+  vm::ref<iree_hal_executable_t> Prepare(
+      iree_vm_ro_byte_buffer_t* executable_data) {
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_CHECK_OK(
+        iree_vm_variant_list_alloc(4, IREE_ALLOCATOR_SYSTEM, &inputs));
+    iree_vm_ref_t executable_cache_ref = iree_hal_executable_cache_retain_ref(
+        reinterpret_cast<iree_hal_executable_cache_t*>(
+            executable_cache_.get()));
+    IREE_CHECK_OK(
+        iree_vm_variant_list_append_ref_move(inputs, &executable_cache_ref));
+    iree_vm_ref_t executable_layout_ref =
+        iree_hal_executable_layout_retain_ref(executable_layout_);
+    IREE_CHECK_OK(
+        iree_vm_variant_list_append_ref_move(inputs, &executable_layout_ref));
+    iree_vm_value_t caching_mode =
+        IREE_VM_VALUE_MAKE_I32(IREE_HAL_EXECUTABLE_CACHING_MODE_DEFAULT);
+    IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, caching_mode));
+    iree_vm_ref_t executable_data_ref =
+        iree_vm_ro_byte_buffer_retain_ref(executable_data);
+    IREE_CHECK_OK(
+        iree_vm_variant_list_append_ref_move(inputs, &executable_data_ref));
+
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_CHECK_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+    IREE_CHECK_OK(iree_vm_invoke(
+        context_, LookupFunction("executable_cache.prepare"),
+        /*policy=*/nullptr, inputs, outputs, IREE_ALLOCATOR_SYSTEM));
+
+    auto executable = vm::retain_ref(iree_hal_executable_deref(
+        &iree_vm_variant_list_get(outputs, 0)->ref));
+    iree_vm_variant_list_free(inputs);
+    iree_vm_variant_list_free(outputs);
+    return executable;
+  }
+
+  // Calls hal.command_buffer.dispatch with |executable| and returns the
+  // status of the call.
+  iree_status_t Dispatch(const vm::ref<iree_hal_executable_t>& executable) {
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_CHECK_OK(
+        iree_vm_variant_list_alloc(6, IREE_ALLOCATOR_SYSTEM, &inputs));
+    iree_vm_ref_t command_buffer_ref =
+        iree_hal_command_buffer_retain_ref(command_buffer_);
+    IREE_CHECK_OK(
+        iree_vm_variant_list_append_ref_move(inputs, &command_buffer_ref));
+    iree_vm_ref_t executable_ref =
+        iree_hal_executable_retain_ref(executable.get());
+    IREE_CHECK_OK(
+        iree_vm_variant_list_append_ref_move(inputs, &executable_ref));
+    iree_vm_value_t entry_point = IREE_VM_VALUE_MAKE_I32(0);
+    IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, entry_point));
+    iree_vm_value_t workgroup_count = IREE_VM_VALUE_MAKE_I32(1);
+    for (int i = 0; i < 3; ++i) {
+      IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, workgroup_count));
+    }
+
+    iree_status_t status = iree_vm_invoke(
+        context_, LookupFunction("command_buffer.dispatch"),
+        /*policy=*/nullptr, inputs, /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM);
+    iree_vm_variant_list_free(inputs);
+    return status;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_hal_device_t* device_ = nullptr;
+  iree_vm_module_t* hal_module_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  ref_ptr<TestExecutableCache> executable_cache_;
+  iree_hal_executable_layout_t* executable_layout_ = nullptr;
+  iree_hal_command_buffer_t* command_buffer_ = nullptr;
+  iree_vm_ro_byte_buffer_t valid_executable_data_;
+  iree_vm_ro_byte_buffer_t invalid_executable_data_;
+};
+
+TEST_F(HALModuleAsyncPreparationTest, PreparesConcurrentlyAndDispatches) {
+  // Preparation is blocked so each prepare call must return without waiting.
+  std::vector<vm::ref<iree_hal_executable_t>> executables;
+  for (int i = 0; i < 4; ++i) {
+    executables.push_back(Prepare(&valid_executable_data_));
+    ASSERT_TRUE(executables.back());
+  }
+  EXPECT_EQ(executable_cache_->completed_count(), 0);
+
+  executable_cache_->Unblock();
+  for (const auto& executable : executables) {
+    IREE_EXPECT_OK(Dispatch(executable));
+  }
+  EXPECT_EQ(executable_cache_->started_count(), 4);
+  EXPECT_EQ(executable_cache_->completed_count(), 4);
+}
+
+TEST_F(HALModuleAsyncPreparationTest, DispatchWaitsForPreparation) {
+  auto executable = Prepare(&valid_executable_data_);
+  std::thread unblock_thread([this]() {
+    absl::SleepFor(absl::Milliseconds(10));
+    executable_cache_->Unblock();
+  });
+  IREE_EXPECT_OK(Dispatch(executable));
+  EXPECT_EQ(executable_cache_->completed_count(), 1);
+  unblock_thread.join();
+}
+
+TEST_F(HALModuleAsyncPreparationTest, DispatchReturnsPreparationError) {
+  auto valid_executable = Prepare(&valid_executable_data_);
+  auto invalid_executable = Prepare(&invalid_executable_data_);
+  ASSERT_TRUE(invalid_executable);
+  executable_cache_->Unblock();
+
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_status_code(Dispatch(invalid_executable)));
+  // The error remains with the executable and does not affect others.
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_status_code(Dispatch(invalid_executable)));
+  IREE_EXPECT_OK(Dispatch(valid_executable));
+}
+
+TEST_F(HALModuleAsyncPreparationTest, DestroyWaitsForOutstandingPreparations) {
+  for (int i = 0; i < 4; ++i) {
+    Prepare(i % 2 ? &invalid_executable_data_ : &valid_executable_data_);
+  }
+  EXPECT_EQ(executable_cache_->completed_count(), 0);
+
+  // The context holds a reference to the module so the module is destroyed
+  // when both have been released. Destruction must block until the
+  // preparations complete.
+  iree_vm_context_release(context_);
+  context_ = nullptr;
+  std::thread unblock_thread([this]() {
+    absl::SleepFor(absl::Milliseconds(10));
+    executable_cache_->Unblock();
+  });
+  iree_vm_module_release(hal_module_);
+  hal_module_ = nullptr;
+  EXPECT_EQ(executable_cache_->completed_count(), 4);
+  unblock_thread.join();
+
+  // The test still holds its reference so the cache outlives the module.
+  EXPECT_EQ(executable_cache_->started_count(), 4);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -12,8 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
 #include "absl/flags/flag.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "benchmark/benchmark.h"
 #include "iree/base/api_util.h"
 #include "iree/base/file_io.h"
@@ -48,6 +55,11 @@ ABSL_FLAG(std::vector<std::string>, inputs, {},
           "values:\n"
           "2x2xi32=[[1 2][3 4]], 1x2xf32=[[1 2]]");
 
+ABSL_FLAG(bool, print_profile, false,
+          "Prints opcode, function, and import statistics of the benchmarked "
+          "iterations. Requires the VM to be built with "
+          "IREE_VM_PROFILING_ENABLE=1.");
+
 namespace iree {
 namespace {
 
@@ -60,6 +72,63 @@ StatusOr<std::string> GetModuleContentsFromFlags() {
   return file_io::GetFileContents(input_file);
 }
 
+// Prints the profile of |module| collected over |iterations| invocations.
+Status PrintProfile(iree_vm_module_t* module, int64_t iterations) {
+  iree_vm_bytecode_profile_t* profile = nullptr;
+  iree_status_t status = iree_vm_bytecode_module_profile_snapshot(
+      module, IREE_ALLOCATOR_SYSTEM, &profile);
+  if (status == IREE_STATUS_UNAVAILABLE) {
+    fprintf(stdout,
+            "VM profiling is not available; rebuild with "
+            "IREE_VM_PROFILING_ENABLE=1.\n");
+    return OkStatus();
+  }
+  RETURN_IF_ERROR(FromApiStatus(status, IREE_LOC));
+
+  fprintf(stdout, "VM profile over %lld iterations:\n",
+          static_cast<long long>(iterations));
+
+  std::vector<std::pair<int64_t, int>> opcodes;
+  for (int i = 0; i < 256; ++i) {
+    if (profile->opcode_counts[i]) {
+      opcodes.push_back({profile->opcode_counts[i], i});
+    }
+  }
+  std::sort(opcodes.rbegin(), opcodes.rend());
+  fprintf(stdout, "%-24s %16s\n", "Opcode", "Count");
+  for (const auto& opcode : opcodes) {
+    iree_string_view_t name =
+        iree_vm_bytecode_opcode_name(static_cast<uint8_t>(opcode.second));
+    fprintf(stdout, "%-24.*s %16lld\n", static_cast<int>(name.size),
+            name.data, static_cast<long long>(opcode.first));
+  }
+
+  fprintf(stdout, "\n%-32s %10s %16s %16s\n", "Function", "Calls",
+          "Inclusive (ns)", "Exclusive (ns)");
+  for (int32_t i = 0; i < profile->function_count; ++i) {
+    const auto& function = profile->functions[i];
+    if (!function.call_count) continue;
+    fprintf(stdout, "%-32.*s %10lld %16lld %16lld\n",
+            static_cast<int>(function.name.size), function.name.data,
+            static_cast<long long>(function.call_count),
+            static_cast<long long>(function.inclusive_time_ns),
+            static_cast<long long>(function.exclusive_time_ns));
+  }
+
+  fprintf(stdout, "\n%-32s %10s %16s\n", "Import", "Calls", "Time (ns)");
+  for (int32_t i = 0; i < profile->import_count; ++i) {
+    const auto& import = profile->imports[i];
+    if (!import.call_count) continue;
+    fprintf(stdout, "%-32.*s %10lld %16lld\n",
+            static_cast<int>(import.full_name.size), import.full_name.data,
+            static_cast<long long>(import.call_count),
+            static_cast<long long>(import.time_ns));
+  }
+  fprintf(stdout, "\n");
+
+  return FromApiStatus(iree_vm_bytecode_profile_free(profile), IREE_LOC);
+}
+
 Status Run(::benchmark::State& state) {
   RETURN_IF_ERROR(FromApiStatus(iree_hal_module_register_types(), IREE_LOC))
       << "registering HAL types";
@@ -74,6 +143,11 @@ Status Run(::benchmark::State& state) {
 
   iree_hal_device_t* device = nullptr;
   RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
+
+  // Time to first inference covers everything between having a device and
+  // getting the results of the first invocation: module initialization
+  // (including executable preparation) and the first run.
+  absl::Time start_time = absl::Now();
   iree_vm_module_t* hal_module = nullptr;
   RETURN_IF_ERROR(CreateHalModule(device, &hal_module));
 
@@ -120,6 +194,17 @@ Status Run(::benchmark::State& state) {
                                    inputs, outputs, IREE_ALLOCATOR_SYSTEM),
                     IREE_LOC));
   RETURN_IF_ERROR(FromApiStatus(iree_vm_variant_list_free(outputs), IREE_LOC));
+  state.counters["time_to_first_inference_ms"] =
+      absl::ToDoubleMilliseconds(absl::Now() - start_time);
+
+  // Only profile the benchmarked iterations.
+  bool print_profile = absl::GetFlag(FLAGS_print_profile);
+  if (print_profile) {
+    iree_status_t status = iree_vm_bytecode_module_profile_reset(input_module);
+    if (status != IREE_STATUS_UNAVAILABLE) {
+      RETURN_IF_ERROR(FromApiStatus(status, IREE_LOC));
+    }
+  }
 
   for (auto _ : state) {
     // No status conversions and conditional returns in the benchmarked inner
@@ -131,6 +216,10 @@ Status Run(::benchmark::State& state) {
     IREE_CHECK_OK(iree_vm_variant_list_free(outputs));
   }
 
+  if (print_profile) {
+    RETURN_IF_ERROR(PrintProfile(input_module, state.iterations()));
+  }
+
   // TODO(gcmn): Some nice wrappers to make this pattern shorter with generated
   // error messages.
   // Deallocate:
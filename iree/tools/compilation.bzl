@@ -56,3 +56,47 @@ def iree_bytecode_module(
             visibility = visibility,
             flatten = True,
         )
+
+def iree_c_module(
+        name,
+        src,
+        flags = ["-iree-mlir-to-vm-c-module"],
+        translate_tool = "//iree/tools:iree-translate",
+        testonly = None,
+        visibility = None):
+    """Compiles a VM module ahead-of-time to C and wraps it in a cc_library.
+
+    The library is named |name|_c and provides |name|.h declaring the module
+    create function. |flags| must produce a VM C module (for example
+    -iree-vm-ir-to-c-module when |src| is already in the VM dialect).
+    """
+    for output, output_format in [("c", "source"), ("h", "header")]:
+        native.genrule(
+            name = "%s_%s_gen" % (name, output),
+            srcs = [src],
+            outs = ["%s.%s" % (name, output)],
+            cmd = " ".join([
+                "$(location %s)" % (translate_tool),
+                " ".join(flags),
+                "-iree-vm-c-module-output-format=%s" % (output_format),
+                "-iree-vm-c-module-prefix=%s" % (name),
+                "-o $(location %s.%s)" % (name, output),
+                "$(location %s)" % (src),
+            ]),
+            tools = [translate_tool],
+            testonly = testonly,
+            message = "Compiling IREE module %s to C..." % (name),
+            output_to_bindir = 1,
+        )
+
+    native.cc_library(
+        name = "%s_c" % (name),
+        srcs = ["%s.c" % (name)],
+        hdrs = ["%s.h" % (name)],
+        deps = [
+            "//iree/base:api",
+            "//iree/vm:c_module",
+        ],
+        testonly = testonly,
+        visibility = visibility,
+    )
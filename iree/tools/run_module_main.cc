@@ -19,6 +19,7 @@
 #include "iree/base/api_util.h"
 #include "iree/base/file_io.h"
 #include "iree/base/init.h"
+#include "iree/base/logging.h"
 #include "iree/base/source_location.h"
 #include "iree/base/status.h"
 #include "iree/modules/hal/hal_module.h"
@@ -47,6 +48,13 @@ ABSL_FLAG(std::vector<std::string>, inputs, {},
           "values:\n"
           "2x2xi32=[[1 2][3 4]], 1x2xf32=[[1 2]]");
 
+ABSL_FLAG(std::string, executable_cache_file, "",
+          "File used to warm-start the executable cache. If the file exists "
+          "its contents are used to populate the cache and after the run "
+          "completes the file is replaced with the contents of the cache. "
+          "Cache data from another driver or device is ignored. Only drivers "
+          "that compile executables (vulkan, llvm) persist any data.");
+
 namespace iree {
 namespace {
 
@@ -62,6 +70,55 @@ StatusOr<std::string> GetModuleContentsFromFlags() {
   return contents;
 }
 
+// Creates an executable cache for |device| populated with the contents of
+// |cache_file|, if it exists. Invalid cache data is ignored as it will be
+// replaced when the cache is saved.
+StatusOr<iree_hal_executable_cache_t*> LoadExecutableCache(
+    iree_hal_device_t* device, const std::string& cache_file) {
+  std::string cache_data;
+  if (file_io::FileExists(cache_file).ok()) {
+    ASSIGN_OR_RETURN(cache_data, file_io::GetFileContents(cache_file));
+  }
+  iree_hal_executable_cache_t* executable_cache = nullptr;
+  auto status = FromApiStatus(
+      iree_hal_executable_cache_create_with_data(
+          device, iree_make_cstring_view("default"),
+          iree_const_byte_span_t{
+              reinterpret_cast<const uint8_t*>(cache_data.data()),
+              cache_data.size()},
+          IREE_ALLOCATOR_SYSTEM, &executable_cache),
+      IREE_LOC);
+  if (!status.ok()) {
+    LOG(WARNING) << "Ignoring executable cache file '" << cache_file
+                 << "': " << status;
+    RETURN_IF_ERROR(FromApiStatus(
+        iree_hal_executable_cache_create(
+            device, iree_make_cstring_view("default"), IREE_ALLOCATOR_SYSTEM,
+            &executable_cache),
+        IREE_LOC));
+  }
+  return executable_cache;
+}
+
+// Writes the contents of |executable_cache| to |cache_file|.
+Status SaveExecutableCache(iree_hal_executable_cache_t* executable_cache,
+                           const std::string& cache_file) {
+  iree_byte_span_t cache_data = {nullptr, 0};
+  RETURN_IF_ERROR(FromApiStatus(
+      iree_hal_executable_cache_serialize(executable_cache,
+                                          IREE_ALLOCATOR_SYSTEM, &cache_data),
+      IREE_LOC))
+      << "serializing executable cache";
+  auto status = file_io::SetFileContents(
+      cache_file,
+      std::string(reinterpret_cast<const char*>(cache_data.data),
+                  cache_data.data_length));
+  if (cache_data.data) {
+    iree_allocator_free(IREE_ALLOCATOR_SYSTEM, cache_data.data);
+  }
+  return status;
+}
+
 Status Run() {
   RETURN_IF_ERROR(FromApiStatus(iree_hal_module_register_types(), IREE_LOC))
       << "registering HAL types";
@@ -77,7 +134,16 @@ Status Run() {
   iree_hal_device_t* device = nullptr;
   RETURN_IF_ERROR(CreateDevice(absl::GetFlag(FLAGS_driver), &device));
   iree_vm_module_t* hal_module = nullptr;
-  RETURN_IF_ERROR(CreateHalModule(device, &hal_module));
+  iree_hal_executable_cache_t* executable_cache = nullptr;
+  std::string executable_cache_file =
+      absl::GetFlag(FLAGS_executable_cache_file);
+  if (executable_cache_file.empty()) {
+    RETURN_IF_ERROR(CreateHalModule(device, &hal_module));
+  } else {
+    ASSIGN_OR_RETURN(executable_cache,
+                     LoadExecutableCache(device, executable_cache_file));
+    RETURN_IF_ERROR(CreateHalModule(device, executable_cache, &hal_module));
+  }
 
   iree_vm_context_t* context = nullptr;
   // Order matters. The input module will likely be dependent on the hal module.
@@ -123,6 +189,14 @@ Status Run() {
   RETURN_IF_ERROR(PrintVariantList(output_descs, outputs))
       << "printing results";
 
+  if (executable_cache) {
+    RETURN_IF_ERROR(
+        SaveExecutableCache(executable_cache, executable_cache_file))
+        << "saving executable cache to '" << executable_cache_file << "'";
+    RETURN_IF_ERROR(FromApiStatus(
+        iree_hal_executable_cache_release(executable_cache), IREE_LOC));
+  }
+
   // TODO(gcmn): Some nice wrappers to make this pattern shorter with generated
   // error messages.
   // Deallocate:
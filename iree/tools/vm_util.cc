@@ -16,6 +16,7 @@
 
 #include <ostream>
 
+#include "absl/flags/flag.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
@@ -33,6 +34,11 @@
 #include "iree/vm/module.h"
 #include "iree/vm/variant_list.h"
 
+ABSL_FLAG(bool, async_executable_preparation, false,
+          "Prepares the executables of a module concurrently on a pool of "
+          "worker threads instead of one at a time while initializing the "
+          "module. Executables block at first dispatch until ready.");
+
 namespace iree {
 
 Status ValidateFunctionAbi(const iree_vm_function_t& function) {
@@ -320,8 +326,20 @@ Status CreateDevice(absl::string_view driver_name,
 
 Status CreateHalModule(iree_hal_device_t* device,
                        iree_vm_module_t** out_module) {
+  return CreateHalModule(device, /*executable_cache=*/nullptr, out_module);
+}
+
+Status CreateHalModule(iree_hal_device_t* device,
+                       iree_hal_executable_cache_t* executable_cache,
+                       iree_vm_module_t** out_module) {
+  iree_hal_module_options_t options;
+  iree_hal_module_options_initialize(&options);
+  options.executable_cache = executable_cache;
+  options.async_executable_preparation =
+      absl::GetFlag(FLAGS_async_executable_preparation);
   RETURN_IF_ERROR(FromApiStatus(
-      iree_hal_module_create(device, IREE_ALLOCATOR_SYSTEM, out_module),
+      iree_hal_module_create_with_options(device, &options,
+                                          IREE_ALLOCATOR_SYSTEM, out_module),
       IREE_LOC))
       << "Creating HAL module";
   return OkStatus();
@@ -73,10 +73,19 @@ Status CreateDevice(absl::string_view driver_name,
                     iree_hal_device_t** out_device);
 
 // Creates a hal module |driver| in |out_hal_module|.
+// Executables are prepared asynchronously if --async_executable_preparation
+// is set.
 // The returned |out_module| must be released by the caller.
 Status CreateHalModule(iree_hal_device_t* device,
                        iree_vm_module_t** out_module);
 
+// Creates a hal module as with CreateHalModule that prepares all executables
+// using |executable_cache|, which may be null to create a new cache.
+// The returned |out_module| must be released by the caller.
+Status CreateHalModule(iree_hal_device_t* device,
+                       iree_hal_executable_cache_t* executable_cache,
+                       iree_vm_module_t** out_module);
+
 // Loads a VM bytecode from an opaque string.
 // The returned |out_module| must be released by the caller.
 Status LoadBytecodeModule(absl::string_view module_data,
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <assert.h>
+#include <math.h>
 #include <string.h>
 
 #include "iree/base/alignment.h"
@@ -35,44 +36,141 @@
 #define IREE_DISPATCH_LOG_CALL(...)
 #endif  // IREE_DISPATCH_LOGGING
 
+#if IREE_VM_PROFILING_ENABLE
+
+// Charges the time elapsed since |*last_time_ns| to the exclusive time of the
+// function executing in |frame|.
+static void iree_vm_bytecode_dispatch_profile_charge(
+    iree_vm_bytecode_module_t* module, iree_vm_stack_frame_t* frame,
+    int64_t* last_time_ns) {
+  int64_t now_ns = iree_vm_bytecode_profile_now_ns();
+  module->profile->functions[frame->function.ordinal].exclusive_time_ns +=
+      now_ns - *last_time_ns;
+  *last_time_ns = now_ns;
+}
+
+// Records entering the function in |frame| at |time_ns|.
+static void iree_vm_bytecode_dispatch_profile_enter(
+    iree_vm_bytecode_module_t* module, iree_vm_stack_frame_t* frame,
+    int64_t time_ns) {
+  ++module->profile->functions[frame->function.ordinal].call_count;
+  frame->profile_enter_time_ns = time_ns;
+}
+
+// Records returning from the function in |frame| at |time_ns|.
+static void iree_vm_bytecode_dispatch_profile_leave(
+    iree_vm_bytecode_module_t* module, iree_vm_stack_frame_t* frame,
+    int64_t time_ns) {
+  module->profile->functions[frame->function.ordinal].inclusive_time_ns +=
+      time_ns - frame->profile_enter_time_ns;
+}
+
+// Charges the time elapsed since |*last_time_ns| to the import |ordinal|.
+static void iree_vm_bytecode_dispatch_profile_import(
+    iree_vm_bytecode_module_t* module, int32_t ordinal, int64_t* last_time_ns) {
+  int64_t now_ns = iree_vm_bytecode_profile_now_ns();
+  iree_vm_bytecode_import_counters_t* counters =
+      &module->profile->imports[ordinal];
+  ++counters->call_count;
+  counters->time_ns += now_ns - *last_time_ns;
+  *last_time_ns = now_ns;
+}
+
+// Counts the execution of each opcode.
+#define IREE_DISPATCH_PROFILE_OPCODE(op_name) \
+  ++module->profile->opcode_counts[IREE_VM_OP_##op_name]
+// Charges the time since the last profiling event to the current function.
+// Called before leaving the bytecode of the current function for any reason.
+#define IREE_DISPATCH_PROFILE_CHARGE()                            \
+  iree_vm_bytecode_dispatch_profile_charge(module, current_frame, \
+                                           &profile_time_ns)
+// Records entering the function in |frame| at the last profiling event.
+#define IREE_DISPATCH_PROFILE_ENTER(frame) \
+  iree_vm_bytecode_dispatch_profile_enter(module, frame, profile_time_ns)
+// Records returning from the function in |frame| at the last profiling event.
+#define IREE_DISPATCH_PROFILE_LEAVE(frame) \
+  iree_vm_bytecode_dispatch_profile_leave(module, frame, profile_time_ns)
+// Records a call to the import |ordinal| that began at the last event.
+#define IREE_DISPATCH_PROFILE_IMPORT(ordinal) \
+  iree_vm_bytecode_dispatch_profile_import(module, ordinal, &profile_time_ns)
+// Restarts timing after work that is not attributed to any function.
+#define IREE_DISPATCH_PROFILE_RESTART() \
+  profile_time_ns = iree_vm_bytecode_profile_now_ns()
+
+#else
+#define IREE_DISPATCH_PROFILE_OPCODE(...)
+#define IREE_DISPATCH_PROFILE_CHARGE(...)
+#define IREE_DISPATCH_PROFILE_ENTER(...)
+#define IREE_DISPATCH_PROFILE_LEAVE(...)
+#define IREE_DISPATCH_PROFILE_IMPORT(...)
+#define IREE_DISPATCH_PROFILE_RESTART(...)
+#endif  // IREE_VM_PROFILING_ENABLE
+
 #if defined(IREE_COMPILER_MSVC) && !defined(IREE_COMPILER_CLANG)
 #define IREE_DISPATCH_MODE_SWITCH 1
 #else
 #define IREE_DISPATCH_MODE_COMPUTED_GOTO 1
 #endif  // MSVC
 
+// All function bytecode is verified when the module is loaded (see
+// bytecode_verifier.c) and the dispatcher trusts the static operands of each
+// instruction: opcodes, register ordinals, branch targets, and global, rodata,
+// type, and function ordinals. Those invariants are only asserted with VMCHECK
+// in debug builds. Operands read from registers at runtime (such as indirect
+// global offsets) are still checked.
 #ifndef NDEBUG
 #define VMCHECK(expr) assert(expr)
 #else
 #define VMCHECK(expr)
 #endif  // NDEBUG
 
-// Remaps argument registers from a source list to the 0-N ABI registers.
+// Copies the i64 register pair |src_reg| to |dst_reg|.
+static inline void iree_vm_bytecode_dispatch_copy_i64(
+    const iree_vm_registers_t* src_regs, uint16_t src_reg,
+    iree_vm_registers_t* dst_regs, uint16_t dst_reg) {
+  *(int64_t*)&dst_regs->i32[dst_reg & IREE_I64_REGISTER_MASK] =
+      *(const int64_t*)&src_regs->i32[src_reg & IREE_I64_REGISTER_MASK];
+}
+
+// Reserves the registers of an import |callee_frame| needed to receive the
+// arguments remapped by iree_vm_bytecode_dispatch_remap_argument_registers.
+// Imports reserve any additional registers they need for their results.
+static iree_status_t iree_vm_bytecode_dispatch_reserve_argument_registers(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame,
+    const iree_vm_register_remap_list_t* i32_remap_list,
+    const iree_vm_register_list_t* ref_reg_list) {
+  int32_t i32_register_count = 0;
+  for (int i = 0; i < i32_remap_list->size; ++i) {
+    int32_t dst_reg = i32_remap_list->pairs[i].dst_reg & IREE_I32_REGISTER_MASK;
+    if (dst_reg >= i32_register_count) i32_register_count = dst_reg + 1;
+  }
+  return iree_vm_stack_frame_reserve_registers(
+      stack, callee_frame, i32_register_count, ref_reg_list->size);
+}
+
+// Remaps argument registers to the 0-N ABI registers of the callee.
+// Primitive registers are remapped to the destinations computed by the
+// compiler (with i64 pairs split into two i32 registers) and ref registers
+// are left-aligned in the order they are listed.
 static void iree_vm_bytecode_dispatch_remap_argument_registers(
-    iree_vm_registers_t* src_regs, const iree_vm_register_list_t* src_reg_list,
+    iree_vm_registers_t* src_regs,
+    const iree_vm_register_remap_list_t* i32_remap_list,
+    const iree_vm_register_list_t* ref_reg_list,
     iree_vm_registers_t* dst_regs) {
-  // Each bank begins left-aligned at 0 and increments per arg of its type.
-  int i32_reg_offset = 0;
-  int ref_reg_offset = 0;
-  for (int i = 0; i < src_reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = src_reg_list->registers[i];
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      uint16_t dst_reg = ref_reg_offset++;
-      memset(&dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK], 0,
-             sizeof(iree_vm_ref_t));
-      iree_vm_ref_retain_or_move(
-          src_reg & IREE_REF_REGISTER_MOVE_BIT,
-          &src_regs->ref[src_reg & IREE_REF_REGISTER_MASK],
-          &dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
-    } else {
-      uint16_t dst_reg = i32_reg_offset++;
-      dst_regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
-          src_regs->i32[src_reg & IREE_I32_REGISTER_MASK];
-    }
+  for (int i = 0; i < i32_remap_list->size; ++i) {
+    uint16_t src_reg = i32_remap_list->pairs[i].src_reg;
+    uint16_t dst_reg = i32_remap_list->pairs[i].dst_reg;
+    dst_regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
+        src_regs->i32[src_reg & IREE_I32_REGISTER_MASK];
   }
-  dst_regs->ref_register_count = ref_reg_offset;
+  for (int i = 0; i < ref_reg_list->size; ++i) {
+    uint16_t src_reg = ref_reg_list->registers[i];
+    memset(&dst_regs->ref[i], 0, sizeof(iree_vm_ref_t));
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &src_regs->ref[src_reg & IREE_REF_REGISTER_MASK],
+                               &dst_regs->ref[i]);
+  }
+  dst_regs->ref_register_count = ref_reg_list->size;
 }
 
 // Remaps registers from source to destination, possibly across frames.
@@ -91,6 +189,8 @@ static void iree_vm_bytecode_dispatch_remap_registers(
           src_reg & IREE_REF_REGISTER_MOVE_BIT,
           &src_regs->ref[src_reg & IREE_REF_REGISTER_MASK],
           &dst_regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
+    } else if (src_reg & IREE_I64_REGISTER_BIT) {
+      iree_vm_bytecode_dispatch_copy_i64(src_regs, src_reg, dst_regs, dst_reg);
     } else {
       dst_regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
           src_regs->i32[src_reg & IREE_I32_REGISTER_MASK];
@@ -111,38 +211,25 @@ static void iree_vm_bytecode_dispatch_discard_registers(
   }
 }
 
-// Interleaved src-dst register sets.
-// This structure is an overlay for the bytecode that is serialized in a
-// matching format.
-typedef struct {
-  uint16_t size;
-  struct pair {
-    uint16_t src_reg;
-    uint16_t dst_reg;
-  } pairs[];
-} iree_vm_register_remap_list_t;
-static_assert(iree_alignof(iree_vm_register_remap_list_t) == 2,
-              "Expecting byte alignment (to avoid padding)");
-static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
-              "Expect no padding in the struct");
-
 // Remaps registers from a source set to a destination set within the frame.
+// Primitive and ref registers are remapped from separate lists in the order
+// specified by the compiler to resolve any hazards.
 static void iree_vm_bytecode_dispatch_remap_branch_registers(
     iree_vm_registers_t* regs,
-    const iree_vm_register_remap_list_t* remap_list) {
-  for (int i = 0; i < remap_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = remap_list->pairs[i].src_reg;
-    uint16_t dst_reg = remap_list->pairs[i].dst_reg;
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
-                                 &regs->ref[src_reg & IREE_REF_REGISTER_MASK],
-                                 &regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
-    } else {
-      regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
-          regs->i32[src_reg & IREE_I32_REGISTER_MASK];
-    }
+    const iree_vm_register_remap_list_t* i32_remap_list,
+    const iree_vm_register_remap_list_t* ref_remap_list) {
+  for (int i = 0; i < i32_remap_list->size; ++i) {
+    uint16_t src_reg = i32_remap_list->pairs[i].src_reg;
+    uint16_t dst_reg = i32_remap_list->pairs[i].dst_reg;
+    regs->i32[dst_reg & IREE_I32_REGISTER_MASK] =
+        regs->i32[src_reg & IREE_I32_REGISTER_MASK];
+  }
+  for (int i = 0; i < ref_remap_list->size; ++i) {
+    uint16_t src_reg = ref_remap_list->pairs[i].src_reg;
+    uint16_t dst_reg = ref_remap_list->pairs[i].dst_reg;
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &regs->ref[src_reg & IREE_REF_REGISTER_MASK],
+                               &regs->ref[dst_reg & IREE_REF_REGISTER_MASK]);
   }
 }
 
@@ -184,6 +271,7 @@ iree_status_t iree_vm_bytecode_dispatch(
 
 #define DISPATCH_OP(op_name, body)                          \
   _dispatch_##op_name : IREE_DISPATCH_LOG_OPCODE(#op_name); \
+  IREE_DISPATCH_PROFILE_OPCODE(op_name);                    \
   body;                                                     \
   goto* kDispatchTable[bytecode_data[pc++]];
 
@@ -203,10 +291,11 @@ iree_status_t iree_vm_bytecode_dispatch(
     VMCHECK(0);              \
     return IREE_STATUS_UNIMPLEMENTED;
 
-#define DISPATCH_OP(op_name, body)      \
-  case IREE_VM_OP_##op_name:            \
-    IREE_DISPATCH_LOG_OPCODE(#op_name); \
-    body;                               \
+#define DISPATCH_OP(op_name, body)         \
+  case IREE_VM_OP_##op_name:               \
+    IREE_DISPATCH_LOG_OPCODE(#op_name);    \
+    IREE_DISPATCH_PROFILE_OPCODE(op_name); \
+    body;                                  \
     break;
 
 #endif  // IREE_DISPATCH_MODE_COMPUTED_GOTO
@@ -217,6 +306,7 @@ iree_status_t iree_vm_bytecode_dispatch(
 #define OP_I8(i) bytecode_data[pc + i]
 #define OP_I16(i) *((uint16_t*)&bytecode_data[pc + i])
 #define OP_I32(i) *((uint32_t*)&bytecode_data[pc + i])
+#define OP_I64(i) *((uint64_t*)&bytecode_data[pc + i])
 #else
 #define OP_I8(i) bytecode_data[pc + i]
 #define OP_I16(i)                         \
@@ -227,12 +317,44 @@ iree_status_t iree_vm_bytecode_dispatch(
       ((uint32_t)bytecode_data[pc + 1 + i] << 8) |  \
       ((uint32_t)bytecode_data[pc + 2 + i] << 16) | \
       ((uint32_t)bytecode_data[pc + 3 + i] << 24)
+#define OP_I64(i) \
+  ((uint64_t)(OP_I32(i)) | ((uint64_t)(OP_I32(i + 4)) << 32))
 #endif  // IREE_IS_LITTLE_ENDIAN
 
 #define OP_R_I32(i) regs->i32[OP_I16(i) & IREE_I32_REGISTER_MASK]
+#define OP_R_I64(i) \
+  *((int64_t*)&regs->i32[OP_I16(i) & IREE_I64_REGISTER_MASK])
+#define OP_R_F32(i) *((float*)&regs->i32[OP_I16(i) & IREE_I32_REGISTER_MASK])
 #define OP_R_REF(i) regs->ref[OP_I16(i) & IREE_REF_REGISTER_MASK]
 #define OP_R_REF_IS_MOVE(i) (OP_I16(i) & IREE_REF_REGISTER_MOVE_BIT)
 
+  // Branches are encoded as the target block pc followed by the primitive and
+  // ref register remapping lists:
+  //   [i32 block pc][i32 remap list][ref remap list]
+  // TAKE_BRANCH remaps the registers and jumps to the target block while
+  // SKIP_BRANCH advances the pc past the branch.
+#define TAKE_BRANCH()                                                         \
+  {                                                                           \
+    int32_t block_pc = OP_I32(0);                                             \
+    const iree_vm_register_remap_list_t* i32_remap_list =                     \
+        (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];         \
+    const iree_vm_register_remap_list_t* ref_remap_list =                     \
+        (const iree_vm_register_remap_list_t*)&bytecode_data                  \
+            [pc + 4 + kRegSize + i32_remap_list->size * 2 * kRegSize];        \
+    iree_vm_bytecode_dispatch_remap_branch_registers(regs, i32_remap_list,    \
+                                                     ref_remap_list);         \
+    pc = block_pc;                                                            \
+  }
+#define SKIP_BRANCH()                                                         \
+  {                                                                           \
+    const iree_vm_register_remap_list_t* i32_remap_list =                     \
+        (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];         \
+    pc += 4 + kRegSize + i32_remap_list->size * 2 * kRegSize;                 \
+    const iree_vm_register_remap_list_t* ref_remap_list =                     \
+        (const iree_vm_register_remap_list_t*)&bytecode_data[pc];             \
+    pc += kRegSize + ref_remap_list->size * 2 * kRegSize;                     \
+  }
+
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
   // offset) faster. You can think of this like CPU state (like PC).
@@ -242,16 +364,59 @@ iree_status_t iree_vm_bytecode_dispatch(
   // as we call into different functions.
   const iree_vm_function_descriptor_t* entry_function_descriptor =
       &module->function_descriptor_table[entry_frame->function.ordinal];
-  iree_vm_stack_frame_t* current_frame = entry_frame;
-  const uint8_t* bytecode_data =
-      module->bytecode_data.data + entry_function_descriptor->bytecode_offset;
-  iree_vm_source_offset_t pc = current_frame->pc;
-  iree_vm_registers_t* regs = &current_frame->registers;
   // TODO(benvanik): hide this register initialization logic in the stack enter.
-  regs->ref_register_count = entry_function_descriptor->ref_register_count;
+  entry_frame->registers.ref_register_count =
+      entry_function_descriptor->ref_register_count;
 
   memset(out_result, 0, sizeof(*out_result));
 
+#if IREE_VM_PROFILING_ENABLE
+  // Timestamp of the last profiling event (entering or leaving bytecode).
+  int64_t profile_time_ns = iree_vm_bytecode_profile_now_ns();
+#endif  // IREE_VM_PROFILING_ENABLE
+
+  // If execution previously suspended then frames above the entry frame are
+  // still on the stack. Internal calls are executed inline by this loop so we
+  // resume within the deepest frame of this module, though if that frame
+  // was suspended within an import call the import must complete first.
+  iree_vm_stack_frame_t* current_frame = iree_vm_stack_current_frame(stack);
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  for (iree_vm_stack_frame_t* frame = current_frame; frame != entry_frame;
+       frame = frame->parent) {
+    if (frame->function.module != &module->interface) {
+      callee_frame = frame;
+      current_frame = frame->parent;
+    }
+  }
+  if (callee_frame) {
+    iree_status_t call_status = callee_frame->function.module->execute(
+        callee_frame->function.module->self, stack, callee_frame, out_result);
+    IREE_DISPATCH_PROFILE_RESTART();
+    if (!iree_status_is_ok(call_status)) {
+      return call_status;
+    } else if (out_result->wait_type != IREE_VM_WAIT_NONE) {
+      return IREE_STATUS_OK;
+    }
+    if (callee_frame->return_registers) {
+      iree_vm_bytecode_dispatch_remap_registers(
+          &callee_frame->registers, callee_frame->return_registers,
+          &current_frame->registers, current_frame->return_registers);
+    }
+    iree_vm_stack_function_leave(stack);
+  }
+  const uint8_t* bytecode_data =
+      module->bytecode_data.data +
+      module->function_descriptor_table[current_frame->function.ordinal]
+          .bytecode_offset;
+  iree_vm_source_offset_t pc = current_frame->pc;
+#if IREE_VM_PROFILING_ENABLE
+  if (current_frame == entry_frame && pc == 0) {
+    // First execution of the entry function (vs. resuming it).
+    IREE_DISPATCH_PROFILE_ENTER(entry_frame);
+  }
+#endif  // IREE_VM_PROFILING_ENABLE
+  iree_vm_registers_t* regs = &current_frame->registers;
+
   // NOTE: we should generate this with tblgen, as it has the encoding info.
   // TODO(benvanik): at least generate operand reading/writing and sizes.
   // This could look something like:
@@ -270,10 +435,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncResult<"value">,
       // ];
       int byte_offset = OP_I32(0);
-      if (byte_offset < 0 ||
-          byte_offset >= module_state->rwdata_storage.data_length) {
-        return IREE_STATUS_OUT_OF_RANGE;
-      }
+      VMCHECK(byte_offset + sizeof(int32_t) <=
+              module_state->rwdata_storage.data_length);
       const int32_t* global_ptr =
           (const int32_t*)(module_state->rwdata_storage.data + byte_offset);
       OP_R_I32(4) = *global_ptr;
@@ -286,10 +449,65 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOperand<"value", 0>,
       // ];
       int byte_offset = OP_I32(0);
-      if (byte_offset < 0 ||
-          byte_offset >= module_state->rwdata_storage.data_length) {
-        return IREE_STATUS_OUT_OF_RANGE;
-      }
+      VMCHECK(byte_offset + sizeof(int32_t) <=
+              module_state->rwdata_storage.data_length);
+      int32_t* global_ptr =
+          (int32_t*)(module_state->rwdata_storage.data + byte_offset);
+      *global_ptr = OP_R_I32(4);
+      pc += 4 + kRegSize;
+    });
+    DISPATCH_OP(GlobalLoadI64, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_GlobalLoadI64>,
+      //   VM_EncGlobalAttr<"global">,
+      //   VM_EncResult<"value">,
+      // ];
+      int byte_offset = OP_I32(0);
+      VMCHECK(byte_offset + sizeof(int64_t) <=
+              module_state->rwdata_storage.data_length);
+      const int64_t* global_ptr =
+          (const int64_t*)(module_state->rwdata_storage.data + byte_offset);
+      OP_R_I64(4) = *global_ptr;
+      pc += 4 + kRegSize;
+    });
+    DISPATCH_OP(GlobalStoreI64, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_GlobalStoreI64>,
+      //   VM_EncGlobalAttr<"global">,
+      //   VM_EncOperand<"value", 0>,
+      // ];
+      int byte_offset = OP_I32(0);
+      VMCHECK(byte_offset + sizeof(int64_t) <=
+              module_state->rwdata_storage.data_length);
+      int64_t* global_ptr =
+          (int64_t*)(module_state->rwdata_storage.data + byte_offset);
+      *global_ptr = OP_R_I64(4);
+      pc += 4 + kRegSize;
+    });
+    DISPATCH_OP(GlobalLoadF32, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_GlobalLoadF32>,
+      //   VM_EncGlobalAttr<"global">,
+      //   VM_EncResult<"value">,
+      // ];
+      // f32 values are stored bitwise so this is identical to GlobalLoadI32.
+      int byte_offset = OP_I32(0);
+      VMCHECK(byte_offset + sizeof(float) <=
+              module_state->rwdata_storage.data_length);
+      const int32_t* global_ptr =
+          (const int32_t*)(module_state->rwdata_storage.data + byte_offset);
+      OP_R_I32(4) = *global_ptr;
+      pc += 4 + kRegSize;
+    });
+    DISPATCH_OP(GlobalStoreF32, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_GlobalStoreF32>,
+      //   VM_EncGlobalAttr<"global">,
+      //   VM_EncOperand<"value", 0>,
+      // ];
+      int byte_offset = OP_I32(0);
+      VMCHECK(byte_offset + sizeof(float) <=
+              module_state->rwdata_storage.data_length);
       int32_t* global_ptr =
           (int32_t*)(module_state->rwdata_storage.data + byte_offset);
       *global_ptr = OP_R_I32(4);
@@ -303,8 +521,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncResult<"value">,
       // ];
       int byte_offset = OP_R_I32(0);
-      if (byte_offset < 0 ||
-          byte_offset >= module_state->rwdata_storage.data_length) {
+      if (byte_offset < 0 || byte_offset + sizeof(int32_t) >
+                                 module_state->rwdata_storage.data_length) {
         return IREE_STATUS_OUT_OF_RANGE;
       }
       const int32_t* global_ptr =
@@ -319,8 +537,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOperand<"value", 1>,
       // ];
       int byte_offset = OP_R_I32(0);
-      if (byte_offset < 0 ||
-          byte_offset >= module_state->rwdata_storage.data_length) {
+      if (byte_offset < 0 || byte_offset + sizeof(int32_t) >
+                                 module_state->rwdata_storage.data_length) {
         return IREE_STATUS_OUT_OF_RANGE;
       }
       int32_t* global_ptr =
@@ -337,11 +555,9 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncResult<"value">,
       // ];
       int global = OP_I32(0);
-      if (global < 0 || global >= module_state->global_ref_count) {
-        return IREE_STATUS_OUT_OF_RANGE;
-      }
+      VMCHECK(global < module_state->global_ref_count);
       int type_id = OP_I32(4);
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       iree_vm_ref_t* global_ref = &module_state->global_ref_table[global];
       iree_vm_ref_retain_or_move_checked(OP_R_REF_IS_MOVE(8), global_ref,
@@ -356,11 +572,9 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOperand<"value", 0>,
       // ];
       int global = OP_I32(0);
-      if (global < 0 || global >= module_state->global_ref_count) {
-        return IREE_STATUS_OUT_OF_RANGE;
-      }
+      VMCHECK(global < module_state->global_ref_count);
       int type_id = OP_I32(4);
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       iree_vm_ref_t* global_ref = &module_state->global_ref_table[global];
       iree_vm_ref_retain_or_move_checked(OP_R_REF_IS_MOVE(8), &OP_R_REF(8),
@@ -380,7 +594,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         return IREE_STATUS_OUT_OF_RANGE;
       }
       int type_id = OP_I32(2);
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       iree_vm_ref_t* global_ref = &module_state->global_ref_table[global];
       iree_vm_ref_retain_or_move_checked(OP_R_REF_IS_MOVE(6), global_ref,
@@ -399,7 +613,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         return IREE_STATUS_OUT_OF_RANGE;
       }
       int type_id = OP_I32(2);
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       iree_vm_ref_t* global_ref = &module_state->global_ref_table[global];
       iree_vm_ref_retain_or_move_checked(OP_R_REF_IS_MOVE(6), &OP_R_REF(6),
@@ -421,6 +635,27 @@ iree_status_t iree_vm_bytecode_dispatch(
       pc += 4 + kRegSize;
     });
 
+    DISPATCH_OP(ConstI64, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncIntAttr<"value", type.bitwidth>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64(8) = (int64_t)OP_I64(0);
+      pc += 8 + kRegSize;
+    });
+
+    DISPATCH_OP(ConstF32, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncFloatAttr<"value", type.bitwidth>,
+      //   VM_EncResult<"result">,
+      // ];
+      // The value is encoded as its IEEE bit pattern which is how we store it.
+      OP_R_I32(4) = OP_I32(0);
+      pc += 4 + kRegSize;
+    });
+
     DISPATCH_OP(ConstI32Zero, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_ConstI32Zero>,
@@ -430,6 +665,24 @@ iree_status_t iree_vm_bytecode_dispatch(
       pc += kRegSize;
     });
 
+    DISPATCH_OP(ConstI64Zero, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_ConstI64Zero>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64(0) = 0;
+      pc += kRegSize;
+    });
+
+    DISPATCH_OP(ConstF32Zero, {
+      // let encoding = [
+      //   VM_EncOpcode<VM_OPC_ConstF32Zero>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_F32(0) = 0.0f;
+      pc += kRegSize;
+    });
+
     DISPATCH_OP(ConstRefZero, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_ConstRefZero>,
@@ -468,6 +721,31 @@ iree_status_t iree_vm_bytecode_dispatch(
       pc += kRegSize + kRegSize + kRegSize + kRegSize;
     });
 
+    DISPATCH_OP(SelectI64, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncOperand<"condition", 0>,
+      //   VM_EncOperand<"true_value", 1>,
+      //   VM_EncOperand<"false_value", 2>,
+      //   VM_EncResult<"result">,
+      // ];
+      OP_R_I64(6) = OP_R_I32(0) ? OP_R_I64(2) : OP_R_I64(4);
+      pc += kRegSize + kRegSize + kRegSize + kRegSize;
+    });
+
+    DISPATCH_OP(SelectF32, {
+      // let encoding = [
+      //   VM_EncOpcode<opcode>,
+      //   VM_EncOperand<"condition", 0>,
+      //   VM_EncOperand<"true_value", 1>,
+      //   VM_EncOperand<"false_value", 2>,
+      //   VM_EncResult<"result">,
+      // ];
+      // f32 values are stored bitwise so this is identical to SelectI32.
+      OP_R_I32(6) = OP_R_I32(0) ? OP_R_I32(2) : OP_R_I32(4);
+      pc += kRegSize + kRegSize + kRegSize + kRegSize;
+    });
+
     DISPATCH_OP(SelectRef, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_SelectRef>,
@@ -480,7 +758,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       // TODO(benvanik): remove the type_id and use either LHS/RHS (if both are
       // null then output is always null so no need to know the type).
       int type_id = OP_I32(2);
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       if (OP_R_I32(0)) {
         // Select LHS (+6).
@@ -544,7 +822,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       }
       iree_vm_ref_t* result_reg = &OP_R_REF(0);
       pc += kRegSize;
-      type_id = type_id >= module->type_count ? 0 : type_id;
+      VMCHECK(type_id < module->type_count);
       const iree_vm_type_def_t* type_def = &module->type_table[type_id];
       iree_vm_ref_retain_or_move_checked(is_move, new_value, type_def->ref_type,
                                          result_reg);
@@ -589,6 +867,85 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_BINARY_ALU_I32(OrI32, uint32_t, |);
     DISPATCH_OP_BINARY_ALU_I32(XorI32, uint32_t, ^);
 
+    // Fused const+op selected by the bytecode encoder when a constant operand
+    // can be inlined as an immediate. Commutative ops may have had their
+    // operands swapped to place the constant in the immediate.
+    //   [opcode][operand reg][i32 immediate][result reg]
+#define DISPATCH_OP_BINARY_ALU_I32_IMM(op_name, type, op)             \
+  DISPATCH_OP(op_name, {                                              \
+    OP_R_I32(6) = (int32_t)(((type)OP_R_I32(0))op((type)OP_I32(2))); \
+    pc += kRegSize + 4 + kRegSize;                                    \
+  });
+
+    DISPATCH_OP_BINARY_ALU_I32_IMM(AddI32Imm, int32_t, +);
+    DISPATCH_OP_BINARY_ALU_I32_IMM(SubI32Imm, int32_t, -);
+    DISPATCH_OP_BINARY_ALU_I32_IMM(MulI32Imm, int32_t, *);
+    DISPATCH_OP_BINARY_ALU_I32_IMM(AndI32Imm, uint32_t, &);
+    DISPATCH_OP_BINARY_ALU_I32_IMM(OrI32Imm, uint32_t, |);
+    DISPATCH_OP_BINARY_ALU_I32_IMM(XorI32Imm, uint32_t, ^);
+
+#define DISPATCH_OP_UNARY_ALU_I64(op_name, type, op) \
+  DISPATCH_OP(op_name, {                             \
+    OP_R_I64(2) = (int64_t)(op((type)OP_R_I64(0)));  \
+    pc += kRegSize + kRegSize;                       \
+  });
+
+#define DISPATCH_OP_BINARY_ALU_I64(op_name, type, op)                  \
+  DISPATCH_OP(op_name, {                                               \
+    OP_R_I64(4) = (int64_t)(((type)OP_R_I64(0))op((type)OP_R_I64(2))); \
+    pc += kRegSize + kRegSize + kRegSize;                              \
+  });
+
+    DISPATCH_OP_BINARY_ALU_I64(AddI64, int64_t, +);
+    DISPATCH_OP_BINARY_ALU_I64(SubI64, int64_t, -);
+    DISPATCH_OP_BINARY_ALU_I64(MulI64, int64_t, *);
+    DISPATCH_OP_BINARY_ALU_I64(DivI64S, int64_t, /);
+    DISPATCH_OP_BINARY_ALU_I64(DivI64U, uint64_t, /);
+    DISPATCH_OP_BINARY_ALU_I64(RemI64S, int64_t, %);
+    DISPATCH_OP_BINARY_ALU_I64(RemI64U, uint64_t, %);
+    DISPATCH_OP_UNARY_ALU_I64(NotI64, uint64_t, ~);
+    DISPATCH_OP_BINARY_ALU_I64(AndI64, uint64_t, &);
+    DISPATCH_OP_BINARY_ALU_I64(OrI64, uint64_t, |);
+    DISPATCH_OP_BINARY_ALU_I64(XorI64, uint64_t, ^);
+
+    //===------------------------------------------------------------------===//
+    // Native floating-point arithmetic
+    //===------------------------------------------------------------------===//
+
+    // let encoding = [
+    //   VM_EncOpcode<opcode>,
+    //   VM_EncOperand<"operand", 0>,
+    //   VM_EncResult<"result">,
+    // ];
+#define DISPATCH_OP_UNARY_ALU_F32(op_name, fn) \
+  DISPATCH_OP(op_name, {                       \
+    OP_R_F32(2) = fn(OP_R_F32(0));             \
+    pc += kRegSize + kRegSize;                 \
+  });
+
+    // let encoding = [
+    //   VM_EncOpcode<opcode>,
+    //   VM_EncOperand<"lhs", 0>,
+    //   VM_EncOperand<"rhs", 1>,
+    //   VM_EncResult<"result">,
+    // ];
+#define DISPATCH_OP_BINARY_ALU_F32(op_name, op) \
+  DISPATCH_OP(op_name, {                        \
+    OP_R_F32(4) = OP_R_F32(0) op OP_R_F32(2);   \
+    pc += kRegSize + kRegSize + kRegSize;       \
+  });
+
+    DISPATCH_OP_BINARY_ALU_F32(AddF32, +);
+    DISPATCH_OP_BINARY_ALU_F32(SubF32, -);
+    DISPATCH_OP_BINARY_ALU_F32(MulF32, *);
+    DISPATCH_OP_BINARY_ALU_F32(DivF32, /);
+    DISPATCH_OP(RemF32, {
+      OP_R_F32(4) = fmodf(OP_R_F32(0), OP_R_F32(2));
+      pc += kRegSize + kRegSize + kRegSize;
+    });
+    DISPATCH_OP_UNARY_ALU_F32(AbsF32, fabsf);
+    DISPATCH_OP_UNARY_ALU_F32(NegF32, -);
+
     //===------------------------------------------------------------------===//
     // Casting and type conversion/emulation
     //===------------------------------------------------------------------===//
@@ -609,6 +966,35 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_CAST_I32(ExtI8I32S, int8_t, int32_t);
     DISPATCH_OP_CAST_I32(ExtI16I32S, int16_t, int32_t);
 
+    DISPATCH_OP(TruncI64I32, {
+      OP_R_I32(2) = (int32_t)OP_R_I64(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(ExtI32I64S, {
+      OP_R_I64(2) = (int64_t)OP_R_I32(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(ExtI32I64U, {
+      OP_R_I64(2) = (int64_t)(uint32_t)OP_R_I32(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(CastSI32F32, {
+      OP_R_F32(2) = (float)OP_R_I32(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(CastUI32F32, {
+      OP_R_F32(2) = (float)(uint32_t)OP_R_I32(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(CastF32SI32, {
+      OP_R_I32(2) = (int32_t)OP_R_F32(0);
+      pc += kRegSize + kRegSize;
+    });
+    DISPATCH_OP(CastF32UI32, {
+      OP_R_I32(2) = (int32_t)(uint32_t)OP_R_F32(0);
+      pc += kRegSize + kRegSize;
+    });
+
     //===------------------------------------------------------------------===//
     // Native bitwise shifts and rotates
     //===------------------------------------------------------------------===//
@@ -619,16 +1005,27 @@ iree_status_t iree_vm_bytecode_dispatch(
     //   VM_EncIntAttr<"amount", type.bitwidth>,
     //   VM_EncResult<"result">,
     // ];
+    // Note that the amount is an i8 attribute and encoded as a single byte.
 #define DISPATCH_OP_SHIFT_I32(op_name, type, op)             \
   DISPATCH_OP(op_name, {                                     \
-    OP_R_I32(4) = (int32_t)(((type)OP_R_I32(0))op OP_I8(2)); \
-    pc += kRegSize + kRegSize + kRegSize;                    \
+    OP_R_I32(3) = (int32_t)(((type)OP_R_I32(0))op OP_I8(2)); \
+    pc += kRegSize + 1 + kRegSize;                           \
   });
 
     DISPATCH_OP_SHIFT_I32(ShlI32, int32_t, <<);
     DISPATCH_OP_SHIFT_I32(ShrI32S, int32_t, >>);
     DISPATCH_OP_SHIFT_I32(ShrI32U, uint32_t, >>);
 
+#define DISPATCH_OP_SHIFT_I64(op_name, type, op)             \
+  DISPATCH_OP(op_name, {                                     \
+    OP_R_I64(3) = (int64_t)(((type)OP_R_I64(0))op OP_I8(2)); \
+    pc += kRegSize + 1 + kRegSize;                           \
+  });
+
+    DISPATCH_OP_SHIFT_I64(ShlI64, int64_t, <<);
+    DISPATCH_OP_SHIFT_I64(ShrI64S, int64_t, >>);
+    DISPATCH_OP_SHIFT_I64(ShrI64U, uint64_t, >>);
+
     //===------------------------------------------------------------------===//
     // Comparison ops
     //===------------------------------------------------------------------===//
@@ -656,6 +1053,30 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP_CMP_I32(CmpGTEI32S, int32_t, >=);
     DISPATCH_OP_CMP_I32(CmpGTEI32U, uint32_t, >=);
 
+#define DISPATCH_OP_CMP_I64(op_name, type, op)                        \
+  DISPATCH_OP(op_name, {                                              \
+    OP_R_I32(4) = (((type)OP_R_I64(0))op((type)OP_R_I64(2))) ? 1 : 0; \
+    pc += kRegSize + kRegSize + kRegSize;                             \
+  });
+
+    DISPATCH_OP_CMP_I64(CmpEQI64, int64_t, ==);
+    DISPATCH_OP_CMP_I64(CmpNEI64, int64_t, !=);
+    DISPATCH_OP_CMP_I64(CmpLTI64S, int64_t, <);
+    DISPATCH_OP_CMP_I64(CmpLTI64U, uint64_t, <);
+    DISPATCH_OP_CMP_I64(CmpLTEI64S, int64_t, <=);
+    DISPATCH_OP_CMP_I64(CmpLTEI64U, uint64_t, <=);
+
+#define DISPATCH_OP_CMP_F32(op_name, op)                \
+  DISPATCH_OP(op_name, {                                \
+    OP_R_I32(4) = (OP_R_F32(0) op OP_R_F32(2)) ? 1 : 0; \
+    pc += kRegSize + kRegSize + kRegSize;               \
+  });
+
+    DISPATCH_OP_CMP_F32(CmpEQF32, ==);
+    DISPATCH_OP_CMP_F32(CmpNEF32, !=);
+    DISPATCH_OP_CMP_F32(CmpLTF32, <);
+    DISPATCH_OP_CMP_F32(CmpLTEF32, <=);
+
     DISPATCH_OP(CmpEQRef, {
       // let encoding = [
       //   VM_EncOpcode<opcode>,
@@ -701,13 +1122,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOpcode<VM_OPC_Branch>,
       //   VM_EncBranch<"dest", "operands">,
       // ];
-
-      int32_t block_pc = OP_I32(0);
-      const iree_vm_register_remap_list_t* remap_list =
-          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];
-      pc += 4 + kRegSize + remap_list->size * 2 * kRegSize;
-      pc = block_pc;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      TAKE_BRANCH();
     });
 
     DISPATCH_OP(CondBranch, {
@@ -717,48 +1132,57 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncBranch<"getTrueDest", "getTrueOperands">,
       //   VM_EncBranch<"getFalseDest", "getFalseOperands">,
       // ];
-
       int32_t cond_value = OP_R_I32(0);
-      int32_t true_block_pc = OP_I32(2);
-      const iree_vm_register_remap_list_t* true_remap_list =
-          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + kRegSize +
-                                                               4];
-      pc += kRegSize + 4 + kRegSize + true_remap_list->size * 2 * kRegSize;
-      int32_t false_block_pc = OP_I32(0);
-      const iree_vm_register_remap_list_t* false_remap_list =
-          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];
-      pc += 4 + kRegSize + false_remap_list->size * 2 * kRegSize;
-
-      if (cond_value) {
-        pc = true_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list);
-      } else {
-        pc = false_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs,
-                                                         false_remap_list);
-      }
+      pc += kRegSize;
+      if (!cond_value) SKIP_BRANCH();
+      TAKE_BRANCH();
     });
 
+    // Fused compare-and-branch selected by the bytecode encoder when a
+    // comparison is only used by the vm.cond_br following it:
+    //   [opcode][lhs reg][rhs reg][true branch][false branch]
+#define DISPATCH_OP_COND_BRANCH_I32(op_name, type, op)              \
+  DISPATCH_OP(op_name, {                                            \
+    int32_t cond_value = ((type)OP_R_I32(0))op((type)OP_R_I32(2)); \
+    pc += kRegSize + kRegSize;                                      \
+    if (!cond_value) SKIP_BRANCH();                                 \
+    TAKE_BRANCH();                                                  \
+  });
+
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchEQI32, int32_t, ==);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchNEI32, int32_t, !=);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchLTI32S, int32_t, <);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchLTI32U, uint32_t, <);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchLTEI32S, int32_t, <=);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchLTEI32U, uint32_t, <=);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchGTI32S, int32_t, >);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchGTI32U, uint32_t, >);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchGTEI32S, int32_t, >=);
+    DISPATCH_OP_COND_BRANCH_I32(CondBranchGTEI32U, uint32_t, >=);
+
     DISPATCH_OP(Call, {
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_Call>,
       //   VM_EncFuncAttr<"callee">,
-      //   VM_EncVariadicOperands<"operands">,
+      //   VM_EncCallOperands<"operands">,
       //   VM_EncVariadicResults<"results">,
       // ];
 
       // Get argument and result register lists and flush the caller frame.
       int32_t function_ordinal = OP_I32(0);
-      const iree_vm_register_list_t* src_reg_list =
-          (const iree_vm_register_list_t*)&bytecode_data[pc + 4];
-      pc += 4 + kRegSize + src_reg_list->size * kRegSize;
+      const iree_vm_register_remap_list_t* src_i32_remap_list =
+          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];
+      pc += 4 + kRegSize + src_i32_remap_list->size * 2 * kRegSize;
+      const iree_vm_register_list_t* src_ref_reg_list =
+          (const iree_vm_register_list_t*)&bytecode_data[pc];
+      pc += kRegSize + src_ref_reg_list->size * kRegSize;
       const iree_vm_register_list_t* dst_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[pc];
       current_frame->return_registers = dst_reg_list;
       pc += kRegSize + dst_reg_list->size * kRegSize;
       current_frame->pc = pc;
 
-      // NOTE: we assume validation has ensured these functions exist.
+      // NOTE: the verifier has ensured these functions exist.
       // TODO(benvanik): something more clever than just a high bit?
       iree_vm_function_t target_function;
       int is_import = (function_ordinal & 0x80000000u) != 0;
@@ -774,48 +1198,88 @@ iree_status_t iree_vm_bytecode_dispatch(
       }
 
       IREE_DISPATCH_LOG_CALL(target_function);
-
-      // Remap registers from caller to callee.
-      iree_vm_stack_frame_t* callee_frame = NULL;
-      iree_status_t enter_status =
-          iree_vm_stack_function_enter(stack, target_function, &callee_frame);
-      if (!iree_status_is_ok(enter_status)) {
-        // TODO(benvanik): set execution result to stack overflow.
-        return enter_status;
-      }
-      iree_vm_bytecode_dispatch_remap_argument_registers(
-          &current_frame->registers, src_reg_list, &callee_frame->registers);
-
-      if (is_import) {
-        // Call external function.
-        iree_status_t call_status = target_function.module->execute(
-            target_function.module->self, stack, callee_frame, out_result);
-        if (!iree_status_is_ok(call_status)) {
+      IREE_DISPATCH_PROFILE_CHARGE();
+
+      // Imports that may suspend are unavailable for direct calls and are
+      // executed in a callee frame instead.
+      iree_status_t direct_status = IREE_STATUS_UNAVAILABLE;
+      if (is_import && target_function.module->call_direct) {
+        // Call the import directly with the caller registers; no callee frame
+        // is entered and results are written straight to |dst_reg_list|.
+        iree_vm_direct_call_t call;
+        call.function = target_function;
+        call.registers = regs;
+        call.i32_argument_registers = src_i32_remap_list;
+        call.ref_argument_registers = src_ref_reg_list;
+        call.result_registers = dst_reg_list;
+        direct_status = target_function.module->call_direct(
+            target_function.module->self, stack, &call);
+        if (iree_status_is_ok(direct_status)) {
+          IREE_DISPATCH_PROFILE_IMPORT(function_ordinal & 0x7FFFFFFFu);
+        } else if (!iree_status_is_unavailable(direct_status)) {
           // TODO(benvanik): set execution result to failure/capture stack.
-          return call_status;
+          return direct_status;
+        }
+      }
+      if (iree_status_is_unavailable(direct_status)) {
+        // Remap registers from caller to callee.
+        iree_vm_stack_frame_t* callee_frame = NULL;
+        iree_status_t enter_status =
+            iree_vm_stack_function_enter(stack, target_function, &callee_frame);
+        if (iree_status_is_ok(enter_status)) {
+          if (is_import) {
+            enter_status = iree_vm_bytecode_dispatch_reserve_argument_registers(
+                stack, callee_frame, src_i32_remap_list, src_ref_reg_list);
+          } else {
+            const iree_vm_function_descriptor_t* function_descriptor =
+                &module->function_descriptor_table[function_ordinal];
+            enter_status = iree_vm_stack_frame_reserve_registers(
+                stack, callee_frame, function_descriptor->i32_register_count,
+                function_descriptor->ref_register_count);
+          }
         }
-        if (callee_frame->return_registers) {
-          iree_vm_bytecode_dispatch_remap_registers(
-              &callee_frame->registers, callee_frame->return_registers,
-              &current_frame->registers, current_frame->return_registers);
+        if (!iree_status_is_ok(enter_status)) {
+          // TODO(benvanik): set execution result to stack overflow.
+          return enter_status;
+        }
+        iree_vm_bytecode_dispatch_remap_argument_registers(
+            &current_frame->registers, src_i32_remap_list, src_ref_reg_list,
+            &callee_frame->registers);
+
+        if (is_import) {
+          // Call external function.
+          iree_status_t call_status = target_function.module->execute(
+              target_function.module->self, stack, callee_frame, out_result);
+          IREE_DISPATCH_PROFILE_IMPORT(function_ordinal & 0x7FFFFFFFu);
+          if (!iree_status_is_ok(call_status)) {
+            // TODO(benvanik): set execution result to failure/capture stack.
+            return call_status;
+          } else if (out_result->wait_type != IREE_VM_WAIT_NONE) {
+            // The import suspended; the callee frame is resumed (and results
+            // remapped) the next time the entry frame is executed.
+            return IREE_STATUS_OK;
+          }
+          if (callee_frame->return_registers) {
+            iree_vm_bytecode_dispatch_remap_registers(
+                &callee_frame->registers, callee_frame->return_registers,
+                &current_frame->registers, current_frame->return_registers);
+          }
+          iree_vm_stack_function_leave(stack);
+        } else {
+          // Switch execution to the target function and continue running in
+          // the bytecode dispatcher.
+          const iree_vm_function_descriptor_t* function_descriptor =
+              &module
+                   ->function_descriptor_table[callee_frame->function.ordinal];
+          current_frame = callee_frame;
+          bytecode_data =
+              module->bytecode_data.data + function_descriptor->bytecode_offset;
+          regs = &callee_frame->registers;
+          // Ref registers beyond the arguments were zeroed when reserved.
+          regs->ref_register_count = function_descriptor->ref_register_count;
+          pc = callee_frame->pc;
+          IREE_DISPATCH_PROFILE_ENTER(callee_frame);
         }
-        iree_vm_stack_function_leave(stack);
-      } else {
-        // Switch execution to the target function and continue running in the
-        // bytecode dispatcher.
-        const iree_vm_function_descriptor_t* function_descriptor =
-            &module->function_descriptor_table[callee_frame->function.ordinal];
-        current_frame = callee_frame;
-        bytecode_data =
-            module->bytecode_data.data + function_descriptor->bytecode_offset;
-        regs = &callee_frame->registers;
-        // TODO(benvanik): hide this in the stack.
-        memset(
-            &regs->ref[regs->ref_register_count], 0,
-            sizeof(iree_vm_ref_t) * (function_descriptor->ref_register_count -
-                                     regs->ref_register_count));
-        regs->ref_register_count = function_descriptor->ref_register_count;
-        pc = callee_frame->pc;
       }
     });
 
@@ -824,7 +1288,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncOpcode<VM_OPC_CallVariadic>,
       //   VM_EncFuncAttr<"callee">,
       //   VM_EncIntArrayAttr<"segment_sizes", 16>,
-      //   VM_EncVariadicOperands<"operands">,
+      //   VM_EncCallOperands<"operands">,
       //   VM_EncVariadicResults<"results">,
       // ];
 
@@ -837,40 +1301,46 @@ iree_status_t iree_vm_bytecode_dispatch(
       const iree_vm_register_list_t* seg_size_list =
           (const iree_vm_register_list_t*)&bytecode_data[pc];
       pc += kRegSize + seg_size_list->size * kRegSize;
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_remap_list_t* src_i32_remap_list =
+          (const iree_vm_register_remap_list_t*)&bytecode_data[pc];
+      pc += kRegSize + src_i32_remap_list->size * 2 * kRegSize;
+      const iree_vm_register_list_t* src_ref_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[pc];
-      pc += kRegSize + src_reg_list->size * kRegSize;
+      pc += kRegSize + src_ref_reg_list->size * kRegSize;
       const iree_vm_register_list_t* dst_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[pc];
       current_frame->return_registers = dst_reg_list;
       pc += kRegSize + dst_reg_list->size * kRegSize;
       current_frame->pc = pc;
 
-      // NOTE: we assume validation has ensured these functions exist.
+      // NOTE: the verifier has ensured these functions exist.
       // TODO(benvanik): something more clever than just a high bit?
       iree_vm_function_t target_function;
-      int is_import = (function_ordinal & 0x80000000u) != 0;
-      if (!is_import) {
-        // Variadic calls are currently only supported for import functions.
-        return IREE_STATUS_FAILED_PRECONDITION;
-      }
+      // Variadic calls are currently only supported for import functions.
+      VMCHECK((function_ordinal & 0x80000000u) != 0);
 
       // Import that we can fetch from the module state.
       target_function =
           module_state->import_table[function_ordinal & 0x7FFFFFFFu];
 
       IREE_DISPATCH_LOG_CALL(target_function);
+      IREE_DISPATCH_PROFILE_CHARGE();
 
       // Remap registers from caller to callee.
       iree_vm_stack_frame_t* callee_frame = NULL;
       iree_status_t enter_status =
           iree_vm_stack_function_enter(stack, target_function, &callee_frame);
+      if (iree_status_is_ok(enter_status)) {
+        enter_status = iree_vm_bytecode_dispatch_reserve_argument_registers(
+            stack, callee_frame, src_i32_remap_list, src_ref_reg_list);
+      }
       if (!iree_status_is_ok(enter_status)) {
         // TODO(benvanik): set execution result to stack overflow.
         return enter_status;
       }
       iree_vm_bytecode_dispatch_remap_argument_registers(
-          &current_frame->registers, src_reg_list, &callee_frame->registers);
+          &current_frame->registers, src_i32_remap_list, src_ref_reg_list,
+          &callee_frame->registers);
 
       // TODO(benvanik): rename return_registers.
       callee_frame->return_registers = seg_size_list;
@@ -878,9 +1348,12 @@ iree_status_t iree_vm_bytecode_dispatch(
       // Call external function.
       iree_status_t call_status = target_function.module->execute(
           target_function.module->self, stack, callee_frame, out_result);
+      IREE_DISPATCH_PROFILE_IMPORT(function_ordinal & 0x7FFFFFFFu);
       if (!iree_status_is_ok(call_status)) {
         // TODO(benvanik): set execution result to failure/capture stack.
         return call_status;
+      } else if (out_result->wait_type != IREE_VM_WAIT_NONE) {
+        return IREE_STATUS_OK;
       }
       if (callee_frame->return_registers) {
         iree_vm_bytecode_dispatch_remap_registers(
@@ -900,6 +1373,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       const iree_vm_register_list_t* src_reg_list =
           (const iree_vm_register_list_t*)&bytecode_data[pc];
       current_frame->pc = pc + kRegSize + src_reg_list->size * kRegSize;
+      IREE_DISPATCH_PROFILE_CHARGE();
+      IREE_DISPATCH_PROFILE_LEAVE(current_frame);
 
       if (current_frame == entry_frame) {
         // Return from the top-level entry frame - return back to execute().
@@ -938,7 +1413,11 @@ iree_status_t iree_vm_bytecode_dispatch(
       // let encoding = [
       //   VM_EncOpcode<VM_OPC_Yield>,
       // ];
-      // TODO(benvanik): yield with execution results.
+      // Save the resume point and return to the host. All frames remain on
+      // the stack and executing the entry frame again continues from here.
+      current_frame->pc = pc;
+      out_result->wait_type = IREE_VM_WAIT_YIELD;
+      IREE_DISPATCH_PROFILE_CHARGE();
       return IREE_STATUS_OK;
     });
 
@@ -986,12 +1465,7 @@ iree_status_t iree_vm_bytecode_dispatch(
       //   VM_EncBranch<"dest", "operands">,
       // ];
       // TODO(benvanik): break unconditionally.
-      int32_t block_pc = OP_I32(0);
-      const iree_vm_register_remap_list_t* remap_list =
-          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + 4];
-      pc += 4 + kRegSize + remap_list->size * 2 * kRegSize;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
-      pc = block_pc;
+      TAKE_BRANCH();
     });
 
     DISPATCH_OP(CondBreak, {
@@ -1003,13 +1477,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       if (cond_value) {
         // TODO(benvanik): cond break.
       }
-      int32_t block_pc = OP_I32(2);
-      const iree_vm_register_remap_list_t* remap_list =
-          (const iree_vm_register_remap_list_t*)&bytecode_data[pc + kRegSize +
-                                                               4];
-      pc += kRegSize + 4 + kRegSize + remap_list->size * 2 * kRegSize;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
-      pc = block_pc;
+      pc += kRegSize;
+      TAKE_BRANCH();
     });
 
     // NOLINTNEXTLINE(misc-static-assert)
@@ -18,6 +18,9 @@
 // avoid defining the IR inline here so that we can run this test on platforms
 // that we can't run the full MLIR compiler stack on.
 
+#include <memory>
+#include <vector>
+
 #include "absl/strings/match.h"
 #include "iree/base/logging.h"
 #include "iree/testing/gtest.h"
@@ -27,6 +30,8 @@
 #include "iree/vm/instance.h"
 #include "iree/vm/invocation.h"
 #include "iree/vm/module.h"
+#include "iree/vm/stack.h"
+#include "iree/vm/variant_list.h"
 
 namespace {
 
@@ -64,9 +69,7 @@ std::vector<TestParams> GetModuleTestParams() {
   return function_names;
 }
 
-class VMBytecodeDispatchTest
-    : public ::testing::Test,
-      public ::testing::WithParamInterface<TestParams> {
+class VMBytecodeDispatchTestBase : public ::testing::Test {
  protected:
   virtual void SetUp() {
     IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance_));
@@ -92,15 +95,18 @@ class VMBytecodeDispatchTest
     iree_vm_instance_release(instance_);
   }
 
-  iree_status_t RunFunction(absl::string_view function_name) {
+  iree_vm_function_t LookupFunction(absl::string_view function_name) {
     iree_vm_function_t function;
     IREE_CHECK_OK(bytecode_module_->lookup_function(
         bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
         iree_string_view_t{function_name.data(), function_name.size()},
         &function))
         << "Exported function '" << function_name << "' not found";
+    return function;
+  }
 
-    return iree_vm_invoke(context_, function,
+  iree_status_t RunFunction(absl::string_view function_name) {
+    return iree_vm_invoke(context_, LookupFunction(function_name),
                           /*policy=*/nullptr, /*inputs=*/nullptr,
                           /*outputs=*/nullptr, IREE_ALLOCATOR_SYSTEM);
   }
@@ -110,6 +116,10 @@ class VMBytecodeDispatchTest
   iree_vm_module_t* bytecode_module_ = nullptr;
 };
 
+class VMBytecodeDispatchTest
+    : public VMBytecodeDispatchTestBase,
+      public ::testing::WithParamInterface<TestParams> {};
+
 TEST_P(VMBytecodeDispatchTest, Check) {
   const auto& test_params = GetParam();
   bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
@@ -135,4 +145,130 @@ INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMBytecodeDispatchTest,
                          ::testing::ValuesIn(GetModuleTestParams()),
                          ::testing::PrintToStringParamName());
 
+// A function invocation suspended on its own stack.
+struct Fiber {
+  explicit Fiber(iree_vm_context_t* context) {
+    IREE_CHECK_OK(iree_vm_stack_init(iree_vm_context_state_resolver(context),
+                                     IREE_ALLOCATOR_SYSTEM, &stack));
+  }
+  ~Fiber() { iree_vm_stack_deinit(&stack); }
+
+  iree_vm_stack_t stack;
+  iree_vm_execution_result_t result;
+  int yield_count = 0;
+};
+
+using VMBytecodeValueTest = VMBytecodeDispatchTestBase;
+
+// Tests that i64 and f32 values are passed through registers.
+TEST_F(VMBytecodeValueTest, PrimitiveTypes) {
+  struct {
+    const char* function_name;
+    std::vector<iree_vm_value_t> args;
+    iree_vm_value_t expected_result;
+  } cases[] = {
+      {"i32_shift", {IREE_VM_VALUE_MAKE_I32(5)}, IREE_VM_VALUE_MAKE_I32(20)},
+      {"i64_arithmetic",
+       {IREE_VM_VALUE_MAKE_I32(3), iree_vm_value_make_i64(10)},
+       iree_vm_value_make_i64(6442450949ll)},
+      {"f32_arithmetic",
+       {iree_vm_value_make_f32(1.5f), iree_vm_value_make_f32(3.0f)},
+       iree_vm_value_make_f32(-5.0f)},
+      {"f32_ceil", {iree_vm_value_make_f32(2.5f)}, IREE_VM_VALUE_MAKE_I32(3)},
+  };
+
+  for (const auto& test_case : cases) {
+    SCOPED_TRACE(test_case.function_name);
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_ASSERT_OK(iree_vm_variant_list_alloc(
+        test_case.args.size(), IREE_ALLOCATOR_SYSTEM, &inputs));
+    for (const auto& arg : test_case.args) {
+      IREE_ASSERT_OK(iree_vm_variant_list_append_value(inputs, arg));
+    }
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_ASSERT_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+    IREE_ASSERT_OK(iree_vm_invoke(
+        context_, LookupFunction(test_case.function_name), /*policy=*/nullptr,
+        inputs, outputs, IREE_ALLOCATOR_SYSTEM));
+    ASSERT_EQ(1, iree_vm_variant_list_size(outputs));
+    auto* result = iree_vm_variant_list_get(outputs, 0);
+    switch (test_case.expected_result.type) {
+      case IREE_VM_VALUE_TYPE_I64:
+        EXPECT_EQ(IREE_VM_VALUE_TYPE_I64, result->value_type);
+        EXPECT_EQ(test_case.expected_result.i64, result->i64);
+        break;
+      case IREE_VM_VALUE_TYPE_F32:
+        // 32-bit primitive registers are untyped and f32 results are returned
+        // as i32 values holding the bits of the float.
+        EXPECT_EQ(IREE_VM_VALUE_TYPE_I32, result->value_type);
+        EXPECT_EQ(test_case.expected_result.i32, result->i32);
+        EXPECT_EQ(test_case.expected_result.f32, result->f32);
+        break;
+      default:
+        EXPECT_EQ(test_case.expected_result.i32, result->i32);
+        break;
+    }
+    iree_vm_variant_list_free(inputs);
+    iree_vm_variant_list_free(outputs);
+  }
+}
+
+using VMBytecodeFiberTest = VMBytecodeDispatchTestBase;
+
+// Tests that yielding invocations can be interleaved on a single thread and
+// resume from where they left off, including from within callees.
+TEST_F(VMBytecodeFiberTest, InterleaveYields) {
+  struct {
+    const char* function_name;
+    int32_t arg;
+    int32_t expected_result;
+    int expected_yield_count;
+  } cases[] = {
+      {"yield_sequence", 10, 12, 2},
+      {"yield_in_call", 20, 22, 3},
+  };
+
+  std::vector<std::unique_ptr<Fiber>> fibers;
+  for (const auto& test_case : cases) {
+    fibers.push_back(std::make_unique<Fiber>(context_));
+    auto* fiber = fibers.back().get();
+    iree_vm_variant_list_t* inputs = nullptr;
+    IREE_ASSERT_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &inputs));
+    IREE_ASSERT_OK(iree_vm_variant_list_append_value(
+        inputs, IREE_VM_VALUE_MAKE_I32(test_case.arg)));
+    IREE_ASSERT_OK(iree_vm_invoke_begin(&fiber->stack,
+                                        LookupFunction(test_case.function_name),
+                                        inputs, &fiber->result));
+    iree_vm_variant_list_free(inputs);
+  }
+
+  // Round-robin all fibers until they have completed.
+  bool any_suspended = true;
+  while (any_suspended) {
+    any_suspended = false;
+    for (auto& fiber : fibers) {
+      if (fiber->result.wait_type == IREE_VM_WAIT_NONE) continue;
+      EXPECT_EQ(IREE_VM_WAIT_YIELD, fiber->result.wait_type);
+      ++fiber->yield_count;
+      IREE_ASSERT_OK(iree_vm_invoke_resume(&fiber->stack, &fiber->result));
+      any_suspended = true;
+    }
+  }
+
+  for (int i = 0; i < fibers.size(); ++i) {
+    auto* fiber = fibers[i].get();
+    EXPECT_EQ(cases[i].expected_yield_count, fiber->yield_count);
+    iree_vm_variant_list_t* outputs = nullptr;
+    IREE_ASSERT_OK(
+        iree_vm_variant_list_alloc(1, IREE_ALLOCATOR_SYSTEM, &outputs));
+    IREE_ASSERT_OK(iree_vm_invoke_end(&fiber->stack, outputs));
+    ASSERT_EQ(1, iree_vm_variant_list_size(outputs));
+    EXPECT_EQ(cases[i].expected_result,
+              iree_vm_variant_list_get(outputs, 0)->i32);
+    iree_vm_variant_list_free(outputs);
+  }
+}
+
 }  // namespace
@@ -8,5 +8,72 @@ vm.module @bytecode_dispatch_test {
     vm.return
   }
 
+  // Tests that execution continues from the yield point when resumed.
+  vm.export @yield_sequence
+  vm.func @yield_sequence(%arg0 : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    vm.yield
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.yield
+    %1 = vm.add.i32 %0, %c1 : i32
+    vm.return %1 : i32
+  }
+
+  // Tests that yields within a callee resume within the callee.
+  vm.func @yield_callee(%arg0 : i32) -> i32 attributes {noinline} {
+    %c1 = vm.const.i32 1 : i32
+    vm.yield
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.return %0 : i32
+  }
+  vm.export @yield_in_call
+  vm.func @yield_in_call(%arg0 : i32) -> i32 {
+    %0 = vm.call @yield_callee(%arg0) : (i32) -> i32
+    vm.yield
+    %1 = vm.call @yield_callee(%0) : (i32) -> i32
+    vm.return %1 : i32
+  }
+
+  // Tests that i32 shifts decode their i8 amount and result correctly.
+  vm.export @i32_shift
+  vm.func @i32_shift(%arg0 : i32) -> i32 {
+    %0 = vm.shl.i32 %arg0, 3 : i32
+    %1 = vm.shr.i32.u %0, 1 : i32
+    vm.return %1 : i32
+  }
+
+  // Tests i64 arithmetic on values that do not fit in 32 bits. The leading i32
+  // argument ensures the i64 argument is aligned to a register pair.
+  vm.export @i64_arithmetic
+  vm.func @i64_arithmetic(%arg0 : i32, %arg1 : i64) -> i64 {
+    %0 = vm.ext.i32.i64.s %arg0 : i32 -> i64
+    %c = vm.const.i64 4294967296 : i64
+    %1 = vm.mul.i64 %0, %c : i64
+    %2 = vm.add.i64 %1, %arg1 : i64
+    %3 = vm.shr.i64.s %2, 1 : i64
+    vm.return %3 : i64
+  }
+
+  // Tests f32 arithmetic.
+  vm.export @f32_arithmetic
+  vm.func @f32_arithmetic(%arg0 : f32, %arg1 : f32) -> f32 {
+    %0 = vm.mul.f32 %arg0, %arg1 : f32
+    %c = vm.const.f32 0.5 : f32
+    %1 = vm.add.f32 %0, %c : f32
+    %2 = vm.neg.f32 %1 : f32
+    vm.return %2 : f32
+  }
+
+  // Tests f32 comparison and conversion by computing ceil(arg0) for positive
+  // values.
+  vm.export @f32_ceil
+  vm.func @f32_ceil(%arg0 : f32) -> i32 {
+    %0 = vm.cast.f32.si32 %arg0 : f32 -> i32
+    %1 = vm.cast.si32.f32 %0 : i32 -> f32
+    %2 = vm.cmp.lt.f32 %1, %arg0 : f32
+    %3 = vm.add.i32 %0, %2 : i32
+    vm.return %3 : i32
+  }
+
   // TODO(benvanik): more tests.
 }
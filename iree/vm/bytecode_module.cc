@@ -16,9 +16,12 @@
 
 #include <string.h>
 
+#include <chrono>
+
 #include "iree/base/api.h"
 #include "iree/base/flatbuffer_util.h"
 #include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_table.h"
 #include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
 
@@ -45,6 +48,10 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   memset(&result, 0, sizeof(result));
   if (full_name == "i32") {
     result.value_type = IREE_VM_VALUE_TYPE_I32;
+  } else if (full_name == "i64") {
+    result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (full_name == "f32") {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
   } else if (!full_name.empty() && full_name[0] == '!') {
     full_name.remove_prefix(1);
     const iree_vm_ref_type_descriptor_t* type_descriptor =
@@ -77,8 +84,10 @@ static iree_status_t iree_vm_bytecode_module_resolve_types(
 // runtime. There are still some conditions we must be aware of (such as omitted
 // names on functions with internal linkage), however we shouldn't need to
 // bounds check anything within the flatbuffer after this succeeds.
+// Function bytecode is verified as well such that the dispatcher can trust the
+// static operands of each instruction. |allocator| is used for scratch memory.
 static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
-    const iree::vm::BytecodeModuleDef* module_def) {
+    const iree::vm::BytecodeModuleDef* module_def, iree_allocator_t allocator) {
   if (!module_def->name() || module_def->name()->size() == 0) {
     LOG(ERROR) << "All modules must have a name.";
     return IREE_STATUS_INVALID_ARGUMENT;
@@ -170,6 +179,24 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     }
   }
 
+  iree_vm_bytecode_module_limits_t limits;
+  limits.function_count = module_def->internal_functions()->size();
+  limits.import_count = module_def->imported_functions()
+                            ? module_def->imported_functions()->size()
+                            : 0;
+  limits.type_count = module_def->types()->size();
+  limits.rodata_count =
+      module_def->rodata_segments() ? module_def->rodata_segments()->size() : 0;
+  limits.global_bytes_capacity =
+      module_def->module_state()
+          ? module_def->module_state()->global_bytes_capacity()
+          : 0;
+  limits.global_ref_count = module_def->module_state()
+                                ? module_def->module_state()->global_ref_count()
+                                : 0;
+  iree_const_byte_span_t bytecode_data = {module_def->bytecode_data()->Data(),
+                                          module_def->bytecode_data()->size()};
+
   for (int i = 0; i < module_def->internal_functions()->size(); ++i) {
     auto* function_def = module_def->internal_functions()->Get(i);
     if (!function_def) {
@@ -190,13 +217,25 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
       LOG(ERROR) << "Bytecode span must be a valid range.";
       return IREE_STATUS_INVALID_ARGUMENT;
     }
-    if (function_descriptor->i32_register_count() > IREE_I32_REGISTER_COUNT ||
+    if (function_descriptor->i32_register_count() < 0 ||
+        function_descriptor->i32_register_count() > IREE_I32_REGISTER_COUNT ||
+        function_descriptor->ref_register_count() < 0 ||
         function_descriptor->ref_register_count() > IREE_REF_REGISTER_COUNT) {
       LOG(ERROR) << "Register counts out of range.";
       return IREE_STATUS_INVALID_ARGUMENT;
     }
 
-    // TODO(benvanik): run bytecode verifier on contents.
+    if (!iree_status_is_ok(iree_vm_bytecode_function_verify(
+            bytecode_data,
+            (const iree_vm_function_descriptor_t*)function_descriptor,
+            &limits, allocator))) {
+      LOG(ERROR) << "Function " << i << " ("
+                 << (function_def->local_name()
+                         ? function_def->local_name()->c_str()
+                         : "<unnamed>")
+                 << ") has invalid bytecode.";
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
   }
 
   return IREE_STATUS_OK;
@@ -523,12 +562,13 @@ static iree_status_t iree_vm_bytecode_module_execute(
     return IREE_STATUS_INVALID_ARGUMENT;
   }
 
+  // Callers only reserve the registers they pass arguments in. This is a no-op
+  // when resuming a frame that already has its registers.
   const iree_vm_function_descriptor_t* function_descriptor =
       &module->function_descriptor_table[frame->function.ordinal];
-  iree_vm_registers_t* regs = &frame->registers;
-  memset(&regs->ref[regs->ref_register_count], 0,
-         sizeof(iree_vm_ref_t) * (function_descriptor->ref_register_count -
-                                  regs->ref_register_count));
+  IREE_RETURN_IF_ERROR(iree_vm_stack_frame_reserve_registers(
+      stack, frame, function_descriptor->i32_register_count,
+      function_descriptor->ref_register_count));
 
   return iree_vm_bytecode_dispatch(
       module, (iree_vm_bytecode_module_state_t*)frame->module_state, stack,
@@ -560,14 +600,26 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     LOG(ERROR) << "Failed getting root from flatbuffer data";
     return IREE_STATUS_INVALID_ARGUMENT;
   }
-  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_flatbuffer_verify(module_def));
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_flatbuffer_verify(module_def, allocator));
 
   size_t type_table_size =
       module_def->types()->size() * sizeof(iree_vm_type_def_t);
+  int32_t import_count = module_def->imported_functions()
+                             ? module_def->imported_functions()->size()
+                             : 0;
+  size_t profile_size = 0;
+#if IREE_VM_PROFILING_ENABLE
+  profile_size = sizeof(iree_vm_bytecode_profile_counters_t) +
+                 module_def->internal_functions()->size() *
+                     sizeof(iree_vm_bytecode_function_counters_t) +
+                 import_count * sizeof(iree_vm_bytecode_import_counters_t);
+#endif  // IREE_VM_PROFILING_ENABLE
 
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
+      allocator,
+      sizeof(iree_vm_bytecode_module_t) + type_table_size + profile_size,
       (void**)&module));
   module->allocator = allocator;
 
@@ -587,6 +639,22 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
                                              sizeof(iree_vm_bytecode_module_t));
   iree_vm_bytecode_module_resolve_types(module_def, module->type_table);
 
+  module->profile = NULL;
+#if IREE_VM_PROFILING_ENABLE
+  // Counters are zeroed by iree_allocator_malloc.
+  uint8_t* profile_ptr = (uint8_t*)module->type_table + type_table_size;
+  module->profile = (iree_vm_bytecode_profile_counters_t*)profile_ptr;
+  profile_ptr += sizeof(iree_vm_bytecode_profile_counters_t);
+  module->profile->functions =
+      (iree_vm_bytecode_function_counters_t*)profile_ptr;
+  profile_ptr += module_def->internal_functions()->size() *
+                 sizeof(iree_vm_bytecode_function_counters_t);
+  module->profile->import_count = import_count;
+  module->profile->imports = (iree_vm_bytecode_import_counters_t*)profile_ptr;
+#else
+  (void)import_count;
+#endif  // IREE_VM_PROFILING_ENABLE
+
   iree_vm_module_init(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -603,3 +671,116 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   *out_module = &module->interface;
   return IREE_STATUS_OK;
 }
+
+extern "C" int64_t iree_vm_bytecode_profile_now_ns(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL
+iree_vm_bytecode_opcode_name(uint8_t opcode) {
+#define IREE_VM_OP_NAME(opcode, name) #name,
+#define IREE_VM_OP_RESERVED(opcode) "",
+  static const char* kOpcodeNames[256] = {
+      IREE_VM_OP_TABLE(IREE_VM_OP_NAME, IREE_VM_OP_RESERVED)};
+#undef IREE_VM_OP_NAME
+#undef IREE_VM_OP_RESERVED
+  return iree_make_cstring_view(kOpcodeNames[opcode]);
+}
+
+// Returns the bytecode module implementing |module| or NULL if it is not a
+// bytecode module.
+static iree_vm_bytecode_module_t* iree_vm_bytecode_module_cast(
+    iree_vm_module_t* module) {
+  if (!module || module->execute != iree_vm_bytecode_module_execute) {
+    return NULL;
+  }
+  return (iree_vm_bytecode_module_t*)module->self;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_profile_snapshot(
+    iree_vm_module_t* module, iree_allocator_t allocator,
+    iree_vm_bytecode_profile_t** out_profile) {
+  if (!out_profile) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_profile = NULL;
+  iree_vm_bytecode_module_t* bytecode_module =
+      iree_vm_bytecode_module_cast(module);
+  if (!bytecode_module) return IREE_STATUS_INVALID_ARGUMENT;
+  const iree_vm_bytecode_profile_counters_t* counters =
+      bytecode_module->profile;
+  if (!counters) return IREE_STATUS_UNAVAILABLE;
+
+  auto* module_def = IREE_VM_GET_MODULE_DEF(bytecode_module);
+  int32_t function_count = bytecode_module->function_descriptor_count;
+  int32_t import_count = counters->import_count;
+
+  iree_vm_bytecode_profile_t* profile = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator,
+      sizeof(iree_vm_bytecode_profile_t) +
+          function_count * sizeof(iree_vm_bytecode_function_profile_t) +
+          import_count * sizeof(iree_vm_bytecode_import_profile_t),
+      (void**)&profile));
+  profile->allocator = allocator;
+  memcpy(profile->opcode_counts, counters->opcode_counts,
+         sizeof(profile->opcode_counts));
+
+  profile->function_count = function_count;
+  profile->functions =
+      (iree_vm_bytecode_function_profile_t*)((uint8_t*)profile +
+                                             sizeof(*profile));
+  for (int32_t i = 0; i < function_count; ++i) {
+    iree_vm_bytecode_function_profile_t* function_profile =
+        &profile->functions[i];
+    auto* function_def = module_def->internal_functions()->Get(i);
+    if (function_def->local_name()) {
+      function_profile->name =
+          iree_string_view_t{function_def->local_name()->data(),
+                             function_def->local_name()->size()};
+    }
+    function_profile->call_count = counters->functions[i].call_count;
+    function_profile->inclusive_time_ns =
+        counters->functions[i].inclusive_time_ns;
+    function_profile->exclusive_time_ns =
+        counters->functions[i].exclusive_time_ns;
+  }
+
+  profile->import_count = import_count;
+  profile->imports =
+      (iree_vm_bytecode_import_profile_t*)(profile->functions + function_count);
+  for (int32_t i = 0; i < import_count; ++i) {
+    iree_vm_bytecode_import_profile_t* import_profile = &profile->imports[i];
+    auto* import_def = module_def->imported_functions()->Get(i);
+    import_profile->full_name = iree_string_view_t{
+        import_def->full_name()->data(), import_def->full_name()->size()};
+    import_profile->call_count = counters->imports[i].call_count;
+    import_profile->time_ns = counters->imports[i].time_ns;
+  }
+
+  *out_profile = profile;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_profile_reset(iree_vm_module_t* module) {
+  iree_vm_bytecode_module_t* bytecode_module =
+      iree_vm_bytecode_module_cast(module);
+  if (!bytecode_module) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_vm_bytecode_profile_counters_t* counters = bytecode_module->profile;
+  if (!counters) return IREE_STATUS_UNAVAILABLE;
+  memset(counters->opcode_counts, 0, sizeof(counters->opcode_counts));
+  memset(counters->functions, 0,
+         bytecode_module->function_descriptor_count *
+             sizeof(iree_vm_bytecode_function_counters_t));
+  memset(counters->imports, 0,
+         counters->import_count * sizeof(iree_vm_bytecode_import_counters_t));
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_profile_free(iree_vm_bytecode_profile_t* profile) {
+  if (!profile) return IREE_STATUS_OK;
+  return iree_allocator_free(profile->allocator, profile);
+}
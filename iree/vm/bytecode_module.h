@@ -33,6 +33,77 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+//===----------------------------------------------------------------------===//
+// Profiling
+//===----------------------------------------------------------------------===//
+// The bytecode interpreter can be built with profiling support by defining
+// IREE_VM_PROFILING_ENABLE=1 (--copt=-DIREE_VM_PROFILING_ENABLE=1 in bazel or
+// -DIREE_ENABLE_VM_PROFILING=ON in CMake). Each bytecode module then counts
+// executed opcodes, function calls and time, and calls to imports. Counters
+// are updated without synchronization and are only exact when a single
+// invocation is executing at a time.
+
+// Profile of an internal function, indexed by internal function ordinal.
+typedef struct {
+  // Local name of the function, if available.
+  iree_string_view_t name;
+  // Number of times the function was entered.
+  int64_t call_count;
+  // Wall time between entering and returning from the function, including
+  // callees, imports, and time spent suspended.
+  int64_t inclusive_time_ns;
+  // Time spent executing bytecode of the function, excluding callees and
+  // imports.
+  int64_t exclusive_time_ns;
+} iree_vm_bytecode_function_profile_t;
+
+// Profile of an imported function, indexed by import ordinal.
+typedef struct {
+  // Fully-qualified name of the import.
+  iree_string_view_t full_name;
+  // Number of calls made to the import from this module.
+  int64_t call_count;
+  // Time spent within the import.
+  int64_t time_ns;
+} iree_vm_bytecode_import_profile_t;
+
+// A snapshot of the profiling counters of a bytecode module.
+// Name strings reference the module and are only valid while it is live.
+typedef struct {
+  // Allocator the snapshot was allocated from.
+  iree_allocator_t allocator;
+  // Number of times each opcode was executed, indexed by opcode.
+  int64_t opcode_counts[256];
+  // Internal function profiles indexed by internal function ordinal.
+  int32_t function_count;
+  iree_vm_bytecode_function_profile_t* functions;
+  // Import profiles indexed by import ordinal.
+  int32_t import_count;
+  iree_vm_bytecode_import_profile_t* imports;
+} iree_vm_bytecode_profile_t;
+
+// Returns the name of |opcode| (such as 'AddI32') or an empty string if it is
+// reserved.
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL
+iree_vm_bytecode_opcode_name(uint8_t opcode);
+
+// Snapshots the profiling counters of the bytecode |module|.
+// The returned |out_profile| must be freed with iree_vm_bytecode_profile_free.
+// Returns IREE_STATUS_UNAVAILABLE if profiling support was not compiled in.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_profile_snapshot(
+    iree_vm_module_t* module, iree_allocator_t allocator,
+    iree_vm_bytecode_profile_t** out_profile);
+
+// Resets all profiling counters of the bytecode |module| to zero.
+// Returns IREE_STATUS_UNAVAILABLE if profiling support was not compiled in.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_profile_reset(iree_vm_module_t* module);
+
+// Frees a |profile| returned by iree_vm_bytecode_module_profile_snapshot.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_profile_free(iree_vm_bytecode_profile_t* profile);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -12,15 +12,26 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/base/status.h"
 #include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_benchmark_aot_module.h"
 #include "iree/vm/bytecode_module_benchmark_module.h"
+#include "iree/vm/c_module.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
 #include "iree/vm/module.h"
+#include "iree/vm/module_abi_cc.h"
 #include "iree/vm/stack.h"
+#include "iree/vm/variant_list.h"
 
 namespace {
 
@@ -41,11 +52,8 @@ static iree_status_t IREE_API_CALL SimpleAddExecute(
   return IREE_STATUS_OK;
 }
 
-// Benchmarks the given exported function, optionally passing in arguments.
-static iree_status_t RunFunction(benchmark::State& state,
-                                 absl::string_view function_name,
-                                 absl::InlinedVector<int32_t, 4> i32_args,
-                                 int batch_size = 1) {
+// Creates the benchmark module interpreted from bytecode.
+static iree_vm_module_t* CreateBytecodeModule() {
   const auto* module_file_toc =
       iree::vm::bytecode_module_benchmark_module_create();
   iree_vm_module_t* module = nullptr;
@@ -55,11 +63,32 @@ static iree_status_t RunFunction(benchmark::State& state,
           module_file_toc->size},
       IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &module))
       << "Bytecode module failed to load";
+  return module;
+}
+
+// Creates the same benchmark module compiled ahead-of-time to C.
+static iree_vm_module_t* CreateAOTModule() {
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(bytecode_module_benchmark_aot_module_create(
+      IREE_ALLOCATOR_SYSTEM, &module))
+      << "AOT module failed to create";
+  return module;
+}
+
+// Benchmarks the given exported function, optionally passing in arguments.
+// |create_module| selects the implementation of the benchmark module to run.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 iree_vm_module_t* (*create_module)(),
+                                 absl::string_view function_name,
+                                 absl::InlinedVector<int32_t, 4> i32_args,
+                                 int batch_size = 1) {
+  iree_vm_module_t* module = create_module();
 
   iree_vm_module_state_t* module_state;
   module->alloc_state(module->self, IREE_ALLOCATOR_SYSTEM, &module_state);
 
   iree_vm_module_t import_module;
+  iree_vm_module_init(&import_module, &import_module);
   import_module.execute = SimpleAddExecute;
   iree_vm_function_t imported_func;
   imported_func.module = &import_module;
@@ -77,7 +106,7 @@ static iree_status_t RunFunction(benchmark::State& state,
       }};
 
   auto stack = std::make_unique<iree_vm_stack_t>();
-  iree_vm_stack_init(state_resolver, stack.get());
+  iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get());
 
   iree_vm_function_t function;
   IREE_CHECK_OK(module->lookup_function(
@@ -89,6 +118,8 @@ static iree_status_t RunFunction(benchmark::State& state,
   while (state.KeepRunningBatch(batch_size)) {
     iree_vm_stack_frame_t* entry_frame;
     iree_vm_stack_function_enter(stack.get(), function, &entry_frame);
+    iree_vm_stack_frame_reserve_registers(stack.get(), entry_frame,
+                                          i32_args.size(), 0);
     // TODO(benvanik): replace direct register manipulation with setter:
     //   iree_vm_stack_frame_set_arguments(entry_frame, 1, i32_args, 0, {});
     for (int i = 0; i < i32_args.size(); ++i) {
@@ -194,10 +225,15 @@ static void BM_EmptyFuncReference(benchmark::State& state) {
 BENCHMARK(BM_EmptyFuncReference);
 
 static void BM_EmptyFuncBytecode(benchmark::State& state) {
-  IREE_CHECK_OK(RunFunction(state, "empty_func", {}));
+  IREE_CHECK_OK(RunFunction(state, CreateBytecodeModule, "empty_func", {}));
 }
 BENCHMARK(BM_EmptyFuncBytecode);
 
+static void BM_EmptyFuncAOT(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, CreateAOTModule, "empty_func", {}));
+}
+BENCHMARK(BM_EmptyFuncAOT);
+
 static void BM_CallInternalFuncReference(benchmark::State& state) {
   static auto add_fn = +[](int value) {
     benchmark::DoNotOptimize(value += value);
@@ -231,19 +267,38 @@ static void BM_CallInternalFuncReference(benchmark::State& state) {
 BENCHMARK(BM_CallInternalFuncReference);
 
 static void BM_CallInternalFuncBytecode(benchmark::State& state) {
-  IREE_CHECK_OK(RunFunction(state, "call_internal_func", {100},
-                            /*batch_size=*/10));
+  IREE_CHECK_OK(RunFunction(state, CreateBytecodeModule, "call_internal_func",
+                            {100}, /*batch_size=*/10));
 }
 BENCHMARK(BM_CallInternalFuncBytecode);
 
+static void BM_CallInternalFuncAOT(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, CreateAOTModule, "call_internal_func",
+                            {100}, /*batch_size=*/10));
+}
+BENCHMARK(BM_CallInternalFuncAOT);
+
 static void BM_CallImportedFuncReference(benchmark::State& state) {
   iree_vm_module_t import_module;
+  iree_vm_module_init(&import_module, &import_module);
   import_module.execute = SimpleAddExecute;
   iree_vm_module_t* module_ptr = &import_module;
   benchmark::DoNotOptimize(module_ptr);
 
+  iree_vm_state_resolver_t state_resolver = {
+      nullptr,
+      +[](void* state_resolver, iree_vm_module_t* module,
+          iree_vm_module_state_t** out_module_state) -> iree_status_t {
+        *out_module_state = nullptr;
+        return IREE_STATUS_OK;
+      }};
   auto stack = std::make_unique<iree_vm_stack_t>();
-  iree_vm_stack_frame_t* frame = &stack->frames[0];
+  iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get());
+  iree_vm_function_t function = {module_ptr, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
+                                 0};
+  iree_vm_stack_frame_t* frame = nullptr;
+  iree_vm_stack_function_enter(stack.get(), function, &frame);
+  iree_vm_stack_frame_reserve_registers(stack.get(), frame, 1, 0);
   iree_vm_execution_result_t result;
   while (state.KeepRunningBatch(10)) {
     int value = 100;
@@ -256,15 +311,183 @@ static void BM_CallImportedFuncReference(benchmark::State& state) {
     }
     benchmark::ClobberMemory();
   }
+  iree_vm_stack_deinit(stack.get());
 }
 BENCHMARK(BM_CallImportedFuncReference);
 
 static void BM_CallImportedFuncBytecode(benchmark::State& state) {
-  IREE_CHECK_OK(RunFunction(state, "call_imported_func", {100},
-                            /*batch_size=*/10));
+  IREE_CHECK_OK(RunFunction(state, CreateBytecodeModule, "call_imported_func",
+                            {100}, /*batch_size=*/10));
 }
 BENCHMARK(BM_CallImportedFuncBytecode);
 
+static void BM_CallImportedFuncAOT(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, CreateAOTModule, "call_imported_func",
+                            {100}, /*batch_size=*/10));
+}
+BENCHMARK(BM_CallImportedFuncAOT);
+
+// Implements 'benchmark.imported_func' for modules registered in a context.
+static iree_status_t IREE_API_CALL ImportedFuncShim(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    iree_vm_c_module_state_t* state) {
+  // The argument register is reused for the left-aligned result.
+  frame->registers.i32[0] = frame->registers.i32[0] + 1;
+  return IREE_STATUS_OK;
+}
+
+static const iree_vm_c_function_descriptor_t kImportModuleFunctions[] = {
+    {{"imported_func", 13}, {}, ImportedFuncShim, 0, nullptr},
+};
+static const iree_vm_c_export_descriptor_t kImportModuleExports[] = {
+    {{"imported_func", 13}, 0},
+};
+static const iree_vm_c_module_descriptor_t kImportModuleDescriptor = {
+    /*name=*/{"benchmark", 9},
+    /*import_count=*/0,
+    /*imports=*/nullptr,
+    /*export_count=*/1,
+    /*exports=*/kImportModuleExports,
+    /*function_count=*/1,
+    /*functions=*/kImportModuleFunctions,
+    /*rodata_count=*/0,
+    /*rodata_segments=*/nullptr,
+    /*global_bytes_capacity=*/0,
+    /*global_ref_count=*/0,
+};
+
+// Creates the 'benchmark' import module implemented in C.
+static iree_vm_module_t* CreateCImportModule() {
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(iree_vm_c_module_create(&kImportModuleDescriptor,
+                                        IREE_ALLOCATOR_SYSTEM, &module));
+  return module;
+}
+
+// Implements 'benchmark.imported_func' as a C++ native module.
+class NativeImportModuleState final {
+ public:
+  iree::StatusOr<int32_t> ImportedFunc(int32_t value) { return value + 1; }
+};
+
+static const iree::vm::NativeFunction<NativeImportModuleState>
+    kNativeImportModuleFunctions[] = {
+        iree::vm::MakeNativeFunction("imported_func",
+                                     &NativeImportModuleState::ImportedFunc),
+};
+
+class NativeImportModule final
+    : public iree::vm::NativeModule<NativeImportModuleState> {
+ public:
+  using iree::vm::NativeModule<NativeImportModuleState>::NativeModule;
+
+ protected:
+  iree::StatusOr<std::unique_ptr<NativeImportModuleState>> CreateState(
+      iree_allocator_t allocator) override {
+    return std::make_unique<NativeImportModuleState>();
+  }
+};
+
+// Creates the 'benchmark' import module implemented in C++. Calls from
+// bytecode use the direct call path.
+static iree_vm_module_t* CreateNativeImportModule() {
+  return (new NativeImportModule(
+              "benchmark", IREE_ALLOCATOR_SYSTEM,
+              absl::MakeConstSpan(kNativeImportModuleFunctions)))
+      ->interface();
+}
+
+// Creates the C++ import module with direct calls disabled such that calls
+// from bytecode enter a callee frame.
+static iree_vm_module_t* CreateNativeImportModuleWithFrames() {
+  iree_vm_module_t* module = CreateNativeImportModule();
+  module->call_direct = nullptr;
+  return module;
+}
+
+// Benchmarks the full iree_vm_invoke path of the given exported function in a
+// context, including stack setup and argument/result marshaling.
+// |create_import_module| selects the implementation of the 'benchmark' module.
+static iree_status_t InvokeFunction(
+    benchmark::State& state, iree_vm_module_t* (*create_module)(),
+    iree_vm_module_t* (*create_import_module)(),
+    absl::string_view function_name, absl::InlinedVector<int32_t, 4> i32_args) {
+  iree_vm_instance_t* instance = nullptr;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_ALLOCATOR_SYSTEM, &instance));
+  iree_vm_module_t* import_module = create_import_module();
+  iree_vm_module_t* module = create_module();
+  iree_vm_module_t* modules[] = {import_module, module};
+  iree_vm_context_t* context = nullptr;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, modules, 2, IREE_ALLOCATOR_SYSTEM, &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_module_lookup_function_by_name(
+      module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+      iree_string_view_t{function_name.data(), function_name.size()},
+      &function))
+      << "Exported function '" << function_name << "' not found";
+
+  iree_vm_variant_list_t* inputs = nullptr;
+  IREE_CHECK_OK(iree_vm_variant_list_alloc(i32_args.size(),
+                                           IREE_ALLOCATOR_SYSTEM, &inputs));
+  for (int32_t arg : i32_args) {
+    iree_vm_value_t value = IREE_VM_VALUE_MAKE_I32(arg);
+    IREE_CHECK_OK(iree_vm_variant_list_append_value(inputs, value));
+  }
+  std::vector<uint8_t> outputs_storage(iree_vm_variant_list_alloc_size(1));
+  auto* outputs =
+      reinterpret_cast<iree_vm_variant_list_t*>(outputs_storage.data());
+
+  while (state.KeepRunning()) {
+    IREE_CHECK_OK(iree_vm_variant_list_init(outputs, 1));
+    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr, inputs,
+                                 outputs, IREE_ALLOCATOR_SYSTEM));
+    benchmark::DoNotOptimize(outputs);
+  }
+
+  iree_vm_variant_list_free(inputs);
+  iree_vm_context_release(context);
+  iree_vm_module_release(module);
+  iree_vm_module_release(import_module);
+  iree_vm_instance_release(instance);
+  return IREE_STATUS_OK;
+}
+
+static void BM_InvokeEmptyFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(InvokeFunction(state, CreateBytecodeModule, CreateCImportModule,
+                               "empty_func", {}));
+}
+BENCHMARK(BM_InvokeEmptyFuncBytecode);
+
+static void BM_InvokeCallImportedFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(InvokeFunction(state, CreateBytecodeModule, CreateCImportModule,
+                               "call_imported_func", {100}));
+}
+BENCHMARK(BM_InvokeCallImportedFuncBytecode);
+
+static void BM_InvokeCallImportedFuncAOT(benchmark::State& state) {
+  IREE_CHECK_OK(InvokeFunction(state, CreateAOTModule, CreateCImportModule,
+                               "call_imported_func", {100}));
+}
+BENCHMARK(BM_InvokeCallImportedFuncAOT);
+
+// Measures calls from bytecode into a C++ native module import with and
+// without the direct call path. Each invocation makes 10 import calls.
+static void BM_CallNativeImportDirect(benchmark::State& state) {
+  IREE_CHECK_OK(InvokeFunction(state, CreateBytecodeModule,
+                               CreateNativeImportModule, "call_imported_func",
+                               {100}));
+}
+BENCHMARK(BM_CallNativeImportDirect);
+
+static void BM_CallNativeImportFrame(benchmark::State& state) {
+  IREE_CHECK_OK(InvokeFunction(state, CreateBytecodeModule,
+                               CreateNativeImportModuleWithFrames,
+                               "call_imported_func", {100}));
+}
+BENCHMARK(BM_CallNativeImportFrame);
+
 static void BM_LoopSumReference(benchmark::State& state) {
   static auto loop = +[](int count) {
     int i = 0;
@@ -282,10 +505,17 @@ static void BM_LoopSumReference(benchmark::State& state) {
 BENCHMARK(BM_LoopSumReference)->Arg(100000);
 
 static void BM_LoopSumBytecode(benchmark::State& state) {
-  IREE_CHECK_OK(RunFunction(state, "loop_sum",
+  IREE_CHECK_OK(RunFunction(state, CreateBytecodeModule, "loop_sum",
                             {static_cast<int32_t>(state.range(0))},
                             /*batch_size=*/state.range(0)));
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+static void BM_LoopSumAOT(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, CreateAOTModule, "loop_sum",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumAOT)->Arg(100000);
+
 }  // namespace
@@ -28,6 +28,12 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Enables opcode/function/import profiling in the dispatcher.
+// See iree_vm_bytecode_module_profile_snapshot in bytecode_module.h.
+#ifndef IREE_VM_PROFILING_ENABLE
+#define IREE_VM_PROFILING_ENABLE 0
+#endif  // !IREE_VM_PROFILING_ENABLE
+
 // Describes a type in the type table, mapping from a local module type ID to
 // either a primitive value type or registered ref type.
 //
@@ -46,6 +52,30 @@ typedef struct {
   uint16_t ref_register_count;
 } iree_vm_function_descriptor_t;
 
+// Profiling counters of an internal function.
+typedef struct {
+  int64_t call_count;
+  int64_t inclusive_time_ns;
+  int64_t exclusive_time_ns;
+} iree_vm_bytecode_function_counters_t;
+
+// Profiling counters of an imported function.
+typedef struct {
+  int64_t call_count;
+  int64_t time_ns;
+} iree_vm_bytecode_import_counters_t;
+
+// Profiling counters of a module, updated by the dispatcher when built with
+// IREE_VM_PROFILING_ENABLE.
+typedef struct {
+  int64_t opcode_counts[256];
+  // Indexed by internal function ordinal.
+  iree_vm_bytecode_function_counters_t* functions;
+  // Indexed by import ordinal.
+  int32_t import_count;
+  iree_vm_bytecode_import_counters_t* imports;
+} iree_vm_bytecode_profile_counters_t;
+
 // A loaded bytecode module.
 typedef struct {
   // Interface routing to the bytecode module functions.
@@ -71,6 +101,9 @@ typedef struct {
   // Type table mapping module type IDs to registered VM types.
   int32_t type_count;
   iree_vm_type_def_t* type_table;
+
+  // Profiling counters or NULL if profiling is not enabled.
+  iree_vm_bytecode_profile_counters_t* profile;
 } iree_vm_bytecode_module_t;
 
 // Per-instance module state.
@@ -101,6 +134,40 @@ typedef struct {
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
 
+// Module-level counts that bytecode operands are verified against.
+typedef struct {
+  // Number of internal functions that may be called.
+  int32_t function_count;
+  // Number of imported functions that may be called.
+  int32_t import_count;
+  // Number of entries in the module type table.
+  int32_t type_count;
+  // Number of rodata segments.
+  int32_t rodata_count;
+  // Size of the primitive global storage, in bytes.
+  int32_t global_bytes_capacity;
+  // Number of ref globals.
+  int32_t global_ref_count;
+} iree_vm_bytecode_module_limits_t;
+
+// Verifies the bytecode of the function described by |function_descriptor|
+// within the module |bytecode_data|. Returns IREE_STATUS_INVALID_ARGUMENT if
+// any instruction has an unknown opcode, is truncated, references registers
+// outside of the function's declared register counts, branches outside of
+// the function or into the middle of an instruction, or references globals,
+// rodata, types, or functions outside of |limits|. Functions must also end
+// with an instruction that does not fall through.
+//
+// The dispatcher relies on modules having been verified and only checks
+// operands that are not known until runtime (such as indirect globals).
+iree_status_t iree_vm_bytecode_function_verify(
+    iree_const_byte_span_t bytecode_data,
+    const iree_vm_function_descriptor_t* function_descriptor,
+    const iree_vm_bytecode_module_limits_t* limits, iree_allocator_t allocator);
+
+// Returns a monotonic timestamp in nanoseconds used for profiling.
+int64_t iree_vm_bytecode_profile_now_ns(void);
+
 // Begins (or resumes) execution of the given |entry_frame| and continues until
 // either a yield or return. |out_result| will contain the result status for
 // continuation, if needed.
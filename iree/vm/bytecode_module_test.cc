@@ -18,10 +18,170 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/api.h"
+#include "iree/schemas/bytecode_module_def_generated.h"
 #include "iree/testing/gtest.h"
+#include "iree/vm/module.h"
 
 namespace {
 
-// TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
+// Opcodes used by the tests below; see bytecode_op_table.h.
+constexpr uint8_t kOpConstI32 = 0x09;
+constexpr uint8_t kOpConstRefRodata = 0x0B;
+constexpr uint8_t kOpBranch = 0x50;
+constexpr uint8_t kOpCall = 0x52;
+constexpr uint8_t kOpReturn = 0x54;
+
+// Hand-assembles function bytecode in the serialized little-endian format.
+class BytecodeWriter {
+ public:
+  BytecodeWriter& u8(uint8_t value) {
+    bytes_.push_back(value);
+    return *this;
+  }
+  BytecodeWriter& u16(uint16_t value) {
+    return u8(value & 0xFF).u8((value >> 8) & 0xFF);
+  }
+  BytecodeWriter& u32(uint32_t value) {
+    return u16(value & 0xFFFF).u16((value >> 16) & 0xFFFF);
+  }
+  const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// Builds a module with a single exported function 'fn' containing |bytecode|
+// and tries to load it.
+iree_status_t CreateModuleWithBytecode(const std::vector<uint8_t>& bytecode,
+                                       int16_t i32_register_count,
+                                       int16_t ref_register_count) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto name = fbb.CreateString("module");
+  auto types =
+      fbb.CreateVector(std::vector<flatbuffers::Offset<iree::vm::TypeDef>>());
+  auto signature = iree::vm::CreateFunctionSignatureDef(fbb);
+  std::vector<flatbuffers::Offset<iree::vm::ExportFunctionDef>> exports = {
+      iree::vm::CreateExportFunctionDef(fbb, fbb.CreateString("fn"),
+                                        signature, 0)};
+  auto exports_offset = fbb.CreateVector(exports);
+  std::vector<flatbuffers::Offset<iree::vm::InternalFunctionDef>> functions = {
+      iree::vm::CreateInternalFunctionDef(fbb, fbb.CreateString("fn"),
+                                          signature)};
+  auto functions_offset = fbb.CreateVector(functions);
+  iree::vm::FunctionDescriptor descriptor(
+      0, static_cast<int32_t>(bytecode.size()), i32_register_count,
+      ref_register_count);
+  auto descriptors_offset = fbb.CreateVectorOfStructs(&descriptor, 1);
+  auto bytecode_offset = fbb.CreateVector(bytecode);
+
+  iree::vm::BytecodeModuleDefBuilder module_builder(fbb);
+  module_builder.add_name(name);
+  module_builder.add_types(types);
+  module_builder.add_exported_functions(exports_offset);
+  module_builder.add_internal_functions(functions_offset);
+  module_builder.add_function_descriptors(descriptors_offset);
+  module_builder.add_bytecode_data(bytecode_offset);
+  iree::vm::FinishBytecodeModuleDefBuffer(fbb, module_builder.Finish());
+
+  iree_vm_module_t* module = nullptr;
+  iree_status_t status = iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{fbb.GetBufferPointer(), fbb.GetSize()},
+      IREE_ALLOCATOR_NULL, IREE_ALLOCATOR_SYSTEM, &module);
+  if (module) iree_vm_module_release(module);
+  return status;
+}
+
+TEST(BytecodeModuleTest, VerifyValidBytecode) {
+  BytecodeWriter w;
+  w.u8(kOpConstI32).u32(42).u16(0);
+  w.u8(kOpReturn).u16(1).u16(0);
+  EXPECT_EQ(IREE_STATUS_OK, CreateModuleWithBytecode(w.bytes(), 1, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyRegisterOutOfRange) {
+  BytecodeWriter w;
+  w.u8(kOpConstI32).u32(42).u16(1);
+  w.u8(kOpReturn).u16(1).u16(1);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(w.bytes(), 1, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyUnknownOpcode) {
+  BytecodeWriter w;
+  w.u8(0x0C);  // Reserved.
+  w.u8(kOpReturn).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(w.bytes(), 0, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyTruncatedInstruction) {
+  BytecodeWriter w;
+  w.u8(kOpReturn).u16(2).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(w.bytes(), 1, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyFallthroughOffEnd) {
+  BytecodeWriter w;
+  w.u8(kOpConstI32).u32(42).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(w.bytes(), 1, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyBranchTargets) {
+  // Branching to an instruction (here a backward branch to the start of the
+  // function) is fine.
+  BytecodeWriter valid;
+  valid.u8(kOpBranch).u32(0).u16(0).u16(0);
+  EXPECT_EQ(IREE_STATUS_OK, CreateModuleWithBytecode(valid.bytes(), 0, 0));
+
+  // Branching into the middle of an instruction is not.
+  BytecodeWriter misaligned;
+  misaligned.u8(kOpBranch).u32(2).u16(0).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(misaligned.bytes(), 0, 0));
+
+  // Nor is branching outside of the function.
+  BytecodeWriter out_of_range;
+  out_of_range.u8(kOpBranch).u32(100).u16(0).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(out_of_range.bytes(), 0, 0));
+}
+
+TEST(BytecodeModuleTest, VerifyRodataOrdinal) {
+  // The module has no rodata segments.
+  BytecodeWriter w;
+  w.u8(kOpConstRefRodata).u32(0).u16(0x8000);
+  w.u8(kOpReturn).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(w.bytes(), 0, 1));
+}
+
+TEST(BytecodeModuleTest, VerifyCallOrdinals) {
+  // Calling the function itself is fine.
+  BytecodeWriter internal;
+  internal.u8(kOpCall).u32(0).u16(0).u16(0).u16(0);
+  internal.u8(kOpReturn).u16(0);
+  EXPECT_EQ(IREE_STATUS_OK, CreateModuleWithBytecode(internal.bytes(), 0, 0));
+
+  // The module has no imports.
+  BytecodeWriter import;
+  import.u8(kOpCall).u32(0x80000000u).u16(0).u16(0).u16(0);
+  import.u8(kOpReturn).u16(0);
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            CreateModuleWithBytecode(import.bytes(), 0, 0));
+}
+
+TEST(BytecodeModuleTest, OpcodeNames) {
+  auto name = iree_vm_bytecode_opcode_name(kOpReturn);
+  EXPECT_EQ("Return", std::string(name.data, name.size));
+  EXPECT_EQ(0, iree_vm_bytecode_opcode_name(0x0C).size);  // Reserved.
+}
 
 }  // namespace
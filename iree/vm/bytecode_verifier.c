@@ -0,0 +1,660 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Load-time verification of function bytecode.
+//
+// Each function is walked once when the module is created so that the
+// dispatch loop in bytecode_dispatch.c can trust the static operands encoded
+// in the bytecode without checking them on every instruction. Operand layouts
+// here must match those read by the dispatcher.
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_table.h"
+
+typedef struct {
+  const uint8_t* bytecode_data;
+  iree_vm_source_offset_t bytecode_length;
+  const iree_vm_function_descriptor_t* function_descriptor;
+  const iree_vm_bytecode_module_limits_t* limits;
+
+  // Bitmap with one bit per byte of bytecode set for each instruction start.
+  // Populated during the first pass and used during the second pass to verify
+  // that all branches land on an instruction.
+  uint8_t* instruction_starts;
+  bool verify_branch_targets;
+
+  iree_vm_source_offset_t pc;
+} iree_vm_bytecode_verifier_t;
+
+// Fails verification of the current function if |expr| is false.
+#define VERIFY(expr)                       \
+  do {                                     \
+    if (!(expr)) {                         \
+      return IREE_STATUS_INVALID_ARGUMENT; \
+    }                                      \
+  } while (0)
+
+//===----------------------------------------------------------------------===//
+// Primitive operands
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_vm_bytecode_verifier_skip(
+    iree_vm_bytecode_verifier_t* verifier, iree_vm_source_offset_t length) {
+  VERIFY(length >= 0 && verifier->pc + length <= verifier->bytecode_length);
+  verifier->pc += length;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_read_u16(
+    iree_vm_bytecode_verifier_t* verifier, uint16_t* out_value) {
+  VERIFY(verifier->pc + 2 <= verifier->bytecode_length);
+  const uint8_t* p = &verifier->bytecode_data[verifier->pc];
+  *out_value = (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+  verifier->pc += 2;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_read_i32(
+    iree_vm_bytecode_verifier_t* verifier, int32_t* out_value) {
+  VERIFY(verifier->pc + 4 <= verifier->bytecode_length);
+  const uint8_t* p = &verifier->bytecode_data[verifier->pc];
+  *out_value = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+  verifier->pc += 4;
+  return IREE_STATUS_OK;
+}
+
+//===----------------------------------------------------------------------===//
+// Registers
+//===----------------------------------------------------------------------===//
+
+static bool iree_vm_bytecode_verifier_is_valid_i32_reg(
+    iree_vm_bytecode_verifier_t* verifier, uint16_t reg) {
+  return (reg & IREE_REF_REGISTER_TYPE_BIT) == 0 &&
+         (reg & IREE_I32_REGISTER_MASK) <
+             verifier->function_descriptor->i32_register_count;
+}
+
+static bool iree_vm_bytecode_verifier_is_valid_i64_reg(
+    iree_vm_bytecode_verifier_t* verifier, uint16_t reg) {
+  return (reg & IREE_REF_REGISTER_TYPE_BIT) == 0 &&
+         (reg & IREE_I64_REGISTER_MASK) + 1 <
+             verifier->function_descriptor->i32_register_count;
+}
+
+static bool iree_vm_bytecode_verifier_is_valid_ref_reg(
+    iree_vm_bytecode_verifier_t* verifier, uint16_t reg) {
+  return (reg & IREE_REF_REGISTER_MASK) <
+         verifier->function_descriptor->ref_register_count;
+}
+
+// Verifies a register that carries its type in its high bits (as in the
+// variadic operand and result lists).
+static bool iree_vm_bytecode_verifier_is_valid_any_reg(
+    iree_vm_bytecode_verifier_t* verifier, uint16_t reg) {
+  if (reg & IREE_REF_REGISTER_TYPE_BIT) {
+    return iree_vm_bytecode_verifier_is_valid_ref_reg(verifier, reg);
+  } else if (reg & IREE_I64_REGISTER_BIT) {
+    return iree_vm_bytecode_verifier_is_valid_i64_reg(verifier, reg);
+  }
+  return iree_vm_bytecode_verifier_is_valid_i32_reg(verifier, reg);
+}
+
+typedef enum {
+  IREE_VM_BYTECODE_REG_I32 = 0,
+  IREE_VM_BYTECODE_REG_I64,
+  IREE_VM_BYTECODE_REG_REF,
+  IREE_VM_BYTECODE_REG_ANY,
+} iree_vm_bytecode_reg_kind_t;
+
+static iree_status_t iree_vm_bytecode_verifier_reg(
+    iree_vm_bytecode_verifier_t* verifier, iree_vm_bytecode_reg_kind_t kind) {
+  uint16_t reg = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_u16(verifier, &reg));
+  switch (kind) {
+    case IREE_VM_BYTECODE_REG_I32:
+      VERIFY(iree_vm_bytecode_verifier_is_valid_i32_reg(verifier, reg));
+      break;
+    case IREE_VM_BYTECODE_REG_I64:
+      VERIFY(iree_vm_bytecode_verifier_is_valid_i64_reg(verifier, reg));
+      break;
+    case IREE_VM_BYTECODE_REG_REF:
+      VERIFY(iree_vm_bytecode_verifier_is_valid_ref_reg(verifier, reg));
+      break;
+    case IREE_VM_BYTECODE_REG_ANY:
+      VERIFY(iree_vm_bytecode_verifier_is_valid_any_reg(verifier, reg));
+      break;
+  }
+  return IREE_STATUS_OK;
+}
+
+// Verifies a [u16 size][size registers] list.
+static iree_status_t iree_vm_bytecode_verifier_reg_list(
+    iree_vm_bytecode_verifier_t* verifier, iree_vm_bytecode_reg_kind_t kind) {
+  uint16_t size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_u16(verifier, &size));
+  for (int i = 0; i < size; ++i) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_reg(verifier, kind));
+  }
+  return IREE_STATUS_OK;
+}
+
+// Verifies a [u16 size][size (src, dst) pairs] list of branch remappings
+// within the bank of |kind|.
+static iree_status_t iree_vm_bytecode_verifier_remap_list(
+    iree_vm_bytecode_verifier_t* verifier, iree_vm_bytecode_reg_kind_t kind) {
+  uint16_t size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_u16(verifier, &size));
+  for (int i = 0; i < size * 2; ++i) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_reg(verifier, kind));
+  }
+  return IREE_STATUS_OK;
+}
+
+//===----------------------------------------------------------------------===//
+// Attributes
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_vm_bytecode_verifier_global_attr(
+    iree_vm_bytecode_verifier_t* verifier, int32_t value_size) {
+  int32_t byte_offset = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verifier_read_i32(verifier, &byte_offset));
+  VERIFY(byte_offset >= 0 &&
+         (int64_t)byte_offset + value_size <=
+             verifier->limits->global_bytes_capacity);
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_global_ref_attr(
+    iree_vm_bytecode_verifier_t* verifier) {
+  int32_t ordinal = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_i32(verifier, &ordinal));
+  VERIFY(ordinal >= 0 && ordinal < verifier->limits->global_ref_count);
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_rodata_attr(
+    iree_vm_bytecode_verifier_t* verifier) {
+  int32_t ordinal = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_i32(verifier, &ordinal));
+  VERIFY(ordinal >= 0 && ordinal < verifier->limits->rodata_count);
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_type_of(
+    iree_vm_bytecode_verifier_t* verifier) {
+  int32_t type_id = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_i32(verifier, &type_id));
+  VERIFY(type_id >= 0 && type_id < verifier->limits->type_count);
+  return IREE_STATUS_OK;
+}
+
+// Verifies a function ordinal with the high bit indicating an import.
+static iree_status_t iree_vm_bytecode_verifier_func_attr(
+    iree_vm_bytecode_verifier_t* verifier, bool allow_internal) {
+  int32_t function_ordinal = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verifier_read_i32(verifier, &function_ordinal));
+  if (function_ordinal & 0x80000000u) {
+    VERIFY((function_ordinal & 0x7FFFFFFFu) <
+           (uint32_t)verifier->limits->import_count);
+  } else {
+    VERIFY(allow_internal &&
+           function_ordinal < verifier->limits->function_count);
+  }
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_bytecode_verifier_str_attr(
+    iree_vm_bytecode_verifier_t* verifier) {
+  uint16_t length = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_u16(verifier, &length));
+  return iree_vm_bytecode_verifier_skip(verifier, length);
+}
+
+static iree_status_t iree_vm_bytecode_verifier_int16_array_attr(
+    iree_vm_bytecode_verifier_t* verifier) {
+  uint16_t count = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_u16(verifier, &count));
+  return iree_vm_bytecode_verifier_skip(verifier, count * 2);
+}
+
+//===----------------------------------------------------------------------===//
+// Control flow
+//===----------------------------------------------------------------------===//
+
+// Verifies a [i32 block pc][i32 remap list][ref remap list] branch.
+static iree_status_t iree_vm_bytecode_verifier_branch(
+    iree_vm_bytecode_verifier_t* verifier) {
+  int32_t block_pc = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_read_i32(verifier, &block_pc));
+  VERIFY(block_pc >= 0 && block_pc < verifier->bytecode_length);
+  if (verifier->verify_branch_targets) {
+    VERIFY(verifier->instruction_starts[block_pc / 8] & (1u << (block_pc % 8)));
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verifier_remap_list(verifier, IREE_VM_BYTECODE_REG_I32));
+  return iree_vm_bytecode_verifier_remap_list(verifier,
+                                              IREE_VM_BYTECODE_REG_REF);
+}
+
+// Verifies the [i32 remap list][ref register list] call arguments and the
+// result register list following them. Argument destinations are the callee
+// ABI registers and only need to fit within a frame.
+static iree_status_t iree_vm_bytecode_verifier_call_operands(
+    iree_vm_bytecode_verifier_t* verifier) {
+  uint16_t i32_count = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verifier_read_u16(verifier, &i32_count));
+  for (int i = 0; i < i32_count; ++i) {
+    uint16_t src_reg = 0;
+    uint16_t dst_reg = 0;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_verifier_read_u16(verifier, &src_reg));
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_verifier_read_u16(verifier, &dst_reg));
+    VERIFY(iree_vm_bytecode_verifier_is_valid_i32_reg(verifier, src_reg));
+    VERIFY(dst_reg < IREE_I32_REGISTER_COUNT);
+  }
+  uint16_t ref_count = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verifier_read_u16(verifier, &ref_count));
+  VERIFY(ref_count <= IREE_REF_REGISTER_COUNT);
+  for (int i = 0; i < ref_count; ++i) {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_verifier_reg(verifier, IREE_VM_BYTECODE_REG_REF));
+  }
+  return iree_vm_bytecode_verifier_reg_list(verifier, IREE_VM_BYTECODE_REG_ANY);
+}
+
+//===----------------------------------------------------------------------===//
+// Instructions
+//===----------------------------------------------------------------------===//
+
+#define VERIFY_REG(kind) \
+  IREE_RETURN_IF_ERROR(  \
+      iree_vm_bytecode_verifier_reg(verifier, IREE_VM_BYTECODE_REG_##kind))
+#define VERIFY_REG_LIST(kind) \
+  IREE_RETURN_IF_ERROR(       \
+      iree_vm_bytecode_verifier_reg_list(verifier, IREE_VM_BYTECODE_REG_##kind))
+#define VERIFY_SKIP(length) \
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_skip(verifier, length))
+#define VERIFY_BRANCH() \
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_branch(verifier))
+
+// Verifies the instruction at the current pc and advances past it.
+// |out_is_terminator| is set if execution never continues to the next
+// instruction.
+static iree_status_t iree_vm_bytecode_verifier_instruction(
+    iree_vm_bytecode_verifier_t* verifier, bool* out_is_terminator) {
+  *out_is_terminator = false;
+  VERIFY(verifier->pc < verifier->bytecode_length);
+  uint8_t opcode = verifier->bytecode_data[verifier->pc++];
+  switch (opcode) {
+    //===------------------------------------------------------------------===//
+    // Globals
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_GlobalLoadI32:
+    case IREE_VM_OP_GlobalStoreI32:
+    case IREE_VM_OP_GlobalLoadF32:
+    case IREE_VM_OP_GlobalStoreF32:
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_global_attr(verifier, 4));
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_GlobalLoadI64:
+    case IREE_VM_OP_GlobalStoreI64:
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_global_attr(verifier, 8));
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_GlobalLoadIndirectI32:
+    case IREE_VM_OP_GlobalStoreIndirectI32:
+      // The byte offset is only known at runtime and checked in dispatch.
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_GlobalLoadRef:
+    case IREE_VM_OP_GlobalStoreRef:
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_global_ref_attr(verifier));
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_type_of(verifier));
+      VERIFY_REG(REF);
+      break;
+    case IREE_VM_OP_GlobalLoadIndirectRef:
+    case IREE_VM_OP_GlobalStoreIndirectRef:
+      VERIFY_REG(I32);
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_type_of(verifier));
+      VERIFY_REG(REF);
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Constants
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_ConstI32:
+    case IREE_VM_OP_ConstF32:
+      VERIFY_SKIP(4);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_ConstI64:
+      VERIFY_SKIP(8);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_ConstI32Zero:
+    case IREE_VM_OP_ConstF32Zero:
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_ConstI64Zero:
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_ConstRefZero:
+      VERIFY_REG(REF);
+      break;
+    case IREE_VM_OP_ConstRefRodata:
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_rodata_attr(verifier));
+      VERIFY_REG(REF);
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Conditional assignment
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_SelectI32:
+    case IREE_VM_OP_SelectF32:
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_SelectI64:
+      VERIFY_REG(I32);
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_SelectRef:
+      VERIFY_REG(I32);
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_type_of(verifier));
+      VERIFY_REG(REF);
+      VERIFY_REG(REF);
+      VERIFY_REG(REF);
+      break;
+    case IREE_VM_OP_SwitchI32:
+      VERIFY_REG(I32);
+      VERIFY_SKIP(4);
+      VERIFY_REG_LIST(I32);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_SwitchRef:
+      VERIFY_REG(I32);
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_type_of(verifier));
+      VERIFY_REG(REF);
+      VERIFY_REG_LIST(REF);
+      VERIFY_REG(REF);
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Arithmetic, bitwise ops, casts and comparisons
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_NotI32:
+    case IREE_VM_OP_TruncI8:
+    case IREE_VM_OP_TruncI16:
+    case IREE_VM_OP_ExtI8I32S:
+    case IREE_VM_OP_ExtI16I32S:
+    case IREE_VM_OP_AbsF32:
+    case IREE_VM_OP_NegF32:
+    case IREE_VM_OP_CastSI32F32:
+    case IREE_VM_OP_CastUI32F32:
+    case IREE_VM_OP_CastF32SI32:
+    case IREE_VM_OP_CastF32UI32:
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_AddI32:
+    case IREE_VM_OP_SubI32:
+    case IREE_VM_OP_MulI32:
+    case IREE_VM_OP_DivI32S:
+    case IREE_VM_OP_DivI32U:
+    case IREE_VM_OP_RemI32S:
+    case IREE_VM_OP_RemI32U:
+    case IREE_VM_OP_AndI32:
+    case IREE_VM_OP_OrI32:
+    case IREE_VM_OP_XorI32:
+    case IREE_VM_OP_AddF32:
+    case IREE_VM_OP_SubF32:
+    case IREE_VM_OP_MulF32:
+    case IREE_VM_OP_DivF32:
+    case IREE_VM_OP_RemF32:
+    case IREE_VM_OP_CmpEQI32:
+    case IREE_VM_OP_CmpNEI32:
+    case IREE_VM_OP_CmpLTI32S:
+    case IREE_VM_OP_CmpLTI32U:
+    case IREE_VM_OP_CmpLTEI32S:
+    case IREE_VM_OP_CmpLTEI32U:
+    case IREE_VM_OP_CmpGTI32S:
+    case IREE_VM_OP_CmpGTI32U:
+    case IREE_VM_OP_CmpGTEI32S:
+    case IREE_VM_OP_CmpGTEI32U:
+    case IREE_VM_OP_CmpEQF32:
+    case IREE_VM_OP_CmpNEF32:
+    case IREE_VM_OP_CmpLTF32:
+    case IREE_VM_OP_CmpLTEF32:
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_AddI32Imm:
+    case IREE_VM_OP_SubI32Imm:
+    case IREE_VM_OP_MulI32Imm:
+    case IREE_VM_OP_AndI32Imm:
+    case IREE_VM_OP_OrI32Imm:
+    case IREE_VM_OP_XorI32Imm:
+      VERIFY_REG(I32);
+      VERIFY_SKIP(4);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_ShlI32:
+    case IREE_VM_OP_ShrI32S:
+    case IREE_VM_OP_ShrI32U:
+      VERIFY_REG(I32);
+      VERIFY_SKIP(1);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_NotI64:
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_AddI64:
+    case IREE_VM_OP_SubI64:
+    case IREE_VM_OP_MulI64:
+    case IREE_VM_OP_DivI64S:
+    case IREE_VM_OP_DivI64U:
+    case IREE_VM_OP_RemI64S:
+    case IREE_VM_OP_RemI64U:
+    case IREE_VM_OP_AndI64:
+    case IREE_VM_OP_OrI64:
+    case IREE_VM_OP_XorI64:
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_ShlI64:
+    case IREE_VM_OP_ShrI64S:
+    case IREE_VM_OP_ShrI64U:
+      VERIFY_REG(I64);
+      VERIFY_SKIP(1);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_TruncI64I32:
+      VERIFY_REG(I64);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_ExtI32I64S:
+    case IREE_VM_OP_ExtI32I64U:
+      VERIFY_REG(I32);
+      VERIFY_REG(I64);
+      break;
+    case IREE_VM_OP_CmpEQI64:
+    case IREE_VM_OP_CmpNEI64:
+    case IREE_VM_OP_CmpLTI64S:
+    case IREE_VM_OP_CmpLTI64U:
+    case IREE_VM_OP_CmpLTEI64S:
+    case IREE_VM_OP_CmpLTEI64U:
+      VERIFY_REG(I64);
+      VERIFY_REG(I64);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_CmpEQRef:
+    case IREE_VM_OP_CmpNERef:
+      VERIFY_REG(REF);
+      VERIFY_REG(REF);
+      VERIFY_REG(I32);
+      break;
+    case IREE_VM_OP_CmpNZRef:
+      VERIFY_REG(REF);
+      VERIFY_REG(I32);
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Control flow
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_Branch:
+    case IREE_VM_OP_Break:
+      VERIFY_BRANCH();
+      *out_is_terminator = true;
+      break;
+    case IREE_VM_OP_CondBranch:
+      VERIFY_REG(I32);
+      VERIFY_BRANCH();
+      VERIFY_BRANCH();
+      *out_is_terminator = true;
+      break;
+    case IREE_VM_OP_CondBreak:
+      VERIFY_REG(I32);
+      VERIFY_BRANCH();
+      *out_is_terminator = true;
+      break;
+    case IREE_VM_OP_CondBranchEQI32:
+    case IREE_VM_OP_CondBranchNEI32:
+    case IREE_VM_OP_CondBranchLTI32S:
+    case IREE_VM_OP_CondBranchLTI32U:
+    case IREE_VM_OP_CondBranchLTEI32S:
+    case IREE_VM_OP_CondBranchLTEI32U:
+    case IREE_VM_OP_CondBranchGTI32S:
+    case IREE_VM_OP_CondBranchGTI32U:
+    case IREE_VM_OP_CondBranchGTEI32S:
+    case IREE_VM_OP_CondBranchGTEI32U:
+      VERIFY_REG(I32);
+      VERIFY_REG(I32);
+      VERIFY_BRANCH();
+      VERIFY_BRANCH();
+      *out_is_terminator = true;
+      break;
+    case IREE_VM_OP_Call:
+      IREE_RETURN_IF_ERROR(
+          iree_vm_bytecode_verifier_func_attr(verifier, /*allow_internal=*/1));
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_call_operands(verifier));
+      break;
+    case IREE_VM_OP_CallVariadic:
+      // Variadic calls are currently only supported for import functions.
+      IREE_RETURN_IF_ERROR(
+          iree_vm_bytecode_verifier_func_attr(verifier, /*allow_internal=*/0));
+      IREE_RETURN_IF_ERROR(
+          iree_vm_bytecode_verifier_int16_array_attr(verifier));
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_call_operands(verifier));
+      break;
+    case IREE_VM_OP_Return:
+      VERIFY_REG_LIST(ANY);
+      *out_is_terminator = true;
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Async/fiber ops
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_Yield:
+      break;
+
+    //===------------------------------------------------------------------===//
+    // Debugging
+    //===------------------------------------------------------------------===//
+
+    case IREE_VM_OP_Trace:
+    case IREE_VM_OP_Print:
+      IREE_RETURN_IF_ERROR(iree_vm_bytecode_verifier_str_attr(verifier));
+      VERIFY_REG_LIST(ANY);
+      break;
+
+    default:
+      // Reserved or unknown opcode.
+      return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  return IREE_STATUS_OK;
+}
+
+// Walks all instructions in the function once. Returns the status of the first
+// instruction that failed verification.
+static iree_status_t iree_vm_bytecode_verifier_run(
+    iree_vm_bytecode_verifier_t* verifier) {
+  verifier->pc = 0;
+  bool is_terminator = false;
+  while (verifier->pc < verifier->bytecode_length) {
+    verifier->instruction_starts[verifier->pc / 8] |= 1u << (verifier->pc % 8);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_verifier_instruction(verifier, &is_terminator));
+  }
+  // Execution must never run off the end of the function.
+  VERIFY(is_terminator);
+  return IREE_STATUS_OK;
+}
+
+iree_status_t iree_vm_bytecode_function_verify(
+    iree_const_byte_span_t bytecode_data,
+    const iree_vm_function_descriptor_t* function_descriptor,
+    const iree_vm_bytecode_module_limits_t* limits,
+    iree_allocator_t allocator) {
+  VERIFY(function_descriptor->bytecode_offset >= 0 &&
+         function_descriptor->bytecode_length > 0 &&
+         (iree_host_size_t)function_descriptor->bytecode_offset +
+                 function_descriptor->bytecode_length <=
+             bytecode_data.data_length);
+
+  iree_vm_bytecode_verifier_t verifier;
+  memset(&verifier, 0, sizeof(verifier));
+  verifier.bytecode_data =
+      bytecode_data.data + function_descriptor->bytecode_offset;
+  verifier.bytecode_length = function_descriptor->bytecode_length;
+  verifier.function_descriptor = function_descriptor;
+  verifier.limits = limits;
+
+  iree_host_size_t bitmap_size = (verifier.bytecode_length + 7) / 8;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, bitmap_size, (void**)&verifier.instruction_starts));
+
+  // The first pass records where each instruction begins such that the second
+  // pass can check branch targets, including those of backward branches.
+  iree_status_t status = iree_vm_bytecode_verifier_run(&verifier);
+  if (iree_status_is_ok(status)) {
+    verifier.verify_branch_targets = true;
+    status = iree_vm_bytecode_verifier_run(&verifier);
+  }
+
+  iree_allocator_free(allocator, verifier.instruction_starts);
+  return status;
+}
@@ -0,0 +1,353 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/c_module.h"
+
+#include <string.h>
+
+#include "iree/base/atomics.h"
+
+// A module created from a generated descriptor.
+typedef struct {
+  // Interface routing to the module functions.
+  // Must be first in the struct as we dereference the interface to find our
+  // members below.
+  iree_vm_module_t interface;
+
+  const iree_vm_c_module_descriptor_t* descriptor;
+
+  // Allocator this module was allocated with and must be freed with.
+  iree_allocator_t allocator;
+} iree_vm_c_module_t;
+
+static iree_status_t iree_vm_c_module_destroy(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  return iree_allocator_free(module->allocator, module);
+}
+
+static iree_string_view_t iree_vm_c_module_name(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  return module->descriptor->name;
+}
+
+static iree_vm_module_signature_t iree_vm_c_module_signature(void* self) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  iree_vm_module_signature_t signature;
+  signature.import_function_count = module->descriptor->import_count;
+  signature.export_function_count = module->descriptor->export_count;
+  signature.internal_function_count = module->descriptor->function_count;
+  return signature;
+}
+
+static iree_status_t iree_vm_c_module_get_function(
+    void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
+    iree_vm_function_t* out_function, iree_string_view_t* out_name,
+    iree_vm_function_signature_t* out_signature) {
+  if (out_function) {
+    memset(out_function, 0, sizeof(iree_vm_function_t));
+  }
+  if (out_name) {
+    out_name->data = NULL;
+    out_name->size = 0;
+  }
+  if (out_signature) {
+    memset(out_signature, 0, sizeof(iree_vm_function_signature_t));
+  }
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_descriptor_t* descriptor = module->descriptor;
+
+  iree_string_view_t name;
+  memset(&name, 0, sizeof(name));
+  iree_vm_function_signature_t signature;
+  memset(&signature, 0, sizeof(signature));
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
+    if (ordinal < 0 || ordinal >= descriptor->import_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    const iree_vm_c_import_descriptor_t* import_descriptor =
+        &descriptor->imports[ordinal];
+    name = import_descriptor->full_name;
+    signature = import_descriptor->signature;
+    if (out_function) {
+      out_function->module = &module->interface;
+      out_function->linkage = linkage;
+      out_function->ordinal = ordinal;
+    }
+  } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    if (ordinal < 0 || ordinal >= descriptor->export_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    const iree_vm_c_export_descriptor_t* export_descriptor =
+        &descriptor->exports[ordinal];
+    name = export_descriptor->name;
+    signature =
+        descriptor->functions[export_descriptor->internal_ordinal].signature;
+    if (out_function) {
+      out_function->module = &module->interface;
+      out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+      out_function->ordinal = export_descriptor->internal_ordinal;
+    }
+  } else {
+    if (ordinal < 0 || ordinal >= descriptor->function_count) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    const iree_vm_c_function_descriptor_t* function_descriptor =
+        &descriptor->functions[ordinal];
+    name = function_descriptor->name;
+    signature = function_descriptor->signature;
+    if (out_function) {
+      out_function->module = &module->interface;
+      out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+      out_function->ordinal = ordinal;
+    }
+  }
+
+  if (out_name) *out_name = name;
+  if (out_signature) *out_signature = signature;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_get_function_reflection_attr(
+    void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
+    int32_t index, iree_string_view_t* key, iree_string_view_t* value) {
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+
+  if (linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+    iree_vm_function_t internal_function;
+    IREE_RETURN_IF_ERROR(iree_vm_c_module_get_function(
+        self, linkage, ordinal, &internal_function, NULL, NULL));
+    if (internal_function.linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+      // Imports have no reflection attributes.
+      return IREE_STATUS_NOT_FOUND;
+    }
+    ordinal = internal_function.ordinal;
+  }
+
+  if (ordinal < 0 || ordinal >= module->descriptor->function_count) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  const iree_vm_c_function_descriptor_t* function_descriptor =
+      &module->descriptor->functions[ordinal];
+  if (index < 0 || index >= function_descriptor->reflection_attr_count) {
+    return IREE_STATUS_NOT_FOUND;
+  }
+  *key = function_descriptor->reflection_attrs[index].key;
+  *value = function_descriptor->reflection_attrs[index].value;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_lookup_function(
+    void* self, iree_vm_function_linkage_t linkage, iree_string_view_t name,
+    iree_vm_function_t* out_function) {
+  if (!out_function) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_function, 0, sizeof(iree_vm_function_t));
+
+  if (!name.data || !name.size) return IREE_STATUS_INVALID_ARGUMENT;
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_descriptor_t* descriptor = module->descriptor;
+
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
+    for (int32_t ordinal = 0; ordinal < descriptor->import_count; ++ordinal) {
+      if (iree_string_view_compare(descriptor->imports[ordinal].full_name,
+                                   name) == 0) {
+        out_function->module = &module->interface;
+        out_function->linkage = linkage;
+        out_function->ordinal = ordinal;
+        return IREE_STATUS_OK;
+      }
+    }
+  } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    for (int32_t ordinal = 0; ordinal < descriptor->export_count; ++ordinal) {
+      if (iree_string_view_compare(descriptor->exports[ordinal].name, name) ==
+          0) {
+        out_function->module = &module->interface;
+        out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+        out_function->ordinal = descriptor->exports[ordinal].internal_ordinal;
+        return IREE_STATUS_OK;
+      }
+    }
+  } else {
+    for (int32_t ordinal = 0; ordinal < descriptor->function_count; ++ordinal) {
+      if (iree_string_view_compare(descriptor->functions[ordinal].name, name) ==
+          0) {
+        out_function->module = &module->interface;
+        out_function->linkage = IREE_VM_FUNCTION_LINKAGE_INTERNAL;
+        out_function->ordinal = ordinal;
+        return IREE_STATUS_OK;
+      }
+    }
+  }
+  return IREE_STATUS_NOT_FOUND;
+}
+
+static iree_status_t iree_vm_c_module_alloc_state(
+    void* self, iree_allocator_t allocator,
+    iree_vm_module_state_t** out_module_state) {
+  if (!out_module_state) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_module_state = NULL;
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  const iree_vm_c_module_descriptor_t* descriptor = module->descriptor;
+
+  iree_host_size_t total_state_struct_size = sizeof(iree_vm_c_module_state_t);
+  total_state_struct_size += descriptor->global_bytes_capacity;
+  total_state_struct_size +=
+      descriptor->global_ref_count * sizeof(iree_vm_ref_t);
+  total_state_struct_size +=
+      descriptor->rodata_count * sizeof(iree_vm_ro_byte_buffer_t);
+  total_state_struct_size +=
+      descriptor->import_count * sizeof(iree_vm_function_t);
+
+  iree_vm_c_module_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, total_state_struct_size,
+                                             (void**)&state));
+  state->allocator = allocator;
+
+  uint8_t* p = ((uint8_t*)state) + sizeof(iree_vm_c_module_state_t);
+  state->rwdata_storage.data = p;
+  state->rwdata_storage.data_length = descriptor->global_bytes_capacity;
+  p += descriptor->global_bytes_capacity;
+  state->global_ref_count = descriptor->global_ref_count;
+  state->global_ref_table = (iree_vm_ref_t*)p;
+  p += descriptor->global_ref_count * sizeof(*state->global_ref_table);
+  state->rodata_ref_count = descriptor->rodata_count;
+  state->rodata_ref_table = (iree_vm_ro_byte_buffer_t*)p;
+  p += descriptor->rodata_count * sizeof(*state->rodata_ref_table);
+  state->import_count = descriptor->import_count;
+  state->import_table = (iree_vm_function_t*)p;
+  p += descriptor->import_count * sizeof(*state->import_table);
+
+  for (int32_t i = 0; i < descriptor->rodata_count; ++i) {
+    iree_vm_ro_byte_buffer_t* ref = &state->rodata_ref_table[i];
+    iree_atomic_store(&ref->ref_object.counter, 1);
+    ref->data = descriptor->rodata_segments[i];
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_free_state(
+    void* self, iree_vm_module_state_t* module_state) {
+  iree_vm_c_module_state_t* state = (iree_vm_c_module_state_t*)module_state;
+  if (!state) return IREE_STATUS_INVALID_ARGUMENT;
+
+  // Release remaining global references.
+  for (int32_t i = 0; i < state->global_ref_count; ++i) {
+    iree_vm_ref_release(&state->global_ref_table[i]);
+  }
+
+  return iree_allocator_free(state->allocator, state);
+}
+
+static iree_status_t iree_vm_c_module_resolve_import(
+    void* self, iree_vm_module_state_t* module_state, int32_t ordinal,
+    iree_vm_function_t function) {
+  iree_vm_c_module_state_t* state = (iree_vm_c_module_state_t*)module_state;
+  if (!state) return IREE_STATUS_INVALID_ARGUMENT;
+  if (ordinal < 0 || ordinal >= state->import_count) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  state->import_table[ordinal] = function;
+  return IREE_STATUS_OK;
+}
+
+static iree_status_t iree_vm_c_module_execute(
+    void* self, iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    iree_vm_execution_result_t* out_result) {
+  if (!out_result) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+  if (!stack || !frame) return IREE_STATUS_INVALID_ARGUMENT;
+  if (frame->function.linkage != IREE_VM_FUNCTION_LINKAGE_INTERNAL) {
+    IREE_RETURN_IF_ERROR(iree_vm_c_module_get_function(
+        self, frame->function.linkage, frame->function.ordinal,
+        &frame->function, NULL, NULL));
+  }
+
+  iree_vm_c_module_t* module = (iree_vm_c_module_t*)self;
+  if (frame->function.ordinal < 0 ||
+      frame->function.ordinal >= module->descriptor->function_count) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  const iree_vm_c_function_descriptor_t* function_descriptor =
+      &module->descriptor->functions[frame->function.ordinal];
+  return function_descriptor->shim(
+      stack, frame, (iree_vm_c_module_state_t*)frame->module_state);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_create(
+    const iree_vm_c_module_descriptor_t* descriptor, iree_allocator_t allocator,
+    iree_vm_module_t** out_module) {
+  if (!out_module) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_module = NULL;
+  if (!descriptor) return IREE_STATUS_INVALID_ARGUMENT;
+
+  iree_vm_c_module_t* module = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*module), (void**)&module));
+  module->descriptor = descriptor;
+  module->allocator = allocator;
+
+  iree_vm_module_init(&module->interface, module);
+  module->interface.destroy = iree_vm_c_module_destroy;
+  module->interface.name = iree_vm_c_module_name;
+  module->interface.signature = iree_vm_c_module_signature;
+  module->interface.get_function = iree_vm_c_module_get_function;
+  module->interface.lookup_function = iree_vm_c_module_lookup_function;
+  module->interface.alloc_state = iree_vm_c_module_alloc_state;
+  module->interface.free_state = iree_vm_c_module_free_state;
+  module->interface.resolve_import = iree_vm_c_module_resolve_import;
+  module->interface.execute = iree_vm_c_module_execute;
+  module->interface.get_function_reflection_attr =
+      iree_vm_c_module_get_function_reflection_attr;
+
+  *out_module = &module->interface;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_enter_import(
+    iree_vm_stack_t* stack, iree_vm_c_module_state_t* state, int32_t ordinal,
+    int32_t i32_register_count, int32_t ref_register_count,
+    iree_vm_stack_frame_t** out_callee_frame) {
+  if (ordinal < 0 || ordinal >= state->import_count ||
+      !state->import_table[ordinal].module) {
+    // Import was not resolved when the module was registered.
+    return IREE_STATUS_NOT_FOUND;
+  }
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+      stack, state->import_table[ordinal], out_callee_frame));
+  iree_status_t status = iree_vm_stack_frame_reserve_registers(
+      stack, *out_callee_frame, i32_register_count, ref_register_count);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_stack_function_leave(stack);
+    *out_callee_frame = NULL;
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_call_import(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame) {
+  iree_vm_module_t* target_module = callee_frame->function.module;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  // Generated functions cannot be resumed at their call sites so imports that
+  // suspend are resumed in place until they complete.
+  do {
+    IREE_RETURN_IF_ERROR(target_module->execute(target_module->self, stack,
+                                                callee_frame, &result));
+  } while (result.wait_type != IREE_VM_WAIT_NONE);
+  return IREE_STATUS_OK;
+}
@@ -0,0 +1,184 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runtime support for VM modules compiled ahead-of-time to C source.
+//
+// The compiler C target (-iree-vm-ir-to-c-module) translates each vm.func to a
+// native C function and emits a static iree_vm_c_module_descriptor_t
+// describing the module. iree_vm_c_module_create wraps that descriptor in the
+// standard iree_vm_module_t interface such that AOT modules can be registered
+// in contexts, called, and linked against other modules exactly like bytecode
+// modules.
+//
+// The declarations below are the contract between the generated source and the
+// runtime and are not intended to be used directly by hosting applications.
+
+#ifndef IREE_VM_C_MODULE_H_
+#define IREE_VM_C_MODULE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/module.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/stack.h"
+#include "iree/vm/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Per-instance module state.
+// This is allocated with a provided allocator as a single flat allocation and
+// matches the layout used by bytecode modules.
+typedef struct iree_vm_c_module_state {
+  // Combined rwdata storage for the entire module, including globals.
+  iree_byte_span_t rwdata_storage;
+
+  // Global ref_ptr values, indexed by global ordinal.
+  int32_t global_ref_count;
+  iree_vm_ref_t* global_ref_table;
+
+  // Initialized references to rodata segments.
+  int32_t rodata_ref_count;
+  iree_vm_ro_byte_buffer_t* rodata_ref_table;
+
+  // Resolved function imports.
+  int32_t import_count;
+  iree_vm_function_t* import_table;
+
+  // Allocator used for the state itself and any runtime allocations needed.
+  iree_allocator_t allocator;
+} iree_vm_c_module_state_t;
+
+// Entry point of a generated function.
+// Reads the arguments from the |frame| registers (left-aligned in each bank as
+// defined by the VM ABI), runs the function, and writes the results back to the
+// |frame| registers referenced by |frame|->return_registers.
+typedef iree_status_t(IREE_API_PTR* iree_vm_c_function_shim_t)(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
+    iree_vm_c_module_state_t* state);
+
+// A reflection attribute key-value pair attached to a function.
+typedef struct {
+  iree_string_view_t key;
+  iree_string_view_t value;
+} iree_vm_c_reflection_attr_t;
+
+// Describes an internal function, indexed by internal ordinal.
+typedef struct {
+  iree_string_view_t name;
+  iree_vm_function_signature_t signature;
+  iree_vm_c_function_shim_t shim;
+  int32_t reflection_attr_count;
+  const iree_vm_c_reflection_attr_t* reflection_attrs;
+} iree_vm_c_function_descriptor_t;
+
+// Describes an exported function, indexed by export ordinal.
+typedef struct {
+  iree_string_view_t name;
+  int32_t internal_ordinal;
+} iree_vm_c_export_descriptor_t;
+
+// Describes an imported function, indexed by import ordinal.
+typedef struct {
+  iree_string_view_t full_name;
+  iree_vm_function_signature_t signature;
+} iree_vm_c_import_descriptor_t;
+
+// Static description of a generated module.
+// Must remain valid for the lifetime of all modules created from it; generated
+// descriptors are stored in static read-only memory.
+typedef struct {
+  iree_string_view_t name;
+
+  int32_t import_count;
+  const iree_vm_c_import_descriptor_t* imports;
+  int32_t export_count;
+  const iree_vm_c_export_descriptor_t* exports;
+  int32_t function_count;
+  const iree_vm_c_function_descriptor_t* functions;
+
+  int32_t rodata_count;
+  const iree_const_byte_span_t* rodata_segments;
+
+  int32_t global_bytes_capacity;
+  int32_t global_ref_count;
+} iree_vm_c_module_descriptor_t;
+
+// Returns |frame|'s |i|th return register. If the callee did not provide a
+// return register list the results are assumed to be left-aligned and
+// |default_reg| is used instead.
+static inline uint16_t iree_vm_c_result_register(
+    const iree_vm_stack_frame_t* frame, int i, uint16_t default_reg) {
+  return frame->return_registers ? frame->return_registers->registers[i]
+                                 : default_reg;
+}
+
+// Accessors for primitive values in a register bank.
+#define IREE_VM_C_REG_I32(regs, reg) \
+  ((regs)->i32[(reg)&IREE_I32_REGISTER_MASK])
+#define IREE_VM_C_REG_I64(regs, reg) \
+  (*(int64_t*)&(regs)->i32[(reg)&IREE_I64_REGISTER_MASK])
+#define IREE_VM_C_REG_F32(regs, reg) \
+  (*(float*)&(regs)->i32[(reg)&IREE_I32_REGISTER_MASK])
+#define IREE_VM_C_REG_REF(regs, reg) ((regs)->ref[(reg)&IREE_REF_REGISTER_MASK])
+
+// Accessors for primitive globals at |byte_offset| in the module state.
+#define IREE_VM_C_GLOBAL(state, type, byte_offset) \
+  (*(type*)((state)->rwdata_storage.data + (byte_offset)))
+
+// Evaluates |expr| and jumps to the exit label of the generated function with
+// |status| set if it fails.
+#define IREE_VM_C_CHECK_OK(expr)      \
+  do {                                \
+    status = (expr);                  \
+    if (!iree_status_is_ok(status)) { \
+      goto exit;                      \
+    }                                 \
+  } while (0)
+
+#ifndef IREE_API_NO_PROTOTYPES
+
+// Creates a VM module implemented by the generated C functions in
+// |descriptor|.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_create(
+    const iree_vm_c_module_descriptor_t* descriptor, iree_allocator_t allocator,
+    iree_vm_module_t** out_module);
+
+// Enters the imported function |ordinal| and returns the callee frame with
+// |i32_register_count| and |ref_register_count| argument registers reserved.
+// Callers must populate the argument registers of the callee frame as defined
+// by the VM ABI and then call iree_vm_c_module_call_import.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_enter_import(
+    iree_vm_stack_t* stack, iree_vm_c_module_state_t* state, int32_t ordinal,
+    int32_t i32_register_count, int32_t ref_register_count,
+    iree_vm_stack_frame_t** out_callee_frame);
+
+// Executes the import entered with iree_vm_c_module_enter_import.
+// Results are left in the |callee_frame| registers for the caller to read
+// before leaving the frame with iree_vm_stack_function_leave.
+//
+// Generated functions cannot be resumed mid-function so imports that suspend
+// are resumed in place until they complete.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_c_module_call_import(
+    iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame);
+
+#endif  // IREE_API_NO_PROTOTYPES
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_C_MODULE_H_
@@ -20,6 +20,11 @@
 
 #include "iree/base/atomics.h"
 
+// Maximum number of idle stacks retained by each context for reuse.
+#ifndef IREE_VM_CONTEXT_STACK_POOL_CAPACITY
+#define IREE_VM_CONTEXT_STACK_POOL_CAPACITY 4
+#endif  // !IREE_VM_CONTEXT_STACK_POOL_CAPACITY
+
 struct iree_vm_context {
   iree_atomic_intptr_t ref_count;
   iree_vm_instance_t* instance;
@@ -33,10 +38,38 @@ struct iree_vm_context {
     iree_vm_module_t** modules;
     iree_vm_module_state_t** module_states;
   } list;
+
+  // Idle stacks available for reuse by invocations.
+  struct {
+    // Non-zero while the pool is being modified; see
+    // iree_vm_context_stack_pool_try_lock.
+    iree_atomic_intptr_t lock;
+    iree_host_size_t count;
+    iree_vm_stack_t* stacks[IREE_VM_CONTEXT_STACK_POOL_CAPACITY];
+  } stack_pool;
 };
 
 static iree_status_t iree_vm_context_destroy(iree_vm_context_t* context);
 
+// Tries to lock the stack pool of |context| without blocking.
+// Contention is expected to be rare and callers fall back to allocating or
+// freeing stacks when the pool is busy.
+static bool iree_vm_context_stack_pool_try_lock(iree_vm_context_t* context) {
+  if (iree_atomic_fetch_add(&context->stack_pool.lock, 1) == 0) return true;
+  iree_atomic_fetch_sub(&context->stack_pool.lock, 1);
+  return false;
+}
+
+static void iree_vm_context_stack_pool_unlock(iree_vm_context_t* context) {
+  iree_atomic_fetch_sub(&context->stack_pool.lock, 1);
+}
+
+static void iree_vm_context_free_stack(iree_vm_context_t* context,
+                                       iree_vm_stack_t* stack) {
+  iree_vm_stack_deinit(stack);
+  iree_allocator_free(context->allocator, stack);
+}
+
 static iree_status_t iree_vm_context_query_module_state(
     void* state_resolver, iree_vm_module_t* module,
     iree_vm_module_state_t** out_module_state) {
@@ -95,9 +128,12 @@ static iree_status_t iree_vm_invoke_empty_function(
     return status;
   }
 
+  // Initializers run synchronously so any yields are resumed immediately.
   iree_vm_execution_result_t result;
-  status = function.module->execute(function.module->self, stack, callee_frame,
-                                    &result);
+  do {
+    status = function.module->execute(function.module->self, stack,
+                                      callee_frame, &result);
+  } while (iree_status_is_ok(status) && result.wait_type != IREE_VM_WAIT_NONE);
 
   iree_vm_stack_function_leave(stack);
   return status;
@@ -210,24 +246,17 @@ static iree_status_t iree_vm_context_destroy(iree_vm_context_t* context) {
   }
 
   if (context->list.count > 0) {
-    // Allocate a scratch stack used for initialization.
-    // If we shrunk the stack (or made it so that it could dynamically grow)
-    // then we could stack-allocate it here and not need the allocator at all.
+    // Use a scratch stack for running module deinitializers.
     iree_vm_stack_t* stack = NULL;
-    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-        context->allocator, sizeof(iree_vm_stack_t), (void**)&stack));
-    iree_status_t status =
-        iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
-    if (!iree_status_is_ok(status)) {
-      iree_allocator_free(context->allocator, stack);
-      return status;
-    }
-
+    IREE_RETURN_IF_ERROR(iree_vm_context_acquire_stack(context, &stack));
     iree_vm_context_release_modules(context, stack, 0, context->list.count - 1);
+    iree_vm_context_release_stack(context, stack);
+  }
 
-    iree_vm_stack_deinit(stack);
-    iree_allocator_free(context->allocator, stack);
+  for (iree_host_size_t i = 0; i < context->stack_pool.count; ++i) {
+    iree_vm_context_free_stack(context, context->stack_pool.stacks[i]);
   }
+  context->stack_pool.count = 0;
 
   // Note: For non-static module lists, it is only dynamically allocated if
   // capacity > 0.
@@ -262,6 +291,11 @@ iree_vm_context_release(iree_vm_context_t* context) {
   return IREE_STATUS_OK;
 }
 
+IREE_API_EXPORT iree_vm_instance_t* IREE_API_CALL
+iree_vm_context_instance(const iree_vm_context_t* context) {
+  return context ? context->instance : NULL;
+}
+
 IREE_API_EXPORT int32_t IREE_API_CALL
 iree_vm_context_id(const iree_vm_context_t* context) {
   if (!context) {
@@ -325,18 +359,9 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
     context->list.capacity = new_capacity;
   }
 
-  // Allocate a scratch stack used for initialization.
-  // If we shrunk the stack (or made it so that it could dynamically grow)
-  // then we could stack-allocate it here and not need the allocator at all.
+  // Use a scratch stack for running module initializers.
   iree_vm_stack_t* stack = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      context->allocator, sizeof(iree_vm_stack_t), (void**)&stack));
-  iree_status_t status =
-      iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
-  if (!iree_status_is_ok(status)) {
-    iree_allocator_free(context->allocator, stack);
-    return status;
-  }
+  IREE_RETURN_IF_ERROR(iree_vm_context_acquire_stack(context, &stack));
 
   // Retain all modules and allocate their state.
   assert(context->list.capacity >= context->list.count + module_count);
@@ -357,8 +382,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
       iree_vm_context_release_modules(context, stack, orig_count,
                                       orig_count + i);
       context->list.count = orig_count;
-      iree_vm_stack_deinit(stack);
-      iree_allocator_free(context->allocator, stack);
+      iree_vm_context_release_stack(context, stack);
       return alloc_status;
     }
     context->list.module_states[orig_count + i] = module_state;
@@ -372,8 +396,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
       iree_vm_context_release_modules(context, stack, orig_count,
                                       orig_count + i);
       context->list.count = orig_count;
-      iree_vm_stack_deinit(stack);
-      iree_allocator_free(context->allocator, stack);
+      iree_vm_context_release_stack(context, stack);
       return resolve_status;
     }
 
@@ -393,18 +416,61 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
         iree_vm_context_release_modules(context, stack, orig_count,
                                         orig_count + i);
         context->list.count = orig_count;
-        iree_vm_stack_deinit(stack);
-        iree_allocator_free(context->allocator, stack);
+        iree_vm_context_release_stack(context, stack);
         return init_status;
       }
     }
   }
 
-  iree_vm_stack_deinit(stack);
-  iree_allocator_free(context->allocator, stack);
+  iree_vm_context_release_stack(context, stack);
   return IREE_STATUS_OK;
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_acquire_stack(
+    iree_vm_context_t* context, iree_vm_stack_t** out_stack) {
+  if (!out_stack) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_stack = NULL;
+  if (!context) return IREE_STATUS_INVALID_ARGUMENT;
+
+  if (iree_vm_context_stack_pool_try_lock(context)) {
+    if (context->stack_pool.count > 0) {
+      *out_stack = context->stack_pool.stacks[--context->stack_pool.count];
+    }
+    iree_vm_context_stack_pool_unlock(context);
+    if (*out_stack) return IREE_STATUS_OK;
+  }
+
+  iree_vm_stack_t* stack = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      context->allocator, sizeof(iree_vm_stack_t), (void**)&stack));
+  iree_status_t status = iree_vm_stack_init(
+      iree_vm_context_state_resolver(context), context->allocator, stack);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(context->allocator, stack);
+    return status;
+  }
+  *out_stack = stack;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_release_stack(
+    iree_vm_context_t* context, iree_vm_stack_t* stack) {
+  if (!context || !stack) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_status_t status = iree_vm_stack_reset(stack);
+  if (iree_status_is_ok(status) &&
+      iree_vm_context_stack_pool_try_lock(context)) {
+    bool pooled = false;
+    if (context->stack_pool.count < IREE_VM_CONTEXT_STACK_POOL_CAPACITY) {
+      context->stack_pool.stacks[context->stack_pool.count++] = stack;
+      pooled = true;
+    }
+    iree_vm_context_stack_pool_unlock(context);
+    if (pooled) return IREE_STATUS_OK;
+  }
+  iree_vm_context_free_stack(context, stack);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_resolve_function(
     const iree_vm_context_t* context, iree_string_view_t full_name,
     iree_vm_function_t* out_function) {
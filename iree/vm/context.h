@@ -67,6 +67,10 @@ iree_vm_context_release(iree_vm_context_t* context);
 IREE_API_EXPORT int32_t IREE_API_CALL
 iree_vm_context_id(const iree_vm_context_t* context);
 
+// Returns the instance the |context| was created within.
+IREE_API_EXPORT iree_vm_instance_t* IREE_API_CALL
+iree_vm_context_instance(const iree_vm_context_t* context);
+
 // Returns a state resolver setup to use the |context| for resolving module
 // state.
 IREE_API_EXPORT iree_vm_state_resolver_t IREE_API_CALL
@@ -86,6 +90,18 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_resolve_function(
     const iree_vm_context_t* context, iree_string_view_t full_name,
     iree_vm_function_t* out_function);
 
+// Acquires a stack for executing functions within |context|.
+// Stacks are pooled by the context and retain their storage so that
+// invocations on a warm stack do not allocate. The stack must be returned with
+// iree_vm_context_release_stack.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_acquire_stack(
+    iree_vm_context_t* context, iree_vm_stack_t** out_stack);
+
+// Leaves any frames remaining on |stack| and returns it to the pool of
+// |context| it was acquired from.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_release_stack(
+    iree_vm_context_t* context, iree_vm_stack_t* stack);
+
 #endif  // IREE_API_NO_PROTOTYPES
 
 #ifdef __cplusplus
@@ -0,0 +1,350 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/executor.h"
+
+#include <algorithm>
+#include <set>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/base/api_util.h"
+#include "iree/base/ref_ptr.h"
+#include "iree/base/tracing.h"
+
+namespace {
+
+// Orders tasks by descending priority, then ascending deadline, then
+// submission order.
+struct TaskOrder {
+  bool operator()(const iree_vm_executor_task_t* a,
+                  const iree_vm_executor_task_t* b) const {
+    if (a->priority != b->priority) return a->priority > b->priority;
+    if (a->deadline != b->deadline) return a->deadline < b->deadline;
+    return a->sequence < b->sequence;
+  }
+};
+
+}  // namespace
+
+struct iree_vm_executor {
+  iree_allocator_t allocator;
+  int32_t worker_count = 1;
+
+  absl::Mutex mutex;
+  bool has_shutdown ABSL_GUARDED_BY(mutex) = false;
+  uint64_t next_sequence ABSL_GUARDED_BY(mutex) = 0;
+  // Tasks waiting to execute, in execution order.
+  std::set<iree_vm_executor_task_t*, TaskOrder> pending_tasks
+      ABSL_GUARDED_BY(mutex);
+  // Exclusive keys of tasks currently executing.
+  absl::flat_hash_set<const void*> busy_keys ABSL_GUARDED_BY(mutex);
+  // Number of worker threads waiting for tasks.
+  int32_t idle_worker_count ABSL_GUARDED_BY(mutex) = 0;
+  std::vector<std::thread> threads ABSL_GUARDED_BY(mutex);
+  // Events set when the task they are keyed on completes. Only tasks that have
+  // been waited on with ExecutorTaskOnComplete have an event.
+  absl::flat_hash_map<iree_vm_executor_task_t*,
+                      iree::ref_ptr<iree::ManualResetEvent>>
+      completion_events ABSL_GUARDED_BY(mutex);
+
+  // Set when the executor was destroyed from one of its own workers (such as
+  // when a task release drops the last reference to the owning instance). The
+  // worker frees the executor once it unwinds back to ThreadMain.
+  bool free_on_worker_exit = false;
+
+  // Returns the highest-ordered task that can execute at |now|, if any.
+  iree_vm_executor_task_t* PeekRunnableTask(iree_time_t now)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    for (auto* task : pending_tasks) {
+      if (task->resume_time > now) continue;
+      if (!task->exclusive_key || !busy_keys.contains(task->exclusive_key)) {
+        return task;
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns the earliest time after |now| at which a suspended task may
+  // resume or IREE_TIME_INFINITE_FUTURE if there are none.
+  iree_time_t NextResumeTime(iree_time_t now)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    iree_time_t resume_time = IREE_TIME_INFINITE_FUTURE;
+    for (auto* task : pending_tasks) {
+      if (task->resume_time > now) {
+        resume_time = std::min(resume_time, task->resume_time);
+      }
+    }
+    return resume_time;
+  }
+
+  // Marks |task| as complete with |status| and signals any waiters.
+  void CompleteTask(iree_vm_executor_task_t* task, iree_status_t status)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    task->status = status;
+    task->state = IREE_VM_EXECUTOR_TASK_COMPLETE;
+    auto it = completion_events.find(task);
+    if (it != completion_events.end()) {
+      it->second->Set().IgnoreError();
+      completion_events.erase(it);
+    }
+  }
+
+  void ThreadMain();
+  void Execute(iree_vm_executor_task_t* task) ABSL_LOCKS_EXCLUDED(mutex);
+};
+
+void iree_vm_executor::ThreadMain() {
+  IREE_TRACE_THREAD_ENABLE("vm_executor");
+  while (true) {
+    iree_vm_executor_task_t* task = nullptr;
+    {
+      absl::MutexLock lock(&mutex);
+      ++idle_worker_count;
+      auto has_work = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+        return has_shutdown ||
+               PeekRunnableTask(absl::ToUnixNanos(absl::Now())) != nullptr;
+      };
+      // Suspended tasks become runnable with the passage of time and not a
+      // change in state so we also wake for the earliest resume time.
+      while (!has_work()) {
+        mutex.AwaitWithDeadline(
+            absl::Condition(&has_work),
+            iree::ToAbslTime(NextResumeTime(absl::ToUnixNanos(absl::Now()))));
+      }
+      --idle_worker_count;
+      if (has_shutdown) return;
+      task = PeekRunnableTask(absl::ToUnixNanos(absl::Now()));
+      pending_tasks.erase(task);
+      task->state = IREE_VM_EXECUTOR_TASK_RUNNING;
+      if (task->exclusive_key) busy_keys.insert(task->exclusive_key);
+    }
+    Execute(task);
+
+    // Only ever set by this thread from within Execute.
+    if (free_on_worker_exit) {
+      iree_allocator_t allocator = this->allocator;
+      this->~iree_vm_executor();
+      iree_allocator_free(allocator, this);
+      return;
+    }
+  }
+}
+
+void iree_vm_executor::Execute(iree_vm_executor_task_t* task) {
+  IREE_TRACE_SCOPE0("iree_vm_executor::Execute");
+
+  iree_status_t status = IREE_STATUS_OK;
+  if (task->deadline != IREE_TIME_INFINITE_FUTURE &&
+      absl::ToUnixNanos(absl::Now()) > task->deadline) {
+    // Skip the work entirely if no one cares about the result anymore.
+    status = IREE_STATUS_DEADLINE_EXCEEDED;
+  } else {
+    status = task->execute(task);
+  }
+
+  // Tasks without a release callback may be destroyed as soon as they are
+  // observed complete so we must not touch them after that point.
+  auto release = task->release;
+  {
+    absl::MutexLock lock(&mutex);
+    if (task->exclusive_key) busy_keys.erase(task->exclusive_key);
+    if (status == IREE_STATUS_UNAVAILABLE && !task->abort_requested &&
+        !has_shutdown) {
+      // The task suspended; requeue it behind other tasks of the same order so
+      // that they get a chance to run in the meantime.
+      task->sequence = next_sequence++;
+      task->state = IREE_VM_EXECUTOR_TASK_PENDING;
+      pending_tasks.insert(task);
+      return;
+    } else if (status == IREE_STATUS_UNAVAILABLE) {
+      status = has_shutdown ? IREE_STATUS_CANCELLED : IREE_STATUS_ABORTED;
+    }
+    if (task->abort_requested && iree_status_is_ok(status)) {
+      status = IREE_STATUS_ABORTED;
+    }
+    CompleteTask(task, status);
+  }
+  if (release) release(task);
+}
+
+extern "C" {
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_create(
+    int32_t worker_count, iree_allocator_t allocator,
+    iree_vm_executor_t** out_executor) {
+  if (!out_executor) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_executor = nullptr;
+  if (worker_count < 0) return IREE_STATUS_INVALID_ARGUMENT;
+
+  iree_vm_executor_t* executor = nullptr;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, sizeof(*executor), reinterpret_cast<void**>(&executor)));
+  new (executor) iree_vm_executor();
+  executor->allocator = allocator;
+  executor->worker_count =
+      worker_count > 0
+          ? worker_count
+          : std::max(1, static_cast<int32_t>(
+                            std::thread::hardware_concurrency()));
+
+  *out_executor = executor;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_executor_destroy(iree_vm_executor_t* executor) {
+  if (!executor) return;
+  IREE_TRACE_SCOPE0("iree_vm_executor_destroy");
+
+  std::vector<std::pair<iree_vm_executor_task_t*,
+                        void(IREE_API_PTR*)(iree_vm_executor_task_t*)>>
+      cancelled_tasks;
+  std::vector<std::thread> threads;
+  {
+    absl::MutexLock lock(&executor->mutex);
+    executor->has_shutdown = true;
+    for (auto* task : executor->pending_tasks) {
+      cancelled_tasks.emplace_back(task, task->release);
+      executor->CompleteTask(task, IREE_STATUS_CANCELLED);
+    }
+    executor->pending_tasks.clear();
+    threads.swap(executor->threads);
+  }
+  for (auto& cancelled_task : cancelled_tasks) {
+    if (cancelled_task.second) cancelled_task.second(cancelled_task.first);
+  }
+  bool destroyed_from_worker = false;
+  for (auto& thread : threads) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      thread.detach();
+      destroyed_from_worker = true;
+    } else {
+      thread.join();
+    }
+  }
+  if (destroyed_from_worker) {
+    executor->free_on_worker_exit = true;
+    return;
+  }
+
+  iree_allocator_t allocator = executor->allocator;
+  executor->~iree_vm_executor();
+  iree_allocator_free(allocator, executor);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_submit(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task) {
+  if (!executor || !task || !task->execute) {
+    return IREE_STATUS_INVALID_ARGUMENT;
+  }
+  absl::MutexLock lock(&executor->mutex);
+  if (executor->has_shutdown) return IREE_STATUS_FAILED_PRECONDITION;
+  task->executor = executor;
+  task->sequence = executor->next_sequence++;
+  task->state = IREE_VM_EXECUTOR_TASK_PENDING;
+  task->abort_requested = false;
+  task->status = IREE_STATUS_UNAVAILABLE;
+  task->resume_time = IREE_TIME_INFINITE_PAST;
+  executor->pending_tasks.insert(task);
+
+  // Spin up another worker if all existing ones are busy.
+  if (executor->idle_worker_count == 0 &&
+      static_cast<int32_t>(executor->threads.size()) <
+          executor->worker_count) {
+    executor->threads.emplace_back([executor]() { executor->ThreadMain(); });
+  }
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_query_status(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task) {
+  if (!executor || !task) return IREE_STATUS_INVALID_ARGUMENT;
+  absl::MutexLock lock(&executor->mutex);
+  return task->state == IREE_VM_EXECUTOR_TASK_COMPLETE
+             ? task->status
+             : IREE_STATUS_UNAVAILABLE;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_await(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task,
+    iree_time_t deadline) {
+  if (!executor || !task) return IREE_STATUS_INVALID_ARGUMENT;
+  IREE_TRACE_SCOPE0("iree_vm_executor_await");
+  absl::MutexLock lock(&executor->mutex);
+  auto is_complete = [task]() {
+    return task->state == IREE_VM_EXECUTOR_TASK_COMPLETE;
+  };
+  if (!executor->mutex.AwaitWithDeadline(absl::Condition(&is_complete),
+                                         iree::ToAbslTime(deadline))) {
+    return IREE_STATUS_DEADLINE_EXCEEDED;
+  }
+  return task->status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_abort(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task) {
+  if (!executor || !task) return IREE_STATUS_INVALID_ARGUMENT;
+  auto release = task->release;
+  {
+    absl::MutexLock lock(&executor->mutex);
+    switch (task->state) {
+      case IREE_VM_EXECUTOR_TASK_PENDING:
+        executor->pending_tasks.erase(task);
+        executor->CompleteTask(task, IREE_STATUS_ABORTED);
+        break;
+      case IREE_VM_EXECUTOR_TASK_RUNNING:
+        task->abort_requested = true;
+        return IREE_STATUS_OK;
+      case IREE_VM_EXECUTOR_TASK_COMPLETE:
+        return IREE_STATUS_OK;
+    }
+  }
+  // Only reached when the task was removed from the queue.
+  if (release) release(task);
+  return IREE_STATUS_OK;
+}
+
+}  // extern "C"
+
+namespace iree {
+namespace vm {
+
+StatusOr<WaitHandle> ExecutorTaskOnComplete(iree_vm_executor_task_t* task) {
+  if (!task || !task->executor) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Task has not been submitted to an executor";
+  }
+  iree_vm_executor_t* executor = task->executor;
+  absl::MutexLock lock(&executor->mutex);
+  if (task->state == IREE_VM_EXECUTOR_TASK_COMPLETE) {
+    auto event = make_ref<ManualResetEvent>();
+    RETURN_IF_ERROR(event->Set());
+    return event->OnSet();
+  }
+  // Share the event with any other waiters on the same task.
+  auto& event = executor->completion_events[task];
+  if (!event) event = make_ref<ManualResetEvent>("vm_executor_task");
+  return event->OnSet();
+}
+
+}  // namespace vm
+}  // namespace iree
@@ -0,0 +1,135 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Executor used to run asynchronous VM invocations.
+// This is an implementation detail of iree_vm_invocation_t and not intended to
+// be used directly by hosting applications.
+
+#ifndef IREE_VM_EXECUTOR_H_
+#define IREE_VM_EXECUTOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+#include "iree/base/status.h"
+#include "iree/base/wait_handle.h"
+
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_vm_executor iree_vm_executor_t;
+typedef struct iree_vm_executor_task iree_vm_executor_task_t;
+
+typedef enum {
+  // Task is waiting in the executor queue (possibly after suspending).
+  IREE_VM_EXECUTOR_TASK_PENDING = 0,
+  // Task is executing on a worker thread.
+  IREE_VM_EXECUTOR_TASK_RUNNING = 1,
+  // Task has completed (successfully or otherwise) and |status| is valid.
+  IREE_VM_EXECUTOR_TASK_COMPLETE = 2,
+} iree_vm_executor_task_state_t;
+
+// A unit of work scheduled on the executor. Tasks are embedded in the objects
+// they execute on behalf of and must remain valid until |release| is called.
+struct iree_vm_executor_task {
+  // Executes the task on a worker thread and returns the completion status.
+  // Tasks may suspend by setting |resume_time| and returning
+  // IREE_STATUS_UNAVAILABLE, in which case they are requeued and executed
+  // again once the resume time has elapsed.
+  iree_status_t(IREE_API_PTR* execute)(iree_vm_executor_task_t* task);
+  // Called once the executor no longer references the task. May be NULL.
+  void(IREE_API_PTR* release)(iree_vm_executor_task_t* task);
+
+  // Tasks with higher priority are executed before those with lower priority.
+  int32_t priority;
+  // Tasks with earlier deadlines are executed before those with later
+  // deadlines of the same priority. Tasks whose deadline has elapsed by the
+  // time they would be executed (or resumed) complete with
+  // IREE_STATUS_DEADLINE_EXCEEDED.
+  iree_time_t deadline;
+  // Earliest time at which the task may execute. Set by suspended tasks to
+  // delay their resumption; IREE_TIME_INFINITE_PAST executes immediately.
+  iree_time_t resume_time;
+  // Tasks sharing the same non-NULL key are never executed concurrently.
+  // Used to serialize invocations against the same context.
+  const void* exclusive_key;
+
+  // Fields below are owned by the executor and must not be modified.
+  iree_vm_executor_t* executor;
+  uint64_t sequence;
+  iree_vm_executor_task_state_t state;
+  bool abort_requested;
+  iree_status_t status;
+};
+
+#ifndef IREE_API_NO_PROTOTYPES
+
+// Creates an executor with up to |worker_count| worker threads. Threads are
+// created lazily when tasks are first submitted. A |worker_count| of 0 uses one
+// worker per hardware thread.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_create(
+    int32_t worker_count, iree_allocator_t allocator,
+    iree_vm_executor_t** out_executor);
+
+// Destroys the |executor|. Tasks still pending are completed with
+// IREE_STATUS_CANCELLED and in-flight tasks are joined before returning.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_executor_destroy(iree_vm_executor_t* executor);
+
+// Submits |task| for execution. The task fields owned by the executor will be
+// initialized.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_submit(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task);
+
+// Returns the completion status of |task| or IREE_STATUS_UNAVAILABLE if it has
+// not yet completed.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_query_status(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task);
+
+// Blocks the caller until |task| completes or |deadline| elapses.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the deadline elapses first and
+// otherwise the completion status of the task.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_await(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task,
+    iree_time_t deadline);
+
+// Aborts |task| if it has not yet completed. Pending (including suspended)
+// tasks are removed from the queue immediately. Running tasks are allowed to
+// finish or suspend but complete with IREE_STATUS_ABORTED.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_executor_abort(
+    iree_vm_executor_t* executor, iree_vm_executor_task_t* task);
+
+#endif  // IREE_API_NO_PROTOTYPES
+
+#ifdef __cplusplus
+}  // extern "C"
+
+namespace iree {
+namespace vm {
+
+// Returns a wait handle that is signaled once |task| completes (successfully or
+// otherwise). The handle may be waited on alongside other wait handles, such as
+// those of HAL fences, with WaitHandle::WaitAny. |task| must have been
+// submitted to an executor that has not yet been destroyed.
+StatusOr<WaitHandle> ExecutorTaskOnComplete(iree_vm_executor_task_t* task);
+
+}  // namespace vm
+}  // namespace iree
+
+#endif  // __cplusplus
+
+#endif  // IREE_VM_EXECUTOR_H_
@@ -0,0 +1,327 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/executor.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/base/api.h"
+#include "iree/base/status.h"
+#include "iree/base/status_matchers.h"
+#include "iree/base/wait_handle.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+// Task that records its execution order and optionally blocks until released.
+struct TestTask {
+  iree_vm_executor_task_t task;
+  int id = 0;
+  std::vector<int>* execution_order = nullptr;
+  absl::Notification* started = nullptr;
+  absl::Notification* unblock = nullptr;
+  iree_status_t result = IREE_STATUS_OK;
+  // Number of times the task suspends before completing with |result|.
+  int suspend_count = 0;
+  // Delay before a suspended task may resume.
+  absl::Duration resume_delay;
+  std::atomic<int> release_count{0};
+  absl::Notification released;
+
+  explicit TestTask(int id, std::vector<int>* execution_order = nullptr)
+      : id(id), execution_order(execution_order) {
+    memset(&task, 0, sizeof(task));
+    task.execute = Execute;
+    task.release = Release;
+    task.deadline = IREE_TIME_INFINITE_FUTURE;
+  }
+
+  // The executor may still reference the task until it has been released.
+  ~TestTask() { released.WaitForNotification(); }
+
+  static iree_status_t Execute(iree_vm_executor_task_t* task) {
+    auto* test_task = reinterpret_cast<TestTask*>(task);
+    if (test_task->started) test_task->started->Notify();
+    if (test_task->unblock) test_task->unblock->WaitForNotification();
+    if (test_task->execution_order) {
+      test_task->execution_order->push_back(test_task->id);
+    }
+    if (test_task->suspend_count > 0) {
+      --test_task->suspend_count;
+      task->resume_time =
+          absl::ToUnixNanos(absl::Now() + test_task->resume_delay);
+      return IREE_STATUS_UNAVAILABLE;
+    }
+    return test_task->result;
+  }
+
+  static void Release(iree_vm_executor_task_t* task) {
+    auto* test_task = reinterpret_cast<TestTask*>(task);
+    ++test_task->release_count;
+    test_task->released.Notify();
+  }
+};
+
+class VMExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_executor_create(/*worker_count=*/1,
+                                           IREE_ALLOCATOR_SYSTEM, &executor_));
+  }
+  void TearDown() override { iree_vm_executor_destroy(executor_); }
+
+  // Submits a task that blocks the single worker until |unblock| is notified.
+  void BlockWorker(TestTask* blocker, absl::Notification* unblock) {
+    absl::Notification started;
+    blocker->started = &started;
+    blocker->unblock = unblock;
+    IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &blocker->task));
+    started.WaitForNotification();
+  }
+
+  iree_vm_executor_t* executor_ = nullptr;
+};
+
+// Tests that a submitted task executes and reports its status.
+TEST_F(VMExecutorTest, SubmitAndAwait) {
+  TestTask task(0);
+  task.result = IREE_STATUS_DATA_LOSS;
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &task.task));
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_vm_executor_await(executor_, &task.task,
+                                   IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_vm_executor_query_status(executor_, &task.task));
+  task.released.WaitForNotification();
+  EXPECT_EQ(1, task.release_count.load());
+}
+
+// Tests that awaiting with an elapsed deadline does not block.
+TEST_F(VMExecutorTest, AwaitDeadline) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+  EXPECT_EQ(IREE_STATUS_UNAVAILABLE,
+            iree_vm_executor_query_status(executor_, &blocker.task));
+  EXPECT_EQ(IREE_STATUS_DEADLINE_EXCEEDED,
+            iree_vm_executor_await(executor_, &blocker.task,
+                                   IREE_TIME_INFINITE_PAST));
+  unblock.Notify();
+  IREE_EXPECT_OK(iree_vm_executor_await(executor_, &blocker.task,
+                                        IREE_TIME_INFINITE_FUTURE));
+}
+
+// Tests that queued tasks execute by priority and then deadline.
+TEST_F(VMExecutorTest, PolicyOrdering) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+
+  std::vector<int> execution_order;
+  iree_time_t now = absl::ToUnixNanos(absl::Now());
+  TestTask low(1, &execution_order);
+  low.task.priority = -1;
+  TestTask late(2, &execution_order);
+  late.task.deadline = now + absl::ToInt64Nanoseconds(absl::Hours(2));
+  TestTask early(3, &execution_order);
+  early.task.deadline = now + absl::ToInt64Nanoseconds(absl::Hours(1));
+  TestTask high(4, &execution_order);
+  high.task.priority = 1;
+  for (auto* task : {&low, &late, &early, &high}) {
+    IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &task->task));
+  }
+
+  unblock.Notify();
+  for (auto* task : {&low, &late, &early, &high}) {
+    IREE_EXPECT_OK(iree_vm_executor_await(executor_, &task->task,
+                                          IREE_TIME_INFINITE_FUTURE));
+  }
+  EXPECT_EQ((std::vector<int>{4, 3, 2, 1}), execution_order);
+}
+
+// Tests that tasks whose deadline elapses before they start are not executed.
+TEST_F(VMExecutorTest, ExpiredDeadline) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+
+  std::vector<int> execution_order;
+  TestTask expired(1, &execution_order);
+  expired.task.deadline = absl::ToUnixNanos(absl::Now());
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &expired.task));
+  unblock.Notify();
+  EXPECT_EQ(IREE_STATUS_DEADLINE_EXCEEDED,
+            iree_vm_executor_await(executor_, &expired.task,
+                                   IREE_TIME_INFINITE_FUTURE));
+  EXPECT_TRUE(execution_order.empty());
+}
+
+// Tests that pending tasks can be aborted.
+TEST_F(VMExecutorTest, AbortPending) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+
+  std::vector<int> execution_order;
+  TestTask task(1, &execution_order);
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &task.task));
+  IREE_ASSERT_OK(iree_vm_executor_abort(executor_, &task.task));
+  EXPECT_EQ(IREE_STATUS_ABORTED,
+            iree_vm_executor_query_status(executor_, &task.task));
+  EXPECT_EQ(1, task.release_count.load());
+
+  unblock.Notify();
+  IREE_EXPECT_OK(iree_vm_executor_await(executor_, &blocker.task,
+                                        IREE_TIME_INFINITE_FUTURE));
+  EXPECT_TRUE(execution_order.empty());
+}
+
+// Tests that suspended tasks are requeued behind other tasks of the same order.
+TEST_F(VMExecutorTest, SuspendAndResume) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+
+  std::vector<int> execution_order;
+  TestTask a(1, &execution_order);
+  a.suspend_count = 2;
+  TestTask b(2, &execution_order);
+  b.suspend_count = 2;
+  b.result = IREE_STATUS_DATA_LOSS;
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &a.task));
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &b.task));
+  unblock.Notify();
+
+  IREE_EXPECT_OK(
+      iree_vm_executor_await(executor_, &a.task, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(IREE_STATUS_DATA_LOSS,
+            iree_vm_executor_await(executor_, &b.task,
+                                   IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ((std::vector<int>{1, 2, 1, 2, 1, 2}), execution_order);
+  b.released.WaitForNotification();
+  EXPECT_EQ(1, a.release_count.load());
+  EXPECT_EQ(1, b.release_count.load());
+}
+
+// Tests that suspended tasks are not resumed before their resume time.
+TEST_F(VMExecutorTest, ResumeTime) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+
+  std::vector<int> execution_order;
+  TestTask waiting(1, &execution_order);
+  waiting.task.priority = 1;
+  waiting.suspend_count = 1;
+  waiting.resume_delay = absl::Milliseconds(50);
+  TestTask other(2, &execution_order);
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &waiting.task));
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &other.task));
+  unblock.Notify();
+
+  IREE_EXPECT_OK(iree_vm_executor_await(executor_, &waiting.task,
+                                        IREE_TIME_INFINITE_FUTURE));
+  IREE_EXPECT_OK(iree_vm_executor_await(executor_, &other.task,
+                                        IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ((std::vector<int>{1, 2, 1}), execution_order);
+}
+
+// Tests that suspended tasks can be aborted.
+TEST_F(VMExecutorTest, AbortSuspended) {
+  absl::Notification started;
+  TestTask task(0);
+  task.started = &started;
+  task.suspend_count = 1;
+  task.resume_delay = absl::Hours(1);
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &task.task));
+  started.WaitForNotification();
+  IREE_ASSERT_OK(iree_vm_executor_abort(executor_, &task.task));
+  EXPECT_EQ(IREE_STATUS_ABORTED,
+            iree_vm_executor_await(executor_, &task.task,
+                                   IREE_TIME_INFINITE_FUTURE));
+  task.released.WaitForNotification();
+  EXPECT_EQ(1, task.release_count.load());
+}
+
+// Tests that task completion can be waited on alongside other wait handles.
+TEST_F(VMExecutorTest, OnComplete) {
+  absl::Notification unblock;
+  TestTask blocker(0);
+  BlockWorker(&blocker, &unblock);
+  TestTask task(1);
+  IREE_ASSERT_OK(iree_vm_executor_submit(executor_, &task.task));
+
+  iree::ManualResetEvent other_event;
+  auto other_handle = other_event.OnSet();
+  ASSERT_OK_AND_ASSIGN(auto task_handle,
+                       iree::vm::ExecutorTaskOnComplete(&task.task));
+  ASSERT_OK_AND_ASSIGN(bool completed, task_handle.TryWait());
+  EXPECT_FALSE(completed);
+
+  unblock.Notify();
+  ASSERT_OK_AND_ASSIGN(
+      int signaled_index,
+      iree::WaitHandle::WaitAny({&other_handle, &task_handle}));
+  EXPECT_EQ(1, signaled_index);
+  IREE_EXPECT_OK(iree_vm_executor_query_status(executor_, &task.task));
+
+  // Tasks that have already completed return a signaled handle.
+  ASSERT_OK_AND_ASSIGN(auto completed_handle,
+                       iree::vm::ExecutorTaskOnComplete(&task.task));
+  ASSERT_OK_AND_ASSIGN(completed, completed_handle.TryWait());
+  EXPECT_TRUE(completed);
+}
+
+// Tests that tasks sharing an exclusive key never run concurrently even when
+// multiple workers are available.
+TEST(VMExecutorExclusiveTest, ExclusiveKeys) {
+  iree_vm_executor_t* executor = nullptr;
+  IREE_ASSERT_OK(iree_vm_executor_create(/*worker_count=*/4,
+                                         IREE_ALLOCATOR_SYSTEM, &executor));
+
+  static std::atomic<int> active_count{0};
+  static std::atomic<bool> overlapped{false};
+  struct ExclusiveTask {
+    iree_vm_executor_task_t task;
+    static iree_status_t Execute(iree_vm_executor_task_t* task) {
+      if (++active_count > 1) overlapped = true;
+      absl::SleepFor(absl::Milliseconds(1));
+      --active_count;
+      return IREE_STATUS_OK;
+    }
+  };
+  int key = 0;
+  std::vector<ExclusiveTask> tasks(16);
+  for (auto& task : tasks) {
+    memset(&task.task, 0, sizeof(task.task));
+    task.task.execute = ExclusiveTask::Execute;
+    task.task.deadline = IREE_TIME_INFINITE_FUTURE;
+    task.task.exclusive_key = &key;
+    IREE_ASSERT_OK(iree_vm_executor_submit(executor, &task.task));
+  }
+  for (auto& task : tasks) {
+    IREE_EXPECT_OK(iree_vm_executor_await(executor, &task.task,
+                                          IREE_TIME_INFINITE_FUTURE));
+  }
+  EXPECT_FALSE(overlapped);
+
+  iree_vm_executor_destroy(executor);
+}
+
+}  // namespace
@@ -20,6 +20,7 @@
 struct iree_vm_instance {
   iree_atomic_intptr_t ref_count;
   iree_allocator_t allocator;
+  iree_vm_executor_t* executor;
 };
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_instance_create(
@@ -37,11 +38,19 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_instance_create(
   instance->allocator = allocator;
   iree_atomic_store(&instance->ref_count, 1);
 
+  iree_status_t status = iree_vm_executor_create(
+      /*worker_count=*/0, allocator, &instance->executor);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator, instance);
+    return status;
+  }
+
   *out_instance = instance;
   return IREE_STATUS_OK;
 }
 
 static iree_status_t iree_vm_instance_destroy(iree_vm_instance_t* instance) {
+  iree_vm_executor_destroy(instance->executor);
   iree_allocator_free(instance->allocator, instance);
   return IREE_STATUS_OK;
 }
@@ -62,3 +71,8 @@ iree_vm_instance_release(iree_vm_instance_t* instance) {
   }
   return IREE_STATUS_OK;
 }
+
+IREE_API_EXPORT iree_vm_executor_t* IREE_API_CALL
+iree_vm_instance_executor(iree_vm_instance_t* instance) {
+  return instance ? instance->executor : NULL;
+}
@@ -16,6 +16,7 @@
 #define IREE_VM_INSTANCE_H_
 
 #include "iree/base/api.h"
+#include "iree/vm/executor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +52,12 @@ iree_vm_instance_retain(iree_vm_instance_t* instance);
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_instance_release(iree_vm_instance_t* instance);
 
+// Returns the executor used to schedule asynchronous invocations of contexts
+// created within the |instance|. Worker threads are only created once
+// invocations are submitted.
+IREE_API_EXPORT iree_vm_executor_t* IREE_API_CALL
+iree_vm_instance_executor(iree_vm_instance_t* instance);
+
 #endif  // IREE_API_NO_PROTOTYPES
 
 #ifdef __cplusplus
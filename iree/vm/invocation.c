@@ -14,6 +14,12 @@
 
 #include "iree/vm/invocation.h"
 
+#include <string.h>
+
+#include "iree/base/atomics.h"
+#include "iree/vm/executor.h"
+#include "iree/vm/instance.h"
+
 static iree_status_t iree_vm_validate_function_inputs(
     iree_vm_function_t function, iree_vm_variant_list_t* inputs) {
   // TODO(benvanik): validate inputs.
@@ -21,18 +27,40 @@ static iree_status_t iree_vm_validate_function_inputs(
 }
 
 static iree_status_t iree_vm_marshal_inputs(
-    iree_vm_variant_list_t* inputs, iree_vm_stack_frame_t* callee_frame) {
-  iree_vm_registers_t* registers = &callee_frame->registers;
+    iree_vm_stack_t* stack, iree_vm_variant_list_t* inputs,
+    iree_vm_stack_frame_t* callee_frame) {
   iree_host_size_t count = iree_vm_variant_list_size(inputs);
   int i32_reg = 0;
   int ref_reg = 0;
+  for (int i = 0; i < count; ++i) {
+    iree_vm_variant_t* variant = iree_vm_variant_list_get(inputs, i);
+    if (IREE_VM_VARIANT_IS_REF(variant)) {
+      ++ref_reg;
+    } else if (variant->value_type == IREE_VM_VALUE_TYPE_I64) {
+      i32_reg = ((i32_reg + 1) & ~1) + 2;
+    } else {
+      ++i32_reg;
+    }
+  }
+  IREE_RETURN_IF_ERROR(iree_vm_stack_frame_reserve_registers(
+      stack, callee_frame, i32_reg, ref_reg));
+
+  iree_vm_registers_t* registers = &callee_frame->registers;
+  i32_reg = 0;
+  ref_reg = 0;
   for (int i = 0; i < count; ++i) {
     iree_vm_variant_t* variant = iree_vm_variant_list_get(inputs, i);
     if (IREE_VM_VARIANT_IS_REF(variant)) {
       iree_vm_ref_t* reg_ref = &registers->ref[ref_reg++];
       memset(reg_ref, 0, sizeof(*reg_ref));
       iree_vm_ref_retain(&variant->ref, reg_ref);
+    } else if (variant->value_type == IREE_VM_VALUE_TYPE_I64) {
+      // i64 values occupy the next even-aligned register pair.
+      i32_reg = (i32_reg + 1) & ~1;
+      *(int64_t*)&registers->i32[i32_reg] = variant->i64;
+      i32_reg += 2;
     } else {
+      // f32 values are stored bitwise.
       registers->i32[i32_reg++] = variant->i32;
     }
   }
@@ -55,7 +83,13 @@ static iree_status_t iree_vm_marshal_outputs(
         IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_ref_retain(
             outputs, &registers->ref[reg & IREE_REF_REGISTER_MASK]));
       }
+    } else if (reg & IREE_I64_REGISTER_BIT) {
+      iree_vm_value_t value = iree_vm_value_make_i64(
+          *(int64_t*)&registers->i32[reg & IREE_I64_REGISTER_MASK]);
+      IREE_RETURN_IF_ERROR(iree_vm_variant_list_append_value(outputs, value));
     } else {
+      // NOTE: registers do not track whether they hold i32 or f32 values so
+      // f32 results are bitcast to i32 (see iree_vm_invoke).
       iree_vm_value_t value;
       value.type = IREE_VM_VALUE_TYPE_I32;
       value.i32 = registers->i32[reg & IREE_I32_REGISTER_MASK];
@@ -65,7 +99,89 @@ static iree_status_t iree_vm_marshal_outputs(
   return IREE_STATUS_OK;
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_begin(
+    iree_vm_stack_t* stack, iree_vm_function_t function,
+    iree_vm_variant_list_t* inputs, iree_vm_execution_result_t* out_result) {
+  if (!out_result) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_result, 0, sizeof(*out_result));
+  if (!stack || !function.module) return IREE_STATUS_INVALID_ARGUMENT;
+  if (stack->depth != 0) return IREE_STATUS_FAILED_PRECONDITION;
+
+  // NOTE: it is ok to have no inputs. If we do have them, though, they must be
+  // valid.
+  IREE_RETURN_IF_ERROR(iree_vm_validate_function_inputs(function, inputs));
+
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  iree_status_t status =
+      iree_vm_stack_function_enter(stack, function, &callee_frame);
+
+  // Marshal inputs.
+  if (iree_status_is_ok(status) && inputs) {
+    status = iree_vm_marshal_inputs(stack, inputs, callee_frame);
+  }
+
+  // Perform execution until the function returns or suspends.
+  if (iree_status_is_ok(status)) {
+    status = function.module->execute(function.module->self, stack,
+                                      callee_frame, out_result);
+  }
+
+  // Failed invocations cannot be resumed so unwind everything they entered.
+  if (!iree_status_is_ok(status)) iree_vm_stack_deinit(stack);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_resume(
+    iree_vm_stack_t* stack, iree_vm_execution_result_t* out_result) {
+  if (!out_result) return IREE_STATUS_INVALID_ARGUMENT;
+  memset(out_result, 0, sizeof(*out_result));
+  if (!stack) return IREE_STATUS_INVALID_ARGUMENT;
+  if (stack->depth == 0) return IREE_STATUS_FAILED_PRECONDITION;
+
+  // The module owning the entry frame resumes any frames it entered.
+  iree_vm_stack_frame_t* entry_frame = iree_vm_stack_entry_frame(stack);
+  iree_vm_module_t* module = entry_frame->function.module;
+  iree_status_t status =
+      module->execute(module->self, stack, entry_frame, out_result);
+  if (!iree_status_is_ok(status)) iree_vm_stack_deinit(stack);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_end(
+    iree_vm_stack_t* stack, iree_vm_variant_list_t* outputs) {
+  if (!stack) return IREE_STATUS_INVALID_ARGUMENT;
+  if (stack->depth != 1) return IREE_STATUS_FAILED_PRECONDITION;
+
+  // Marshal outputs.
+  iree_status_t status = IREE_STATUS_OK;
+  if (outputs) {
+    status = iree_vm_marshal_outputs(iree_vm_stack_current_frame(stack),
+                                     outputs);
+  }
+
+  iree_vm_stack_function_leave(stack);
+  return status;
+}
+
+// Completes the returned invocation on |stack|.
+// Results are marshaled into |outputs|, if provided, or into a newly allocated
+// list returned in |out_outputs|, if provided.
+static iree_status_t iree_vm_invoke_finish(iree_vm_stack_t* stack,
+                                           iree_vm_variant_list_t* outputs,
+                                           iree_vm_variant_list_t** out_outputs,
+                                           iree_allocator_t allocator) {
+  if (!outputs && out_outputs) {
+    iree_vm_stack_frame_t* entry_frame = iree_vm_stack_current_frame(stack);
+    iree_host_size_t output_count = entry_frame->return_registers
+                                        ? entry_frame->return_registers->size
+                                        : 0;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_variant_list_alloc(output_count, allocator, out_outputs));
+    outputs = *out_outputs;
+  }
+  return iree_vm_invoke_end(stack, outputs);
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, iree_vm_variant_list_t* inputs,
@@ -73,44 +189,225 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   // NOTE: it is ok to have no inputs or outputs. If we do have them, though,
   // they must be valid.
   // TODO(benvanik): validate outputs capacity.
-  IREE_RETURN_IF_ERROR(iree_vm_validate_function_inputs(function, inputs));
-
-  // Allocate a stack on the heap and initialize it.
-  // If we shrunk the stack (or made it so that it could dynamically grow)
-  // then we could stack-allocate it here and not need the allocator at all.
   iree_vm_stack_t* stack = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, sizeof(iree_vm_stack_t),
-                                             (void**)&stack));
-  iree_status_t status =
-      iree_vm_stack_init(iree_vm_context_state_resolver(context), stack);
+  IREE_RETURN_IF_ERROR(iree_vm_context_acquire_stack(context, &stack));
+
+  // Synchronous invocations run on the calling thread and ignore |policy|.
+  // Suspensions are resumed immediately regardless of their wait condition.
+  iree_vm_execution_result_t result;
+  iree_status_t status = iree_vm_invoke_begin(stack, function, inputs, &result);
+  while (iree_status_is_ok(status) && result.wait_type != IREE_VM_WAIT_NONE) {
+    status = iree_vm_invoke_resume(stack, &result);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_end(stack, outputs);
+  }
+
+  iree_vm_context_release_stack(context, stack);
+  return status;
+}
+
+struct iree_vm_invocation {
+  // Must be first so that the executor task can be cast to the invocation.
+  iree_vm_executor_task_t task;
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_executor_t* executor;
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  // Retained copy of the caller inputs.
+  iree_vm_variant_list_t* inputs;
+  // Outputs populated by the task on successful completion.
+  iree_vm_variant_list_t* outputs;
+  // Stack of the in-flight invocation, if it has begun and not yet completed.
+  iree_vm_stack_t* stack;
+};
+
+static iree_status_t iree_vm_invocation_execute(iree_vm_executor_task_t* task) {
+  iree_vm_invocation_t* invocation = (iree_vm_invocation_t*)task;
+  iree_vm_execution_result_t result;
+  iree_status_t status = IREE_STATUS_OK;
+  if (!invocation->stack) {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_acquire_stack(invocation->context, &invocation->stack));
+    status = iree_vm_invoke_begin(invocation->stack, invocation->function,
+                                  invocation->inputs, &result);
+  } else {
+    status = iree_vm_invoke_resume(invocation->stack, &result);
+  }
+
+  if (iree_status_is_ok(status) && result.wait_type != IREE_VM_WAIT_NONE) {
+    // Hand the worker back to the executor until we are ready to resume.
+    invocation->task.resume_time = result.wait_type == IREE_VM_WAIT_UNTIL
+                                       ? result.resume_time
+                                       : IREE_TIME_INFINITE_PAST;
+    return IREE_STATUS_UNAVAILABLE;
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_finish(invocation->stack, /*outputs=*/NULL,
+                                   &invocation->outputs,
+                                   invocation->allocator);
+  }
+  iree_vm_context_release_stack(invocation->context, invocation->stack);
+  invocation->stack = NULL;
+  return status;
+}
+
+static void iree_vm_invocation_task_release(iree_vm_executor_task_t* task) {
+  iree_vm_invocation_release((iree_vm_invocation_t*)task);
+}
+
+static iree_status_t iree_vm_invocation_clone_inputs(
+    const iree_vm_variant_list_t* source, iree_allocator_t allocator,
+    iree_vm_variant_list_t** out_list) {
+  // NOTE: variant lists have no const accessors; we don't modify |source|.
+  iree_vm_variant_list_t* source_list = (iree_vm_variant_list_t*)source;
+  iree_host_size_t count = iree_vm_variant_list_size(source_list);
+  IREE_RETURN_IF_ERROR(iree_vm_variant_list_alloc(count, allocator, out_list));
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_vm_variant_t* variant = iree_vm_variant_list_get(source_list, i);
+    iree_status_t status;
+    if (IREE_VM_VARIANT_IS_REF(variant)) {
+      status = iree_vm_variant_list_append_ref_retain(*out_list, &variant->ref);
+    } else {
+      iree_vm_value_t value;
+      value.type = variant->value_type;
+      switch (variant->value_type) {
+        case IREE_VM_VALUE_TYPE_I64:
+          value.i64 = variant->i64;
+          break;
+        case IREE_VM_VALUE_TYPE_F32:
+          value.f32 = variant->f32;
+          break;
+        default:
+          value.i32 = variant->i32;
+          break;
+      }
+      status = iree_vm_variant_list_append_value(*out_list, value);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_vm_variant_list_free(*out_list);
+      *out_list = NULL;
+      return status;
+    }
+  }
+  return IREE_STATUS_OK;
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  // Invocations aborted while suspended still hold their stack.
+  if (invocation->stack) {
+    iree_vm_context_release_stack(invocation->context, invocation->stack);
+  }
+  if (invocation->outputs) iree_vm_variant_list_free(invocation->outputs);
+  if (invocation->inputs) iree_vm_variant_list_free(invocation->inputs);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(invocation->allocator, invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy,
+    const iree_vm_variant_list_t* inputs, iree_allocator_t allocator,
+    iree_vm_invocation_t** out_invocation) {
+  if (!out_invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  *out_invocation = NULL;
+  if (!context || !function.module) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_vm_executor_t* executor =
+      iree_vm_instance_executor(iree_vm_context_instance(context));
+  if (!executor) return IREE_STATUS_FAILED_PRECONDITION;
+
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, sizeof(iree_vm_invocation_t), (void**)&invocation));
+  memset(invocation, 0, sizeof(*invocation));
+  iree_atomic_store(&invocation->ref_count, 1);
+  invocation->allocator = allocator;
+  invocation->executor = executor;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->function = function;
+
+  iree_status_t status = IREE_STATUS_OK;
+  if (inputs) {
+    status = iree_vm_invocation_clone_inputs(inputs, allocator,
+                                             &invocation->inputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_validate_function_inputs(function, invocation->inputs);
+  }
   if (!iree_status_is_ok(status)) {
-    iree_allocator_free(allocator, stack);
+    iree_vm_invocation_destroy(invocation);
     return status;
   }
 
-  iree_vm_stack_frame_t* callee_frame = NULL;
-  status = iree_vm_stack_function_enter(stack, function, &callee_frame);
+  invocation->task.execute = iree_vm_invocation_execute;
+  invocation->task.release = iree_vm_invocation_task_release;
+  invocation->task.priority =
+      policy ? policy->priority : IREE_VM_INVOCATION_PRIORITY_DEFAULT;
+  invocation->task.deadline =
+      policy ? policy->deadline : IREE_TIME_INFINITE_FUTURE;
+  // The VM module state of a context is not thread-safe.
+  invocation->task.exclusive_key = context;
 
-  // Marshal inputs.
-  if (iree_status_is_ok(status) && inputs) {
-    status = iree_vm_marshal_inputs(inputs, callee_frame);
+  // The executor holds a reference until the task completes.
+  iree_vm_invocation_retain(invocation);
+  status = iree_vm_executor_submit(executor, &invocation->task);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invocation_release(invocation);
+    iree_vm_invocation_release(invocation);
+    return status;
   }
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
-  if (iree_status_is_ok(status)) {
-    iree_vm_execution_result_t result;
-    status = function.module->execute(function.module->self, stack,
-                                      callee_frame, &result);
+  *out_invocation = invocation;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  iree_atomic_fetch_add(&invocation->ref_count, 1);
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_fetch_sub(&invocation->ref_count, 1) == 1) {
+    iree_vm_invocation_destroy(invocation);
   }
+  return IREE_STATUS_OK;
+}
 
-  // Marshal outputs.
-  if (iree_status_is_ok(status) && outputs) {
-    status = iree_vm_marshal_outputs(callee_frame, outputs);
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  return iree_vm_executor_query_status(invocation->executor, &invocation->task);
+}
+
+IREE_API_EXPORT const iree_vm_variant_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  if (!invocation ||
+      !iree_status_is_ok(iree_vm_invocation_query_status(invocation))) {
+    return NULL;
   }
+  return invocation->outputs;
+}
 
-  iree_vm_stack_function_leave(stack);
-  iree_vm_stack_deinit(stack);
-  iree_allocator_free(allocator, stack);
-  return status;
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  return iree_vm_executor_await(invocation->executor, &invocation->task,
+                                deadline);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  if (!invocation) return IREE_STATUS_INVALID_ARGUMENT;
+  return iree_vm_executor_abort(invocation->executor, &invocation->task);
+}
+
+IREE_API_EXPORT iree_vm_executor_task_t* IREE_API_CALL
+iree_vm_invocation_task(iree_vm_invocation_t* invocation) {
+  return invocation ? &invocation->task : NULL;
 }
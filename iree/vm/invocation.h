@@ -19,7 +19,9 @@
 
 #include "iree/base/api.h"
 #include "iree/vm/context.h"
+#include "iree/vm/executor.h"
 #include "iree/vm/module.h"
+#include "iree/vm/stack.h"
 #include "iree/vm/variant_list.h"
 
 #ifdef __cplusplus
@@ -27,7 +29,24 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_vm_invocation iree_vm_invocation_t;
-typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
+
+// Default priority of invocations that do not specify a policy.
+#define IREE_VM_INVOCATION_PRIORITY_DEFAULT 0
+
+// Controls how an invocation is scheduled relative to other pending or
+// in-flight invocations.
+typedef struct iree_vm_invocation_policy {
+  // Invocations with higher priority are executed before those with lower
+  // priority.
+  int32_t priority;
+  // Absolute time by which the invocation is expected to complete. Among
+  // invocations of the same priority those with the earliest deadline are
+  // executed first. Invocations that have not started (or are suspended) when
+  // their deadline elapses complete with IREE_STATUS_DEADLINE_EXCEEDED without
+  // executing further.
+  // IREE_TIME_INFINITE_FUTURE indicates no deadline.
+  iree_time_t deadline;
+} iree_vm_invocation_policy_t;
 
 #ifndef IREE_API_NO_PROTOTYPES
 
@@ -43,13 +62,67 @@ typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
 //
 // |outputs| is populated after the function completes execution with the
 // output values and objects of the function. List ownership remains with the
-// caller.
+// caller. 32-bit primitive registers are untyped and f32 results are returned
+// as IREE_VM_VALUE_TYPE_I32 values holding the bits of the float; read them
+// through the f32 member of the variant.
+//
+// If the function suspends it is resumed immediately on the calling thread.
+// The invocation executes on a stack pooled by |context| (see
+// iree_vm_context_acquire_stack).
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, iree_vm_variant_list_t* inputs,
     iree_vm_variant_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Begins a resumable invocation of |function| on |stack|.
+// |stack| must be empty and either acquired from the context that the function
+// is to be invoked within (see iree_vm_context_acquire_stack) or initialized
+// with its state resolver (see iree_vm_context_state_resolver).
+//
+// |inputs| is used to pass values and objects into the target function and must
+// match the signature defined by the compiled function. List ownership remains
+// with the caller.
+//
+// If the function suspends (such as by executing vm.yield) |out_result|
+// describes the condition that must be satisfied before calling
+// iree_vm_invoke_resume to continue execution. Once |out_result| reports
+// IREE_VM_WAIT_NONE the function has returned and iree_vm_invoke_end must be
+// called to retrieve the results.
+//
+// Suspended stacks hold no host thread state and any number of them may be
+// resumed from a single thread in any order.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_begin(
+    iree_vm_stack_t* stack, iree_vm_function_t function,
+    iree_vm_variant_list_t* inputs, iree_vm_execution_result_t* out_result);
+
+// Resumes a suspended invocation on |stack| from the point at which it last
+// suspended. |out_result| is populated as with iree_vm_invoke_begin.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_resume(
+    iree_vm_stack_t* stack, iree_vm_execution_result_t* out_result);
+
+// Completes an invocation on |stack| that has returned.
+// |outputs|, if provided, is populated with the output values and objects of
+// the function as with iree_vm_invoke. List ownership remains with the caller.
+// The stack is left empty and may be reused for another invocation.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke_end(
+    iree_vm_stack_t* stack, iree_vm_variant_list_t* outputs);
+
+// Asynchronously invokes a function in the VM.
+//
+// The invocation is queued on the executor owned by the instance of |context|
+// and scheduled based on |policy|, if provided. Invocations against the same
+// context are executed one at a time while those against different contexts
+// may execute concurrently. Invocations that suspend release their worker so
+// that other invocations (including those against the same context) may run
+// until they are ready to resume.
+//
+// |inputs| is retained by the invocation and the caller may free the list after
+// this call returns.
+//
+// Use iree_vm_invocation_await (or iree::vm::InvocationOnComplete to wait
+// alongside other wait handles) to wait for completion and
+// iree_vm_invocation_output to access the results.
+// |out_invocation| must be released by the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy,
@@ -95,10 +168,33 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_invocation_abort(iree_vm_invocation_t* invocation);
 
+// Returns the executor task that schedules the invocation.
+// The task is owned by the invocation and must not be modified. Hosting
+// applications should prefer iree::vm::InvocationOnComplete.
+IREE_API_EXPORT iree_vm_executor_task_t* IREE_API_CALL
+iree_vm_invocation_task(iree_vm_invocation_t* invocation);
+
 #endif  // IREE_API_NO_PROTOTYPES
 
 #ifdef __cplusplus
 }  // extern "C"
+
+namespace iree {
+namespace vm {
+
+// Returns a wait handle that is signaled once |invocation| completes
+// (successfully or otherwise). Unlike iree_vm_invocation_await this allows
+// waiting on invocations alongside other wait handles, such as those of HAL
+// fences, with WaitHandle::WaitAny. Use iree_vm_invocation_query_status to
+// retrieve the completion status once signaled.
+inline StatusOr<WaitHandle> InvocationOnComplete(
+    iree_vm_invocation_t* invocation) {
+  return ExecutorTaskOnComplete(iree_vm_invocation_task(invocation));
+}
+
+}  // namespace vm
+}  // namespace iree
+
 #endif  // __cplusplus
 
 #endif  // IREE_VM_INVOCATION_H_
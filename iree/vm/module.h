@@ -27,6 +27,7 @@ extern "C" {
 typedef struct iree_vm_module iree_vm_module_t;
 typedef struct iree_vm_stack iree_vm_stack_t;
 typedef struct iree_vm_stack_frame iree_vm_stack_frame_t;
+typedef struct iree_vm_direct_call iree_vm_direct_call_t;
 
 // Describes the type of a function reference.
 typedef enum {
@@ -76,14 +77,25 @@ typedef struct {
 // VM functions and accessing this state.
 typedef struct iree_vm_module_state iree_vm_module_state_t;
 
+// Describes why execution suspended before the entry frame returned.
+typedef enum {
+  // Execution did not suspend and the entry frame has returned.
+  IREE_VM_WAIT_NONE = 0,
+  // Execution yielded (such as via vm.yield) and may be resumed at any time.
+  IREE_VM_WAIT_YIELD = 1,
+  // Execution is waiting and should not be resumed before the resume time.
+  IREE_VM_WAIT_UNTIL = 2,
+} iree_vm_wait_type_t;
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Set when execution suspended before the entry frame returned. All frames
+  // remain on the stack and executing the entry frame again continues from the
+  // point at which execution suspended.
+  iree_vm_wait_type_t wait_type;
+  // Earliest time at which execution should be resumed when |wait_type| is
+  // IREE_VM_WAIT_UNTIL.
+  iree_time_t resume_time;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -139,6 +151,8 @@ typedef struct iree_vm_module {
   // Asynchronously executes the function specified in the |frame|.
   // This may be called repeatedly for the same frame if the execution
   // previously yielded. The offset within the frame is preserved across calls.
+  // If execution suspends |out_result| describes the wait condition and any
+  // frames entered since |frame| are left on the stack to be resumed.
   iree_status_t(IREE_API_PTR* execute)(void* self, iree_vm_stack_t* stack,
                                        iree_vm_stack_frame_t* frame,
                                        iree_vm_execution_result_t* out_result);
@@ -153,6 +167,15 @@ typedef struct iree_vm_module {
   iree_status_t(IREE_API_PTR* get_function_reflection_attr)(
       void* self, iree_vm_function_linkage_t linkage, int32_t ordinal,
       int32_t index, iree_string_view_t* key, iree_string_view_t* value);
+
+  // Optional. Synchronously executes the function specified in |call| without
+  // entering a stack frame by reading arguments from and writing results to
+  // the registers of the caller. Functions that may suspend cannot be called
+  // this way and return IREE_STATUS_UNAVAILABLE without touching any registers.
+  // Callers use execute instead when this is NULL or the function is
+  // unavailable.
+  iree_status_t(IREE_API_PTR* call_direct)(void* self, iree_vm_stack_t* stack,
+                                           const iree_vm_direct_call_t* call);
 } iree_vm_module_t;
 
 #ifndef IREE_API_NO_PROTOTYPES
@@ -18,7 +18,10 @@
 #include <cstring>
 #include <memory>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/types/span.h"
 #include "iree/base/api.h"
 #include "iree/base/api_util.h"
@@ -45,6 +48,8 @@ namespace vm {
 // std::tuple, and absl::Span to match fixed-length arrays of the same type,
 // tuples of mixed types, or dynamic arrays (variadic arguments). Results may be
 // returned as either their type or an std::tuple/std::array of types.
+// Functions that complete asynchronously may instead return StatusOr<Wait> to
+// suspend the calling invocation until the wait is satisfied.
 //
 // Usage:
 //   // Per-context module state that must only be thread-compatible.
@@ -89,6 +94,7 @@ class NativeModule {
     interface_.free_state = NativeModule::ModuleFreeState;
     interface_.resolve_import = NativeModule::ModuleResolveImport;
     interface_.execute = NativeModule::ModuleExecute;
+    interface_.call_direct = NativeModule::ModuleCallDirect;
   }
 
   virtual ~NativeModule() = default;
@@ -226,7 +232,46 @@ class NativeModule {
     }
     const auto& info = module->dispatch_table_[ordinal];
     auto* state = FromStatePointer(frame->module_state);
-    auto status = info.call(info.ptr, state, stack, frame, out_result);
+    Status status;
+    if (frame->pc != 0) {
+      // Resuming a call that previously suspended on a wait.
+      status = module->ResumeWait(frame, out_result);
+    } else {
+      Wait wait;
+      status = info.call(info.ptr, state, stack, frame, &wait);
+      if (status.ok() && wait.poll) {
+        status = module->PollWait(frame, std::move(wait), out_result);
+      }
+    }
+    if (!status.ok()) {
+      status = iree::Annotate(
+          status,
+          absl::StrCat("while executing ", module->name_, ".", info.name));
+      return ToApiStatus(status);
+    }
+    return IREE_STATUS_OK;
+  }
+
+  // Calls are made directly with the caller registers to avoid entering a
+  // frame and copying the arguments and results.
+  static iree_status_t ModuleCallDirect(void* self, iree_vm_stack_t* stack,
+                                        const iree_vm_direct_call_t* call) {
+    if (!stack || !call) return IREE_STATUS_INVALID_ARGUMENT;
+    int32_t ordinal = call->function.ordinal;
+    auto* module = FromModulePointer(self);
+    if (ordinal < 0 || ordinal >= module->dispatch_table_.size()) {
+      return IREE_STATUS_INVALID_ARGUMENT;
+    }
+    const auto& info = module->dispatch_table_[ordinal];
+    if (!info.call_direct) {
+      // Functions that may wait are executed in a frame so they can suspend.
+      return IREE_STATUS_UNAVAILABLE;
+    }
+    iree_vm_module_state_t* module_state = nullptr;
+    IREE_RETURN_IF_ERROR(stack->state_resolver.query_module_state(
+        stack->state_resolver.self, module->interface(), &module_state));
+    auto* state = FromStatePointer(module_state);
+    auto status = info.call_direct(info.ptr, state, stack, call);
     if (!status.ok()) {
       status = iree::Annotate(
           status,
@@ -236,11 +281,51 @@ class NativeModule {
     return IREE_STATUS_OK;
   }
 
+  // Polls |wait| and, if it has not yet completed, suspends |frame| until the
+  // next poll. The pending wait is held by the module as the frame (and its
+  // stack) must remain untouched until it is resumed.
+  Status PollWait(iree_vm_stack_frame_t* frame, Wait wait,
+                  iree_vm_execution_result_t* out_result) {
+    ASSIGN_OR_RETURN(bool completed, wait.poll());
+    if (completed) {
+      frame->pc = 0;
+      return OkStatus();
+    }
+    out_result->wait_type = IREE_VM_WAIT_UNTIL;
+    out_result->resume_time =
+        absl::ToUnixNanos(absl::Now() + wait.poll_interval);
+    frame->pc = 1;
+    absl::MutexLock lock(&pending_waits_mutex_);
+    pending_waits_[frame] = std::move(wait);
+    return OkStatus();
+  }
+
+  Status ResumeWait(iree_vm_stack_frame_t* frame,
+                    iree_vm_execution_result_t* out_result) {
+    Wait wait;
+    {
+      absl::MutexLock lock(&pending_waits_mutex_);
+      auto it = pending_waits_.find(frame);
+      if (it == pending_waits_.end()) {
+        return FailedPreconditionErrorBuilder(IREE_LOC)
+               << "Frame is not suspended on a wait";
+      }
+      wait = std::move(it->second);
+      pending_waits_.erase(it);
+    }
+    return PollWait(frame, std::move(wait), out_result);
+  }
+
   const char* name_;
   const iree_allocator_t allocator_;
   iree_vm_module_t interface_;
 
   const absl::Span<const NativeFunction<State>> dispatch_table_;
+
+  // Waits of suspended calls keyed by the frame they were made in.
+  absl::Mutex pending_waits_mutex_;
+  absl::flat_hash_map<iree_vm_stack_frame_t*, Wait> pending_waits_
+      ABSL_GUARDED_BY(pending_waits_mutex_);
 };
 
 }  // namespace vm
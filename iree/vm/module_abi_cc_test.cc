@@ -0,0 +1,140 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/module_abi_cc.h"
+
+#include <memory>
+
+#include "iree/base/api.h"
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/vm/module.h"
+#include "iree/vm/stack.h"
+
+namespace iree {
+namespace vm {
+namespace {
+
+class WaitModuleState final {
+ public:
+  // Completes after |remaining_polls_| polls report the wait as pending.
+  StatusOr<Wait> WaitForPolls() {
+    Wait wait;
+    wait.poll = [this]() -> StatusOr<bool> {
+      ++poll_count_;
+      return remaining_polls_-- <= 0;
+    };
+    wait.poll_interval = absl::Milliseconds(10);
+    return wait;
+  }
+
+  int remaining_polls_ = 2;
+  int poll_count_ = 0;
+};
+
+static const NativeFunction<WaitModuleState> kWaitModuleFunctions[] = {
+    MakeNativeFunction("wait_for_polls", &WaitModuleState::WaitForPolls),
+};
+
+class WaitModule final : public NativeModule<WaitModuleState> {
+ public:
+  using NativeModule::NativeModule;
+  StatusOr<std::unique_ptr<WaitModuleState>> CreateState(
+      iree_allocator_t allocator) override {
+    return std::make_unique<WaitModuleState>();
+  }
+};
+
+class VMModuleAbiCcTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    module_ = (new WaitModule("wait", IREE_ALLOCATOR_SYSTEM,
+                              absl::MakeConstSpan(kWaitModuleFunctions)))
+                  ->interface();
+    IREE_ASSERT_OK(module_->alloc_state(module_->self, IREE_ALLOCATOR_SYSTEM,
+                                        &module_state_));
+    iree_vm_state_resolver_t state_resolver = {
+        module_state_,
+        +[](void* state_resolver, iree_vm_module_t* module,
+            iree_vm_module_state_t** out_module_state) -> iree_status_t {
+          *out_module_state = (iree_vm_module_state_t*)state_resolver;
+          return IREE_STATUS_OK;
+        }};
+    stack_ = std::make_unique<iree_vm_stack_t>();
+    IREE_ASSERT_OK(iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM,
+                                      stack_.get()));
+  }
+
+  void TearDown() override {
+    IREE_EXPECT_OK(iree_vm_stack_deinit(stack_.get()));
+    IREE_EXPECT_OK(module_->free_state(module_->self, module_state_));
+    IREE_EXPECT_OK(module_->destroy(module_->self));
+  }
+
+  WaitModuleState* state() {
+    return reinterpret_cast<WaitModuleState*>(module_state_);
+  }
+
+  iree_vm_function_t LookupFunction(const char* name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(module_->lookup_function(module_->self,
+                                           IREE_VM_FUNCTION_LINKAGE_EXPORT,
+                                           iree_make_cstring_view(name),
+                                           &function));
+    return function;
+  }
+
+  iree_vm_module_t* module_ = nullptr;
+  iree_vm_module_state_t* module_state_ = nullptr;
+  std::unique_ptr<iree_vm_stack_t> stack_;
+};
+
+// Functions that may wait must be executed in a frame so they can suspend.
+TEST_F(VMModuleAbiCcTest, WaitIsUnavailableForDirectCalls) {
+  iree_vm_direct_call_t call = {};
+  call.function = LookupFunction("wait_for_polls");
+  EXPECT_EQ(IREE_STATUS_UNAVAILABLE,
+            module_->call_direct(module_->self, stack_.get(), &call));
+  EXPECT_EQ(0, state()->poll_count_);
+}
+
+// Pending waits suspend the frame until the resume time and are polled again
+// each time the frame is executed until they complete.
+TEST_F(VMModuleAbiCcTest, WaitSuspendsAndResumes) {
+  iree_vm_stack_frame_t* frame = nullptr;
+  IREE_ASSERT_OK(iree_vm_stack_function_enter(
+      stack_.get(), LookupFunction("wait_for_polls"), &frame));
+
+  iree_time_t start_time = absl::ToUnixNanos(absl::Now());
+  iree_vm_execution_result_t result;
+  IREE_ASSERT_OK(module_->execute(module_->self, stack_.get(), frame, &result));
+  EXPECT_EQ(IREE_VM_WAIT_UNTIL, result.wait_type);
+  EXPECT_GE(result.resume_time,
+            start_time + absl::ToInt64Nanoseconds(absl::Milliseconds(10)));
+  EXPECT_EQ(1, state()->poll_count_);
+
+  IREE_ASSERT_OK(module_->execute(module_->self, stack_.get(), frame, &result));
+  EXPECT_EQ(IREE_VM_WAIT_UNTIL, result.wait_type);
+  EXPECT_EQ(2, state()->poll_count_);
+
+  IREE_ASSERT_OK(module_->execute(module_->self, stack_.get(), frame, &result));
+  EXPECT_EQ(IREE_VM_WAIT_NONE, result.wait_type);
+  EXPECT_EQ(3, state()->poll_count_);
+
+  IREE_EXPECT_OK(iree_vm_stack_function_leave(stack_.get()));
+}
+
+}  // namespace
+}  // namespace vm
+}  // namespace iree
@@ -15,10 +15,12 @@
 #ifndef IREE_VM_MODULE_ABI_PACKING_H_
 #define IREE_VM_MODULE_ABI_PACKING_H_
 
+#include <functional>
 #include <memory>
 #include <tuple>
 #include <utility>
 
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "iree/base/api.h"
 #include "iree/base/api_util.h"
@@ -31,6 +33,19 @@
 
 namespace iree {
 namespace vm {
+
+// Returned by native functions that complete asynchronously.
+// Instead of blocking the host thread the calling invocation suspends with
+// IREE_VM_WAIT_UNTIL and |poll| is called each time the invocation is resumed
+// until it returns true. Functions returning a Wait have no results and are
+// never called directly with the caller registers.
+struct Wait {
+  // Returns true once the operation being waited on has completed.
+  std::function<StatusOr<bool>()> poll;
+  // Minimum duration the invocation is suspended between polls.
+  absl::Duration poll_interval = absl::Microseconds(50);
+};
+
 namespace packing {
 
 namespace impl {
@@ -92,22 +107,57 @@ struct LeafCount<std::tuple<Ts...>> {
 template <typename T>
 struct ParamUnpack;
 
+// Arguments are unpacked either from the ABI registers of a callee |frame| or,
+// for direct calls, straight from the caller registers described by |call|.
 struct ParamUnpackState {
   iree_vm_stack_frame_t* frame;
+  const iree_vm_direct_call_t* call = nullptr;
   int i32_ordinal = 0;
   int ref_ordinal = 0;
   int varargs_ordinal = 0;
   Status status;
 
+  // Returns the next primitive argument.
+  int32_t NextI32() {
+    int ordinal = i32_ordinal++;
+    if (!call) return frame->registers.i32[ordinal];
+    if (ordinal >= call->i32_argument_registers->size) {
+      status = InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Missing primitive argument " << ordinal;
+      return 0;
+    }
+    uint16_t reg = call->i32_argument_registers->pairs[ordinal].src_reg;
+    return call->registers->i32[reg & IREE_I32_REGISTER_MASK];
+  }
+
+  // Returns the register holding the next ref argument or nullptr if missing.
+  // |out_is_move| is set if ownership of the ref may be taken by the callee.
+  iree_vm_ref_t* NextRef(bool* out_is_move) {
+    int ordinal = ref_ordinal++;
+    if (!call) {
+      *out_is_move = true;
+      return &frame->registers.ref[ordinal];
+    }
+    if (ordinal >= call->ref_argument_registers->size) {
+      status = InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Missing ref argument " << ordinal;
+      return nullptr;
+    }
+    uint16_t reg = call->ref_argument_registers->registers[ordinal];
+    *out_is_move = (reg & IREE_REF_REGISTER_MOVE_BIT) != 0;
+    return &call->registers->ref[reg & IREE_REF_REGISTER_MASK];
+  }
+
   template <typename... Ts>
   static StatusOr<std::tuple<typename ParamUnpack<
       typename std::remove_reference<Ts>::type>::storage_type...>>
-  LoadSequence(iree_vm_stack_frame_t* frame) {
+  LoadSequence(iree_vm_stack_frame_t* frame,
+               const iree_vm_direct_call_t* call = nullptr) {
     auto params = std::make_tuple(
         typename ParamUnpack<
             typename impl::remove_cvref<Ts>::type>::storage_type()...);
 
-    ParamUnpackState param_state{frame};
+    ParamUnpackState param_state{frame, call};
     ApplyLoad<Ts...>(&param_state, params,
                      std::make_index_sequence<sizeof...(Ts)>());
     RETURN_IF_ERROR(param_state.status);
@@ -129,8 +179,7 @@ struct ParamUnpack {
   using storage_type = T;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    out_param = static_cast<T>(
-        param_state->frame->registers.i32[param_state->i32_ordinal++]);
+    out_param = static_cast<T>(param_state->NextI32());
   }
 };
 
@@ -139,14 +188,16 @@ struct ParamUnpack<opaque_ref> {
   using storage_type = opaque_ref;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    auto* reg = &param_state->frame->registers.ref[param_state->ref_ordinal++];
+    bool is_move = false;
+    auto* reg = param_state->NextRef(&is_move);
+    if (!reg) return;
     if (iree_vm_ref_is_null(reg)) {
       param_state->status = InvalidArgumentErrorBuilder(IREE_LOC)
                             << "argument " << (param_state->varargs_ordinal - 1)
                             << " (" << typeid(storage_type).name() << ")"
                             << " must not be a null";
     } else {
-      iree_vm_ref_move(reg, &out_param);
+      iree_vm_ref_retain_or_move(is_move, reg, &out_param);
     }
   }
 };
@@ -156,10 +207,11 @@ struct ParamUnpack<absl::optional<opaque_ref>> {
   using storage_type = absl::optional<opaque_ref>;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    auto* reg = &param_state->frame->registers.ref[param_state->ref_ordinal++];
-    if (!iree_vm_ref_is_null(reg)) {
+    bool is_move = false;
+    auto* reg = param_state->NextRef(&is_move);
+    if (reg && !iree_vm_ref_is_null(reg)) {
       out_param = {opaque_ref()};
-      iree_vm_ref_move(reg, &out_param.value());
+      iree_vm_ref_retain_or_move(is_move, reg, &out_param.value());
     }
   }
 };
@@ -169,12 +221,17 @@ struct ParamUnpack<ref<T>> {
   using storage_type = ref<T>;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    auto& ref_storage =
-        param_state->frame->registers.ref[param_state->ref_ordinal++];
+    bool is_move = false;
+    auto* ref_ptr = param_state->NextRef(&is_move);
+    if (!ref_ptr) return;
+    auto& ref_storage = *ref_ptr;
     if (ref_storage.type == ref_type_descriptor<T>::get()->type) {
-      // Move semantics.
-      out_param = ref<T>{reinterpret_cast<T*>(ref_storage.ptr)};
-      std::memset(&ref_storage, 0, sizeof(ref_storage));
+      if (is_move) {
+        out_param = assign_ref(reinterpret_cast<T*>(ref_storage.ptr));
+        std::memset(&ref_storage, 0, sizeof(ref_storage));
+      } else {
+        out_param = retain_ref(reinterpret_cast<T*>(ref_storage.ptr));
+      }
     } else if (ref_storage.type != IREE_VM_REF_TYPE_NULL) {
       param_state->status =
           InvalidArgumentErrorBuilder(IREE_LOC)
@@ -197,12 +254,17 @@ struct ParamUnpack<absl::optional<ref<T>>> {
   using storage_type = absl::optional<ref<T>>;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    auto& ref_storage =
-        param_state->frame->registers.ref[param_state->ref_ordinal++];
+    bool is_move = false;
+    auto* ref_ptr = param_state->NextRef(&is_move);
+    if (!ref_ptr) return;
+    auto& ref_storage = *ref_ptr;
     if (ref_storage.type == ref_type_descriptor<T>::get()->type) {
-      // Move semantics.
-      out_param = ref<T>{reinterpret_cast<T*>(ref_storage.ptr)};
-      std::memset(&ref_storage, 0, sizeof(ref_storage));
+      if (is_move) {
+        out_param = assign_ref(reinterpret_cast<T*>(ref_storage.ptr));
+        std::memset(&ref_storage, 0, sizeof(ref_storage));
+      } else {
+        out_param = retain_ref(reinterpret_cast<T*>(ref_storage.ptr));
+      }
     } else if (ref_storage.type != IREE_VM_REF_TYPE_NULL) {
       param_state->status =
           InvalidArgumentErrorBuilder(IREE_LOC)
@@ -223,8 +285,12 @@ struct ParamUnpack<absl::string_view> {
   using storage_type = absl::string_view;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
     ++param_state->varargs_ordinal;
-    auto& ref_storage =
-        param_state->frame->registers.ref[param_state->ref_ordinal++];
+    // The buffer is borrowed from the register and not moved as the view
+    // must remain valid for the duration of the call.
+    bool is_move = false;
+    auto* ref_ptr = param_state->NextRef(&is_move);
+    if (!ref_ptr) return;
+    auto& ref_storage = *ref_ptr;
     if (ref_storage.type ==
         ref_type_descriptor<iree_vm_ro_byte_buffer_t>::get()->type) {
       auto byte_span =
@@ -287,6 +353,12 @@ struct ParamUnpack<absl::Span<U>> {
   using element_type = typename impl::remove_cvref<U>::type;
   using storage_type = std::vector<element_type>;
   static void Load(ParamUnpackState* param_state, storage_type& out_param) {
+    if (!param_state->frame || !param_state->frame->return_registers) {
+      // Segment sizes are only provided for variadic calls.
+      param_state->status = InvalidArgumentErrorBuilder(IREE_LOC)
+                            << "Variadic argument segment sizes not provided";
+      return;
+    }
     const uint16_t count = param_state->frame->return_registers
                                ->registers[param_state->varargs_ordinal++];
     int32_t original_varargs_ordinal = param_state->varargs_ordinal;
@@ -302,11 +374,69 @@ struct ParamUnpack<absl::Span<U>> {
 // Result packing
 //===----------------------------------------------------------------------===//
 
+// Results are packed either left-aligned into the registers of a callee
+// |frame| or, for direct calls, straight into the caller registers described
+// by |call|.
 struct ResultPackState {
+  iree_vm_stack_t* stack;
   iree_vm_stack_frame_t* frame;
+  const iree_vm_direct_call_t* call = nullptr;
   int i32_ordinal = 0;
   int ref_ordinal = 0;
   Status status;
+
+  // Returns the register to store the next primitive result in or nullptr on
+  // failure.
+  int32_t* NextI32() {
+    if (!call) {
+      if (!ReserveNext(1, 0)) return nullptr;
+      return &frame->registers.i32[i32_ordinal++];
+    }
+    int ordinal = i32_ordinal++ + ref_ordinal;
+    if (!CheckResultOrdinal(ordinal)) return nullptr;
+    uint16_t reg = call->result_registers->registers[ordinal];
+    return &call->registers->i32[reg & IREE_I32_REGISTER_MASK];
+  }
+
+  // Returns the empty register to store the next ref result in or nullptr on
+  // failure.
+  iree_vm_ref_t* NextRef() {
+    iree_vm_ref_t* reg_ptr = nullptr;
+    if (!call) {
+      if (!ReserveNext(0, 1)) return nullptr;
+      reg_ptr = &frame->registers.ref[ref_ordinal++];
+      std::memset(reg_ptr, 0, sizeof(*reg_ptr));
+      return reg_ptr;
+    }
+    int ordinal = i32_ordinal + ref_ordinal++;
+    if (!CheckResultOrdinal(ordinal)) return nullptr;
+    uint16_t reg = call->result_registers->registers[ordinal];
+    reg_ptr = &call->registers->ref[reg & IREE_REF_REGISTER_MASK];
+    iree_vm_ref_release(reg_ptr);
+    return reg_ptr;
+  }
+
+  bool CheckResultOrdinal(int ordinal) {
+    if (!status.ok()) return false;
+    if (ordinal >= call->result_registers->size) {
+      status = InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Missing result register " << ordinal;
+      return false;
+    }
+    return true;
+  }
+
+  // Reserves the frame registers needed to store the next result.
+  // Callers only reserve the registers used by the arguments.
+  bool ReserveNext(int i32_count, int ref_count) {
+    if (!status.ok()) return false;
+    status = FromApiStatus(
+        iree_vm_stack_frame_reserve_registers(stack, frame,
+                                              i32_ordinal + i32_count,
+                                              ref_ordinal + ref_count),
+        IREE_LOC);
+    return status.ok();
+  }
 };
 
 template <typename T>
@@ -328,8 +458,9 @@ struct ResultRegister<std::tuple<Ts...>> {
 template <typename T>
 struct ResultPack {
   static void Store(ResultPackState* result_state, T value) {
-    result_state->frame->registers.i32[result_state->i32_ordinal++] =
-        static_cast<int32_t>(value);
+    auto* reg_ptr = result_state->NextI32();
+    if (!reg_ptr) return;
+    *reg_ptr = static_cast<int32_t>(value);
   }
 };
 
@@ -342,9 +473,8 @@ struct ResultPack<ref<T>> {
                              << ") must not be null";
       return;
     }
-    auto* reg_ptr =
-        &result_state->frame->registers.ref[result_state->ref_ordinal++];
-    std::memset(reg_ptr, 0, sizeof(*reg_ptr));
+    auto* reg_ptr = result_state->NextRef();
+    if (!reg_ptr) return;
     iree_vm_ref_wrap_assign(value.release(), value.type(), reg_ptr);
   }
 };
@@ -358,9 +488,8 @@ template <typename T>
 struct ResultPack<absl::optional<ref<T>>> {
   static void Store(ResultPackState* result_state,
                     absl::optional<ref<T>> value) {
-    auto* reg_ptr =
-        &result_state->frame->registers.ref[result_state->ref_ordinal++];
-    std::memset(reg_ptr, 0, sizeof(*reg_ptr));
+    auto* reg_ptr = result_state->NextRef();
+    if (!reg_ptr) return;
     if (value.has_value()) {
       iree_vm_ref_wrap_assign(value.release(), value.type(), reg_ptr);
     }
@@ -412,8 +541,7 @@ struct DispatchFunctor {
   }
 
   static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
-                     iree_vm_stack_frame_t* frame,
-                     iree_vm_execution_result_t* out_result) {
+                     iree_vm_stack_frame_t* frame, Wait* out_wait) {
     ASSIGN_OR_RETURN(auto params,
                      ParamUnpackState::LoadSequence<Params...>(frame));
 
@@ -437,7 +565,26 @@ struct DispatchFunctor {
     frame->return_registers =
         reinterpret_cast<const iree_vm_register_list_t*>(kResultList.data());
 
-    ResultPackState result_state{frame};
+    ResultPackState result_state{stack, frame};
+    auto results = std::move(results_or).value();
+    ResultPack<Results>::Store(&result_state, std::move(results));
+    return result_state.status;
+  }
+
+  static Status CallDirect(void (Owner::*ptr)(), Owner* self,
+                           iree_vm_stack_t* stack,
+                           const iree_vm_direct_call_t* call) {
+    ASSIGN_OR_RETURN(auto params,
+                     ParamUnpackState::LoadSequence<Params...>(nullptr, call));
+
+    auto results_or =
+        ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
+                std::make_index_sequence<sizeof...(Params)>());
+    if (!results_or.ok()) {
+      return std::move(results_or).status();
+    }
+
+    ResultPackState result_state{stack, nullptr, call};
     auto results = std::move(results_or).value();
     ResultPack<Results>::Store(&result_state, std::move(results));
     return result_state.status;
@@ -455,8 +602,7 @@ struct DispatchFunctorVoid {
   using FnPtr = Status (Owner::*)(Params...);
 
   static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
-                     iree_vm_stack_frame_t* frame,
-                     iree_vm_execution_result_t* out_result) {
+                     iree_vm_stack_frame_t* frame, Wait* out_wait) {
     ASSIGN_OR_RETURN(auto params,
                      ParamUnpackState::LoadSequence<Params...>(frame));
 
@@ -467,6 +613,15 @@ struct DispatchFunctorVoid {
                    std::make_index_sequence<sizeof...(Params)>());
   }
 
+  static Status CallDirect(void (Owner::*ptr)(), Owner* self,
+                           iree_vm_stack_t* stack,
+                           const iree_vm_direct_call_t* call) {
+    ASSIGN_OR_RETURN(auto params,
+                     ParamUnpackState::LoadSequence<Params...>(nullptr, call));
+    return ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
+                   std::make_index_sequence<sizeof...(Params)>());
+  }
+
   template <typename T, size_t... I>
   static Status ApplyFn(FnPtr ptr, Owner* self, T&& params,
                         std::index_sequence<I...>) {
@@ -474,29 +629,71 @@ struct DispatchFunctorVoid {
   }
 };
 
+template <typename Owner, typename... Params>
+struct DispatchFunctorWait {
+  using FnPtr = StatusOr<Wait> (Owner::*)(Params...);
+
+  static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
+                     iree_vm_stack_frame_t* frame, Wait* out_wait) {
+    ASSIGN_OR_RETURN(auto params,
+                     ParamUnpackState::LoadSequence<Params...>(frame));
+
+    frame->return_registers = nullptr;
+    frame->registers.ref_register_count = 0;
+
+    ASSIGN_OR_RETURN(
+        *out_wait,
+        ApplyFn(reinterpret_cast<FnPtr>(ptr), self, std::move(params),
+                std::make_index_sequence<sizeof...(Params)>()));
+    return OkStatus();
+  }
+
+  template <typename T, size_t... I>
+  static StatusOr<Wait> ApplyFn(FnPtr ptr, Owner* self, T&& params,
+                                std::index_sequence<I...>) {
+    return (self->*ptr)(std::move(std::get<I>(params))...);
+  }
+};
+
 }  // namespace packing
 
 template <typename Owner>
 struct NativeFunction {
   const char* name;
   void (Owner::*const ptr)();
+  // Executes the function with arguments and results in a callee |frame|.
+  // |out_wait| is set if the function must wait before it completes.
   Status (*const call)(void (Owner::*ptr)(), Owner* self,
                        iree_vm_stack_t* stack, iree_vm_stack_frame_t* frame,
-                       iree_vm_execution_result_t* out_result);
+                       Wait* out_wait);
+  // Executes the function with arguments and results in the caller registers.
+  // Null for functions that may wait as they require a frame to suspend.
+  Status (*const call_direct)(void (Owner::*ptr)(), Owner* self,
+                              iree_vm_stack_t* stack,
+                              const iree_vm_direct_call_t* call);
 };
 
 template <typename Owner, typename Result, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     const char* name, StatusOr<Result> (Owner::*fn)(Params...)) {
   return {name, (void (Owner::*)())fn,
-          &packing::DispatchFunctor<Owner, Result, Params...>::Call};
+          &packing::DispatchFunctor<Owner, Result, Params...>::Call,
+          &packing::DispatchFunctor<Owner, Result, Params...>::CallDirect};
 }
 
 template <typename Owner, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     const char* name, Status (Owner::*fn)(Params...)) {
   return {name, (void (Owner::*)())fn,
-          &packing::DispatchFunctorVoid<Owner, Params...>::Call};
+          &packing::DispatchFunctorVoid<Owner, Params...>::Call,
+          &packing::DispatchFunctorVoid<Owner, Params...>::CallDirect};
+}
+
+template <typename Owner, typename... Params>
+constexpr NativeFunction<Owner> MakeNativeFunction(
+    const char* name, StatusOr<Wait> (Owner::*fn)(Params...)) {
+  return {name, (void (Owner::*)())fn,
+          &packing::DispatchFunctorWait<Owner, Params...>::Call, nullptr};
 }
 
 }  // namespace vm
@@ -18,15 +18,95 @@
 
 #include "iree/vm/module.h"
 
+// Alignment of frames and register storage within stack blocks.
+#define IREE_VM_STACK_ALIGNMENT 16
+
+static inline iree_host_size_t iree_vm_stack_align(iree_host_size_t value) {
+  return (value + IREE_VM_STACK_ALIGNMENT - 1) &
+         ~(iree_host_size_t)(IREE_VM_STACK_ALIGNMENT - 1);
+}
+
+struct iree_vm_stack_block {
+  // Adjacent blocks in allocation order.
+  iree_vm_stack_block_t* prev;
+  iree_vm_stack_block_t* next;
+  // Size of the block storage, in bytes.
+  iree_host_size_t capacity;
+  // Number of bytes of the block storage in use.
+  iree_host_size_t offset;
+  // Storage follows the header, aligned to IREE_VM_STACK_ALIGNMENT.
+};
+
+static inline uint8_t* iree_vm_stack_block_storage(
+    iree_vm_stack_block_t* block) {
+  return (uint8_t*)block + iree_vm_stack_align(sizeof(iree_vm_stack_block_t));
+}
+
+// Allocates |size| bytes of storage from the top of |stack|.
+// If the current block is full the next retained block is used, and if that is
+// missing or too small a new block is allocated in its place.
+static iree_status_t iree_vm_stack_allocate(iree_vm_stack_t* stack,
+                                            iree_host_size_t size,
+                                            void** out_ptr) {
+  size = iree_vm_stack_align(size);
+  iree_vm_stack_block_t* block = stack->current_block;
+  if (!block || block->offset + size > block->capacity) {
+    iree_vm_stack_block_t* next_block =
+        block ? block->next : stack->first_block;
+    if (!next_block || next_block->capacity < size) {
+      iree_host_size_t capacity = size > IREE_VM_STACK_DEFAULT_BLOCK_SIZE
+                                      ? size
+                                      : IREE_VM_STACK_DEFAULT_BLOCK_SIZE;
+      iree_vm_stack_block_t* new_block = NULL;
+      IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+          stack->allocator,
+          iree_vm_stack_align(sizeof(iree_vm_stack_block_t)) + capacity,
+          (void**)&new_block));
+      new_block->capacity = capacity;
+      new_block->prev = block;
+      new_block->next = next_block;
+      if (next_block) next_block->prev = new_block;
+      if (block) {
+        block->next = new_block;
+      } else {
+        stack->first_block = new_block;
+      }
+      next_block = new_block;
+    }
+    next_block->offset = 0;
+    block = next_block;
+    stack->current_block = block;
+  }
+  *out_ptr = iree_vm_stack_block_storage(block) + block->offset;
+  block->offset += size;
+  return IREE_STATUS_OK;
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_init(
-    iree_vm_state_resolver_t state_resolver, iree_vm_stack_t* out_stack) {
+    iree_vm_state_resolver_t state_resolver, iree_allocator_t allocator,
+    iree_vm_stack_t* out_stack) {
   memset(out_stack, 0, sizeof(iree_vm_stack_t));
+  out_stack->allocator = allocator;
   out_stack->state_resolver = state_resolver;
   return IREE_STATUS_OK;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_stack_deinit(iree_vm_stack_t* stack) {
+  IREE_RETURN_IF_ERROR(iree_vm_stack_reset(stack));
+  iree_vm_stack_block_t* block = stack->first_block;
+  while (block) {
+    iree_vm_stack_block_t* next_block = block->next;
+    iree_allocator_free(stack->allocator, block);
+    block = next_block;
+  }
+  stack->first_block = NULL;
+  stack->current_block = NULL;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_stack_reset(iree_vm_stack_t* stack) {
   while (stack->depth) {
     IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));
   }
@@ -35,12 +115,17 @@ iree_vm_stack_deinit(iree_vm_stack_t* stack) {
 
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_current_frame(iree_vm_stack_t* stack) {
-  return stack->depth > 0 ? &stack->frames[stack->depth - 1] : NULL;
+  return stack->current_frame;
 }
 
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_parent_frame(iree_vm_stack_t* stack) {
-  return stack->depth > 1 ? &stack->frames[stack->depth - 2] : NULL;
+  return stack->current_frame ? stack->current_frame->parent : NULL;
+}
+
+IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
+iree_vm_stack_entry_frame(iree_vm_stack_t* stack) {
+  return stack->entry_frame;
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
@@ -53,34 +138,99 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
 
   // Try to reuse the same module state if the caller and callee are from the
   // same module. Otherwise, query the state from the registered handler.
-  iree_vm_stack_frame_t* callee_frame = &stack->frames[stack->depth];
-  if (stack->depth > 0) {
-    iree_vm_stack_frame_t* caller_frame = &stack->frames[stack->depth - 1];
-    if (caller_frame->function.module == function.module) {
-      callee_frame->module_state = caller_frame->module_state;
-    }
-  }
-  if (!callee_frame->module_state) {
+  iree_vm_stack_frame_t* caller_frame = stack->current_frame;
+  iree_vm_module_state_t* module_state = NULL;
+  if (caller_frame && caller_frame->function.module == function.module) {
+    module_state = caller_frame->module_state;
+  } else {
     IREE_RETURN_IF_ERROR(stack->state_resolver.query_module_state(
-        stack->state_resolver.self, function.module,
-        &callee_frame->module_state));
+        stack->state_resolver.self, function.module, &module_state));
   }
 
+  iree_vm_stack_block_t* storage_block = stack->current_block;
+  iree_host_size_t storage_offset = storage_block ? storage_block->offset : 0;
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_allocate(
+      stack, sizeof(iree_vm_stack_frame_t), (void**)&callee_frame));
+  memset(callee_frame, 0, sizeof(*callee_frame));
+  callee_frame->function = function;
+  callee_frame->module_state = module_state;
+  callee_frame->parent = caller_frame;
+  callee_frame->storage_block = storage_block;
+  callee_frame->storage_offset = storage_offset;
+
   ++stack->depth;
+  if (!caller_frame) stack->entry_frame = callee_frame;
+  stack->current_frame = callee_frame;
 
-  callee_frame->function = function;
-  callee_frame->pc = 0;
-  callee_frame->registers.ref_register_count = 0;
-  callee_frame->return_registers = NULL;
+  *out_callee_frame = callee_frame;
+  return IREE_STATUS_OK;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_stack_frame_reserve_registers(iree_vm_stack_t* stack,
+                                      iree_vm_stack_frame_t* frame,
+                                      int32_t i32_register_count,
+                                      int32_t ref_register_count) {
+  iree_vm_registers_t* registers = &frame->registers;
+  if (i32_register_count <= registers->i32_capacity &&
+      ref_register_count <= registers->ref_capacity) {
+    return IREE_STATUS_OK;
+  } else if (frame != stack->current_frame) {
+    return IREE_STATUS_FAILED_PRECONDITION;
+  } else if (i32_register_count > IREE_I32_REGISTER_COUNT ||
+             ref_register_count > IREE_REF_REGISTER_COUNT) {
+    return IREE_STATUS_OUT_OF_RANGE;
+  }
+
+  // The i32 bank is rounded up so that the ref bank following it is aligned.
+  iree_host_size_t old_i32_capacity = registers->i32_capacity;
+  iree_host_size_t old_ref_capacity = registers->ref_capacity;
+  iree_host_size_t new_i32_capacity =
+      i32_register_count > old_i32_capacity ? i32_register_count
+                                            : old_i32_capacity;
+  new_i32_capacity = (new_i32_capacity + 3) & ~(iree_host_size_t)3;
+  iree_host_size_t new_ref_capacity =
+      ref_register_count > old_ref_capacity ? ref_register_count
+                                            : old_ref_capacity;
+  iree_host_size_t new_i32_size = new_i32_capacity * sizeof(int32_t);
+  iree_host_size_t new_size =
+      new_i32_size + new_ref_capacity * sizeof(iree_vm_ref_t);
 
+  // The registers of the current frame are always the last allocation in the
+  // current block so they can be grown in place if the block has room.
+  uint8_t* old_storage = (uint8_t*)registers->i32;
+  iree_vm_stack_block_t* block = stack->current_block;
+  uint8_t* new_storage = NULL;
+  if (old_storage && old_storage + new_size <= iree_vm_stack_block_storage(
+                                                   block) + block->capacity) {
+    new_storage = old_storage;
+    memmove(new_storage + new_i32_size, registers->ref,
+            old_ref_capacity * sizeof(iree_vm_ref_t));
+    block->offset =
+        (old_storage - iree_vm_stack_block_storage(block)) +
+        iree_vm_stack_align(new_size);
+  } else {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_stack_allocate(stack, new_size, (void**)&new_storage));
+    if (old_storage) {
+      memcpy(new_storage, registers->i32, old_i32_capacity * sizeof(int32_t));
+      memcpy(new_storage + new_i32_size, registers->ref,
+             old_ref_capacity * sizeof(iree_vm_ref_t));
+    }
+  }
+
+  registers->i32 = (int32_t*)new_storage;
+  registers->ref = (iree_vm_ref_t*)(new_storage + new_i32_size);
+  registers->i32_capacity = (uint16_t)new_i32_capacity;
+  registers->ref_capacity = (uint16_t)new_ref_capacity;
+  memset(&registers->ref[old_ref_capacity], 0,
+         (new_ref_capacity - old_ref_capacity) * sizeof(iree_vm_ref_t));
 #ifndef NDEBUG
-  memset(callee_frame->registers.i32, 0xCD,
-         sizeof(callee_frame->registers.i32));
-  memset(callee_frame->registers.ref, 0xCD,
-         sizeof(callee_frame->registers.ref));
+  memset(&registers->i32[old_i32_capacity], 0xCD,
+         (new_i32_capacity - old_i32_capacity) * sizeof(int32_t));
 #endif  // !NDEBUG
 
-  *out_callee_frame = callee_frame;
   return IREE_STATUS_OK;
 }
 
@@ -90,15 +240,22 @@ iree_vm_stack_function_leave(iree_vm_stack_t* stack) {
     return IREE_STATUS_FAILED_PRECONDITION;
   }
 
-  iree_vm_stack_frame_t* callee_frame = &stack->frames[stack->depth - 1];
-  --stack->depth;
-  memset(&callee_frame->function, 0, sizeof(callee_frame->function));
-  callee_frame->module_state = NULL;
-
+  iree_vm_stack_frame_t* callee_frame = stack->current_frame;
   iree_vm_registers_t* registers = &callee_frame->registers;
   for (int i = 0; i < registers->ref_register_count; ++i) {
     iree_vm_ref_release(&registers->ref[i]);
   }
 
+  --stack->depth;
+  stack->current_frame = callee_frame->parent;
+  if (!stack->current_frame) stack->entry_frame = NULL;
+
+  // Return the frame storage to the stack. Any blocks allocated for the frame
+  // are retained for reuse.
+  stack->current_block = callee_frame->storage_block;
+  if (stack->current_block) {
+    stack->current_block->offset = callee_frame->storage_offset;
+  }
+
   return IREE_STATUS_OK;
 }
@@ -28,14 +28,28 @@ extern "C" {
 #endif  // __cplusplus
 
 // Maximum stack depth, in frames.
-#define IREE_MAX_STACK_DEPTH 32
+// Stack storage grows on demand and this only bounds runaway recursion.
+#ifndef IREE_MAX_STACK_DEPTH
+#define IREE_MAX_STACK_DEPTH 1024
+#endif  // !IREE_MAX_STACK_DEPTH
+
+// Default size of each block of stack storage, in bytes. Frames needing more
+// storage than this get a block of their own.
+#ifndef IREE_VM_STACK_DEFAULT_BLOCK_SIZE
+#define IREE_VM_STACK_DEFAULT_BLOCK_SIZE (32 * 1024)
+#endif  // !IREE_VM_STACK_DEFAULT_BLOCK_SIZE
 
 // Maximum register count per bank.
 // This determines the bits required to reference registers in the VM bytecode.
-#define IREE_I32_REGISTER_COUNT 0x7FFF
+// The primitive bank holds 32-bit values (i32/f32) in a single register and
+// 64-bit values (i64) in a pair of consecutive registers, the first of which
+// is always even and referenced with IREE_I64_REGISTER_BIT set.
+#define IREE_I32_REGISTER_COUNT 0x4000
 #define IREE_REF_REGISTER_COUNT 0x7FFF
 
-#define IREE_I32_REGISTER_MASK 0x7FFF
+#define IREE_I32_REGISTER_MASK 0x3FFF
+#define IREE_I64_REGISTER_BIT 0x4000
+#define IREE_I64_REGISTER_MASK 0x3FFE
 
 #define IREE_REF_REGISTER_TYPE_BIT 0x8000
 #define IREE_REF_REGISTER_MOVE_BIT 0x4000
@@ -48,13 +62,19 @@ extern "C" {
 typedef int64_t iree_vm_source_offset_t;
 
 // Register banks for use within a stack frame.
+// Storage is allocated from the stack with
+// iree_vm_stack_frame_reserve_registers and only registers below the reserved
+// capacities may be accessed.
 typedef struct {
-  // Integer registers.
-  iree_alignas(16) int32_t i32[IREE_I32_REGISTER_COUNT];
+  // Primitive registers. f32 values are stored bitwise and i64 values span two
+  // registers (see IREE_I64_REGISTER_BIT). Aligned to 16 bytes.
+  int32_t* i32;
   // Reference counted registers.
-  iree_vm_ref_t ref[IREE_REF_REGISTER_COUNT];
+  iree_vm_ref_t* ref;
+  // Number of registers allocated in each bank.
+  uint16_t i32_capacity;
+  uint16_t ref_capacity;
   // Total number of valid ref registers used by the function.
-  // TODO(benvanik): make the above dynamic and include i32 count.
   uint16_t ref_register_count;
 } iree_vm_registers_t;
 
@@ -71,6 +91,24 @@ static_assert(iree_alignof(iree_vm_register_list_t) == 2,
 static_assert(offsetof(iree_vm_register_list_t, registers) == 2,
               "Expect no padding in the struct");
 
+// Interleaved src-dst register sets.
+// This structure is an overlay for the bytecode that is serialized in a
+// matching format.
+typedef struct {
+  uint16_t size;
+  struct iree_vm_register_remap_pair {
+    uint16_t src_reg;
+    uint16_t dst_reg;
+  } pairs[];
+} iree_vm_register_remap_list_t;
+static_assert(iree_alignof(iree_vm_register_remap_list_t) == 2,
+              "Expecting byte alignment (to avoid padding)");
+static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
+              "Expect no padding in the struct");
+
+// A block of storage from which stack frames and registers are allocated.
+typedef struct iree_vm_stack_block iree_vm_stack_block_t;
+
 // A single stack frame within the VM.
 typedef struct iree_vm_stack_frame {
   // Function that the stack frame is within.
@@ -87,8 +125,35 @@ typedef struct iree_vm_stack_frame {
   // If omitted then the return values are assumed to be left-aligned in the
   // register banks.
   const iree_vm_register_list_t* return_registers;
+
+  // Time the function was entered, in nanoseconds. Only used by modules built
+  // with profiling enabled (see iree_vm_bytecode_module_profile_snapshot).
+  int64_t profile_enter_time_ns;
+
+  // Frame of the caller or NULL if this is the entry frame.
+  struct iree_vm_stack_frame* parent;
+  // Stack storage position to restore when leaving the frame.
+  iree_vm_stack_block_t* storage_block;
+  iree_host_size_t storage_offset;
 } iree_vm_stack_frame_t;
 
+// A call made directly from the registers of the caller frame.
+// See iree_vm_module_t::call_direct.
+typedef struct iree_vm_direct_call {
+  // Function being called.
+  iree_vm_function_t function;
+  // Registers of the caller frame.
+  iree_vm_registers_t* registers;
+  // Primitive arguments as (caller register, ABI register) pairs. The ABI
+  // registers are left-aligned in argument order.
+  const iree_vm_register_remap_list_t* i32_argument_registers;
+  // Ref arguments in argument order. Ownership of refs marked with
+  // IREE_REF_REGISTER_MOVE_BIT may be taken by the callee.
+  const iree_vm_register_list_t* ref_argument_registers;
+  // Caller registers receiving the results in result order.
+  const iree_vm_register_list_t* result_registers;
+} iree_vm_direct_call_t;
+
 // A state resolver that can allocate or lookup module state.
 typedef struct iree_vm_state_resolver {
   void* self;
@@ -100,12 +165,25 @@ typedef struct iree_vm_state_resolver {
 // A fiber stack used for storing stack frame state during execution.
 // All required state is stored within the stack and no host thread-local state
 // is used allowing us to execute multiple fibers on the same host thread.
+//
+// Frames and their registers are allocated from a list of storage blocks that
+// is grown on demand. Blocks are retained when frames are left so that a stack
+// reused across invocations (see iree_vm_context_acquire_stack) does not
+// allocate once warm.
 typedef struct iree_vm_stack {
   // TODO(benvanik): add globally useful things (instance/device manager?)
   // Depth of the stack, in frames. 0 indicates an empty stack.
   int32_t depth;
-  // [0-depth) valid stack frames.
-  iree_vm_stack_frame_t frames[IREE_MAX_STACK_DEPTH];
+  // Outermost and innermost frames or NULL if the stack is empty.
+  iree_vm_stack_frame_t* entry_frame;
+  iree_vm_stack_frame_t* current_frame;
+
+  // Storage blocks in allocation order and the block frames are currently
+  // allocated from. Blocks after |current_block| are unused.
+  iree_vm_stack_block_t* first_block;
+  iree_vm_stack_block_t* current_block;
+  // Allocator used for storage blocks.
+  iree_allocator_t allocator;
 
   // Resolves a module to a module state within a context.
   // This will be called on function entry whenever module transitions occur.
@@ -113,13 +191,20 @@ typedef struct iree_vm_stack {
 } iree_vm_stack_t;
 
 // Constructs a stack in-place in |out_stack|.
+// No storage is allocated until frames are entered.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_init(
-    iree_vm_state_resolver_t state_resolver, iree_vm_stack_t* out_stack);
+    iree_vm_state_resolver_t state_resolver, iree_allocator_t allocator,
+    iree_vm_stack_t* out_stack);
 
-// Destructs |stack|.
+// Destructs |stack|, leaving any remaining frames and freeing its storage.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_stack_deinit(iree_vm_stack_t* stack);
 
+// Leaves any remaining frames so that the |stack| can be reused for another
+// invocation. Storage is retained.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_stack_reset(iree_vm_stack_t* stack);
+
 // Returns the current stack frame or nullptr if the stack is empty.
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_current_frame(iree_vm_stack_t* stack);
@@ -128,12 +213,31 @@ iree_vm_stack_current_frame(iree_vm_stack_t* stack);
 IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
 iree_vm_stack_parent_frame(iree_vm_stack_t* stack);
 
+// Returns the outermost stack frame or nullptr if the stack is empty.
+IREE_API_EXPORT iree_vm_stack_frame_t* IREE_API_CALL
+iree_vm_stack_entry_frame(iree_vm_stack_t* stack);
+
 // Enters into the given |function| and returns the callee stack frame.
-// Callers must populate the argument registers as defined by the VM API.
+// The frame has no registers; callers must reserve registers with
+// iree_vm_stack_frame_reserve_registers and populate the argument registers as
+// defined by the VM API.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
     iree_vm_stack_t* stack, iree_vm_function_t function,
     iree_vm_stack_frame_t** out_callee_frame);
 
+// Ensures that |frame| has storage for at least |i32_register_count| primitive
+// and |ref_register_count| ref registers. Existing register values are
+// preserved and newly allocated ref registers are zeroed. The register
+// pointers in |frame| may change.
+//
+// Storage can only grow for the current frame; returns
+// IREE_STATUS_FAILED_PRECONDITION if a parent frame has insufficient capacity.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_stack_frame_reserve_registers(iree_vm_stack_t* stack,
+                                      iree_vm_stack_frame_t* frame,
+                                      int32_t i32_register_count,
+                                      int32_t ref_register_count);
+
 // Leaves the current stack frame.
 // Callers must have retrieved the result registers as defined by the VM API.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
@@ -49,7 +49,8 @@ static iree_status_t SentinelStateResolver(
 TEST(VMStackTest, Usage) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
   EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
@@ -86,7 +87,8 @@ TEST(VMStackTest, Usage) {
 TEST(VMStackTest, DeinitWithRemainingFrames) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   iree_vm_function_t function_a = {MODULE_A_SENTINEL,
                                    IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
@@ -106,7 +108,8 @@ TEST(VMStackTest, DeinitWithRemainingFrames) {
 TEST(VMStackTest, StackOverflow) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
   EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
@@ -137,7 +140,8 @@ TEST(VMStackTest, StackOverflow) {
 TEST(VMStackTest, UnbalancedPop) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   EXPECT_EQ(IREE_STATUS_FAILED_PRECONDITION,
             iree_vm_stack_function_leave(stack.get()));
@@ -149,7 +153,8 @@ TEST(VMStackTest, UnbalancedPop) {
 TEST(VMStackTest, ModuleStateQueries) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
   EXPECT_EQ(nullptr, iree_vm_stack_parent_frame(stack.get()));
@@ -198,7 +203,8 @@ TEST(VMStackTest, ModuleStateQueryFailure) {
         // NOTE: always failing.
         return IREE_STATUS_INTERNAL;
       }};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   // Push should fail if we can't query state, status should propagate.
   iree_vm_function_t function_a = {MODULE_A_SENTINEL,
@@ -234,7 +240,8 @@ iree_vm_ref_type_t DummyObject::kTypeID = IREE_VM_REF_TYPE_NULL;
 TEST(VMStackTest, RefRegisterCleanup) {
   auto stack = std::make_unique<iree_vm_stack_t>();
   iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
-  IREE_EXPECT_OK(iree_vm_stack_init(state_resolver, stack.get()));
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
 
   dummy_object_count = 0;
   DummyObject::RegisterType();
@@ -244,8 +251,9 @@ TEST(VMStackTest, RefRegisterCleanup) {
   iree_vm_stack_frame_t* frame_a = nullptr;
   IREE_EXPECT_OK(
       iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 0, 1));
   frame_a->registers.ref_register_count = 1;
-  memset(&frame_a->registers.ref[0], 0, sizeof(iree_vm_ref_t));
   IREE_EXPECT_OK(iree_vm_ref_wrap_assign(
       new DummyObject(), DummyObject::kTypeID, &frame_a->registers.ref[0]));
   EXPECT_EQ(1, dummy_object_count);
@@ -257,4 +265,110 @@ TEST(VMStackTest, RefRegisterCleanup) {
   IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
 }
 
+// Tests that growing the registers of a frame preserves their values.
+TEST(VMStackTest, ReserveRegistersGrowth) {
+  auto stack = std::make_unique<iree_vm_stack_t>();
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
+
+  dummy_object_count = 0;
+  DummyObject::RegisterType();
+
+  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_stack_frame_t* frame_a = nullptr;
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 2, 1));
+  frame_a->registers.i32[0] = 1;
+  frame_a->registers.i32[1] = 2;
+  IREE_EXPECT_OK(iree_vm_ref_wrap_assign(
+      new DummyObject(), DummyObject::kTypeID, &frame_a->registers.ref[0]));
+
+  // Grow well past the default block size to force new storage.
+  IREE_EXPECT_OK(iree_vm_stack_frame_reserve_registers(
+      stack.get(), frame_a, IREE_I32_REGISTER_COUNT, 1024));
+  EXPECT_LE(IREE_I32_REGISTER_COUNT, frame_a->registers.i32_capacity);
+  EXPECT_LE(1024, frame_a->registers.ref_capacity);
+  EXPECT_EQ(1, frame_a->registers.i32[0]);
+  EXPECT_EQ(2, frame_a->registers.i32[1]);
+  EXPECT_EQ(DummyObject::kTypeID, frame_a->registers.ref[0].type);
+  EXPECT_EQ(nullptr, frame_a->registers.ref[1023].ptr);
+  frame_a->registers.ref_register_count = 1024;
+
+  // Counts beyond what registers can encode are rejected.
+  EXPECT_EQ(IREE_STATUS_OUT_OF_RANGE,
+            iree_vm_stack_frame_reserve_registers(
+                stack.get(), frame_a, IREE_I32_REGISTER_COUNT + 1, 0));
+
+  IREE_EXPECT_OK(iree_vm_stack_function_leave(stack.get()));
+  EXPECT_EQ(0, dummy_object_count);
+
+  IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
+}
+
+// Tests that only the current frame may grow its registers.
+TEST(VMStackTest, ReserveRegistersParentFrame) {
+  auto stack = std::make_unique<iree_vm_stack_t>();
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
+
+  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_stack_frame_t* frame_a = nullptr;
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 4, 0));
+
+  iree_vm_function_t function_b = {MODULE_B_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 1};
+  iree_vm_stack_frame_t* frame_b = nullptr;
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_b, &frame_b));
+
+  // Reserving within the existing capacity of the parent is fine.
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 4, 0));
+  EXPECT_EQ(IREE_STATUS_FAILED_PRECONDITION,
+            iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 64, 0));
+
+  IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
+}
+
+// Tests that storage is reused after reset.
+TEST(VMStackTest, ResetReusesStorage) {
+  auto stack = std::make_unique<iree_vm_stack_t>();
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_EXPECT_OK(
+      iree_vm_stack_init(state_resolver, IREE_ALLOCATOR_SYSTEM, stack.get()));
+
+  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_stack_frame_t* frame_a = nullptr;
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 8, 8));
+  iree_vm_stack_frame_t* first_frame = frame_a;
+  int32_t* first_i32 = frame_a->registers.i32;
+
+  IREE_EXPECT_OK(iree_vm_stack_reset(stack.get()));
+  EXPECT_EQ(nullptr, iree_vm_stack_current_frame(stack.get()));
+  EXPECT_EQ(0, stack->depth);
+
+  IREE_EXPECT_OK(
+      iree_vm_stack_function_enter(stack.get(), function_a, &frame_a));
+  IREE_EXPECT_OK(
+      iree_vm_stack_frame_reserve_registers(stack.get(), frame_a, 8, 8));
+  EXPECT_EQ(first_frame, frame_a);
+  EXPECT_EQ(first_i32, frame_a->registers.i32);
+  EXPECT_EQ(nullptr, frame_a->registers.ref[7].ptr);
+
+  IREE_EXPECT_OK(iree_vm_stack_deinit(stack.get()));
+}
+
 }  // namespace
@@ -27,6 +27,10 @@ typedef enum {
   IREE_VM_VALUE_TYPE_NONE = 0,
   // int32_t.
   IREE_VM_VALUE_TYPE_I32 = 1,
+  // int64_t.
+  IREE_VM_VALUE_TYPE_I64 = 2,
+  // float.
+  IREE_VM_VALUE_TYPE_F32 = 3,
 } iree_vm_value_type_t;
 
 // A variant value type.
@@ -34,6 +38,8 @@ typedef struct iree_vm_value {
   iree_vm_value_type_t type;
   union {
     int32_t i32;
+    int64_t i64;
+    float f32;
   };
 } iree_vm_value_t;
 
@@ -42,6 +48,20 @@ typedef struct iree_vm_value {
     IREE_VM_VALUE_TYPE_I32, { (value) } \
   }
 
+static inline iree_vm_value_t iree_vm_value_make_i64(int64_t value) {
+  iree_vm_value_t result;
+  result.type = IREE_VM_VALUE_TYPE_I64;
+  result.i64 = value;
+  return result;
+}
+
+static inline iree_vm_value_t iree_vm_value_make_f32(float value) {
+  iree_vm_value_t result;
+  result.type = IREE_VM_VALUE_TYPE_F32;
+  result.f32 = value;
+  return result;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -76,7 +76,17 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_variant_list_append_value(
   int i = list->count++;
   list->values[i].value_type = value.type;
   list->values[i].ref_type = IREE_VM_REF_TYPE_NULL;
-  list->values[i].i32 = value.i32;
+  switch (value.type) {
+    case IREE_VM_VALUE_TYPE_I64:
+      list->values[i].i64 = value.i64;
+      break;
+    case IREE_VM_VALUE_TYPE_F32:
+      list->values[i].f32 = value.f32;
+      break;
+    default:
+      list->values[i].i32 = value.i32;
+      break;
+  }
   return IREE_STATUS_OK;
 }
 
@@ -38,6 +38,8 @@ typedef struct {
   iree_vm_ref_type_t ref_type : 24;
   union {
     int32_t i32;
+    int64_t i64;
+    float f32;
     iree_vm_ref_t ref;
   };
 } iree_vm_variant_t;